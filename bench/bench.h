@@ -0,0 +1,505 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Common part of corpus runners.
+ *
+ * A corpus is a directory (walked recursively) or a single file. Files are loaded in memory before measuring:
+ *   *.html, *.htm, *.css, *.txt and others by extension as is;
+ *   *.gz decompressed with `gzip -dc`;
+ *   *.warc, *.warc.gz split into documents by Content-Length of records (WARC files from commoncrawl.org).
+ * Without a corpus a runner generates its own documents.
+ *
+ * Every measurement is printed as one JSON object per line:
+ *   {"bench": "...", "mode": "...", "docs": N, "bytes": N, "seconds": N, "mb_per_sec": N, "docs_per_sec": N,
+ *    "p50_ms": N, "p99_ms": N, "peak_rss_kb": N}
+ * Latency is of one document (one item for myurl). Peak RSS is of the process up to the end of the measurement,
+ * the loaded corpus included.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+#include <mycore/myosi.h>
+
+#define DIE(msg, ...) do { fprintf(stderr, msg, ##__VA_ARGS__); exit(EXIT_FAILURE); } while(0)
+#define CHECK_STATUS(msg, ...) do {if(status) DIE(msg, ##__VA_ARGS__);} while(0)
+
+#define BENCH_DEFAULT_ITERATIONS 3
+#define BENCH_GENERATE_DOCS      200
+
+struct bench_res {
+    char*  data;
+    size_t size;
+}
+typedef bench_res_t;
+
+struct bench_corpus {
+    bench_res_t* list;
+    size_t length;
+    size_t size;
+    size_t bytes;
+}
+typedef bench_corpus_t;
+
+struct bench_stat {
+    double* times;
+    size_t  length;
+    size_t  size;
+    size_t  bytes;
+    double  total;
+}
+typedef bench_stat_t;
+
+/* time */
+static double bench_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1000000000.0);
+}
+
+/* data */
+static void bench_res_append(bench_res_t* res, size_t* res_size, const char* data, size_t len)
+{
+    if(res->size + len + 1 > *res_size) {
+        *res_size = (res->size + len + 1) * 2;
+        res->data = realloc(res->data, *res_size);
+
+        if(res->data == NULL)
+            DIE("Can't allocate mem for data\n");
+    }
+
+    memcpy(&res->data[res->size], data, len);
+
+    res->size += len;
+    res->data[res->size] = '\0';
+}
+
+static bench_res_t bench_read_stream(FILE* fh, const char* filename)
+{
+    bench_res_t res = {NULL, 0};
+    size_t res_size = 0;
+    char buf[4096 * 4];
+
+    size_t nread;
+    while((nread = fread(buf, 1, sizeof(buf), fh)) > 0)
+        bench_res_append(&res, &res_size, buf, nread);
+
+    if(ferror(fh))
+        DIE("Can't read file: %s\n", filename);
+
+    if(res.data == NULL)
+        bench_res_append(&res, &res_size, "", 0);
+
+    return res;
+}
+
+static bool bench_has_ext(const char* filename, const char* ext)
+{
+    size_t len = strlen(filename);
+    size_t ext_len = strlen(ext);
+
+    return len >= ext_len && strcmp(&filename[(len - ext_len)], ext) == 0;
+}
+
+static bench_res_t bench_load_file(const char* filename)
+{
+    bench_res_t res;
+
+    if(bench_has_ext(filename, ".gz")) {
+        char command[4096];
+
+        if(strchr(filename, '\'') || snprintf(command, sizeof(command), "gzip -dc '%s'", filename) >= (int)sizeof(command))
+            DIE("Can't make command for file: %s\n", filename);
+
+        FILE *fh = popen(command, "r");
+        if(fh == NULL)
+            DIE("Can't run: %s\n", command);
+
+        res = bench_read_stream(fh, filename);
+
+        if(pclose(fh) != 0)
+            DIE("Can't decompress file: %s\n", filename);
+    }
+    else {
+        FILE *fh = fopen(filename, "rb");
+        if(fh == NULL)
+            DIE("Can't open file: %s\n", filename);
+
+        res = bench_read_stream(fh, filename);
+        fclose(fh);
+    }
+
+    return res;
+}
+
+/* corpus */
+static void bench_corpus_add(bench_corpus_t* corpus, const char* data, size_t size)
+{
+    if(corpus->length == corpus->size) {
+        corpus->size = (corpus->size ? corpus->size * 2 : 128);
+        corpus->list = realloc(corpus->list, sizeof(bench_res_t) * corpus->size);
+
+        if(corpus->list == NULL)
+            DIE("Can't allocate mem for corpus\n");
+    }
+
+    bench_res_t res = {NULL, 0};
+    size_t res_size = 0;
+
+    bench_res_append(&res, &res_size, data, size);
+
+    corpus->list[corpus->length] = res;
+    corpus->length++;
+    corpus->bytes += size;
+}
+
+static size_t bench_warc_header_end(const char* data, size_t size, size_t from)
+{
+    for(size_t i = from; (i + 3) < size; i++) {
+        if(data[i] == '\r' && data[(i + 1)] == '\n' && data[(i + 2)] == '\r' && data[(i + 3)] == '\n')
+            return (i + 4);
+    }
+
+    return size;
+}
+
+/* records of WARC: WARC headers, Content-Length bytes of block (HTTP headers and body) */
+static void bench_corpus_add_warc(bench_corpus_t* corpus, const char* data, size_t size)
+{
+    const char *ct = "Content-Length:";
+    size_t ct_size = strlen(ct);
+
+    size_t i = 0;
+    while(i < size)
+    {
+        size_t head_end = bench_warc_header_end(data, size, i);
+        size_t length = 0;
+        bool is_response = false;
+
+        for(size_t line = i; line < head_end; line++) {
+            if(line != i && data[(line - 1)] != '\n')
+                continue;
+
+            if(strncmp(&data[line], ct, ct_size) == 0)
+                length = strtoul(&data[(line + ct_size)], NULL, 10);
+            else if(strncmp(&data[line], "WARC-Type: response", 19) == 0)
+                is_response = true;
+        }
+
+        if(head_end + length > size)
+            length = size - head_end;
+
+        if(is_response) {
+            /* skip HTTP headers */
+            size_t body = bench_warc_header_end(data, (head_end + length), head_end);
+
+            if(body < head_end + length)
+                bench_corpus_add(corpus, &data[body], (head_end + length - body));
+        }
+
+        i = head_end + length;
+
+        while(i < size && (data[i] == '\r' || data[i] == '\n'))
+            i++;
+    }
+}
+
+static bool bench_corpus_ext_is(const char* filename, const char** exts)
+{
+    for(size_t i = 0; exts[i]; i++) {
+        if(bench_has_ext(filename, exts[i]))
+            return true;
+
+        char gz_ext[64];
+        snprintf(gz_ext, sizeof(gz_ext), "%s.gz", exts[i]);
+
+        if(bench_has_ext(filename, gz_ext))
+            return true;
+    }
+
+    return false;
+}
+
+static void bench_corpus_add_file(bench_corpus_t* corpus, const char* filename, const char** exts)
+{
+    /* WARC has HTML documents only */
+    bool is_warc = (bench_has_ext(filename, ".warc") || bench_has_ext(filename, ".warc.gz"))
+                   && bench_corpus_ext_is(".html", exts);
+
+    if(is_warc == false && bench_corpus_ext_is(filename, exts) == false)
+        return;
+
+    bench_res_t res = bench_load_file(filename);
+
+    if(is_warc)
+        bench_corpus_add_warc(corpus, res.data, res.size);
+    else
+        bench_corpus_add(corpus, res.data, res.size);
+
+    free(res.data);
+}
+
+static void bench_corpus_load_path(bench_corpus_t* corpus, const char* path, const char** exts)
+{
+    struct stat st;
+
+    if(stat(path, &st) != 0)
+        DIE("Can't stat: %s\n", path);
+
+    if(S_ISDIR(st.st_mode) == 0) {
+        bench_corpus_add_file(corpus, path, exts);
+        return;
+    }
+
+    DIR *dir = opendir(path);
+    if(dir == NULL)
+        DIE("Can't open directory: %s\n", path);
+
+    struct dirent *entry;
+    while((entry = readdir(dir)))
+    {
+        if(strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+
+        char full[4096];
+
+        if(snprintf(full, sizeof(full), "%s/%s", path, entry->d_name) >= (int)sizeof(full))
+            DIE("Too long path: %s/%s\n", path, entry->d_name);
+
+        bench_corpus_load_path(corpus, full, exts);
+    }
+
+    closedir(dir);
+}
+
+/* exts: NULL terminated list of extensions like ".html" */
+static bench_corpus_t bench_corpus_load(const char* path, const char** exts)
+{
+    bench_corpus_t corpus = {NULL, 0, 0, 0};
+
+    bench_corpus_load_path(&corpus, path, exts);
+
+    return corpus;
+}
+
+static void bench_corpus_destroy(bench_corpus_t* corpus)
+{
+    for(size_t i = 0; i < corpus->length; i++)
+        free(corpus->list[i].data);
+
+    free(corpus->list);
+    memset(corpus, 0, sizeof(bench_corpus_t));
+}
+
+/* generated HTML page with sizes from about 1KB to 250KB */
+static bench_res_t bench_generate_html(size_t idx)
+{
+    static const char *words[] = {
+        "lorem", "ipsum", "dolor", "sit", "amet", "&amp;", "&nbsp;", "&copy;", "\xd0\xbf\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82",
+        "\xe6\x97\xa5\xe6\x9c\xac", "consectetur", "&#x41;", "adipiscing", "elit"
+    };
+
+    bench_res_t res = {NULL, 0};
+    size_t res_size = 0;
+    char buf[512];
+
+    size_t blocks = 1 + ((idx * 7919) % 97) * ((idx % 5) + 1);
+
+    const char *head = "<title>Page</title><style>.a{color:red} div > p.b{margin:0 auto}</style>"
+                       "<script>var x = 1 < 2 && \"</div>\";</script></head><body class=\"main\">";
+
+    bench_res_append(&res, &res_size, "<!DOCTYPE html><html><head>", 27);
+
+    /* every second page without <meta charset>, encoding of them must be detected by content */
+    if(idx % 2)
+        bench_res_append(&res, &res_size, "<meta charset=\"utf-8\">", 22);
+
+    bench_res_append(&res, &res_size, head, strlen(head));
+
+    for(size_t i = 0; i < blocks; i++) {
+        int len = snprintf(buf, sizeof(buf),
+                           "<div class=\"c%zu a\" id=\"d%zu\"><h2>Title %zu</h2><p class=\"b\">%s %s <a href=\"/path/%zu/page.html?q=%zu#top\">link</a> %s"
+                           "<img src=\"http://img.example.com/%zu.png\" alt=\"\"><br>%s</p>"
+                           "<ul><li>%s<li><a href=\"../rel/%zu\">%s</a><li>%s</ul><table><tr><td>%zu<td>%s</table><!-- c --></div>\n",
+                           (i % 20), i, i, words[(i % 14)], words[((i + 3) % 14)], i, idx, words[((i + 5) % 14)],
+                           i, words[((i + 7) % 14)], words[((i + 9) % 14)], i, words[((i + 11) % 14)], words[((i + 13) % 14)],
+                           i, words[((i + 1) % 14)]);
+
+        bench_res_append(&res, &res_size, buf, (size_t)len);
+    }
+
+    bench_res_append(&res, &res_size, "</body></html>", 14);
+
+    return res;
+}
+
+static bench_res_t bench_generate_css(size_t idx)
+{
+    bench_res_t res = {NULL, 0};
+    size_t res_size = 0;
+    char buf[512];
+
+    size_t rules = 10 + ((idx * 7919) % 97) * ((idx % 5) + 1) * 4;
+
+    for(size_t i = 0; i < rules; i++) {
+        int len = snprintf(buf, sizeof(buf),
+                           ".c%zu > p.b, #d%zu a:hover {color: #%06zx; margin: %zupx auto; font: bold 12px/1.5 \"Arial\", sans-serif}\n"
+                           "div.a ul li:nth-child(2n+1) a[href^=\"/path\"] {padding: %zuem %zu%%; background: url(\"/img/%zu.png\") no-repeat}\n",
+                           (i % 20), i, ((i * 2654435761UL) & 0xffffff), (i % 30), (i % 4), (i % 100), i);
+
+        bench_res_append(&res, &res_size, buf, (size_t)len);
+    }
+
+    return res;
+}
+
+static bench_corpus_t bench_corpus_generate(bench_res_t (*generate)(size_t idx), size_t count)
+{
+    bench_corpus_t corpus = {NULL, 0, 0, 0};
+
+    for(size_t i = 0; i < count; i++) {
+        bench_res_t res = generate(i);
+
+        bench_corpus_add(&corpus, res.data, res.size);
+        free(res.data);
+    }
+
+    return corpus;
+}
+
+/* corpus from path or generated if path is NULL */
+static bench_corpus_t bench_corpus_get(const char* path, const char** exts, bench_res_t (*generate)(size_t idx))
+{
+    bench_corpus_t corpus;
+
+    if(path)
+        corpus = bench_corpus_load(path, exts);
+    else
+        corpus = bench_corpus_generate(generate, BENCH_GENERATE_DOCS);
+
+    if(corpus.length == 0)
+        DIE("No documents in corpus: %s\n", (path ? path : "generated"));
+
+    return corpus;
+}
+
+/* statistics */
+static void bench_stat_add(bench_stat_t* stat, double time, size_t bytes)
+{
+    if(stat->length == stat->size) {
+        stat->size = (stat->size ? stat->size * 2 : 1024);
+        stat->times = realloc(stat->times, sizeof(double) * stat->size);
+
+        if(stat->times == NULL)
+            DIE("Can't allocate mem for statistics\n");
+    }
+
+    stat->times[stat->length] = time;
+    stat->length++;
+
+    stat->bytes += bytes;
+    stat->total += time;
+}
+
+static int bench_stat_cmp(const void* a, const void* b)
+{
+    double da = *(const double*)a;
+    double db = *(const double*)b;
+
+    return (da > db) - (da < db);
+}
+
+/* nearest-rank percentile, times must be sorted */
+static double bench_stat_percentile(bench_stat_t* stat, double percent)
+{
+    if(stat->length == 0)
+        return 0;
+
+    size_t rank = (size_t)((percent / 100.0) * (double)stat->length + 0.999999);
+
+    if(rank == 0)
+        rank = 1;
+
+    if(rank > stat->length)
+        rank = stat->length;
+
+    return stat->times[(rank - 1)];
+}
+
+static long bench_peak_rss_kb(void)
+{
+    struct rusage usage;
+
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+    /* kilobytes on Linux, bytes on Mac OS */
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+static void bench_stat_print_json(const char* bench, const char* mode, bench_stat_t* stat)
+{
+    qsort(stat->times, stat->length, sizeof(double), bench_stat_cmp);
+
+    double seconds = stat->total;
+
+    printf("{\"bench\": \"%s\", \"mode\": \"%s\", \"docs\": " MyCORE_FORMAT_Z ", \"bytes\": " MyCORE_FORMAT_Z ", "
+           "\"seconds\": %.6f, \"mb_per_sec\": %.3f, \"docs_per_sec\": %.1f, \"p50_ms\": %.4f, \"p99_ms\": %.4f, "
+           "\"peak_rss_kb\": %ld}\n",
+           bench, mode, stat->length, stat->bytes, seconds,
+           (seconds > 0 ? ((double)stat->bytes / (1024.0 * 1024.0)) / seconds : 0),
+           (seconds > 0 ? (double)stat->length / seconds : 0),
+           (bench_stat_percentile(stat, 50) * 1000.0), (bench_stat_percentile(stat, 99) * 1000.0),
+           bench_peak_rss_kb());
+
+    fflush(stdout);
+}
+
+static void bench_stat_clean(bench_stat_t* stat)
+{
+    free(stat->times);
+    memset(stat, 0, sizeof(bench_stat_t));
+}
+
+/* arguments: [<corpus>] [iterations]; "-" is no corpus */
+static const char * bench_arg_corpus(int argc, const char * argv[], int idx)
+{
+    if(argc > idx && strcmp(argv[idx], "-") != 0)
+        return argv[idx];
+
+    return NULL;
+}
+
+static size_t bench_arg_size(int argc, const char * argv[], int idx, size_t def)
+{
+    if(argc > idx) {
+        size_t value = strtoul(argv[idx], NULL, 10);
+
+        if(value == 0)
+            DIE("Bad argument: %s\n", argv[idx]);
+
+        return value;
+    }
+
+    return def;
+}
+
+#endif /* BENCH_H */
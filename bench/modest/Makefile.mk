@@ -0,0 +1,13 @@
+modest_dirs := .
+modest_objs := $(call BINARY_UTILS_OBJS,modest,$(modest_dirs))
+
+modest_all: $(modest_objs)
+
+modest_clean: 
+	rm -f $(modest_objs)
+
+# arguments: [<html file> <css file>] [threads] [iterations]; without files a generated page is used
+modest_finder_thread :=
+
+# arguments: [<corpus>|-] [<css file>|-] [iterations] [threads]
+modest_cascade := $(or $(BENCH_CORPUS),-) $(or $(BENCH_CSS),-) $(BENCH_ITERATIONS)
@@ -0,0 +1,203 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Cascade of one stylesheet over a corpus of HTML documents (*.html, *.htm, *.warc; also gzipped):
+ * every selector is matched against the document and declarations are applied to modest nodes.
+ * Measured with selectors matched from left to right (modest_finder_thread_process)
+ * and with rules compiled once for the stylesheet (modest_finder_thread_process_rules).
+ * Also measured is modest_style_computed_process after the cascade, it looks up declarations of every node.
+ * Mode is suffixed by the store of node declarations, see MODEST_BUILD_NODE_STORE.
+ * HTML parsing is not measured.
+ *
+ * Usage: cascade [<corpus dir or file>|-] [<css file>|-] [iterations] [threads]
+ */
+
+#include "../bench.h"
+
+#include <modest/modest.h>
+#include <modest/finder/finder.h>
+#include <modest/finder/thread.h>
+#include <modest/finder/rules.h>
+#include <modest/glue.h>
+#include <modest/node/node.h>
+#include <modest/style/computed.h>
+#include <myhtml/myhtml.h>
+#include <mycss/mycss.h>
+#include <mycss/stylesheet.h>
+
+#define BENCH_DEFAULT_THREADS 2
+
+static const char *bench_exts[] = {".html", ".htm", NULL};
+
+/* mode is suffixed by the store of library build */
+static void bench_cascade_print_json(const char* mode, bench_stat_t* stat)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "%s_%s", mode, modest_node_store_name());
+
+    bench_stat_print_json("modest_cascade", name, stat);
+}
+
+static mycss_entry_t * bench_parse_css(bench_res_t* res)
+{
+    mycss_t *mycss = mycss_create();
+    mystatus_t status = mycss_init(mycss);
+
+    CHECK_STATUS("Can't init MyCSS object\n");
+
+    mycss_entry_t *entry = mycss_entry_create();
+    status = mycss_entry_init(mycss, entry);
+
+    CHECK_STATUS("Can't init MyCSS Entry object\n");
+
+    status = mycss_parse(entry, MyENCODING_UTF_8, res->data, res->size);
+    CHECK_STATUS("Can't parse CSS\n");
+
+    return entry;
+}
+
+static void bench_cascade(modest_t* modest, modest_finder_thread_t* finder_thread, mycss_stylesheet_t* stylesheet,
+                          modest_finder_rules_t* rules, bench_corpus_t* corpus, size_t iterations)
+{
+    bench_stat_t stat = {0};
+
+    for(size_t it = 0; it < iterations; it++) {
+        for(size_t i = 0; i < corpus->length; i++) {
+            modest_clean(modest);
+
+            mystatus_t status = myhtml_parse(modest->myhtml_tree, MyENCODING_UTF_8, corpus->list[i].data, corpus->list[i].size);
+            CHECK_STATUS("Can't parse HTML\n");
+
+            double begin = bench_time();
+
+            if(rules)
+                status = modest_finder_thread_process_rules(modest, finder_thread, modest->myhtml_tree->node_html, rules);
+            else
+                status = modest_finder_thread_process(modest, finder_thread, modest->myhtml_tree->node_html,
+                                                      stylesheet->sel_list_first);
+
+            CHECK_STATUS("Can't find by selectors with thread\n");
+
+            bench_stat_add(&stat, (bench_time() - begin), corpus->list[i].size);
+
+            modest_finder_thread_clean(finder_thread, false);
+        }
+    }
+
+    bench_cascade_print_json((rules ? "rules" : "selectors"), &stat);
+    bench_stat_clean(&stat);
+}
+
+static void bench_computed(modest_t* modest, modest_finder_thread_t* finder_thread, modest_finder_rules_t* rules,
+                           bench_corpus_t* corpus, size_t iterations)
+{
+    bench_stat_t stat = {0};
+
+    modest_style_computed_t *computed = modest_style_computed_create();
+    mystatus_t status = modest_style_computed_init(computed, modest);
+
+    CHECK_STATUS("Can't init Modest Style Computed object\n");
+
+    for(size_t it = 0; it < iterations; it++) {
+        for(size_t i = 0; i < corpus->length; i++) {
+            modest_clean(modest);
+
+            status = myhtml_parse(modest->myhtml_tree, MyENCODING_UTF_8, corpus->list[i].data, corpus->list[i].size);
+            CHECK_STATUS("Can't parse HTML\n");
+
+            status = modest_finder_thread_process_rules(modest, finder_thread, modest->myhtml_tree->node_html, rules);
+            CHECK_STATUS("Can't find by selectors with thread\n");
+
+            double begin = bench_time();
+
+            status = modest_style_computed_process(computed, modest->myhtml_tree->node_html);
+            CHECK_STATUS("Can't compute styles\n");
+
+            bench_stat_add(&stat, (bench_time() - begin), corpus->list[i].size);
+
+            modest_finder_thread_clean(finder_thread, false);
+        }
+    }
+
+    bench_cascade_print_json("computed", &stat);
+    bench_stat_clean(&stat);
+
+    modest_style_computed_destroy(computed, true);
+}
+
+int main(int argc, const char * argv[])
+{
+    const char *path     = bench_arg_corpus(argc, argv, 1);
+    const char *css_path = bench_arg_corpus(argc, argv, 2);
+    size_t iterations    = bench_arg_size(argc, argv, 3, BENCH_DEFAULT_ITERATIONS);
+    size_t threads       = bench_arg_size(argc, argv, 4, BENCH_DEFAULT_THREADS);
+
+    bench_corpus_t corpus = bench_corpus_get(path, bench_exts, bench_generate_html);
+    bench_res_t css = (css_path ? bench_load_file(css_path) : bench_generate_css(0));
+
+    /* init Modest */
+    modest_t *modest = modest_create();
+    mystatus_t status = modest_init(modest);
+
+    CHECK_STATUS("Can't init Modest object\n");
+
+    myhtml_t* myhtml = myhtml_create();
+    status = myhtml_init(myhtml, MyHTML_OPTIONS_PARSE_MODE_SINGLE, 1, 0);
+
+    CHECK_STATUS("Can't init MyHTML object\n");
+
+    modest->myhtml_tree = myhtml_tree_create();
+    status = myhtml_tree_init(modest->myhtml_tree, myhtml);
+
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+
+    myhtml_callback_tree_node_insert_set(modest->myhtml_tree, modest_glue_callback_myhtml_insert_node, (void*)modest);
+
+    modest->mycss_entry = bench_parse_css(&css);
+    mycss_stylesheet_t *stylesheet = mycss_entry_stylesheet(modest->mycss_entry);
+
+    /* finder */
+    modest_finder_t* finder = modest_finder_create();
+    status = modest_finder_init(finder);
+
+    CHECK_STATUS("Can't init Modest Finder object\n");
+
+    modest_finder_thread_t *finder_thread = modest_finder_thread_create();
+    status = modest_finder_thread_init(finder, finder_thread, threads);
+
+    CHECK_STATUS("Can't init Modest Finder Thread object\n");
+
+    modest_finder_rules_t *rules = modest_finder_rules_create();
+    status = modest_finder_rules_init_by_stylesheet(rules, stylesheet, 0);
+
+    CHECK_STATUS("Can't init Modest Finder Rules object\n");
+
+    bench_cascade(modest, finder_thread, stylesheet, NULL, &corpus, iterations);
+    bench_cascade(modest, finder_thread, stylesheet, rules, &corpus, iterations);
+    bench_computed(modest, finder_thread, rules, &corpus, iterations);
+
+    /* destroy all */
+    modest_finder_rules_destroy(rules, true);
+    modest_finder_thread_destroy(finder_thread, true);
+    modest_finder_destroy(finder, true);
+
+    mycss_stylesheet_destroy(stylesheet, true);
+
+    myhtml_tree_destroy(modest->myhtml_tree);
+    myhtml_destroy(myhtml);
+
+    mycss_t* mycss = modest->mycss_entry->mycss;
+    mycss_entry_destroy(modest->mycss_entry, true);
+    mycss_destroy(mycss, true);
+
+    modest_destroy(modest, true);
+
+    free(css.data);
+    bench_corpus_destroy(&corpus);
+
+    return 0;
+}
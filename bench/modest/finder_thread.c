@@ -0,0 +1,330 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Load balance of modest_finder_thread_process.
+ * Every run is measured with static split of selectors between threads, with work stealing,
+ * with right to left matching of node chunks and with rules compiled once for all runs. The time of process is the time of the slowest thread.
+ *
+ * Usage: finder_thread [<html file> <css file>] [threads] [iterations]
+ * Without files a page and a stylesheet with expensive selectors at the beginning are generated.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <modest/modest.h>
+#include <modest/finder/finder.h>
+#include <modest/finder/thread.h>
+#include <modest/finder/rules.h>
+#include <modest/glue.h>
+
+#define BENCH_DEFAULT_THREADS    4
+#define BENCH_DEFAULT_ITERATIONS 10
+
+#define DIE(msg, ...) do { fprintf(stderr, msg, ##__VA_ARGS__); exit(EXIT_FAILURE); } while(0)
+#define CHECK_STATUS(msg, ...) do {if(status) DIE(msg, ##__VA_ARGS__);} while(0)
+
+struct bench_res {
+    char*  data;
+    size_t size;
+}
+typedef bench_res_t;
+
+struct bench_stat {
+    double min;
+    double total;
+}
+typedef bench_stat_t;
+
+bench_res_t bench_load_file(const char* filename)
+{
+    FILE *fh = fopen(filename, "rb");
+    if(fh == NULL)
+        DIE("Can't open file: %s\n", filename);
+
+    if(fseek(fh, 0L, SEEK_END) != 0)
+        DIE("Can't set position (fseek) in file: %s\n", filename);
+
+    long size = ftell(fh);
+
+    if(fseek(fh, 0L, SEEK_SET) != 0)
+        DIE("Can't set position (fseek) in file: %s\n", filename);
+
+    if(size <= 0)
+        DIE("Can't get file size or file is empty: %s\n", filename);
+
+    char *file_data = (char*)malloc(size + 1);
+    if(file_data == NULL)
+        DIE("Can't allocate mem for file: %s\n", filename);
+
+    size_t nread = fread(file_data, 1, size, fh);
+    if(nread != size)
+        DIE("Could not read %ld bytes (" MyCORE_FORMAT_Z " bytes done)\n", size, nread);
+
+    fclose(fh);
+
+    file_data[size] = '\0';
+
+    return (bench_res_t){file_data, (size_t)size};
+}
+
+static void bench_append(bench_res_t* res, size_t* res_size, const char* data)
+{
+    size_t len = strlen(data);
+
+    if(res->size + len + 1 > *res_size) {
+        *res_size = (res->size + len + 1) * 2;
+        res->data = realloc(res->data, *res_size);
+
+        if(res->data == NULL)
+            DIE("Can't allocate mem for generated data\n");
+    }
+
+    memcpy(&res->data[res->size], data, len + 1);
+    res->size += len;
+}
+
+bench_res_t bench_generate_html(size_t count)
+{
+    bench_res_t res = {NULL, 0};
+    size_t res_size = 0;
+    char buf[256];
+
+    bench_append(&res, &res_size, "<html><body>");
+
+    for(size_t i = 0; i < count; i++) {
+        snprintf(buf, sizeof(buf), "<div class=\"c%zu\"><ul><li class=\"a\">x<li id=\"i%zu\"><p><span class=\"s%zu\">y</span><a href=\"#\">z</a></p></ul>",
+                 (i % 20), i, (i % 5));
+        bench_append(&res, &res_size, buf);
+
+        /* close divs by groups, make some depth */
+        if((i % 8) == 7) {
+            for(size_t j = 0; j < 8; j++)
+                bench_append(&res, &res_size, "</div>");
+        }
+    }
+
+    bench_append(&res, &res_size, "</body></html>");
+
+    return res;
+}
+
+bench_res_t bench_generate_css(size_t count)
+{
+    static const char *expensive[] = {
+        "* *", "div :not(.c1) span", "div div div p", "body *:not(.a) a", "div:has(span) li", "ul ~ * span"
+    };
+
+    bench_res_t res = {NULL, 0};
+    size_t res_size = 0;
+    char buf[256];
+
+    /* like resets at the beginning of real stylesheets */
+    for(size_t i = 0; i < (sizeof(expensive) / sizeof(expensive[0])); i++) {
+        snprintf(buf, sizeof(buf), "%s {padding: %zupx}\n", expensive[i], i);
+        bench_append(&res, &res_size, buf);
+    }
+
+    for(size_t i = 0; i < count; i++) {
+        snprintf(buf, sizeof(buf), ".c%zu {width: %zupx} #i%zu {color: red}\n", (i % 20), i, i);
+        bench_append(&res, &res_size, buf);
+    }
+
+    return res;
+}
+
+myhtml_tree_t * bench_parse_html(modest_t* modest, bench_res_t* res)
+{
+    myhtml_t* myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, MyHTML_OPTIONS_PARSE_MODE_SINGLE, 1, 0);
+
+    CHECK_STATUS("Can't init MyHTML object\n");
+
+    myhtml_tree_t* tree = myhtml_tree_create();
+    status = myhtml_tree_init(tree, myhtml);
+
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+
+    myhtml_callback_tree_node_insert_set(tree, modest_glue_callback_myhtml_insert_node, (void*)modest);
+
+    status = myhtml_parse(tree, MyENCODING_UTF_8, res->data, res->size);
+    CHECK_STATUS("Can't parse HTML\n");
+
+    return tree;
+}
+
+mycss_entry_t * bench_parse_css(bench_res_t* res)
+{
+    mycss_t *mycss = mycss_create();
+    mystatus_t status = mycss_init(mycss);
+
+    CHECK_STATUS("Can't init MyCSS object\n");
+
+    mycss_entry_t *entry = mycss_entry_create();
+    status = mycss_entry_init(mycss, entry);
+
+    CHECK_STATUS("Can't init MyCSS Entry object\n");
+
+    status = mycss_parse(entry, MyENCODING_UTF_8, res->data, res->size);
+    CHECK_STATUS("Can't parse CSS\n");
+
+    return entry;
+}
+
+static double bench_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1000000000.0);
+}
+
+bench_stat_t bench_run(modest_t* modest, modest_finder_thread_t* finder_thread, mycss_stylesheet_t* stylesheet,
+                       modest_finder_rules_t* rules, size_t iterations)
+{
+    bench_stat_t stat = {0, 0};
+
+    for(size_t i = 0; i < iterations; i++) {
+        double begin = bench_time();
+
+        mystatus_t status;
+
+        if(rules)
+            status = modest_finder_thread_process_rules(modest, finder_thread, modest->myhtml_tree->node_html, rules);
+        else
+            status = modest_finder_thread_process(modest, finder_thread, modest->myhtml_tree->node_html,
+                                                  stylesheet->sel_list_first);
+
+        CHECK_STATUS("Can't find by selectors with thread\n");
+
+        double elapsed = bench_time() - begin;
+
+        if(i == 0 || elapsed < stat.min)
+            stat.min = elapsed;
+
+        stat.total += elapsed;
+
+        modest_finder_thread_clean(finder_thread, false);
+    }
+
+    return stat;
+}
+
+void bench_print(const char* name, modest_finder_thread_t* finder_thread, bench_stat_t* stat, size_t iterations)
+{
+    printf("%-8s min %.6f s, avg %.6f s; work by thread:", name, stat->min, (stat->total / (double)iterations));
+
+    for(size_t i = 0; i < finder_thread->context_list_size; i++) {
+        printf(" " MyCORE_FORMAT_Z "(" MyCORE_FORMAT_Z " stolen)",
+               finder_thread->context_list[i].work_done, finder_thread->context_list[i].work_stolen);
+    }
+
+    printf("\n");
+}
+
+int main(int argc, const char * argv[])
+{
+    size_t threads = BENCH_DEFAULT_THREADS;
+    size_t iterations = BENCH_DEFAULT_ITERATIONS;
+
+    bench_res_t html, css;
+    int argi = 1;
+
+    if(argc > 2) {
+        html = bench_load_file(argv[1]);
+        css  = bench_load_file(argv[2]);
+
+        argi = 3;
+    }
+    else {
+        html = bench_generate_html(2000);
+        css  = bench_generate_css(200);
+    }
+
+    if(argc > argi)
+        threads = strtoul(argv[argi], NULL, 10);
+
+    if(argc > (argi + 1))
+        iterations = strtoul(argv[(argi + 1)], NULL, 10);
+
+    if(threads == 0 || iterations == 0)
+        DIE("Usage: %s [<html file> <css file>] [threads] [iterations]\n", argv[0]);
+
+    /* init Modest */
+    modest_t *modest = modest_create();
+    mystatus_t status = modest_init(modest);
+
+    CHECK_STATUS("Can't init Modest object\n");
+
+    modest->myhtml_tree = bench_parse_html(modest, &html);
+    modest->mycss_entry = bench_parse_css(&css);
+
+    mycss_stylesheet_t *stylesheet = mycss_entry_stylesheet(modest->mycss_entry);
+
+    modest_finder_t* finder = modest_finder_create();
+    status = modest_finder_init(finder);
+
+    CHECK_STATUS("Can't init Modest Finder object\n");
+
+    modest_finder_thread_t *finder_thread = modest_finder_thread_create();
+    status = modest_finder_thread_init(finder, finder_thread, threads);
+
+    CHECK_STATUS("Can't init Modest Finder Thread object\n");
+
+    printf("html: " MyCORE_FORMAT_Z " bytes; css: " MyCORE_FORMAT_Z " bytes; threads: " MyCORE_FORMAT_Z "; iterations: " MyCORE_FORMAT_Z "\n",
+           html.size, css.size, finder_thread->context_list_size, iterations);
+
+    finder_thread->steal = false;
+    bench_stat_t stat_static = bench_run(modest, finder_thread, stylesheet, NULL, iterations);
+    bench_print("static", finder_thread, &stat_static, iterations);
+
+    finder_thread->steal = true;
+    bench_stat_t stat_steal = bench_run(modest, finder_thread, stylesheet, NULL, iterations);
+    bench_print("steal", finder_thread, &stat_steal, iterations);
+
+    finder_thread->mode = MODEST_FINDER_THREAD_MODE_RIGHT_TO_LEFT;
+    bench_stat_t stat_rtl = bench_run(modest, finder_thread, stylesheet, NULL, iterations);
+    bench_print("rtl", finder_thread, &stat_rtl, iterations);
+
+    modest_finder_rules_t *rules = modest_finder_rules_create();
+    status = modest_finder_rules_init_by_stylesheet(rules, stylesheet, 0);
+
+    CHECK_STATUS("Can't init Modest Finder Rules object\n");
+
+    bench_stat_t stat_rules = bench_run(modest, finder_thread, stylesheet, rules, iterations);
+    bench_print("rules", finder_thread, &stat_rules, iterations);
+
+    if(stat_steal.min > 0)
+        printf("speedup: %.2fx\n", (stat_static.min / stat_steal.min));
+
+    if(stat_rtl.min > 0)
+        printf("speedup rtl: %.2fx\n", (stat_steal.min / stat_rtl.min));
+
+    /* destroy all */
+    modest_finder_rules_destroy(rules, true);
+    modest_finder_thread_destroy(finder_thread, true);
+    modest_finder_destroy(finder, true);
+
+    mycss_stylesheet_destroy(stylesheet, true);
+
+    myhtml_t* myhtml = modest->myhtml_tree->myhtml;
+    myhtml_tree_destroy(modest->myhtml_tree);
+    myhtml_destroy(myhtml);
+
+    mycss_t* mycss = modest->mycss_entry->mycss;
+    mycss_entry_destroy(modest->mycss_entry, true);
+    mycss_destroy(mycss, true);
+
+    modest_destroy(modest, true);
+
+    free(html.data);
+    free(css.data);
+
+    return 0;
+}
@@ -0,0 +1,10 @@
+mycore_dirs := .
+mycore_objs := $(call BINARY_UTILS_OBJS,mycore,$(mycore_dirs))
+
+mycore_all: $(mycore_objs)
+
+mycore_clean: 
+	rm -f $(mycore_objs)
+
+# arguments: [threads] [rounds]
+mycore_async_thread :=
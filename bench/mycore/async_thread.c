@@ -0,0 +1,154 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Contention of mcobject_async and mchar_async allocation from many threads.
+ * Every thread has its own node of one shared object and per round adds a node, allocates many small
+ * objects (strings) and deletes the node, so new chunks are taken all the time.
+ * Runs with 1 thread and with N threads; mallocs_per_sec of N threads close to N times of 1 thread is no contention.
+ *
+ * Usage: async_thread [threads] [rounds]
+ */
+
+#include "../bench.h"
+
+#include <pthread.h>
+
+#include <mycore/utils/mcobject_async.h>
+#include <mycore/utils/mchar_async.h>
+
+#define BENCH_DEFAULT_THREADS 4
+#define BENCH_DEFAULT_ROUNDS  50
+#define BENCH_ALLOCS          100000
+
+struct bench_thread {
+    pthread_t thread;
+
+    mcobject_async_t* mcobject;
+    mchar_async_t*    mchar;
+
+    size_t rounds;
+    size_t allocs;
+}
+typedef bench_thread_t;
+
+static void * bench_mcobject_async(void* arg)
+{
+    bench_thread_t *bt = (bench_thread_t*)arg;
+    mcobject_async_status_t status;
+
+    for(size_t round = 0; round < bt->rounds; round++)
+    {
+        size_t node_idx = mcobject_async_node_add(bt->mcobject, &status);
+        CHECK_STATUS("Can't add node to mcobject_async\n");
+
+        for(size_t i = 0; i < BENCH_ALLOCS; i++) {
+            size_t *obj = mcobject_async_malloc(bt->mcobject, node_idx, &status);
+            CHECK_STATUS("Can't allocate object by mcobject_async\n");
+
+            *obj = i;
+        }
+
+        bt->allocs += BENCH_ALLOCS;
+        mcobject_async_node_delete(bt->mcobject, node_idx);
+    }
+
+    return NULL;
+}
+
+static void * bench_mchar_async(void* arg)
+{
+    bench_thread_t *bt = (bench_thread_t*)arg;
+    mystatus_t status;
+
+    for(size_t round = 0; round < bt->rounds; round++)
+    {
+        size_t node_idx = mchar_async_node_add(bt->mchar, &status);
+        CHECK_STATUS("Can't add node to mchar_async\n");
+
+        for(size_t i = 0; i < BENCH_ALLOCS; i++) {
+            /* like text of tokens: from 8 to 71 chars */
+            size_t size = 8 + (i % 64);
+            char *data = mchar_async_malloc(bt->mchar, node_idx, size);
+
+            if(data == NULL)
+                DIE("Can't allocate chars by mchar_async\n");
+
+            data[0] = data[(size - 1)] = 'a';
+        }
+
+        bt->allocs += BENCH_ALLOCS;
+        mchar_async_node_delete(bt->mchar, node_idx);
+    }
+
+    return NULL;
+}
+
+static void bench_run(const char* mode, void * (*func)(void*), size_t threads, size_t rounds)
+{
+    mcobject_async_t *mcobject = mcobject_async_create();
+
+    if(mcobject == NULL || mcobject_async_init(mcobject, 128, 1024, sizeof(size_t) * 8))
+        DIE("Can't init mcobject_async\n");
+
+    mchar_async_t *mchar = mchar_async_create();
+
+    if(mchar == NULL || mchar_async_init(mchar, 128, 4096))
+        DIE("Can't init mchar_async\n");
+
+    /* tails of chunks are not cached by nodes, only taking of chunks is measured */
+    mchar_async_arena_set(mchar, true);
+
+    bench_thread_t *list = calloc(threads, sizeof(bench_thread_t));
+
+    if(list == NULL)
+        DIE("Can't allocate memory for threads\n");
+
+    double begin = bench_time();
+
+    for(size_t i = 0; i < threads; i++) {
+        list[i].mcobject = mcobject;
+        list[i].mchar    = mchar;
+        list[i].rounds   = rounds;
+
+        if(pthread_create(&list[i].thread, NULL, func, &list[i]))
+            DIE("Can't create thread\n");
+    }
+
+    size_t allocs = 0;
+
+    for(size_t i = 0; i < threads; i++) {
+        pthread_join(list[i].thread, NULL);
+        allocs += list[i].allocs;
+    }
+
+    double seconds = bench_time() - begin;
+
+    printf("{\"bench\": \"mycore/async_thread\", \"mode\": \"%s\", \"threads\": " MyCORE_FORMAT_Z ", "
+           "\"allocs\": " MyCORE_FORMAT_Z ", \"seconds\": %.6f, \"mallocs_per_sec\": %.0f, \"peak_rss_kb\": %ld}\n",
+           mode, threads, allocs, seconds, (seconds > 0 ? (double)allocs / seconds : 0), bench_peak_rss_kb());
+
+    fflush(stdout);
+
+    free(list);
+
+    mchar_async_destroy(mchar, 1);
+    mcobject_async_destroy(mcobject, 1);
+}
+
+int main(int argc, const char * argv[])
+{
+    size_t threads = bench_arg_size(argc, argv, 1, BENCH_DEFAULT_THREADS);
+    size_t rounds  = bench_arg_size(argc, argv, 2, BENCH_DEFAULT_ROUNDS);
+
+    bench_run("mcobject_async", bench_mcobject_async, 1, rounds);
+    bench_run("mcobject_async", bench_mcobject_async, threads, rounds);
+
+    bench_run("mchar_async", bench_mchar_async, 1, rounds);
+    bench_run("mchar_async", bench_mchar_async, threads, rounds);
+
+    return 0;
+}
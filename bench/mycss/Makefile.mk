@@ -0,0 +1,10 @@
+mycss_dirs := .
+mycss_objs := $(call BINARY_UTILS_OBJS,mycss,$(mycss_dirs))
+
+mycss_all: $(mycss_objs)
+
+mycss_clean: 
+	rm -f $(mycss_objs)
+
+# arguments: [<corpus>|-] [iterations] [threads]
+mycss_parse := $(or $(BENCH_CORPUS),-) $(BENCH_ITERATIONS)
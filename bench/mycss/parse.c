@@ -0,0 +1,190 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Parsing of a corpus of stylesheets (*.css; also gzipped) by mycss_parse and by mycss_parallel_parse,
+ * every stylesheet and all of them joined into one bundle.
+ * If the corpus has no stylesheets, contents of <style> elements of its HTML documents are used.
+ *
+ * Usage: parse [<corpus dir or file>|-] [iterations] [threads]
+ */
+
+#include "../bench.h"
+
+#include <mycss/mycss.h>
+#include <mycss/stylesheet.h>
+#include <mycss/parallel.h>
+
+#define BENCH_DEFAULT_THREADS 4
+
+static const char *bench_exts[] = {".css", NULL};
+static const char *bench_html_exts[] = {".html", ".htm", NULL};
+
+static const char * bench_find_case(const char* data, const char* end, const char* str)
+{
+    size_t len = strlen(str);
+
+    for(; (data + len) <= end; data++) {
+        if(mycore_strncasecmp(data, str, len) == 0)
+            return data;
+    }
+
+    return NULL;
+}
+
+static bench_corpus_t bench_corpus_styles(const char* path)
+{
+    bench_corpus_t html = bench_corpus_load(path, bench_html_exts);
+    bench_corpus_t corpus = {NULL, 0, 0, 0};
+
+    for(size_t i = 0; i < html.length; i++) {
+        const char *data = html.list[i].data;
+        const char *end  = &data[ html.list[i].size ];
+
+        while((data = bench_find_case(data, end, "<style"))) {
+            data = memchr(data, '>', (size_t)(end - data));
+            if(data == NULL)
+                break;
+
+            data++;
+
+            const char *close = bench_find_case(data, end, "</style");
+            if(close == NULL)
+                close = end;
+
+            if(close > data)
+                bench_corpus_add(&corpus, data, (size_t)(close - data));
+
+            data = close;
+        }
+    }
+
+    bench_corpus_destroy(&html);
+
+    return corpus;
+}
+
+static bench_corpus_t bench_corpus_bundle(bench_corpus_t* corpus)
+{
+    bench_res_t res = {NULL, 0};
+    size_t res_size = 0;
+
+    for(size_t i = 0; i < corpus->length; i++)
+        bench_res_append(&res, &res_size, corpus->list[i].data, corpus->list[i].size);
+
+    bench_corpus_t bundle = {NULL, 0, 0, 0};
+    bench_corpus_add(&bundle, res.data, res.size);
+
+    free(res.data);
+
+    return bundle;
+}
+
+static void bench_parse(mycss_t* mycss, bench_corpus_t* corpus, const char* mode, size_t iterations)
+{
+    mycss_entry_t *entry = mycss_entry_create();
+    mystatus_t status = mycss_entry_init(mycss, entry);
+
+    CHECK_STATUS("Can't init MyCSS Entry object\n");
+
+    bench_stat_t stat = {0};
+
+    for(size_t it = 0; it < iterations; it++) {
+        for(size_t i = 0; i < corpus->length; i++) {
+            double begin = bench_time();
+
+            status = mycss_parse(entry, MyENCODING_UTF_8, corpus->list[i].data, corpus->list[i].size);
+            CHECK_STATUS("Can't parse CSS\n");
+
+            bench_stat_add(&stat, (bench_time() - begin), corpus->list[i].size);
+
+            /* mycss_parse keeps memory of previous stylesheets */
+            mycss_stylesheet_destroy(mycss_entry_stylesheet(entry), true);
+            entry->stylesheet = NULL;
+
+            mycss_entry_clean_all(entry);
+        }
+    }
+
+    bench_stat_print_json("mycss_parse", mode, &stat);
+
+    bench_stat_clean(&stat);
+
+    mycss_entry_destroy(entry, true);
+}
+
+static void bench_parse_parallel(mycss_t* mycss, bench_corpus_t* corpus, const char* mode, size_t threads, size_t iterations)
+{
+    mycss_parallel_t *parallel = mycss_parallel_create();
+    mystatus_t status = mycss_parallel_init(parallel, mycss, threads);
+
+    CHECK_STATUS("Can't init MyCSS Parallel object\n");
+
+    bench_stat_t stat = {0};
+
+    for(size_t it = 0; it < iterations; it++) {
+        for(size_t i = 0; i < corpus->length; i++) {
+            double begin = bench_time();
+
+            status = mycss_parallel_parse(parallel, MyENCODING_UTF_8, corpus->list[i].data, corpus->list[i].size);
+            CHECK_STATUS("Can't parse CSS\n");
+
+            bench_stat_add(&stat, (bench_time() - begin), corpus->list[i].size);
+
+            /* as for mycss_parse, clean is not measured */
+            mycss_parallel_clean(parallel);
+        }
+    }
+
+    bench_stat_print_json("mycss_parallel_parse", mode, &stat);
+
+    bench_stat_clean(&stat);
+
+    mycss_parallel_destroy(parallel, true);
+}
+
+int main(int argc, const char * argv[])
+{
+    const char *path  = bench_arg_corpus(argc, argv, 1);
+    size_t iterations = bench_arg_size(argc, argv, 2, BENCH_DEFAULT_ITERATIONS);
+    size_t threads    = bench_arg_size(argc, argv, 3, BENCH_DEFAULT_THREADS);
+
+    bench_corpus_t corpus;
+
+    if(path) {
+        corpus = bench_corpus_load(path, bench_exts);
+
+        if(corpus.length == 0) {
+            bench_corpus_destroy(&corpus);
+            corpus = bench_corpus_styles(path);
+        }
+
+        if(corpus.length == 0)
+            DIE("No stylesheets in corpus: %s\n", path);
+    }
+    else
+        corpus = bench_corpus_get(NULL, bench_exts, bench_generate_css);
+
+    bench_corpus_t bundle = bench_corpus_bundle(&corpus);
+
+    mycss_t *mycss = mycss_create();
+    mystatus_t status = mycss_init(mycss);
+
+    CHECK_STATUS("Can't init MyCSS object\n");
+
+    bench_parse(mycss, &corpus, "single", iterations);
+    bench_parse_parallel(mycss, &corpus, "parallel", threads, iterations);
+
+    bench_parse(mycss, &bundle, "single_bundle", iterations);
+    bench_parse_parallel(mycss, &bundle, "parallel_bundle", threads, iterations);
+
+    mycss_destroy(mycss, true);
+
+    bench_corpus_destroy(&bundle);
+    bench_corpus_destroy(&corpus);
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Encoding of a corpus of HTML documents (*.html, *.htm, *.txt, *.warc; also gzipped):
+ * detection like a browser does it without transport layer (BOM, <meta> prescan, then myencoding_detect)
+ * and conversion of documents from the detected encoding to UTF-8.
+ *
+ * Usage: convert [<corpus dir or file>|-] [iterations]
+ */
+
+#include "../bench.h"
+
+#include <myencoding/encoding.h>
+#include <mycore/mystring.h>
+
+static const char *bench_exts[] = {".html", ".htm", ".txt", NULL};
+
+static myencoding_t bench_detect(const char* data, size_t size)
+{
+    myencoding_t encoding;
+
+    if(myencoding_detect_bom(data, size, &encoding))
+        return encoding;
+
+    encoding = myencoding_prescan_stream_to_determine_encoding(data, size);
+
+    if(encoding != MyENCODING_NOT_DETERMINED)
+        return encoding;
+
+    if(myencoding_detect(data, size, &encoding))
+        return encoding;
+
+    return MyENCODING_DEFAULT;
+}
+
+int main(int argc, const char * argv[])
+{
+    const char *path  = bench_arg_corpus(argc, argv, 1);
+    size_t iterations = bench_arg_size(argc, argv, 2, BENCH_DEFAULT_ITERATIONS);
+
+    bench_corpus_t corpus = bench_corpus_get(path, bench_exts, bench_generate_html);
+
+    myencoding_t *encodings = malloc(sizeof(myencoding_t) * corpus.length);
+    if(encodings == NULL)
+        DIE("Can't allocate mem for encodings\n");
+
+    /* detect */
+    bench_stat_t stat = {0};
+
+    for(size_t it = 0; it < iterations; it++) {
+        for(size_t i = 0; i < corpus.length; i++) {
+            double begin = bench_time();
+
+            encodings[i] = bench_detect(corpus.list[i].data, corpus.list[i].size);
+
+            bench_stat_add(&stat, (bench_time() - begin), corpus.list[i].size);
+        }
+    }
+
+    bench_stat_print_json("myencoding_detect", "bom_meta_detect", &stat);
+    bench_stat_clean(&stat);
+
+    /* convert */
+    mycore_string_raw_t str = {0};
+
+    for(size_t it = 0; it < iterations; it++) {
+        for(size_t i = 0; i < corpus.length; i++) {
+            mycore_string_raw_clean(&str);
+
+            double begin = bench_time();
+
+            myencoding_convert_to_ascii_utf_8(&str, corpus.list[i].data, corpus.list[i].size, encodings[i]);
+
+            bench_stat_add(&stat, (bench_time() - begin), corpus.list[i].size);
+        }
+    }
+
+    bench_stat_print_json("myencoding_convert", "to_utf_8", &stat);
+    bench_stat_clean(&stat);
+
+    mycore_string_raw_destroy(&str, false);
+    free(encodings);
+    bench_corpus_destroy(&corpus);
+
+    return 0;
+}
@@ -0,0 +1,13 @@
+myhtml_dirs := .
+myhtml_objs := $(call BINARY_UTILS_OBJS,myhtml,$(myhtml_dirs))
+
+myhtml_all: $(myhtml_objs)
+
+myhtml_clean: 
+	rm -f $(myhtml_objs)
+
+# arguments: [<corpus>|-] [iterations] [threads]
+myhtml_parse := $(or $(BENCH_CORPUS),-) $(BENCH_ITERATIONS)
+
+# arguments: [<corpus>|-] [iterations] [threads]
+myhtml_pool := $(or $(BENCH_CORPUS),-) $(BENCH_ITERATIONS)
@@ -0,0 +1,123 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Parsing of a corpus of HTML documents (*.html, *.htm, *.warc; also gzipped) by myhtml_parse,
+ * in single mode, in single mode with lazy strings (text and attribute values are not decoded)
+ * and with the tree built in separate threads, and serialization of parsed trees.
+ * Documents are parsed as UTF-8 by one reused tree.
+ *
+ * Usage: parse [<corpus dir or file>|-] [iterations] [threads]
+ */
+
+#include "../bench.h"
+
+#include <myhtml/myhtml.h>
+#include <myhtml/serialization.h>
+
+#define BENCH_DEFAULT_THREADS 2
+
+static const char *bench_exts[] = {".html", ".htm", NULL};
+
+static myhtml_tree_t * bench_tree_create(enum myhtml_options opt, size_t threads)
+{
+    myhtml_t* myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, opt, threads, 0);
+
+    CHECK_STATUS("Can't init MyHTML object\n");
+
+    myhtml_tree_t* tree = myhtml_tree_create();
+    status = myhtml_tree_init(tree, myhtml);
+
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+
+    return tree;
+}
+
+static void bench_tree_destroy(myhtml_tree_t* tree)
+{
+    myhtml_t* myhtml = tree->myhtml;
+
+    myhtml_tree_destroy(tree);
+    myhtml_destroy(myhtml);
+}
+
+static void bench_parse(bench_corpus_t* corpus, const char* mode, enum myhtml_options opt, size_t threads, size_t iterations,
+                        myhtml_tree_parse_flags_t parse_flags)
+{
+    myhtml_tree_t* tree = bench_tree_create(opt, threads);
+    bench_stat_t stat = {0};
+
+    myhtml_tree_parse_flags_set(tree, parse_flags);
+
+    for(size_t it = 0; it < iterations; it++) {
+        for(size_t i = 0; i < corpus->length; i++) {
+            double begin = bench_time();
+
+            mystatus_t status = myhtml_parse(tree, MyENCODING_UTF_8, corpus->list[i].data, corpus->list[i].size);
+            CHECK_STATUS("Can't parse HTML\n");
+
+            bench_stat_add(&stat, (bench_time() - begin), corpus->list[i].size);
+        }
+    }
+
+    bench_stat_print_json("myhtml_parse", mode, &stat);
+
+    bench_stat_clean(&stat);
+    bench_tree_destroy(tree);
+}
+
+static void bench_serialization(bench_corpus_t* corpus, size_t iterations)
+{
+    myhtml_tree_t* tree = bench_tree_create(MyHTML_OPTIONS_PARSE_MODE_SINGLE, 1);
+    bench_stat_t stat = {0};
+
+    mycore_string_raw_t str = {0};
+
+    for(size_t i = 0; i < corpus->length; i++) {
+        mystatus_t status = myhtml_parse(tree, MyENCODING_UTF_8, corpus->list[i].data, corpus->list[i].size);
+        CHECK_STATUS("Can't parse HTML\n");
+
+        for(size_t it = 0; it < iterations; it++) {
+            mycore_string_raw_clean(&str);
+
+            double begin = bench_time();
+
+            status = myhtml_serialization_tree_buffer(myhtml_tree_get_document(tree), &str);
+            CHECK_STATUS("Can't serialize HTML\n");
+
+            bench_stat_add(&stat, (bench_time() - begin), str.length);
+        }
+    }
+
+    bench_stat_print_json("myhtml_serialization", "single", &stat);
+
+    mycore_string_raw_destroy(&str, false);
+    bench_stat_clean(&stat);
+    bench_tree_destroy(tree);
+}
+
+int main(int argc, const char * argv[])
+{
+    const char *path  = bench_arg_corpus(argc, argv, 1);
+    size_t iterations = bench_arg_size(argc, argv, 2, BENCH_DEFAULT_ITERATIONS);
+    size_t threads    = bench_arg_size(argc, argv, 3, BENCH_DEFAULT_THREADS);
+
+    bench_corpus_t corpus = bench_corpus_get(path, bench_exts, bench_generate_html);
+
+    bench_parse(&corpus, "single", MyHTML_OPTIONS_PARSE_MODE_SINGLE, 1, iterations, MyHTML_TREE_PARSE_FLAGS_CLEAN);
+    bench_parse(&corpus, "single_lazy", MyHTML_OPTIONS_PARSE_MODE_SINGLE, 1, iterations, MyHTML_TREE_PARSE_FLAGS_LAZY_STRINGS);
+
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    bench_parse(&corpus, "separately", MyHTML_OPTIONS_PARSE_MODE_SEPARATELY, threads, iterations, MyHTML_TREE_PARSE_FLAGS_CLEAN);
+#endif
+
+    bench_serialization(&corpus, iterations);
+
+    bench_corpus_destroy(&corpus);
+
+    return 0;
+}
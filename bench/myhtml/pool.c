@@ -0,0 +1,114 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Parsing of a corpus of HTML documents by myhtml_pool_parse with 1, 2, 4... threads up to the given count,
+ * every document is parsed whole by one thread of pool.
+ * Seconds are of wall time from the first submit to the end of the last document,
+ * latency is from submit of a document to its callback, wait in queue included.
+ *
+ * Usage: pool [<corpus dir or file>|-] [iterations] [threads]
+ */
+
+#include "../bench.h"
+
+#include <myhtml/myhtml.h>
+
+static const char *bench_exts[] = {".html", ".htm", NULL};
+
+struct bench_doc {
+    bench_res_t* res;
+    double time;
+}
+typedef bench_doc_t;
+
+static void bench_callback_done(myhtml_tree_t* tree, mystatus_t status, void* ctx)
+{
+    bench_doc_t *doc = (bench_doc_t*)ctx;
+
+    CHECK_STATUS("Can't parse HTML\n");
+
+    doc->time = bench_time() - doc->time;
+}
+
+static void bench_pool(bench_corpus_t* corpus, size_t threads, size_t iterations)
+{
+    myhtml_pool_t *pool = myhtml_pool_create();
+    mystatus_t status = myhtml_pool_init(pool, threads, 0);
+
+    CHECK_STATUS("Can't init MyHTML Pool object\n");
+
+    bench_doc_t *docs = (bench_doc_t*)calloc(corpus->length, sizeof(bench_doc_t));
+    if(docs == NULL)
+        DIE("Can't allocate mem for documents\n");
+
+    bench_stat_t stat = {0};
+    double wall = 0;
+
+    for(size_t it = 0; it < iterations; it++) {
+        double begin = bench_time();
+
+        for(size_t i = 0; i < corpus->length; i++) {
+            docs[i].res  = &corpus->list[i];
+            docs[i].time = bench_time();
+
+            status = myhtml_pool_parse(pool, MyENCODING_UTF_8, corpus->list[i].data, corpus->list[i].size,
+                                       bench_callback_done, &docs[i]);
+            CHECK_STATUS("Can't submit HTML to pool\n");
+        }
+
+        myhtml_pool_wait_for_all_done(pool);
+        wall += bench_time() - begin;
+
+        for(size_t i = 0; i < corpus->length; i++)
+            bench_stat_add(&stat, docs[i].time, docs[i].res->size);
+    }
+
+    /* throughput by wall time */
+    stat.total = wall;
+
+    char mode[64];
+    snprintf(mode, sizeof(mode), "threads_" MyCORE_FORMAT_Z, myhtml_pool_tree_count(pool));
+
+    bench_stat_print_json("myhtml_pool_parse", mode, &stat);
+
+    bench_stat_clean(&stat);
+    free(docs);
+
+    myhtml_pool_destroy(pool, true);
+}
+
+/* count of online processors, 1 without threads */
+static size_t bench_pool_default_threads(void)
+{
+    myhtml_pool_t *pool = myhtml_pool_create();
+    mystatus_t status = myhtml_pool_init(pool, 0, 0);
+
+    CHECK_STATUS("Can't init MyHTML Pool object\n");
+
+    size_t threads = myhtml_pool_tree_count(pool);
+    myhtml_pool_destroy(pool, true);
+
+    return threads;
+}
+
+int main(int argc, const char * argv[])
+{
+    const char *path  = bench_arg_corpus(argc, argv, 1);
+    size_t iterations = bench_arg_size(argc, argv, 2, BENCH_DEFAULT_ITERATIONS);
+    size_t threads    = bench_arg_size(argc, argv, 3, bench_pool_default_threads());
+
+    bench_corpus_t corpus = bench_corpus_get(path, bench_exts, bench_generate_html);
+
+    for(size_t count = 1; count < threads; count *= 2)
+        bench_pool(&corpus, count, iterations);
+
+    bench_pool(&corpus, threads, iterations);
+
+    bench_corpus_destroy(&corpus);
+
+    return 0;
+}
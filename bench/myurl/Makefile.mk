@@ -0,0 +1,10 @@
+myurl_dirs := .
+myurl_objs := $(call BINARY_UTILS_OBJS,myurl,$(myurl_dirs))
+
+myurl_all: $(myurl_objs)
+
+myurl_clean: 
+	rm -f $(myurl_objs)
+
+# arguments: [<corpus>|-] [iterations]
+myurl_parse := $(or $(BENCH_CORPUS),-) $(BENCH_ITERATIONS)
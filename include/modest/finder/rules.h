@@ -0,0 +1,161 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#ifndef MODEST_FINDER_RULES_H
+#define MODEST_FINDER_RULES_H
+#pragma once
+
+#include <modest/finder/myosi.h>
+#include <modest/finder/finder.h>
+#include <myhtml/tree.h>
+#include <mycss/stylesheet.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* counters of ancestor keys, must be power of two */
+#define MODEST_FINDER_RULES_BLOOM_SIZE 4096
+
+/*
+ * Right-to-left matching.
+ * Every selector is a rule indexed by a key of its rightmost compound selector (id, class or tag).
+ * For a node only rules from buckets of its own keys are checked, from right to left,
+ * and rules whose ancestors can't be present are dropped by a Bloom filter of ancestor keys.
+ *
+ * Rules are compiled once per stylesheet and don't change after init,
+ * so one object can be shared by any number of threads and documents.
+ * All state of matching lives in modest_finder_rules_context_t.
+ */
+struct modest_finder_rule {
+    mycss_selectors_list_t* selector_list;
+    mycss_selectors_entries_list_t* entries;
+    mycss_selectors_entry_t* entry_last;
+    mycss_declaration_entry_t* declaration;
+    
+    /* specificity of the selector; rules are sorted by it, then by source order */
+    mycss_selectors_specificity_t specificity;
+    size_t order;
+    
+    /* key of specificity and order for collation, see modest_style_raw_cascade_key */
+    unsigned long long cascade_key;
+    
+    /* first entry of every compound selector, from left to right */
+    mycss_selectors_entry_t** compound;
+    size_t compound_length;
+    
+    /* id, class and tag keys of compound selectors which must be ancestors */
+    size_t* ancestor_keys;
+    size_t ancestor_keys_length;
+    
+    /* key of the rightmost compound selector; 0 for universal */
+    size_t key;
+};
+
+struct modest_finder_rules_bucket {
+    size_t key;
+    size_t begin;
+    size_t length;
+};
+
+struct modest_finder_rules {
+    modest_finder_rule_t* list;
+    size_t list_length;
+    size_t list_size;
+    
+    /* source order of the first rule; rules of the next stylesheet start at modest_finder_rules_order_end */
+    size_t order_base;
+    
+    /* open addressing, key => indexes of rules in specificity order */
+    modest_finder_rules_bucket_t* buckets;
+    size_t buckets_size;
+    size_t* bucket_rules;
+    
+    /* rules without key, are checked for every node */
+    size_t* universal;
+    size_t universal_length;
+};
+
+struct modest_finder_rules_ancestor {
+    myhtml_tree_node_t* node;
+    size_t keys_begin;
+};
+
+/* one for every thread */
+struct modest_finder_rules_context {
+    unsigned char bloom[MODEST_FINDER_RULES_BLOOM_SIZE];
+    
+    /* ancestors of the last node from scope, and their keys */
+    modest_finder_rules_ancestor_t* stack;
+    size_t stack_length;
+    size_t stack_size;
+    
+    size_t* stack_keys;
+    size_t stack_keys_length;
+    size_t stack_keys_size;
+    
+    myhtml_tree_node_t* scope;
+    myhtml_tree_node_t* last;
+    
+    size_t* keys;
+    size_t keys_length;
+    size_t keys_size;
+    
+    size_t* candidates;
+    size_t candidates_length;
+    size_t candidates_size;
+    
+    /* rule of the node given to callback_found */
+    modest_finder_rule_t* rule;
+};
+
+modest_finder_rules_t * modest_finder_rules_create(void);
+mystatus_t modest_finder_rules_init(modest_finder_rules_t* rules, mycss_selectors_list_t* selector_list, size_t base_order);
+mystatus_t modest_finder_rules_init_by_stylesheet(modest_finder_rules_t* rules, mycss_stylesheet_t* stylesheet, size_t base_order);
+void modest_finder_rules_clean(modest_finder_rules_t* rules);
+modest_finder_rules_t * modest_finder_rules_destroy(modest_finder_rules_t* rules, bool self_destroy);
+
+size_t modest_finder_rules_order_end(modest_finder_rules_t* rules);
+
+modest_finder_rules_context_t * modest_finder_rules_context_create(void);
+mystatus_t modest_finder_rules_context_init(modest_finder_rules_context_t* context);
+void modest_finder_rules_context_clean(modest_finder_rules_context_t* context, myhtml_tree_node_t* scope_node);
+modest_finder_rules_context_t * modest_finder_rules_context_destroy(modest_finder_rules_context_t* context, bool self_destroy);
+
+/* nodes must be in document order and inside the scope node of context */
+mystatus_t modest_finder_rules_process(modest_finder_t* finder, modest_finder_rules_t* rules, modest_finder_rules_context_t* context,
+                                       myhtml_tree_node_t** nodes, size_t nodes_length,
+                                       modest_finder_callback_f callback_found, void* ctx);
+
+mystatus_t modest_finder_rules_process_node(modest_finder_t* finder, modest_finder_rules_t* rules, modest_finder_rules_context_t* context,
+                                            myhtml_tree_node_t* node, modest_finder_callback_f callback_found, void* ctx);
+
+/* all nodes of scope_node with a temporary context, for a single document */
+mystatus_t modest_finder_rules_find(modest_finder_t* finder, modest_finder_rules_t* rules, myhtml_tree_node_t* scope_node,
+                                    modest_finder_callback_f callback_found, void* ctx);
+
+mystatus_t modest_finder_by_rules(modest_finder_t* finder, myhtml_tree_node_t* scope_node,
+                                  modest_finder_rules_t* rules, myhtml_collection_t** collection);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* MODEST_FINDER_RULES_H */
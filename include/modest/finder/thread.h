@@ -28,9 +28,11 @@
 #include <modest/style/map.h>
 #include <modest/finder/myosi.h>
 #include <modest/finder/finder.h>
+#include <modest/finder/rules.h>
 
 #include <mycore/mythread.h>
 #include <mycore/utils/mcobject_async.h>
+#include <mycore/utils/mcdeque.h>
 
 #include <mycss/declaration/myosi.h>
 
@@ -38,6 +40,17 @@
 extern "C" {
 #endif
 
+/* nodes of scope given to a thread at once in right to left mode */
+#define MODEST_FINDER_THREAD_NODE_CHUNK_SIZE 128
+
+enum modest_finder_thread_mode {
+    /* for every selector walk the scope, see modest_finder_node_combinator_begin */
+    MODEST_FINDER_THREAD_MODE_LEFT_TO_RIGHT = 0x00,
+    /* for every node check candidate rules, see modest_finder_rules_process */
+    MODEST_FINDER_THREAD_MODE_RIGHT_TO_LEFT = 0x01
+}
+typedef modest_finder_thread_mode_t;
+
 struct modest_finder_thread_declaration {
     mycss_declaration_entry_t* entry;
     modest_style_raw_specificity_t raw_spec;
@@ -61,6 +74,31 @@ struct modest_finder_thread_context {
     modest_finder_thread_entry_t* entry_last;
     size_t entry_node_id;
     size_t declaration_node_id;
+    
+    /* open addressing index, node => entry */
+    modest_finder_thread_entry_t** index;
+    size_t index_size;
+    size_t index_length;
+    
+    /* for right to left mode */
+    modest_finder_rules_context_t* rules_context;
+    
+    /* statistics for the last process */
+    size_t work_done;
+    size_t work_stolen;
+    
+    /* first error of callback_found or of rules matching in the last process */
+    mystatus_t status;
+    
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    /* indexes of finder_thread->work_list owned by this thread */
+    mcdeque_t deque;
+#endif
+};
+
+struct modest_finder_thread_work {
+    mycss_selectors_list_t* selector_list;
+    mycss_selectors_entries_list_t* entries;
 };
 
 struct modest_finder_thread {
@@ -72,15 +110,47 @@ struct modest_finder_thread {
     mcobject_async_t* entry_obj;
     mcobject_async_t* declaration_obj;
     
+    /* all selectors of one process, split between threads */
+    modest_finder_thread_work_t* work_list;
+    size_t work_list_size;
+    size_t work_list_length;
+    
+    /* threads take work from others when their own is over; default true */
+    bool steal;
+    
+    /* default MODEST_FINDER_THREAD_MODE_LEFT_TO_RIGHT */
+    modest_finder_thread_mode_t mode;
+    
+    /* origin of stylesheets for cascade keys; default MODEST_STYLE_RAW_ORIGIN_AUTHOR */
+    modest_style_raw_origin_t origin;
+    
+    /*
+     * source order of the first selector of the next process, default 0;
+     * every process moves it past own selectors (or rules), so a later stylesheet wins ties.
+     * modest_finder_thread_clean sets it to 0 for a new cascade, so do not clean between stylesheets of one.
+     */
+    size_t order_base;
+    
+    /* right to left mode: rules of selector_list and nodes of scope in document order */
+    modest_finder_rules_t* rules;
+    myhtml_tree_node_t** node_list;
+    size_t node_list_size;
+    size_t node_list_length;
+    
     /* refs */
     modest_finder_t* finder;
     myhtml_tree_node_t* base_node;
     mycss_selectors_list_t* selector_list;
+    /* rules of current process, right to left if not NULL */
+    modest_finder_rules_t* rules_ref;
 };
 
 struct modest_finder_thread_found_context {
     modest_finder_thread_t* finder_thread;
     modest_finder_thread_context_t* context;
+    
+    /* left to right mode: source order of the selector being matched */
+    size_t order;
 };
 
 
@@ -90,6 +160,8 @@ void modest_finder_thread_clean(modest_finder_thread_t* finder_thread, bool self
 modest_finder_thread_t * modest_finder_thread_destroy(modest_finder_thread_t* finder_thread, bool self_destroy);
 
 mystatus_t modest_finder_thread_process(modest_t* modest, modest_finder_thread_t* finder_thread, myhtml_tree_node_t* scope_node, mycss_selectors_list_t* selector_list);
+/* right to left with rules compiled once, see modest_finder_rules_init_by_stylesheet; rules are not changed */
+mystatus_t modest_finder_thread_process_rules(modest_t* modest, modest_finder_thread_t* finder_thread, myhtml_tree_node_t* scope_node, modest_finder_rules_t* rules);
 
 #ifndef MyCORE_BUILD_WITHOUT_THREADS
 void modest_finder_thread_wait_for_all_done(modest_finder_thread_t* finder_thread);
@@ -68,12 +68,14 @@ enum modest_status {
     MODEST_STATUS_ERROR_STYLE_DECLARATION_INIT   = 0x020123,
     MODEST_STATUS_ERROR_AVL_TREE_CREATE          = 0x020124,
     MODEST_STATUS_ERROR_AVL_TREE_INIT            = 0x020125,
+    MODEST_STATUS_ERROR_NODE_PROPERTY_CREATE     = 0x020126,
 }
 typedef modest_status_t;
 
 typedef struct modest modest_t;
 typedef struct modest_node modest_node_t;
 typedef struct modest_style_sheet modest_style_sheet_t;
+typedef struct modest_style_computed modest_style_computed_t;
 
 #ifdef __cplusplus
 } /* extern "C" */
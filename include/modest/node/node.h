@@ -26,20 +26,19 @@
 #include <modest/modest.h>
 #include <modest/style/raw.h>
 #include <modest/render/tree_node.h>
-#include <mycore/utils/avl_tree.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+typedef void (*modest_node_raw_declaration_callback_f)(mycss_property_type_t type, modest_style_raw_declaration_t *raw_declr, void* context);
+
+/*
+ * Cascaded declarations of node are kept by the library after modest_node_t, in a store
+ * chosen by MODEST_BUILD_NODE_STORE (see modest/node/store.h in source); use functions below for them.
+ */
 struct modest_node {
     modest_style_sheet_t* stylesheet;
-#ifndef MODEST_NODE_FULL_RAW
-    mycore_utils_avl_tree_node_t *avl_tree_node;
-#else
-    modest_style_raw_declaration_t * raw_declaration[MyCSS_PROPERTY_TYPE_LAST_ENTRY];
-#endif /* MODEST_NODE_FULL_RAW */
-    
     modest_render_tree_node_t* render_node;
 };
 
@@ -49,7 +48,11 @@ mystatus_t modest_node_init(modest_t* modest, modest_node_t *mnode);
 mycss_declaration_entry_t * modest_node_declaration_by_type(modest_t* modest, modest_node_t *mnode, mycss_property_type_t type);
 
 modest_style_raw_declaration_t * modest_node_raw_declaration_by_type(modest_t* modest, modest_node_t *mnode, mycss_property_type_t type);
-void modest_node_raw_declaration_set_by_type(modest_t* modest, modest_node_t *mnode, mycss_property_type_t type, modest_style_raw_declaration_t *raw_declr);
+mystatus_t modest_node_raw_declaration_set_by_type(modest_t* modest, modest_node_t *mnode, mycss_property_type_t type, modest_style_raw_declaration_t *raw_declr);
+void modest_node_raw_declaration_list_all(modest_t* modest, modest_node_t *mnode, modest_node_raw_declaration_callback_f callback, void* context);
+
+/* name of store of library build: "flat", "avl_tree" or "full_raw" */
+const char * modest_node_store_name(void);
 
 #ifdef __cplusplus
 } /* extern "C" */
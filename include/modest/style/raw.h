@@ -33,11 +33,31 @@ extern "C" {
 typedef struct modest_style_raw_declaration modest_style_raw_declaration_t;
 typedef struct modest_style_raw_specificity modest_style_raw_specificity_t;
 
+/* bits of cascade key, see modest_style_raw_cascade_key */
+#define MODEST_STYLE_RAW_CASCADE_ORDER_BITS 37
+#define MODEST_STYLE_RAW_CASCADE_ORDER_MAX  ((1ULL << MODEST_STYLE_RAW_CASCADE_ORDER_BITS) - 1ULL)
+#define MODEST_STYLE_RAW_CASCADE_SPEC_MAX   0xff
+#define MODEST_STYLE_RAW_CASCADE_ORIGIN_SHIFT 61
+#define MODEST_STYLE_RAW_CASCADE_IMPORTANT  (1ULL << 63)
+
+enum modest_style_raw_origin {
+    MODEST_STYLE_RAW_ORIGIN_USER_AGENT = 0x00,
+    MODEST_STYLE_RAW_ORIGIN_USER       = 0x01,
+    MODEST_STYLE_RAW_ORIGIN_AUTHOR     = 0x02
+}
+typedef modest_style_raw_origin_t;
+
+/*
+ * Cascade key, of two declarations the one with greater or equal key (later) wins:
+ *   63     -- !important
+ *   61..62 -- origin, reversed for !important
+ *   37..60 -- specificity a, b, c by 8 bits
+ *   0..36  -- order of selector in stylesheet
+ * a, b and c saturate at MODEST_STYLE_RAW_CASCADE_SPEC_MAX (255), so all selectors with 255 or more
+ * ids (classes, types) have equal a (b, c); order saturates at MODEST_STYLE_RAW_CASCADE_ORDER_MAX.
+ */
 struct modest_style_raw_specificity {
-    unsigned int x;
-    unsigned int a;
-    unsigned int b;
-    unsigned int c;
+    unsigned long long key;
 };
 
 struct modest_style_raw_declaration {
@@ -47,6 +67,9 @@ struct modest_style_raw_declaration {
 
 modest_style_raw_declaration_t * modest_style_raw_declaration_create(modest_t* modest);
 
+unsigned long long modest_style_raw_cascade_key(unsigned int a, unsigned int b, unsigned int c, size_t order);
+unsigned long long modest_style_raw_cascade_key_declaration(unsigned long long key, modest_style_raw_origin_t origin, bool is_important);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -50,6 +50,14 @@ struct modest_style_sheet {
     modest_style_type_length_t border_right_width;
     modest_style_type_length_t border_bottom_width;
     modest_style_type_length_t border_left_width;
+    
+    /* inherited */
+    modest_style_type_color_t color;
+    
+    modest_style_type_length_t font_size;
+    modest_style_type_font_weight_t font_weight;
+    modest_style_type_font_style_t font_style;
+    modest_style_type_length_t line_height;
 };
 
 modest_style_sheet_t * modest_style_sheet_create(modest_t* modest);
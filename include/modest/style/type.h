@@ -33,15 +33,40 @@ extern "C" {
 
 typedef struct modest_style_type_length modest_style_type_length_t;
 typedef struct modest_style_type_display modest_style_type_display_t;
+typedef struct modest_style_type_color modest_style_type_color_t;
+typedef struct modest_style_type_font_weight modest_style_type_font_weight_t;
+typedef struct modest_style_type_font_style modest_style_type_font_style_t;
 
+/*
+ type is MyCSS_PROPERTY_VALUE__LENGTH for value in px,
+ MyCSS_PROPERTY_VALUE__PERCENTAGE and MyCSS_PROPERTY_VALUE__NUMBER for value as is
+ or keyword of property (auto, normal...) with value 0
+*/
 struct modest_style_type_length {
     float value;
+    unsigned int type;
 };
 
 struct modest_style_type_display {
     mycss_property_display_t value;
 };
 
+struct modest_style_type_color {
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+};
+
+/* 1..1000, normal is 400, bold is 700 */
+struct modest_style_type_font_weight {
+    unsigned int value;
+};
+
+struct modest_style_type_font_style {
+    mycss_property_font_style_t value;
+};
+
 
 void * modest_style_type_create(modest_t* modest, size_t size);
 mystatus_t modest_style_type_init(modest_t* modest, void *data);
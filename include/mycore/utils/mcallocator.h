@@ -0,0 +1,76 @@
+/*
+ Copyright (C) 2015-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#ifndef MyCORE_UTILS_MCALLOCATOR_H
+#define MyCORE_UTILS_MCALLOCATOR_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <mycore/myosi.h>
+#include <mycore/utils/mcsync.h>
+
+/* every block of allocator begins with its size, block data stays aligned as after malloc */
+#define MCALLOCATOR_HEADER_SIZE (sizeof(size_t) * 2)
+
+typedef void * (*mcallocator_malloc_f)(size_t size, void* ctx);
+typedef void * (*mcallocator_realloc_f)(void* dst, size_t size, void* ctx);
+typedef void (*mcallocator_free_f)(void* dst, void* ctx);
+
+struct mcallocator {
+    mcallocator_malloc_f  malloc;
+    mcallocator_realloc_f realloc;
+    mcallocator_free_f    free;
+    void* ctx;
+    
+    /* bytes in use and the most bytes in use since init or clean */
+    volatile size_t bytes;
+    volatile size_t bytes_peak;
+    
+    /* 0 for without limit */
+    size_t limit;
+}
+typedef mcallocator_t;
+
+mcallocator_t * mcallocator_create(void);
+mystatus_t mcallocator_init(mcallocator_t* allocator, mcallocator_malloc_f malloc_f,
+                            mcallocator_realloc_f realloc_f, mcallocator_free_f free_f, void* ctx);
+void mcallocator_clean(mcallocator_t* allocator);
+mcallocator_t * mcallocator_destroy(mcallocator_t* allocator, bool self_destroy);
+
+void * mcallocator_malloc(mcallocator_t* allocator, size_t size);
+void * mcallocator_realloc(mcallocator_t* allocator, void* dst, size_t size);
+void * mcallocator_calloc(mcallocator_t* allocator, size_t num, size_t size);
+void * mcallocator_free(mcallocator_t* allocator, void* dst);
+
+size_t mcallocator_bytes(mcallocator_t* allocator);
+size_t mcallocator_bytes_peak(mcallocator_t* allocator);
+
+void mcallocator_limit_set(mcallocator_t* allocator, size_t limit);
+size_t mcallocator_limit(mcallocator_t* allocator);
+bool mcallocator_limit_exceeded(mcallocator_t* allocator);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* MyCORE_UTILS_MCALLOCATOR_H */
@@ -0,0 +1,67 @@
+/*
+ Copyright (C) 2015-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+ */
+
+#ifndef MyCORE_UTILS_MCDEQUE_H
+#define MyCORE_UTILS_MCDEQUE_H
+#pragma once
+
+#include <mycore/myosi.h>
+#include <mycore/utils/mcsync.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+/*
+ * Fixed size work-stealing deque (Chase-Lev) of size_t values.
+ * The owner thread pushes and pops at the bottom, any other thread
+ * steals from the top. top and bottom only grow, list is a ring.
+ */
+struct mcdeque {
+    size_t* list;
+    size_t  size;
+    
+    volatile size_t top;
+    volatile size_t bottom;
+}
+typedef mcdeque_t;
+
+mcdeque_t * mcdeque_create(void);
+mystatus_t mcdeque_init(mcdeque_t* deque, size_t size);
+void mcdeque_clean(mcdeque_t* deque);
+mcdeque_t * mcdeque_destroy(mcdeque_t* deque, bool self_destroy);
+
+/* not thread safe, only for empty and not shared deque */
+mystatus_t mcdeque_resize(mcdeque_t* deque, size_t size);
+
+/* owner only */
+bool mcdeque_push(mcdeque_t* deque, size_t value);
+bool mcdeque_pop(mcdeque_t* deque, size_t* value);
+
+/* any thread */
+bool mcdeque_steal(mcdeque_t* deque, size_t* value);
+#endif
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* MyCORE_UTILS_MCDEQUE_H */
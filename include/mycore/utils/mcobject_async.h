@@ -28,6 +28,10 @@ extern "C" {
 
 #include <mycore/myosi.h>
 #include <mycore/utils/mcsync.h>
+#include <mycore/utils/mcallocator.h>
+
+/* chunks taken by a node at once, from free chunks or from chunks array under lock */
+#define MCOBJECT_ASYNC_MAGAZINE_SIZE 8
 
 enum mcobject_async_status {
     MCOBJECT_ASYNC_STATUS_OK                                  = 0,
@@ -53,6 +57,9 @@ typedef mcobject_async_chunk_t;
 struct mcobject_async_node {
     mcobject_async_chunk_t *chunk;
     
+    /* chunks reserved by node, linked by next; used without lock */
+    mcobject_async_chunk_t *magazine;
+    
     void  **cache;
     size_t  cache_size;
     size_t  cache_length;
@@ -64,9 +71,8 @@ struct mcobject_async {
     size_t  struct_size;
     size_t  struct_size_sn;
     
-    mcobject_async_chunk_t **chunk_cache;
-    size_t  chunk_cache_size;
-    size_t  chunk_cache_length;
+    /* lock-free stack of free chunks (mcobject_async_chunk_t*), linked by next */
+    volatile size_t chunk_free;
     
     mcobject_async_chunk_t **chunks;
     size_t chunks_pos_size;
@@ -82,6 +88,12 @@ struct mcobject_async {
     size_t nodes_cache_length;
     size_t nodes_cache_size;
     
+    /* bump allocation only: free does not fill node caches, clean rewinds chunks */
+    bool arena;
+    
+    /* NULL for mycore_malloc */
+    mcallocator_t *allocator;
+    
     mcsync_t *mcsync;
 }
 typedef mcobject_async_t;
@@ -91,6 +103,8 @@ mcobject_async_status_t mcobject_async_init(mcobject_async_t *mcobj_async, size_
 
 void mcobject_async_clean(mcobject_async_t *mcobj_async);
 mcobject_async_t * mcobject_async_destroy(mcobject_async_t *mcobj_async, int destroy_self);
+void mcobject_async_arena_set(mcobject_async_t *mcobj_async, bool arena);
+void mcobject_async_allocator_set(mcobject_async_t *mcobj_async, mcallocator_t *allocator);
 
 size_t mcobject_async_node_add(mcobject_async_t *mcobj_async, mcobject_async_status_t *status);
 void mcobject_async_node_clean(mcobject_async_t *mcobj_async, size_t node_idx);
@@ -27,6 +27,7 @@ extern "C" {
 #endif
 
 #include <mycore/myosi.h>
+#include <mycore/utils/mcallocator.h>
 
 struct mcsimple {
     size_t  struct_size;
@@ -38,6 +39,9 @@ struct mcsimple {
     size_t list_pos_length_used;
     size_t list_size;
     size_t list_length;
+    
+    /* NULL for mycore_malloc */
+    mcallocator_t *allocator;
 }
 typedef mcsimple_t;
 
@@ -46,6 +50,7 @@ mcsimple_t * mcsimple_create(void);
 void mcsimple_init(mcsimple_t *mcsimple, size_t pos_size, size_t list_size, size_t struct_size);
 void mcsimple_clean(mcsimple_t *mcsimple);
 mcsimple_t * mcsimple_destroy(mcsimple_t *mcsimple, bool destroy_self);
+void mcsimple_allocator_set(mcsimple_t *mcsimple, mcallocator_t *allocator);
 
 uint8_t * mcsimple_init_list_entries(mcsimple_t *mcsimple, size_t pos);
 
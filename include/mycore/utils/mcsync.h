@@ -66,6 +66,13 @@ void * mcsync_mutex_create(void);
 mcsync_status_t mcsync_mutex_init(void* mutex);
 void mcsync_mutex_clean(void* mutex);
 void mcsync_mutex_destroy(void* mutex);
+
+/* atomic operations on size_t, all of them are sequentially consistent */
+size_t mcsync_atomic_load(volatile size_t* value);
+void mcsync_atomic_store(volatile size_t* value, size_t new_value);
+bool mcsync_atomic_compare_exchange(volatile size_t* value, size_t expected, size_t desired);
+size_t mcsync_atomic_fetch_add(volatile size_t* value, size_t add);
+void mcsync_atomic_fence(void);
 #endif
 
 #ifdef __cplusplus
@@ -90,7 +90,10 @@ enum mycss_status {
     MyCSS_STATUS_ERROR_DECLARATION_INIT                 = 0x010701,
     MyCSS_STATUS_ERROR_DECLARATION_ENTRY_CREATE         = 0x010702,
     MyCSS_STATUS_ERROR_DECLARATION_ENTRY_INIT           = 0x010703,
-    MyCSS_STATUS_ERROR_PARSER_LIST_CREATE               = 0x010800
+    MyCSS_STATUS_ERROR_PARSER_LIST_CREATE               = 0x010800,
+    MyCSS_STATUS_ERROR_CACHE_VALUE                      = 0x010900,
+    MyCSS_STATUS_ERROR_CACHE_FORMAT                     = 0x010901,
+    MyCSS_STATUS_ERROR_CACHE_WRITE                      = 0x010902
 }
 typedef mycss_status_t;
 
@@ -202,6 +205,27 @@ mycss_init(mycss_t* mycss);
 mycss_t*
 mycss_destroy(mycss_t* mycss, bool self_destroy);
 
+/**
+ * Set allocator for memory of entries (selectors, declarations, strings)
+ * Entries take it in mycss_entry_init, set it before and keep it
+ * until all these entries are destroyed. NULL for mycore_malloc.
+ *
+ * @param[in] mycss_t*
+ * @param[in] mcallocator_t*, see mycore/utils/mcallocator.h
+ */
+void
+mycss_allocator_set(mycss_t* mycss, mcallocator_t* allocator);
+
+/**
+ * Get allocator for memory of entries
+ *
+ * @param[in] mycss_t*
+ *
+ * @return mcallocator_t* or NULL
+ */
+mcallocator_t*
+mycss_allocator(mycss_t* mycss);
+
 /**
  * Parsing CSS
  *
@@ -217,6 +241,22 @@ mycss_destroy(mycss_t* mycss, bool self_destroy);
 mystatus_t
 mycss_parse(mycss_entry_t* entry, myencoding_t encoding, const char* css, size_t css_size);
 
+/**
+ * Parsing CSS from file without copy of it
+ *
+ * @param[in] previously created structure mycss_entry_t*
+ * @param[in] Input character encoding; Default: MyENCODING_UTF_8 or MyENCODING_DEFAULT or 0
+ * @param[in] path to file
+ *
+ * File is mapped to memory and given to tokenizer as is.
+ * Mapping lives until the next parse, clean or destroy of entry
+ *
+ * @return MyCSS_STATUS_OK if successful, MyCORE_STATUS_ERROR_FILE_OPEN or
+ * MyCORE_STATUS_ERROR_FILE_MAP if file can not be mapped, otherwise an error status
+ */
+mystatus_t
+mycss_parse_file(mycss_entry_t* entry, myencoding_t encoding, const char* filename);
+
 /**
  * Parsing CSS chunk. For End Parsing call mycss_parse_chunk_end function
  *
@@ -34,13 +34,20 @@ extern "C" {
 
 struct mycss {
     mycss_tokenizer_state_f* parse_state_func;
+    
+    /* for memory of entries, NULL for mycore_malloc */
+    mcallocator_t* allocator;
 };
 
 mycss_t * mycss_create(void);
 mystatus_t mycss_init(mycss_t* mycss);
 mycss_t * mycss_destroy(mycss_t* mycss, bool self_destroy);
 
+void mycss_allocator_set(mycss_t* mycss, mcallocator_t* allocator);
+mcallocator_t * mycss_allocator(mycss_t* mycss);
+
 mystatus_t mycss_parse(mycss_entry_t* entry, myencoding_t encoding, const char* css, size_t css_size);
+mystatus_t mycss_parse_file(mycss_entry_t* entry, myencoding_t encoding, const char* filename);
 mystatus_t mycss_parse_chunk(mycss_entry_t* entry, const char* css, size_t css_size);
 mystatus_t mycss_parse_chunk_end(mycss_entry_t* entry);
 
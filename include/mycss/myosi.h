@@ -72,7 +72,10 @@ enum mycss_status {
     MyCSS_STATUS_ERROR_DECLARATION_INIT                 = 0x010701,
     MyCSS_STATUS_ERROR_DECLARATION_ENTRY_CREATE         = 0x010702,
     MyCSS_STATUS_ERROR_DECLARATION_ENTRY_INIT           = 0x010703,
-    MyCSS_STATUS_ERROR_PARSER_LIST_CREATE               = 0x010800
+    MyCSS_STATUS_ERROR_PARSER_LIST_CREATE               = 0x010800,
+    MyCSS_STATUS_ERROR_CACHE_VALUE                      = 0x010900,
+    MyCSS_STATUS_ERROR_CACHE_FORMAT                     = 0x010901,
+    MyCSS_STATUS_ERROR_CACHE_WRITE                      = 0x010902
 }
 typedef mycss_status_t;
 
@@ -260,6 +263,12 @@ typedef mycss_stylesheet_entry_type_t;
 // stylesheet
 typedef struct mycss_stylesheet mycss_stylesheet_t;
 
+// cache
+typedef struct mycss_cache mycss_cache_t;
+
+// parallel
+typedef struct mycss_parallel mycss_parallel_t;
+
 // mystring
 typedef struct mycss_string_escaped_res mycss_string_escaped_res_t;
 typedef struct mycss_string_res mycss_string_res_t;
@@ -0,0 +1,105 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#ifndef MyHTML_MyCSS_PARALLEL_H
+#define MyHTML_MyCSS_PARALLEL_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <mycss/myosi.h>
+#include <mycss/entry.h>
+#include <mycore/mythread.h>
+#include <myencoding/myosi.h>
+
+/*
+ * Parsing of one stylesheet by slices in threads.
+ *
+ * A pre-scan over bytes finds beginnings of top-level rules (outside of strings, comments,
+ * url() and brackets), the stylesheet is cut at them into about equal slices, one for every thread.
+ * Every slice is parsed on its own entry; top-level @namespace rules from before the slice are
+ * parsed first, so namespaces of selectors are the same as in a sequential parse.
+ * Selector lists of slices are joined in source order into the stylesheet of the first entry,
+ * entries and their stylesheets are owned by parallel object and live until clean or destroy.
+ *
+ * After unbalanced bracket, unterminated string or comment the rest goes to one slice.
+ * Only stylesheets parsed as UTF-8 are cut: in legacy multibyte encodings '}' can be a trail byte.
+ */
+
+/* slices smaller than this are not worth a thread */
+#define MyCSS_PARALLEL_SLICE_MIN_SIZE 16384
+
+struct mycss_parallel_range {
+    size_t begin;
+    size_t length;
+}
+typedef mycss_parallel_range_t;
+
+struct mycss_parallel_slice {
+    mycss_entry_t* entry;
+    
+    size_t begin;
+    size_t length;
+    
+    /* count of top-level namespace rules before slice */
+    size_t ns_length;
+    
+    mystatus_t status;
+}
+typedef mycss_parallel_slice_t;
+
+struct mycss_parallel {
+    mycss_t* mycss;
+    
+    /* one entry for every thread */
+    mycss_parallel_slice_t* slice_list;
+    size_t slice_list_size;
+    size_t slice_list_length;
+    
+    /* top-level namespace rules of current stylesheet */
+    mycss_parallel_range_t* ns_list;
+    size_t ns_list_size;
+    size_t ns_list_length;
+    
+    size_t slice_min_size;
+    
+    const char* css;
+    myencoding_t encoding;
+    
+    mythread_t* thread;
+};
+
+mycss_parallel_t * mycss_parallel_create(void);
+mystatus_t mycss_parallel_init(mycss_parallel_t* parallel, mycss_t* mycss, size_t thread_count);
+void mycss_parallel_clean(mycss_parallel_t* parallel);
+mycss_parallel_t * mycss_parallel_destroy(mycss_parallel_t* parallel, bool self_destroy);
+
+mystatus_t mycss_parallel_parse(mycss_parallel_t* parallel, myencoding_t encoding, const char* css, size_t css_size);
+
+mycss_stylesheet_t * mycss_parallel_stylesheet(mycss_parallel_t* parallel);
+size_t mycss_parallel_slice_count(mycss_parallel_t* parallel);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* MyHTML_MyCSS_PARALLEL_H */
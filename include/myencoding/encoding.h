@@ -141,11 +141,24 @@ void myencoding_result_clean(myencoding_result_t *res);
 bool myencoding_detect(const char *text, size_t length, myencoding_t *encoding);
 bool myencoding_detect_russian(const char *text, size_t length, myencoding_t *encoding);
 bool myencoding_detect_unicode(const char *text, size_t length, myencoding_t *encoding);
+myencoding_unicode_result_t myencoding_detect_utf_8(unsigned const char *u_text, size_t length);
+myencoding_unicode_result_t myencoding_detect_utf_16(unsigned const char *u_text, size_t length);
 bool myencoding_detect_bom(const char *text, size_t length, myencoding_t *encoding);
 bool myencoding_detect_and_cut_bom(const char *text, size_t length, myencoding_t *encoding, const char **new_text, size_t *new_size);
 
 size_t myencoding_convert_to_ascii_utf_8(mycore_string_raw_t* raw_str, const char* buff, size_t length, myencoding_t encoding);
 
+/*
+ * Decode buff from *offset to length into out as UTF-8.
+ * State of not finished character is kept in res between calls, clean it before the first part of a stream.
+ * Stops when all data is decoded or out has less than 4 bytes free; *offset is set to the first not decoded byte.
+ * Unlike myencoding_custom_f calls, an ASCII byte which breaks a multibyte sequence is decoded again, not lost.
+ * Returns count of bytes written to out.
+ */
+size_t myencoding_decode_chunk_to_ascii_utf_8(myencoding_t encoding, myencoding_result_t *res,
+                                              const char* buff, size_t length, size_t* offset,
+                                              char* out, size_t out_size);
+
 const myencoding_detect_name_entry_t * myencoding_name_entry_by_name(const char* name, size_t length);
 bool myencoding_by_name(const char *name, size_t length, myencoding_t *encoding);
 const char * myencoding_name_by_id(myencoding_t encoding, size_t *length);
@@ -405,7 +405,10 @@ enum myhtml_tree_parse_flags {
     MyHTML_TREE_PARSE_FLAGS_WITHOUT_BUILD_TREE      = 0x001,
     MyHTML_TREE_PARSE_FLAGS_WITHOUT_PROCESS_TOKEN   = 0x003,
     MyHTML_TREE_PARSE_FLAGS_SKIP_WHITESPACE_TOKEN   = 0x004, /* skip ws token, but not for RCDATA, RAWTEXT, CDATA and PLAINTEXT */
-    MyHTML_TREE_PARSE_FLAGS_WITHOUT_DOCTYPE_IN_TREE = 0x008
+    MyHTML_TREE_PARSE_FLAGS_WITHOUT_DOCTYPE_IN_TREE = 0x008,
+    MyHTML_TREE_PARSE_FLAGS_CONVERT_TO_UTF_8        = 0x010, /* decode not UTF-8 input by buffers before tokenizer, positions are in UTF-8 then */
+    MyHTML_TREE_PARSE_FLAGS_LAZY_STRINGS            = 0x020, /* text and attribute values are decoded on first read, input must live until then */
+    MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM            = 0x041  /* include WITHOUT_BUILD_TREE, tokens are freed after callback_after_token, tokenizer works in Main thread */
 }
 typedef myhtml_tree_parse_flags_t;
 
@@ -423,6 +426,13 @@ typedef struct myhtml myhtml_t;
  */
 typedef struct myhtml_tree myhtml_tree_t;
 
+/**
+ * @struct myhtml_pool_t MyHTML_POOL
+ *
+ * Threads for parsing of many independent documents. Create once for using many times.
+ */
+typedef struct myhtml_pool myhtml_pool_t;
+
 /**
  * @struct myhtml_token_t MyHTML_TOKEN
  */
@@ -475,6 +485,8 @@ typedef myhtml_version_t;
 // callback functions
 typedef void* (*myhtml_callback_token_f)(myhtml_tree_t* tree, myhtml_token_node_t* token, void* ctx);
 typedef void (*myhtml_callback_tree_node_f)(myhtml_tree_t* tree, myhtml_tree_node_t* node, void* ctx);
+typedef bool (*myhtml_callback_tree_node_prune_f)(myhtml_tree_t* tree, myhtml_tree_node_t* node, void* ctx);
+typedef void (*myhtml_callback_pool_done_f)(myhtml_tree_t* tree, mystatus_t status, void* ctx);
 
 /***********************************************************************************
  *
@@ -525,6 +537,31 @@ myhtml_clean(myhtml_t* myhtml);
 myhtml_t*
 myhtml_destroy(myhtml_t* myhtml);
 
+/**
+ * Set allocator for memory of trees (nodes, tokens, attributes, strings, tags)
+ * Trees take it in myhtml_tree_init, set it before and keep it
+ * until all these trees are destroyed. NULL for mycore_malloc.
+ *
+ * When allocator has a limit (mcallocator_limit_set) and it is exceeded
+ * while parsing, tokenizer stops and parsing returns MyCORE_STATUS_ERROR_MEMORY_LIMIT,
+ * the tree has nodes from HTML before that place.
+ *
+ * @param[in] myhtml_t*
+ * @param[in] mcallocator_t*, see mycore/utils/mcallocator.h
+ */
+void
+myhtml_allocator_set(myhtml_t* myhtml, mcallocator_t* allocator);
+
+/**
+ * Get allocator for memory of trees
+ *
+ * @param[in] myhtml_t*
+ *
+ * @return mcallocator_t* or NULL
+ */
+mcallocator_t*
+myhtml_allocator(myhtml_t* myhtml);
+
 /**
  * Parsing HTML
  *
@@ -541,6 +578,23 @@ mystatus_t
 myhtml_parse(myhtml_tree_t* tree, myencoding_t encoding,
              const char* html, size_t html_size);
 
+/**
+ * Parsing HTML from file without copy of it
+ *
+ * @param[in] previously created structure myhtml_tree_t*
+ * @param[in] Input character encoding; Default: MyENCODING_UTF_8 or MyENCODING_DEFAULT or 0
+ * @param[in] path to file
+ *
+ * File is mapped to memory and given to tokenizer as is (other encodings than UTF-8 are decoded as by myhtml_parse).
+ * Mapping lives until the next parse, clean or destroy of tree,
+ * so raw positions of nodes are valid for it (myhtml_tree_incoming_buffer_first)
+ *
+ * @return MyHTML_STATUS_OK if successful, MyCORE_STATUS_ERROR_FILE_OPEN or
+ * MyCORE_STATUS_ERROR_FILE_MAP if file can not be mapped, otherwise an error status
+ */
+mystatus_t
+myhtml_parse_file(myhtml_tree_t* tree, myencoding_t encoding, const char* filename);
+
 /**
  * Parsing fragment of HTML
  *
@@ -712,6 +766,57 @@ myhtml_tree_parse_flags(myhtml_tree_t* tree);
 void
 myhtml_tree_parse_flags_set(myhtml_tree_t* tree, myhtml_tree_parse_flags_t parse_flags);
 
+/**
+ * Enable index of nodes for Tree
+ * Then myhtml_get_nodes_by_tag_id, myhtml_get_nodes_by_attribute_key,
+ * myhtml_get_nodes_by_attribute_value (for "id") and
+ * myhtml_get_nodes_by_attribute_value_whitespace_separated (for "class")
+ * and Modest finder for element, #id and .class selectors take nodes from the index
+ *
+ * Enable it before parsing, then the tree builder fills the index.
+ * Changes of tree after parsing make the index to be built again on next query,
+ * attributes add/remove by myhtml_attribute_* functions keep it current.
+ *
+ * @param[in] myhtml_tree_t*
+ *
+ * @return MyHTML_STATUS_OK if successful, otherwise an error status
+ */
+mystatus_t
+myhtml_tree_index_enable(myhtml_tree_t* tree);
+
+/**
+ * Disable and destroy index of nodes for Tree
+ *
+ * @param[in] myhtml_tree_t*
+ */
+void
+myhtml_tree_index_disable(myhtml_tree_t* tree);
+
+/**
+ * Set arena mode for memory of Tree
+ * In arena mode nodes, tokens, attributes and strings are only bump allocated:
+ * freeing them does nothing and the memory is reused after myhtml_tree_clean
+ * (and on next parsing) without calls of malloc.
+ * Use it when a tree is used for parsing one document after another
+ * and a document is thrown away whole; a lot of changes of one tree
+ * in arena mode only grow the memory until clean.
+ *
+ * @param[in] myhtml_tree_t*
+ * @param[in] true for arena mode, false for default (objects are reused after free)
+ */
+void
+myhtml_tree_arena_set(myhtml_tree_t* tree, bool arena);
+
+/**
+ * Get arena mode of Tree, see myhtml_tree_arena_set
+ *
+ * @param[in] myhtml_tree_t*
+ *
+ * @return true if arena mode is set
+ */
+bool
+myhtml_tree_arena(myhtml_tree_t* tree);
+
 /**
  * Clears resources before new parsing
  *
@@ -1347,6 +1452,7 @@ myhtml_node_attribute_last(myhtml_tree_node_t *node);
 
 /**
  * Get text of a node. Only for a MyHTML_TAG__TEXT or MyHTML_TAG__COMMENT tags
+ * With MyHTML_TREE_PARSE_FLAGS_LAZY_STRINGS text is decoded on first call and kept
  *
  * @param[in] myhtml_tree_node_t*
  * @param[out] optional, text length
@@ -1477,6 +1583,7 @@ myhtml_attribute_key(myhtml_tree_attr_t *attr, size_t *length);
 
 /**
  * Get attribute value
+ * With MyHTML_TREE_PARSE_FLAGS_LAZY_STRINGS value is decoded on first call and kept
  *
  * @param[in] myhtml_tree_attr_t*
  * @param[out] optional, value length
@@ -1665,6 +1772,7 @@ myhtml_token_node_attribute_last(myhtml_token_node_t *token_node);
 
 /**
  * Get text of a token node. Only for a MyHTML_TAG__TEXT or MyHTML_TAG__COMMENT tags
+ * With MyHTML_TREE_PARSE_FLAGS_LAZY_STRINGS it is NULL until text is read by myhtml_node_text
  *
  * @param[in] myhtml_token_node_t*
  * @param[out] optional, text length
@@ -2419,6 +2527,11 @@ myhtml_callback_before_token_done_set(myhtml_tree_t* tree, myhtml_callback_token
  * If you build MyHTML without thread or using MyHTML_OPTIONS_PARSE_MODE_SINGLE for create myhtml_t object
  *  then this callback calls from Main thread
  *
+ * With MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM tokens are parsed in Main thread
+ *  and the token with its attributes is freed when callback returns, do not keep pointers to it.
+ *  Incoming buffers before current token are released after every chunk,
+ *  so memory use depends on the largest token, not on the document
+ *
  * @param[in] myhtml_tree_t*
  * @param[in] myhtml_callback_token_f callback function
  */
@@ -2481,6 +2594,36 @@ myhtml_callback_tree_node_insert_set(myhtml_tree_t* tree, myhtml_callback_tree_n
 void
 myhtml_callback_tree_node_remove_set(myhtml_tree_t* tree, myhtml_callback_tree_node_f func, void* ctx);
 
+/**
+ * Get current callback for pruning of tree node contents
+ *
+ * @param[in] myhtml_tree_t*
+ *
+ * @return myhtml_callback_tree_node_prune_f
+ */
+myhtml_callback_tree_node_prune_f
+myhtml_callback_tree_node_prune(myhtml_tree_t* tree);
+
+/**
+ * Set callback for pruning of tree node contents
+ * It is called for every element inserted by parser, after insert callback.
+ * If it returns true, everything inside the element is discarded:
+ * the element stays in the tree without children after parsing.
+ *
+ * Tokenizer and insertion modes work as usual, elements inside are kept
+ * only for the stack of open elements and are not passed to insert callback or index,
+ * text and comment nodes are not created.
+ * In MyHTML_OPTIONS_PARSE_MODE_SINGLE text and attribute values inside are not decoded.
+ *
+ * Warning!
+ * If you using thread mode parsing then this callback calls from thread (not Main thread)
+ *
+ * @param[in] myhtml_tree_t*
+ * @param[in] myhtml_callback_tree_node_prune_f callback function
+ */
+void
+myhtml_callback_tree_node_prune_set(myhtml_tree_t* tree, myhtml_callback_tree_node_prune_f func, void* ctx);
+
 /***********************************************************************************
  *
  * MyHTML_UTILS
@@ -2581,6 +2724,104 @@ mystatus_t
 myhtml_serialization_node_callback(myhtml_tree_node_t* node,
                                    mycore_callback_serialize_f callback, void* ptr);
 
+/***********************************************************************************
+ *
+ * MyHTML_POOL
+ *
+ ***********************************************************************************/
+
+/**
+ * Create a MyHTML_POOL structure
+ *
+ * @return myhtml_pool_t* if successful, otherwise an NULL value.
+ */
+myhtml_pool_t*
+myhtml_pool_create(void);
+
+/**
+ * Allocating and Initialization resources for a MyHTML_POOL structure
+ *
+ * Every thread of pool owns one tree and parses whole documents in it,
+ * one document after another. Trees are parsed in MyHTML_OPTIONS_PARSE_MODE_SINGLE
+ * and threads share only the queue of submitted documents.
+ * Without threads (MyCORE_BUILD_WITHOUT_THREADS) documents are parsed in myhtml_pool_parse.
+ *
+ * @param[in] myhtml_pool_t*
+ * @param[in] thread count; 0 for count of online processors
+ * @param[in] how many documents can wait in queue; 0 for 64 by thread
+ *
+ * @return MyHTML_STATUS_OK if successful, otherwise an error status value.
+ */
+mystatus_t
+myhtml_pool_init(myhtml_pool_t* pool, size_t thread_count, size_t queue_size);
+
+/**
+ * Destroy of a MyHTML_POOL structure
+ * Waits for all submitted documents, then stops threads and destroys trees
+ *
+ * @param[in] myhtml_pool_t*
+ * @param[in] call free() function for myhtml_pool_t* object? true or false
+ *
+ * @return NULL if successful, otherwise an MyHTML_POOL structure
+ */
+myhtml_pool_t*
+myhtml_pool_destroy(myhtml_pool_t* pool, bool self_destroy);
+
+/**
+ * Get count of trees, one tree for every thread
+ *
+ * @param[in] myhtml_pool_t*
+ *
+ * @return count of trees
+ */
+size_t
+myhtml_pool_tree_count(myhtml_pool_t* pool);
+
+/**
+ * Get tree of thread by index
+ *
+ * Set parse flags, callbacks or index for trees before the first myhtml_pool_parse,
+ * they are kept for all documents parsed in the tree.
+ *
+ * @param[in] myhtml_pool_t*
+ * @param[in] index of tree, less than myhtml_pool_tree_count
+ *
+ * @return myhtml_tree_t* if exists, otherwise a NULL value
+ */
+myhtml_tree_t*
+myhtml_pool_tree(myhtml_pool_t* pool, size_t idx);
+
+/**
+ * Submit HTML for parsing by a thread of pool
+ *
+ * Callback is called in the thread with a tree of parsed document and status of myhtml_parse.
+ * The tree is cleaned after callback for the next document, so take all you need in callback.
+ * HTML must live until callback is called.
+ *
+ * If queue is full, waits for place in it. Do not submit from callback,
+ * it can wait for itself.
+ *
+ * @param[in] myhtml_pool_t*
+ * @param[in] Input character encoding; Default: MyENCODING_UTF_8 or MyENCODING_DEFAULT or 0
+ * @param[in] HTML
+ * @param[in] HTML size
+ * @param[in] callback for parsed document, can be NULL
+ * @param[in] callback context
+ *
+ * @return MyHTML_STATUS_OK if submitted, otherwise an error status
+ */
+mystatus_t
+myhtml_pool_parse(myhtml_pool_t* pool, myencoding_t encoding, const char* html, size_t html_size,
+                  myhtml_callback_pool_done_f callback, void* ctx);
+
+/**
+ * Wait until all submitted documents are parsed and their callbacks are done
+ *
+ * @param[in] myhtml_pool_t*
+ */
+void
+myhtml_pool_wait_for_all_done(myhtml_pool_t* pool);
+
 /***********************************************************************************
  *
  * MyHTML_VERSION
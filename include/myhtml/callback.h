@@ -40,6 +40,9 @@ myhtml_callback_tree_node_f myhtml_callback_tree_node_remove(myhtml_tree_t *tree
 void myhtml_callback_tree_node_insert_set(myhtml_tree_t *tree, myhtml_callback_tree_node_f func, void* ctx);
 void myhtml_callback_tree_node_remove_set(myhtml_tree_t *tree, myhtml_callback_tree_node_f func, void* ctx);
 
+myhtml_callback_tree_node_prune_f myhtml_callback_tree_node_prune(myhtml_tree_t *tree);
+void myhtml_callback_tree_node_prune_set(myhtml_tree_t *tree, myhtml_callback_tree_node_prune_f func, void* ctx);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
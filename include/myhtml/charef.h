@@ -31,6 +31,8 @@ extern "C" {
 struct charef_entry {
     unsigned char ch;
     size_t next;
+    /* bits of children characters by named_character_references_class, children are sorted from next */
+    unsigned long long children;
     size_t cur_pos;
     size_t codepoints[2];
     size_t codepoints_len;
@@ -41,11 +43,15 @@ struct charef_entry_result {
     const charef_entry_t *curr_entry;
     const charef_entry_t *last_entry;
     size_t last_offset;
+    /* count of characters found after first and that count for last_entry */
+    size_t curr_length;
+    size_t last_length;
     int is_done;
 }
 typedef charef_entry_result_t;
 
 const charef_entry_t * myhtml_charef_find(const char *begin, size_t *offset, size_t size, size_t *data_size);
+/* pos is position of entry for last found character, see charef_entry_t.cur_pos */
 const charef_entry_t * myhtml_charef_find_by_pos(size_t pos, const char *begin, size_t *offset, size_t size, charef_entry_result_t *result);
 const charef_entry_t * myhtml_charef_get_first_position(const char begin);
 
@@ -57,7 +57,10 @@ enum myhtml_tree_parse_flags {
     MyHTML_TREE_PARSE_FLAGS_WITHOUT_BUILD_TREE      = 0x001,
     MyHTML_TREE_PARSE_FLAGS_WITHOUT_PROCESS_TOKEN   = 0x003,
     MyHTML_TREE_PARSE_FLAGS_SKIP_WHITESPACE_TOKEN   = 0x004, /* skip ws token, but not for RCDATA, RAWTEXT, CDATA and PLAINTEXT */
-    MyHTML_TREE_PARSE_FLAGS_WITHOUT_DOCTYPE_IN_TREE = 0x008
+    MyHTML_TREE_PARSE_FLAGS_WITHOUT_DOCTYPE_IN_TREE = 0x008,
+    MyHTML_TREE_PARSE_FLAGS_CONVERT_TO_UTF_8        = 0x010, /* decode not UTF-8 input by buffers before tokenizer, positions are in UTF-8 then */
+    MyHTML_TREE_PARSE_FLAGS_LAZY_STRINGS            = 0x020, /* text and attribute values are decoded on first read, input must live until then */
+    MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM            = 0x041  /* include WITHOUT_BUILD_TREE, tokens are freed after callback_after_token, tokenizer works in Main thread */
 }
 typedef myhtml_tree_parse_flags_t;
 
@@ -70,6 +73,8 @@ typedef struct myhtml_async_args myhtml_async_args_t;
 
 typedef struct myhtml_tree_node myhtml_tree_node_t;
 typedef struct myhtml_tree myhtml_tree_t;
+typedef struct myhtml_index myhtml_index_t;
+typedef struct myhtml_pool myhtml_pool_t;
 
 // token
 enum myhtml_token_type {
@@ -309,6 +314,8 @@ typedef size_t (*myhtml_data_process_state_f)(myhtml_data_process_entry_t* chare
 // callback functions
 typedef void* (*myhtml_callback_token_f)(myhtml_tree_t* tree, myhtml_token_node_t* token, void* ctx);
 typedef void (*myhtml_callback_tree_node_f)(myhtml_tree_t* tree, myhtml_tree_node_t* node, void* ctx);
+typedef bool (*myhtml_callback_tree_node_prune_f)(myhtml_tree_t* tree, myhtml_tree_node_t* node, void* ctx);
+typedef void (*myhtml_callback_pool_done_f)(myhtml_tree_t* tree, mystatus_t status, void* ctx);
 
 // find attribute value functions
 typedef bool (*myhtml_attribute_value_find_f)(mycore_string_t* str_key, const char* value, size_t value_len);
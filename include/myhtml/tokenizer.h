@@ -29,6 +29,7 @@ extern "C" {
 #include <myhtml/myosi.h>
 #include <mycore/utils.h>
 #include <mycore/mythread.h>
+#include <mycore/utils/mcscan.h>
 #include <myhtml/myhtml.h>
 #include <myhtml/tag.h>
 #include <myhtml/tokenizer_doctype.h>
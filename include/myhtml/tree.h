@@ -72,7 +72,9 @@ enum myhtml_close_type {
 enum myhtml_tree_node_flags {
     MyHTML_TREE_NODE_UNDEF           = 0,
     MyHTML_TREE_NODE_PARSER_INSERTED = 1,
-    MyHTML_TREE_NODE_BLOCKING        = 2
+    MyHTML_TREE_NODE_BLOCKING        = 2,
+    MyHTML_TREE_NODE_PRUNED          = 4, /* children are not built, cleared at the end of parsing */
+    MyHTML_TREE_NODE_IN_PRUNED       = 8  /* inside pruned element, removed at the end of parsing */
 };
 
 struct myhtml_tree_node {
@@ -114,6 +116,9 @@ enum myhtml_tree_insertion_mode {
 
 struct myhtml_async_args {
     size_t mchar_node_id;
+    
+    /* buffer of the last processed token data, search of the next one begins here */
+    mycore_incoming_buffer_t* incoming_buf;
 };
 
 struct myhtml_tree_doctype {
@@ -201,6 +206,10 @@ struct myhtml_tree {
     mycore_incoming_buffer_t*  incoming_buf;
     mycore_incoming_buffer_t*  incoming_buf_first;
     
+    /* mapping of myhtml_parse_file, incoming buffers point to it */
+    const char*                file_data;
+    size_t                     file_size;
+    
     // ref for nodes
     myhtml_tree_node_t*   document;
     myhtml_tree_node_t*   fragment;
@@ -251,6 +260,13 @@ struct myhtml_tree {
     
     void* callback_tree_node_insert_ctx;
     void* callback_tree_node_remove_ctx;
+    
+    /* contents of elements for which it returns true are not built, see myhtml_callback_tree_node_prune_set */
+    myhtml_callback_tree_node_prune_f callback_tree_node_prune;
+    void* callback_tree_node_prune_ctx;
+    
+    /* optional index of nodes, see myhtml_tree_index_enable */
+    myhtml_index_t* index;
 };
 
 // base
@@ -259,6 +275,16 @@ mystatus_t myhtml_tree_init(myhtml_tree_t* tree, myhtml_t* myhtml);
 void myhtml_tree_clean(myhtml_tree_t* tree);
 void myhtml_tree_clean_all(myhtml_tree_t* tree);
 myhtml_tree_t * myhtml_tree_destroy(myhtml_tree_t* tree);
+void myhtml_tree_file_unmap(myhtml_tree_t* tree);
+
+/* index */
+mystatus_t myhtml_tree_index_enable(myhtml_tree_t* tree);
+void myhtml_tree_index_disable(myhtml_tree_t* tree);
+myhtml_index_t * myhtml_tree_get_index(myhtml_tree_t* tree);
+
+/* arena */
+void myhtml_tree_arena_set(myhtml_tree_t* tree, bool arena);
+bool myhtml_tree_arena(myhtml_tree_t* tree);
 
 /* parse flags */
 myhtml_tree_parse_flags_t myhtml_tree_parse_flags(myhtml_tree_t* tree);
@@ -333,6 +359,10 @@ bool myhtml_tree_open_elements_find(myhtml_tree_t* tree, myhtml_tree_node_t* idx
 bool myhtml_tree_open_elements_find_reverse(myhtml_tree_t* tree, myhtml_tree_node_t* idx, size_t* pos);
 myhtml_tree_node_t * myhtml_tree_open_elements_find_by_tag_idx(myhtml_tree_t* tree, myhtml_tag_id_t tag_idx, myhtml_namespace_t mynamespace, size_t* return_index);
 myhtml_tree_node_t * myhtml_tree_open_elements_find_by_tag_idx_reverse(myhtml_tree_t* tree, myhtml_tag_id_t tag_idx, myhtml_namespace_t mynamespace, size_t* return_index);
+
+bool myhtml_tree_pruned_insertion(myhtml_tree_t* tree);
+void myhtml_tree_pruned_clean(myhtml_tree_t* tree);
+
 myhtml_tree_node_t * myhtml_tree_element_in_scope(myhtml_tree_t* tree, myhtml_tag_id_t tag_idx, myhtml_namespace_t mynamespace, enum myhtml_tag_categories category);
 bool myhtml_tree_element_in_scope_by_node(myhtml_tree_node_t* node, enum myhtml_tag_categories category);
 void myhtml_tree_generate_implied_end_tags(myhtml_tree_t* tree, myhtml_tag_id_t exclude_tag_idx, myhtml_namespace_t mynamespace);
@@ -133,6 +133,9 @@ modest_finder_t * modest_finder_by_stylesheet(mycss_stylesheet_t *stylesheet, my
     else
         myhtml_collection_clean(*collection);
     
+    if(base_node->tree && base_node->tree->index)
+        myhtml_index_update(base_node->tree->index, true);
+    
     mycss_selectors_list_t *selector_list = stylesheet->sel_list_first;
     
     while(selector_list) {
@@ -161,7 +164,10 @@ mystatus_t modest_finder_by_selectors_list(modest_finder_t* finder, myhtml_tree_
         if(status)
             return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
     }
-
+    
+    if(scope_node->tree && scope_node->tree->index)
+        myhtml_index_update(scope_node->tree->index, true);
+    
     for(size_t i = 0; i < selector_list->entries_list_length; i++) {
         mycss_selectors_specificity_t spec = selector_list->entries_list[i].specificity;
         
@@ -172,6 +178,110 @@ mystatus_t modest_finder_by_selectors_list(modest_finder_t* finder, myhtml_tree_
     return MODEST_STATUS_OK;
 }
 
+/* nodes for first selector of element, #id or .class from tree index; false if the index can not answer */
+static bool modest_finder_index_list(myhtml_tree_node_t* base_node, mycss_selectors_entry_t* selector, myhtml_index_list_t** list)
+{
+    myhtml_tree_t *tree = base_node->tree;
+    
+    if(tree == NULL || tree->index == NULL)
+        return false;
+    
+    myhtml_index_t *index = tree->index;
+    
+    switch(selector->type) {
+        case MyCSS_SELECTORS_TYPE_ELEMENT: {
+            mycore_string_t *str = selector->key;
+            
+            if(str->length == 1 && *str->data == '*')
+                return false;
+            
+            myhtml_tag_id_t tag_id = myhtml_tag_id_by_name(tree, str->data, str->length);
+            
+            if(tag_id == MyHTML_TAG__UNDEF || myhtml_index_is_ready(index, false) == false)
+                return false;
+            
+            *list = myhtml_index_list_by_tag_id(index, tag_id);
+            break;
+        }
+        case MyCSS_SELECTORS_TYPE_ID:
+        case MyCSS_SELECTORS_TYPE_CLASS: {
+            /* in quirks mode match is case-insensitive, keys of index are not */
+            if(tree->compat_mode == MyHTML_TREE_COMPAT_MODE_QUIRKS || myhtml_index_is_ready(index, true) == false)
+                return false;
+            
+            if(selector->type == MyCSS_SELECTORS_TYPE_ID)
+                *list = myhtml_index_list_by_id(index, selector->key->data, selector->key->length);
+            else
+                *list = myhtml_index_list_by_class(index, selector->key->data, selector->key->length);
+            
+            break;
+        }
+        default:
+            return false;
+    }
+    
+    /* from document only html element is indexed */
+    if(base_node == tree->document) {
+        for(myhtml_tree_node_t *node = base_node->child; node; node = node->next) {
+            if(node != index->root && node->tag_id != MyHTML_TAG__TEXT && node->tag_id != MyHTML_TAG__COMMENT &&
+               node->tag_id != MyHTML_TAG__DOCTYPE)
+                return false;
+        }
+        
+        return true;
+    }
+    
+    return myhtml_index_node_is_indexed(index, base_node);
+}
+
+/* same as walk in modest_finder_node_combinator_begin, but only by nodes of index list */
+static void modest_finder_node_combinator_begin_by_index(modest_finder_t* finder, myhtml_tree_node_t* base_node, myhtml_index_list_t* list,
+                                                         mycss_selectors_list_t* selector_list, mycss_selectors_entry_t* selector,
+                                                         mycss_selectors_specificity_t* spec, modest_finder_callback_f callback_found, void* ctx)
+{
+    bool is_document = (base_node == base_node->tree->document);
+    
+    size_t begin = (is_document ? 0 : myhtml_index_list_lower_bound(list, base_node));
+    myhtml_tree_node_t *bound = (is_document ? NULL : myhtml_index_node_after(base_node));
+    size_t end = (bound ? myhtml_index_list_lower_bound(list, bound) : list->length);
+    
+    /* subtree of node is skipped when next combinator found nothing */
+    myhtml_tree_node_t *skip_bound = NULL;
+    
+    for(size_t i = begin; i < end; i++)
+    {
+        myhtml_tree_node_t *node = list->list[i];
+        
+        /* node with some class attributes */
+        if(i > begin && node == list->list[(i - 1)])
+            continue;
+        
+        if(skip_bound) {
+            if(myhtml_index_node_compare(node, skip_bound) < 0)
+                continue;
+            
+            skip_bound = NULL;
+        }
+        
+        if(node->tag_id != MyHTML_TAG__TEXT && node->tag_id != MyHTML_TAG__COMMENT &&
+           modest_finder_static_selector_type_map[selector->type](finder, node, selector, spec))
+        {
+            if(selector->next == NULL) {
+                if(callback_found)
+                    callback_found(finder, node, selector_list, selector, spec, ctx);
+            }
+            else {
+                myhtml_tree_node_t *find_node = modest_finder_static_selector_combinator_map[selector->next->combinator](finder, node, selector_list, selector->next, spec, callback_found, ctx);
+                
+                if(find_node == NULL) {
+                    if(node == base_node || (skip_bound = myhtml_index_node_after(node)) == NULL)
+                        break;
+                }
+            }
+        }
+    }
+}
+
 myhtml_tree_node_t * modest_finder_node_combinator_begin(modest_finder_t* finder, myhtml_tree_node_t* base_node,
                                                          mycss_selectors_list_t* selector_list, mycss_selectors_entry_t* selector,
                                                          mycss_selectors_specificity_t* spec, modest_finder_callback_f callback_found, void* ctx)
@@ -179,6 +289,14 @@ myhtml_tree_node_t * modest_finder_node_combinator_begin(modest_finder_t* finder
     if(selector == NULL)
         return NULL;
     
+    myhtml_index_list_t *list = NULL;
+    
+    if(modest_finder_index_list(base_node, selector, &list)) {
+        if(list)
+            modest_finder_node_combinator_begin_by_index(finder, base_node, list, selector_list, selector, spec, callback_found, ctx);
+        
+        return NULL;
+    }
     
     myhtml_tree_node_t *node = base_node;
     
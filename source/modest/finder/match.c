@@ -48,6 +48,8 @@ bool modest_finder_match_attribute_eq(myhtml_token_attr_t* attr, const char* key
         if(attr->key.length == key_len) {
             if(mycore_strncasecmp(key, attr->key.data, key_len) == 0)
             {
+                myhtml_token_attr_materialize(attr);
+                
                 if(attr->value.length == value_len) {
                     if(case_sensitive) {
                         if(strncmp(value, attr->value.data, value_len) == 0) {
@@ -81,6 +83,8 @@ bool modest_finder_match_attribute_ws(myhtml_token_attr_t* attr, const char* key
         if(attr->key.length == key_len) {
             if(mycore_strncasecmp(key, attr->key.data, key_len) == 0)
             {
+                myhtml_token_attr_materialize(attr);
+                
                 size_t i = 0;
                 size_t begin;
                 
@@ -134,6 +138,8 @@ bool modest_finder_match_attribute_begin(myhtml_token_attr_t* attr, const char*
         if(attr->key.length == key_len) {
             if(mycore_strncasecmp(key, attr->key.data, key_len) == 0)
             {
+                myhtml_token_attr_materialize(attr);
+                
                 if(attr->value.length >= value_len) {
                     if(case_sensitive) {
                         if(mycore_strncmp(value, attr->value.data, value_len) == 0)
@@ -165,6 +171,8 @@ bool modest_finder_match_attribute_end(myhtml_token_attr_t* attr, const char* ke
         if(attr->key.length == key_len) {
             if(mycore_strncasecmp(key, attr->key.data, key_len) == 0)
             {
+                myhtml_token_attr_materialize(attr);
+                
                 if(attr->value.length >= value_len) {
                     if(case_sensitive) {
                         if(mycore_strncmp(value, &attr->value.data[ (attr->value.length - value_len) ], value_len) == 0)
@@ -196,6 +204,8 @@ bool modest_finder_match_attribute_sub(myhtml_token_attr_t* attr, const char* ke
         if(attr->key.length == key_len) {
             if(mycore_strncasecmp(key, attr->key.data, key_len) == 0)
             {
+                myhtml_token_attr_materialize(attr);
+                
                 if(attr->value.length >= value_len) {
                     size_t i = 0;
                     
@@ -240,6 +250,8 @@ bool modest_finder_match_attribute_hsp(myhtml_token_attr_t* attr, const char* ke
         if(attr->key.length == key_len) {
             if(mycore_strncasecmp(key, attr->key.data, key_len) == 0)
             {
+                myhtml_token_attr_materialize(attr);
+                
                 if(attr->value.length == value_len) {
                     if(case_sensitive) {
                         if(mycore_strncmp(value, attr->value.data, value_len) == 0)
@@ -45,6 +45,13 @@ typedef struct modest_finder_thread_entry modest_finder_thread_entry_t;
 typedef struct modest_finder_thread_context modest_finder_thread_context_t;
 typedef struct modest_finder_thread modest_finder_thread_t;
 typedef struct modest_finder_thread_found_context modest_finder_thread_found_context_t;
+typedef struct modest_finder_thread_work modest_finder_thread_work_t;
+
+typedef struct modest_finder_rule modest_finder_rule_t;
+typedef struct modest_finder_rules_bucket modest_finder_rules_bucket_t;
+typedef struct modest_finder_rules modest_finder_rules_t;
+typedef struct modest_finder_rules_ancestor modest_finder_rules_ancestor_t;
+typedef struct modest_finder_rules_context modest_finder_rules_context_t;
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -451,6 +451,8 @@ bool modest_finder_selector_sub_type_pseudo_class_blank(modest_finder_t* finder,
                 return false;
             
             if(node->token) {
+                myhtml_token_node_materialize(node->tree->token, node->token);
+                
                 const char *data = node->token->str.data;
                 size_t len = node->token->str.length;
                 
@@ -488,6 +490,8 @@ bool modest_finder_selector_sub_type_pseudo_class_checked(modest_finder_t* finde
             if(attr->key.length == 4) {
                 if(mycore_strncasecmp("type", attr->key.data, 4) == 0)
                 {
+                    myhtml_token_attr_materialize(attr);
+                    
                     if(attr->value.length == 8) {
                         if(mycore_strncasecmp("checkbox", attr->value.data, 8) == 0) {
                             return modest_finder_match_attribute_only_key(base_node->token->attr_first, "checked", 7);
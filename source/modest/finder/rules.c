@@ -0,0 +1,1014 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#include "modest/finder/rules.h"
+#include "modest/finder/resource.h"
+#include "modest/style/raw.h"
+#include "myhtml/tag.h"
+#include "mycore/utils/resources.h"
+
+enum modest_finder_rules_key_type {
+    MODEST_FINDER_RULES_KEY_TYPE_TAG   = 0x01,
+    MODEST_FINDER_RULES_KEY_TYPE_ID    = 0x02,
+    MODEST_FINDER_RULES_KEY_TYPE_CLASS = 0x03
+};
+
+/* keys */
+static size_t modest_finder_rules_key_final(unsigned long long hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    
+    /* zero is a key of universal rules */
+    if((size_t)hash == 0)
+        return 1;
+    
+    return (size_t)hash;
+}
+
+/* ids and classes are case-insensitive in quirks mode, so always fold */
+static size_t modest_finder_rules_key_hash(unsigned int type, const char* data, size_t length)
+{
+    unsigned long long hash = 14695981039346656037ULL ^ ((unsigned long long)type * 0x9E3779B97F4A7C15ULL);
+    
+    for(size_t i = 0; i < length; i++) {
+        hash ^= mycore_string_chars_lowercase_map[ (const unsigned char)data[i] ];
+        hash *= 1099511628211ULL;
+    }
+    
+    return modest_finder_rules_key_final(hash);
+}
+
+static size_t modest_finder_rules_key_tag_id(myhtml_tag_id_t tag_id)
+{
+    return modest_finder_rules_key_final(((unsigned long long)tag_id + 1ULL) * 0x9E3779B97F4A7C15ULL);
+}
+
+static size_t modest_finder_rules_key_tag_name(const char* name, size_t length)
+{
+    const myhtml_tag_context_t *tag_ctx = myhtml_tag_static_search(name, length);
+    
+    if(tag_ctx)
+        return modest_finder_rules_key_tag_id(tag_ctx->id);
+    
+    return modest_finder_rules_key_hash(MODEST_FINDER_RULES_KEY_TYPE_TAG, name, length);
+}
+
+static size_t modest_finder_rules_key_by_entry(mycss_selectors_entry_t* entry)
+{
+    if(entry->key == NULL || entry->key->length == 0)
+        return 0;
+    
+    switch (entry->type) {
+        case MyCSS_SELECTORS_TYPE_ELEMENT:
+            if(entry->key->length == 1 && *entry->key->data == '*')
+                return 0;
+            
+            return modest_finder_rules_key_tag_name(entry->key->data, entry->key->length);
+            
+        case MyCSS_SELECTORS_TYPE_ID:
+            return modest_finder_rules_key_hash(MODEST_FINDER_RULES_KEY_TYPE_ID, entry->key->data, entry->key->length);
+            
+        case MyCSS_SELECTORS_TYPE_CLASS:
+            return modest_finder_rules_key_hash(MODEST_FINDER_RULES_KEY_TYPE_CLASS, entry->key->data, entry->key->length);
+            
+        default:
+            break;
+    }
+    
+    return 0;
+}
+
+static mystatus_t modest_finder_rules_key_append(size_t** keys, size_t* length, size_t* size, size_t key)
+{
+    if(*length >= *size) {
+        size_t new_size = (*size ? (*size * 2) : 64);
+        size_t* tmp = mycore_realloc(*keys, sizeof(size_t) * new_size);
+        
+        if(tmp == NULL)
+            return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+        
+        *keys = tmp;
+        *size = new_size;
+    }
+    
+    (*keys)[ *length ] = key;
+    (*length)++;
+    
+    return MODEST_STATUS_OK;
+}
+
+/* the same attributes as modest_finder_selector_type_id and modest_finder_selector_type_class take */
+static mystatus_t modest_finder_rules_node_keys(myhtml_tree_node_t* node, size_t** keys, size_t* length, size_t* size)
+{
+    mystatus_t status;
+    
+    if(node->tag_id < MyHTML_TAG_LAST_ENTRY) {
+        status = modest_finder_rules_key_append(keys, length, size, modest_finder_rules_key_tag_id(node->tag_id));
+    }
+    else {
+        const myhtml_tag_context_t *tag_ctx = NULL;
+        
+        if(node->tree && node->tree->tags)
+            tag_ctx = myhtml_tag_get_by_id(node->tree->tags, node->tag_id);
+        
+        if(tag_ctx == NULL)
+            return MODEST_STATUS_OK;
+        
+        status = modest_finder_rules_key_append(keys, length, size,
+                                                modest_finder_rules_key_hash(MODEST_FINDER_RULES_KEY_TYPE_TAG, tag_ctx->name, tag_ctx->name_length));
+    }
+    
+    if(status || node->token == NULL)
+        return status;
+    
+    bool is_id = false, is_class = false;
+    myhtml_token_attr_t* attr = node->token->attr_first;
+    
+    while(attr && (is_id == false || is_class == false))
+    {
+        if(is_id == false && attr->key.length == 2 && mycore_strncasecmp("id", attr->key.data, 2) == 0)
+        {
+            is_id = true;
+            myhtml_token_attr_materialize(attr);
+            
+            if(attr->value.length) {
+                status = modest_finder_rules_key_append(keys, length, size,
+                                                        modest_finder_rules_key_hash(MODEST_FINDER_RULES_KEY_TYPE_ID, attr->value.data, attr->value.length));
+                if(status)
+                    return status;
+            }
+        }
+        else if(is_class == false && attr->key.length == 5 && mycore_strncasecmp("class", attr->key.data, 5) == 0)
+        {
+            is_class = true;
+            myhtml_token_attr_materialize(attr);
+            
+            const char* data = attr->value.data;
+            size_t i = 0, begin;
+            
+            while(i < attr->value.length)
+            {
+                while(i < attr->value.length && mycore_utils_whithspace(data[i], ==, ||)) {i++;}
+                
+                begin = i;
+                while(i < attr->value.length && mycore_utils_whithspace(data[i], !=, &&)) {i++;}
+                
+                if(i > begin) {
+                    status = modest_finder_rules_key_append(keys, length, size,
+                                                            modest_finder_rules_key_hash(MODEST_FINDER_RULES_KEY_TYPE_CLASS, &data[begin], (i - begin)));
+                    if(status)
+                        return status;
+                }
+            }
+        }
+        
+        attr = attr->next;
+    }
+    
+    return MODEST_STATUS_OK;
+}
+
+/* rules */
+modest_finder_rules_t * modest_finder_rules_create(void)
+{
+    return (modest_finder_rules_t*)mycore_calloc(1, sizeof(modest_finder_rules_t));
+}
+
+/*
+ * Specificity as reported by matching: :not() adds the same as in modest_finder_selector_sub_type_pseudo_class_function_not.
+ * :matches() and :nth-child(of) depend on the matched argument and are counted at match time only.
+ */
+static mycss_selectors_specificity_t modest_finder_rules_specificity(mycss_selectors_entries_list_t* entries)
+{
+    mycss_selectors_specificity_t spec = entries->specificity;
+    
+    for(mycss_selectors_entry_t* entry = entries->entry; entry; entry = entry->next)
+    {
+        if(entry->type != MyCSS_SELECTORS_TYPE_PSEUDO_CLASS_FUNCTION ||
+           entry->sub_type != MyCSS_SELECTORS_SUB_TYPE_PSEUDO_CLASS_FUNCTION_NOT || entry->value == NULL)
+            continue;
+        
+        mycss_selectors_list_t *list = entry->value;
+        mycss_selectors_specificity_t work_spec = {0, 0, 0};
+        
+        for(size_t i = 0; i < list->entries_list_length; i++) {
+            if(list->entries_list[i].entry)
+                modest_finder_specificity_inc(list->entries_list[i].entry, &work_spec);
+        }
+        
+        if(work_spec.a)
+            spec.a++;
+        else if(work_spec.b)
+            spec.b++;
+        else if(work_spec.c)
+            spec.c++;
+    }
+    
+    return spec;
+}
+
+static mystatus_t modest_finder_rules_append(modest_finder_rules_t* rules, mycss_selectors_list_t* selector_list,
+                                             mycss_selectors_entries_list_t* entries)
+{
+    if(rules->list_length >= rules->list_size) {
+        size_t new_size = (rules->list_size ? (rules->list_size * 2) : 256);
+        modest_finder_rule_t* tmp = mycore_realloc(rules->list, sizeof(modest_finder_rule_t) * new_size);
+        
+        if(tmp == NULL)
+            return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+        
+        rules->list = tmp;
+        rules->list_size = new_size;
+    }
+    
+    modest_finder_rule_t* rule = &rules->list[ rules->list_length ];
+    memset(rule, 0, sizeof(modest_finder_rule_t));
+    
+    rule->selector_list = selector_list;
+    rule->entries = entries;
+    rule->declaration = selector_list->declaration_entry;
+    rule->specificity = modest_finder_rules_specificity(entries);
+    rule->order = rules->order_base + rules->list_length;
+    rule->cascade_key = modest_style_raw_cascade_key(rule->specificity.a, rule->specificity.b, rule->specificity.c, rule->order);
+    
+    /* compound selectors */
+    mycss_selectors_entry_t* entry = entries->entry;
+    
+    while(entry) {
+        if(entry == entries->entry || entry->combinator != MyCSS_SELECTORS_COMBINATOR_UNDEF)
+            rule->compound_length++;
+        
+        rule->entry_last = entry;
+        entry = entry->next;
+    }
+    
+    rule->compound = mycore_malloc(sizeof(mycss_selectors_entry_t*) * rule->compound_length);
+    if(rule->compound == NULL)
+        return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    size_t idx = 0;
+    
+    for(entry = entries->entry; entry; entry = entry->next) {
+        if(entry == entries->entry || entry->combinator != MyCSS_SELECTORS_COMBINATOR_UNDEF) {
+            rule->compound[idx] = entry;
+            idx++;
+        }
+    }
+    
+    /* keys of compound selectors before descendant or child combinator, they are on ancestors */
+    for(int pass = 0; pass < 2; pass++)
+    {
+        for(idx = 1; idx < rule->compound_length; idx++)
+        {
+            if(rule->compound[idx]->combinator != MyCSS_SELECTORS_COMBINATOR_DESCENDANT &&
+               rule->compound[idx]->combinator != MyCSS_SELECTORS_COMBINATOR_CHILD)
+                continue;
+            
+            for(entry = rule->compound[ (idx - 1) ]; entry != rule->compound[idx]; entry = entry->next) {
+                size_t key = modest_finder_rules_key_by_entry(entry);
+                
+                if(key == 0)
+                    continue;
+                
+                if(pass)
+                    rule->ancestor_keys[ rule->ancestor_keys_length ] = key;
+                
+                rule->ancestor_keys_length++;
+            }
+        }
+        
+        if(pass || rule->ancestor_keys_length == 0)
+            break;
+        
+        rule->ancestor_keys = mycore_malloc(sizeof(size_t) * rule->ancestor_keys_length);
+        
+        if(rule->ancestor_keys == NULL) {
+            mycore_free(rule->compound);
+            return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+        }
+        
+        rule->ancestor_keys_length = 0;
+    }
+    
+    /* rightmost compound: id, then class, then tag */
+    size_t tag_key = 0, class_key = 0;
+    
+    for(entry = rule->compound[ (rule->compound_length - 1) ]; entry; entry = entry->next)
+    {
+        if(entry->type == MyCSS_SELECTORS_TYPE_ID) {
+            rule->key = modest_finder_rules_key_by_entry(entry);
+            
+            if(rule->key)
+                break;
+        }
+        else if(entry->type == MyCSS_SELECTORS_TYPE_CLASS) {
+            if(class_key == 0)
+                class_key = modest_finder_rules_key_by_entry(entry);
+        }
+        else if(entry->type == MyCSS_SELECTORS_TYPE_ELEMENT) {
+            if(tag_key == 0)
+                tag_key = modest_finder_rules_key_by_entry(entry);
+        }
+    }
+    
+    if(rule->key == 0)
+        rule->key = (class_key ? class_key : tag_key);
+    
+    rules->list_length++;
+    
+    return MODEST_STATUS_OK;
+}
+
+static modest_finder_rules_bucket_t * modest_finder_rules_bucket_search(modest_finder_rules_t* rules, size_t key, bool for_insert)
+{
+    if(rules->buckets_size == 0)
+        return NULL;
+    
+    size_t idx = key & (rules->buckets_size - 1);
+    
+    while(rules->buckets[idx].key) {
+        if(rules->buckets[idx].key == key)
+            return &rules->buckets[idx];
+        
+        idx = (idx + 1) & (rules->buckets_size - 1);
+    }
+    
+    if(for_insert) {
+        rules->buckets[idx].key = key;
+        return &rules->buckets[idx];
+    }
+    
+    return NULL;
+}
+
+static mystatus_t modest_finder_rules_make_buckets(modest_finder_rules_t* rules)
+{
+    size_t keys_count = 0;
+    
+    for(size_t i = 0; i < rules->list_length; i++) {
+        if(rules->list[i].key)
+            keys_count++;
+    }
+    
+    rules->universal_length = rules->list_length - keys_count;
+    
+    if(rules->universal_length) {
+        rules->universal = mycore_malloc(sizeof(size_t) * rules->universal_length);
+        
+        if(rules->universal == NULL)
+            return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+    }
+    
+    if(keys_count == 0) {
+        for(size_t i = 0; i < rules->list_length; i++)
+            rules->universal[i] = i;
+        
+        return MODEST_STATUS_OK;
+    }
+    
+    /* load factor <= 1/2 */
+    rules->buckets_size = 16;
+    
+    while(rules->buckets_size < (keys_count * 2))
+        rules->buckets_size <<= 1;
+    
+    rules->buckets = mycore_calloc(rules->buckets_size, sizeof(modest_finder_rules_bucket_t));
+    rules->bucket_rules = mycore_malloc(sizeof(size_t) * keys_count);
+    
+    if(rules->buckets == NULL || rules->bucket_rules == NULL)
+        return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    for(size_t i = 0; i < rules->list_length; i++) {
+        if(rules->list[i].key)
+            modest_finder_rules_bucket_search(rules, rules->list[i].key, true)->length++;
+    }
+    
+    size_t begin = 0;
+    
+    for(size_t i = 0; i < rules->buckets_size; i++) {
+        rules->buckets[i].begin = begin;
+        begin += rules->buckets[i].length;
+        
+        rules->buckets[i].length = 0;
+    }
+    
+    /* in order of list */
+    size_t universal_length = 0;
+    
+    for(size_t i = 0; i < rules->list_length; i++) {
+        if(rules->list[i].key) {
+            modest_finder_rules_bucket_t* bucket = modest_finder_rules_bucket_search(rules, rules->list[i].key, false);
+            
+            rules->bucket_rules[ (bucket->begin + bucket->length) ] = i;
+            bucket->length++;
+        }
+        else {
+            rules->universal[universal_length] = i;
+            universal_length++;
+        }
+    }
+    
+    return MODEST_STATUS_OK;
+}
+
+static int modest_finder_rules_cmp(const void* left, const void* right)
+{
+    const modest_finder_rule_t *l = (const modest_finder_rule_t*)left, *r = (const modest_finder_rule_t*)right;
+    
+    if(l->specificity.a != r->specificity.a)
+        return (l->specificity.a < r->specificity.a ? -1 : 1);
+    
+    if(l->specificity.b != r->specificity.b)
+        return (l->specificity.b < r->specificity.b ? -1 : 1);
+    
+    if(l->specificity.c != r->specificity.c)
+        return (l->specificity.c < r->specificity.c ? -1 : 1);
+    
+    return (l->order < r->order ? -1 : (l->order > r->order ? 1 : 0));
+}
+
+mystatus_t modest_finder_rules_init(modest_finder_rules_t* rules, mycss_selectors_list_t* selector_list, size_t base_order)
+{
+    mystatus_t status;
+    
+    rules->order_base = base_order;
+    
+    while(selector_list) {
+        for(size_t i = 0; i < selector_list->entries_list_length; i++) {
+            if(selector_list->entries_list[i].entry == NULL)
+                continue;
+            
+            if((status = modest_finder_rules_append(rules, selector_list, &selector_list->entries_list[i])))
+                return status;
+        }
+        
+        selector_list = selector_list->next;
+    }
+    
+    /* candidates are merged by index, so every node gets rules from low to high specificity */
+    if(rules->list_length > 1)
+        qsort(rules->list, rules->list_length, sizeof(modest_finder_rule_t), modest_finder_rules_cmp);
+    
+    return modest_finder_rules_make_buckets(rules);
+}
+
+mystatus_t modest_finder_rules_init_by_stylesheet(modest_finder_rules_t* rules, mycss_stylesheet_t* stylesheet, size_t base_order)
+{
+    return modest_finder_rules_init(rules, stylesheet->sel_list_first, base_order);
+}
+
+size_t modest_finder_rules_order_end(modest_finder_rules_t* rules)
+{
+    return rules->order_base + rules->list_length;
+}
+
+void modest_finder_rules_clean(modest_finder_rules_t* rules)
+{
+    for(size_t i = 0; i < rules->list_length; i++) {
+        if(rules->list[i].compound)
+            mycore_free(rules->list[i].compound);
+        
+        if(rules->list[i].ancestor_keys)
+            mycore_free(rules->list[i].ancestor_keys);
+    }
+    
+    rules->list_length = 0;
+    rules->order_base  = 0;
+    
+    if(rules->buckets) {
+        mycore_free(rules->buckets);
+        rules->buckets = NULL;
+    }
+    
+    if(rules->bucket_rules) {
+        mycore_free(rules->bucket_rules);
+        rules->bucket_rules = NULL;
+    }
+    
+    if(rules->universal) {
+        mycore_free(rules->universal);
+        rules->universal = NULL;
+    }
+    
+    rules->buckets_size = 0;
+    rules->universal_length = 0;
+}
+
+modest_finder_rules_t * modest_finder_rules_destroy(modest_finder_rules_t* rules, bool self_destroy)
+{
+    if(rules == NULL)
+        return NULL;
+    
+    modest_finder_rules_clean(rules);
+    
+    if(rules->list) {
+        mycore_free(rules->list);
+        
+        rules->list = NULL;
+        rules->list_size = 0;
+    }
+    
+    if(self_destroy) {
+        mycore_free(rules);
+        return NULL;
+    }
+    
+    return rules;
+}
+
+/* context */
+modest_finder_rules_context_t * modest_finder_rules_context_create(void)
+{
+    return (modest_finder_rules_context_t*)mycore_calloc(1, sizeof(modest_finder_rules_context_t));
+}
+
+mystatus_t modest_finder_rules_context_init(modest_finder_rules_context_t* context)
+{
+    modest_finder_rules_context_clean(context, NULL);
+    
+    return MODEST_STATUS_OK;
+}
+
+void modest_finder_rules_context_clean(modest_finder_rules_context_t* context, myhtml_tree_node_t* scope_node)
+{
+    memset(context->bloom, 0, sizeof(context->bloom));
+    
+    context->stack_length      = 0;
+    context->stack_keys_length = 0;
+    
+    context->scope = scope_node;
+    context->last  = NULL;
+}
+
+modest_finder_rules_context_t * modest_finder_rules_context_destroy(modest_finder_rules_context_t* context, bool self_destroy)
+{
+    if(context == NULL)
+        return NULL;
+    
+    if(context->stack)
+        mycore_free(context->stack);
+    
+    if(context->stack_keys)
+        mycore_free(context->stack_keys);
+    
+    if(context->keys)
+        mycore_free(context->keys);
+    
+    if(context->candidates)
+        mycore_free(context->candidates);
+    
+    memset(context, 0, sizeof(modest_finder_rules_context_t));
+    
+    if(self_destroy) {
+        mycore_free(context);
+        return NULL;
+    }
+    
+    return context;
+}
+
+/* ancestors Bloom filter with saturating counters; a saturated counter stays, this gives only false positives */
+static void modest_finder_rules_bloom_add(modest_finder_rules_context_t* context, size_t key)
+{
+    size_t first  = key & (MODEST_FINDER_RULES_BLOOM_SIZE - 1);
+    size_t second = (key / MODEST_FINDER_RULES_BLOOM_SIZE) & (MODEST_FINDER_RULES_BLOOM_SIZE - 1);
+    
+    if(context->bloom[first] != 0xff)
+        context->bloom[first]++;
+    
+    if(context->bloom[second] != 0xff)
+        context->bloom[second]++;
+}
+
+static void modest_finder_rules_bloom_remove(modest_finder_rules_context_t* context, size_t key)
+{
+    size_t first  = key & (MODEST_FINDER_RULES_BLOOM_SIZE - 1);
+    size_t second = (key / MODEST_FINDER_RULES_BLOOM_SIZE) & (MODEST_FINDER_RULES_BLOOM_SIZE - 1);
+    
+    if(context->bloom[first] != 0xff && context->bloom[first])
+        context->bloom[first]--;
+    
+    if(context->bloom[second] != 0xff && context->bloom[second])
+        context->bloom[second]--;
+}
+
+static bool modest_finder_rules_bloom_has(modest_finder_rules_context_t* context, size_t key)
+{
+    return context->bloom[ (key & (MODEST_FINDER_RULES_BLOOM_SIZE - 1)) ] &&
+           context->bloom[ ((key / MODEST_FINDER_RULES_BLOOM_SIZE) & (MODEST_FINDER_RULES_BLOOM_SIZE - 1)) ];
+}
+
+static mystatus_t modest_finder_rules_context_stack_check(modest_finder_rules_context_t* context, size_t length)
+{
+    if(length > context->stack_size) {
+        size_t new_size = (context->stack_size ? context->stack_size : 128);
+        
+        while(new_size < length)
+            new_size <<= 1;
+        
+        modest_finder_rules_ancestor_t* tmp = mycore_realloc(context->stack, sizeof(modest_finder_rules_ancestor_t) * new_size);
+        
+        if(tmp == NULL)
+            return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+        
+        context->stack = tmp;
+        context->stack_size = new_size;
+    }
+    
+    return MODEST_STATUS_OK;
+}
+
+static mystatus_t modest_finder_rules_context_push(modest_finder_rules_context_t* context, myhtml_tree_node_t* node)
+{
+    if(modest_finder_rules_context_stack_check(context, (context->stack_length + 1)))
+        return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    size_t begin = context->stack_keys_length;
+    
+    mystatus_t status = modest_finder_rules_node_keys(node, &context->stack_keys, &context->stack_keys_length, &context->stack_keys_size);
+    if(status) {
+        context->stack_keys_length = begin;
+        return status;
+    }
+    
+    for(size_t i = begin; i < context->stack_keys_length; i++)
+        modest_finder_rules_bloom_add(context, context->stack_keys[i]);
+    
+    context->stack[ context->stack_length ].node       = node;
+    context->stack[ context->stack_length ].keys_begin = begin;
+    context->stack_length++;
+    
+    return MODEST_STATUS_OK;
+}
+
+static void modest_finder_rules_context_pop(modest_finder_rules_context_t* context)
+{
+    context->stack_length--;
+    
+    size_t begin = context->stack[ context->stack_length ].keys_begin;
+    
+    for(size_t i = begin; i < context->stack_keys_length; i++)
+        modest_finder_rules_bloom_remove(context, context->stack_keys[i]);
+    
+    context->stack_keys_length = begin;
+}
+
+/* make stack and Bloom filter hold the ancestors of node */
+static mystatus_t modest_finder_rules_context_move(modest_finder_rules_context_t* context, myhtml_tree_node_t* node)
+{
+    myhtml_tree_node_t* parent = (node == context->scope ? NULL : node->parent);
+    
+    if(parent && parent == context->last) {
+        mystatus_t status = modest_finder_rules_context_push(context, parent);
+        
+        if(status)
+            return status;
+        
+        context->last = node;
+        return MODEST_STATUS_OK;
+    }
+    
+    /* in document order parent is in the stack already */
+    size_t idx = context->stack_length;
+    
+    while(idx && context->stack[ (idx - 1) ].node != parent)
+        idx--;
+    
+    if(idx || parent == NULL) {
+        while(context->stack_length > idx)
+            modest_finder_rules_context_pop(context);
+        
+        context->last = node;
+        return MODEST_STATUS_OK;
+    }
+    
+    /* other place, build from scope */
+    modest_finder_rules_context_clean(context, context->scope);
+    
+    size_t depth = 0;
+    myhtml_tree_node_t* anc;
+    
+    for(anc = parent; anc; anc = (anc == context->scope ? NULL : anc->parent))
+        depth++;
+    
+    if(modest_finder_rules_context_stack_check(context, depth))
+        return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    /* put ancestors from scope in place, then push them one by one over themselves */
+    anc = parent;
+    
+    for(size_t i = depth; i > 0; i--) {
+        context->stack[ (i - 1) ].node = anc;
+        anc = anc->parent;
+    }
+    
+    for(size_t i = 0; i < depth; i++) {
+        mystatus_t status = modest_finder_rules_context_push(context, context->stack[i].node);
+        
+        if(status)
+            return status;
+    }
+    
+    context->last = node;
+    
+    return MODEST_STATUS_OK;
+}
+
+/* matching */
+static bool modest_finder_rules_match_compound(modest_finder_t* finder, myhtml_tree_node_t* node,
+                                               mycss_selectors_entry_t* entry, mycss_selectors_specificity_t* spec)
+{
+    do {
+        if(modest_finder_static_selector_type_map[entry->type](finder, node, entry, spec) == false)
+            return false;
+        
+        entry = entry->next;
+    }
+    while(entry && entry->combinator == MyCSS_SELECTORS_COMBINATOR_UNDEF);
+    
+    return true;
+}
+
+static myhtml_tree_node_t * modest_finder_rules_prev_element(myhtml_tree_node_t* node)
+{
+    node = node->prev;
+    
+    while(node && (node->tag_id == MyHTML_TAG__TEXT || node->tag_id == MyHTML_TAG__COMMENT))
+        node = node->prev;
+    
+    return node;
+}
+
+static bool modest_finder_rules_match(modest_finder_t* finder, modest_finder_rules_context_t* context, modest_finder_rule_t* rule,
+                                      size_t idx, myhtml_tree_node_t* node, mycss_selectors_specificity_t* spec)
+{
+    mycss_selectors_specificity_t match_spec = *spec;
+    
+    if(modest_finder_rules_match_compound(finder, node, rule->compound[idx], &match_spec) == false)
+        return false;
+    
+    if(idx == 0) {
+        *spec = match_spec;
+        return true;
+    }
+    
+    /* all other compound selectors must be inside scope */
+    if(node == context->scope)
+        return false;
+    
+    mycss_selectors_specificity_t try_spec;
+    
+    switch (rule->compound[idx]->combinator) {
+        case MyCSS_SELECTORS_COMBINATOR_DESCENDANT:
+            while(node != context->scope && node->parent) {
+                node = node->parent;
+                try_spec = match_spec;
+                
+                if(modest_finder_rules_match(finder, context, rule, (idx - 1), node, &try_spec)) {
+                    *spec = try_spec;
+                    return true;
+                }
+            }
+            
+            return false;
+            
+        case MyCSS_SELECTORS_COMBINATOR_CHILD:
+            if(node->parent == NULL)
+                return false;
+            
+            try_spec = match_spec;
+            
+            if(modest_finder_rules_match(finder, context, rule, (idx - 1), node->parent, &try_spec)) {
+                *spec = try_spec;
+                return true;
+            }
+            
+            return false;
+            
+        case MyCSS_SELECTORS_COMBINATOR_NEXT_SIBLING:
+            node = modest_finder_rules_prev_element(node);
+            
+            if(node == NULL)
+                return false;
+            
+            try_spec = match_spec;
+            
+            if(modest_finder_rules_match(finder, context, rule, (idx - 1), node, &try_spec)) {
+                *spec = try_spec;
+                return true;
+            }
+            
+            return false;
+            
+        case MyCSS_SELECTORS_COMBINATOR_FOLLOWING_SIBLING:
+            while((node = modest_finder_rules_prev_element(node))) {
+                try_spec = match_spec;
+                
+                if(modest_finder_rules_match(finder, context, rule, (idx - 1), node, &try_spec)) {
+                    *spec = try_spec;
+                    return true;
+                }
+            }
+            
+            return false;
+            
+        default:
+            /* E || F, see modest_finder_node_combinator_column */
+            return false;
+    }
+}
+
+static int modest_finder_rules_candidates_cmp(const void* left, const void* right)
+{
+    size_t l = *((const size_t*)left), r = *((const size_t*)right);
+    
+    return (l < r ? -1 : (l > r ? 1 : 0));
+}
+
+static mystatus_t modest_finder_rules_candidates_append(modest_finder_rules_context_t* context, size_t* list, size_t length)
+{
+    if((context->candidates_length + length) > context->candidates_size) {
+        size_t new_size = (context->candidates_length + length) * 2;
+        size_t* tmp = mycore_realloc(context->candidates, sizeof(size_t) * new_size);
+        
+        if(tmp == NULL)
+            return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+        
+        context->candidates = tmp;
+        context->candidates_size = new_size;
+    }
+    
+    memcpy(&context->candidates[ context->candidates_length ], list, sizeof(size_t) * length);
+    context->candidates_length += length;
+    
+    return MODEST_STATUS_OK;
+}
+
+mystatus_t modest_finder_rules_process_node(modest_finder_t* finder, modest_finder_rules_t* rules, modest_finder_rules_context_t* context,
+                                            myhtml_tree_node_t* node, modest_finder_callback_f callback_found, void* ctx)
+{
+    if(node->tag_id == MyHTML_TAG__TEXT || node->tag_id == MyHTML_TAG__COMMENT)
+        return MODEST_STATUS_OK;
+    
+    mystatus_t status = modest_finder_rules_context_move(context, node);
+    if(status)
+        return status;
+    
+    /* candidates from buckets of node keys */
+    context->keys_length = 0;
+    context->candidates_length = 0;
+    
+    status = modest_finder_rules_node_keys(node, &context->keys, &context->keys_length, &context->keys_size);
+    if(status)
+        return status;
+    
+    size_t sources = 0;
+    
+    for(size_t i = 0; i < context->keys_length; i++) {
+        modest_finder_rules_bucket_t* bucket = modest_finder_rules_bucket_search(rules, context->keys[i], false);
+        
+        if(bucket) {
+            if((status = modest_finder_rules_candidates_append(context, &rules->bucket_rules[bucket->begin], bucket->length)))
+                return status;
+            
+            sources++;
+        }
+    }
+    
+    if(rules->universal_length) {
+        if((status = modest_finder_rules_candidates_append(context, rules->universal, rules->universal_length)))
+            return status;
+        
+        sources++;
+    }
+    
+    /* in source order and once, like in left to right */
+    if(sources > 1) {
+        qsort(context->candidates, context->candidates_length, sizeof(size_t), modest_finder_rules_candidates_cmp);
+        
+        size_t length = 1;
+        
+        for(size_t i = 1; i < context->candidates_length; i++) {
+            if(context->candidates[i] != context->candidates[ (length - 1) ]) {
+                context->candidates[length] = context->candidates[i];
+                length++;
+            }
+        }
+        
+        context->candidates_length = length;
+    }
+    
+    for(size_t i = 0; i < context->candidates_length; i++)
+    {
+        modest_finder_rule_t* rule = &rules->list[ context->candidates[i] ];
+        size_t key_idx = 0;
+        
+        while(key_idx < rule->ancestor_keys_length && modest_finder_rules_bloom_has(context, rule->ancestor_keys[key_idx]))
+            key_idx++;
+        
+        if(key_idx < rule->ancestor_keys_length)
+            continue;
+        
+        mycss_selectors_specificity_t spec = rule->entries->specificity;
+        
+        if(modest_finder_rules_match(finder, context, rule, (rule->compound_length - 1), node, &spec)) {
+            if(callback_found) {
+                context->rule = rule;
+                callback_found(finder, node, rule->selector_list, rule->entry_last, &spec, ctx);
+            }
+        }
+    }
+    
+    return MODEST_STATUS_OK;
+}
+
+mystatus_t modest_finder_rules_process(modest_finder_t* finder, modest_finder_rules_t* rules, modest_finder_rules_context_t* context,
+                                       myhtml_tree_node_t** nodes, size_t nodes_length,
+                                       modest_finder_callback_f callback_found, void* ctx)
+{
+    for(size_t i = 0; i < nodes_length; i++) {
+        mystatus_t status = modest_finder_rules_process_node(finder, rules, context, nodes[i], callback_found, ctx);
+        
+        if(status)
+            return status;
+    }
+    
+    return MODEST_STATUS_OK;
+}
+
+mystatus_t modest_finder_rules_find(modest_finder_t* finder, modest_finder_rules_t* rules, myhtml_tree_node_t* scope_node,
+                                    modest_finder_callback_f callback_found, void* ctx)
+{
+    modest_finder_rules_context_t *context = modest_finder_rules_context_create();
+    
+    if(context == NULL)
+        return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    mystatus_t status = modest_finder_rules_context_init(context);
+    
+    if(status) {
+        modest_finder_rules_context_destroy(context, true);
+        return status;
+    }
+    
+    modest_finder_rules_context_clean(context, scope_node);
+    
+    myhtml_tree_node_t *node = scope_node;
+    
+    while(node) {
+        if((status = modest_finder_rules_process_node(finder, rules, context, node, callback_found, ctx)))
+            break;
+        
+        if(node->child)
+            node = node->child;
+        else {
+            while(node != scope_node && node->next == NULL)
+                node = node->parent;
+            
+            if(node == scope_node)
+                break;
+            
+            node = node->next;
+        }
+    }
+    
+    modest_finder_rules_context_destroy(context, true);
+    
+    return status;
+}
+
+mystatus_t modest_finder_by_rules(modest_finder_t* finder, myhtml_tree_node_t* scope_node,
+                                  modest_finder_rules_t* rules, myhtml_collection_t** collection)
+{
+    if(finder == NULL || rules == NULL || scope_node == NULL || collection == NULL)
+        return MODEST_STATUS_ERROR;
+    
+    if(*collection == NULL) {
+        mystatus_t status;
+        *collection = myhtml_collection_create(4096, &status);
+        
+        if(status)
+            return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+    }
+    
+    return modest_finder_rules_find(finder, rules, scope_node, modest_finder_callback_found_with_collection, *collection);
+}
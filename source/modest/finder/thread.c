@@ -23,13 +23,20 @@
 /* private functions */
 #ifndef MyCORE_BUILD_WITHOUT_THREADS
 static void modest_finder_thread_stream(mythread_id_t thread_id, void* arg);
+static mystatus_t modest_finder_thread_work_prepare(modest_finder_thread_t* finder_thread, mycss_selectors_list_t* selector_list);
 #else
 static void modest_finder_thread_stream_single(modest_finder_thread_t* finder_thread, mycss_selectors_list_t* selector_list);
 #endif
 
 static modest_finder_thread_context_t * modest_finder_thread_create_context(modest_finder_thread_t* finder_thread, size_t count);
-//static void modest_finder_thread_callback_found(modest_finder_t* finder, myhtml_tree_node_t* node, mycss_selectors_list_t* selector_list,
-//                                                mycss_selectors_entry_t* selector, mycss_selectors_specificity_t* spec, void* ctx);
+static mystatus_t modest_finder_thread_process_run(modest_t* modest, modest_finder_thread_t* finder_thread,
+                                                   myhtml_tree_node_t* scope_node, mycss_selectors_list_t* selector_list);
+static mystatus_t modest_finder_thread_rules_prepare(modest_finder_thread_t* finder_thread, mycss_selectors_list_t* selector_list);
+static mystatus_t modest_finder_thread_nodes_prepare(modest_finder_thread_t* finder_thread, myhtml_tree_node_t* scope_node);
+static mystatus_t modest_finder_thread_collate_context(modest_t* modest, modest_finder_thread_context_t* context);
+static void modest_finder_thread_drop_context(modest_finder_thread_context_t* context);
+void modest_finder_thread_callback_found(modest_finder_t* finder, myhtml_tree_node_t* node, mycss_selectors_list_t* selector_list,
+                                         mycss_selectors_entry_t* selector, mycss_selectors_specificity_t* spec, void* ctx);
 
 /* basic functions */
 modest_finder_thread_t * modest_finder_thread_create(void)
@@ -44,6 +51,8 @@ mystatus_t modest_finder_thread_init(modest_finder_t* finder, modest_finder_thre
 #endif
     
     finder_thread->finder = finder;
+    finder_thread->steal  = true;
+    finder_thread->origin = MODEST_STYLE_RAW_ORIGIN_AUTHOR;
     
     /* objects for nodes */
     finder_thread->entry_obj = mcobject_async_create();
@@ -95,10 +104,12 @@ mystatus_t modest_finder_thread_init(modest_finder_t* finder, modest_finder_thre
 
 void modest_finder_thread_clean(modest_finder_thread_t* finder_thread, bool self_destroy)
 {
-    for(size_t i = 1; i < finder_thread->context_list_size; i++) {
+    for(size_t i = 0; i < finder_thread->context_list_size; i++) {
         mcobject_async_node_clean(finder_thread->entry_obj, finder_thread->context_list[i].entry_node_id);
         mcobject_async_node_clean(finder_thread->declaration_obj, finder_thread->context_list[i].declaration_node_id);
     }
+    
+    finder_thread->order_base = 0;
 }
 
 modest_finder_thread_t * modest_finder_thread_destroy(modest_finder_thread_t* finder_thread, bool self_destroy)
@@ -116,12 +127,41 @@ modest_finder_thread_t * modest_finder_thread_destroy(modest_finder_thread_t* fi
     finder_thread->declaration_obj = mcobject_async_destroy(finder_thread->declaration_obj, true);
     
     if(finder_thread->context_list) {
+        for(size_t i = 0; i < finder_thread->context_list_size; i++) {
+            if(finder_thread->context_list[i].index)
+                mycore_free(finder_thread->context_list[i].index);
+            
+            modest_finder_rules_context_destroy(finder_thread->context_list[i].rules_context, true);
+            
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+            mcdeque_destroy(&finder_thread->context_list[i].deque, false);
+#endif
+        }
+        
         mycore_free(finder_thread->context_list);
         
         finder_thread->context_list = NULL;
         finder_thread->context_list_size = 0;
     }
     
+    if(finder_thread->work_list) {
+        mycore_free(finder_thread->work_list);
+        
+        finder_thread->work_list = NULL;
+        finder_thread->work_list_size = 0;
+        finder_thread->work_list_length = 0;
+    }
+    
+    finder_thread->rules = modest_finder_rules_destroy(finder_thread->rules, true);
+    
+    if(finder_thread->node_list) {
+        mycore_free(finder_thread->node_list);
+        
+        finder_thread->node_list = NULL;
+        finder_thread->node_list_size = 0;
+        finder_thread->node_list_length = 0;
+    }
+    
     if(self_destroy) {
         mycore_free(finder_thread);
         return NULL;
@@ -130,115 +170,374 @@ modest_finder_thread_t * modest_finder_thread_destroy(modest_finder_thread_t* fi
     return finder_thread;
 }
 
-void modest_finder_thread_collate_node(modest_t* modest, myhtml_tree_node_t* node, modest_finder_thread_entry_t* entry)
+mystatus_t modest_finder_thread_collate_node(modest_t* modest, myhtml_tree_node_t* node, modest_finder_thread_entry_t* entry)
 {
     modest_finder_thread_declaration_t* dec = entry->declaration;
     
     while(dec) {
-        if(dec->entry)
-            modest_style_map_collate_declaration(modest, node, dec->entry, dec->entry->type, &dec->raw_spec);
+        if(dec->entry) {
+            mystatus_t status = modest_style_map_collate_declaration(modest, node, dec->entry, dec->entry->type, &dec->raw_spec);
+            
+            if(status)
+                return status;
+        }
         
         dec = dec->next;
     }
+    
+    return MODEST_STATUS_OK;
+}
+
+/* node index */
+static size_t modest_finder_thread_index_hash(myhtml_tree_node_t* node, size_t size)
+{
+    unsigned long long key = (unsigned long long)((size_t)node >> 3);
+    return (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & (size - 1);
+}
+
+static modest_finder_thread_entry_t * modest_finder_thread_index_search(modest_finder_thread_context_t* context, myhtml_tree_node_t* node)
+{
+    if(context->index_length == 0)
+        return NULL;
+    
+    size_t idx = modest_finder_thread_index_hash(node, context->index_size);
+    
+    while(context->index[idx]) {
+        if(context->index[idx]->node == node)
+            return context->index[idx];
+        
+        idx = (idx + 1) & (context->index_size - 1);
+    }
+    
+    return NULL;
+}
+
+static void modest_finder_thread_index_insert_entry(modest_finder_thread_entry_t** index, size_t size, modest_finder_thread_entry_t* entry)
+{
+    size_t idx = modest_finder_thread_index_hash(entry->node, size);
+    
+    while(index[idx])
+        idx = (idx + 1) & (size - 1);
+    
+    index[idx] = entry;
+}
+
+static mystatus_t modest_finder_thread_index_add(modest_finder_thread_context_t* context, modest_finder_thread_entry_t* entry)
+{
+    /* keep load factor <= 1/2 */
+    if((context->index_length + 1) * 2 > context->index_size)
+    {
+        size_t new_size = (context->index_size ? (context->index_size * 2) : 1024);
+        modest_finder_thread_entry_t** new_index = mycore_calloc(new_size, sizeof(modest_finder_thread_entry_t*));
+        
+        if(new_index == NULL)
+            return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+        
+        for(size_t i = 0; i < context->index_size; i++) {
+            if(context->index[i])
+                modest_finder_thread_index_insert_entry(new_index, new_size, context->index[i]);
+        }
+        
+        if(context->index)
+            mycore_free(context->index);
+        
+        context->index      = new_index;
+        context->index_size = new_size;
+    }
+    
+    modest_finder_thread_index_insert_entry(context->index, context->index_size, entry);
+    context->index_length++;
+    
+    return MODEST_STATUS_OK;
+}
+
+static void modest_finder_thread_index_clean(modest_finder_thread_context_t* context)
+{
+    if(context->index_length) {
+        memset(context->index, 0, sizeof(modest_finder_thread_entry_t*) * context->index_size);
+        context->index_length = 0;
+    }
+}
+
+mystatus_t modest_finder_thread_collate_context(modest_t* modest, modest_finder_thread_context_t* context)
+{
+    modest_finder_thread_entry_t* entry = context->entry;
+    mystatus_t status = MODEST_STATUS_OK;
+    
+    while(entry) {
+        if((status = modest_finder_thread_collate_node(modest, entry->node, entry)))
+            break;
+        
+        entry = entry->next;
+    }
+    
+    modest_finder_thread_drop_context(context);
+    
+    return status;
+}
+
+/* entries stay in entry_obj until modest_finder_thread_clean, but are not found by the next process */
+void modest_finder_thread_drop_context(modest_finder_thread_context_t* context)
+{
+    context->entry      = NULL;
+    context->entry_last = NULL;
+    
+    modest_finder_thread_index_clean(context);
 }
 
-#ifdef MyCORE_BUILD_WITHOUT_THREADS
 mystatus_t modest_finder_thread_process(modest_t* modest, modest_finder_thread_t* finder_thread,
                                         myhtml_tree_node_t* scope_node, mycss_selectors_list_t* selector_list)
 {
     finder_thread->base_node = scope_node;
     finder_thread->selector_list = selector_list;
+    finder_thread->rules_ref = NULL;
     
     if(finder_thread->finder == NULL)
         return MODEST_STATUS_ERROR;
     
-    modest_finder_thread_stream_single(finder_thread, selector_list);
+    /* threads only read the index */
+    if(scope_node->tree && scope_node->tree->index)
+        myhtml_index_update(scope_node->tree->index, true);
     
-    /* calc result */
-    modest_finder_thread_context_t* context = finder_thread->context_list;
-    myhtml_tree_node_t* node = scope_node;
+    if(finder_thread->mode == MODEST_FINDER_THREAD_MODE_RIGHT_TO_LEFT) {
+        mystatus_t status = modest_finder_thread_rules_prepare(finder_thread, selector_list);
+        if(status)
+            return status;
+        
+        finder_thread->rules_ref = finder_thread->rules;
+    }
     
-    /* compare results */
-    while(node) {
-        modest_finder_thread_entry_t* entry = context->entry;
-        
-        while(entry) {
-            if(entry->node == node)
-            {
-                if(entry->next)
-                    entry->next->prev = entry->prev;
-                else
-                    context->entry_last = entry->prev;
-                
-                if(entry->prev)
-                    entry->prev->next = entry->next;
-                else
-                    context->entry = entry->next;
-                
-                modest_finder_thread_collate_node(modest, node, entry);
-            }
-            
-            entry = entry->next;
+    mystatus_t status = modest_finder_thread_process_run(modest, finder_thread, scope_node, selector_list);
+    
+    if(status == MODEST_STATUS_OK) {
+        if(finder_thread->rules_ref) {
+            finder_thread->order_base = modest_finder_rules_order_end(finder_thread->rules_ref);
         }
-        
-        if(node->child)
-            node = node->child;
         else {
-            while(node != scope_node && node->next == NULL)
-                node = node->parent;
-            
-            if(node == scope_node)
-                break;
-            
-            node = node->next;
+            /* left to right gives an order to every entry, see modest_finder_thread_stream_single */
+            for(mycss_selectors_list_t* list = selector_list; list; list = list->next)
+                finder_thread->order_base += list->entries_list_length;
         }
     }
     
-    return MyCORE_STATUS_OK;
+    return status;
 }
 
-#else /* end def MyCORE_BUILD_WITHOUT_THREADS */
-mystatus_t modest_finder_thread_process(modest_t* modest, modest_finder_thread_t* finder_thread,
-                                        myhtml_tree_node_t* scope_node, mycss_selectors_list_t* selector_list)
+mystatus_t modest_finder_thread_process_rules(modest_t* modest, modest_finder_thread_t* finder_thread,
+                                              myhtml_tree_node_t* scope_node, modest_finder_rules_t* rules)
 {
     finder_thread->base_node = scope_node;
-    finder_thread->selector_list = selector_list;
+    finder_thread->selector_list = NULL;
+    finder_thread->rules_ref = rules;
     
-    if(finder_thread->finder == NULL)
+    if(finder_thread->finder == NULL || rules == NULL)
         return MODEST_STATUS_ERROR;
     
+    /* orders of rules are given by modest_finder_rules_init */
+    mystatus_t status = modest_finder_thread_process_run(modest, finder_thread, scope_node, NULL);
+    
+    if(status == MODEST_STATUS_OK && finder_thread->order_base < modest_finder_rules_order_end(rules))
+        finder_thread->order_base = modest_finder_rules_order_end(rules);
+    
+    return status;
+}
+
+#ifdef MyCORE_BUILD_WITHOUT_THREADS
+mystatus_t modest_finder_thread_process_run(modest_t* modest, modest_finder_thread_t* finder_thread,
+                                            myhtml_tree_node_t* scope_node, mycss_selectors_list_t* selector_list)
+{
+    finder_thread->context_list->work_done   = 0;
+    finder_thread->context_list->work_stolen = 0;
+    finder_thread->context_list->status      = MODEST_STATUS_OK;
+    
+    if(finder_thread->rules_ref) {
+        mystatus_t status = modest_finder_thread_nodes_prepare(finder_thread, scope_node);
+        if(status)
+            return status;
+        
+        modest_finder_thread_found_context_t found_ctx = {finder_thread, finder_thread->context_list, 0};
+        
+        status = modest_finder_rules_process(finder_thread->finder, finder_thread->rules_ref, finder_thread->context_list->rules_context,
+                                             finder_thread->node_list, finder_thread->node_list_length,
+                                             modest_finder_thread_callback_found, &found_ctx);
+        if(status) {
+            modest_finder_thread_drop_context(finder_thread->context_list);
+            return status;
+        }
+        
+        finder_thread->context_list->work_done = finder_thread->node_list_length;
+    }
+    else {
+        modest_finder_thread_stream_single(finder_thread, selector_list);
+    }
+    
+    if(finder_thread->context_list->status) {
+        modest_finder_thread_drop_context(finder_thread->context_list);
+        return finder_thread->context_list->status;
+    }
+    
+    /* calc result */
+    return modest_finder_thread_collate_context(modest, finder_thread->context_list);
+}
+
+#else /* end def MyCORE_BUILD_WITHOUT_THREADS */
+mystatus_t modest_finder_thread_process_run(modest_t* modest, modest_finder_thread_t* finder_thread,
+                                            myhtml_tree_node_t* scope_node, mycss_selectors_list_t* selector_list)
+{
+    mystatus_t status;
+    
+    if(finder_thread->rules_ref) {
+        if((status = modest_finder_thread_nodes_prepare(finder_thread, scope_node)))
+            return status;
+    }
+    
+    if((status = modest_finder_thread_work_prepare(finder_thread, selector_list)))
+        return status;
+    
     mythread_resume(finder_thread->thread, MyTHREAD_OPT_UNDEF);
     modest_finder_thread_wait_for_all_done(finder_thread);
     
-    /* calc result */
-    modest_finder_thread_context_t* context_list = finder_thread->context_list;
-    myhtml_tree_node_t* node = scope_node;
+    for(size_t i = 0; i < finder_thread->thread->entries_length; i++) {
+        if(finder_thread->context_list[i].status) {
+            status = finder_thread->context_list[i].status;
+            
+            for(size_t t = 0; t < finder_thread->thread->entries_length; t++)
+                modest_finder_thread_drop_context(&finder_thread->context_list[t]);
+            
+            return status;
+        }
+    }
+    
+    /* calc result; per node, threads are collated in id order as before */
+    for(size_t i = 0; i < finder_thread->thread->entries_length; i++) {
+        if((status = modest_finder_thread_collate_context(modest, &finder_thread->context_list[i]))) {
+            for(size_t t = (i + 1); t < finder_thread->thread->entries_length; t++)
+                modest_finder_thread_drop_context(&finder_thread->context_list[t]);
+            
+            return status;
+        }
+    }
+    
+    return MODEST_STATUS_OK;
+}
+
+mystatus_t modest_finder_thread_work_prepare(modest_finder_thread_t* finder_thread, mycss_selectors_list_t* selector_list)
+{
+    size_t count = 0;
+    
+    if(finder_thread->rules_ref)
+    {
+        /* work is a chunk of nodes */
+        count = (finder_thread->node_list_length + (MODEST_FINDER_THREAD_NODE_CHUNK_SIZE - 1)) / MODEST_FINDER_THREAD_NODE_CHUNK_SIZE;
+    }
+    else {
+        for(mycss_selectors_list_t* list = selector_list; list; list = list->next)
+            count += list->entries_list_length;
+        
+        if(count > finder_thread->work_list_size) {
+            modest_finder_thread_work_t* work_list = mycore_realloc(finder_thread->work_list,
+                                                                    sizeof(modest_finder_thread_work_t) * count);
+            
+            if(work_list == NULL)
+                return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+            
+            finder_thread->work_list = work_list;
+            finder_thread->work_list_size = count;
+        }
+        
+        finder_thread->work_list_length = 0;
+        
+        for(mycss_selectors_list_t* list = selector_list; list; list = list->next) {
+            for(size_t i = 0; i < list->entries_list_length; i++) {
+                modest_finder_thread_work_t* work = &finder_thread->work_list[ finder_thread->work_list_length ];
+                
+                work->selector_list = list;
+                work->entries       = &list->entries_list[i];
+                
+                finder_thread->work_list_length++;
+            }
+        }
+    }
+    
+    /*
+     * Every thread gets a contiguous range of selectors (or nodes) and takes it from the bottom of own deque,
+     * in source order; idle threads steal from the other end.
+     */
+    size_t thread_count = finder_thread->thread->entries_length;
+    
+    for(size_t i = 0; i < thread_count; i++) {
+        modest_finder_thread_context_t* context = &finder_thread->context_list[i];
+        
+        size_t begin = (count * i) / thread_count;
+        size_t end   = (count * (i + 1)) / thread_count;
+        
+        if(mcdeque_resize(&context->deque, (end - begin)))
+            return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+        
+        mcdeque_clean(&context->deque);
+        
+        context->work_done   = 0;
+        context->work_stolen = 0;
+        context->status      = MODEST_STATUS_OK;
+        
+        while(end > begin) {
+            end--;
+            mcdeque_push(&context->deque, end);
+        }
+    }
+    
+    return MODEST_STATUS_OK;
+}
+
+void modest_finder_thread_wait_for_all_done(modest_finder_thread_t* finder_thread)
+{
+    mythread_t *mythread = finder_thread->thread;
+    
+    for (size_t idx = 0; idx < mythread->entries_length; idx++) {
+        mythread_cond_wait_while(mythread, mythread->cond,
+                                 (mythread->entries[idx].context.opt & MyTHREAD_OPT_DONE) == 0);
+    }
+}
+#endif /* if undef MyCORE_BUILD_WITHOUT_THREADS */
+
+mystatus_t modest_finder_thread_rules_prepare(modest_finder_thread_t* finder_thread, mycss_selectors_list_t* selector_list)
+{
+    if(finder_thread->rules == NULL) {
+        finder_thread->rules = modest_finder_rules_create();
+        
+        if(finder_thread->rules == NULL)
+            return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+    }
+    else
+        modest_finder_rules_clean(finder_thread->rules);
+    
+    return modest_finder_rules_init(finder_thread->rules, selector_list, finder_thread->order_base);
+}
+
+mystatus_t modest_finder_thread_nodes_prepare(modest_finder_thread_t* finder_thread, myhtml_tree_node_t* scope_node)
+{
+    mystatus_t status;
+    
+    /* nodes in document order */
+    finder_thread->node_list_length = 0;
+    myhtml_tree_node_t *node = scope_node;
     
-    /* compare results */
     while(node) {
-        for(size_t i = 0; i < finder_thread->thread->entries_length; i++)
+        if(node->tag_id != MyHTML_TAG__TEXT && node->tag_id != MyHTML_TAG__COMMENT)
         {
-            modest_finder_thread_context_t* context = &context_list[i];
-            modest_finder_thread_entry_t* entry = context->entry;
-            
-            while(entry) {
-                if(entry->node == node)
-                {
-                    if(entry->next)
-                        entry->next->prev = entry->prev;
-                    else
-                        context->entry_last = entry->prev;
-                    
-                    if(entry->prev)
-                        entry->prev->next = entry->next;
-                    else
-                        context->entry = entry->next;
-                    
-                    modest_finder_thread_collate_node(modest, node, entry);
-                }
+            if(finder_thread->node_list_length >= finder_thread->node_list_size) {
+                size_t new_size = (finder_thread->node_list_size ? (finder_thread->node_list_size * 2) : 4096);
+                myhtml_tree_node_t** tmp = mycore_realloc(finder_thread->node_list, sizeof(myhtml_tree_node_t*) * new_size);
                 
-                entry = entry->next;
+                if(tmp == NULL)
+                    return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+                
+                finder_thread->node_list = tmp;
+                finder_thread->node_list_size = new_size;
             }
+            
+            finder_thread->node_list[ finder_thread->node_list_length ] = node;
+            finder_thread->node_list_length++;
         }
         
         if(node->child)
@@ -254,18 +553,26 @@ mystatus_t modest_finder_thread_process(modest_t* modest, modest_finder_thread_t
         }
     }
     
-    return MODEST_STATUS_OK;
-}
-
-void modest_finder_thread_wait_for_all_done(modest_finder_thread_t* finder_thread)
-{
-    for (size_t idx = 0; idx < finder_thread->thread->entries_length; idx++) {
-        while((finder_thread->thread->entries[idx].context.opt & MyTHREAD_OPT_DONE) == 0) {
-            mythread_nanosleep_sleep(finder_thread->thread->timespec);
+    /* contexts */
+    for(size_t i = 0; i < finder_thread->context_list_size; i++)
+    {
+        modest_finder_thread_context_t* context = &finder_thread->context_list[i];
+        
+        if(context->rules_context == NULL) {
+            context->rules_context = modest_finder_rules_context_create();
+            
+            if(context->rules_context == NULL)
+                return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+            
+            if((status = modest_finder_rules_context_init(context->rules_context)))
+                return status;
         }
+        
+        modest_finder_rules_context_clean(context->rules_context, scope_node);
     }
+    
+    return MODEST_STATUS_OK;
 }
-#endif /* if undef MyCORE_BUILD_WITHOUT_THREADS */
 
 modest_finder_thread_context_t * modest_finder_thread_create_context(modest_finder_thread_t* finder_thread, size_t count)
 {
@@ -315,27 +622,10 @@ modest_finder_thread_context_t * modest_finder_thread_create_context(modest_find
     return ctx;
 }
 
+/* one compare of cascade keys; on equal keys the later declaration of the same rule wins */
 bool modest_finder_thread_spec_is_up(modest_style_raw_specificity_t* spec_f, modest_style_raw_specificity_t* spec_t)
 {
-    if(spec_f->x > spec_t->x)
-        return true;
-    else if(spec_f->x < spec_t->x)
-        return false;
-    
-    if(spec_f->a > spec_t->a)
-        return true;
-    else if(spec_f->a < spec_t->a)
-        return false;
-    
-    if(spec_f->b > spec_t->b)
-        return true;
-    else if(spec_f->b < spec_t->b)
-        return false;
-    
-    if(spec_f->c > spec_t->c)
-        return true;
-    
-    return false;
+    return spec_f->key >= spec_t->key;
 }
 
 void modest_finder_thread_declaratin_append(modest_finder_thread_found_context_t* found_context, bool is_low_priority,
@@ -346,6 +636,11 @@ void modest_finder_thread_declaratin_append(modest_finder_thread_found_context_t
         entry->declaration = entry->declaration_last = mcobject_async_malloc(found_context->finder_thread->declaration_obj,
                                                                              found_context->context->declaration_node_id, NULL);
         
+        if(entry->declaration == NULL) {
+            found_context->context->status = MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+            return;
+        }
+        
         entry->declaration->entry     = dec_entry;
         entry->declaration->raw_spec  = *raw_spec;
         entry->declaration->next      = NULL;
@@ -373,6 +668,11 @@ void modest_finder_thread_declaratin_append(modest_finder_thread_found_context_t
     thr_dec = mcobject_async_malloc(found_context->finder_thread->declaration_obj,
                                     found_context->context->declaration_node_id, NULL);
     
+    if(thr_dec == NULL) {
+        found_context->context->status = MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+        return;
+    }
+    
     thr_dec->next     = NULL;
     thr_dec->entry    = dec_entry;
     thr_dec->raw_spec = *raw_spec;
@@ -385,10 +685,12 @@ void modest_finder_thread_declaratin_append(modest_finder_thread_found_context_t
 
 void modest_finder_thread_declaratin_list_replace(modest_finder_thread_found_context_t* found_context,
                                                   modest_finder_thread_entry_t* entry, mycss_declaration_entry_t* dec_entry,
-                                                  mycss_selectors_specificity_t* spec)
+                                                  unsigned long long cascade_key)
 {
+    modest_style_raw_origin_t origin = found_context->finder_thread->origin;
+    
     while(dec_entry) {
-        modest_style_raw_specificity_t raw_spec = {((unsigned int)dec_entry->is_important), spec->a, spec->b, spec->c};
+        modest_style_raw_specificity_t raw_spec = {modest_style_raw_cascade_key_declaration(cascade_key, origin, dec_entry->is_important)};
         
         modest_finder_thread_declaratin_append(found_context, false, entry, dec_entry, &raw_spec);
         
@@ -401,26 +703,39 @@ void modest_finder_thread_callback_found(modest_finder_t* finder, myhtml_tree_no
     modest_finder_thread_found_context_t* found_context = (modest_finder_thread_found_context_t*)ctx;
     modest_finder_thread_context_t* thread_context = found_context->context;
     
-    if(thread_context->entry_last) {
-        modest_finder_thread_entry_t* entry = thread_context->entry;
+    /* specificity of the match can differ from the rule one, for :matches() and :nth-child(of) */
+    unsigned long long cascade_key;
+    
+    if(found_context->finder_thread->rules_ref) {
+        modest_finder_rule_t* rule = thread_context->rules_context->rule;
         
-        while(entry)
-        {
-            if(entry->node == node) {
-                modest_finder_thread_declaratin_list_replace(found_context, entry, selector_list->declaration_entry, spec);
-                return;
-            }
-            
-            entry = entry->next;
-        }
+        if(rule->specificity.a == spec->a && rule->specificity.b == spec->b && rule->specificity.c == spec->c)
+            cascade_key = rule->cascade_key;
+        else
+            cascade_key = modest_style_raw_cascade_key(spec->a, spec->b, spec->c, rule->order);
+    }
+    else
+        cascade_key = modest_style_raw_cascade_key(spec->a, spec->b, spec->c, found_context->order);
+    
+    modest_finder_thread_entry_t* entry = modest_finder_thread_index_search(thread_context, node);
+    
+    if(entry) {
+        modest_finder_thread_declaratin_list_replace(found_context, entry, selector_list->declaration_entry, cascade_key);
+        return;
+    }
+    
+    entry = mcobject_async_malloc(found_context->finder_thread->entry_obj, thread_context->entry_node_id, NULL);
+    
+    if(entry == NULL) {
+        thread_context->status = MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+        return;
     }
     
-    modest_finder_thread_entry_t* entry = mcobject_async_malloc(found_context->finder_thread->entry_obj, thread_context->entry_node_id, NULL);
     memset(entry, 0, sizeof(modest_finder_thread_entry_t));
     
     entry->node = node;
     
-    modest_finder_thread_declaratin_list_replace(found_context, entry, selector_list->declaration_entry, spec);
+    modest_finder_thread_declaratin_list_replace(found_context, entry, selector_list->declaration_entry, cascade_key);
     
     if(thread_context->entry_last) {
         entry->prev = thread_context->entry_last;
@@ -431,11 +746,16 @@ void modest_finder_thread_callback_found(modest_finder_t* finder, myhtml_tree_no
     else {
         thread_context->entry_last = thread_context->entry = entry;
     }
+    
+    mystatus_t status = modest_finder_thread_index_add(thread_context, entry);
+    
+    if(status && thread_context->status == MODEST_STATUS_OK)
+        thread_context->status = status;
 }
 
 void modest_finder_thread_stream_single(modest_finder_thread_t* finder_thread, mycss_selectors_list_t* selector_list)
 {
-    modest_finder_thread_found_context_t found_ctx = {finder_thread, finder_thread->context_list};
+    modest_finder_thread_found_context_t found_ctx = {finder_thread, finder_thread->context_list, finder_thread->order_base};
     
     while(selector_list)
     {
@@ -445,6 +765,9 @@ void modest_finder_thread_stream_single(modest_finder_thread_t* finder_thread, m
             
             modest_finder_node_combinator_begin(finder_thread->finder, finder_thread->base_node, selector_list,
                                                 entries->entry, &spec, modest_finder_thread_callback_found, &found_ctx);
+            
+            found_ctx.context->work_done++;
+            found_ctx.order++;
         }
         
         selector_list = selector_list->next;
@@ -452,35 +775,62 @@ void modest_finder_thread_stream_single(modest_finder_thread_t* finder_thread, m
 }
 
 #ifndef MyCORE_BUILD_WITHOUT_THREADS
+static void modest_finder_thread_stream_work(modest_finder_thread_t* finder_thread, size_t idx, modest_finder_thread_found_context_t* found_ctx)
+{
+    if(finder_thread->rules_ref)
+    {
+        size_t begin  = idx * MODEST_FINDER_THREAD_NODE_CHUNK_SIZE;
+        size_t length = finder_thread->node_list_length - begin;
+        
+        if(length > MODEST_FINDER_THREAD_NODE_CHUNK_SIZE)
+            length = MODEST_FINDER_THREAD_NODE_CHUNK_SIZE;
+        
+        mystatus_t status = modest_finder_rules_process(finder_thread->finder, finder_thread->rules_ref, found_ctx->context->rules_context,
+                                                        &finder_thread->node_list[begin], length, modest_finder_thread_callback_found, found_ctx);
+        
+        if(status && found_ctx->context->status == MODEST_STATUS_OK)
+            found_ctx->context->status = status;
+    }
+    else {
+        modest_finder_thread_work_t* work = &finder_thread->work_list[idx];
+        mycss_selectors_specificity_t spec = work->entries->specificity;
+        
+        /* work list is in source order */
+        found_ctx->order = finder_thread->order_base + idx;
+        
+        modest_finder_node_combinator_begin(finder_thread->finder, finder_thread->base_node, work->selector_list,
+                                            work->entries->entry, &spec, modest_finder_thread_callback_found, found_ctx);
+    }
+    
+    found_ctx->context->work_done++;
+}
+
 void modest_finder_thread_stream(mythread_id_t thread_id, void* arg)
 {
     mythread_context_t* ctx = (mythread_context_t*)arg;
     modest_finder_thread_t* finder_thread = (modest_finder_thread_t*)ctx->mythread->context;
-    mycss_selectors_list_t* selector_list = finder_thread->selector_list;
+    modest_finder_thread_context_t* context = &finder_thread->context_list[ctx->id];
     
-    modest_finder_thread_found_context_t found_ctx = {finder_thread, &finder_thread->context_list[ctx->id]};
+    modest_finder_thread_found_context_t found_ctx = {finder_thread, context, 0};
+    size_t idx;
     
-    size_t count = 0, counnt_done = ctx->id - 1;
-    size_t offset = (ctx->mythread->entries_size - 1);
+    while(mcdeque_pop(&context->deque, &idx)) {
+        modest_finder_thread_stream_work(finder_thread, idx, &found_ctx);
+    }
     
-    while(selector_list) {
-        for(size_t i = 0; i < selector_list->entries_list_length; i++) {
-            /* split selectors by thread id */
-            if(count == counnt_done) {
-                mycss_selectors_entries_list_t *entries = &selector_list->entries_list[i];
-                mycss_selectors_specificity_t spec = entries->specificity;
-                
-                modest_finder_node_combinator_begin(finder_thread->finder, finder_thread->base_node, selector_list,
-                                                    entries->entry, &spec, modest_finder_thread_callback_found, &found_ctx);
-                
-                counnt_done += offset;
-            }
-            
-            count++;
-        }
+    if(finder_thread->steal == false)
+        return;
+    
+    /* nothing is pushed while threads run, so one pass over others is enough */
+    size_t thread_count = ctx->mythread->entries_length;
+    
+    for(size_t i = 1; i < thread_count; i++) {
+        mcdeque_t* victim = &finder_thread->context_list[ ((ctx->id + i) % thread_count) ].deque;
         
-        selector_list = selector_list->next;
+        while(mcdeque_steal(victim, &idx)) {
+            modest_finder_thread_stream_work(finder_thread, idx, &found_ctx);
+            context->work_stolen++;
+        }
     }
 }
 #endif
-
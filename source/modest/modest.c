@@ -22,6 +22,7 @@
 #include "modest/style/sheet.h"
 #include "modest/style/raw.h"
 #include "modest/node/node.h"
+#include "modest/node/store.h"
 
 modest_t * modest_create(void)
 {
@@ -37,7 +38,9 @@ mystatus_t modest_init(modest_t* modest)
     if(modest->mnode_obj == NULL)
         return MODEST_STATUS_ERROR_MNODE_CREATE;
     
-    mcobject_async_status_t mcstatus = mcobject_async_init(modest->mnode_obj, 128, 1024, sizeof(modest_node_t));
+    mcobject_async_allocator_set(modest->mnode_obj, modest->allocator);
+    
+    mcobject_async_status_t mcstatus = mcobject_async_init(modest->mnode_obj, 128, 1024, sizeof(modest_node_entry_t));
     if(mcstatus)
         return MODEST_STATUS_ERROR_MNODE_INIT;
     
@@ -52,6 +55,8 @@ mystatus_t modest_init(modest_t* modest)
     if(modest->mstylesheet_obj == NULL)
         return MODEST_STATUS_ERROR_STYLESHEET_CREATE;
     
+    mcobject_async_allocator_set(modest->mstylesheet_obj, modest->allocator);
+    
     mcstatus = mcobject_async_init(modest->mstylesheet_obj, 128, 1024, sizeof(modest_style_sheet_t));
     if(mcstatus)
         return MODEST_STATUS_ERROR_STYLESHEET_INIT;
@@ -67,6 +72,8 @@ mystatus_t modest_init(modest_t* modest)
     if(modest->mstyle_type_obj == NULL)
         return MODEST_STATUS_ERROR_STYLE_TYPE_CREATE;
     
+    mchar_async_allocator_set(modest->mstyle_type_obj, modest->allocator);
+    
     if((status = mchar_async_init(modest->mstyle_type_obj, 12, (4096 * 5))))
         return status;
     
@@ -79,11 +86,28 @@ mystatus_t modest_init(modest_t* modest)
     if(modest->mraw_style_declaration_obj == NULL)
         return MODEST_STATUS_ERROR_STYLE_DECLARATION_CREATE;
     
+    mcobject_allocator_set(modest->mraw_style_declaration_obj, modest->allocator);
+    
     mystatus_t myhtml_status = mcobject_init(modest->mraw_style_declaration_obj, 256, sizeof(modest_style_raw_declaration_t));
     if(myhtml_status)
         return MODEST_STATUS_ERROR_STYLE_DECLARATION_INIT;
     
     
+    /* lists of node declarations, freed only by modest_clean */
+    modest->mnode_property_obj = mchar_async_create();
+    if(modest->mnode_property_obj == NULL)
+        return MODEST_STATUS_ERROR_NODE_PROPERTY_CREATE;
+    
+    mchar_async_allocator_set(modest->mnode_property_obj, modest->allocator);
+    mchar_async_arena_set(modest->mnode_property_obj, true);
+    
+    if((status = mchar_async_init(modest->mnode_property_obj, 12, (4096 * 5))))
+        return status;
+    
+    modest->mnode_property_node_id = mchar_async_node_add(modest->mnode_property_obj, &status);
+    if(status)
+        return status;
+    
     /* styles tree */
     modest->style_avl_tree = mycore_utils_avl_tree_create();
     if(modest->style_avl_tree == NULL)
@@ -100,9 +124,21 @@ void modest_clean(modest_t* modest)
 {
     mcobject_async_clean(modest->mnode_obj);
     mcobject_async_clean(modest->mstylesheet_obj);
+    mchar_async_clean(modest->mnode_property_obj);
     mycore_utils_avl_tree_clean(modest->style_avl_tree);
 }
 
+/* before modest_init */
+void modest_allocator_set(modest_t* modest, mcallocator_t* allocator)
+{
+    modest->allocator = allocator;
+}
+
+mcallocator_t * modest_allocator(modest_t* modest)
+{
+    return modest->allocator;
+}
+
 modest_t * modest_destroy(modest_t* modest, bool self_destroy)
 {
     if(modest == NULL)
@@ -110,6 +146,9 @@ modest_t * modest_destroy(modest_t* modest, bool self_destroy)
     
     modest->mnode_obj = mcobject_async_destroy(modest->mnode_obj, true);
     modest->mstylesheet_obj = mcobject_async_destroy(modest->mstylesheet_obj, true);
+    modest->mstyle_type_obj = mchar_async_destroy(modest->mstyle_type_obj, true);
+    modest->mraw_style_declaration_obj = mcobject_destroy(modest->mraw_style_declaration_obj, true);
+    modest->mnode_property_obj = mchar_async_destroy(modest->mnode_property_obj, true);
     modest->style_avl_tree = mycore_utils_avl_tree_destroy(modest->style_avl_tree, true);
     
     if(self_destroy) {
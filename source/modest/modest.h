@@ -45,10 +45,17 @@ struct modest {
     
     mcobject_t* mraw_style_declaration_obj;
     
+    /* lists of declarations of nodes, arena */
+    mchar_async_t* mnode_property_obj;
+    size_t mnode_property_node_id;
+    
     modest_layout_t* layout;
     
     mycore_utils_avl_tree_t* style_avl_tree;
     
+    /* for memory of modest objects, NULL for mycore_malloc */
+    mcallocator_t* allocator;
+    
     /* refs */
     myhtml_tree_t* myhtml_tree;
     mycss_entry_t* mycss_entry;
@@ -60,6 +67,9 @@ mystatus_t modest_init(modest_t* modest);
 void modest_clean(modest_t* modest);
 modest_t * modest_destroy(modest_t* modest, bool self_destroy);
 
+void modest_allocator_set(modest_t* modest, mcallocator_t* allocator);
+mcallocator_t * modest_allocator(modest_t* modest);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -19,6 +19,7 @@
 */
 
 #include "modest/node/node.h"
+#include "modest/node/store.h"
 #include "modest/style/sheet.h"
 
 modest_node_t * modest_node_create(modest_t* modest)
@@ -28,49 +29,63 @@ modest_node_t * modest_node_create(modest_t* modest)
     if(mnode == NULL)
         return NULL;
     
-    memset(mnode, 0, sizeof(modest_node_t));
+    memset(mnode, 0, sizeof(modest_node_entry_t));
     
     return mnode;
 }
 
 mystatus_t modest_node_init(modest_t* modest, modest_node_t *mnode)
 {
-    mnode->stylesheet = modest_style_sheet_create(modest);
-    if(mnode->stylesheet == NULL)
-        return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
-    
-    mystatus_t status = modest_style_sheet_init(modest, mnode->stylesheet);
-    if(status)
-        return MODEST_STATUS_ERROR;
+    /* stylesheet is set by modest_style_computed_process, can be shared between nodes */
+    mnode->stylesheet = NULL;
     
     return MODEST_STATUS_OK;
 }
 
-#ifdef MODEST_NODE_FULL_RAW
+#if defined(MODEST_NODE_FULL_RAW)
 
 mycss_declaration_entry_t * modest_node_declaration_by_type(modest_t* modest, modest_node_t *mnode, mycss_property_type_t type)
 {
-    if(mnode->raw_declaration[ type ])
-        return mnode->raw_declaration[ type ]->declaration;
+    modest_node_store_t *store = modest_node_store(mnode);
+    
+    if(store->raw_declaration[ type ])
+        return store->raw_declaration[ type ]->declaration;
     
     return NULL;
 }
 
 modest_style_raw_declaration_t * modest_node_raw_declaration_by_type(modest_t* modest, modest_node_t *mnode, mycss_property_type_t type)
 {
-    return mnode->raw_declaration[ type ];
+    modest_node_store_t *store = modest_node_store(mnode);
+    
+    return store->raw_declaration[ type ];
+}
+
+mystatus_t modest_node_raw_declaration_set_by_type(modest_t* modest, modest_node_t *mnode, mycss_property_type_t type, modest_style_raw_declaration_t *raw_declr)
+{
+    modest_node_store_t *store = modest_node_store(mnode);
+    
+    store->raw_declaration[ type ] = raw_declr;
+    return MODEST_STATUS_OK;
 }
 
-void modest_node_raw_declaration_set_by_type(modest_t* modest, modest_node_t *mnode, mycss_property_type_t type, modest_style_raw_declaration_t *raw_declr)
+void modest_node_raw_declaration_list_all(modest_t* modest, modest_node_t *mnode, modest_node_raw_declaration_callback_f callback, void* context)
 {
-    mnode->raw_declaration[ type ] = raw_declr;
+    modest_node_store_t *store = modest_node_store(mnode);
+    
+    for(size_t i = 0; i < MyCSS_PROPERTY_TYPE_LAST_ENTRY; i++) {
+        if(store->raw_declaration[i])
+            callback((mycss_property_type_t)i, store->raw_declaration[i], context);
+    }
 }
 
-#else
+#elif defined(MODEST_NODE_AVL_TREE)
 
 mycss_declaration_entry_t * modest_node_declaration_by_type(modest_t* modest, modest_node_t *mnode, mycss_property_type_t type)
 {
-    mycore_utils_avl_tree_node_t *find_node = mycore_utils_avl_tree_search_by_type(modest->style_avl_tree, mnode->avl_tree_node, type);
+    modest_node_store_t *store = modest_node_store(mnode);
+    
+    mycore_utils_avl_tree_node_t *find_node = mycore_utils_avl_tree_search_by_type(modest->style_avl_tree, store->avl_tree_node, type);
     
     if(find_node)
         return ((modest_style_raw_declaration_t*)find_node->value)->declaration;
@@ -80,15 +95,164 @@ mycss_declaration_entry_t * modest_node_declaration_by_type(modest_t* modest, mo
 
 modest_style_raw_declaration_t * modest_node_raw_declaration_by_type(modest_t* modest, modest_node_t *mnode, mycss_property_type_t type)
 {
-    mycore_utils_avl_tree_node_t *find_node = mycore_utils_avl_tree_search_by_type(modest->style_avl_tree, mnode->avl_tree_node, type);
+    modest_node_store_t *store = modest_node_store(mnode);
+    
+    mycore_utils_avl_tree_node_t *find_node = mycore_utils_avl_tree_search_by_type(modest->style_avl_tree, store->avl_tree_node, type);
     return (find_node ? find_node->value : NULL);
 }
 
-void modest_node_raw_declaration_set_by_type(modest_t* modest, modest_node_t *mnode, mycss_property_type_t type, modest_style_raw_declaration_t *raw_declr)
+mystatus_t modest_node_raw_declaration_set_by_type(modest_t* modest, modest_node_t *mnode, mycss_property_type_t type, modest_style_raw_declaration_t *raw_declr)
 {
-    mycore_utils_avl_tree_add(modest->style_avl_tree, &mnode->avl_tree_node, type, raw_declr);
+    modest_node_store_t *store = modest_node_store(mnode);
+    
+    mycore_utils_avl_tree_add(modest->style_avl_tree, &store->avl_tree_node, type, raw_declr);
+    return MODEST_STATUS_OK;
 }
 
-#endif /* MODEST_NODE_FULL_RAW */
+struct modest_node_avl_tree_context {
+    modest_node_raw_declaration_callback_f callback;
+    void* context;
+}
+typedef modest_node_avl_tree_context_t;
+
+static void modest_node_avl_tree_callback(mycore_utils_avl_tree_node_t* avl_node, void* ctx)
+{
+    modest_node_avl_tree_context_t *context = ctx;
+    context->callback((mycss_property_type_t)avl_node->type, avl_node->value, context->context);
+}
+
+void modest_node_raw_declaration_list_all(modest_t* modest, modest_node_t *mnode, modest_node_raw_declaration_callback_f callback, void* context)
+{
+    modest_node_store_t *store = modest_node_store(mnode);
+    
+    modest_node_avl_tree_context_t avl_context = {callback, context};
+    mycore_utils_avl_tree_list_all_nodes(modest->style_avl_tree, store->avl_tree_node, modest_node_avl_tree_callback, &avl_context);
+}
+
+#else
+
+#if defined(__GNUC__) || defined(__clang__)
+#define modest_node_popcount(bits) ((size_t)__builtin_popcountll(bits))
+#define modest_node_ctz(bits) ((size_t)__builtin_ctzll(bits))
+#else
+static size_t modest_node_popcount(unsigned long long bits)
+{
+    size_t count = 0;
+    
+    while(bits) {
+        bits &= bits - 1;
+        count++;
+    }
+    
+    return count;
+}
+
+#define modest_node_ctz(bits) modest_node_popcount(((bits) & (~(bits) + 1ULL)) - 1ULL)
+#endif
+
+/* index of type in property_list, if the type bit is set */
+static size_t modest_node_property_index(modest_node_store_t *store, size_t type)
+{
+    size_t word = type >> 6;
+    unsigned long long mask = (1ULL << (type & 63)) - 1ULL;
+    
+    return (size_t)store->property_rank[word] + modest_node_popcount(store->property_bitmap[word] & mask);
+}
+
+static bool modest_node_property_is_set(modest_node_store_t *store, size_t type)
+{
+    return (store->property_bitmap[(type >> 6)] & (1ULL << (type & 63))) != 0;
+}
 
+mycss_declaration_entry_t * modest_node_declaration_by_type(modest_t* modest, modest_node_t *mnode, mycss_property_type_t type)
+{
+    modest_node_store_t *store = modest_node_store(mnode);
+    
+    if(modest_node_property_is_set(store, type) == false)
+        return NULL;
+    
+    return store->property_list[ modest_node_property_index(store, type) ]->declaration;
+}
 
+modest_style_raw_declaration_t * modest_node_raw_declaration_by_type(modest_t* modest, modest_node_t *mnode, mycss_property_type_t type)
+{
+    modest_node_store_t *store = modest_node_store(mnode);
+    
+    if(modest_node_property_is_set(store, type) == false)
+        return NULL;
+    
+    return store->property_list[ modest_node_property_index(store, type) ];
+}
+
+mystatus_t modest_node_raw_declaration_set_by_type(modest_t* modest, modest_node_t *mnode, mycss_property_type_t type, modest_style_raw_declaration_t *raw_declr)
+{
+    modest_node_store_t *store = modest_node_store(mnode);
+    
+    size_t idx = modest_node_property_index(store, type);
+    
+    if(modest_node_property_is_set(store, type)) {
+        store->property_list[idx] = raw_declr;
+        return MODEST_STATUS_OK;
+    }
+    
+    if(store->property_length == store->property_size) {
+        size_t new_size = (store->property_size ? (store->property_size * 2) : MODEST_NODE_PROPERTY_LIST_SIZE);
+        
+        modest_style_raw_declaration_t **list = (modest_style_raw_declaration_t**)
+            mchar_async_malloc(modest->mnode_property_obj, modest->mnode_property_node_id, (sizeof(modest_style_raw_declaration_t*) * new_size));
+        
+        if(list == NULL)
+            return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+        
+        /* old list stays in the arena until modest_clean */
+        if(store->property_length)
+            memcpy(list, store->property_list, (sizeof(modest_style_raw_declaration_t*) * store->property_length));
+        
+        store->property_list = list;
+        store->property_size = (unsigned short)new_size;
+    }
+    
+    memmove(&store->property_list[(idx + 1)], &store->property_list[idx],
+            (sizeof(modest_style_raw_declaration_t*) * (store->property_length - idx)));
+    
+    store->property_list[idx] = raw_declr;
+    store->property_length++;
+    
+    store->property_bitmap[(type >> 6)] |= (1ULL << (type & 63));
+    
+    for(size_t i = ((size_t)type >> 6) + 1; i < MODEST_NODE_PROPERTY_BITMAP_SIZE; i++)
+        store->property_rank[i]++;
+    
+    return MODEST_STATUS_OK;
+}
+
+void modest_node_raw_declaration_list_all(modest_t* modest, modest_node_t *mnode, modest_node_raw_declaration_callback_f callback, void* context)
+{
+    modest_node_store_t *store = modest_node_store(mnode);
+    
+    size_t idx = 0;
+    
+    for(size_t i = 0; i < MODEST_NODE_PROPERTY_BITMAP_SIZE; i++) {
+        unsigned long long bits = store->property_bitmap[i];
+        
+        while(bits) {
+            callback((mycss_property_type_t)((i << 6) + modest_node_ctz(bits)), store->property_list[idx], context);
+            
+            bits &= bits - 1;
+            idx++;
+        }
+    }
+}
+
+#endif /* MODEST_NODE_FULL_RAW */
+
+const char * modest_node_store_name(void)
+{
+#if defined(MODEST_NODE_FULL_RAW)
+    return "full_raw";
+#elif defined(MODEST_NODE_AVL_TREE)
+    return "avl_tree";
+#else
+    return "flat";
+#endif
+}
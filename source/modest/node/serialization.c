@@ -48,19 +48,18 @@ void modest_node_raw_serialization_declaration(mycss_entry_t* mycss_entry, mycss
 //    return is_use;
 //}
 
-void modest_node_raw_serialization_callback(mycore_utils_avl_tree_node_t* node, void* context)
+void modest_node_raw_serialization_callback(mycss_property_type_t type, modest_style_raw_declaration_t *raw_declr, void* context)
 {
     modest_node_serialization_context_t *ctx = context;
     
-    modest_style_raw_declaration_t *raw_declr = node->value;
-    modest_node_raw_serialization_declaration(ctx->modest->mycss_entry, raw_declr->declaration, (mycss_property_type_t)node->type, ctx->callback, ctx->context, &ctx->is_use);
+    modest_node_raw_serialization_declaration(ctx->modest->mycss_entry, raw_declr->declaration, type, ctx->callback, ctx->context, &ctx->is_use);
 }
 
 bool modest_node_raw_serialization(modest_t* modest, modest_node_t* mnode, mycore_callback_serialize_f callback, void* context)
 {
     modest_node_serialization_context_t ctx = {modest, callback, context, 0};
     
-    mycore_utils_avl_tree_list_all_nodes(modest->style_avl_tree, mnode->avl_tree_node, modest_node_raw_serialization_callback, &ctx);
+    modest_node_raw_declaration_list_all(modest, mnode, modest_node_raw_serialization_callback, &ctx);
     
     return ctx.is_use;
 }
@@ -0,0 +1,74 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#ifndef MODEST_NODE_STORE_H
+#define MODEST_NODE_STORE_H
+#pragma once
+
+/*
+ * Internal to the library, not installed: the layout depends on MODEST_BUILD_NODE_STORE.
+ *
+ * Cascaded declarations of node are stored by one of:
+ *   MODEST_NODE_FULL_RAW  -- array of pointers for all property types;
+ *   MODEST_NODE_AVL_TREE  -- AVL tree keyed by property type, nodes in modest->style_avl_tree;
+ *   default               -- bitmap of property types and dense array of declarations ordered by type,
+ *                            arrays are allocated from modest->mnode_property_obj.
+ * The store follows modest_node_t in the same object of modest->mnode_obj.
+ */
+
+#include "modest/node/node.h"
+#include "mycore/utils/avl_tree.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MODEST_NODE_PROPERTY_BITMAP_SIZE ((MyCSS_PROPERTY_TYPE_LAST_ENTRY + 63) / 64)
+#define MODEST_NODE_PROPERTY_LIST_SIZE 4
+
+#define modest_node_store(mnode) (&((modest_node_entry_t*)(mnode))->store)
+
+struct modest_node_store {
+#if defined(MODEST_NODE_FULL_RAW)
+    modest_style_raw_declaration_t * raw_declaration[MyCSS_PROPERTY_TYPE_LAST_ENTRY];
+#elif defined(MODEST_NODE_AVL_TREE)
+    mycore_utils_avl_tree_node_t *avl_tree_node;
+#else
+    unsigned long long property_bitmap[MODEST_NODE_PROPERTY_BITMAP_SIZE];
+    /* count of set bits in words before, index of first declaration of word in property_list */
+    unsigned short property_rank[MODEST_NODE_PROPERTY_BITMAP_SIZE];
+    unsigned short property_length;
+    unsigned short property_size;
+    modest_style_raw_declaration_t **property_list;
+#endif /* MODEST_NODE_FULL_RAW */
+}
+typedef modest_node_store_t;
+
+struct modest_node_entry {
+    modest_node_t node;
+    modest_node_store_t store;
+}
+typedef modest_node_entry_t;
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* MODEST_NODE_STORE_H */
@@ -0,0 +1,840 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#include "modest/style/computed.h"
+#include "modest/style/default.h"
+#include "modest/node/store.h"
+#include "mycss/declaration/default.h"
+#include "mycss/values/color.h"
+#include "mycss/values/units.h"
+
+static void modest_style_computed_node_resolve(modest_style_computed_t* computed, myhtml_tree_node_t* node,
+                                               modest_style_sheet_t* sheet, modest_style_sheet_t* parent);
+
+modest_style_computed_t * modest_style_computed_create(void)
+{
+    return (modest_style_computed_t*)mycore_calloc(1, sizeof(modest_style_computed_t));
+}
+
+mystatus_t modest_style_computed_init(modest_style_computed_t* computed, modest_t* modest)
+{
+    computed->modest = modest;
+    computed->share  = true;
+    
+    computed->viewport_width  = MODEST_STYLE_COMPUTED_VIEWPORT_WIDTH;
+    computed->viewport_height = MODEST_STYLE_COMPUTED_VIEWPORT_HEIGHT;
+    
+    /* initial values, see mycss_declaration_default_by_type */
+    modest_style_sheet_t *initial = &computed->initial;
+    memset(initial, 0, sizeof(modest_style_sheet_t));
+    
+    initial->width.type  = MyCSS_PROPERTY_WIDTH_AUTO;
+    initial->height.type = MyCSS_PROPERTY_HEIGHT_AUTO;
+    
+    initial->padding_top.type    = MyCSS_PROPERTY_VALUE__LENGTH;
+    initial->padding_right.type  = MyCSS_PROPERTY_VALUE__LENGTH;
+    initial->padding_bottom.type = MyCSS_PROPERTY_VALUE__LENGTH;
+    initial->padding_left.type   = MyCSS_PROPERTY_VALUE__LENGTH;
+    
+    initial->margin_top.type    = MyCSS_PROPERTY_VALUE__LENGTH;
+    initial->margin_right.type  = MyCSS_PROPERTY_VALUE__LENGTH;
+    initial->margin_bottom.type = MyCSS_PROPERTY_VALUE__LENGTH;
+    initial->margin_left.type   = MyCSS_PROPERTY_VALUE__LENGTH;
+    
+    initial->display.value = MyCSS_PROPERTY_DISPLAY_INLINE;
+    
+    /* medium; for border style none it is 0, see modest_style_computed_border_width */
+    initial->border_top_width.value    = 3.0f;
+    initial->border_top_width.type     = MyCSS_PROPERTY_VALUE__LENGTH;
+    initial->border_right_width.value  = 3.0f;
+    initial->border_right_width.type   = MyCSS_PROPERTY_VALUE__LENGTH;
+    initial->border_bottom_width.value = 3.0f;
+    initial->border_bottom_width.type  = MyCSS_PROPERTY_VALUE__LENGTH;
+    initial->border_left_width.value   = 3.0f;
+    initial->border_left_width.type    = MyCSS_PROPERTY_VALUE__LENGTH;
+    
+    /* black */
+    initial->color.a = 255;
+    
+    initial->font_size.value   = MODEST_STYLE_COMPUTED_FONT_SIZE_MEDIUM;
+    initial->font_size.type    = MyCSS_PROPERTY_VALUE__LENGTH;
+    initial->font_weight.value = 400;
+    initial->font_style.value  = MyCSS_PROPERTY_FONT_STYLE_NORMAL;
+    initial->line_height.type  = MyCSS_PROPERTY_LINE_HEIGHT_NORMAL;
+    
+    computed->root_font_size = initial->font_size.value;
+    
+    return MODEST_STATUS_OK;
+}
+
+void modest_style_computed_clean(modest_style_computed_t* computed)
+{
+    computed->share_length = 0;
+    computed->share_index  = 0;
+    
+    computed->sheet_count  = 0;
+    computed->shared_count = 0;
+    
+    computed->root_font_size = computed->initial.font_size.value;
+}
+
+modest_style_computed_t * modest_style_computed_destroy(modest_style_computed_t* computed, bool self_destroy)
+{
+    if(computed == NULL)
+        return NULL;
+    
+    if(self_destroy) {
+        mycore_free(computed);
+        return NULL;
+    }
+    
+    return computed;
+}
+
+modest_style_sheet_t * modest_style_computed_by_node(myhtml_tree_node_t* node)
+{
+    if(node == NULL || node->data == NULL)
+        return NULL;
+    
+    return ((modest_node_t*)node->data)->stylesheet;
+}
+
+static modest_style_sheet_t * modest_style_computed_parent(modest_style_computed_t* computed, myhtml_tree_node_t* node)
+{
+    modest_style_sheet_t *parent = modest_style_computed_by_node(node->parent);
+    return (parent ? parent : &computed->initial);
+}
+
+/*
+ * Style sharing
+ */
+struct modest_style_computed_signature_context {
+    modest_t* modest;
+    modest_node_t* mnode;
+    
+    size_t hash;
+    size_t count;
+    bool is_equal;
+}
+typedef modest_style_computed_signature_context_t;
+
+static size_t modest_style_computed_signature_hash(size_t type, mycss_declaration_entry_t* declr)
+{
+    size_t hash = (((size_t)declr) >> 3) ^ (type << 16);
+    return (hash * 2654435761u) ^ (hash >> 15);
+}
+
+static void modest_style_computed_signature_callback(mycss_property_type_t type, modest_style_raw_declaration_t *raw_declr, void* ctx)
+{
+    modest_style_computed_signature_context_t *context = ctx;
+    
+    /* order of declarations is not important */
+    context->hash += modest_style_computed_signature_hash(type, raw_declr->declaration);
+    context->count++;
+}
+
+#if defined(MODEST_NODE_FULL_RAW) || defined(MODEST_NODE_AVL_TREE)
+static void modest_style_computed_equal_callback(mycss_property_type_t type, modest_style_raw_declaration_t *raw_declr, void* ctx)
+{
+    modest_style_computed_signature_context_t *context = ctx;
+    
+    if(context->is_equal == false)
+        return;
+    
+    modest_style_raw_declaration_t *cand_declr = modest_node_raw_declaration_by_type(context->modest, context->mnode, type);
+    
+    if(cand_declr == NULL || cand_declr->declaration != raw_declr->declaration)
+        context->is_equal = false;
+}
+#endif
+
+static void modest_style_computed_signature(modest_t* modest, modest_node_t* mnode, size_t* hash, size_t* count)
+{
+    modest_style_computed_signature_context_t context = {modest, mnode, 0, 0, true};
+    
+    modest_node_raw_declaration_list_all(modest, mnode, modest_style_computed_signature_callback, &context);
+    
+    *hash  = context.hash;
+    *count = context.count;
+}
+
+/* the same cascaded declarations, counts are checked before */
+static bool modest_style_computed_declarations_is_equal(modest_t* modest, modest_node_t* mnode, modest_node_t* cand)
+{
+#if defined(MODEST_NODE_FULL_RAW) || defined(MODEST_NODE_AVL_TREE)
+    modest_style_computed_signature_context_t context = {modest, cand, 0, 0, true};
+    modest_node_raw_declaration_list_all(modest, mnode, modest_style_computed_equal_callback, &context);
+    
+    return context.is_equal;
+#else
+    modest_node_store_t *store = modest_node_store(mnode);
+    modest_node_store_t *cand_store = modest_node_store(cand);
+    
+    /* the same types are at the same positions of lists */
+    if(memcmp(store->property_bitmap, cand_store->property_bitmap, sizeof(store->property_bitmap)))
+        return false;
+    
+    for(size_t i = 0; i < store->property_length; i++) {
+        if(store->property_list[i]->declaration != cand_store->property_list[i]->declaration)
+            return false;
+    }
+    
+    return true;
+#endif
+}
+
+static modest_style_sheet_t * modest_style_computed_share_find(modest_style_computed_t* computed, myhtml_tree_node_t* node,
+                                                               modest_style_sheet_t* parent, size_t hash, size_t count)
+{
+    for(size_t i = 0; i < computed->share_length; i++)
+    {
+        myhtml_tree_node_t *cand = computed->share_list[i].node;
+        
+        if(computed->share_list[i].hash != hash || computed->share_list[i].count != count ||
+           cand->tag_id != node->tag_id || cand->ns != node->ns)
+        {
+            continue;
+        }
+        
+        /* inherited values and percentages of font size */
+        if(modest_style_computed_parent(computed, cand) != parent)
+            continue;
+        
+        if(modest_style_computed_declarations_is_equal(computed->modest, node->data, cand->data))
+            return ((modest_node_t*)cand->data)->stylesheet;
+    }
+    
+    return NULL;
+}
+
+static void modest_style_computed_share_add(modest_style_computed_t* computed, myhtml_tree_node_t* node, size_t hash, size_t count)
+{
+    computed->share_list[ computed->share_index ].node  = node;
+    computed->share_list[ computed->share_index ].hash  = hash;
+    computed->share_list[ computed->share_index ].count = count;
+    
+    computed->share_index = (computed->share_index + 1) % MODEST_STYLE_COMPUTED_SHARE_SIZE;
+    
+    if(computed->share_length < MODEST_STYLE_COMPUTED_SHARE_SIZE)
+        computed->share_length++;
+}
+
+/*
+ * Process
+ */
+static mystatus_t modest_style_computed_node(modest_style_computed_t* computed, myhtml_tree_node_t* node)
+{
+    modest_t *modest = computed->modest;
+    modest_node_t *mnode = node->data;
+    modest_style_sheet_t *parent = modest_style_computed_parent(computed, node);
+    
+    size_t hash = 0, count = 0;
+    bool is_root = (node == node->tree->node_html);
+    
+    if(computed->share && is_root == false) {
+        modest_style_computed_signature(modest, mnode, &hash, &count);
+        
+        modest_style_sheet_t *sheet = modest_style_computed_share_find(computed, node, parent, hash, count);
+        
+        if(sheet) {
+            mnode->stylesheet = sheet;
+            computed->shared_count++;
+            
+            return MODEST_STATUS_OK;
+        }
+    }
+    
+    modest_style_sheet_t *sheet = modest_style_sheet_create(modest);
+    if(sheet == NULL)
+        return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    modest_style_computed_node_resolve(computed, node, sheet, parent);
+    
+    mnode->stylesheet = sheet;
+    computed->sheet_count++;
+    
+    if(is_root) {
+        /* rem of all nodes is changed, nodes before can not be shared */
+        computed->root_font_size = sheet->font_size.value;
+        computed->share_length = 0;
+    }
+    else if(computed->share) {
+        modest_style_computed_share_add(computed, node, hash, count);
+    }
+    
+    return MODEST_STATUS_OK;
+}
+
+mystatus_t modest_style_computed_process(modest_style_computed_t* computed, myhtml_tree_node_t* scope_node)
+{
+    modest_style_computed_clean(computed);
+    
+    if(scope_node == NULL)
+        return MODEST_STATUS_OK;
+    
+    /* scope inside of document, rem by computed root */
+    modest_style_sheet_t *root = modest_style_computed_by_node(scope_node->tree->node_html);
+    
+    if(root && scope_node != scope_node->tree->node_html)
+        computed->root_font_size = root->font_size.value;
+    
+    myhtml_tree_node_t *node = scope_node;
+    
+    while(node) {
+        if(node->data) {
+            mystatus_t status = modest_style_computed_node(computed, node);
+            
+            if(status)
+                return status;
+        }
+        
+        if(node->child)
+            node = node->child;
+        else {
+            while(node != scope_node && node->next == NULL)
+                node = node->parent;
+            
+            if(node == scope_node)
+                break;
+            
+            node = node->next;
+        }
+    }
+    
+    return MODEST_STATUS_OK;
+}
+
+/*
+ * Values
+ */
+static mycss_declaration_entry_t * modest_style_computed_declaration(modest_t* modest, myhtml_tree_node_t* node, mycss_property_type_t type)
+{
+    mycss_declaration_entry_t *declr = modest_node_declaration_by_type(modest, node->data, type);
+    
+    if(declr)
+        return declr;
+    
+    return modest_style_default_declaration_by_html_node(modest, node, type);
+}
+
+/*
+ * Returns declaration for resolve of value;
+ * for not declared property and for inherit, initial, unset the value is copied from parent or initial and NULL is returned.
+ */
+static mycss_declaration_entry_t * modest_style_computed_cascade(modest_style_computed_t* computed, myhtml_tree_node_t* node,
+                                                                 mycss_property_type_t type, bool inherited,
+                                                                 void* value, const void* parent_value, const void* initial_value, size_t size)
+{
+    mycss_declaration_entry_t *declr = modest_style_computed_declaration(computed->modest, node, type);
+    
+    if(declr) {
+        switch (declr->value_type) {
+            case MyCSS_PROPERTY_VALUE_INHERIT:
+                inherited = true;
+                break;
+                
+            case MyCSS_PROPERTY_VALUE_INITIAL:
+                inherited = false;
+                break;
+                
+            case MyCSS_PROPERTY_VALUE_UNSET:
+                break;
+                
+            default:
+                return declr;
+        }
+    }
+    
+    memcpy(value, (inherited ? parent_value : initial_value), size);
+    
+    return NULL;
+}
+
+#define modest_style_computed_number(num) ((num)->is_float ? (num)->value.f : (float)(num)->value.i)
+
+static float modest_style_computed_length_px(modest_style_computed_t* computed, mycss_values_length_t* length, float font_size)
+{
+    float value = modest_style_computed_number(length);
+    
+    switch (length->type) {
+        case MyCSS_UNIT_TYPE_CM:
+            return value * 96.0f / 2.54f;
+        case MyCSS_UNIT_TYPE_IN:
+            return value * 96.0f;
+        case MyCSS_UNIT_TYPE_MM:
+            return value * 96.0f / 25.4f;
+        case MyCSS_UNIT_TYPE_Q:
+            return value * 96.0f / 101.6f;
+        case MyCSS_UNIT_TYPE_PC:
+            return value * 16.0f;
+        case MyCSS_UNIT_TYPE_PT:
+            return value * 96.0f / 72.0f;
+            
+        /* without metrics of font */
+        case MyCSS_UNIT_TYPE_EM:
+        case MyCSS_UNIT_TYPE_IC:
+            return value * font_size;
+        case MyCSS_UNIT_TYPE_EX:
+        case MyCSS_UNIT_TYPE_CH:
+            return value * font_size * 0.5f;
+        case MyCSS_UNIT_TYPE_REM:
+            return value * computed->root_font_size;
+            
+        case MyCSS_UNIT_TYPE_VW:
+        case MyCSS_UNIT_TYPE_VI:
+            return value * computed->viewport_width / 100.0f;
+        case MyCSS_UNIT_TYPE_VH:
+        case MyCSS_UNIT_TYPE_VB:
+            return value * computed->viewport_height / 100.0f;
+        case MyCSS_UNIT_TYPE_VMIN:
+            return value * (computed->viewport_width < computed->viewport_height ? computed->viewport_width : computed->viewport_height) / 100.0f;
+        case MyCSS_UNIT_TYPE_VMAX:
+            return value * (computed->viewport_width > computed->viewport_height ? computed->viewport_width : computed->viewport_height) / 100.0f;
+            
+        /* px and 0 without unit */
+        default:
+            return value;
+    }
+}
+
+static void modest_style_computed_length(modest_style_computed_t* computed, mycss_declaration_entry_t* declr,
+                                         modest_style_type_length_t* length, float font_size)
+{
+    if(declr->value == NULL) {
+        length->value = 0;
+        length->type  = declr->value_type;
+        
+        return;
+    }
+    
+    switch (declr->value_type) {
+        case MyCSS_PROPERTY_VALUE__LENGTH:
+            length->value = modest_style_computed_length_px(computed, declr->value, font_size);
+            break;
+            
+        /* percentages are resolved by layout */
+        case MyCSS_PROPERTY_VALUE__PERCENTAGE:
+            length->value = modest_style_computed_number((mycss_values_percentage_t*)declr->value);
+            break;
+            
+        case MyCSS_PROPERTY_VALUE__NUMBER:
+            length->value = modest_style_computed_number((mycss_values_number_t*)declr->value);
+            break;
+            
+        default:
+            length->value = 0;
+            break;
+    }
+    
+    length->type = declr->value_type;
+}
+
+static void modest_style_computed_length_by_type(modest_style_computed_t* computed, myhtml_tree_node_t* node, mycss_property_type_t type,
+                                                 modest_style_type_length_t* length, const modest_style_type_length_t* parent_length,
+                                                 const modest_style_type_length_t* initial_length, float font_size)
+{
+    mycss_declaration_entry_t *declr = modest_style_computed_cascade(computed, node, type, false, length, parent_length,
+                                                                     initial_length, sizeof(modest_style_type_length_t));
+    
+    if(declr)
+        modest_style_computed_length(computed, declr, length, font_size);
+}
+
+static void modest_style_computed_border_width(modest_style_computed_t* computed, myhtml_tree_node_t* node,
+                                               mycss_property_type_t type, mycss_property_type_t style_type,
+                                               modest_style_type_length_t* length, const modest_style_type_length_t* parent_length,
+                                               const modest_style_type_length_t* initial_length, float font_size)
+{
+    /* style of border is not inherited, initial is none */
+    mycss_declaration_entry_t *style = modest_style_computed_declaration(computed->modest, node, style_type);
+    
+    if(style == NULL || style->value_type == MyCSS_PROPERTY_BORDER_STYLE_NONE ||
+       style->value_type == MyCSS_PROPERTY_BORDER_STYLE_HIDDEN ||
+       style->value_type == MyCSS_PROPERTY_VALUE_INITIAL || style->value_type == MyCSS_PROPERTY_VALUE_UNSET)
+    {
+        length->value = 0;
+        length->type  = MyCSS_PROPERTY_VALUE__LENGTH;
+        
+        return;
+    }
+    
+    mycss_declaration_entry_t *declr = modest_style_computed_cascade(computed, node, type, false, length, parent_length,
+                                                                     initial_length, sizeof(modest_style_type_length_t));
+    
+    if(declr == NULL)
+        return;
+    
+    switch (declr->value_type) {
+        case MyCSS_PROPERTY_BORDER_WIDTH_THIN:
+            length->value = 1.0f;
+            break;
+        case MyCSS_PROPERTY_BORDER_WIDTH_MEDIUM:
+            length->value = 3.0f;
+            break;
+        case MyCSS_PROPERTY_BORDER_WIDTH_THICK:
+            length->value = 5.0f;
+            break;
+        default:
+            modest_style_computed_length(computed, declr, length, font_size);
+            return;
+    }
+    
+    length->type = MyCSS_PROPERTY_VALUE__LENGTH;
+}
+
+static unsigned char modest_style_computed_color_channel(float value)
+{
+    if(value <= 0.0f)
+        return 0;
+    
+    if(value >= 255.0f)
+        return 255;
+    
+    return (unsigned char)(value + 0.5f);
+}
+
+static unsigned char modest_style_computed_color_alpha(mycss_values_color_alpha_value_t* alpha)
+{
+    switch (alpha->type_value) {
+        case MyCSS_VALUES_COLOR_TYPE_VALUE_NUMBER:
+            return modest_style_computed_color_channel(modest_style_computed_number(&alpha->value.number) * 255.0f);
+            
+        case MyCSS_VALUES_COLOR_TYPE_VALUE_PERCENTAGE:
+            return modest_style_computed_color_channel(modest_style_computed_number(&alpha->value.percentage) * 2.55f);
+            
+        default:
+            return 255;
+    }
+}
+
+static float modest_style_computed_color_hue_rgb(float m1, float m2, float hue)
+{
+    if(hue < 0.0f)
+        hue += 1.0f;
+    else if(hue > 1.0f)
+        hue -= 1.0f;
+    
+    if(hue * 6.0f < 1.0f)
+        return m1 + (m2 - m1) * hue * 6.0f;
+    
+    if(hue * 2.0f < 1.0f)
+        return m2;
+    
+    if(hue * 3.0f < 2.0f)
+        return m1 + (m2 - m1) * (2.0f / 3.0f - hue) * 6.0f;
+    
+    return m1;
+}
+
+static void modest_style_computed_color_hsl(mycss_values_color_hsla_t* hsla, modest_style_type_color_t* color)
+{
+    float hue;
+    
+    if(hsla->hue.type_value == MyCSS_VALUES_COLOR_TYPE_VALUE_ANGLE) {
+        mycss_values_angle_t *angle = &hsla->hue.value.angle;
+        hue = modest_style_computed_number(angle);
+        
+        switch (angle->type) {
+            case MyCSS_UNIT_TYPE_GRAD:
+                hue = hue * 0.9f;
+                break;
+            case MyCSS_UNIT_TYPE_RAD:
+                hue = hue * 57.29578f;
+                break;
+            case MyCSS_UNIT_TYPE_TURN:
+                hue = hue * 360.0f;
+                break;
+            default:
+                break;
+        }
+    }
+    else
+        hue = modest_style_computed_number(&hsla->hue.value.number);
+    
+    hue = hue - (360.0f * (float)((long)(hue / 360.0f)));
+    
+    if(hue < 0.0f)
+        hue += 360.0f;
+    
+    hue = hue / 360.0f;
+    
+    float saturation = modest_style_computed_number(&hsla->saturation) / 100.0f;
+    float lightness  = modest_style_computed_number(&hsla->lightness) / 100.0f;
+    
+    float m2 = (lightness <= 0.5f ? lightness * (saturation + 1.0f) : lightness + saturation - lightness * saturation);
+    float m1 = lightness * 2.0f - m2;
+    
+    color->r = modest_style_computed_color_channel(modest_style_computed_color_hue_rgb(m1, m2, hue + 1.0f / 3.0f) * 255.0f);
+    color->g = modest_style_computed_color_channel(modest_style_computed_color_hue_rgb(m1, m2, hue) * 255.0f);
+    color->b = modest_style_computed_color_channel(modest_style_computed_color_hue_rgb(m1, m2, hue - 1.0f / 3.0f) * 255.0f);
+    color->a = modest_style_computed_color_alpha(&hsla->alpha);
+}
+
+static void modest_style_computed_color(mycss_declaration_entry_t* declr, modest_style_type_color_t* color,
+                                        const modest_style_type_color_t* parent_color, const modest_style_type_color_t* initial_color)
+{
+    mycss_values_color_t *value = declr->value;
+    
+    if(declr->value_type != MyCSS_PROPERTY_VALUE__COLOR || value == NULL) {
+        *color = *initial_color;
+        return;
+    }
+    
+    switch (value->type) {
+        case MyCSS_VALUES_COLOR_TYPE_HEX:
+            color->r = (unsigned char)value->value.hex.r.value.i;
+            color->g = (unsigned char)value->value.hex.g.value.i;
+            color->b = (unsigned char)value->value.hex.b.value.i;
+            
+            /* 0..255 */
+            if(value->value.hex.alpha.type_value == MyCSS_VALUES_COLOR_TYPE_VALUE_NUMBER)
+                color->a = (unsigned char)value->value.hex.alpha.value.number.value.i;
+            else
+                color->a = 255;
+            
+            break;
+            
+        case MyCSS_VALUES_COLOR_TYPE_RGB:
+        case MyCSS_VALUES_COLOR_TYPE_RGBA:
+            if(value->type_value == MyCSS_VALUES_COLOR_TYPE_VALUE_PERCENTAGE) {
+                color->r = modest_style_computed_color_channel(modest_style_computed_number(&value->value.rgba_percentage.r) * 2.55f);
+                color->g = modest_style_computed_color_channel(modest_style_computed_number(&value->value.rgba_percentage.g) * 2.55f);
+                color->b = modest_style_computed_color_channel(modest_style_computed_number(&value->value.rgba_percentage.b) * 2.55f);
+                color->a = modest_style_computed_color_alpha(&value->value.rgba_percentage.alpha);
+            }
+            else {
+                color->r = modest_style_computed_color_channel(modest_style_computed_number(&value->value.rgba_number.r));
+                color->g = modest_style_computed_color_channel(modest_style_computed_number(&value->value.rgba_number.g));
+                color->b = modest_style_computed_color_channel(modest_style_computed_number(&value->value.rgba_number.b));
+                color->a = modest_style_computed_color_alpha(&value->value.rgba_number.alpha);
+            }
+            
+            break;
+            
+        case MyCSS_VALUES_COLOR_TYPE_HSL:
+        case MyCSS_VALUES_COLOR_TYPE_HSLA:
+            modest_style_computed_color_hsl(&value->value.hsla, color);
+            break;
+            
+        case MyCSS_VALUES_COLOR_TYPE_GRAY:
+            color->r = modest_style_computed_color_channel(modest_style_computed_number(&value->value.gray.number));
+            color->g = color->r;
+            color->b = color->r;
+            color->a = modest_style_computed_color_alpha(&value->value.gray.alpha);
+            break;
+            
+        case MyCSS_VALUES_COLOR_TYPE_NAMED:
+        {
+            if(value->value.name_id == MyCSS_VALUES_COLOR_ID_CURRENTCOLOR) {
+                *color = *parent_color;
+                break;
+            }
+            
+            if(value->value.name_id == MyCSS_VALUES_COLOR_ID_TRANSPARENT) {
+                memset(color, 0, sizeof(modest_style_type_color_t));
+                break;
+            }
+            
+            size_t length;
+            const char *name = mycss_values_color_name_by_id(value->value.name_id, &length);
+            const mycss_values_color_index_static_entry_t *entry = (name ? mycss_values_color_index_entry_by_name(name, length) : NULL);
+            
+            if(entry == NULL) {
+                *color = *initial_color;
+                break;
+            }
+            
+            color->r = (unsigned char)((entry->rgb >> 16) & 0xff);
+            color->g = (unsigned char)((entry->rgb >> 8) & 0xff);
+            color->b = (unsigned char)(entry->rgb & 0xff);
+            color->a = 255;
+            
+            break;
+        }
+            
+        /* hwb, device-cmyk, color-mod */
+        default:
+            *color = *initial_color;
+            break;
+    }
+}
+
+static float modest_style_computed_font_size_keyword(unsigned int value_type, float parent_font_size)
+{
+    switch (value_type) {
+        case MyCSS_PROPERTY_FONT_SIZE_XX_SMALL:
+            return 9.0f;
+        case MyCSS_PROPERTY_FONT_SIZE_X_SMALL:
+            return 10.0f;
+        case MyCSS_PROPERTY_FONT_SIZE_SMALL:
+            return 13.0f;
+        case MyCSS_PROPERTY_FONT_SIZE_LARGE:
+            return 18.0f;
+        case MyCSS_PROPERTY_FONT_SIZE_X_LARGE:
+            return 24.0f;
+        case MyCSS_PROPERTY_FONT_SIZE_XX_LARGE:
+            return 32.0f;
+        case MyCSS_PROPERTY_FONT_SIZE_LARGER:
+            return parent_font_size * 1.2f;
+        case MyCSS_PROPERTY_FONT_SIZE_SMALLER:
+            return parent_font_size / 1.2f;
+        default:
+            return MODEST_STYLE_COMPUTED_FONT_SIZE_MEDIUM;
+    }
+}
+
+static void modest_style_computed_font_size(modest_style_computed_t* computed, myhtml_tree_node_t* node,
+                                            modest_style_sheet_t* sheet, modest_style_sheet_t* parent)
+{
+    mycss_declaration_entry_t *declr = modest_style_computed_cascade(computed, node, MyCSS_PROPERTY_TYPE_FONT_SIZE, true,
+                                                                     &sheet->font_size, &parent->font_size,
+                                                                     &computed->initial.font_size, sizeof(modest_style_type_length_t));
+    if(declr == NULL)
+        return;
+    
+    float parent_font_size = parent->font_size.value;
+    
+    if(declr->value_type == MyCSS_PROPERTY_VALUE__LENGTH && declr->value) {
+        /* em of font size is font size of parent */
+        sheet->font_size.value = modest_style_computed_length_px(computed, declr->value, parent_font_size);
+    }
+    else if(declr->value_type == MyCSS_PROPERTY_VALUE__PERCENTAGE && declr->value) {
+        sheet->font_size.value = parent_font_size * modest_style_computed_number((mycss_values_percentage_t*)declr->value) / 100.0f;
+    }
+    else
+        sheet->font_size.value = modest_style_computed_font_size_keyword(declr->value_type, parent_font_size);
+    
+    sheet->font_size.type = MyCSS_PROPERTY_VALUE__LENGTH;
+}
+
+static void modest_style_computed_font_weight(modest_style_computed_t* computed, myhtml_tree_node_t* node,
+                                              modest_style_sheet_t* sheet, modest_style_sheet_t* parent)
+{
+    mycss_declaration_entry_t *declr = modest_style_computed_cascade(computed, node, MyCSS_PROPERTY_TYPE_FONT_WEIGHT, true,
+                                                                     &sheet->font_weight, &parent->font_weight,
+                                                                     &computed->initial.font_weight, sizeof(modest_style_type_font_weight_t));
+    if(declr == NULL)
+        return;
+    
+    unsigned int parent_weight = parent->font_weight.value;
+    
+    switch (declr->value_type) {
+        case MyCSS_PROPERTY_FONT_WEIGHT_100: sheet->font_weight.value = 100; break;
+        case MyCSS_PROPERTY_FONT_WEIGHT_200: sheet->font_weight.value = 200; break;
+        case MyCSS_PROPERTY_FONT_WEIGHT_300: sheet->font_weight.value = 300; break;
+        case MyCSS_PROPERTY_FONT_WEIGHT_500: sheet->font_weight.value = 500; break;
+        case MyCSS_PROPERTY_FONT_WEIGHT_600: sheet->font_weight.value = 600; break;
+        case MyCSS_PROPERTY_FONT_WEIGHT_700:
+        case MyCSS_PROPERTY_FONT_WEIGHT_BOLD:
+            sheet->font_weight.value = 700;
+            break;
+        case MyCSS_PROPERTY_FONT_WEIGHT_800: sheet->font_weight.value = 800; break;
+        case MyCSS_PROPERTY_FONT_WEIGHT_900: sheet->font_weight.value = 900; break;
+            
+        /* see table of css-fonts for bolder and lighter */
+        case MyCSS_PROPERTY_FONT_WEIGHT_BOLDER:
+            if(parent_weight < 350)
+                sheet->font_weight.value = 400;
+            else if(parent_weight < 550)
+                sheet->font_weight.value = 700;
+            else
+                sheet->font_weight.value = 900;
+            break;
+            
+        case MyCSS_PROPERTY_FONT_WEIGHT_LIGHTER:
+            if(parent_weight < 100)
+                sheet->font_weight.value = parent_weight;
+            else if(parent_weight < 550)
+                sheet->font_weight.value = 100;
+            else if(parent_weight < 750)
+                sheet->font_weight.value = 400;
+            else
+                sheet->font_weight.value = 700;
+            break;
+            
+        /* 400, normal */
+        default:
+            sheet->font_weight.value = 400;
+            break;
+    }
+}
+
+static void modest_style_computed_node_resolve(modest_style_computed_t* computed, myhtml_tree_node_t* node,
+                                               modest_style_sheet_t* sheet, modest_style_sheet_t* parent)
+{
+    modest_style_sheet_t *initial = &computed->initial;
+    mycss_declaration_entry_t *declr;
+    
+    /* inherited, font size before lengths by em */
+    modest_style_computed_font_size(computed, node, sheet, parent);
+    modest_style_computed_font_weight(computed, node, sheet, parent);
+    
+    float font_size = sheet->font_size.value;
+    
+    declr = modest_style_computed_cascade(computed, node, MyCSS_PROPERTY_TYPE_FONT_STYLE, true, &sheet->font_style,
+                                          &parent->font_style, &initial->font_style, sizeof(modest_style_type_font_style_t));
+    if(declr)
+        sheet->font_style.value = declr->value_type;
+    
+    declr = modest_style_computed_cascade(computed, node, MyCSS_PROPERTY_TYPE_LINE_HEIGHT, true, &sheet->line_height,
+                                          &parent->line_height, &initial->line_height, sizeof(modest_style_type_length_t));
+    if(declr) {
+        modest_style_computed_length(computed, declr, &sheet->line_height, font_size);
+        
+        /* percentage is computed by font size, number is inherited as is */
+        if(sheet->line_height.type == MyCSS_PROPERTY_VALUE__PERCENTAGE) {
+            sheet->line_height.value = font_size * sheet->line_height.value / 100.0f;
+            sheet->line_height.type  = MyCSS_PROPERTY_VALUE__LENGTH;
+        }
+    }
+    
+    declr = modest_style_computed_cascade(computed, node, MyCSS_PROPERTY_TYPE_COLOR, true, &sheet->color,
+                                          &parent->color, &initial->color, sizeof(modest_style_type_color_t));
+    if(declr)
+        modest_style_computed_color(declr, &sheet->color, &parent->color, &initial->color);
+    
+    /* not inherited */
+    declr = modest_style_computed_cascade(computed, node, MyCSS_PROPERTY_TYPE_DISPLAY, false, &sheet->display,
+                                          &parent->display, &initial->display, sizeof(modest_style_type_display_t));
+    if(declr)
+        sheet->display.value = declr->value_type;
+    
+    modest_style_computed_length_by_type(computed, node, MyCSS_PROPERTY_TYPE_WIDTH, &sheet->width, &parent->width, &initial->width, font_size);
+    modest_style_computed_length_by_type(computed, node, MyCSS_PROPERTY_TYPE_HEIGHT, &sheet->height, &parent->height, &initial->height, font_size);
+    
+    modest_style_computed_length_by_type(computed, node, MyCSS_PROPERTY_TYPE_PADDING_TOP, &sheet->padding_top, &parent->padding_top, &initial->padding_top, font_size);
+    modest_style_computed_length_by_type(computed, node, MyCSS_PROPERTY_TYPE_PADDING_RIGHT, &sheet->padding_right, &parent->padding_right, &initial->padding_right, font_size);
+    modest_style_computed_length_by_type(computed, node, MyCSS_PROPERTY_TYPE_PADDING_BOTTOM, &sheet->padding_bottom, &parent->padding_bottom, &initial->padding_bottom, font_size);
+    modest_style_computed_length_by_type(computed, node, MyCSS_PROPERTY_TYPE_PADDING_LEFT, &sheet->padding_left, &parent->padding_left, &initial->padding_left, font_size);
+    
+    modest_style_computed_length_by_type(computed, node, MyCSS_PROPERTY_TYPE_MARGIN_TOP, &sheet->margin_top, &parent->margin_top, &initial->margin_top, font_size);
+    modest_style_computed_length_by_type(computed, node, MyCSS_PROPERTY_TYPE_MARGIN_RIGHT, &sheet->margin_right, &parent->margin_right, &initial->margin_right, font_size);
+    modest_style_computed_length_by_type(computed, node, MyCSS_PROPERTY_TYPE_MARGIN_BOTTOM, &sheet->margin_bottom, &parent->margin_bottom, &initial->margin_bottom, font_size);
+    modest_style_computed_length_by_type(computed, node, MyCSS_PROPERTY_TYPE_MARGIN_LEFT, &sheet->margin_left, &parent->margin_left, &initial->margin_left, font_size);
+    
+    modest_style_computed_border_width(computed, node, MyCSS_PROPERTY_TYPE_BORDER_TOP_WIDTH, MyCSS_PROPERTY_TYPE_BORDER_TOP_STYLE,
+                                       &sheet->border_top_width, &parent->border_top_width, &initial->border_top_width, font_size);
+    modest_style_computed_border_width(computed, node, MyCSS_PROPERTY_TYPE_BORDER_RIGHT_WIDTH, MyCSS_PROPERTY_TYPE_BORDER_RIGHT_STYLE,
+                                       &sheet->border_right_width, &parent->border_right_width, &initial->border_right_width, font_size);
+    modest_style_computed_border_width(computed, node, MyCSS_PROPERTY_TYPE_BORDER_BOTTOM_WIDTH, MyCSS_PROPERTY_TYPE_BORDER_BOTTOM_STYLE,
+                                       &sheet->border_bottom_width, &parent->border_bottom_width, &initial->border_bottom_width, font_size);
+    modest_style_computed_border_width(computed, node, MyCSS_PROPERTY_TYPE_BORDER_LEFT_WIDTH, MyCSS_PROPERTY_TYPE_BORDER_LEFT_STYLE,
+                                       &sheet->border_left_width, &parent->border_left_width, &initial->border_left_width, font_size);
+}
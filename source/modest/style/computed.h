@@ -0,0 +1,99 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#ifndef MODEST_STYLE_COMPUTED_H
+#define MODEST_STYLE_COMPUTED_H
+#pragma once
+
+#include "modest/myosi.h"
+#include "modest/modest.h"
+#include "modest/node/node.h"
+#include "modest/style/sheet.h"
+#include "modest/style/type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* recently computed nodes checked for style sharing */
+#define MODEST_STYLE_COMPUTED_SHARE_SIZE 16
+
+#define MODEST_STYLE_COMPUTED_FONT_SIZE_MEDIUM 16.0f
+#define MODEST_STYLE_COMPUTED_VIEWPORT_WIDTH   1024.0f
+#define MODEST_STYLE_COMPUTED_VIEWPORT_HEIGHT  768.0f
+
+struct modest_style_computed_share {
+    myhtml_tree_node_t* node;
+    
+    /* of cascaded declarations of node */
+    size_t hash;
+    size_t count;
+}
+typedef modest_style_computed_share_t;
+
+/*
+ * One walk over the tree: for every node with modest node the values of properties
+ * are taken from cascaded declaration, from default of html node, from parent (inherited properties)
+ * or initial and resolved into typed fields of modest_style_sheet_t (lengths in px).
+ *
+ * A node with the same tag, the same cascaded declarations and the same stylesheet of parent
+ * as one of recently computed nodes gets the stylesheet of this node, so modest_node_t->stylesheet
+ * may be shared and must not be changed.
+ */
+struct modest_style_computed {
+    modest_t* modest;
+    
+    /* initial values and stylesheet for nodes without parent */
+    modest_style_sheet_t initial;
+    
+    float viewport_width;
+    float viewport_height;
+    float root_font_size;
+    
+    /* style sharing; on by default */
+    bool share;
+    
+    modest_style_computed_share_t share_list[MODEST_STYLE_COMPUTED_SHARE_SIZE];
+    size_t share_length;
+    size_t share_index;
+    
+    /* statistics of last process */
+    size_t sheet_count;
+    size_t shared_count;
+};
+
+modest_style_computed_t * modest_style_computed_create(void);
+mystatus_t modest_style_computed_init(modest_style_computed_t* computed, modest_t* modest);
+void modest_style_computed_clean(modest_style_computed_t* computed);
+modest_style_computed_t * modest_style_computed_destroy(modest_style_computed_t* computed, bool self_destroy);
+
+/*
+ * Call after cascade (modest_finder_thread_process*).
+ * Every call creates new stylesheets, old ones are freed with modest_clean.
+ */
+mystatus_t modest_style_computed_process(modest_style_computed_t* computed, myhtml_tree_node_t* scope_node);
+
+modest_style_sheet_t * modest_style_computed_by_node(myhtml_tree_node_t* node);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* MODEST_STYLE_COMPUTED_H */
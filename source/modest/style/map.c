@@ -20,170 +20,174 @@
 
 #include "modest/style/map.h"
 #include "modest/style/map_resource.h"
+#include "mycss/declaration/default.h"
 
-void modest_style_map_collate_declaration(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl, mycss_property_type_t type, modest_style_raw_specificity_t* spec)
+mystatus_t modest_style_map_collate_declaration(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl, mycss_property_type_t type, modest_style_raw_specificity_t* spec)
 {
     if(type < MyCSS_PROPERTY_TYPE_LAST_ENTRY)
-        modest_style_map_static_collate_declaration[ type ](modest, node, decl, type, spec);
+        return modest_style_map_static_collate_declaration[ type ](modest, node, decl, type, spec);
+    
+    return MODEST_STATUS_OK;
 }
 
-void modest_style_map_collate_declaration_undef(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl, mycss_property_type_t type, modest_style_raw_specificity_t* spec)
+mystatus_t modest_style_map_collate_declaration_undef(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl, mycss_property_type_t type, modest_style_raw_specificity_t* spec)
 {
-    
+    return MODEST_STATUS_OK;
 }
 
-void modest_style_map_collate_declaration_for_all(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl, mycss_property_type_t type, modest_style_raw_specificity_t* spec)
+mystatus_t modest_style_map_collate_declaration_for_all(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl, mycss_property_type_t type, modest_style_raw_specificity_t* spec)
 {
     if(node->data == NULL)
-        return;
+        return MODEST_STATUS_OK;
     
     modest_node_t *m_node = (modest_node_t*)node->data;
     modest_style_raw_declaration_t *raw_declr = modest_node_raw_declaration_by_type(modest, m_node, type);
     
     if(raw_declr == NULL) {
         raw_declr = modest_style_raw_declaration_create(modest);
-        modest_node_raw_declaration_set_by_type(modest, m_node, type, raw_declr);
+        
+        if(raw_declr == NULL)
+            return MODEST_STATUS_ERROR_MEMORY_ALLOCATION;
+        
+        mystatus_t status = modest_node_raw_declaration_set_by_type(modest, m_node, type, raw_declr);
+        
+        if(status) {
+            mcobject_free(modest->mraw_style_declaration_obj, raw_declr);
+            return status;
+        }
     }
     
     if(modest_finder_thread_spec_is_up(spec, &raw_declr->spec)) {
         raw_declr->declaration = decl;
         raw_declr->spec = *spec;
     }
+    
+    return MODEST_STATUS_OK;
 }
 
-void modest_style_map_collate_declaration_padding(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl, mycss_property_type_t type, modest_style_raw_specificity_t* spec)
+/* one to four values of shorthand for top, right, bottom and left */
+static mystatus_t modest_style_map_collate_declaration_four(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl,
+                                                            const mycss_property_type_t types[4], modest_style_raw_specificity_t* spec)
 {
     if(node->data == NULL || decl->value == NULL)
-        return;
+        return MODEST_STATUS_OK;
     
     mycss_values_shorthand_four_t *val_four = (mycss_values_shorthand_four_t*)decl->value;
+    mycss_declaration_entry_t *values[4] = {val_four->one, val_four->one, val_four->one, val_four->one};
     
-    if(val_four->two == NULL) {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_PADDING_TOP, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_PADDING_RIGHT, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_PADDING_BOTTOM, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_PADDING_LEFT, spec);
-    }
-    else if(val_four->three == NULL) {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_PADDING_TOP, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_PADDING_RIGHT, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_PADDING_BOTTOM, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_PADDING_LEFT, spec);
-    }
-    else if(val_four->four == NULL) {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_PADDING_TOP, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_PADDING_RIGHT, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->three, MyCSS_PROPERTY_TYPE_PADDING_BOTTOM, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_PADDING_LEFT, spec);
+    if(val_four->two) {
+        values[1] = values[3] = val_four->two;
+        
+        if(val_four->three) {
+            values[2] = val_four->three;
+            
+            if(val_four->four)
+                values[3] = val_four->four;
+        }
     }
-    else {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_PADDING_TOP, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_PADDING_RIGHT, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->three, MyCSS_PROPERTY_TYPE_PADDING_BOTTOM, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->four, MyCSS_PROPERTY_TYPE_PADDING_LEFT, spec);
+    
+    for(size_t i = 0; i < 4; i++) {
+        mystatus_t status = modest_style_map_collate_declaration_for_all(modest, node, values[i], types[i], spec);
+        
+        if(status)
+            return status;
     }
+    
+    return MODEST_STATUS_OK;
 }
 
-/* margin */
-void modest_style_map_collate_declaration_margin(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl, mycss_property_type_t type, modest_style_raw_specificity_t* spec)
+/* padding */
+mystatus_t modest_style_map_collate_declaration_padding(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl, mycss_property_type_t type, modest_style_raw_specificity_t* spec)
 {
-    if(node->data == NULL || decl->value == NULL)
-        return;
+    static const mycss_property_type_t types[4] = {
+        MyCSS_PROPERTY_TYPE_PADDING_TOP, MyCSS_PROPERTY_TYPE_PADDING_RIGHT,
+        MyCSS_PROPERTY_TYPE_PADDING_BOTTOM, MyCSS_PROPERTY_TYPE_PADDING_LEFT
+    };
     
-    mycss_values_shorthand_four_t *val_four = (mycss_values_shorthand_four_t*)decl->value;
+    return modest_style_map_collate_declaration_four(modest, node, decl, types, spec);
+}
+
+/* margin */
+mystatus_t modest_style_map_collate_declaration_margin(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl, mycss_property_type_t type, modest_style_raw_specificity_t* spec)
+{
+    static const mycss_property_type_t types[4] = {
+        MyCSS_PROPERTY_TYPE_MARGIN_TOP, MyCSS_PROPERTY_TYPE_MARGIN_RIGHT,
+        MyCSS_PROPERTY_TYPE_MARGIN_BOTTOM, MyCSS_PROPERTY_TYPE_MARGIN_LEFT
+    };
     
-    if(val_four->two == NULL) {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_MARGIN_LEFT, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_MARGIN_RIGHT, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_MARGIN_BOTTOM, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_MARGIN_LEFT, spec);
-    }
-    else if(val_four->three == NULL) {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_MARGIN_LEFT, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_MARGIN_RIGHT, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_MARGIN_BOTTOM, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_MARGIN_LEFT, spec);
-    }
-    else if(val_four->four == NULL) {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_MARGIN_LEFT, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_MARGIN_RIGHT, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->three, MyCSS_PROPERTY_TYPE_MARGIN_BOTTOM, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_MARGIN_LEFT, spec);
-    }
-    else {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_MARGIN_LEFT, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_MARGIN_RIGHT, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->three, MyCSS_PROPERTY_TYPE_MARGIN_BOTTOM, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->four, MyCSS_PROPERTY_TYPE_MARGIN_LEFT, spec);
-    }
+    return modest_style_map_collate_declaration_four(modest, node, decl, types, spec);
 }
 
 /* border width */
-void modest_style_map_collate_declaration_border_width(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl, mycss_property_type_t type, modest_style_raw_specificity_t* spec)
+mystatus_t modest_style_map_collate_declaration_border_width(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl, mycss_property_type_t type, modest_style_raw_specificity_t* spec)
 {
-    if(node->data == NULL || decl->value == NULL)
-        return;
+    static const mycss_property_type_t types[4] = {
+        MyCSS_PROPERTY_TYPE_BORDER_TOP_WIDTH, MyCSS_PROPERTY_TYPE_BORDER_RIGHT_WIDTH,
+        MyCSS_PROPERTY_TYPE_BORDER_BOTTOM_WIDTH, MyCSS_PROPERTY_TYPE_BORDER_LEFT_WIDTH
+    };
     
-    mycss_values_shorthand_four_t *val_four = (mycss_values_shorthand_four_t*)decl->value;
-    
-    if(val_four->two == NULL) {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_TOP_WIDTH, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_RIGHT_WIDTH, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_BOTTOM_WIDTH, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_LEFT_WIDTH, spec);
-    }
-    else if(val_four->three == NULL) {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_TOP_WIDTH, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_BORDER_RIGHT_WIDTH, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_BOTTOM_WIDTH, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_BORDER_LEFT_WIDTH, spec);
-    }
-    else if(val_four->four == NULL) {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_TOP_WIDTH, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_BORDER_RIGHT_WIDTH, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->three, MyCSS_PROPERTY_TYPE_BORDER_BOTTOM_WIDTH, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_BORDER_LEFT_WIDTH, spec);
-    }
-    else {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_TOP_WIDTH, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_BORDER_RIGHT_WIDTH, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->three, MyCSS_PROPERTY_TYPE_BORDER_BOTTOM_WIDTH, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->four, MyCSS_PROPERTY_TYPE_BORDER_LEFT_WIDTH, spec);
-    }
+    return modest_style_map_collate_declaration_four(modest, node, decl, types, spec);
 }
 
 /* border style */
-void modest_style_map_collate_declaration_border_style(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl, mycss_property_type_t type, modest_style_raw_specificity_t* spec)
+mystatus_t modest_style_map_collate_declaration_border_style(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl, mycss_property_type_t type, modest_style_raw_specificity_t* spec)
 {
-    if(node->data == NULL || decl->value == NULL)
-        return;
+    static const mycss_property_type_t types[4] = {
+        MyCSS_PROPERTY_TYPE_BORDER_TOP_STYLE, MyCSS_PROPERTY_TYPE_BORDER_RIGHT_STYLE,
+        MyCSS_PROPERTY_TYPE_BORDER_BOTTOM_STYLE, MyCSS_PROPERTY_TYPE_BORDER_LEFT_STYLE
+    };
     
-    mycss_values_shorthand_four_t *val_four = (mycss_values_shorthand_four_t*)decl->value;
+    return modest_style_map_collate_declaration_four(modest, node, decl, types, spec);
+}
+
+/* font */
+mystatus_t modest_style_map_collate_declaration_font(modest_t* modest, myhtml_tree_node_t* node, mycss_declaration_entry_t* decl, mycss_property_type_t type, modest_style_raw_specificity_t* spec)
+{
+    static const mycss_property_type_t types[6] = {
+        MyCSS_PROPERTY_TYPE_FONT_STYLE, MyCSS_PROPERTY_TYPE_FONT_WEIGHT, MyCSS_PROPERTY_TYPE_FONT_STRETCH,
+        MyCSS_PROPERTY_TYPE_FONT_SIZE, MyCSS_PROPERTY_TYPE_LINE_HEIGHT, MyCSS_PROPERTY_TYPE_FONT_FAMILY
+    };
     
-    if(val_four->two == NULL) {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_TOP_STYLE, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_RIGHT_STYLE, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_BOTTOM_STYLE, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_LEFT_STYLE, spec);
-    }
-    else if(val_four->three == NULL) {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_TOP_STYLE, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_BORDER_RIGHT_STYLE, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_BOTTOM_STYLE, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_BORDER_LEFT_STYLE, spec);
-    }
-    else if(val_four->four == NULL) {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_TOP_STYLE, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_BORDER_RIGHT_STYLE, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->three, MyCSS_PROPERTY_TYPE_BORDER_BOTTOM_STYLE, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_BORDER_LEFT_STYLE, spec);
+    if(node->data == NULL)
+        return MODEST_STATUS_OK;
+    
+    mycss_declaration_entry_t *values[6] = {decl, decl, decl, decl, decl, decl};
+    
+    switch (decl->value_type) {
+        case MyCSS_PROPERTY_VALUE_INHERIT:
+        case MyCSS_PROPERTY_VALUE_INITIAL:
+        case MyCSS_PROPERTY_VALUE_UNSET:
+            break;
+            
+        default: {
+            mycss_values_font_t *font = (mycss_values_font_t*)decl->value;
+            
+            /* system fonts (caption, icon...) are not supported */
+            if(font == NULL || font->size == NULL)
+                return MODEST_STATUS_OK;
+            
+            /* omitted values of shorthand are reset to initial */
+            values[0] = (font->style ? font->style : mycss_declaration_default_by_type(MyCSS_PROPERTY_TYPE_FONT_STYLE));
+            values[1] = (font->weight ? font->weight : mycss_declaration_default_by_type(MyCSS_PROPERTY_TYPE_FONT_WEIGHT));
+            values[2] = (font->stretch ? font->stretch : mycss_declaration_default_by_type(MyCSS_PROPERTY_TYPE_FONT_STRETCH));
+            values[3] = font->size;
+            values[4] = (font->line_height ? font->line_height : mycss_declaration_default_by_type(MyCSS_PROPERTY_TYPE_LINE_HEIGHT));
+            values[5] = font->family;
+            
+            break;
+        }
     }
-    else {
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->one, MyCSS_PROPERTY_TYPE_BORDER_TOP_STYLE, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->two, MyCSS_PROPERTY_TYPE_BORDER_RIGHT_STYLE, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->three, MyCSS_PROPERTY_TYPE_BORDER_BOTTOM_STYLE, spec);
-        modest_style_map_collate_declaration_for_all(modest, node, val_four->four, MyCSS_PROPERTY_TYPE_BORDER_LEFT_STYLE, spec);
+    
+    for(size_t i = 0; i < 6; i++) {
+        if(values[i] == NULL)
+            continue;
+        
+        mystatus_t status = modest_style_map_collate_declaration_for_all(modest, node, values[i], types[i], spec);
+        
+        if(status)
+            return status;
     }
+    
+    return MODEST_STATUS_OK;
 }
 
-
@@ -32,4 +32,27 @@ modest_style_raw_declaration_t * modest_style_raw_declaration_create(modest_t* m
     return raw_decl;
 }
 
+static unsigned long long modest_style_raw_cascade_spec(unsigned int value)
+{
+    return (value > MODEST_STYLE_RAW_CASCADE_SPEC_MAX ? MODEST_STYLE_RAW_CASCADE_SPEC_MAX : value);
+}
+
+/* specificity and order, without origin and importance */
+unsigned long long modest_style_raw_cascade_key(unsigned int a, unsigned int b, unsigned int c, size_t order)
+{
+    unsigned long long key = (modest_style_raw_cascade_spec(a) << 16) | (modest_style_raw_cascade_spec(b) << 8) | modest_style_raw_cascade_spec(c);
+    
+    if(order > MODEST_STYLE_RAW_CASCADE_ORDER_MAX)
+        order = MODEST_STYLE_RAW_CASCADE_ORDER_MAX;
+    
+    return (key << MODEST_STYLE_RAW_CASCADE_ORDER_BITS) | (unsigned long long)order;
+}
 
+unsigned long long modest_style_raw_cascade_key_declaration(unsigned long long key, modest_style_raw_origin_t origin, bool is_important)
+{
+    if(is_important)
+        return key | MODEST_STYLE_RAW_CASCADE_IMPORTANT |
+            ((unsigned long long)(MODEST_STYLE_RAW_ORIGIN_AUTHOR - origin) << MODEST_STYLE_RAW_CASCADE_ORIGIN_SHIFT);
+    
+    return key | ((unsigned long long)origin << MODEST_STYLE_RAW_CASCADE_ORIGIN_SHIFT);
+}
@@ -116,6 +116,9 @@ enum mycore_status {
     MyCORE_STATUS_ASYNC_ERROR_LOCK                     = 0x0060,
     MyCORE_STATUS_ASYNC_ERROR_UNLOCK                   = 0x0061,
     MyCORE_STATUS_ERROR_NO_FREE_SLOT                   = 0x0062,
+    MyCORE_STATUS_ERROR_MEMORY_LIMIT                   = 0x0063,
+    MyCORE_STATUS_ERROR_FILE_OPEN                      = 0x0064,
+    MyCORE_STATUS_ERROR_FILE_MAP                       = 0x0065,
 }
 typedef mycore_status_t;
 
@@ -143,11 +146,20 @@ typedef struct mycore_incoming_buffer mycore_incoming_buffer_t;
 /* callbacks */
 typedef mystatus_t (*mycore_callback_serialize_f)(const char* buffer, size_t size, void* ctx);
 
+/* memory */
+typedef void * (*mycore_malloc_f)(size_t size);
+typedef void * (*mycore_realloc_f)(void* dst, size_t size);
+typedef void * (*mycore_calloc_f)(size_t num, size_t size);
+typedef void (*mycore_free_f)(void* dst);
+
 void * mycore_malloc(size_t size);
 void * mycore_realloc(void* dst, size_t size);
 void * mycore_calloc(size_t num, size_t size);
 void * mycore_free(void* dst);
 
+/* set before any object is created; NULL in any of them returns to malloc, realloc, calloc and free */
+void mycore_memory_set(mycore_malloc_f malloc_f, mycore_realloc_f realloc_f, mycore_calloc_f calloc_f, mycore_free_f free_f);
+
 /* io */
 FILE * mycore_fopen(const char *filename, const char *mode);
 int mycore_fclose(FILE *stream);
@@ -161,6 +173,12 @@ int mycore_ferror(FILE *stream);
     
 void mycore_setbuf(FILE *stream, char *buffer);
 
+/* read only mapping of whole file for sequential reading; data is NULL for empty file */
+mystatus_t mycore_file_map(const char* filename, const char** data, size_t* size);
+/* private writable mapping, changes are copied on write and never reach the file */
+mystatus_t mycore_file_map_copy(const char* filename, char** data, size_t* size);
+void mycore_file_unmap(const char* data, size_t size);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -47,6 +47,12 @@ mystatus_t mythread_init(mythread_t *mythread, mythread_type_t type, size_t thre
     
     mythread->timespec = mythread_nanosleep_create(mythread);
     
+    mythread->cond = mythread_cond_create(mythread);
+    if(mythread->cond == NULL)
+        return MyCORE_STATUS_THREAD_ERROR_SEM_CREATE;
+    
+    mythread->cond_shared = false;
+    
     return MyCORE_STATUS_OK;
 }
 
@@ -72,6 +78,11 @@ mythread_t * mythread_destroy(mythread_t *mythread, mythread_callback_before_ent
     mythread_thread_attr_destroy(mythread, mythread->attr);
     mythread_nanosleep_destroy(mythread->timespec);
     
+    if(mythread->cond_shared == false)
+        mythread_cond_close(mythread, mythread->cond);
+    
+    mythread->cond = NULL;
+    
     if(self_destroy) {
         mycore_free(mythread);
         return NULL;
@@ -123,6 +134,21 @@ mythread_id_t myhread_increase_id_by_entry_id(mythread_t* mythread, mythread_id_
     return mythread->id_increase + thread_id;
 }
 
+void mythread_cond_share(mythread_t *mythread, mythread_t *owner)
+{
+    if(mythread->cond_shared == false)
+        mythread_cond_close(mythread, mythread->cond);
+    
+    mythread->cond        = owner->cond;
+    mythread->cond_shared = true;
+}
+
+void mythread_notify(mythread_t *mythread)
+{
+    if(mythread && mythread->cond)
+        mythread_cond_notify(mythread, mythread->cond);
+}
+
 /*
  * Global functions, for all threads
  */
@@ -167,9 +193,8 @@ mystatus_t mythread_stop(mythread_t *mythread)
     
     for (size_t i = 0; i < mythread->entries_length; i++)
     {
-        while((mythread->entries[i].context.opt & MyTHREAD_OPT_STOP) == 0) {
-            mythread_nanosleep_sleep(mythread->timespec);
-        }
+        mythread_cond_wait_while(mythread, mythread->cond,
+                                 (mythread->entries[i].context.opt & MyTHREAD_OPT_STOP) == 0);
     }
     
     return MyCORE_STATUS_OK;
@@ -184,11 +209,9 @@ mystatus_t mythread_suspend(mythread_t *mythread)
     
     for (size_t i = 0; i < mythread->entries_length; i++)
     {
-        while((mythread->entries[i].context.opt & MyTHREAD_OPT_STOP) == 0 &&
-              (mythread->entries[i].context.opt & MyTHREAD_OPT_WAIT) == 0)
-        {
-            mythread_nanosleep_sleep(mythread->timespec);
-        }
+        mythread_cond_wait_while(mythread, mythread->cond,
+                                 (mythread->entries[i].context.opt & MyTHREAD_OPT_STOP) == 0 &&
+                                 (mythread->entries[i].context.opt & MyTHREAD_OPT_WAIT) == 0);
     }
     
     return MyCORE_STATUS_OK;
@@ -235,6 +258,7 @@ mythread_thread_opt_t mythread_option(mythread_t *mythread)
 void mythread_option_set(mythread_t *mythread, mythread_thread_opt_t opt)
 {
     mythread->opt = opt;
+    mythread_notify(mythread);
 }
 
 /*
@@ -271,10 +295,10 @@ mystatus_t mythread_entry_stop(mythread_entry_t* entry)
         return MyCORE_STATUS_OK;
     
     entry->context.opt = MyTHREAD_OPT_STOP;
+    mythread_notify(entry->context.mythread);
     
-    while((entry->context.opt & MyTHREAD_OPT_STOP) == 0) {
-        mythread_nanosleep_sleep(entry->context.mythread->timespec);
-    }
+    mythread_cond_wait_while(entry->context.mythread, entry->context.mythread->cond,
+                             (entry->context.opt & MyTHREAD_OPT_STOP) == 0);
     
     return MyCORE_STATUS_OK;
 }
@@ -285,10 +309,10 @@ mystatus_t mythread_entry_suspend(mythread_entry_t* entry)
         return MyCORE_STATUS_OK;
     
     entry->context.opt = MyTHREAD_OPT_WAIT;
+    mythread_notify(entry->context.mythread);
     
-    while((entry->context.opt & MyTHREAD_OPT_STOP) == 0 && (entry->context.opt & MyTHREAD_OPT_WAIT) == 0) {
-        mythread_nanosleep_sleep(entry->context.mythread->timespec);
-    }
+    mythread_cond_wait_while(entry->context.mythread, entry->context.mythread->cond,
+                             (entry->context.opt & MyTHREAD_OPT_STOP) == 0 && (entry->context.opt & MyTHREAD_OPT_WAIT) == 0);
     
     return MyCORE_STATUS_OK;
 }
@@ -307,6 +331,8 @@ mystatus_t mythread_entry_resume(mythread_entry_t* entry, mythread_thread_opt_t
     else
         entry->context.opt = send_opt;
     
+    mythread_notify(entry->context.mythread);
+    
     return MyCORE_STATUS_OK;
 }
 
@@ -323,8 +349,7 @@ mythread_t * mythread_entry_mythread(mythread_entry_t* entry)
 /* Callbacks */
 void mythread_callback_quit(mythread_t* mythread, mythread_entry_t* entry, void* ctx)
 {
-    while((entry->context.opt & MyTHREAD_OPT_QUIT) == 0)
-        mythread_nanosleep_sleep(mythread->timespec);
+    mythread_cond_wait_while(mythread, mythread->cond, (entry->context.opt & MyTHREAD_OPT_QUIT) == 0);
 }
 
 #endif
@@ -91,6 +91,8 @@ struct mythread {
     void* context;
     void* attr;
     void* timespec;
+    void* cond;
+    bool  cond_shared;
     
     int sys_last_error;
     
@@ -105,6 +107,21 @@ mythread_t * mythread_destroy(mythread_t *mythread, mythread_callback_before_ent
 
 mythread_id_t myhread_increase_id_by_entry_id(mythread_t* mythread, mythread_id_t thread_id);
 
+/* wait/notify; owner must outlive mythread */
+void mythread_cond_share(mythread_t *mythread, mythread_t *owner);
+void mythread_notify(mythread_t *mythread);
+
+/* block while expr is true; expr must be changed only before notify of cond */
+#define mythread_cond_wait_while(mythread, cond, expr)                              \
+    while(expr) {                                                                   \
+        size_t mythread_cond_ticket = mythread_cond_prepare(mythread, cond);        \
+                                                                                    \
+        if(expr)                                                                    \
+            mythread_cond_wait(mythread, cond, mythread_cond_ticket);               \
+        else                                                                        \
+            mythread_cond_cancel(mythread, cond);                                   \
+    }
+
 /* set for all threads */
 mystatus_t mythread_join(mythread_t *mythread, mythread_callback_before_entry_join_f before_join, void* ctx);
 mystatus_t mythread_quit(mythread_t *mythread, mythread_callback_before_entry_join_f before_join, void* ctx);
@@ -142,11 +159,21 @@ mystatus_t mythread_mutex_post(mythread_t *mythread, void* mutex);
 mystatus_t mythread_mutex_wait(mythread_t *mythread, void* mutex);
 void mythread_mutex_close(mythread_t *mythread, void* mutex);
 
+void * mythread_cond_create(mythread_t *mythread);
+size_t mythread_cond_prepare(mythread_t *mythread, void* cond);
+mystatus_t mythread_cond_wait(mythread_t *mythread, void* cond, size_t ticket);
+void mythread_cond_cancel(mythread_t *mythread, void* cond);
+mystatus_t mythread_cond_notify(mythread_t *mythread, void* cond);
+void mythread_cond_close(mythread_t *mythread, void* cond);
+
 void * mythread_nanosleep_create(mythread_t* mythread);
 void mythread_nanosleep_clean(void* timespec);
 void mythread_nanosleep_destroy(void* timespec);
 mystatus_t mythread_nanosleep_sleep(void* timespec);
 
+/* online processors, 1 if unknown */
+size_t mythread_cpu_count(void);
+
 /* callback */
 void mythread_callback_quit(mythread_t* mythread, mythread_entry_t* entry, void* ctx);
 
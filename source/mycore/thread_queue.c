@@ -222,14 +222,18 @@ mythread_queue_node_t * mythread_queue_node_malloc_round(mythread_t *mythread, m
         queue->nodes_uses++;
         
 #ifndef MyCORE_BUILD_WITHOUT_THREADS
-        if(mythread)
+        if(mythread) {
+            mythread_notify(mythread);
             mythread_queue_list_entry_wait_for_done(mythread, entry);
+        }
 #endif
         
         mythread_queue_list_entry_clean(entry);
     }
-    else
+    else {
         queue->nodes_uses++;
+        mythread_notify(mythread);
+    }
     
     return &queue->nodes[queue->nodes_pos][queue->nodes_length];
 }
@@ -241,7 +245,30 @@ mythread_queue_node_t * mythread_queue_node_malloc_round(mythread_t *mythread, m
  */
 mythread_queue_list_t * mythread_queue_list_create(mystatus_t *status)
 {
-    return (mythread_queue_list_t*)mycore_calloc(1, sizeof(mythread_queue_list_t));
+    if(status)
+        *status = MyCORE_STATUS_OK;
+    
+    mythread_queue_list_t* queue_list = (mythread_queue_list_t*)mycore_calloc(1, sizeof(mythread_queue_list_t));
+    
+    if(queue_list == NULL) {
+        if(status)
+            *status = MyCORE_STATUS_THREAD_ERROR_QUEUE_MALLOC;
+        
+        return NULL;
+    }
+    
+    queue_list->cond = mythread_cond_create(NULL);
+    
+    if(queue_list->cond == NULL) {
+        mycore_free(queue_list);
+        
+        if(status)
+            *status = MyCORE_STATUS_THREAD_ERROR_SEM_CREATE;
+        
+        return NULL;
+    }
+    
+    return queue_list;
 }
 
 void mythread_queue_list_destroy(mythread_queue_list_t* queue_list)
@@ -249,6 +276,7 @@ void mythread_queue_list_destroy(mythread_queue_list_t* queue_list)
     if(queue_list == NULL)
         return;
     
+    mythread_cond_close(NULL, queue_list->cond);
     mycore_free(queue_list);
 }
 
@@ -267,14 +295,20 @@ void mythread_queue_list_wait_for_done(mythread_t* mythread, mythread_queue_list
     while(entry)
     {
         for (size_t i = 0; i < mythread->entries_length; i++) {
-            while(entry->thread_param[i].use < entry->queue->nodes_uses)
-                mythread_nanosleep_sleep(mythread->timespec);
+            mythread_cond_wait_while(mythread, queue_list->cond,
+                                     entry->thread_param[i].use < entry->queue->nodes_uses);
         }
         
         entry = entry->next;
     }
 }
 
+void mythread_queue_list_notify_done(mythread_t* mythread, mythread_queue_list_t* queue_list)
+{
+    if(queue_list)
+        mythread_cond_notify(mythread, queue_list->cond);
+}
+
 bool mythread_queue_list_see_for_done(mythread_t* mythread, mythread_queue_list_t* queue_list)
 {
     if(queue_list == NULL)
@@ -352,13 +386,15 @@ mythread_queue_list_entry_t * mythread_queue_list_entry_push(mythread_t** mythre
     entry->queue = queue;
     
     for(size_t i = 0; i < list_size; i++) {
+        if(mythread_list[i] == NULL)
+            continue;
+        
         if(mythread_list[i]->type == MyTHREAD_TYPE_BATCH)
             mythread_queue_list_entry_make_batch(mythread_list[i], entry);
         else
             mythread_queue_list_entry_make_stream(mythread_list[i], entry);
         
-        if(mythread_list[i])
-            mythread_suspend(mythread_list[i]);
+        mythread_suspend(mythread_list[i]);
     }
     
     if(queue_list->first) {
@@ -432,9 +468,11 @@ void mythread_queue_list_entry_wait_for_done(mythread_t* mythread, mythread_queu
     if(entry == NULL)
         return;
     
+    mythread_queue_list_t *queue_list = (mythread_queue_list_t*)mythread->context;
+    
     for(size_t i = 0; i < entry->thread_param_size; i++) {
-        while(entry->thread_param[i].use < entry->queue->nodes_uses)
-            mythread_nanosleep_sleep(mythread->timespec);
+        mythread_cond_wait_while(mythread, queue_list->cond,
+                                 entry->thread_param[i].use < entry->queue->nodes_uses);
     }
 }
 
@@ -453,7 +491,7 @@ bool mythread_queue_list_entry_see_for_done(mythread_queue_list_entry_t *entry)
 
 void mythread_queue_list_entry_make_batch(mythread_t* mythread, mythread_queue_list_entry_t* entry)
 {
-    if(entry == NULL)
+    if(entry == NULL || mythread == NULL)
         return;
     
     size_t i = 0;
@@ -465,7 +503,7 @@ void mythread_queue_list_entry_make_batch(mythread_t* mythread, mythread_queue_l
 
 void mythread_queue_list_entry_make_stream(mythread_t* mythread, mythread_queue_list_entry_t* entry)
 {
-    if(entry == NULL)
+    if(entry == NULL || mythread == NULL)
         return;
     
     for(size_t from = mythread->id_increase; from <= mythread->entries_length; from++) {
@@ -489,6 +527,8 @@ bool mythread_function_see_opt(mythread_context_t *ctx, volatile mythread_thread
         if(mythread_queue_list_see_for_done_by_thread(mythread, queue_list, thread_id))
         {
             ctx->opt = MyTHREAD_OPT_STOP;
+            mythread_notify(mythread);
+            
             mythread_mutex_wait(mythread, ctx->mutex);
             ctx->opt = MyTHREAD_OPT_UNDEF;
             
@@ -503,11 +543,16 @@ bool mythread_function_see_opt(mythread_context_t *ctx, volatile mythread_thread
             mythread_nanosleep_destroy(ctx->timespec);
             
             ctx->opt = MyTHREAD_OPT_QUIT;
+            mythread_notify(mythread);
+            
             return true;
         }
     }
     
-    mythread_nanosleep_sleep(timeout);
+    /* nothing to do, sleep until new queue node or new option */
+    mythread_cond_wait_while(mythread, mythread->cond,
+                             mythread->opt == opt && done_count == queue_list->count &&
+                             mythread_queue_list_see_for_done_by_thread(mythread, queue_list, thread_id));
     
     return false;
 }
@@ -524,9 +569,9 @@ void * mythread_function_queue_batch(void *arg)
     do {
         if(mythread->opt & MyTHREAD_OPT_WAIT) {
             ctx->opt = MyTHREAD_OPT_WAIT;
+            mythread_notify(mythread);
             
-            while (mythread->opt & MyTHREAD_OPT_WAIT)
-                mythread_nanosleep_sleep(ctx->timespec);
+            mythread_cond_wait_while(mythread, mythread->cond, mythread->opt & MyTHREAD_OPT_WAIT);
             
             ctx->opt = MyTHREAD_OPT_UNDEF;
         }
@@ -549,6 +594,7 @@ void * mythread_function_queue_batch(void *arg)
                 ctx->func(ctx->id, (void*)qnode);
                 
                 thread_param->use += mythread->entries_length;
+                mythread_queue_list_notify_done(mythread, queue_list);
             }
             else
                 done_count++;
@@ -579,10 +625,9 @@ void * mythread_function_queue_stream(void *arg)
     do {
         if(mythread->opt & MyTHREAD_OPT_WAIT) {
             ctx->opt = MyTHREAD_OPT_WAIT;
+            mythread_notify(mythread);
             
-            while (mythread->opt & MyTHREAD_OPT_WAIT) {
-                mythread_nanosleep_sleep(ctx->timespec);
-            }
+            mythread_cond_wait_while(mythread, mythread->cond, mythread->opt & MyTHREAD_OPT_WAIT);
             
             ctx->opt = MyTHREAD_OPT_UNDEF;
         }
@@ -605,6 +650,7 @@ void * mythread_function_queue_stream(void *arg)
                 ctx->func(ctx->id, (void*)qnode);
                 
                 thread_param->use++;
+                mythread_queue_list_notify_done(mythread, queue_list);
             }
             else
                 done_count++;
@@ -633,15 +679,17 @@ void * mythread_function(void *arg)
     do {
         ctx->func(ctx->id, ctx);
         
-        ctx->opt |= MyTHREAD_OPT_DONE;
-        
         if(ctx->opt & MyTHREAD_OPT_WAIT) {
-            while (ctx->opt & MyTHREAD_OPT_WAIT) {
-                mythread_nanosleep_sleep(ctx->timespec);
-            }
+            ctx->opt |= MyTHREAD_OPT_DONE;
+            mythread_notify(mythread);
+            
+            mythread_cond_wait_while(mythread, mythread->cond, ctx->opt & MyTHREAD_OPT_WAIT);
         }
         else {
-            ctx->opt |= MyTHREAD_OPT_STOP;
+            /* DONE and STOP together, resume must see STOP before anyone sees DONE */
+            ctx->opt |= (MyTHREAD_OPT_DONE|MyTHREAD_OPT_STOP);
+            mythread_notify(mythread);
+            
             mythread_mutex_wait(mythread, ctx->mutex);
         }
         
@@ -651,6 +699,8 @@ void * mythread_function(void *arg)
             mythread_nanosleep_destroy(ctx->timespec);
             
             ctx->opt = MyTHREAD_OPT_QUIT;
+            mythread_notify(mythread);
+            
             break;
         }
         
@@ -55,6 +55,9 @@ struct mythread_queue_list {
     mythread_queue_list_entry_t *last;
     
     volatile size_t count;
+    
+    /* notified when any thread finished a queue node */
+    void* cond;
 };
 
 struct mythread_queue {
@@ -93,6 +96,7 @@ void mythread_queue_list_destroy(mythread_queue_list_t* queue_list);
 size_t mythread_queue_list_get_count(mythread_queue_list_t* queue_list);
 
 void mythread_queue_list_wait_for_done(mythread_t* mythread, mythread_queue_list_t* queue_list);
+void mythread_queue_list_notify_done(mythread_t* mythread, mythread_queue_list_t* queue_list);
 bool mythread_queue_list_see_for_done(mythread_t* mythread, mythread_queue_list_t* queue_list);
 bool mythread_queue_list_see_for_done_by_thread(mythread_t* mythread, mythread_queue_list_t* queue_list, mythread_id_t thread_id);
 
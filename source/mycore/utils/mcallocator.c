@@ -0,0 +1,229 @@
+/*
+ Copyright (C) 2015-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#include "mycore/utils/mcallocator.h"
+
+static void * mcallocator_default_malloc(size_t size, void* ctx)
+{
+    return mycore_malloc(size);
+}
+
+static void * mcallocator_default_realloc(void* dst, size_t size, void* ctx)
+{
+    return mycore_realloc(dst, size);
+}
+
+static void mcallocator_default_free(void* dst, void* ctx)
+{
+    mycore_free(dst);
+}
+
+mcallocator_t * mcallocator_create(void)
+{
+    return (mcallocator_t*)mycore_calloc(1, sizeof(mcallocator_t));
+}
+
+mystatus_t mcallocator_init(mcallocator_t* allocator, mcallocator_malloc_f malloc_f,
+                            mcallocator_realloc_f realloc_f, mcallocator_free_f free_f, void* ctx)
+{
+    if(malloc_f == NULL && realloc_f == NULL && free_f == NULL) {
+        malloc_f  = mcallocator_default_malloc;
+        realloc_f = mcallocator_default_realloc;
+        free_f    = mcallocator_default_free;
+    }
+    else if(malloc_f == NULL || realloc_f == NULL || free_f == NULL)
+        return MyCORE_STATUS_ERROR;
+    
+    allocator->malloc  = malloc_f;
+    allocator->realloc = realloc_f;
+    allocator->free    = free_f;
+    allocator->ctx     = ctx;
+    
+    allocator->bytes      = 0;
+    allocator->bytes_peak = 0;
+    allocator->limit      = 0;
+    
+    return MyCORE_STATUS_OK;
+}
+
+void mcallocator_clean(mcallocator_t* allocator)
+{
+    allocator->bytes_peak = mcallocator_bytes(allocator);
+}
+
+mcallocator_t * mcallocator_destroy(mcallocator_t* allocator, bool self_destroy)
+{
+    if(allocator == NULL)
+        return NULL;
+    
+    if(self_destroy) {
+        mycore_free(allocator);
+        return NULL;
+    }
+    
+    return allocator;
+}
+
+static void mcallocator_bytes_add(mcallocator_t* allocator, size_t add)
+{
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    size_t bytes = mcsync_atomic_fetch_add(&allocator->bytes, add) + add;
+    size_t peak = mcsync_atomic_load(&allocator->bytes_peak);
+    
+    while(bytes > peak) {
+        if(mcsync_atomic_compare_exchange(&allocator->bytes_peak, peak, bytes))
+            break;
+        
+        peak = mcsync_atomic_load(&allocator->bytes_peak);
+    }
+#else
+    allocator->bytes += add;
+    
+    if(allocator->bytes > allocator->bytes_peak)
+        allocator->bytes_peak = allocator->bytes;
+#endif
+}
+
+static void mcallocator_bytes_sub(mcallocator_t* allocator, size_t sub)
+{
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    mcsync_atomic_fetch_add(&allocator->bytes, (0 - sub));
+#else
+    allocator->bytes -= sub;
+#endif
+}
+
+void * mcallocator_malloc(mcallocator_t* allocator, size_t size)
+{
+    if(allocator == NULL)
+        return mycore_malloc(size);
+    
+    if(size > (SIZE_MAX - MCALLOCATOR_HEADER_SIZE))
+        return NULL;
+    
+    unsigned char *data = (unsigned char*)allocator->malloc((size + MCALLOCATOR_HEADER_SIZE), allocator->ctx);
+    
+    if(data == NULL)
+        return NULL;
+    
+    memcpy(data, &size, sizeof(size_t));
+    mcallocator_bytes_add(allocator, size);
+    
+    return &data[MCALLOCATOR_HEADER_SIZE];
+}
+
+void * mcallocator_realloc(mcallocator_t* allocator, void* dst, size_t size)
+{
+    if(allocator == NULL)
+        return mycore_realloc(dst, size);
+    
+    if(dst == NULL)
+        return mcallocator_malloc(allocator, size);
+    
+    if(size > (SIZE_MAX - MCALLOCATOR_HEADER_SIZE))
+        return NULL;
+    
+    unsigned char *data = ((unsigned char*)dst - MCALLOCATOR_HEADER_SIZE);
+    
+    size_t old_size;
+    memcpy(&old_size, data, sizeof(size_t));
+    
+    data = (unsigned char*)allocator->realloc(data, (size + MCALLOCATOR_HEADER_SIZE), allocator->ctx);
+    
+    if(data == NULL)
+        return NULL;
+    
+    memcpy(data, &size, sizeof(size_t));
+    
+    if(size > old_size)
+        mcallocator_bytes_add(allocator, (size - old_size));
+    else
+        mcallocator_bytes_sub(allocator, (old_size - size));
+    
+    return &data[MCALLOCATOR_HEADER_SIZE];
+}
+
+void * mcallocator_calloc(mcallocator_t* allocator, size_t num, size_t size)
+{
+    if(allocator == NULL)
+        return mycore_calloc(num, size);
+    
+    if(size && num > (SIZE_MAX / size))
+        return NULL;
+    
+    void *data = mcallocator_malloc(allocator, (num * size));
+    
+    if(data)
+        memset(data, 0, (num * size));
+    
+    return data;
+}
+
+void * mcallocator_free(mcallocator_t* allocator, void* dst)
+{
+    if(allocator == NULL)
+        return mycore_free(dst);
+    
+    if(dst == NULL)
+        return NULL;
+    
+    unsigned char *data = ((unsigned char*)dst - MCALLOCATOR_HEADER_SIZE);
+    
+    size_t size;
+    memcpy(&size, data, sizeof(size_t));
+    
+    mcallocator_bytes_sub(allocator, size);
+    allocator->free(data, allocator->ctx);
+    
+    return NULL;
+}
+
+size_t mcallocator_bytes(mcallocator_t* allocator)
+{
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    return mcsync_atomic_load(&allocator->bytes);
+#else
+    return allocator->bytes;
+#endif
+}
+
+size_t mcallocator_bytes_peak(mcallocator_t* allocator)
+{
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    return mcsync_atomic_load(&allocator->bytes_peak);
+#else
+    return allocator->bytes_peak;
+#endif
+}
+
+void mcallocator_limit_set(mcallocator_t* allocator, size_t limit)
+{
+    allocator->limit = limit;
+}
+
+size_t mcallocator_limit(mcallocator_t* allocator)
+{
+    return allocator->limit;
+}
+
+bool mcallocator_limit_exceeded(mcallocator_t* allocator)
+{
+    return (allocator->limit && mcallocator_bytes(allocator) > allocator->limit);
+}
@@ -0,0 +1,164 @@
+/*
+ Copyright (C) 2015-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+ */
+
+#include "mycore/utils/mcdeque.h"
+
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+mcdeque_t * mcdeque_create(void)
+{
+    return mycore_calloc(1, sizeof(mcdeque_t));
+}
+
+mystatus_t mcdeque_init(mcdeque_t* deque, size_t size)
+{
+    if(size == 0)
+        size = 1;
+    
+    deque->list = mycore_malloc(sizeof(size_t) * size);
+    
+    if(deque->list == NULL) {
+        deque->size = 0;
+        return MyCORE_STATUS_ERROR_MEMORY_ALLOCATION;
+    }
+    
+    deque->size   = size;
+    deque->top    = 0;
+    deque->bottom = 0;
+    
+    return MyCORE_STATUS_OK;
+}
+
+void mcdeque_clean(mcdeque_t* deque)
+{
+    deque->top    = 0;
+    deque->bottom = 0;
+}
+
+mcdeque_t * mcdeque_destroy(mcdeque_t* deque, bool self_destroy)
+{
+    if(deque == NULL)
+        return NULL;
+    
+    if(deque->list) {
+        mycore_free(deque->list);
+        deque->list = NULL;
+    }
+    
+    deque->size = 0;
+    
+    if(self_destroy) {
+        mycore_free(deque);
+        return NULL;
+    }
+    
+    return deque;
+}
+
+mystatus_t mcdeque_resize(mcdeque_t* deque, size_t size)
+{
+    if(size <= deque->size)
+        return MyCORE_STATUS_OK;
+    
+    size_t* tmp = mycore_realloc(deque->list, sizeof(size_t) * size);
+    
+    if(tmp == NULL)
+        return MyCORE_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    deque->list = tmp;
+    deque->size = size;
+    
+    mcdeque_clean(deque);
+    
+    return MyCORE_STATUS_OK;
+}
+
+bool mcdeque_push(mcdeque_t* deque, size_t value)
+{
+    size_t bottom = mcsync_atomic_load(&deque->bottom);
+    size_t top    = mcsync_atomic_load(&deque->top);
+    
+    /* top may be stale, then we only think that the deque is fuller */
+    if(bottom - top >= deque->size)
+        return false;
+    
+    deque->list[ (bottom % deque->size) ] = value;
+    mcsync_atomic_store(&deque->bottom, (bottom + 1));
+    
+    return true;
+}
+
+bool mcdeque_pop(mcdeque_t* deque, size_t* value)
+{
+    size_t bottom = mcsync_atomic_load(&deque->bottom);
+    
+    /* do not move bottom below zero */
+    if(bottom <= mcsync_atomic_load(&deque->top))
+        return false;
+    
+    bottom--;
+    mcsync_atomic_store(&deque->bottom, bottom);
+    mcsync_atomic_fence();
+    
+    size_t top = mcsync_atomic_load(&deque->top);
+    
+    if(top < bottom) {
+        *value = deque->list[ (bottom % deque->size) ];
+        return true;
+    }
+    
+    bool is_ok = false;
+    
+    /* last one, race with thieves */
+    if(top == bottom) {
+        if(mcsync_atomic_compare_exchange(&deque->top, top, (top + 1))) {
+            *value = deque->list[ (bottom % deque->size) ];
+            is_ok = true;
+        }
+        
+        bottom++;
+    }
+    else {
+        bottom = top;
+    }
+    
+    mcsync_atomic_store(&deque->bottom, bottom);
+    
+    return is_ok;
+}
+
+bool mcdeque_steal(mcdeque_t* deque, size_t* value)
+{
+    for(;;) {
+        size_t top = mcsync_atomic_load(&deque->top);
+        mcsync_atomic_fence();
+        size_t bottom = mcsync_atomic_load(&deque->bottom);
+        
+        if(top >= bottom)
+            return false;
+        
+        size_t res = deque->list[ (top % deque->size) ];
+        
+        if(mcsync_atomic_compare_exchange(&deque->top, top, (top + 1))) {
+            *value = res;
+            return true;
+        }
+    }
+}
+#endif
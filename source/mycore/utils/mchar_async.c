@@ -31,21 +31,22 @@ mystatus_t mchar_async_init(mchar_async_t *mchar_async, size_t chunk_len, size_t
         char_size = 4096;
     
     mchar_async->origin_size      = char_size;
+    mchar_async->arena            = false;
     
     mchar_async->chunks_size      = chunk_len;
     mchar_async->chunks_pos_size  = 1024;
     
     /* Chunck, list of mchar_async_chunk_t* */
-    mchar_async->chunks           = (mchar_async_chunk_t**)mycore_calloc(mchar_async->chunks_pos_size, sizeof(mchar_async_chunk_t*));
+    mchar_async->chunks           = (mchar_async_chunk_t**)mcallocator_calloc(mchar_async->allocator, mchar_async->chunks_pos_size, sizeof(mchar_async_chunk_t*));
     
     if(mchar_async->chunks == NULL)
         return MyCORE_STATUS_ERROR_MEMORY_ALLOCATION;
     
     /* Init first mchar_async_chunk_t* */
-    mchar_async->chunks[0]        = (mchar_async_chunk_t*)mycore_calloc(mchar_async->chunks_size, sizeof(mchar_async_chunk_t));
+    mchar_async->chunks[0]        = (mchar_async_chunk_t*)mcallocator_calloc(mchar_async->allocator, mchar_async->chunks_size, sizeof(mchar_async_chunk_t));
     
     if(mchar_async->chunks[0] == NULL) {
-        mchar_async->chunks = mycore_free(mchar_async->chunks);
+        mchar_async->chunks = mcallocator_free(mchar_async->allocator, mchar_async->chunks);
         return MyCORE_STATUS_ERROR_MEMORY_ALLOCATION;
     }
     
@@ -53,22 +54,22 @@ mystatus_t mchar_async_init(mchar_async_t *mchar_async, size_t chunk_len, size_t
     mystatus_t status = mchar_async_cache_init(&mchar_async->chunk_cache);
     
     if(status) {
-        mycore_free(mchar_async->chunks[0]);
-        mchar_async->chunks = mycore_free(mchar_async->chunks);
+        mcallocator_free(mchar_async->allocator, mchar_async->chunks[0]);
+        mchar_async->chunks = mcallocator_free(mchar_async->allocator, mchar_async->chunks);
         
         return status;
     }
     
     mchar_async->nodes_length     = 0;
     mchar_async->nodes_size       = 64;
-    mchar_async->nodes            = (mchar_async_node_t*)mycore_calloc(mchar_async->nodes_size, sizeof(mchar_async_node_t));
+    mchar_async->nodes            = (mchar_async_node_t*)mcallocator_calloc(mchar_async->allocator, mchar_async->nodes_size, sizeof(mchar_async_node_t));
     
     if(mchar_async->nodes == NULL)
         return status;
     
     mchar_async->nodes_cache_length = 0;
     mchar_async->nodes_cache_size   = mchar_async->nodes_size;
-    mchar_async->nodes_cache        = (size_t*)mycore_malloc(mchar_async->nodes_cache_size * sizeof(size_t));
+    mchar_async->nodes_cache        = (size_t*)mcallocator_malloc(mchar_async->allocator, mchar_async->nodes_cache_size * sizeof(size_t));
     
     if(mchar_async->nodes_cache == NULL)
         return status;
@@ -90,6 +91,8 @@ mystatus_t mchar_async_clean(mchar_async_t *mchar_async)
     mchar_async->chunks_length      = 0;
     mchar_async->chunks_pos_length  = 1;
     
+    mchar_async->chunk_free         = 0;
+    
     mchar_async_cache_clean(&mchar_async->chunk_cache);
     
     for (size_t node_idx = 0; node_idx < mchar_async->nodes_length; node_idx++)
@@ -97,6 +100,8 @@ mystatus_t mchar_async_clean(mchar_async_t *mchar_async)
         mchar_async_node_t *node = &mchar_async->nodes[node_idx];
         mchar_async_cache_clean(&node->cache);
         
+        node->magazine = NULL;
+        
         node->chunk = mchar_async_chunk_malloc(mchar_async, node, mchar_async->origin_size);
         
         if(node->chunk == NULL)
@@ -108,6 +113,17 @@ mystatus_t mchar_async_clean(mchar_async_t *mchar_async)
     return MyCORE_STATUS_OK;
 }
 
+void mchar_async_arena_set(mchar_async_t *mchar_async, bool arena)
+{
+    mchar_async->arena = arena;
+}
+
+/* before init, all memory of mchar_async is freed by the same allocator */
+void mchar_async_allocator_set(mchar_async_t *mchar_async, mcallocator_t *allocator)
+{
+    mchar_async->allocator = allocator;
+}
+
 mchar_async_t * mchar_async_destroy(mchar_async_t *mchar_async, int destroy_self)
 {
     if(mchar_async == NULL)
@@ -121,12 +137,12 @@ mchar_async_t * mchar_async_destroy(mchar_async_t *mchar_async, int destroy_self
             mchar_async_cache_destroy(&node->cache, false);
         }
         
-        mycore_free(mchar_async->nodes);
+        mcallocator_free(mchar_async->allocator, mchar_async->nodes);
         mchar_async->nodes = NULL;
     }
     
     if(mchar_async->nodes_cache) {
-        mycore_free(mchar_async->nodes_cache);
+        mcallocator_free(mchar_async->allocator, mchar_async->nodes_cache);
     }
     
     if(mchar_async->chunks)
@@ -136,14 +152,14 @@ mchar_async_t * mchar_async_destroy(mchar_async_t *mchar_async, int destroy_self
             {
                 for (size_t idx = 0; idx < mchar_async->chunks_size; idx++) {
                     if(mchar_async->chunks[pos_idx][idx].begin)
-                        mycore_free(mchar_async->chunks[pos_idx][idx].begin);
+                        mcallocator_free(mchar_async->allocator, mchar_async->chunks[pos_idx][idx].begin);
                 }
                 
-                mycore_free(mchar_async->chunks[pos_idx]);
+                mcallocator_free(mchar_async->allocator, mchar_async->chunks[pos_idx]);
             }
         }
         
-        mycore_free(mchar_async->chunks);
+        mcallocator_free(mchar_async->allocator, mchar_async->chunks);
         mchar_async->chunks = NULL;
     }
     
@@ -168,10 +184,10 @@ void mchar_async_mem_malloc(mchar_async_t *mchar_async, mchar_async_node_t *node
     
     if(chunk->begin) {
         if(length > chunk->size) {
-            mycore_free(chunk->begin);
+            mcallocator_free(mchar_async->allocator, chunk->begin);
             
             chunk->size = length + mchar_async->origin_size;
-            chunk->begin = (char*)mycore_malloc(chunk->size * sizeof(char));
+            chunk->begin = (char*)mcallocator_malloc(mchar_async->allocator, chunk->size * sizeof(char));
         }
     }
     else {
@@ -180,24 +196,107 @@ void mchar_async_mem_malloc(mchar_async_t *mchar_async, mchar_async_node_t *node
         if(length > chunk->size)
             chunk->size = length;
         
-        chunk->begin = (char*)mycore_malloc(chunk->size * sizeof(char));
+        chunk->begin = (char*)mcallocator_malloc(mchar_async->allocator, chunk->size * sizeof(char));
     }
     
     chunk->length = 0;
 }
 
-mchar_async_chunk_t * mchar_async_chunk_malloc_without_lock(mchar_async_t *mchar_async, mchar_async_node_t *node, size_t length)
+/*
+ * Free chunks are kept in lock-free stack by magazines: up to MCHAR_ASYNC_MAGAZINE_SIZE chunks linked by next,
+ * magazines are linked by prev of their first chunks.
+ */
+static void mchar_async_magazine_push(mchar_async_t *mchar_async, mchar_async_chunk_t *first, mchar_async_chunk_t *last)
+{
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    size_t head;
+    
+    do {
+        head = mcsync_atomic_load(&mchar_async->chunk_free);
+        last->prev = (mchar_async_chunk_t*)head;
+    }
+    while(mcsync_atomic_compare_exchange(&mchar_async->chunk_free, head, (size_t)first) == false);
+#else
+    last->prev = (mchar_async_chunk_t*)mchar_async->chunk_free;
+    mchar_async->chunk_free = (size_t)first;
+#endif
+}
+
+/* all stack is taken by one exchange (pop of one magazine has ABA problem), other magazines are put back */
+static mchar_async_chunk_t * mchar_async_magazine_pop(mchar_async_t *mchar_async)
+{
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    size_t head;
+    
+    do {
+        head = mcsync_atomic_load(&mchar_async->chunk_free);
+        
+        if(head == 0)
+            return NULL;
+    }
+    while(mcsync_atomic_compare_exchange(&mchar_async->chunk_free, head, 0) == false);
+    
+    mchar_async_chunk_t *magazine = (mchar_async_chunk_t*)head;
+    mchar_async_chunk_t *rest = magazine->prev;
+    
+    /* usually nothing is pushed while stack is taken */
+    if(rest && mcsync_atomic_compare_exchange(&mchar_async->chunk_free, 0, (size_t)rest) == false) {
+        mchar_async_chunk_t *last = rest;
+        
+        while(last->prev)
+            last = last->prev;
+        
+        mchar_async_magazine_push(mchar_async, rest, last);
+    }
+#else
+    mchar_async_chunk_t *magazine = (mchar_async_chunk_t*)mchar_async->chunk_free;
+    
+    if(magazine == NULL)
+        return NULL;
+    
+    mchar_async->chunk_free = (size_t)magazine->prev;
+#endif
+    
+    magazine->prev = NULL;
+    
+    return magazine;
+}
+
+/* chunks linked by next are split by magazines and pushed at once */
+static void mchar_async_magazine_push_chunks(mchar_async_t *mchar_async, mchar_async_chunk_t *chunk)
 {
-    if(mchar_async_cache_has_nodes(mchar_async->chunk_cache))
+    mchar_async_chunk_t *first = NULL;
+    mchar_async_chunk_t *last = NULL;
+    
+    while(chunk)
     {
-        size_t index = mchar_async_cache_delete(&mchar_async->chunk_cache, length);
+        mchar_async_chunk_t *magazine = chunk;
         
-        if(index)
-            return (mchar_async_chunk_t*)mchar_async->chunk_cache.nodes[index].value;
+        for(size_t i = 1; i < MCHAR_ASYNC_MAGAZINE_SIZE && chunk->next; i++)
+            chunk = chunk->next;
+        
+        mchar_async_chunk_t *next = chunk->next;
+        chunk->next = NULL;
+        chunk = next;
+        
+        magazine->prev = NULL;
+        
+        if(last)
+            last->prev = magazine;
         else
-            return NULL;
+            first = magazine;
+        
+        last = magazine;
     }
     
+    if(first)
+        mchar_async_magazine_push(mchar_async, first, last);
+}
+
+
+/* new chunk from chunks array, without memory for chars; must be called under lock */
+static mchar_async_chunk_t * mchar_async_chunk_next_without_lock(mchar_async_t *mchar_async)
+{
     if(mchar_async->chunks_length >= mchar_async->chunks_size)
     {
         size_t current_idx = mchar_async->chunks_pos_length;
@@ -206,7 +305,7 @@ mchar_async_chunk_t * mchar_async_chunk_malloc_without_lock(mchar_async_t *mchar
         if(mchar_async->chunks_pos_length >= mchar_async->chunks_pos_size)
         {
             mchar_async->chunks_pos_size <<= 1;
-            mchar_async_chunk_t **tmp_pos = mycore_realloc(mchar_async->chunks,
+            mchar_async_chunk_t **tmp_pos = mcallocator_realloc(mchar_async->allocator, mchar_async->chunks,
                                                       sizeof(mchar_async_chunk_t*) * mchar_async->chunks_pos_size);
             
             if(tmp_pos) {
@@ -220,7 +319,7 @@ mchar_async_chunk_t * mchar_async_chunk_malloc_without_lock(mchar_async_t *mchar
         }
         
         if(mchar_async->chunks[current_idx] == NULL) {
-            mchar_async_chunk_t *tmp = mycore_calloc(mchar_async->chunks_size, sizeof(mchar_async_chunk_t));
+            mchar_async_chunk_t *tmp = mcallocator_calloc(mchar_async->allocator, mchar_async->chunks_size, sizeof(mchar_async_chunk_t));
             
             if(tmp)
                 mchar_async->chunks[current_idx] = tmp;
@@ -234,6 +333,38 @@ mchar_async_chunk_t * mchar_async_chunk_malloc_without_lock(mchar_async_t *mchar
     mchar_async_chunk_t *chunk = &mchar_async->chunks[mchar_async->chunks_pos_length - 1][mchar_async->chunks_length];
     mchar_async->chunks_length++;
     
+    return chunk;
+}
+
+mchar_async_chunk_t * mchar_async_chunk_malloc_without_lock(mchar_async_t *mchar_async, mchar_async_node_t *node, size_t length)
+{
+    mchar_async_chunk_t *chunk = NULL;
+    
+    if(length <= mchar_async->origin_size)
+    {
+        chunk = mchar_async_magazine_pop(mchar_async);
+        
+        if(chunk)
+            mchar_async_magazine_push_chunks(mchar_async, chunk->next);
+    }
+    else if(mchar_async_cache_has_nodes(mchar_async->chunk_cache))
+    {
+        size_t index = mchar_async_cache_delete(&mchar_async->chunk_cache, length);
+        
+        if(index)
+            chunk = (mchar_async_chunk_t*)mchar_async->chunk_cache.nodes[index].value;
+    }
+    
+    if(chunk == NULL) {
+        chunk = mchar_async_chunk_next_without_lock(mchar_async);
+        
+        if(chunk == NULL)
+            return NULL;
+    }
+    
+    chunk->next = NULL;
+    chunk->prev = NULL;
+    
     mchar_async_mem_malloc(mchar_async, node, chunk, length);
     
     if(chunk->begin == NULL)
@@ -242,8 +373,67 @@ mchar_async_chunk_t * mchar_async_chunk_malloc_without_lock(mchar_async_t *mchar
     return chunk;
 }
 
+/*
+ * Chunk of origin size for node from its magazine. Empty magazine is filled by free chunks without lock,
+ * or by new chunks of chunks array with one lock for all of them.
+ */
+static mchar_async_chunk_t * mchar_async_node_chunk_malloc(mchar_async_t *mchar_async, mchar_async_node_t *node)
+{
+    if(node->magazine == NULL)
+    {
+        node->magazine = mchar_async_magazine_pop(mchar_async);
+        
+        if(node->magazine == NULL)
+        {
+            if(mcsync_lock(mchar_async->mcsync))
+                return NULL;
+            
+            mchar_async_chunk_t *last = NULL;
+            
+            for(size_t i = 0; i < MCHAR_ASYNC_MAGAZINE_SIZE; i++) {
+                mchar_async_chunk_t *chunk = mchar_async_chunk_next_without_lock(mchar_async);
+                
+                if(chunk == NULL)
+                    break;
+                
+                if(last)
+                    last->next = chunk;
+                else
+                    node->magazine = chunk;
+                
+                last = chunk;
+            }
+            
+            if(last)
+                last->next = NULL;
+            
+            mcsync_unlock(mchar_async->mcsync);
+            
+            if(node->magazine == NULL)
+                return NULL;
+        }
+    }
+    
+    mchar_async_chunk_t *chunk = node->magazine;
+    node->magazine = chunk->next;
+    
+    chunk->next = NULL;
+    chunk->prev = NULL;
+    
+    /* memory for chars is allocated out of lock */
+    mchar_async_mem_malloc(mchar_async, node, chunk, mchar_async->origin_size);
+    
+    if(chunk->begin == NULL)
+        return NULL;
+    
+    return chunk;
+}
+
 mchar_async_chunk_t * mchar_async_chunk_malloc(mchar_async_t *mchar_async, mchar_async_node_t *node, size_t length)
 {
+    if(node && length <= mchar_async->origin_size)
+        return mchar_async_node_chunk_malloc(mchar_async, node);
+    
     mcsync_lock(mchar_async->mcsync);
     mchar_async_chunk_t *chunk = mchar_async_chunk_malloc_without_lock(mchar_async, node, length);
     mcsync_unlock(mchar_async->mcsync);
@@ -303,6 +493,8 @@ size_t mchar_async_node_add(mchar_async_t *mchar_async, mystatus_t* status)
     node->chunk->next = NULL;
     node->chunk->prev = NULL;
     
+    node->magazine = NULL;
+    
     mcsync_unlock(mchar_async->mcsync);
     
     if(status)
@@ -336,16 +528,36 @@ void mchar_async_node_delete(mchar_async_t *mchar_async, size_t node_idx)
     
     mchar_async_node_t *node = &mchar_async->nodes[node_idx];
     mchar_async_chunk_t *chunk = node->chunk;
+    mchar_async_chunk_t *last = node->chunk;
     
-    while (chunk->next)
-        chunk = chunk->next;
+    while (chunk->prev)
+        chunk = chunk->prev;
+    
+    while (last->next)
+        last = last->next;
+    
+    last->next = node->magazine;
+    
+    /* chunks of origin size go to free magazines, bigger to cache */
+    mchar_async_chunk_t *free_list = NULL;
     
     while (chunk)
     {
-        mchar_async_cache_add(&mchar_async->chunk_cache, (void*)chunk, chunk->size);
-        chunk = chunk->prev;
+        mchar_async_chunk_t *next = chunk->next;
+        
+        if(chunk->size > mchar_async->origin_size) {
+            mchar_async_cache_add(&mchar_async->chunk_cache, (void*)chunk, chunk->size);
+        }
+        else {
+            chunk->next = free_list;
+            free_list = chunk;
+        }
+        
+        chunk = next;
     }
     
+    mchar_async_magazine_push_chunks(mchar_async, free_list);
+    
     if(node->cache.nodes)
         mchar_async_cache_destroy(&node->cache, false);
     
@@ -354,7 +566,7 @@ void mchar_async_node_delete(mchar_async_t *mchar_async, size_t node_idx)
     if(mchar_async->nodes_cache_length >= mchar_async->nodes_cache_size) {
         size_t new_size = mchar_async->nodes_cache_size << 1;
         
-        size_t *tmp = (size_t*)mycore_realloc(mchar_async->nodes_cache, sizeof(size_t) * mchar_async->nodes_cache_size);
+        size_t *tmp = (size_t*)mcallocator_realloc(mchar_async->allocator, mchar_async->nodes_cache, sizeof(size_t) * new_size);
         
         if(tmp) {
             mchar_async->nodes_cache = tmp;
@@ -422,7 +634,8 @@ char * mchar_async_malloc(mchar_async_t *mchar_async, size_t node_idx, size_t si
     
     if(new_size > chunk->size)
     {
-        if((chunk->length + sizeof(size_t)) < chunk->size)
+        /* in arena mode the tail of chunk is just left until clean */
+        if(mchar_async->arena == false && (chunk->length + sizeof(size_t)) < chunk->size)
         {
             size_t calc_size = (chunk->size - chunk->length) - sizeof(size_t);
             
@@ -445,6 +658,9 @@ char * mchar_async_malloc(mchar_async_t *mchar_async, size_t node_idx, size_t si
                 chunk = mchar_async_chunk_malloc(mchar_async, node, (size + sizeof(size_t) + mchar_async->origin_size));
             else
                 chunk = mchar_async_chunk_malloc(mchar_async, node, mchar_async->origin_size);
+            
+            if(chunk == NULL)
+                return NULL;
         }
         
         mchar_sync_chunk_insert_after(node->chunk, chunk);
@@ -500,7 +716,8 @@ char * mchar_async_realloc(mchar_async_t *mchar_async, size_t node_idx, char *da
     if(tmp) {
         memcpy(tmp, data, sizeof(char) * data_len);
         
-        mchar_async_cache_add(&node->cache, data, curr_size);
+        if(mchar_async->arena == false)
+            mchar_async_cache_add(&node->cache, data, curr_size);
     }
     
     return tmp;
@@ -520,7 +737,7 @@ char * mchar_async_crop_first_chars(mchar_async_t *mchar_async, size_t node_idx,
     curr_size -= crop_len;
     memcpy((data - sizeof(size_t)), &curr_size, sizeof(size_t));
     
-    if((crop_len + 4) > sizeof(size_t)) {
+    if(mchar_async->arena == false && (crop_len + 4) > sizeof(size_t)) {
         crop_len = crop_len - sizeof(size_t);
         memcpy((tmp_old - sizeof(size_t)), &crop_len, sizeof(size_t));
         
@@ -557,7 +774,7 @@ size_t mchar_async_get_size_by_data(const char *data)
 
 void mchar_async_free(mchar_async_t *mchar_async, size_t node_idx, char *entry)
 {
-    if(entry)
+    if(entry && mchar_async->arena == false)
         mchar_async_cache_add(&mchar_async->nodes[node_idx].cache, entry, *(size_t*)(entry - sizeof(size_t)));
 }
 
@@ -28,9 +28,13 @@ extern "C" {
 
 #include "mycore/myosi.h"
 #include "mycore/utils/mcsync.h"
+#include "mycore/utils/mcallocator.h"
 
 #define mchar_async_cache_has_nodes(cache) cache.count
 
+/* chunks of origin size taken by a node at once, from free chunks or from chunks array under lock */
+#define MCHAR_ASYNC_MAGAZINE_SIZE 8
+
 typedef struct mchar_async_node mchar_async_node_t;
 
 struct mchar_async_cache_node {
@@ -70,6 +74,9 @@ typedef mchar_async_cache_t;
 struct mchar_async_node {
     mchar_async_chunk_t *chunk;
     mchar_async_cache_t cache;
+    
+    /* chunks reserved by node, linked by next; used without lock */
+    mchar_async_chunk_t *magazine;
 };
 
 struct mchar_async {
@@ -81,8 +88,12 @@ struct mchar_async {
     size_t chunks_size;
     size_t chunks_length;
     
+    /* free chunks bigger than origin size */
     mchar_async_cache_t chunk_cache;
     
+    /* lock-free stack of free chunks (mchar_async_chunk_t*) of origin size, linked by next */
+    volatile size_t chunk_free;
+    
     mchar_async_node_t *nodes;
     size_t nodes_length;
     size_t nodes_size;
@@ -91,6 +102,12 @@ struct mchar_async {
     size_t nodes_cache_length;
     size_t nodes_cache_size;
     
+    /* bump allocation only: free and crop do not fill caches, clean rewinds chunks */
+    bool arena;
+    
+    /* NULL for mycore_malloc */
+    mcallocator_t *allocator;
+    
     mcsync_t *mcsync;
 }
 typedef mchar_async_t;
@@ -100,6 +117,8 @@ mchar_async_t * mchar_async_create(void);
 mystatus_t mchar_async_init(mchar_async_t *mchar_async, size_t chunk_len, size_t char_size);
 mystatus_t mchar_async_clean(mchar_async_t *mchar_async);
 mchar_async_t * mchar_async_destroy(mchar_async_t *mchar_async, int destroy_self);
+void mchar_async_arena_set(mchar_async_t *mchar_async, bool arena);
+void mchar_async_allocator_set(mchar_async_t *mchar_async, mcallocator_t *allocator);
 
 char * mchar_async_malloc(mchar_async_t *mchar_async, size_t node_idx, size_t size);
 char * mchar_async_realloc(mchar_async_t *mchar_async, size_t node_idx, char *data, size_t data_len, size_t new_size);
@@ -34,7 +34,7 @@ mystatus_t mcobject_init(mcobject_t *mcobject, size_t chunk_size, size_t struct_
     
     mcobject->cache_length = 0;
     mcobject->cache_size = chunk_size;
-    mcobject->cache = (void**)mycore_malloc(sizeof(void*) * mcobject->cache_size);
+    mcobject->cache = (void**)mcallocator_malloc(mcobject->allocator, sizeof(void*) * mcobject->cache_size);
     
     if(mcobject->cache == NULL)
         return MyCORE_STATUS_MCOBJECT_ERROR_CACHE_CREATE;
@@ -56,10 +56,10 @@ void mcobject_clean(mcobject_t *mcobject)
         mcobject_chunk_t* tmp = chunk->prev;
         
         if(chunk->begin) {
-            mycore_free(chunk->begin);
+            mcallocator_free(mcobject->allocator, chunk->begin);
         }
         
-        mycore_free(chunk);
+        mcallocator_free(mcobject->allocator, chunk);
         
         chunk = tmp;
     }
@@ -68,6 +68,24 @@ void mcobject_clean(mcobject_t *mcobject)
     mcobject->cache_length = 0;
 }
 
+void mcobject_rewind(mcobject_t *mcobject)
+{
+    if(mcobject->chunk == NULL)
+        return;
+    
+    while(mcobject->chunk->prev)
+        mcobject->chunk = mcobject->chunk->prev;
+    
+    mcobject->chunk->length = 0;
+    mcobject->cache_length = 0;
+}
+
+/* before init, all memory of mcobject is freed by the same allocator */
+void mcobject_allocator_set(mcobject_t *mcobject, mcallocator_t *allocator)
+{
+    mcobject->allocator = allocator;
+}
+
 mcobject_t * mcobject_destroy(mcobject_t *mcobject, bool destroy_self)
 {
     if(mcobject == NULL)
@@ -76,7 +94,7 @@ mcobject_t * mcobject_destroy(mcobject_t *mcobject, bool destroy_self)
     mcobject_clean(mcobject);
     
     if(mcobject->cache) {
-        mycore_free(mcobject->cache);
+        mcallocator_free(mcobject->allocator, mcobject->cache);
         mcobject->cache = NULL;
     }
     
@@ -103,7 +121,7 @@ void mcobject_chunk_malloc(mcobject_t* mcobject, mystatus_t* status)
         return;
     }
     else {
-        chunk = mycore_calloc(1, sizeof(mcobject_chunk_t));
+        chunk = mcallocator_calloc(mcobject->allocator, 1, sizeof(mcobject_chunk_t));
         
         if(chunk == NULL) {
             if(status)
@@ -112,13 +130,13 @@ void mcobject_chunk_malloc(mcobject_t* mcobject, mystatus_t* status)
             return;
         }
         
-        chunk->begin = mycore_malloc(mcobject->struct_size * mcobject->chunk_size);
+        chunk->begin = mcallocator_malloc(mcobject->allocator, mcobject->struct_size * mcobject->chunk_size);
         
         if(chunk->begin == NULL) {
             if(status)
                 *status = MyCORE_STATUS_MCOBJECT_ERROR_CHUNK_INIT;
             
-            mycore_free(chunk);
+            mcallocator_free(mcobject->allocator, chunk);
             return;
         }
         
@@ -175,7 +193,7 @@ mystatus_t mcobject_free(mcobject_t *mcobject, void *entry)
     if(mcobject->cache_length >= mcobject->cache_size) {
         size_t new_size = mcobject->cache_size << 1;
         
-        void **tmp = (void**)mycore_realloc(mcobject->cache, sizeof(void*) * new_size);
+        void **tmp = (void**)mcallocator_realloc(mcobject->allocator, mcobject->cache, sizeof(void*) * new_size);
         
         if(tmp) {
             mcobject->cache = tmp;
@@ -27,6 +27,7 @@ extern "C" {
 #endif
 
 #include "mycore/myosi.h"
+#include "mycore/utils/mcallocator.h"
 
 struct mcobject_chunk {
     unsigned char *begin;
@@ -47,6 +48,9 @@ struct mcobject {
     
     size_t struct_size;
     size_t chunk_size;
+    
+    /* NULL for mycore_malloc */
+    mcallocator_t *allocator;
 }
 typedef mcobject_t;
 
@@ -54,7 +58,9 @@ typedef mcobject_t;
 mcobject_t * mcobject_create(void);
 mystatus_t mcobject_init(mcobject_t *mcobject, size_t chunk_size, size_t struct_size);
 void mcobject_clean(mcobject_t *mcobject);
+void mcobject_rewind(mcobject_t *mcobject);
 mcobject_t * mcobject_destroy(mcobject_t *mcobject, bool destroy_self);
+void mcobject_allocator_set(mcobject_t *mcobject, mcallocator_t *allocator);
 
 void mcobject_chunk_malloc(mcobject_t* mcobject, mystatus_t* status);
 
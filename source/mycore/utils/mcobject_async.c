@@ -30,7 +30,7 @@ mcobject_async_status_t mcobject_async_chunk_up(mcobject_async_t *mcobj_async)
     mcobj_async->chunks_length = 0;
     
     if(mcobj_async->chunks[ mcobj_async->chunks_pos_length ] == NULL) {
-        mcobj_async->chunks[ mcobj_async->chunks_pos_length ] = (mcobject_async_chunk_t*)mycore_calloc(mcobj_async->chunks_size, sizeof(mcobject_async_chunk_t));
+        mcobj_async->chunks[ mcobj_async->chunks_pos_length ] = (mcobject_async_chunk_t*)mcallocator_calloc(mcobj_async->allocator, mcobj_async->chunks_size, sizeof(mcobject_async_chunk_t));
         
         if(mcobj_async->chunks[ mcobj_async->chunks_pos_length ] == NULL)
             return MCOBJECT_ASYNC_STATUS_CHUNK_ERROR_MEMORY_ALLOCATION;
@@ -44,33 +44,28 @@ mcobject_async_status_t mcobject_async_init(mcobject_async_t *mcobj_async, size_
     mcobj_async->origin_size      = obj_size_by_one_chunk;
     mcobj_async->struct_size      = struct_size;
     mcobj_async->struct_size_sn   = struct_size + sizeof(size_t);
+    mcobj_async->arena            = false;
     
     mcobj_async->chunks_pos_length = 0;
     mcobj_async->chunks_pos_size   = 128;
     mcobj_async->chunks_size       = chunk_len;
-    mcobj_async->chunks            = (mcobject_async_chunk_t**)mycore_calloc(mcobj_async->chunks_pos_size, sizeof(mcobject_async_chunk_t*));
+    mcobj_async->chunks            = (mcobject_async_chunk_t**)mcallocator_calloc(mcobj_async->allocator, mcobj_async->chunks_pos_size, sizeof(mcobject_async_chunk_t*));
     
     if(mcobj_async->chunks == NULL)
         return MCOBJECT_ASYNC_STATUS_CHUNK_ERROR_MEMORY_ALLOCATION;
     
     mcobject_async_chunk_up(mcobj_async);
     
-    mcobj_async->chunk_cache_size = mcobj_async->chunks_size;
-    mcobj_async->chunk_cache      = (mcobject_async_chunk_t**)mycore_calloc(mcobj_async->chunk_cache_size, sizeof(mcobject_async_chunk_t*));
-    
-    if(mcobj_async->chunk_cache == NULL)
-        return MCOBJECT_ASYNC_STATUS_CHUNK_CACHE_ERROR_MEMORY_ALLOCATION;
-    
     mcobj_async->nodes_length     = 0;
     mcobj_async->nodes_size       = 64;
-    mcobj_async->nodes            = (mcobject_async_node_t*)mycore_calloc(mcobj_async->nodes_size, sizeof(mcobject_async_node_t));
+    mcobj_async->nodes            = (mcobject_async_node_t*)mcallocator_calloc(mcobj_async->allocator, mcobj_async->nodes_size, sizeof(mcobject_async_node_t));
     
     if(mcobj_async->nodes == NULL)
         return MCOBJECT_ASYNC_STATUS_NODES_ERROR_MEMORY_ALLOCATION;
     
     mcobj_async->nodes_cache_length     = 0;
     mcobj_async->nodes_cache_size       = mcobj_async->nodes_size;
-    mcobj_async->nodes_cache            = (size_t*)mycore_malloc(mcobj_async->nodes_cache_size * sizeof(size_t));
+    mcobj_async->nodes_cache            = (size_t*)mcallocator_malloc(mcobj_async->allocator, mcobj_async->nodes_cache_size * sizeof(size_t));
     
     if(mcobj_async->nodes_cache == NULL)
         return MCOBJECT_ASYNC_STATUS_NODES_ERROR_MEMORY_ALLOCATION;
@@ -95,13 +90,14 @@ void mcobject_async_clean(mcobject_async_t *mcobj_async)
         mcobj_async->chunks_pos_length = 0;
     
     mcobj_async->chunks_length       = 0;
-    mcobj_async->chunk_cache_length  = 0;
+    mcobj_async->chunk_free          = 0;
     
     size_t node_idx;
     for (node_idx = 0; node_idx < mcobj_async->nodes_length; node_idx++)
     {
         mcobject_async_node_t *node = &mcobj_async->nodes[node_idx];
         node->cache_length = 0;
+        node->magazine     = NULL;
         
         if(node->chunk) {
             node->chunk = mcobject_async_chunk_malloc(mcobj_async, mcobj_async->origin_size, NULL);
@@ -109,6 +105,17 @@ void mcobject_async_clean(mcobject_async_t *mcobj_async)
     }
 }
 
+void mcobject_async_arena_set(mcobject_async_t *mcobj_async, bool arena)
+{
+    mcobj_async->arena = arena;
+}
+
+/* before init, all memory of mcobject_async is freed by the same allocator */
+void mcobject_async_allocator_set(mcobject_async_t *mcobj_async, mcallocator_t *allocator)
+{
+    mcobj_async->allocator = allocator;
+}
+
 mcobject_async_t * mcobject_async_destroy(mcobject_async_t *mcobj_async, int destroy_self)
 {
     if(mcobj_async == NULL)
@@ -121,14 +128,14 @@ mcobject_async_t * mcobject_async_destroy(mcobject_async_t *mcobj_async, int des
             mcobject_async_node_t *node = &mcobj_async->nodes[node_idx];
             
             if(node->cache)
-                mycore_free(node->cache);
+                mcallocator_free(mcobj_async->allocator, node->cache);
         }
         
-        mycore_free(mcobj_async->nodes);
+        mcallocator_free(mcobj_async->allocator, mcobj_async->nodes);
     }
     
     if(mcobj_async->nodes_cache) {
-        mycore_free(mcobj_async->nodes_cache);
+        mcallocator_free(mcobj_async->allocator, mcobj_async->nodes_cache);
     }
     
     if(mcobj_async->chunks) {
@@ -137,18 +144,14 @@ mcobject_async_t * mcobject_async_destroy(mcobject_async_t *mcobj_async, int des
             {
                 for (size_t idx = 0; idx < mcobj_async->chunks_size; idx++) {
                     if(mcobj_async->chunks[pos_idx][idx].begin)
-                        mycore_free(mcobj_async->chunks[pos_idx][idx].begin);
+                        mcallocator_free(mcobj_async->allocator, mcobj_async->chunks[pos_idx][idx].begin);
                 }
                 
-                mycore_free(mcobj_async->chunks[pos_idx]);
+                mcallocator_free(mcobj_async->allocator, mcobj_async->chunks[pos_idx]);
             }
         }
         
-        mycore_free(mcobj_async->chunks);
-    }
-    
-    if(mcobj_async->chunk_cache) {
-        mycore_free(mcobj_async->chunk_cache);
+        mcallocator_free(mcobj_async->allocator, mcobj_async->chunks);
     }
     
     mcobj_async->mcsync = mcsync_destroy(mcobj_async->mcsync, 1);
@@ -167,10 +170,10 @@ mcobject_async_status_t mcobject_async_mem_malloc(mcobject_async_t *mcobj_async,
 {
     if(chunk->begin) {
         if(length > chunk->size) {
-            mycore_free(chunk->begin);
+            mcallocator_free(mcobj_async->allocator, chunk->begin);
             
             chunk->size = length + mcobj_async->origin_size;
-            chunk->begin = (unsigned char*)mycore_malloc(chunk->size * mcobj_async->struct_size_sn);
+            chunk->begin = (unsigned char*)mcallocator_malloc(mcobj_async->allocator, chunk->size * mcobj_async->struct_size_sn);
         }
     }
     else {
@@ -179,7 +182,7 @@ mcobject_async_status_t mcobject_async_mem_malloc(mcobject_async_t *mcobj_async,
         if(length > chunk->size)
             chunk->size += length;
         
-        chunk->begin = (unsigned char*)mycore_malloc(chunk->size * mcobj_async->struct_size_sn);
+        chunk->begin = (unsigned char*)mcallocator_malloc(mcobj_async->allocator, chunk->size * mcobj_async->struct_size_sn);
     }
     
     chunk->length = 0;
@@ -190,28 +193,106 @@ mcobject_async_status_t mcobject_async_mem_malloc(mcobject_async_t *mcobj_async,
     return MCOBJECT_ASYNC_STATUS_OK;
 }
 
-mcobject_async_chunk_t * mcobject_async_chunk_malloc_without_lock(mcobject_async_t *mcobj_async, size_t length, mcobject_async_status_t *status)
+/*
+ * Free chunks are kept in lock-free stack by magazines: up to MCOBJECT_ASYNC_MAGAZINE_SIZE chunks linked by next,
+ * magazines are linked by prev of their first chunks.
+ */
+static void mcobject_async_magazine_push(mcobject_async_t *mcobj_async, mcobject_async_chunk_t *first, mcobject_async_chunk_t *last)
 {
-    if(status)
-        *status = MCOBJECT_ASYNC_STATUS_OK;
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    size_t head;
+    
+    do {
+        head = mcsync_atomic_load(&mcobj_async->chunk_free);
+        last->prev = (mcobject_async_chunk_t*)head;
+    }
+    while(mcsync_atomic_compare_exchange(&mcobj_async->chunk_free, head, (size_t)first) == false);
+#else
+    last->prev = (mcobject_async_chunk_t*)mcobj_async->chunk_free;
+    mcobj_async->chunk_free = (size_t)first;
+#endif
+}
+
+/* all stack is taken by one exchange (pop of one magazine has ABA problem), other magazines are put back */
+static mcobject_async_chunk_t * mcobject_async_magazine_pop(mcobject_async_t *mcobj_async)
+{
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    size_t head;
+    
+    do {
+        head = mcsync_atomic_load(&mcobj_async->chunk_free);
+        
+        if(head == 0)
+            return NULL;
+    }
+    while(mcsync_atomic_compare_exchange(&mcobj_async->chunk_free, head, 0) == false);
+    
+    mcobject_async_chunk_t *magazine = (mcobject_async_chunk_t*)head;
+    mcobject_async_chunk_t *rest = magazine->prev;
+    
+    /* usually nothing is pushed while stack is taken */
+    if(rest && mcsync_atomic_compare_exchange(&mcobj_async->chunk_free, 0, (size_t)rest) == false) {
+        mcobject_async_chunk_t *last = rest;
+        
+        while(last->prev)
+            last = last->prev;
+        
+        mcobject_async_magazine_push(mcobj_async, rest, last);
+    }
+#else
+    mcobject_async_chunk_t *magazine = (mcobject_async_chunk_t*)mcobj_async->chunk_free;
+    
+    if(magazine == NULL)
+        return NULL;
     
-    if(mcobj_async->chunk_cache_length)
+    mcobj_async->chunk_free = (size_t)magazine->prev;
+#endif
+    
+    magazine->prev = NULL;
+    
+    return magazine;
+}
+
+/* chunks linked by next are split by magazines and pushed at once */
+static void mcobject_async_magazine_push_chunks(mcobject_async_t *mcobj_async, mcobject_async_chunk_t *chunk)
+{
+    mcobject_async_chunk_t *first = NULL;
+    mcobject_async_chunk_t *last = NULL;
+    
+    while(chunk)
     {
-        mcobj_async->chunk_cache_length--;
+        mcobject_async_chunk_t *magazine = chunk;
+        
+        for(size_t i = 1; i < MCOBJECT_ASYNC_MAGAZINE_SIZE && chunk->next; i++)
+            chunk = chunk->next;
+        
+        mcobject_async_chunk_t *next = chunk->next;
+        chunk->next = NULL;
+        chunk = next;
+        
+        magazine->prev = NULL;
         
-        mcobj_async->chunk_cache[ mcobj_async->chunk_cache_length ]->length = 0;
-        mcobj_async->chunk_cache[ mcobj_async->chunk_cache_length ]->next   = NULL;
-        mcobj_async->chunk_cache[ mcobj_async->chunk_cache_length ]->prev   = NULL;
+        if(last)
+            last->prev = magazine;
+        else
+            first = magazine;
         
-        return mcobj_async->chunk_cache[ mcobj_async->chunk_cache_length ];
+        last = magazine;
     }
     
+    if(first)
+        mcobject_async_magazine_push(mcobj_async, first, last);
+}
+
+/* new chunk from chunks array, without memory for objects; must be called under lock */
+static mcobject_async_chunk_t * mcobject_async_chunk_next_without_lock(mcobject_async_t *mcobj_async, mcobject_async_status_t *status)
+{
     if(mcobj_async->chunks_length >= mcobj_async->chunks_size)
     {
         if(mcobj_async->chunks_pos_length >= mcobj_async->chunks_pos_size)
         {
             size_t tmp_pos_size = mcobj_async->chunks_pos_size << 1;
-            mcobject_async_chunk_t **tmp_pos = mycore_realloc(mcobj_async->chunks,
+            mcobject_async_chunk_t **tmp_pos = mcallocator_realloc(mcobj_async->allocator, mcobj_async->chunks,
                                                       sizeof(mcobject_async_chunk_t*) * tmp_pos_size);
             
             if(tmp_pos)
@@ -246,6 +327,29 @@ mcobject_async_chunk_t * mcobject_async_chunk_malloc_without_lock(mcobject_async
     chunk->next = NULL;
     chunk->prev = NULL;
     
+    return chunk;
+}
+
+mcobject_async_chunk_t * mcobject_async_chunk_malloc_without_lock(mcobject_async_t *mcobj_async, size_t length, mcobject_async_status_t *status)
+{
+    if(status)
+        *status = MCOBJECT_ASYNC_STATUS_OK;
+    
+    mcobject_async_chunk_t* chunk = mcobject_async_magazine_pop(mcobj_async);
+    
+    if(chunk) {
+        mcobject_async_magazine_push_chunks(mcobj_async, chunk->next);
+    }
+    else {
+        chunk = mcobject_async_chunk_next_without_lock(mcobj_async, status);
+        
+        if(chunk == NULL)
+            return NULL;
+    }
+    
+    chunk->next = NULL;
+    chunk->prev = NULL;
+    
     if(status)
         *status = mcobject_async_mem_malloc(mcobj_async, chunk, length);
     else
@@ -269,6 +373,58 @@ mcobject_async_chunk_t * mcobject_async_chunk_malloc(mcobject_async_t *mcobj_asy
     return chunk;
 }
 
+/*
+ * Chunk for node from its magazine. Empty magazine is filled by free chunks without lock,
+ * or by new chunks of chunks array with one lock for all of them.
+ */
+static mcobject_async_chunk_t * mcobject_async_node_chunk_malloc(mcobject_async_t *mcobj_async, mcobject_async_node_t *node, mcobject_async_status_t *status)
+{
+    if(node->magazine == NULL)
+    {
+        node->magazine = mcobject_async_magazine_pop(mcobj_async);
+        
+        if(node->magazine == NULL)
+        {
+            if(mcsync_lock(mcobj_async->mcsync)) {
+                *status = MCOBJECT_ASYNC_STATUS_ERROR_MEMORY_ALLOCATION;
+                return NULL;
+            }
+            
+            mcobject_async_chunk_t *last = NULL;
+            
+            for(size_t i = 0; i < MCOBJECT_ASYNC_MAGAZINE_SIZE; i++) {
+                mcobject_async_chunk_t *chunk = mcobject_async_chunk_next_without_lock(mcobj_async, status);
+                
+                if(chunk == NULL)
+                    break;
+                
+                if(last)
+                    last->next = chunk;
+                else
+                    node->magazine = chunk;
+                
+                last = chunk;
+            }
+            
+            mcsync_unlock(mcobj_async->mcsync);
+            
+            if(node->magazine == NULL)
+                return NULL;
+        }
+    }
+    
+    mcobject_async_chunk_t *chunk = node->magazine;
+    node->magazine = chunk->next;
+    
+    chunk->next = NULL;
+    chunk->prev = NULL;
+    
+    /* memory for objects is allocated out of lock */
+    *status = mcobject_async_mem_malloc(mcobj_async, chunk, mcobj_async->origin_size);
+    
+    return chunk;
+}
+
 size_t mcobject_async_node_add(mcobject_async_t *mcobj_async, mcobject_async_status_t *status)
 {
     mcsync_lock(mcobj_async->mcsync);
@@ -305,9 +461,11 @@ size_t mcobject_async_node_add(mcobject_async_t *mcobj_async, mcobject_async_sta
     node->chunk->next = NULL;
     node->chunk->prev = NULL;
     
+    node->magazine = NULL;
+    
     node->cache_length = 0;
     node->cache_size = mcobj_async->origin_size;
-    node->cache = (void**)mycore_malloc(sizeof(void*) * node->cache_size);
+    node->cache = (void**)mcallocator_malloc(mcobj_async->allocator, sizeof(void*) * node->cache_size);
     
     if(node->cache == NULL) {
         if(status)
@@ -357,45 +515,30 @@ void mcobject_async_node_delete(mcobject_async_t *mcobj_async, size_t node_idx)
     }
     
     mcobject_async_node_t *node = &mcobj_async->nodes[node_idx];
-    mcobject_async_chunk_t *chunk = node->chunk;
     
-    while (chunk->next)
-        chunk = chunk->next;
+    /* chunks of node and its magazine are linked by next already */
+    mcobject_async_chunk_t *first = node->chunk;
+    mcobject_async_chunk_t *last = node->chunk;
     
-    while (chunk)
-    {
-        if(mcobj_async->chunk_cache_length >= mcobj_async->chunk_cache_size) {
-            size_t new_size = mcobj_async->chunk_cache_size << 1;
-            
-            mcobject_async_chunk_t **tmp = (mcobject_async_chunk_t**)mycore_realloc(mcobj_async->chunk_cache,
-                                                                               sizeof(mcobject_async_chunk_t*) * new_size);
-            
-            if(tmp) {
-                mcobj_async->chunk_cache_size = new_size;
-                mcobj_async->chunk_cache = tmp;
-            }
-            else {
-                // TODO: add return status
-                mcsync_unlock(mcobj_async->mcsync);
-                return;
-            }
-        }
-        
-        mcobj_async->chunk_cache[ mcobj_async->chunk_cache_length ] = chunk;
-        mcobj_async->chunk_cache_length++;
-        
-        chunk = chunk->prev;
-    }
+    while (first->prev)
+        first = first->prev;
+    
+    while (last->next)
+        last = last->next;
+    
+    last->next = node->magazine;
+    
+    mcobject_async_magazine_push_chunks(mcobj_async, first);
     
     if(node->cache)
-        mycore_free(node->cache);
+        mcallocator_free(mcobj_async->allocator, node->cache);
     
     memset(node, 0, sizeof(mcobject_async_node_t));
     
     if(mcobj_async->nodes_cache_length >= mcobj_async->nodes_cache_size) {
         size_t new_size = mcobj_async->nodes_cache_size << 1;
         
-        size_t *tmp = (size_t*)mycore_realloc(mcobj_async->nodes_cache, sizeof(size_t) * mcobj_async->nodes_cache_size);
+        size_t *tmp = (size_t*)mcallocator_realloc(mcobj_async->allocator, mcobj_async->nodes_cache, sizeof(size_t) * new_size);
         
         if(tmp) {
             mcobj_async->nodes_cache = tmp;
@@ -429,7 +572,7 @@ void * mcobject_async_malloc(mcobject_async_t *mcobj_async, size_t node_idx, mco
         }
         else {
             mcobject_async_status_t mystatus;
-            mcobject_async_chunk_t *chunk = mcobject_async_chunk_malloc(mcobj_async, mcobj_async->origin_size, &mystatus);
+            mcobject_async_chunk_t *chunk = mcobject_async_node_chunk_malloc(mcobj_async, node, &mystatus);
             
             if(mystatus) {
                 if(status)
@@ -457,6 +600,10 @@ void * mcobject_async_malloc(mcobject_async_t *mcobj_async, size_t node_idx, mco
 
 mcobject_async_status_t mcobject_async_free(mcobject_async_t *mcobj_async, void *entry)
 {
+    /* in arena mode objects live until clean of node */
+    if(mcobj_async->arena)
+        return MCOBJECT_ASYNC_STATUS_OK;
+    
     size_t node_idx = *((size_t*)((unsigned char*)entry - sizeof(size_t)));
     
     if(node_idx >= mcobj_async->nodes_length)
@@ -467,7 +614,7 @@ mcobject_async_status_t mcobject_async_free(mcobject_async_t *mcobj_async, void
     if(node->cache_length >= node->cache_size) {
         size_t new_size = node->cache_size << 1;
         
-        void **tmp = (void**)mycore_realloc(node->cache, sizeof(void*) * new_size);
+        void **tmp = (void**)mcallocator_realloc(mcobj_async->allocator, node->cache, sizeof(void*) * new_size);
         
         if(tmp) {
             node->cache = tmp;
@@ -0,0 +1,379 @@
+/*
+ Copyright (C) 2015-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#include "mycore/utils/mcscan.h"
+#include "mycore/utils/resources.h"
+
+#if !defined(MyCORE_BUILD_WITHOUT_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MyCORE_MCSCAN_AVX2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define MyCORE_MCSCAN_SSE2
+#endif
+#endif
+
+#if !defined(MyCORE_BUILD_WITHOUT_SIMD) && !defined(MyCORE_MCSCAN_AVX2) && !defined(MyCORE_MCSCAN_SSE2)
+#define MyCORE_MCSCAN_WORD
+#include <string.h>
+
+#define MyCORE_MCSCAN_WORD_ONES  0x0101010101010101ULL
+#define MyCORE_MCSCAN_WORD_HIGHS 0x8080808080808080ULL
+
+/* not zero if some byte of word is zero */
+#define mcscan_word_has_zero(word) (((word) - MyCORE_MCSCAN_WORD_ONES) & ~(word) & MyCORE_MCSCAN_WORD_HIGHS)
+#endif
+
+size_t mcscan_char(const char* data, size_t offset, size_t size, unsigned char c)
+{
+#if defined(MyCORE_MCSCAN_AVX2)
+    const __m256i v_c = _mm256_set1_epi8((char)c);
+    
+    while((size - offset) >= 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)&data[offset]);
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, v_c));
+        
+        if(mask)
+            return offset + (size_t)__builtin_ctz(mask);
+        
+        offset += 32;
+    }
+#elif defined(MyCORE_MCSCAN_SSE2)
+    const __m128i v_c = _mm_set1_epi8((char)c);
+    
+    while((size - offset) >= 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)&data[offset]);
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(block, v_c));
+        
+        if(mask)
+            return offset + (size_t)__builtin_ctz(mask);
+        
+        offset += 16;
+    }
+#elif defined(MyCORE_MCSCAN_WORD)
+    const unsigned long long v_c = MyCORE_MCSCAN_WORD_ONES * c;
+    
+    while((size - offset) >= 8) {
+        unsigned long long word;
+        memcpy(&word, &data[offset], sizeof(word));
+        
+        word ^= v_c;
+        
+        /* byte order is not known, the tail loop finds the exact position */
+        if(mcscan_word_has_zero(word))
+            break;
+        
+        offset += 8;
+    }
+#endif
+    
+    while(offset < size) {
+        if((unsigned char)data[offset] == c)
+            break;
+        
+        offset++;
+    }
+    
+    return offset;
+}
+
+size_t mcscan_char2(const char* data, size_t offset, size_t size, unsigned char c1, unsigned char c2)
+{
+#if defined(MyCORE_MCSCAN_AVX2)
+    const __m256i v_c1 = _mm256_set1_epi8((char)c1);
+    const __m256i v_c2 = _mm256_set1_epi8((char)c2);
+    
+    while((size - offset) >= 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)&data[offset]);
+        __m256i found = _mm256_or_si256(_mm256_cmpeq_epi8(block, v_c1), _mm256_cmpeq_epi8(block, v_c2));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(found);
+        
+        if(mask)
+            return offset + (size_t)__builtin_ctz(mask);
+        
+        offset += 32;
+    }
+#elif defined(MyCORE_MCSCAN_SSE2)
+    const __m128i v_c1 = _mm_set1_epi8((char)c1);
+    const __m128i v_c2 = _mm_set1_epi8((char)c2);
+    
+    while((size - offset) >= 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)&data[offset]);
+        __m128i found = _mm_or_si128(_mm_cmpeq_epi8(block, v_c1), _mm_cmpeq_epi8(block, v_c2));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(found);
+        
+        if(mask)
+            return offset + (size_t)__builtin_ctz(mask);
+        
+        offset += 16;
+    }
+#elif defined(MyCORE_MCSCAN_WORD)
+    const unsigned long long v_c1 = MyCORE_MCSCAN_WORD_ONES * c1;
+    const unsigned long long v_c2 = MyCORE_MCSCAN_WORD_ONES * c2;
+    
+    while((size - offset) >= 8) {
+        unsigned long long word;
+        memcpy(&word, &data[offset], sizeof(word));
+        
+        if(mcscan_word_has_zero(word ^ v_c1) || mcscan_word_has_zero(word ^ v_c2))
+            break;
+        
+        offset += 8;
+    }
+#endif
+    
+    while(offset < size) {
+        if((unsigned char)data[offset] == c1 || (unsigned char)data[offset] == c2)
+            break;
+        
+        offset++;
+    }
+    
+    return offset;
+}
+
+size_t mcscan_not_whitespace(const char* data, size_t offset, size_t size)
+{
+#if defined(MyCORE_MCSCAN_AVX2)
+    const __m256i v_space = _mm256_set1_epi8(' ');
+    const __m256i v_tab   = _mm256_set1_epi8('\t');
+    const __m256i v_lf    = _mm256_set1_epi8('\n');
+    const __m256i v_ff    = _mm256_set1_epi8('\f');
+    const __m256i v_cr    = _mm256_set1_epi8('\r');
+    
+    while((size - offset) >= 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)&data[offset]);
+        __m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, v_space), _mm256_cmpeq_epi8(block, v_tab)),
+                                     _mm256_or_si256(_mm256_cmpeq_epi8(block, v_lf), _mm256_cmpeq_epi8(block, v_ff)));
+        ws = _mm256_or_si256(ws, _mm256_cmpeq_epi8(block, v_cr));
+        
+        unsigned int mask = ~((unsigned int)_mm256_movemask_epi8(ws));
+        
+        if(mask)
+            return offset + (size_t)__builtin_ctz(mask);
+        
+        offset += 32;
+    }
+#elif defined(MyCORE_MCSCAN_SSE2)
+    const __m128i v_space = _mm_set1_epi8(' ');
+    const __m128i v_tab   = _mm_set1_epi8('\t');
+    const __m128i v_lf    = _mm_set1_epi8('\n');
+    const __m128i v_ff    = _mm_set1_epi8('\f');
+    const __m128i v_cr    = _mm_set1_epi8('\r');
+    
+    while((size - offset) >= 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)&data[offset]);
+        __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, v_space), _mm_cmpeq_epi8(block, v_tab)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(block, v_lf), _mm_cmpeq_epi8(block, v_ff)));
+        ws = _mm_or_si128(ws, _mm_cmpeq_epi8(block, v_cr));
+        
+        unsigned int mask = (~((unsigned int)_mm_movemask_epi8(ws))) & 0xFFFF;
+        
+        if(mask)
+            return offset + (size_t)__builtin_ctz(mask);
+        
+        offset += 16;
+    }
+#endif
+    
+    while(offset < size) {
+        if(mycore_tokenizer_chars_map[ (unsigned char)data[offset] ] != MyCORE_STRING_MAP_CHAR_WHITESPACE)
+            break;
+        
+        offset++;
+    }
+    
+    return offset;
+}
+
+size_t mcscan_not_ascii(const char* data, size_t offset, size_t size)
+{
+#if defined(MyCORE_MCSCAN_AVX2)
+    while((size - offset) >= 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)&data[offset]);
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(block);
+        
+        if(mask)
+            return offset + (size_t)__builtin_ctz(mask);
+        
+        offset += 32;
+    }
+#elif defined(MyCORE_MCSCAN_SSE2)
+    while((size - offset) >= 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)&data[offset]);
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(block);
+        
+        if(mask)
+            return offset + (size_t)__builtin_ctz(mask);
+        
+        offset += 16;
+    }
+#elif defined(MyCORE_MCSCAN_WORD)
+    while((size - offset) >= 8) {
+        unsigned long long word;
+        memcpy(&word, &data[offset], sizeof(word));
+        
+        if(word & MyCORE_MCSCAN_WORD_HIGHS)
+            break;
+        
+        offset += 8;
+    }
+#endif
+    
+    while(offset < size) {
+        if((unsigned char)data[offset] >= 0x80)
+            break;
+        
+        offset++;
+    }
+    
+    return offset;
+}
+
+#if defined(MyCORE_MCSCAN_AVX2)
+/* x >= c for unsigned bytes */
+#define mcscan_avx2_ge(x, c) _mm256_cmpeq_epi8(_mm256_subs_epu8(_mm256_set1_epi8((char)(c)), (x)), _mm256_setzero_si256())
+
+/* bytes of block moved forward by n (1-3) with zeros in the begin */
+#define mcscan_avx2_prev(x, n) _mm256_alignr_epi8((x), _mm256_permute2x128_si256(_mm256_setzero_si256(), (x), 0x21), (16 - (n)))
+#elif defined(MyCORE_MCSCAN_SSE2)
+#define mcscan_sse2_ge(x, c) _mm_cmpeq_epi8(_mm_subs_epu8(_mm_set1_epi8((char)(c)), (x)), _mm_setzero_si128())
+#endif
+
+size_t mcscan_utf_8(const char* data, size_t offset, size_t size, size_t* count_ascii, size_t* count_multibyte)
+{
+#if defined(MyCORE_MCSCAN_AVX2)
+    const __m256i v_cont_mask = _mm256_set1_epi8((char)0xC0);
+    const __m256i v_cont      = _mm256_set1_epi8((char)0x80);
+    
+    while((size - offset) >= 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)&data[offset]);
+        unsigned int high = (unsigned int)_mm256_movemask_epi8(block);
+        
+        if(high == 0) {
+            *count_ascii += 32;
+            offset += 32;
+            
+            continue;
+        }
+        
+        __m256i lead2 = mcscan_avx2_ge(block, 0xC0);
+        __m256i lead3 = mcscan_avx2_ge(block, 0xE0);
+        __m256i lead4 = mcscan_avx2_ge(block, 0xF0);
+        
+        if(_mm256_movemask_epi8(mcscan_avx2_ge(block, 0xF8)))
+            break;
+        
+        /* continuation bytes must be exactly where leads want them */
+        __m256i cont = _mm256_cmpeq_epi8(_mm256_and_si256(block, v_cont_mask), v_cont);
+        __m256i need = _mm256_or_si256(mcscan_avx2_prev(lead2, 1),
+                                       _mm256_or_si256(mcscan_avx2_prev(lead3, 2), mcscan_avx2_prev(lead4, 3)));
+        
+        if(_mm256_movemask_epi8(_mm256_xor_si256(cont, need)))
+            break;
+        
+        unsigned int leads = (unsigned int)_mm256_movemask_epi8(lead2);
+        
+        /* last character is not finished in block, take the block up to it */
+        size_t length = 32;
+        
+        if(leads & 0x80000000U)
+            length = 31;
+        else if(_mm256_movemask_epi8(lead3) & 0x40000000)
+            length = 30;
+        else if(_mm256_movemask_epi8(lead4) & 0x20000000)
+            length = 29;
+        
+        if(length != 32) {
+            high  &= (1U << length) - 1;
+            leads &= (1U << length) - 1;
+        }
+        
+        *count_ascii     += length - (size_t)__builtin_popcount(high);
+        *count_multibyte += (size_t)__builtin_popcount(leads);
+        
+        offset += length;
+    }
+#elif defined(MyCORE_MCSCAN_SSE2)
+    const __m128i v_cont_mask = _mm_set1_epi8((char)0xC0);
+    const __m128i v_cont      = _mm_set1_epi8((char)0x80);
+    
+    while((size - offset) >= 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)&data[offset]);
+        unsigned int high = (unsigned int)_mm_movemask_epi8(block);
+        
+        if(high == 0) {
+            *count_ascii += 16;
+            offset += 16;
+            
+            continue;
+        }
+        
+        __m128i lead2 = mcscan_sse2_ge(block, 0xC0);
+        __m128i lead3 = mcscan_sse2_ge(block, 0xE0);
+        __m128i lead4 = mcscan_sse2_ge(block, 0xF0);
+        
+        if(_mm_movemask_epi8(mcscan_sse2_ge(block, 0xF8)))
+            break;
+        
+        /* continuation bytes must be exactly where leads want them */
+        __m128i cont = _mm_cmpeq_epi8(_mm_and_si128(block, v_cont_mask), v_cont);
+        __m128i need = _mm_or_si128(_mm_slli_si128(lead2, 1),
+                                    _mm_or_si128(_mm_slli_si128(lead3, 2), _mm_slli_si128(lead4, 3)));
+        
+        if(_mm_movemask_epi8(_mm_xor_si128(cont, need)))
+            break;
+        
+        unsigned int leads = (unsigned int)_mm_movemask_epi8(lead2);
+        
+        /* last character is not finished in block, take the block up to it */
+        size_t length = 16;
+        
+        if(leads & 0x8000)
+            length = 15;
+        else if(_mm_movemask_epi8(lead3) & 0x4000)
+            length = 14;
+        else if(_mm_movemask_epi8(lead4) & 0x2000)
+            length = 13;
+        
+        high  &= (1U << length) - 1;
+        leads &= (1U << length) - 1;
+        
+        *count_ascii     += length - (size_t)__builtin_popcount(high);
+        *count_multibyte += (size_t)__builtin_popcount(leads);
+        
+        offset += length;
+    }
+#elif defined(MyCORE_MCSCAN_WORD)
+    while((size - offset) >= 8) {
+        unsigned long long word;
+        memcpy(&word, &data[offset], sizeof(word));
+        
+        if(word & MyCORE_MCSCAN_WORD_HIGHS)
+            break;
+        
+        *count_ascii += 8;
+        offset += 8;
+    }
+#endif
+    
+    return offset;
+}
@@ -0,0 +1,61 @@
+/*
+ Copyright (C) 2015-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+ */
+
+#ifndef MyCORE_UTILS_MCSCAN_H
+#define MyCORE_UTILS_MCSCAN_H
+#pragma once
+
+#include "mycore/myosi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Block scanners for tokenizers: skip bytes which are not interesting for a state.
+ * Implementation is selected at build time: AVX2 (if compiler builds for it, -mavx2),
+ * SSE2 (all x86_64), otherwise words of 8 bytes.
+ * With MyCORE_BUILD_WITHOUT_SIMD all of them are simple loops, result is the same.
+ *
+ * All functions return offset of the first found byte or size if nothing is found.
+ */
+size_t mcscan_char(const char* data, size_t offset, size_t size, unsigned char c);
+size_t mcscan_char2(const char* data, size_t offset, size_t size, unsigned char c1, unsigned char c2);
+
+/* first byte which is not whitespace: \t, \n, \f, \r or space */
+size_t mcscan_not_whitespace(const char* data, size_t offset, size_t size);
+
+/* first byte which is not ASCII (0x80 and above) */
+size_t mcscan_not_ascii(const char* data, size_t offset, size_t size);
+
+/*
+ * Skip blocks of well-formed UTF-8: each lead byte is followed by all of its continuation bytes
+ * (code point values are not checked); a character not finished in a block is left for the next one.
+ * offset must be on a character boundary. Returns offset after the last skipped block,
+ * without SIMD nothing but ASCII is skipped; the rest must be checked by the caller.
+ * count_ascii and count_multibyte are increased by counts of ASCII bytes and of lead bytes in skipped blocks.
+ */
+size_t mcscan_utf_8(const char* data, size_t offset, size_t size, size_t* count_ascii, size_t* count_multibyte);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* MyCORE_UTILS_MCSCAN_H */
@@ -32,7 +32,7 @@ void mcsimple_init(mcsimple_t *mcsimple, size_t pos_size, size_t list_size, size
     mcsimple->list_pos_length_used = 0;
     mcsimple->list_pos_length = 0;
     mcsimple->list_pos_size = pos_size;
-    mcsimple->list = (uint8_t**)mycore_calloc(pos_size, sizeof(uint8_t*));
+    mcsimple->list = (uint8_t**)mcallocator_calloc(mcsimple->allocator, pos_size, sizeof(uint8_t*));
     
     if(mcsimple->list == NULL) {
         return;
@@ -51,6 +51,12 @@ void mcsimple_clean(mcsimple_t *mcsimple)
     mcsimple->list_pos_length = 0;
 }
 
+/* before init, all memory of mcsimple is freed by the same allocator */
+void mcsimple_allocator_set(mcsimple_t *mcsimple, mcallocator_t *allocator)
+{
+    mcsimple->allocator = allocator;
+}
+
 mcsimple_t * mcsimple_destroy(mcsimple_t *mcsimple, bool destroy_self)
 {
     if(mcsimple == NULL)
@@ -59,10 +65,10 @@ mcsimple_t * mcsimple_destroy(mcsimple_t *mcsimple, bool destroy_self)
     if(mcsimple->list) {
         for(size_t i = 0; i < mcsimple->list_pos_length_used; i++) {
             if(mcsimple->list[i])
-                mycore_free(mcsimple->list[i]);
+                mcallocator_free(mcsimple->allocator, mcsimple->list[i]);
         }
         
-        mycore_free(mcsimple->list);
+        mcallocator_free(mcsimple->allocator, mcsimple->list);
     }
     
     if(destroy_self) {
@@ -78,7 +84,7 @@ uint8_t * mcsimple_init_list_entries(mcsimple_t *mcsimple, size_t pos)
     if(mcsimple->list_pos_length >= mcsimple->list_pos_size)
     {
         size_t new_size = mcsimple->list_pos_size + 128;
-        uint8_t **list = (uint8_t**)mycore_realloc(mcsimple->list, mcsimple->list_pos_size * sizeof(uint8_t*));
+        uint8_t **list = (uint8_t**)mcallocator_realloc(mcsimple->allocator, mcsimple->list, new_size * sizeof(uint8_t*));
         
         if(list) {
             mcsimple->list = list;
@@ -94,7 +100,7 @@ uint8_t * mcsimple_init_list_entries(mcsimple_t *mcsimple, size_t pos)
     
     if(mcsimple->list[pos] == NULL) {
         mcsimple->list_pos_length_used++;
-        mcsimple->list[pos] = (uint8_t*)mycore_malloc(mcsimple->list_size * sizeof(uint8_t));
+        mcsimple->list[pos] = (uint8_t*)mcallocator_malloc(mcsimple->allocator, mcsimple->list_size * sizeof(uint8_t));
     }
     
     return mcsimple->list[pos];
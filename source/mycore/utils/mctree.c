@@ -44,8 +44,14 @@ mctree_t * mctree_create(size_t start_size)
 
 void mctree_clean(mctree_t* mctree)
 {
+    /* nodes after nodes_length were never used, node at nodes_length is next free */
+    size_t used = mctree->nodes_length + 1;
+    
+    if(used > mctree->nodes_size)
+        used = mctree->nodes_size;
+    
     mctree->nodes_length = mctree->start_size + 1;
-    memset(mctree->nodes, 0, sizeof(mctree_node_t) * mctree->nodes_size);
+    memset(mctree->nodes, 0, sizeof(mctree_node_t) * used);
 }
 
 mctree_t * mctree_destroy(mctree_t* mctree)
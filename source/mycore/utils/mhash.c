@@ -79,6 +79,8 @@ void mycore_utils_mhash_clean(mycore_utils_mhash_t* mhash)
 {
     mchar_async_clean(mhash->mchar_obj);
     memset(mhash->table, 0, (sizeof(mycore_utils_mhash_entry_t*) * mhash->table_size));
+    
+    mhash->table_length = 0;
 }
 
 mycore_utils_mhash_t * mycore_utils_mhash_destroy(mycore_utils_mhash_t* mhash, bool self_destroy)
@@ -91,8 +93,10 @@ mycore_utils_mhash_t * mycore_utils_mhash_destroy(mycore_utils_mhash_t* mhash, b
         mhash->table = NULL;
     }
     
+    mhash->mchar_obj = mchar_async_destroy(mhash->mchar_obj, true);
+    
     if(self_destroy) {
-        mycore_free(mhash->table);
+        mycore_free(mhash);
         return NULL;
     }
     
@@ -104,6 +108,9 @@ mycore_utils_mhash_entry_t * mycore_utils_mhash_create_entry(mycore_utils_mhash_
     mycore_utils_mhash_entry_t *entry = (mycore_utils_mhash_entry_t*)
     mchar_async_malloc(mhash->mchar_obj, mhash->mchar_node, sizeof(mycore_utils_mhash_entry_t));
     
+    if(entry == NULL)
+        return NULL;
+    
     entry->key = mchar_async_malloc(mhash->mchar_obj, mhash->mchar_node, (sizeof(char) * key_size) + 1);
     
     if(entry->key == NULL) {
@@ -128,16 +135,20 @@ mycore_utils_mhash_entry_t * mycore_utils_mhash_add_with_choice(mycore_utils_mha
     
     size_t hash_id = mycore_utils_mhash_hash(key, key_size, mhash->table_size);
     
-    
     mycore_utils_mhash_entry_t *entry;
     
     if(mhash->table[hash_id] == NULL) {
         /* rebuild table if need */
         if(mhash->table_length >= (mhash->table_size - (mhash->table_size / 4))) {
-            mycore_utils_mhash_rebuld(mhash);
+            if(mycore_utils_mhash_rebuld(mhash))
+                return mycore_utils_mhash_add_with_choice(mhash, key, key_size);
         }
         
         mhash->table[hash_id] = mycore_utils_mhash_create_entry(mhash, key, key_size, NULL);
+        
+        if(mhash->table[hash_id])
+            mhash->table_length++;
+        
         return mhash->table[hash_id];
     }
     
@@ -153,6 +164,11 @@ mycore_utils_mhash_entry_t * mycore_utils_mhash_add_with_choice(mycore_utils_mha
         if(entry->next == NULL) {
             entry->next = mycore_utils_mhash_create_entry(mhash, key, key_size, NULL);
             
+            if(entry->next == NULL)
+                return NULL;
+            
+            mhash->table_length++;
+            
             if(depth > mhash->table_max_depth) {
                 mycore_utils_mhash_entry_t *entry_new = entry->next;
                 mycore_utils_mhash_rebuld(mhash);
@@ -257,13 +273,14 @@ mycore_utils_mhash_entry_t ** mycore_utils_mhash_rebuld(mycore_utils_mhash_t* mh
         return NULL;
     }
     
-    for(size_t i = 0; i < mhash->table_size; i++) {
+    for(size_t i = 0; i < size; i++) {
         mycore_utils_mhash_entry_t *entry = table[i];
         
         while(entry) {
+            mycore_utils_mhash_entry_t *next = entry->next;
             mycore_utils_mhash_rebuild_add_entry(mhash, entry->key, entry->key_length, entry);
             
-            entry = entry->next;
+            entry = next;
         }
     }
     
@@ -0,0 +1,1374 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#include "mycss/cache.h"
+#include "mycss/selectors/list.h"
+#include "mycss/selectors/value.h"
+#include "mycss/declaration/entry.h"
+#include "mycss/values/values.h"
+#include "mycss/an_plus_b.h"
+
+#include <stddef.h>
+
+/* shape of value of declaration, nested declarations have it by place in parent value */
+enum mycss_cache_shape {
+    MyCSS_CACHE_SHAPE_UNDEF                = 0x00,
+    MyCSS_CACHE_SHAPE_BACKGROUND           = 0x01,
+    MyCSS_CACHE_SHAPE_BACKGROUND_POSITION  = 0x02,
+    MyCSS_CACHE_SHAPE_BACKGROUND_REPEAT    = 0x03,
+    MyCSS_CACHE_SHAPE_BACKGROUND_SIZE      = 0x04,
+    MyCSS_CACHE_SHAPE_TYPE_LIST            = 0x05,
+    MyCSS_CACHE_SHAPE_IMAGE_LIST           = 0x06,
+    MyCSS_CACHE_SHAPE_BORDER               = 0x07,
+    MyCSS_CACHE_SHAPE_BORDER_RADIUS        = 0x08,
+    MyCSS_CACHE_SHAPE_SHORTHAND_FOUR       = 0x09,
+    MyCSS_CACHE_SHAPE_SHORTHAND_TWO_TYPE   = 0x0a,
+    MyCSS_CACHE_SHAPE_FONT                 = 0x0b,
+    MyCSS_CACHE_SHAPE_FONT_FAMILY          = 0x0c,
+    MyCSS_CACHE_SHAPE_TEXT_DECORATION      = 0x0d,
+    MyCSS_CACHE_SHAPE_FLAGS                = 0x0e
+}
+typedef mycss_cache_shape_t;
+
+struct mycss_cache_block {
+    const void* src;
+    size_t pos;
+}
+typedef mycss_cache_block_t;
+
+struct mycss_cache_pointer {
+    size_t slot;
+    const void* src;
+    
+    /* back references (prev, parent) out of image are set to NULL */
+    bool is_weak;
+}
+typedef mycss_cache_pointer_t;
+
+struct mycss_cache_writer {
+    char* data;
+    size_t length;
+    size_t size;
+    
+    /* copied structures by source address, open addressing */
+    mycss_cache_block_t* blocks;
+    size_t blocks_length;
+    size_t blocks_size;
+    
+    /* pointers are resolved when all structures are copied */
+    mycss_cache_pointer_t* pointers;
+    size_t pointers_length;
+    size_t pointers_size;
+    
+    size_t* relocation;
+    size_t relocation_length;
+    size_t relocation_size;
+    
+    mystatus_t status;
+}
+typedef mycss_cache_writer_t;
+
+static void mycss_cache_writer_selectors_list(mycss_cache_writer_t* writer, const mycss_selectors_list_t* list);
+static void mycss_cache_writer_declaration_chain(mycss_cache_writer_t* writer, const mycss_declaration_entry_t* decl);
+static void mycss_cache_writer_declaration(mycss_cache_writer_t* writer, size_t slot, const mycss_declaration_entry_t* decl, mycss_cache_shape_t shape);
+static void mycss_cache_writer_image(mycss_cache_writer_t* writer, size_t slot, const mycss_values_image_t* image);
+
+static void mycss_cache_layout(size_t* layout)
+{
+    layout[0] = 0x01020304;
+    layout[1] = sizeof(void*);
+    layout[2] = sizeof(size_t);
+    layout[3] = sizeof(mycss_stylesheet_t);
+    layout[4] = sizeof(mycss_selectors_list_t);
+    layout[5] = sizeof(mycss_selectors_entry_t);
+    layout[6] = sizeof(mycss_declaration_entry_t);
+    layout[7] = MyCSS_PROPERTY_TYPE_LAST_ENTRY;
+}
+
+/*
+ * Writer
+ */
+static mystatus_t mycss_cache_writer_init(mycss_cache_writer_t* writer)
+{
+    memset(writer, 0, sizeof(mycss_cache_writer_t));
+    
+    writer->size = 4096;
+    writer->data = (char*)mycore_malloc(writer->size);
+    
+    writer->blocks_size = 1024;
+    writer->blocks = (mycss_cache_block_t*)mycore_calloc(writer->blocks_size, sizeof(mycss_cache_block_t));
+    
+    if(writer->data == NULL || writer->blocks == NULL)
+        return MyCORE_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    return MyCSS_STATUS_OK;
+}
+
+static void mycss_cache_writer_destroy(mycss_cache_writer_t* writer)
+{
+    mycore_free(writer->data);
+    mycore_free(writer->blocks);
+    mycore_free(writer->pointers);
+    mycore_free(writer->relocation);
+}
+
+static bool mycss_cache_writer_list_grow(mycss_cache_writer_t* writer, void** list, size_t* size, size_t length, size_t entry_size)
+{
+    if(length < *size)
+        return true;
+    
+    size_t new_size = (*size ? (*size * 2) : 1024);
+    void *tmp = mycore_realloc(*list, (new_size * entry_size));
+    
+    if(tmp == NULL) {
+        writer->status = MyCORE_STATUS_ERROR_MEMORY_ALLOCATION;
+        return false;
+    }
+    
+    *list = tmp;
+    *size = new_size;
+    
+    return true;
+}
+
+/* returns 0 on error, position 0 is taken by header */
+static size_t mycss_cache_writer_alloc(mycss_cache_writer_t* writer, size_t size, size_t align)
+{
+    if(writer->status)
+        return 0;
+    
+    size_t pos = (writer->length + (align - 1)) & ~(align - 1);
+    
+    if((pos + size) > writer->size) {
+        size_t new_size = writer->size * 2;
+        
+        while((pos + size) > new_size)
+            new_size *= 2;
+        
+        char *tmp = (char*)mycore_realloc(writer->data, new_size);
+        
+        if(tmp == NULL) {
+            writer->status = MyCORE_STATUS_ERROR_MEMORY_ALLOCATION;
+            return 0;
+        }
+        
+        writer->data = tmp;
+        writer->size = new_size;
+    }
+    
+    memset(&writer->data[writer->length], 0, ((pos + size) - writer->length));
+    writer->length = pos + size;
+    
+    return pos;
+}
+
+static void mycss_cache_writer_zero(mycss_cache_writer_t* writer, size_t slot, size_t size)
+{
+    if(writer->status == MyCSS_STATUS_OK)
+        memset(&writer->data[slot], 0, size);
+}
+
+static void mycss_cache_writer_size(mycss_cache_writer_t* writer, size_t slot, size_t value)
+{
+    if(writer->status == MyCSS_STATUS_OK)
+        memcpy(&writer->data[slot], &value, sizeof(size_t));
+}
+
+static void mycss_cache_writer_relocation(mycss_cache_writer_t* writer, size_t slot, size_t pos)
+{
+    if(writer->status || mycss_cache_writer_list_grow(writer, (void**)&writer->relocation, &writer->relocation_size,
+                                                      writer->relocation_length, sizeof(size_t)) == false)
+    {
+        return;
+    }
+    
+    mycss_cache_writer_size(writer, slot, pos);
+    
+    writer->relocation[ writer->relocation_length ] = slot;
+    writer->relocation_length++;
+}
+
+static mycss_cache_block_t * mycss_cache_writer_block_find(mycss_cache_writer_t* writer, const void* src)
+{
+    size_t key = (size_t)((uintptr_t)src >> 3);
+    size_t mask = writer->blocks_size - 1;
+    size_t idx = ((key ^ (key >> 16)) * 2654435761u) & mask;
+    
+    while(writer->blocks[idx].src) {
+        if(writer->blocks[idx].src == src)
+            break;
+        
+        idx = (idx + 1) & mask;
+    }
+    
+    return &writer->blocks[idx];
+}
+
+static void mycss_cache_writer_block_add(mycss_cache_writer_t* writer, const void* src, size_t pos)
+{
+    if(writer->status)
+        return;
+    
+    if((writer->blocks_length * 2) >= writer->blocks_size)
+    {
+        mycss_cache_block_t *old = writer->blocks;
+        size_t old_size = writer->blocks_size;
+        
+        writer->blocks = (mycss_cache_block_t*)mycore_calloc((old_size * 2), sizeof(mycss_cache_block_t));
+        
+        if(writer->blocks == NULL) {
+            writer->blocks = old;
+            writer->status = MyCORE_STATUS_ERROR_MEMORY_ALLOCATION;
+            
+            return;
+        }
+        
+        writer->blocks_size = old_size * 2;
+        
+        for(size_t i = 0; i < old_size; i++) {
+            if(old[i].src)
+                *mycss_cache_writer_block_find(writer, old[i].src) = old[i];
+        }
+        
+        mycore_free(old);
+    }
+    
+    mycss_cache_block_t *block = mycss_cache_writer_block_find(writer, src);
+    
+    block->src = src;
+    block->pos = pos;
+    
+    writer->blocks_length++;
+}
+
+/* copy of structure; false if it is already in image or on error */
+static bool mycss_cache_writer_block(mycss_cache_writer_t* writer, const void* src, size_t size, size_t* pos)
+{
+    *pos = 0;
+    
+    if(src == NULL || writer->status)
+        return false;
+    
+    mycss_cache_block_t *block = mycss_cache_writer_block_find(writer, src);
+    
+    if(block->src) {
+        *pos = block->pos;
+        return false;
+    }
+    
+    *pos = mycss_cache_writer_alloc(writer, size, MyCSS_CACHE_ALIGN);
+    
+    if(writer->status)
+        return false;
+    
+    memcpy(&writer->data[*pos], src, size);
+    mycss_cache_writer_block_add(writer, src, *pos);
+    
+    return (writer->status == MyCSS_STATUS_OK);
+}
+
+static void mycss_cache_writer_pointer(mycss_cache_writer_t* writer, size_t slot, const void* src, bool is_weak)
+{
+    mycss_cache_writer_zero(writer, slot, sizeof(void*));
+    
+    if(src == NULL || writer->status)
+        return;
+    
+    if(mycss_cache_writer_list_grow(writer, (void**)&writer->pointers, &writer->pointers_size,
+                                    writer->pointers_length, sizeof(mycss_cache_pointer_t)) == false)
+    {
+        return;
+    }
+    
+    mycss_cache_pointer_t *pointer = &writer->pointers[ writer->pointers_length ];
+    
+    pointer->slot    = slot;
+    pointer->src     = src;
+    pointer->is_weak = is_weak;
+    
+    writer->pointers_length++;
+}
+
+static void mycss_cache_writer_resolve(mycss_cache_writer_t* writer)
+{
+    for(size_t i = 0; i < writer->pointers_length; i++)
+    {
+        if(writer->status)
+            return;
+        
+        mycss_cache_pointer_t *pointer = &writer->pointers[i];
+        mycss_cache_block_t *block = mycss_cache_writer_block_find(writer, pointer->src);
+        
+        if(block->src)
+            mycss_cache_writer_relocation(writer, pointer->slot, block->pos);
+        else if(pointer->is_weak == false)
+            writer->status = MyCSS_STATUS_ERROR_CACHE_VALUE;
+    }
+}
+
+/* structure without pointers */
+static void mycss_cache_writer_flat(mycss_cache_writer_t* writer, size_t slot, const void* src, size_t size)
+{
+    size_t pos;
+    
+    mycss_cache_writer_pointer(writer, slot, src, false);
+    mycss_cache_writer_block(writer, src, size, &pos);
+}
+
+/* fields of string copied to pos, data is copied with terminating zero and is never reallocated */
+static void mycss_cache_writer_string(mycss_cache_writer_t* writer, size_t pos, const mycore_string_t* str)
+{
+    mycss_cache_writer_zero(writer, (pos + offsetof(mycore_string_t, data)), sizeof(char*));
+    mycss_cache_writer_zero(writer, (pos + offsetof(mycore_string_t, mchar)), sizeof(mchar_async_t*));
+    mycss_cache_writer_size(writer, (pos + offsetof(mycore_string_t, node_idx)), 0);
+    
+    if(str->data == NULL) {
+        mycss_cache_writer_size(writer, (pos + offsetof(mycore_string_t, size)), 0);
+        return;
+    }
+    
+    size_t data_pos = mycss_cache_writer_alloc(writer, (str->length + 1), 1);
+    
+    if(writer->status)
+        return;
+    
+    memcpy(&writer->data[data_pos], str->data, str->length);
+    
+    mycss_cache_writer_size(writer, (pos + offsetof(mycore_string_t, size)), (str->length + 1));
+    mycss_cache_writer_relocation(writer, (pos + offsetof(mycore_string_t, data)), data_pos);
+}
+
+static void mycss_cache_writer_string_pointer(mycss_cache_writer_t* writer, size_t slot, const mycore_string_t* str)
+{
+    size_t pos;
+    
+    mycss_cache_writer_pointer(writer, slot, str, false);
+    
+    if(mycss_cache_writer_block(writer, str, sizeof(mycore_string_t), &pos))
+        mycss_cache_writer_string(writer, pos, str);
+}
+
+/*
+ * Namespaces
+ */
+static void mycss_cache_writer_namespace_entry_fields(mycss_cache_writer_t* writer, size_t pos, const mycss_namespace_entry_t* ns_entry)
+{
+    mycss_cache_writer_string_pointer(writer, (pos + offsetof(mycss_namespace_entry_t, name)), ns_entry->name);
+    mycss_cache_writer_string_pointer(writer, (pos + offsetof(mycss_namespace_entry_t, url)), ns_entry->url);
+    
+    mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_namespace_entry_t, next)), ns_entry->next, false);
+    mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_namespace_entry_t, prev)), ns_entry->prev, true);
+}
+
+static void mycss_cache_writer_namespace_entry(mycss_cache_writer_t* writer, const mycss_namespace_entry_t* ns_entry)
+{
+    size_t pos;
+    
+    while(mycss_cache_writer_block(writer, ns_entry, sizeof(mycss_namespace_entry_t), &pos)) {
+        mycss_cache_writer_namespace_entry_fields(writer, pos, ns_entry);
+        ns_entry = ns_entry->next;
+    }
+}
+
+static void mycss_cache_writer_namespace_stylesheet(mycss_cache_writer_t* writer, size_t pos, const mycss_namespace_stylesheet_t* ns_stylesheet)
+{
+    size_t undef_pos = pos + offsetof(mycss_namespace_stylesheet_t, entry_undef);
+    size_t any_pos   = pos + offsetof(mycss_namespace_stylesheet_t, entry_any);
+    
+    /* names are needed only by parser */
+    mycss_cache_writer_zero(writer, (pos + offsetof(mycss_namespace_stylesheet_t, name_tree)), sizeof(mctree_t*));
+    
+    /* selectors point to embedded entries */
+    mycss_cache_writer_block_add(writer, &ns_stylesheet->entry_undef, undef_pos);
+    mycss_cache_writer_block_add(writer, &ns_stylesheet->entry_any, any_pos);
+    
+    mycss_cache_writer_namespace_entry_fields(writer, undef_pos, &ns_stylesheet->entry_undef);
+    mycss_cache_writer_namespace_entry_fields(writer, any_pos, &ns_stylesheet->entry_any);
+    
+    mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_namespace_stylesheet_t, entry_first)), ns_stylesheet->entry_first, false);
+    mycss_cache_writer_namespace_entry(writer, ns_stylesheet->entry_first);
+    
+    mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_namespace_stylesheet_t, entry_default)), ns_stylesheet->entry_default, false);
+    mycss_cache_writer_namespace_entry(writer, ns_stylesheet->entry_default);
+}
+
+/*
+ * Selectors
+ */
+static void mycss_cache_writer_selectors_value_lang(mycss_cache_writer_t* writer, size_t slot, const mycss_selectors_value_lang_t* lang)
+{
+    size_t pos;
+    
+    mycss_cache_writer_pointer(writer, slot, lang, false);
+    
+    while(mycss_cache_writer_block(writer, lang, sizeof(mycss_selectors_value_lang_t), &pos)) {
+        mycss_cache_writer_string(writer, (pos + offsetof(mycss_selectors_value_lang_t, str)), &lang->str);
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_selectors_value_lang_t, next)), lang->next, false);
+        
+        lang = lang->next;
+    }
+}
+
+static void mycss_cache_writer_selectors_value_function(mycss_cache_writer_t* writer, size_t slot, const mycss_selectors_entry_t* selector)
+{
+    size_t pos;
+    
+    switch (selector->sub_type) {
+        case MyCSS_SELECTORS_SUB_TYPE_PSEUDO_CLASS_FUNCTION_CONTAINS:
+        case MyCSS_SELECTORS_SUB_TYPE_PSEUDO_CLASS_FUNCTION_CURRENT:
+        case MyCSS_SELECTORS_SUB_TYPE_PSEUDO_CLASS_FUNCTION_HAS:
+        case MyCSS_SELECTORS_SUB_TYPE_PSEUDO_CLASS_FUNCTION_MATCHES:
+        case MyCSS_SELECTORS_SUB_TYPE_PSEUDO_CLASS_FUNCTION_NOT:
+            mycss_cache_writer_pointer(writer, slot, selector->value, false);
+            mycss_cache_writer_selectors_list(writer, selector->value);
+            break;
+            
+        case MyCSS_SELECTORS_SUB_TYPE_PSEUDO_CLASS_FUNCTION_DIR:
+            mycss_cache_writer_string_pointer(writer, slot, selector->value);
+            break;
+            
+        case MyCSS_SELECTORS_SUB_TYPE_PSEUDO_CLASS_FUNCTION_DROP:
+            /* flags in place of pointer */
+            break;
+            
+        case MyCSS_SELECTORS_SUB_TYPE_PSEUDO_CLASS_FUNCTION_LANG:
+            mycss_cache_writer_selectors_value_lang(writer, slot, selector->value);
+            break;
+            
+        case MyCSS_SELECTORS_SUB_TYPE_PSEUDO_CLASS_FUNCTION_NTH_CHILD:
+        case MyCSS_SELECTORS_SUB_TYPE_PSEUDO_CLASS_FUNCTION_NTH_COLUMN:
+        case MyCSS_SELECTORS_SUB_TYPE_PSEUDO_CLASS_FUNCTION_NTH_LAST_CHILD:
+        case MyCSS_SELECTORS_SUB_TYPE_PSEUDO_CLASS_FUNCTION_NTH_LAST_COLUMN:
+        case MyCSS_SELECTORS_SUB_TYPE_PSEUDO_CLASS_FUNCTION_NTH_LAST_OF_TYPE:
+        case MyCSS_SELECTORS_SUB_TYPE_PSEUDO_CLASS_FUNCTION_NTH_OF_TYPE:
+        {
+            const mycss_an_plus_b_entry_t *anb = selector->value;
+            
+            mycss_cache_writer_pointer(writer, slot, anb, false);
+            
+            if(mycss_cache_writer_block(writer, anb, sizeof(mycss_an_plus_b_entry_t), &pos)) {
+                mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_an_plus_b_entry_t, of)), anb->of, false);
+                mycss_cache_writer_selectors_list(writer, anb->of);
+            }
+            
+            break;
+        }
+            
+        default:
+            if(selector->value)
+                writer->status = MyCSS_STATUS_ERROR_CACHE_VALUE;
+            
+            break;
+    }
+}
+
+static void mycss_cache_writer_selectors_value(mycss_cache_writer_t* writer, size_t slot, const mycss_selectors_entry_t* selector)
+{
+    size_t pos;
+    
+    switch (selector->type) {
+        case MyCSS_SELECTORS_TYPE_ATTRIBUTE:
+        {
+            const mycss_selectors_object_attribute_t *attr = selector->value;
+            
+            mycss_cache_writer_pointer(writer, slot, attr, false);
+            
+            if(mycss_cache_writer_block(writer, attr, sizeof(mycss_selectors_object_attribute_t), &pos))
+                mycss_cache_writer_string_pointer(writer, (pos + offsetof(mycss_selectors_object_attribute_t, value)), attr->value);
+            
+            break;
+        }
+            
+        case MyCSS_SELECTORS_TYPE_PSEUDO_CLASS_FUNCTION:
+            mycss_cache_writer_selectors_value_function(writer, slot, selector);
+            break;
+            
+        default:
+            mycss_cache_writer_string_pointer(writer, slot, selector->value);
+            break;
+    }
+}
+
+static void mycss_cache_writer_selectors_entry(mycss_cache_writer_t* writer, const mycss_selectors_entry_t* selector)
+{
+    size_t pos;
+    
+    while(mycss_cache_writer_block(writer, selector, sizeof(mycss_selectors_entry_t), &pos))
+    {
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_selectors_entry_t, ns_entry)), selector->ns_entry, false);
+        mycss_cache_writer_namespace_entry(writer, selector->ns_entry);
+        
+        mycss_cache_writer_string_pointer(writer, (pos + offsetof(mycss_selectors_entry_t, key)), selector->key);
+        mycss_cache_writer_selectors_value(writer, (pos + offsetof(mycss_selectors_entry_t, value)), selector);
+        
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_selectors_entry_t, next)), selector->next, false);
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_selectors_entry_t, prev)), selector->prev, true);
+        
+        selector = selector->next;
+    }
+}
+
+static void mycss_cache_writer_selectors_list(mycss_cache_writer_t* writer, const mycss_selectors_list_t* list)
+{
+    size_t pos, entries_pos;
+    
+    while(mycss_cache_writer_block(writer, list, sizeof(mycss_selectors_list_t), &pos))
+    {
+        const mycss_selectors_entries_list_t *entries_list = (list->entries_list_length ? list->entries_list : NULL);
+        
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_selectors_list_t, entries_list)), entries_list, false);
+        
+        if(mycss_cache_writer_block(writer, entries_list, (sizeof(mycss_selectors_entries_list_t) * list->entries_list_length), &entries_pos))
+        {
+            for(size_t i = 0; i < list->entries_list_length; i++) {
+                size_t slot = entries_pos + (sizeof(mycss_selectors_entries_list_t) * i) + offsetof(mycss_selectors_entries_list_t, entry);
+                
+                mycss_cache_writer_pointer(writer, slot, entries_list[i].entry, false);
+                mycss_cache_writer_selectors_entry(writer, entries_list[i].entry);
+            }
+        }
+        
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_selectors_list_t, declaration_entry)), list->declaration_entry, false);
+        mycss_cache_writer_declaration_chain(writer, list->declaration_entry);
+        
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_selectors_list_t, parent)), list->parent, true);
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_selectors_list_t, next)), list->next, false);
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_selectors_list_t, prev)), list->prev, true);
+        
+        list = list->next;
+    }
+}
+
+/*
+ * Values
+ */
+static void mycss_cache_writer_url(mycss_cache_writer_t* writer, size_t slot, const mycss_values_url_t* url)
+{
+    size_t pos;
+    
+    mycss_cache_writer_pointer(writer, slot, url, false);
+    
+    if(mycss_cache_writer_block(writer, url, sizeof(mycss_values_url_t), &pos))
+        mycss_cache_writer_string(writer, (pos + offsetof(mycss_values_url_t, str)), &url->str);
+}
+
+static void mycss_cache_writer_custom_ident(mycss_cache_writer_t* writer, size_t slot, const mycss_values_custom_ident_t* custom_ident)
+{
+    size_t pos;
+    
+    mycss_cache_writer_pointer(writer, slot, custom_ident, false);
+    
+    if(mycss_cache_writer_block(writer, custom_ident, sizeof(mycss_values_custom_ident_t), &pos))
+        mycss_cache_writer_string(writer, (pos + offsetof(mycss_values_custom_ident_t, str)), &custom_ident->str);
+}
+
+static void mycss_cache_writer_image_fields(mycss_cache_writer_t* writer, size_t pos, const mycss_values_image_t* image)
+{
+    size_t slot = pos + offsetof(mycss_values_image_t, value);
+    size_t value_pos, options_pos;
+    
+    switch (image->type) {
+        case MyCSS_PROPERTY_VALUE__URL:
+            mycss_cache_writer_url(writer, slot, image->value.url);
+            break;
+            
+        case MyCSS_PROPERTY_VALUE__IMAGE_FUNCTION:
+        {
+            const mycss_values_image_image_t *ii = image->value.ii;
+            
+            mycss_cache_writer_pointer(writer, slot, ii, false);
+            
+            if(mycss_cache_writer_block(writer, ii, sizeof(mycss_values_image_image_t), &value_pos)) {
+                mycss_cache_writer_string_pointer(writer, (value_pos + offsetof(mycss_values_image_image_t, str)), ii->str);
+                mycss_cache_writer_image(writer, (value_pos + offsetof(mycss_values_image_image_t, image)), ii->image);
+                mycss_cache_writer_flat(writer, (value_pos + offsetof(mycss_values_image_image_t, color)), ii->color, sizeof(mycss_values_color_t));
+            }
+            
+            break;
+        }
+            
+        case MyCSS_PROPERTY_VALUE__IMAGE_SET_FUNCTION:
+        {
+            const mycss_values_image_image_set_t *ii_set = image->value.ii_set;
+            
+            mycss_cache_writer_pointer(writer, slot, ii_set, false);
+            
+            if(mycss_cache_writer_block(writer, ii_set, sizeof(mycss_values_image_image_set_t), &value_pos) == false)
+                break;
+            
+            const mycss_values_image_image_set_option_t *options = (ii_set->options_length ? ii_set->options : NULL);
+            
+            mycss_cache_writer_pointer(writer, (value_pos + offsetof(mycss_values_image_image_set_t, options)), options, false);
+            
+            if(mycss_cache_writer_block(writer, options, (sizeof(mycss_values_image_image_set_option_t) * ii_set->options_length), &options_pos))
+            {
+                for(size_t i = 0; i < ii_set->options_length; i++) {
+                    size_t option_pos = options_pos + (sizeof(mycss_values_image_image_set_option_t) * i);
+                    
+                    mycss_cache_writer_string_pointer(writer, (option_pos + offsetof(mycss_values_image_image_set_option_t, str)), options[i].str);
+                    mycss_cache_writer_image(writer, (option_pos + offsetof(mycss_values_image_image_set_option_t, image)), options[i].image);
+                    mycss_cache_writer_flat(writer, (option_pos + offsetof(mycss_values_image_image_set_option_t, resolution)),
+                                            options[i].resolution, sizeof(mycss_values_resolution_t));
+                }
+            }
+            
+            break;
+        }
+            
+        case MyCSS_PROPERTY_VALUE__ELEMENT_FUNCTION:
+        {
+            const mycss_values_element_t *element = image->value.element;
+            
+            mycss_cache_writer_pointer(writer, slot, element, false);
+            
+            if(mycss_cache_writer_block(writer, element, sizeof(mycss_values_element_t), &value_pos))
+                mycss_cache_writer_string(writer, (value_pos + offsetof(mycss_values_element_t, custom_ident.str)), &element->custom_ident.str);
+            
+            break;
+        }
+            
+        case MyCSS_PROPERTY_VALUE__CROSS_FADE_FUNCTION:
+        {
+            const mycss_values_cross_fade_t *cross_fade = image->value.cross_fade;
+            
+            mycss_cache_writer_pointer(writer, slot, cross_fade, false);
+            
+            if(mycss_cache_writer_block(writer, cross_fade, sizeof(mycss_values_cross_fade_t), &value_pos)) {
+                mycss_cache_writer_flat(writer, (value_pos + offsetof(mycss_values_cross_fade_t, mixing_image.percentage)),
+                                        cross_fade->mixing_image.percentage, sizeof(mycss_values_percentage_t));
+                mycss_cache_writer_image(writer, (value_pos + offsetof(mycss_values_cross_fade_t, mixing_image.image)),
+                                         cross_fade->mixing_image.image);
+                mycss_cache_writer_image(writer, (value_pos + offsetof(mycss_values_cross_fade_t, final_image.image)),
+                                         cross_fade->final_image.image);
+                mycss_cache_writer_flat(writer, (value_pos + offsetof(mycss_values_cross_fade_t, final_image.color)),
+                                        cross_fade->final_image.color, sizeof(mycss_values_color_t));
+            }
+            
+            break;
+        }
+            
+        default:
+            /* none and other types without value */
+            mycss_cache_writer_zero(writer, slot, sizeof(void*));
+            break;
+    }
+}
+
+static void mycss_cache_writer_image(mycss_cache_writer_t* writer, size_t slot, const mycss_values_image_t* image)
+{
+    size_t pos;
+    
+    mycss_cache_writer_pointer(writer, slot, image, false);
+    
+    if(mycss_cache_writer_block(writer, image, sizeof(mycss_values_image_t), &pos))
+        mycss_cache_writer_image_fields(writer, pos, image);
+}
+
+static void mycss_cache_writer_image_list(mycss_cache_writer_t* writer, size_t slot, const mycss_values_image_list_t* list)
+{
+    size_t pos, images_pos;
+    
+    mycss_cache_writer_pointer(writer, slot, list, false);
+    
+    if(mycss_cache_writer_block(writer, list, sizeof(mycss_values_image_list_t), &pos) == false)
+        return;
+    
+    const mycss_values_image_t *images = (list->images_length ? list->images : NULL);
+    
+    mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_values_image_list_t, images)), images, false);
+    
+    if(mycss_cache_writer_block(writer, images, (sizeof(mycss_values_image_t) * list->images_length), &images_pos)) {
+        for(size_t i = 0; i < list->images_length; i++)
+            mycss_cache_writer_image_fields(writer, (images_pos + (sizeof(mycss_values_image_t) * i)), &images[i]);
+    }
+}
+
+/* value of declaration by value type */
+static void mycss_cache_writer_value(mycss_cache_writer_t* writer, size_t slot, unsigned int value_type, const void* value)
+{
+    if(value == NULL) {
+        mycss_cache_writer_zero(writer, slot, sizeof(void*));
+        return;
+    }
+    
+    switch (value_type) {
+        case MyCSS_PROPERTY_VALUE__LENGTH:
+        case MyCSS_PROPERTY_VALUE__NUMBER:
+            mycss_cache_writer_flat(writer, slot, value, sizeof(mycss_values_length_t));
+            break;
+            
+        case MyCSS_PROPERTY_VALUE__PERCENTAGE:
+            mycss_cache_writer_flat(writer, slot, value, sizeof(mycss_values_percentage_t));
+            break;
+            
+        case MyCSS_PROPERTY_VALUE__RESOLUTION:
+            mycss_cache_writer_flat(writer, slot, value, sizeof(mycss_values_resolution_t));
+            break;
+            
+        case MyCSS_PROPERTY_VALUE__COLOR:
+            mycss_cache_writer_flat(writer, slot, value, sizeof(mycss_values_color_t));
+            break;
+            
+        case MyCSS_PROPERTY_VALUE__URL:
+            mycss_cache_writer_url(writer, slot, value);
+            break;
+            
+        case MyCSS_PROPERTY_VALUE__CUSTOM_IDENT:
+            mycss_cache_writer_custom_ident(writer, slot, value);
+            break;
+            
+        case MyCSS_PROPERTY_VALUE__IMAGE:
+            mycss_cache_writer_image(writer, slot, value);
+            break;
+            
+        case MyCSS_PROPERTY_VALUE__IMAGE_LIST:
+            mycss_cache_writer_image_list(writer, slot, value);
+            break;
+            
+        default:
+            writer->status = MyCSS_STATUS_ERROR_CACHE_VALUE;
+            break;
+    }
+}
+
+static void mycss_cache_writer_type_length_percentage(mycss_cache_writer_t* writer, size_t pos, const mycss_values_type_length_percentage_entry_t* entry)
+{
+    size_t slot = pos + offsetof(mycss_values_type_length_percentage_entry_t, value);
+    
+    switch (entry->type) {
+        case MyCSS_PROPERTY_VALUE__LENGTH:
+            mycss_cache_writer_flat(writer, slot, entry->value.length, sizeof(mycss_values_length_t));
+            break;
+            
+        case MyCSS_PROPERTY_VALUE__PERCENTAGE:
+            mycss_cache_writer_flat(writer, slot, entry->value.percentage, sizeof(mycss_values_percentage_t));
+            break;
+            
+        default:
+            mycss_cache_writer_zero(writer, slot, sizeof(void*));
+            break;
+    }
+}
+
+static void mycss_cache_writer_type_length_percentage_pointer(mycss_cache_writer_t* writer, size_t slot,
+                                                              const mycss_values_type_length_percentage_entry_t* entry)
+{
+    size_t pos;
+    
+    mycss_cache_writer_pointer(writer, slot, entry, false);
+    
+    if(mycss_cache_writer_block(writer, entry, sizeof(mycss_values_type_length_percentage_entry_t), &pos))
+        mycss_cache_writer_type_length_percentage(writer, pos, entry);
+}
+
+/* list of flat entries, array is not set for empty list */
+static void mycss_cache_writer_flat_list(mycss_cache_writer_t* writer, size_t slot, const void* list, size_t list_size,
+                                         size_t entries_offset, const void* entries, size_t entries_length, size_t entry_size)
+{
+    size_t pos;
+    
+    mycss_cache_writer_pointer(writer, slot, list, false);
+    
+    if(mycss_cache_writer_block(writer, list, list_size, &pos))
+        mycss_cache_writer_flat(writer, (pos + entries_offset), (entries_length ? entries : NULL), (entry_size * entries_length));
+}
+
+static void mycss_cache_writer_background_position(mycss_cache_writer_t* writer, size_t slot, const mycss_values_background_position_t* position)
+{
+    size_t pos;
+    
+    mycss_cache_writer_pointer(writer, slot, position, false);
+    
+    if(mycss_cache_writer_block(writer, position, sizeof(mycss_values_background_position_t), &pos) == false)
+        return;
+    
+    mycss_cache_writer_type_length_percentage(writer, (pos + offsetof(mycss_values_background_position_t, one)), &position->one);
+    mycss_cache_writer_type_length_percentage(writer, (pos + offsetof(mycss_values_background_position_t, two)), &position->two);
+    mycss_cache_writer_type_length_percentage(writer, (pos + offsetof(mycss_values_background_position_t, three)), &position->three);
+    mycss_cache_writer_type_length_percentage(writer, (pos + offsetof(mycss_values_background_position_t, four)), &position->four);
+}
+
+static void mycss_cache_writer_background_size(mycss_cache_writer_t* writer, size_t slot, const mycss_values_background_size_list_t* list)
+{
+    size_t pos, entries_pos;
+    
+    mycss_cache_writer_pointer(writer, slot, list, false);
+    
+    if(mycss_cache_writer_block(writer, list, sizeof(mycss_values_background_size_list_t), &pos) == false)
+        return;
+    
+    const mycss_values_background_size_entry_t *entries = (list->entries_length ? list->entries : NULL);
+    
+    mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_values_background_size_list_t, entries)), entries, false);
+    
+    if(mycss_cache_writer_block(writer, entries, (sizeof(mycss_values_background_size_entry_t) * list->entries_length), &entries_pos))
+    {
+        for(size_t i = 0; i < list->entries_length; i++) {
+            size_t entry_pos = entries_pos + (sizeof(mycss_values_background_size_entry_t) * i);
+            
+            mycss_cache_writer_type_length_percentage_pointer(writer, (entry_pos + offsetof(mycss_values_background_size_entry_t, width)), entries[i].width);
+            mycss_cache_writer_type_length_percentage_pointer(writer, (entry_pos + offsetof(mycss_values_background_size_entry_t, height)), entries[i].height);
+        }
+    }
+}
+
+static void mycss_cache_writer_background(mycss_cache_writer_t* writer, size_t slot, const mycss_values_background_list_t* list)
+{
+    size_t pos, entries_pos;
+    
+    mycss_cache_writer_pointer(writer, slot, list, false);
+    
+    if(mycss_cache_writer_block(writer, list, sizeof(mycss_values_background_list_t), &pos) == false)
+        return;
+    
+    const mycss_values_background_t *entries = (list->entries_length ? list->entries : NULL);
+    
+    mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_values_background_list_t, entries)), entries, false);
+    
+    if(mycss_cache_writer_block(writer, entries, (sizeof(mycss_values_background_t) * list->entries_length), &entries_pos) == false)
+        return;
+    
+    for(size_t i = 0; i < list->entries_length; i++) {
+        size_t bg_pos = entries_pos + (sizeof(mycss_values_background_t) * i);
+        const mycss_values_background_t *bg = &entries[i];
+        
+        mycss_cache_writer_declaration(writer, (bg_pos + offsetof(mycss_values_background_t, image)), bg->image, MyCSS_CACHE_SHAPE_IMAGE_LIST);
+        mycss_cache_writer_declaration(writer, (bg_pos + offsetof(mycss_values_background_t, position)), bg->position, MyCSS_CACHE_SHAPE_BACKGROUND_POSITION);
+        mycss_cache_writer_declaration(writer, (bg_pos + offsetof(mycss_values_background_t, size)), bg->size, MyCSS_CACHE_SHAPE_BACKGROUND_SIZE);
+        mycss_cache_writer_declaration(writer, (bg_pos + offsetof(mycss_values_background_t, repeat)), bg->repeat, MyCSS_CACHE_SHAPE_BACKGROUND_REPEAT);
+        mycss_cache_writer_declaration(writer, (bg_pos + offsetof(mycss_values_background_t, attachment)), bg->attachment, MyCSS_CACHE_SHAPE_TYPE_LIST);
+        mycss_cache_writer_declaration(writer, (bg_pos + offsetof(mycss_values_background_t, origin)), bg->origin, MyCSS_CACHE_SHAPE_TYPE_LIST);
+        mycss_cache_writer_declaration(writer, (bg_pos + offsetof(mycss_values_background_t, clip)), bg->clip, MyCSS_CACHE_SHAPE_TYPE_LIST);
+        mycss_cache_writer_declaration(writer, (bg_pos + offsetof(mycss_values_background_t, color)), bg->color, MyCSS_CACHE_SHAPE_UNDEF);
+    }
+}
+
+static void mycss_cache_writer_border(mycss_cache_writer_t* writer, size_t slot, const mycss_values_border_t* border)
+{
+    size_t pos;
+    
+    mycss_cache_writer_pointer(writer, slot, border, false);
+    
+    if(mycss_cache_writer_block(writer, border, sizeof(mycss_values_border_t), &pos)) {
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_border_t, width)), border->width, MyCSS_CACHE_SHAPE_UNDEF);
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_border_t, style)), border->style, MyCSS_CACHE_SHAPE_UNDEF);
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_border_t, color)), border->color, MyCSS_CACHE_SHAPE_UNDEF);
+    }
+}
+
+static void mycss_cache_writer_shorthand_four(mycss_cache_writer_t* writer, size_t slot, const mycss_values_shorthand_four_t* four,
+                                              mycss_cache_shape_t shape)
+{
+    size_t pos;
+    
+    mycss_cache_writer_pointer(writer, slot, four, false);
+    
+    if(mycss_cache_writer_block(writer, four, sizeof(mycss_values_shorthand_four_t), &pos)) {
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_shorthand_four_t, one)), four->one, shape);
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_shorthand_four_t, two)), four->two, shape);
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_shorthand_four_t, three)), four->three, shape);
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_shorthand_four_t, four)), four->four, shape);
+    }
+}
+
+static void mycss_cache_writer_shorthand_two_type(mycss_cache_writer_t* writer, size_t slot, const mycss_values_shorthand_two_type_t* two_type)
+{
+    size_t pos;
+    
+    mycss_cache_writer_pointer(writer, slot, two_type, false);
+    
+    if(mycss_cache_writer_block(writer, two_type, sizeof(mycss_values_shorthand_two_type_t), &pos)) {
+        mycss_cache_writer_value(writer, (pos + offsetof(mycss_values_shorthand_two_type_t, one)), two_type->type_one, two_type->one);
+        mycss_cache_writer_value(writer, (pos + offsetof(mycss_values_shorthand_two_type_t, two)), two_type->type_two, two_type->two);
+    }
+}
+
+static void mycss_cache_writer_font_family(mycss_cache_writer_t* writer, size_t slot, const mycss_values_font_family_t* font_family)
+{
+    size_t pos, entries_pos;
+    
+    mycss_cache_writer_pointer(writer, slot, font_family, false);
+    
+    if(mycss_cache_writer_block(writer, font_family, sizeof(mycss_values_font_family_t), &pos) == false)
+        return;
+    
+    const mycss_values_font_family_entry_t *entries = (font_family->entries_length ? font_family->entries : NULL);
+    
+    mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_values_font_family_t, entries)), entries, false);
+    
+    if(mycss_cache_writer_block(writer, entries, (sizeof(mycss_values_font_family_entry_t) * font_family->entries_length), &entries_pos))
+    {
+        for(size_t i = 0; i < font_family->entries_length; i++) {
+            if(entries[i].type == MyCSS_VALUES_FONT_FAMILY_TYPE_NAME) {
+                mycss_cache_writer_string(writer, (entries_pos + (sizeof(mycss_values_font_family_entry_t) * i) +
+                                                   offsetof(mycss_values_font_family_entry_t, value.str)), &entries[i].value.str);
+            }
+        }
+    }
+}
+
+static void mycss_cache_writer_font(mycss_cache_writer_t* writer, size_t slot, const mycss_values_font_t* font)
+{
+    size_t pos;
+    
+    mycss_cache_writer_pointer(writer, slot, font, false);
+    
+    if(mycss_cache_writer_block(writer, font, sizeof(mycss_values_font_t), &pos)) {
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_font_t, style)), font->style, MyCSS_CACHE_SHAPE_UNDEF);
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_font_t, weight)), font->weight, MyCSS_CACHE_SHAPE_UNDEF);
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_font_t, stretch)), font->stretch, MyCSS_CACHE_SHAPE_UNDEF);
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_font_t, size)), font->size, MyCSS_CACHE_SHAPE_UNDEF);
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_font_t, family)), font->family, MyCSS_CACHE_SHAPE_FONT_FAMILY);
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_font_t, line_height)), font->line_height, MyCSS_CACHE_SHAPE_UNDEF);
+    }
+}
+
+static void mycss_cache_writer_text_decoration(mycss_cache_writer_t* writer, size_t slot, const mycss_values_text_decoration_t* text_decoration)
+{
+    size_t pos;
+    
+    mycss_cache_writer_pointer(writer, slot, text_decoration, false);
+    
+    if(mycss_cache_writer_block(writer, text_decoration, sizeof(mycss_values_text_decoration_t), &pos)) {
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_text_decoration_t, line)), text_decoration->line, MyCSS_CACHE_SHAPE_FLAGS);
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_text_decoration_t, style)), text_decoration->style, MyCSS_CACHE_SHAPE_UNDEF);
+        mycss_cache_writer_declaration(writer, (pos + offsetof(mycss_values_text_decoration_t, color)), text_decoration->color, MyCSS_CACHE_SHAPE_UNDEF);
+    }
+}
+
+/*
+ * Declarations
+ */
+static mycss_cache_shape_t mycss_cache_shape_by_type(mycss_property_type_t type)
+{
+    switch (type) {
+        case MyCSS_PROPERTY_TYPE_BACKGROUND:
+            return MyCSS_CACHE_SHAPE_BACKGROUND;
+            
+        case MyCSS_PROPERTY_TYPE_BACKGROUND_ATTACHMENT:
+        case MyCSS_PROPERTY_TYPE_BACKGROUND_CLIP:
+        case MyCSS_PROPERTY_TYPE_BACKGROUND_ORIGIN:
+            return MyCSS_CACHE_SHAPE_TYPE_LIST;
+            
+        case MyCSS_PROPERTY_TYPE_BACKGROUND_IMAGE:
+            return MyCSS_CACHE_SHAPE_IMAGE_LIST;
+            
+        case MyCSS_PROPERTY_TYPE_BACKGROUND_POSITION:
+            return MyCSS_CACHE_SHAPE_BACKGROUND_POSITION;
+            
+        case MyCSS_PROPERTY_TYPE_BACKGROUND_REPEAT:
+            return MyCSS_CACHE_SHAPE_BACKGROUND_REPEAT;
+            
+        case MyCSS_PROPERTY_TYPE_BACKGROUND_SIZE:
+            return MyCSS_CACHE_SHAPE_BACKGROUND_SIZE;
+            
+        case MyCSS_PROPERTY_TYPE_BORDER:
+        case MyCSS_PROPERTY_TYPE_BORDER_BLOCK_END:
+        case MyCSS_PROPERTY_TYPE_BORDER_BLOCK_START:
+        case MyCSS_PROPERTY_TYPE_BORDER_BOTTOM:
+        case MyCSS_PROPERTY_TYPE_BORDER_INLINE_END:
+        case MyCSS_PROPERTY_TYPE_BORDER_INLINE_START:
+        case MyCSS_PROPERTY_TYPE_BORDER_LEFT:
+        case MyCSS_PROPERTY_TYPE_BORDER_RIGHT:
+        case MyCSS_PROPERTY_TYPE_BORDER_TOP:
+            return MyCSS_CACHE_SHAPE_BORDER;
+            
+        case MyCSS_PROPERTY_TYPE_BORDER_COLOR:
+        case MyCSS_PROPERTY_TYPE_BORDER_STYLE:
+        case MyCSS_PROPERTY_TYPE_BORDER_WIDTH:
+        case MyCSS_PROPERTY_TYPE_MARGIN:
+        case MyCSS_PROPERTY_TYPE_PADDING:
+            return MyCSS_CACHE_SHAPE_SHORTHAND_FOUR;
+            
+        case MyCSS_PROPERTY_TYPE_BORDER_RADIUS:
+            return MyCSS_CACHE_SHAPE_BORDER_RADIUS;
+            
+        case MyCSS_PROPERTY_TYPE_BORDER_BOTTOM_LEFT_RADIUS:
+        case MyCSS_PROPERTY_TYPE_BORDER_BOTTOM_RIGHT_RADIUS:
+        case MyCSS_PROPERTY_TYPE_BORDER_TOP_LEFT_RADIUS:
+        case MyCSS_PROPERTY_TYPE_BORDER_TOP_RIGHT_RADIUS:
+            return MyCSS_CACHE_SHAPE_SHORTHAND_TWO_TYPE;
+            
+        case MyCSS_PROPERTY_TYPE_FONT:
+            return MyCSS_CACHE_SHAPE_FONT;
+            
+        case MyCSS_PROPERTY_TYPE_FONT_FAMILY:
+            return MyCSS_CACHE_SHAPE_FONT_FAMILY;
+            
+        case MyCSS_PROPERTY_TYPE_TEXT_DECORATION:
+            return MyCSS_CACHE_SHAPE_TEXT_DECORATION;
+            
+        case MyCSS_PROPERTY_TYPE_TEXT_DECORATION_LINE:
+        case MyCSS_PROPERTY_TYPE_TEXT_DECORATION_SKIP:
+            return MyCSS_CACHE_SHAPE_FLAGS;
+            
+        default:
+            return MyCSS_CACHE_SHAPE_UNDEF;
+    }
+}
+
+static void mycss_cache_writer_declaration_value(mycss_cache_writer_t* writer, size_t pos, const mycss_declaration_entry_t* decl, mycss_cache_shape_t shape)
+{
+    size_t slot = pos + offsetof(mycss_declaration_entry_t, value);
+    
+    switch (shape) {
+        case MyCSS_CACHE_SHAPE_BACKGROUND:
+            mycss_cache_writer_background(writer, slot, decl->value);
+            break;
+            
+        case MyCSS_CACHE_SHAPE_BACKGROUND_POSITION:
+            mycss_cache_writer_background_position(writer, slot, decl->value);
+            break;
+            
+        case MyCSS_CACHE_SHAPE_BACKGROUND_REPEAT:
+        {
+            const mycss_values_background_repeat_list_t *list = decl->value;
+            
+            mycss_cache_writer_flat_list(writer, slot, list, sizeof(mycss_values_background_repeat_list_t),
+                                         offsetof(mycss_values_background_repeat_list_t, entries),
+                                         (list ? list->entries : NULL), (list ? list->entries_length : 0), sizeof(mycss_values_background_repeat_t));
+            break;
+        }
+            
+        case MyCSS_CACHE_SHAPE_BACKGROUND_SIZE:
+            mycss_cache_writer_background_size(writer, slot, decl->value);
+            break;
+            
+        case MyCSS_CACHE_SHAPE_TYPE_LIST:
+        {
+            const mycss_values_type_list_t *list = decl->value;
+            
+            mycss_cache_writer_flat_list(writer, slot, list, sizeof(mycss_values_type_list_t),
+                                         offsetof(mycss_values_type_list_t, entries),
+                                         (list ? list->entries : NULL), (list ? list->entries_length : 0), sizeof(unsigned int));
+            break;
+        }
+            
+        case MyCSS_CACHE_SHAPE_IMAGE_LIST:
+            mycss_cache_writer_image_list(writer, slot, decl->value);
+            break;
+            
+        case MyCSS_CACHE_SHAPE_BORDER:
+            mycss_cache_writer_border(writer, slot, decl->value);
+            break;
+            
+        case MyCSS_CACHE_SHAPE_BORDER_RADIUS:
+            mycss_cache_writer_shorthand_four(writer, slot, decl->value, MyCSS_CACHE_SHAPE_SHORTHAND_TWO_TYPE);
+            break;
+            
+        case MyCSS_CACHE_SHAPE_SHORTHAND_FOUR:
+            mycss_cache_writer_shorthand_four(writer, slot, decl->value, MyCSS_CACHE_SHAPE_UNDEF);
+            break;
+            
+        case MyCSS_CACHE_SHAPE_SHORTHAND_TWO_TYPE:
+            mycss_cache_writer_shorthand_two_type(writer, slot, decl->value);
+            break;
+            
+        case MyCSS_CACHE_SHAPE_FONT:
+            mycss_cache_writer_font(writer, slot, decl->value);
+            break;
+            
+        case MyCSS_CACHE_SHAPE_FONT_FAMILY:
+            mycss_cache_writer_font_family(writer, slot, decl->value);
+            break;
+            
+        case MyCSS_CACHE_SHAPE_TEXT_DECORATION:
+            mycss_cache_writer_text_decoration(writer, slot, decl->value);
+            break;
+            
+        case MyCSS_CACHE_SHAPE_FLAGS:
+            mycss_cache_writer_flat(writer, slot, decl->value, sizeof(unsigned int));
+            break;
+            
+        default:
+            mycss_cache_writer_value(writer, slot, decl->value_type, decl->value);
+            break;
+    }
+}
+
+/* declaration in value of other declaration */
+static void mycss_cache_writer_declaration(mycss_cache_writer_t* writer, size_t slot, const mycss_declaration_entry_t* decl, mycss_cache_shape_t shape)
+{
+    size_t pos;
+    
+    mycss_cache_writer_pointer(writer, slot, decl, false);
+    
+    if(mycss_cache_writer_block(writer, decl, sizeof(mycss_declaration_entry_t), &pos)) {
+        mycss_cache_writer_declaration_value(writer, pos, decl, shape);
+        
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_declaration_entry_t, next)), decl->next, true);
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_declaration_entry_t, prev)), decl->prev, true);
+    }
+}
+
+static void mycss_cache_writer_declaration_chain(mycss_cache_writer_t* writer, const mycss_declaration_entry_t* decl)
+{
+    size_t pos;
+    
+    while(mycss_cache_writer_block(writer, decl, sizeof(mycss_declaration_entry_t), &pos))
+    {
+        mycss_cache_writer_declaration_value(writer, pos, decl, mycss_cache_shape_by_type(decl->type));
+        
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_declaration_entry_t, next)), decl->next, false);
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_declaration_entry_t, prev)), decl->prev, true);
+        
+        decl = decl->next;
+    }
+}
+
+/*
+ * Stylesheet
+ */
+static void mycss_cache_writer_stylesheet(mycss_cache_writer_t* writer, const mycss_stylesheet_t* stylesheet)
+{
+    size_t pos;
+    
+    while(mycss_cache_writer_block(writer, stylesheet, sizeof(mycss_stylesheet_t), &pos))
+    {
+        mycss_cache_writer_zero(writer, (pos + offsetof(mycss_stylesheet_t, entry)), sizeof(mycss_entry_t*));
+        mycss_cache_writer_namespace_stylesheet(writer, (pos + offsetof(mycss_stylesheet_t, ns_stylesheet)), &stylesheet->ns_stylesheet);
+        
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_stylesheet_t, sel_list_first)), stylesheet->sel_list_first, false);
+        mycss_cache_writer_selectors_list(writer, stylesheet->sel_list_first);
+        
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_stylesheet_t, child)), stylesheet->child, false);
+        mycss_cache_writer_stylesheet(writer, stylesheet->child);
+        
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_stylesheet_t, parent)), stylesheet->parent, true);
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_stylesheet_t, next)), stylesheet->next, false);
+        mycss_cache_writer_pointer(writer, (pos + offsetof(mycss_stylesheet_t, prev)), stylesheet->prev, true);
+        
+        stylesheet = stylesheet->next;
+    }
+}
+
+mystatus_t mycss_cache_serialization(mycss_stylesheet_t* stylesheet, mycore_callback_serialize_f callback, void* context)
+{
+    /* positions are stored in place of pointers */
+    if(stylesheet == NULL || sizeof(size_t) != sizeof(void*))
+        return MyCSS_STATUS_ERROR_CACHE_VALUE;
+    
+    mycss_cache_writer_t writer;
+    mystatus_t status = mycss_cache_writer_init(&writer);
+    
+    if(status) {
+        mycss_cache_writer_destroy(&writer);
+        return status;
+    }
+    
+    mycss_cache_writer_alloc(&writer, sizeof(mycss_cache_header_t), MyCSS_CACHE_ALIGN);
+    mycss_cache_writer_stylesheet(&writer, stylesheet);
+    mycss_cache_writer_resolve(&writer);
+    
+    size_t stylesheet_pos = mycss_cache_writer_block_find(&writer, stylesheet)->pos;
+    size_t relocation_pos = mycss_cache_writer_alloc(&writer, (sizeof(size_t) * writer.relocation_length), MyCSS_CACHE_ALIGN);
+    
+    if(writer.status == MyCSS_STATUS_OK)
+    {
+        if(writer.relocation_length)
+            memcpy(&writer.data[relocation_pos], writer.relocation, (sizeof(size_t) * writer.relocation_length));
+        
+        mycss_cache_header_t header;
+        memset(&header, 0, sizeof(mycss_cache_header_t));
+        
+        memcpy(header.magic, MyCSS_CACHE_MAGIC, sizeof(header.magic));
+        mycss_cache_layout(header.layout);
+        
+        header.version           = MyCSS_CACHE_VERSION;
+        header.size              = writer.length;
+        header.stylesheet        = stylesheet_pos;
+        header.relocation        = relocation_pos;
+        header.relocation_length = writer.relocation_length;
+        
+        memcpy(writer.data, &header, sizeof(mycss_cache_header_t));
+        
+        writer.status = callback(writer.data, writer.length, context);
+    }
+    
+    status = writer.status;
+    mycss_cache_writer_destroy(&writer);
+    
+    return status;
+}
+
+static mystatus_t mycss_cache_save_callback(const char* buffer, size_t size, void* ctx)
+{
+    if(mycore_fwrite(buffer, 1, size, (FILE*)ctx) != size)
+        return MyCSS_STATUS_ERROR_CACHE_WRITE;
+    
+    return MyCSS_STATUS_OK;
+}
+
+mystatus_t mycss_cache_save(mycss_stylesheet_t* stylesheet, const char* filename)
+{
+    FILE *fh = mycore_fopen(filename, "wb");
+    
+    if(fh == NULL)
+        return MyCORE_STATUS_ERROR_FILE_OPEN;
+    
+    mystatus_t status = mycss_cache_serialization(stylesheet, mycss_cache_save_callback, fh);
+    
+    if(mycore_fclose(fh) != 0 && status == MyCSS_STATUS_OK)
+        status = MyCSS_STATUS_ERROR_CACHE_WRITE;
+    
+    return status;
+}
+
+/*
+ * Loader
+ */
+mycss_cache_t * mycss_cache_create(void)
+{
+    return (mycss_cache_t*)mycore_calloc(1, sizeof(mycss_cache_t));
+}
+
+mystatus_t mycss_cache_init(mycss_cache_t* cache)
+{
+    memset(cache, 0, sizeof(mycss_cache_t));
+    return MyCSS_STATUS_OK;
+}
+
+void mycss_cache_clean(mycss_cache_t* cache)
+{
+    if(cache->is_mapped)
+        mycore_file_unmap(cache->data, cache->size);
+    
+    memset(cache, 0, sizeof(mycss_cache_t));
+}
+
+mycss_cache_t * mycss_cache_destroy(mycss_cache_t* cache, bool self_destroy)
+{
+    if(cache == NULL)
+        return NULL;
+    
+    mycss_cache_clean(cache);
+    
+    if(self_destroy) {
+        mycore_free(cache);
+        return NULL;
+    }
+    
+    return cache;
+}
+
+static bool mycss_cache_header_check(const mycss_cache_header_t* header, size_t size)
+{
+    size_t layout[MyCSS_CACHE_LAYOUT_SIZE];
+    mycss_cache_layout(layout);
+    
+    if(memcmp(header->magic, MyCSS_CACHE_MAGIC, sizeof(header->magic)) ||
+       memcmp(header->layout, layout, sizeof(layout)) ||
+       header->version != MyCSS_CACHE_VERSION || header->size != size || header->is_loaded)
+    {
+        return false;
+    }
+    
+    size_t begin = sizeof(mycss_cache_header_t);
+    
+    if(header->relocation < begin || header->relocation > size || (header->relocation % MyCSS_CACHE_ALIGN) ||
+       header->relocation_length > ((size - header->relocation) / sizeof(size_t)))
+    {
+        return false;
+    }
+    
+    if(header->stylesheet < begin || (header->stylesheet % MyCSS_CACHE_ALIGN) ||
+       header->stylesheet > header->relocation || sizeof(mycss_stylesheet_t) > (header->relocation - header->stylesheet))
+    {
+        return false;
+    }
+    
+    return true;
+}
+
+mystatus_t mycss_cache_load_data(mycss_cache_t* cache, char* data, size_t size)
+{
+    mycss_cache_clean(cache);
+    
+    if(data == NULL || size < sizeof(mycss_cache_header_t) || ((uintptr_t)data % MyCSS_CACHE_ALIGN))
+        return MyCSS_STATUS_ERROR_CACHE_FORMAT;
+    
+    mycss_cache_header_t *header = (mycss_cache_header_t*)data;
+    
+    if(mycss_cache_header_check(header, size) == false)
+        return MyCSS_STATUS_ERROR_CACHE_FORMAT;
+    
+    const size_t *relocation = (const size_t*)&data[ header->relocation ];
+    size_t begin = sizeof(mycss_cache_header_t), end = header->relocation;
+    size_t slot, value;
+    
+    /* nothing is changed in bad image */
+    for(size_t i = 0; i < header->relocation_length; i++)
+    {
+        slot = relocation[i];
+        
+        if(slot < begin || (slot % sizeof(void*)) || slot > (end - sizeof(void*)))
+            return MyCSS_STATUS_ERROR_CACHE_FORMAT;
+        
+        memcpy(&value, &data[slot], sizeof(size_t));
+        
+        if(value < begin || value >= end)
+            return MyCSS_STATUS_ERROR_CACHE_FORMAT;
+    }
+    
+    for(size_t i = 0; i < header->relocation_length; i++)
+    {
+        slot = relocation[i];
+        memcpy(&value, &data[slot], sizeof(size_t));
+        
+        char *pointer = &data[value];
+        memcpy(&data[slot], &pointer, sizeof(char*));
+    }
+    
+    header->is_loaded = 1;
+    
+    cache->data       = data;
+    cache->size       = size;
+    cache->stylesheet = (mycss_stylesheet_t*)&data[ header->stylesheet ];
+    
+    return MyCSS_STATUS_OK;
+}
+
+mystatus_t mycss_cache_load(mycss_cache_t* cache, const char* filename)
+{
+    char *data;
+    size_t size;
+    
+    mycss_cache_clean(cache);
+    
+    mystatus_t status = mycore_file_map_copy(filename, &data, &size);
+    if(status)
+        return status;
+    
+    status = mycss_cache_load_data(cache, data, size);
+    
+    if(status) {
+        mycore_file_unmap(data, size);
+        return status;
+    }
+    
+    cache->is_mapped = true;
+    
+    return MyCSS_STATUS_OK;
+}
+
+mycss_stylesheet_t * mycss_cache_stylesheet(mycss_cache_t* cache)
+{
+    return cache->stylesheet;
+}
@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#ifndef MyHTML_MyCSS_CACHE_H
+#define MyHTML_MyCSS_CACHE_H
+#pragma once
+
+#include "mycss/myosi.h"
+#include "mycss/stylesheet.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Binary image of parsed stylesheet.
+ *
+ * Image is header, copies of all structures of stylesheet (selectors, namespaces, declarations
+ * and values) and list of positions of pointers in image. In the file every pointer is position
+ * from the beginning of image, on load pointers from the list are moved to place of image in memory.
+ * Image depends on layout of structures and is checked by header, it is not portable between builds.
+ *
+ * Loaded stylesheet is read only and has no mycss_entry_t: it can be given to modest finder and
+ * serialization of selectors, but not to parse, clean or destroy functions of mycss.
+ */
+
+#define MyCSS_CACHE_MAGIC "MyCSSbin"
+#define MyCSS_CACHE_VERSION 1
+#define MyCSS_CACHE_ALIGN 8
+#define MyCSS_CACHE_LAYOUT_SIZE 8
+
+struct mycss_cache_header {
+    char magic[8];
+    size_t version;
+    size_t layout[MyCSS_CACHE_LAYOUT_SIZE];
+    
+    size_t size;
+    size_t stylesheet;
+    size_t relocation;
+    size_t relocation_length;
+    
+    /* not 0 after load, image can be moved only once */
+    size_t is_loaded;
+}
+typedef mycss_cache_header_t;
+
+struct mycss_cache {
+    char* data;
+    size_t size;
+    bool is_mapped;
+    
+    mycss_stylesheet_t* stylesheet;
+};
+
+mycss_cache_t * mycss_cache_create(void);
+mystatus_t mycss_cache_init(mycss_cache_t* cache);
+void mycss_cache_clean(mycss_cache_t* cache);
+mycss_cache_t * mycss_cache_destroy(mycss_cache_t* cache, bool self_destroy);
+
+mystatus_t mycss_cache_serialization(mycss_stylesheet_t* stylesheet, mycore_callback_serialize_f callback, void* context);
+mystatus_t mycss_cache_save(mycss_stylesheet_t* stylesheet, const char* filename);
+
+/* data must be writable and aligned to MyCSS_CACHE_ALIGN, it is changed in place and must live while stylesheet is used */
+mystatus_t mycss_cache_load_data(mycss_cache_t* cache, char* data, size_t size);
+mystatus_t mycss_cache_load(mycss_cache_t* cache, const char* filename);
+
+mycss_stylesheet_t * mycss_cache_stylesheet(mycss_cache_t* cache);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* MyHTML_MyCSS_CACHE_H */
@@ -37,6 +37,8 @@ mystatus_t mycss_declaration_init(mycss_entry_t* entry, mycss_declaration_t* dec
     if(declaration->mcobject_entries == NULL)
         return MyCSS_STATUS_ERROR_DECLARATION_ENTRY_CREATE;
     
+    mcobject_allocator_set(declaration->mcobject_entries, entry->mycss->allocator);
+    
     mystatus_t myhtml_status = mcobject_init(declaration->mcobject_entries, 256, sizeof(mycss_declaration_entry_t));
     if(myhtml_status)
         return MyCSS_STATUS_ERROR_DECLARATION_ENTRY_INIT;
@@ -41,6 +41,8 @@ mystatus_t mycss_entry_init(mycss_t* mycss, mycss_entry_t* entry)
     if(entry->mchar == NULL)
         return MyCORE_STATUS_ERROR_MEMORY_ALLOCATION;
     
+    mchar_async_allocator_set(entry->mchar, mycss->allocator);
+    
     if((status = mchar_async_init(entry->mchar, 128, (4096 * 5))))
         return status;
     
@@ -63,6 +65,8 @@ mystatus_t mycss_entry_init(mycss_t* mycss, mycss_entry_t* entry)
     if(entry->mcobject_string_entries == NULL)
         return MyCSS_STATUS_ERROR_STRING_CREATE;
     
+    mcobject_allocator_set(entry->mcobject_string_entries, mycss->allocator);
+    
     mystatus_t myhtml_status = mcobject_init(entry->mcobject_string_entries, 256, sizeof(mycore_string_t));
     if(myhtml_status)
         return MyCSS_STATUS_ERROR_STRING_INIT;
@@ -117,6 +121,8 @@ mystatus_t mycss_entry_init(mycss_t* mycss, mycss_entry_t* entry)
     if(entry->mcobject_incoming_buffer == NULL)
         return MyCSS_STATUS_ERROR_ENTRY_INCOMING_BUFFER_CREATE;
     
+    mcobject_allocator_set(entry->mcobject_incoming_buffer, mycss->allocator);
+    
     myhtml_status = mcobject_init(entry->mcobject_incoming_buffer, 256, sizeof(mycore_incoming_buffer_t));
     if(myhtml_status)
         return MyCSS_STATUS_ERROR_ENTRY_INCOMING_BUFFER_INIT;
@@ -130,6 +136,7 @@ mystatus_t mycss_entry_init(mycss_t* mycss, mycss_entry_t* entry)
 mystatus_t mycss_entry_clean(mycss_entry_t* entry)
 {
     mcobject_clean(entry->mcobject_incoming_buffer);
+    mycss_entry_file_unmap(entry);
     mycss_entry_parser_list_clean(entry->parser_list);
     
     /* CSS Modules */
@@ -155,6 +162,7 @@ mystatus_t mycss_entry_clean(mycss_entry_t* entry)
 mystatus_t mycss_entry_clean_all(mycss_entry_t* entry)
 {
     mcobject_clean(entry->mcobject_incoming_buffer);
+    mycss_entry_file_unmap(entry);
     mchar_async_node_clean(entry->mchar, entry->mchar_node_id);
     mchar_async_node_clean(entry->mchar, entry->mchar_value_node_id);
     
@@ -201,6 +209,7 @@ mycss_entry_t * mycss_entry_destroy(mycss_entry_t* entry, bool self_destroy)
     entry->declaration = mycss_declaration_destroy(entry->declaration, true);
     
     entry->mcobject_incoming_buffer = mcobject_destroy(entry->mcobject_incoming_buffer, true);
+    mycss_entry_file_unmap(entry);
     
     if(entry->token) {
         mycore_free(entry->token);
@@ -215,6 +224,14 @@ mycss_entry_t * mycss_entry_destroy(mycss_entry_t* entry, bool self_destroy)
     return entry;
 }
 
+void mycss_entry_file_unmap(mycss_entry_t* entry)
+{
+    mycore_file_unmap(entry->file_data, entry->file_size);
+    
+    entry->file_data = NULL;
+    entry->file_size = 0;
+}
+
 void mycss_entry_end(mycss_entry_t* entry)
 {
     /* need some code */
@@ -86,6 +86,10 @@ struct mycss_entry {
     mycore_incoming_buffer_t* first_buffer;
     mycore_incoming_buffer_t* current_buffer;
     
+    /* mapping of mycss_parse_file, incoming buffers point to it */
+    const char* file_data;
+    size_t file_size;
+    
     /* options */
     mycss_entry_type_t type;
     myencoding_t encoding;
@@ -116,6 +120,7 @@ mystatus_t mycss_entry_init(mycss_t* mycss, mycss_entry_t* entry);
 mystatus_t mycss_entry_clean(mycss_entry_t* entry);
 mystatus_t mycss_entry_clean_all(mycss_entry_t* entry);
 mycss_entry_t * mycss_entry_destroy(mycss_entry_t* entry, bool self_destroy);
+void mycss_entry_file_unmap(mycss_entry_t* entry);
 
 void mycss_entry_end(mycss_entry_t* entry);
 
@@ -36,6 +36,16 @@ mystatus_t mycss_init(mycss_t* mycss)
     return MyCSS_STATUS_OK;
 }
 
+void mycss_allocator_set(mycss_t* mycss, mcallocator_t* allocator)
+{
+    mycss->allocator = allocator;
+}
+
+mcallocator_t * mycss_allocator(mycss_t* mycss)
+{
+    return mycss->allocator;
+}
+
 mycss_t * mycss_destroy(mycss_t* mycss, bool self_destroy)
 {
     if(mycss == NULL)
@@ -74,6 +84,25 @@ mystatus_t mycss_parse(mycss_entry_t* entry, myencoding_t encoding, const char*
     return status;
 }
 
+mystatus_t mycss_parse_file(mycss_entry_t* entry, myencoding_t encoding, const char* filename)
+{
+    const char *data;
+    size_t size;
+    
+    mystatus_t status = mycore_file_map(filename, &data, &size);
+    
+    if(status)
+        return status;
+    
+    /* previous file is unmapped by clean of entry */
+    status = mycss_parse(entry, encoding, (data ? data : ""), size);
+    
+    entry->file_data = data;
+    entry->file_size = size;
+    
+    return status;
+}
+
 mystatus_t mycss_parse_chunk(mycss_entry_t* entry, const char* css, size_t css_size)
 {
     if(entry->type & MyCSS_ENTRY_TYPE_END) {
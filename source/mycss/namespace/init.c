@@ -32,6 +32,8 @@ mystatus_t mycss_namespace_init(mycss_entry_t* entry, mycss_namespace_t* ns)
     if(ns->mcobject_entries == NULL)
         return MyCSS_STATUS_ERROR_NAMESPACE_ENTRIES_CREATE;
     
+    mcobject_allocator_set(ns->mcobject_entries, entry->mycss->allocator);
+    
     mystatus_t myhtml_status = mcobject_init(ns->mcobject_entries, 256, sizeof(mycss_namespace_entry_t));
     if(myhtml_status)
         return MyCSS_STATUS_ERROR_NAMESPACE_ENTRIES_INIT;
@@ -42,12 +44,17 @@ mystatus_t mycss_namespace_init(mycss_entry_t* entry, mycss_namespace_t* ns)
 void mycss_namespace_clean(mycss_namespace_t* ns)
 {
     ns->entry = NULL;
+    ns->entry_last = NULL;
+    ns->ns_stylesheet = NULL;
 }
 
 mystatus_t mycss_namespace_clean_all(mycss_namespace_t* ns)
 {
     mcobject_clean(ns->mcobject_entries);
+    
     ns->entry = NULL;
+    ns->entry_last = NULL;
+    ns->ns_stylesheet = NULL;
     
     return MyCSS_STATUS_OK;
 }
@@ -0,0 +1,548 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#include "mycss/parallel.h"
+#include "mycss/mycss.h"
+#include "mycss/tokenizer.h"
+#include "mycore/utils.h"
+
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+static void mycss_parallel_stream(mythread_id_t thread_id, void* arg);
+static void mycss_parallel_wait_for_all_done(mycss_parallel_t* parallel);
+#endif
+
+mycss_parallel_t * mycss_parallel_create(void)
+{
+    return (mycss_parallel_t*)mycore_calloc(1, sizeof(mycss_parallel_t));
+}
+
+mystatus_t mycss_parallel_init(mycss_parallel_t* parallel, mycss_t* mycss, size_t thread_count)
+{
+#ifdef MyCORE_BUILD_WITHOUT_THREADS
+    if(thread_count == 0)
+        thread_count = 1;
+#else
+    if(thread_count == 0)
+        thread_count = mythread_cpu_count();
+#endif
+    
+    parallel->mycss          = mycss;
+    parallel->slice_min_size = MyCSS_PARALLEL_SLICE_MIN_SIZE;
+    
+    parallel->slice_list = (mycss_parallel_slice_t*)mycore_calloc(thread_count, sizeof(mycss_parallel_slice_t));
+    if(parallel->slice_list == NULL)
+        return MyCSS_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    mystatus_t status;
+    
+    for(size_t i = 0; i < thread_count; i++) {
+        parallel->slice_list[i].entry = mycss_entry_create();
+        if(parallel->slice_list[i].entry == NULL)
+            return MyCSS_STATUS_ERROR_MEMORY_ALLOCATION;
+        
+        parallel->slice_list_size++;
+        
+        status = mycss_entry_init(mycss, parallel->slice_list[i].entry);
+        if(status)
+            return status;
+    }
+    
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    parallel->thread = mythread_create();
+    if(parallel->thread == NULL)
+        return MyCORE_STATUS_THREAD_ERROR_MEMORY_ALLOCATION;
+    
+    status = mythread_init(parallel->thread, MyTHREAD_TYPE_STREAM, thread_count, 0);
+    if(status) {
+        parallel->thread = mythread_destroy(parallel->thread, NULL, NULL, true);
+        return status;
+    }
+    
+    parallel->thread->context = parallel;
+    
+    for(size_t i = 0; i < thread_count; i++) {
+        status = myhread_entry_create(parallel->thread, mythread_function, mycss_parallel_stream, MyTHREAD_OPT_STOP);
+        if(status)
+            return status;
+    }
+    
+    /* empty first run, thread that never ran does not see quit of destroy */
+    status = mythread_resume(parallel->thread, MyTHREAD_OPT_UNDEF);
+    if(status)
+        return status;
+    
+    mycss_parallel_wait_for_all_done(parallel);
+#endif
+    
+    return MyCSS_STATUS_OK;
+}
+
+void mycss_parallel_clean(mycss_parallel_t* parallel)
+{
+    /* entries after the slices of last parse are clean */
+    for(size_t i = 0; i < parallel->slice_list_length; i++) {
+        mycss_parallel_slice_t *slice = &parallel->slice_list[i];
+        
+        if(slice->entry->stylesheet) {
+            mycss_stylesheet_destroy(slice->entry->stylesheet, true);
+            slice->entry->stylesheet = NULL;
+        }
+        
+        mycss_entry_clean_all(slice->entry);
+        
+        slice->begin     = 0;
+        slice->length    = 0;
+        slice->ns_length = 0;
+        slice->status    = MyCSS_STATUS_OK;
+    }
+    
+    parallel->slice_list_length = 0;
+    parallel->ns_list_length    = 0;
+    parallel->css               = NULL;
+}
+
+mycss_parallel_t * mycss_parallel_destroy(mycss_parallel_t* parallel, bool self_destroy)
+{
+    if(parallel == NULL)
+        return NULL;
+    
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    if(parallel->thread)
+        parallel->thread = mythread_destroy(parallel->thread, mythread_callback_quit, NULL, true);
+#endif
+    
+    if(parallel->slice_list) {
+        mycss_parallel_clean(parallel);
+        
+        for(size_t i = 0; i < parallel->slice_list_size; i++)
+            mycss_entry_destroy(parallel->slice_list[i].entry, true);
+        
+        mycore_free(parallel->slice_list);
+        
+        parallel->slice_list = NULL;
+        parallel->slice_list_size = 0;
+    }
+    
+    if(parallel->ns_list) {
+        mycore_free(parallel->ns_list);
+        
+        parallel->ns_list = NULL;
+        parallel->ns_list_size = 0;
+    }
+    
+    if(self_destroy) {
+        mycore_free(parallel);
+        return NULL;
+    }
+    
+    return parallel;
+}
+
+/*
+ * Pre-scan
+ */
+static bool mycss_parallel_is_space(unsigned char c)
+{
+    return (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f');
+}
+
+static bool mycss_parallel_is_name(unsigned char c)
+{
+    return ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+            c == '-' || c == '_' || c >= 0x80);
+}
+
+/* position after the end, 0 if there is no end */
+static size_t mycss_parallel_skip_comment(const char* css, size_t i, size_t css_size)
+{
+    for(i += 2; (i + 1) < css_size; i++) {
+        if(css[i] == '*' && css[i + 1] == '/')
+            return (i + 2);
+    }
+    
+    return 0;
+}
+
+static size_t mycss_parallel_skip_string(const char* css, size_t i, size_t css_size)
+{
+    char quote = css[i];
+    
+    for(i++; i < css_size; i++) {
+        if(css[i] == quote)
+            return (i + 1);
+        
+        /* bad string, newline is not a part of it */
+        if(css[i] == '\n' || css[i] == '\r' || css[i] == '\f')
+            return i;
+        
+        if(css[i] == '\\')
+            i++;
+    }
+    
+    return 0;
+}
+
+/* unquoted url is one token up to ')', quotes and brackets in it do not count */
+static size_t mycss_parallel_skip_url(const char* css, size_t i, size_t css_size)
+{
+    for(; i < css_size; i++) {
+        if(css[i] == ')')
+            return (i + 1);
+        
+        if(css[i] == '\\')
+            i++;
+    }
+    
+    return 0;
+}
+
+static size_t mycss_parallel_url_unquoted(const char* css, size_t i, size_t css_size)
+{
+    if((i + 4) > css_size || (i && mycss_parallel_is_name((unsigned char)css[i - 1])) ||
+       mycore_strncasecmp(&css[i], "url(", 4))
+    {
+        return 0;
+    }
+    
+    for(i += 4; i < css_size && mycss_parallel_is_space((unsigned char)css[i]); i++) {}
+    
+    if(i < css_size && (css[i] == '"' || css[i] == '\''))
+        return 0;
+    
+    return i;
+}
+
+/* name of at-rule with escapes is taken as namespace, it costs only a repeated parse */
+static bool mycss_parallel_is_namespace(const char* css, size_t i, size_t css_size)
+{
+    size_t begin = i;
+    
+    while(i < css_size && mycss_parallel_is_name((unsigned char)css[i]))
+        i++;
+    
+    if(i < css_size && css[i] == '\\')
+        return true;
+    
+    return ((i - begin) == 9 && mycore_strncasecmp(&css[begin], "namespace", 9) == 0);
+}
+
+static mystatus_t mycss_parallel_ns_push(mycss_parallel_t* parallel, size_t begin, size_t end)
+{
+    if(parallel->ns_list_length >= parallel->ns_list_size) {
+        size_t new_size = (parallel->ns_list_size ? (parallel->ns_list_size * 2) : 16);
+        mycss_parallel_range_t *tmp = mycore_realloc(parallel->ns_list, (sizeof(mycss_parallel_range_t) * new_size));
+        
+        if(tmp == NULL)
+            return MyCSS_STATUS_ERROR_MEMORY_ALLOCATION;
+        
+        parallel->ns_list = tmp;
+        parallel->ns_list_size = new_size;
+    }
+    
+    parallel->ns_list[ parallel->ns_list_length ].begin  = begin;
+    parallel->ns_list[ parallel->ns_list_length ].length = (end - begin);
+    
+    parallel->ns_list_length++;
+    
+    return MyCSS_STATUS_OK;
+}
+
+/*
+ * Slices begin where top-level style rules begin, the next one is taken after the size of the rest
+ * divided by count of slices left. Scan stops on first unbalanced bracket or unterminated token.
+ */
+static mystatus_t mycss_parallel_scan(mycss_parallel_t* parallel, const char* css, size_t css_size, size_t count)
+{
+    size_t i = 0, depth = 0, rule_begin = 0, url_end;
+    size_t target = css_size / count;
+    
+    bool is_rule_begin = true, is_at_rule = false, is_ns = false, is_broken = false;
+    mystatus_t status;
+    
+    parallel->slice_list[0].begin = 0;
+    parallel->slice_list[0].ns_length = 0;
+    parallel->slice_list_length = 1;
+    
+    while(i < css_size && is_broken == false && parallel->slice_list_length < count)
+    {
+        unsigned char c = (unsigned char)css[i];
+        
+        if(c == '/' && (i + 1) < css_size && css[i + 1] == '*') {
+            i = mycss_parallel_skip_comment(css, i, css_size);
+            is_broken = (i == 0);
+            
+            continue;
+        }
+        
+        if(mycss_parallel_is_space(c)) {
+            i++;
+            continue;
+        }
+        
+        if(is_rule_begin && depth == 0)
+        {
+            is_rule_begin = false;
+            is_at_rule    = (c == '@');
+            rule_begin    = i;
+            
+            if(is_at_rule) {
+                is_ns = mycss_parallel_is_namespace(css, (i + 1), css_size);
+            }
+            else if(i >= target) {
+                mycss_parallel_slice_t *slice = &parallel->slice_list[ parallel->slice_list_length ];
+                
+                slice->begin     = i;
+                slice->ns_length = parallel->ns_list_length;
+                
+                parallel->slice_list_length++;
+                
+                target = i + ((css_size - i) / ((count - parallel->slice_list_length) + 1));
+            }
+        }
+        
+        switch (c) {
+            case '"':
+            case '\'':
+                i = mycss_parallel_skip_string(css, i, css_size);
+                is_broken = (i == 0);
+                
+                continue;
+                
+            case '\\':
+                i += 2;
+                continue;
+                
+            case 'u':
+            case 'U':
+                if((url_end = mycss_parallel_url_unquoted(css, i, css_size))) {
+                    i = mycss_parallel_skip_url(css, url_end, css_size);
+                    is_broken = (i == 0);
+                    
+                    continue;
+                }
+                
+                break;
+                
+            case '{':
+            case '(':
+            case '[':
+                depth++;
+                break;
+                
+            case '}':
+                if(depth == 0) {
+                    is_broken = true;
+                    continue;
+                }
+                
+                depth--;
+                
+                if(depth == 0) {
+                    if(is_at_rule && is_ns) {
+                        if((status = mycss_parallel_ns_push(parallel, rule_begin, (i + 1))))
+                            return status;
+                    }
+                    
+                    is_rule_begin = true;
+                }
+                
+                break;
+                
+            case ')':
+            case ']':
+                if(depth == 0) {
+                    is_broken = true;
+                    continue;
+                }
+                
+                depth--;
+                break;
+                
+            case ';':
+                /* in prelude of style rule it is not the end */
+                if(depth == 0 && is_at_rule) {
+                    if(is_ns) {
+                        if((status = mycss_parallel_ns_push(parallel, rule_begin, (i + 1))))
+                            return status;
+                    }
+                    
+                    is_rule_begin = true;
+                }
+                
+                break;
+                
+            default:
+                break;
+        }
+        
+        i++;
+    }
+    
+    for(i = 0; i < parallel->slice_list_length; i++) {
+        mycss_parallel_slice_t *slice = &parallel->slice_list[i];
+        
+        if((i + 1) < parallel->slice_list_length)
+            slice->length = parallel->slice_list[(i + 1)].begin - slice->begin;
+        else
+            slice->length = css_size - slice->begin;
+    }
+    
+    return MyCSS_STATUS_OK;
+}
+
+/*
+ * Parse
+ */
+static void mycss_parallel_parse_slice(mycss_parallel_t* parallel, mycss_parallel_slice_t* slice)
+{
+    mycss_entry_t *entry = slice->entry;
+    
+    entry->parser = mycss_parser_token;
+    entry->stylesheet = mycss_stylesheet_create();
+    
+    if(entry->stylesheet == NULL) {
+        slice->status = MyCSS_STATUS_ERROR_MEMORY_ALLOCATION;
+        return;
+    }
+    
+    if((slice->status = mycss_stylesheet_init(entry->stylesheet, entry)))
+        return;
+    
+    mycss_encoding_set(entry, parallel->encoding);
+    
+    for(size_t i = 0; i < slice->ns_length; i++) {
+        mycss_parallel_range_t *range = &parallel->ns_list[i];
+        
+        if((slice->status = mycss_tokenizer_chunk(entry, &parallel->css[range->begin], range->length)))
+            return;
+    }
+    
+    if((slice->status = mycss_tokenizer_chunk(entry, &parallel->css[slice->begin], slice->length)))
+        return;
+    
+    slice->status = mycss_tokenizer_end(entry);
+}
+
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+static void mycss_parallel_stream(mythread_id_t thread_id, void* arg)
+{
+    mythread_context_t *ctx = (mythread_context_t*)arg;
+    mycss_parallel_t *parallel = (mycss_parallel_t*)ctx->mythread->context;
+    
+    if(ctx->id < parallel->slice_list_length)
+        mycss_parallel_parse_slice(parallel, &parallel->slice_list[ctx->id]);
+}
+
+static void mycss_parallel_wait_for_all_done(mycss_parallel_t* parallel)
+{
+    mythread_t *mythread = parallel->thread;
+    
+    for (size_t idx = 0; idx < mythread->entries_length; idx++) {
+        mythread_cond_wait_while(mythread, mythread->cond,
+                                 (mythread->entries[idx].context.opt & MyTHREAD_OPT_DONE) == 0);
+    }
+}
+#endif
+
+/* selector lists of slices are joined after the lists of first slice */
+static void mycss_parallel_join(mycss_parallel_t* parallel)
+{
+    mycss_stylesheet_t *stylesheet = parallel->slice_list[0].entry->stylesheet;
+    mycss_selectors_list_t *last = stylesheet->sel_list_first;
+    
+    while(last && last->next)
+        last = last->next;
+    
+    for(size_t i = 1; i < parallel->slice_list_length; i++)
+    {
+        mycss_selectors_list_t *first = parallel->slice_list[i].entry->stylesheet->sel_list_first;
+        
+        if(first == NULL)
+            continue;
+        
+        if(last) {
+            last->next  = first;
+            first->prev = last;
+        }
+        else
+            stylesheet->sel_list_first = first;
+        
+        last = first;
+        
+        while(last->next)
+            last = last->next;
+    }
+}
+
+mystatus_t mycss_parallel_parse(mycss_parallel_t* parallel, myencoding_t encoding, const char* css, size_t css_size)
+{
+    mycss_parallel_clean(parallel);
+    
+    parallel->css      = css;
+    parallel->encoding = encoding;
+    
+    size_t count = (parallel->slice_min_size ? (css_size / parallel->slice_min_size) : css_size);
+    
+    if(count > parallel->slice_list_size)
+        count = parallel->slice_list_size;
+    
+    /* UTF-16 is parsed as UTF-8 by tokenizer */
+    if(count == 0 || (encoding != MyENCODING_UTF_8 && encoding != MyENCODING_UTF_16LE && encoding != MyENCODING_UTF_16BE))
+        count = 1;
+    
+    mystatus_t status = mycss_parallel_scan(parallel, css, css_size, count);
+    if(status)
+        return status;
+    
+#ifdef MyCORE_BUILD_WITHOUT_THREADS
+    for(size_t i = 0; i < parallel->slice_list_length; i++)
+        mycss_parallel_parse_slice(parallel, &parallel->slice_list[i]);
+#else
+    if(parallel->slice_list_length == 1) {
+        mycss_parallel_parse_slice(parallel, &parallel->slice_list[0]);
+    }
+    else {
+        mythread_resume(parallel->thread, MyTHREAD_OPT_UNDEF);
+        mycss_parallel_wait_for_all_done(parallel);
+    }
+#endif
+    
+    for(size_t i = 0; i < parallel->slice_list_length; i++) {
+        if(parallel->slice_list[i].status)
+            return parallel->slice_list[i].status;
+    }
+    
+    mycss_parallel_join(parallel);
+    
+    return MyCSS_STATUS_OK;
+}
+
+mycss_stylesheet_t * mycss_parallel_stylesheet(mycss_parallel_t* parallel)
+{
+    if(parallel->slice_list_length == 0)
+        return NULL;
+    
+    return parallel->slice_list[0].entry->stylesheet;
+}
+
+size_t mycss_parallel_slice_count(mycss_parallel_t* parallel)
+{
+    return parallel->slice_list_length;
+}
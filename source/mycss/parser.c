@@ -52,6 +52,12 @@ bool mycss_parser_token(mycss_entry_t* entry, mycss_token_t* token, bool last_re
                 ns->ns_stylesheet = &entry->stylesheet->ns_stylesheet;
                 ns->entry = &ns->ns_stylesheet->entry_first;
                 
+                /* append to entries of this stylesheet, not of the previous one parsed by entry */
+                ns->entry_last = ns->ns_stylesheet->entry_first;
+                
+                while(ns->entry_last && ns->entry_last->next)
+                    ns->entry_last = ns->entry_last->next;
+                
                 entry->parser = mycss_namespace_state_namespace_namespace;
             }
             else {
@@ -1310,6 +1310,9 @@ bool mycss_property_parser_color(mycss_entry_t* entry, mycss_token_t* token, boo
         return mycss_property_parser_destroy_string(&str, mycss_property_shared_switch_to_find_important(entry));
     }
     
+    if(mycss_property_shared_default(entry, token, &dec_entry->value_type, &str))
+        return mycss_property_parser_destroy_string(&str, mycss_property_shared_switch_to_find_important(entry));
+    
     return mycss_property_parser_destroy_string(&str, mycss_property_shared_switch_to_parse_error(entry));
 }
 
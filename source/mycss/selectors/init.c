@@ -40,6 +40,8 @@ mystatus_t mycss_selectors_init(mycss_entry_t* entry, mycss_selectors_t* selecto
     if(selectors->mcobject_entries == NULL)
         return MyCSS_STATUS_ERROR_SELECTORS_ENTRIES_CREATE;
     
+    mcobject_allocator_set(selectors->mcobject_entries, entry->mycss->allocator);
+    
     mystatus_t myhtml_status = mcobject_init(selectors->mcobject_entries, 256, sizeof(mycss_selectors_entry_t));
     if(myhtml_status)
         return MyCSS_STATUS_ERROR_SELECTORS_ENTRIES_INIT;
@@ -49,6 +51,8 @@ mystatus_t mycss_selectors_init(mycss_entry_t* entry, mycss_selectors_t* selecto
     if(selectors->mcobject_list_entries == NULL)
         return MyCSS_STATUS_ERROR_SELECTORS_LIST_CREATE;
     
+    mcobject_allocator_set(selectors->mcobject_list_entries, entry->mycss->allocator);
+    
     myhtml_status = mcobject_init(selectors->mcobject_list_entries, 256, sizeof(mycss_selectors_list_t));
     if(myhtml_status)
         return MyCSS_STATUS_ERROR_SELECTORS_LIST_INIT;
@@ -21,6 +21,7 @@
 #include "myencoding/encoding.h"
 #include "myencoding/detect_resource.h"
 #include "mycore/utils/resources.h"
+#include "mycore/utils/mcscan.h"
 
 myencoding_trigram_result_t myencoding_detect_by_trigram(unsigned const char *u_text, size_t length,
                                                                    const myencoding_trigram_t *list, size_t list_length,
@@ -77,11 +78,27 @@ bool myencoding_detect_unicode_has_end(myencoding_unicode_result_t *res, size_t
 
 myencoding_unicode_result_t myencoding_detect_utf_8(unsigned const char *u_text, size_t length)
 {
-    size_t i = 0;
+    size_t i = 0, scan_from = 0;
     myencoding_unicode_result_t res = {0, 0, 0};
     
     while(i < length)
     {
+        /*
+         * Well-formed text is counted by blocks; block must end before the last byte,
+         * a character which ends with the text is not counted.
+         * After a bad block go by characters for a while.
+         */
+        if(i >= scan_from) {
+            size_t next = mcscan_utf_8((const char*)u_text, i, (length - 1), &res.count_ascii, &res.count_good);
+            
+            if(next != i) {
+                i = next;
+                continue;
+            }
+            
+            scan_from = i + 32;
+        }
+        
         if((u_text[i] & 0x80) == 0x00) {
             i++;
             res.count_ascii++;
@@ -140,22 +157,24 @@ myencoding_unicode_result_t myencoding_detect_utf_16(unsigned const char *u_text
     
     while(i < length)
     {
-        if(u_text[i] == 0x00) {
-            if((i % 2) == 0) {
-                i++;
-                
-                if(u_text[i] > 0x1F && u_text[i] < 0x7F)
-                    res.count_bad++;
-            }
-            else {
-                if(u_text[(i - 1)] > 0x1F && u_text[(i - 1)] < 0x7F)
-                    res.count_good++;
-                
-                i++;
-            }
+        /* only zero bytes are interesting */
+        i = mcscan_char((const char*)u_text, i, length, 0x00);
+        
+        if(i >= length)
+            break;
+        
+        if((i % 2) == 0) {
+            i++;
+            
+            if(i < length && u_text[i] > 0x1F && u_text[i] < 0x7F)
+                res.count_bad++;
         }
-        else
+        else {
+            if(u_text[(i - 1)] > 0x1F && u_text[(i - 1)] < 0x7F)
+                res.count_good++;
+            
             i++;
+        }
     }
     
     return res;
@@ -21,6 +21,7 @@
 #include "myencoding/encoding.h"
 #include "myencoding/resource.h"
 #include "mycore/utils/resources.h"
+#include "mycore/utils/mcscan.h"
 
 myencoding_custom_f myencoding_get_function_by_id(myencoding_t idx)
 {
@@ -421,6 +422,8 @@ myencoding_status_t myencoding_decode_gb18030(unsigned const char data, myencodi
             res->result = myencoding_index_gb18030_ranges_code_point((((res->first - 0x81) * 10 + res->second - 0x30) *
                                                                           126 + res->third - 0x81) * 10 + data - 0x30);
         }
+        else
+            res->result = 0;
         
         res->first  = 0;
         res->second = 0;
@@ -791,15 +794,18 @@ myencoding_status_t myencoding_decode_shift_jis(unsigned const char data, myenco
     
     if(res->first)
     {
+        unsigned long lead = res->first;
         unsigned long offset;
         unsigned long lead_offset;
         
+        res->first = 0x00;
+        
         if(data < 0x7F)
             offset = 0x40;
         else
             offset = 0x41;
         
-        if(res->first < 0xA0)
+        if(lead < 0xA0)
             lead_offset = 0x81;
         else
             lead_offset = 0xC1;
@@ -808,7 +814,7 @@ myencoding_status_t myencoding_decode_shift_jis(unsigned const char data, myenco
         if((data >= 0x40 && data <= 0x7E) ||
            (data >= 0x80 && data <= 0xFC))
         {
-            pointer = (res->first - lead_offset) * 188 + data - offset;
+            pointer = (lead - lead_offset) * 188 + data - offset;
         }
         
         if(pointer)
@@ -860,6 +866,8 @@ myencoding_status_t myencoding_decode_euc_kr(unsigned const char data, myencodin
         
         if(pointer)
             res->result = myencoding_map_euc_kr[pointer];
+        else
+            res->result = 0x00;
         
         if(res->result)
             return MyENCODING_STATUS_OK;
@@ -1202,6 +1210,139 @@ size_t myencoding_codepoint_to_ascii_utf_16(size_t codepoint, char *data)
     return 2;
 }
 
+/*
+ * Bulk decoding.
+ * Single byte encodings are decoded by their maps without calls,
+ * for ASCII compatible encodings runs of ASCII are copied as is while decoder is in ground state.
+ */
+static const unsigned long * myencoding_single_byte_map_index[MyENCODING_LAST_ENTRY] =
+{
+    [MyENCODING_IBM866]         = myencoding_map_ibm866,
+    [MyENCODING_ISO_8859_2]     = myencoding_map_iso_8859_2,
+    [MyENCODING_ISO_8859_3]     = myencoding_map_iso_8859_3,
+    [MyENCODING_ISO_8859_4]     = myencoding_map_iso_8859_4,
+    [MyENCODING_ISO_8859_5]     = myencoding_map_iso_8859_5,
+    [MyENCODING_ISO_8859_6]     = myencoding_map_iso_8859_6,
+    [MyENCODING_ISO_8859_7]     = myencoding_map_iso_8859_7,
+    [MyENCODING_ISO_8859_8]     = myencoding_map_iso_8859_8,
+    [MyENCODING_ISO_8859_8_I]   = myencoding_map_iso_8859_8,
+    [MyENCODING_ISO_8859_10]    = myencoding_map_iso_8859_10,
+    [MyENCODING_ISO_8859_13]    = myencoding_map_iso_8859_13,
+    [MyENCODING_ISO_8859_14]    = myencoding_map_iso_8859_14,
+    [MyENCODING_ISO_8859_15]    = myencoding_map_iso_8859_15,
+    [MyENCODING_ISO_8859_16]    = myencoding_map_iso_8859_16,
+    [MyENCODING_KOI8_R]         = myencoding_map_koi8_r,
+    [MyENCODING_KOI8_U]         = myencoding_map_koi8_u,
+    [MyENCODING_MACINTOSH]      = myencoding_map_macintosh,
+    [MyENCODING_WINDOWS_874]    = myencoding_map_windows_874,
+    [MyENCODING_WINDOWS_1250]   = myencoding_map_windows_1250,
+    [MyENCODING_WINDOWS_1251]   = myencoding_map_windows_1251,
+    [MyENCODING_WINDOWS_1252]   = myencoding_map_windows_1252,
+    [MyENCODING_WINDOWS_1253]   = myencoding_map_windows_1253,
+    [MyENCODING_WINDOWS_1254]   = myencoding_map_windows_1254,
+    [MyENCODING_WINDOWS_1255]   = myencoding_map_windows_1255,
+    [MyENCODING_WINDOWS_1256]   = myencoding_map_windows_1256,
+    [MyENCODING_WINDOWS_1257]   = myencoding_map_windows_1257,
+    [MyENCODING_WINDOWS_1258]   = myencoding_map_windows_1258,
+    [MyENCODING_X_MAC_CYRILLIC] = myencoding_map_x_mac_cyrillic
+};
+
+/* decoder gives ASCII bytes as is in current state */
+static bool myencoding_decode_ascii_is_ground(myencoding_t encoding, myencoding_result_t *res)
+{
+    switch (encoding) {
+        case MyENCODING_UTF_8:
+            return (res->flag == 0);
+        case MyENCODING_BIG5:
+        case MyENCODING_EUC_JP:
+        case MyENCODING_EUC_KR:
+        case MyENCODING_GB18030:
+        case MyENCODING_GBK:
+        case MyENCODING_SHIFT_JIS:
+            return (res->first == 0);
+        case MyENCODING_X_USER_DEFINED:
+            return true;
+        default:
+            /* UTF-16 and ISO-2022-JP */
+            return false;
+    }
+}
+
+size_t myencoding_decode_chunk_to_ascii_utf_8(myencoding_t encoding, myencoding_result_t *res,
+                                              const char* buff, size_t length, size_t* offset,
+                                              char* out, size_t out_size)
+{
+    unsigned const char* u_buff = (unsigned const char*)buff;
+    size_t i = *offset, out_length = 0;
+    
+    if(encoding >= MyENCODING_LAST_ENTRY)
+        return 0;
+    
+    const unsigned long *map = myencoding_single_byte_map_index[encoding];
+    
+    if(map)
+    {
+        while(i < length && (out_size - out_length) >= 4)
+        {
+            if(u_buff[i] <= 0x7F) {
+                size_t end = mcscan_not_ascii(buff, i, length);
+                
+                if((end - i) > (out_size - out_length))
+                    end = i + (out_size - out_length);
+                
+                memcpy(&out[out_length], &buff[i], (end - i));
+                
+                out_length += end - i;
+                i = end;
+                
+                continue;
+            }
+            
+            out_length += myencoding_codepoint_to_ascii_utf_8(map[(u_buff[i] - 0x80)], &out[out_length]);
+            i++;
+        }
+        
+        *offset = i;
+        return out_length;
+    }
+    
+    const myencoding_custom_f func = myencoding_get_function_by_id(encoding);
+    
+    while(i < length && (out_size - out_length) >= 4)
+    {
+        if(u_buff[i] <= 0x7F && myencoding_decode_ascii_is_ground(encoding, res)) {
+            size_t end = mcscan_not_ascii(buff, i, length);
+            
+            if((end - i) > (out_size - out_length))
+                end = i + (out_size - out_length);
+            
+            memcpy(&out[out_length], &buff[i], (end - i));
+            
+            out_length += end - i;
+            i = end;
+            
+            continue;
+        }
+        
+        myencoding_status_t status = func(u_buff[i], res);
+        
+        if(status == MyENCODING_STATUS_OK) {
+            out_length += myencoding_codepoint_to_ascii_utf_8(res->result, &out[out_length]);
+        }
+        else if(status == MyENCODING_STATUS_ERROR && u_buff[i] <= 0x7F &&
+                myencoding_decode_ascii_is_ground(encoding, res))
+        {
+            /* ASCII byte after broken lead is not eaten, it is decoded again (prepend byte in the Encoding Standard) */
+            continue;
+        }
+        
+        i++;
+    }
+    
+    *offset = i;
+    return out_length;
+}
+
 size_t myencoding_convert_to_ascii_utf_8(mycore_string_raw_t* raw_str, const char* buff, size_t length, myencoding_t encoding)
 {
     if(raw_str->data == NULL) {
@@ -1215,27 +1356,24 @@ size_t myencoding_convert_to_ascii_utf_8(mycore_string_raw_t* raw_str, const cha
     
     myencoding_result_t res = {0};
     
-    unsigned const char* u_buff = (unsigned const char*)buff;
-    const myencoding_custom_f func = myencoding_get_function_by_id(encoding);
-    
-    size_t i;
-    for (i = 0; i < length; i++)
+    size_t i = 0;
+    while(i < length)
     {
-        if(func(u_buff[i], &res) == MyENCODING_STATUS_OK) {
-            if((raw_str->length + 6) >= raw_str->size) {
-                size_t new_size = raw_str->length + 6 + (length / 2);
-                char *new_data  = mycore_realloc(raw_str->data, sizeof(char) * new_size);
-                
-                if(new_data == NULL) {
-                    return 0;
-                }
-                
-                raw_str->data = new_data;
-                raw_str->size = new_size;
+        if((raw_str->length + 6) >= raw_str->size) {
+            size_t new_size = raw_str->length + 6 + (length / 2);
+            char *new_data  = mycore_realloc(raw_str->data, sizeof(char) * new_size);
+            
+            if(new_data == NULL) {
+                return 0;
             }
             
-            raw_str->length += myencoding_codepoint_to_ascii_utf_8(res.result, &raw_str->data[raw_str->length]);
+            raw_str->data = new_data;
+            raw_str->size = new_size;
         }
+        
+        raw_str->length += myencoding_decode_chunk_to_ascii_utf_8(encoding, &res, buff, length, &i,
+                                                                  &raw_str->data[raw_str->length],
+                                                                  (raw_str->size - raw_str->length - 1));
     }
     
     return i;
@@ -31,15 +31,15 @@ void myencoding_string_append(mycore_string_t* str, const char* buff, size_t len
 
 void myencoding_string_append_chunk(mycore_string_t* str, myencoding_result_t* res, const char* buff, size_t length, myencoding_t encoding)
 {
-    unsigned const char* u_buff = (unsigned const char*)buff;
-    const myencoding_custom_f func = myencoding_get_function_by_id(encoding);
+    size_t offset = 0;
     
-    for (size_t i = 0; i < length; i++)
+    while(offset < length)
     {
-        if(func(u_buff[i], res) == MyENCODING_STATUS_OK) {
-            MyCORE_STRING_REALLOC_IF_NEED(str, 5, 0);
-            str->length += myencoding_codepoint_to_ascii_utf_8(res->result, &str->data[str->length]);
-        }
+        /* enough for the rest if it is ASCII, else decoder stops and we come back */
+        MyCORE_STRING_REALLOC_IF_NEED(str, ((length - offset) + 5), 0);
+        
+        str->length += myencoding_decode_chunk_to_ascii_utf_8(encoding, res, buff, length, &offset,
+                                                              &str->data[str->length], (str->size - str->length - 1));
     }
     
     MyCORE_STRING_APPEND_BYTE_WITHOUT_INCREMENT('\0', str, 1);
@@ -66,4 +66,14 @@ void myhtml_callback_tree_node_remove_set(myhtml_tree_t *tree, myhtml_callback_t
     tree->callback_tree_node_remove_ctx = ctx;
 }
 
+myhtml_callback_tree_node_prune_f myhtml_callback_tree_node_prune(myhtml_tree_t *tree)
+{
+    return tree->callback_tree_node_prune;
+}
+
+void myhtml_callback_tree_node_prune_set(myhtml_tree_t *tree, myhtml_callback_tree_node_prune_f func, void* ctx)
+{
+    tree->callback_tree_node_prune = func;
+    tree->callback_tree_node_prune_ctx = ctx;
+}
 
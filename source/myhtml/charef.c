@@ -21,38 +21,69 @@
 #include "myhtml/charef.h"
 #include "myhtml/charef_resource.h"
 
+#if defined(__GNUC__) || defined(__clang__)
+#define myhtml_charef_popcount(bits) ((size_t)__builtin_popcountll(bits))
+#else
+static size_t myhtml_charef_popcount(unsigned long long bits)
+{
+    size_t count = 0;
+    
+    while(bits) {
+        bits &= bits - 1;
+        count++;
+    }
+    
+    return count;
+}
+#endif
+
+/*
+ * Child of entry by character without scan of siblings:
+ * index of child is count of children with less characters.
+ */
+static const charef_entry_t * myhtml_charef_child(const charef_entry_t *entry, unsigned char ch)
+{
+    unsigned char cls = named_character_references_class[ch];
+    
+    if(cls == 0xff || (entry->children & (1ULL << cls)) == 0)
+        return NULL;
+    
+    return &named_character_references[ entry->next + myhtml_charef_popcount(entry->children & ((1ULL << cls) - 1ULL)) ];
+}
+
 const charef_entry_t * myhtml_charef_find(const char *begin, size_t *offset, size_t size, size_t *data_size)
 {
     unsigned const char* u_begin = (unsigned const char*)begin;
-    size_t pos = (size_t)(*u_begin);
+    const charef_entry_t *entry = &named_character_references[ *u_begin ];
+    
+    if(entry->ch == '\0' || entry->ch != u_begin[*offset]) {
+        if(data_size)
+            *data_size = entry->codepoints_len;
+        
+        return entry;
+    }
     
-    while (named_character_references[pos].ch)
+    for(;;)
     {
-        if(named_character_references[pos].ch == u_begin[*offset])
-        {
-            (*offset)++;
-            
-            if(named_character_references[pos].next == 0 || *offset >= size) {
-                if(data_size)
-                    *data_size = named_character_references[pos].codepoints_len;
-                
-                return &named_character_references[pos];
-            }
-            
-            pos = named_character_references[pos].next;
-        }
-        else if(u_begin[*offset] > named_character_references[pos].ch) {
-            pos++;
-        }
-        else {
+        (*offset)++;
+        
+        if(entry->next == 0 || *offset >= size)
+            break;
+        
+        const charef_entry_t *child = myhtml_charef_child(entry, u_begin[*offset]);
+        
+        if(child == NULL) {
+            entry = &named_character_references[0];
             break;
         }
+        
+        entry = child;
     }
     
     if(data_size)
-        *data_size = named_character_references[pos].codepoints_len;
+        *data_size = entry->codepoints_len;
     
-    return &named_character_references[pos];
+    return entry;
 }
 
 const charef_entry_t * myhtml_charef_get_first_position(const char begin)
@@ -79,63 +110,59 @@ const charef_entry_t * myhtml_charef_find_by_pos(size_t pos, const char *begin,
     
     result->is_done = 0;
     
-    while (named_character_references[pos].ch)
+    const charef_entry_t *entry;
+    
+    while((entry = myhtml_charef_child(&named_character_references[pos], u_begin[*offset])))
     {
-        if(named_character_references[pos].ch == u_begin[*offset])
-        {
-            if(u_begin[*offset] == ';') {
-                result->is_done = 1;
-                
-                result->curr_entry = &named_character_references[pos];
-                return result->curr_entry;
-            }
+        if(u_begin[*offset] == ';') {
+            result->is_done = 1;
             
-            (*offset)++;
-            
-            if(named_character_references[pos].next == 0) {
-                result->is_done = 1;
-                return &named_character_references[pos];
-            }
+            result->curr_entry = entry;
+            return result->curr_entry;
+        }
+        
+        (*offset)++;
+        result->curr_length++;
+        
+        if(entry->next == 0) {
+            result->is_done = 1;
+            return entry;
+        }
+        
+        if(*offset >= size)
+        {
+            result->curr_entry = entry;
             
-            if(*offset >= size)
-            {
-                result->curr_entry = &named_character_references[pos];
-                
-                if(named_character_references[pos].codepoints_len) {
-                    result->last_offset = *offset;
-                    result->last_entry = &named_character_references[pos];
-                }
-                
-                return result->curr_entry;
+            if(entry->codepoints_len) {
+                result->last_offset = *offset;
+                result->last_length = result->curr_length;
+                result->last_entry = entry;
             }
             
-            if(u_begin[*offset] == '&') {
-                result->is_done = 1;
-                result->curr_entry = &named_character_references[pos];
-                
-                if(result->curr_entry->codepoints_len)
-                    return result->curr_entry;
-                else if(result->last_entry) {
-                    *offset = result->last_offset;
-                    return result->last_entry;
-                }
-                
-                return &named_character_references[0];
-            }
+            return result->curr_entry;
+        }
+        
+        if(u_begin[*offset] == '&') {
+            result->is_done = 1;
+            result->curr_entry = entry;
             
-            if(named_character_references[pos].codepoints_len) {
-                result->last_offset = *offset;
-                result->last_entry = &named_character_references[pos];
+            if(result->curr_entry->codepoints_len)
+                return result->curr_entry;
+            else if(result->last_entry) {
+                *offset = result->last_offset;
+                return result->last_entry;
             }
             
-            pos = named_character_references[pos].next;
-        }
-        else if(u_begin[*offset] > named_character_references[pos].ch) {
-            pos++;
+            return &named_character_references[0];
         }
-        else {
-            break;
+        
+        if(entry->codepoints_len) {
+            result->last_offset = *offset;
+            result->last_length = result->curr_length;
+            result->last_entry = entry;
         }
+        
+        pos = entry->cur_pos;
     }
     
     result->is_done = 1;
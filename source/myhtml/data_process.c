@@ -118,6 +118,7 @@ size_t myhtml_data_process_state_ampersand(myhtml_data_process_entry_t* proc_ent
     }
     else {
         proc_entry->charef_res.last_entry = NULL;
+        proc_entry->charef_res.curr_length = 0;
         proc_entry->charef_res.curr_entry = myhtml_charef_get_first_position(data[offset]);
         
         if(proc_entry->charef_res.curr_entry->ch == '\0')
@@ -137,7 +138,7 @@ size_t myhtml_data_process_state_ampersand_data(myhtml_data_process_entry_t* pro
 {
     size_t tmp_offset = offset;
     
-    const charef_entry_t *current_entry = myhtml_charef_find_by_pos(proc_entry->charef_res.curr_entry->next, data, &offset, size, &proc_entry->charef_res);
+    const charef_entry_t *current_entry = myhtml_charef_find_by_pos(proc_entry->charef_res.curr_entry->cur_pos, data, &offset, size, &proc_entry->charef_res);
     
     if(proc_entry->charef_res.is_done) {
         proc_entry->state = myhtml_data_process_state_data;
@@ -298,13 +299,24 @@ void myhtml_data_process_end(myhtml_data_process_entry_t* proc_entry, mycore_str
     {
         const charef_entry_t *entry = proc_entry->charef_res.last_entry;
         
+        /* characters after the longest name are kept: "&noti" is "&not;" and "i"; "&" and first character are in str too */
+        size_t tail_pos = proc_entry->tmp_str_pos + proc_entry->charef_res.last_length + 2;
+        size_t tail_length = (str->length > tail_pos ? (str->length - tail_pos) : 0);
+        
+        /* if current charef is atrribute, name followed by alphanumeric is not reference */
+        if(proc_entry->is_attributes && tail_length)
+            return;
+        
         for (size_t i = 0; i < entry->codepoints_len; i++) {
             MyCORE_STRING_REALLOC_IF_NEED(str, 5, 0);
             
             proc_entry->tmp_str_pos += myencoding_codepoint_to_ascii_utf_8(entry->codepoints[i], &str->data[proc_entry->tmp_str_pos]);
         }
         
-        str->length = proc_entry->tmp_str_pos;
+        /* legacy names without semicolon are not shorter than their characters in UTF-8 */
+        memmove(&str->data[proc_entry->tmp_str_pos], &str->data[tail_pos], tail_length);
+        
+        str->length = proc_entry->tmp_str_pos + tail_length;
         str->data[str->length] = '\0';
     }
     else if(proc_entry->state == myhtml_data_process_state_ampersand_hash_data) {
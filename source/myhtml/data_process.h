@@ -49,6 +49,9 @@ struct myhtml_data_process_entry {
     /* settings */
     bool is_attributes;
     bool emit_null_char;
+    
+    /* incoming buffer to begin search of data, NULL for the first */
+    mycore_incoming_buffer_t* inc_buf;
 };
 
 void myhtml_data_process_entry_clean(myhtml_data_process_entry_t* proc_entry);
@@ -0,0 +1,723 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#include "myhtml/index.h"
+#include "mycore/utils/resources.h"
+
+#define MyHTML_INDEX_LIST_SIZE 16
+#define MyHTML_INDEX_MHASH_SIZE 1024
+#define MyHTML_INDEX_MHASH_DEPTH 16
+
+myhtml_index_t * myhtml_index_create(void)
+{
+    return (myhtml_index_t*)mycore_calloc(1, sizeof(myhtml_index_t));
+}
+
+static mycore_utils_mhash_t * myhtml_index_mhash_create(mystatus_t* status)
+{
+    mycore_utils_mhash_t* mhash = mycore_utils_mhash_create();
+    
+    if(mhash == NULL) {
+        *status = MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+        return NULL;
+    }
+    
+    if((*status = mycore_utils_mhash_init(mhash, MyHTML_INDEX_MHASH_SIZE, MyHTML_INDEX_MHASH_DEPTH)))
+        return mycore_utils_mhash_destroy(mhash, true);
+    
+    return mhash;
+}
+
+mystatus_t myhtml_index_init(myhtml_index_t* index, myhtml_tree_t* tree)
+{
+    mystatus_t status = MyHTML_STATUS_OK;
+    
+    index->tree      = tree;
+    index->tags_size = tree->tags->tags_count;
+    index->tags      = (myhtml_index_list_t*)mycore_calloc(index->tags_size, sizeof(myhtml_index_list_t));
+    
+    if(index->tags == NULL)
+        return MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    if((index->keys = myhtml_index_mhash_create(&status)) == NULL)
+        return status;
+    
+    if((index->ids = myhtml_index_mhash_create(&status)) == NULL)
+        return status;
+    
+    if((index->classes = myhtml_index_mhash_create(&status)) == NULL)
+        return status;
+    
+    index->lists_obj = mcobject_create();
+    if(index->lists_obj == NULL)
+        return MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    mcobject_allocator_set(index->lists_obj, tree->myhtml->allocator);
+    
+    if((status = mcobject_init(index->lists_obj, 256, sizeof(myhtml_index_list_t))))
+        return status;
+    
+    index->buf_size = 128;
+    index->buf = (char*)mycore_malloc(index->buf_size);
+    
+    if(index->buf == NULL)
+        return MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    myhtml_index_clean(index);
+    
+    return MyHTML_STATUS_OK;
+}
+
+static void myhtml_index_mhash_lists_free(mycore_utils_mhash_t* mhash)
+{
+    if(mhash == NULL)
+        return;
+    
+    for(size_t i = 0; i < mhash->table_size; i++) {
+        mycore_utils_mhash_entry_t* entry = mhash->table[i];
+        
+        while(entry) {
+            myhtml_index_list_t* list = (myhtml_index_list_t*)entry->value;
+            
+            if(list)
+                mycore_free(list->list);
+            
+            entry = entry->next;
+        }
+    }
+}
+
+static void myhtml_index_attrs_clean(myhtml_index_t* index)
+{
+    myhtml_index_mhash_lists_free(index->keys);
+    myhtml_index_mhash_lists_free(index->ids);
+    myhtml_index_mhash_lists_free(index->classes);
+    
+    mycore_utils_mhash_clean(index->keys);
+    mycore_utils_mhash_clean(index->ids);
+    mycore_utils_mhash_clean(index->classes);
+    
+    mcobject_clean(index->lists_obj);
+    
+    index->attrs = false;
+}
+
+static void myhtml_index_tags_clean(myhtml_index_t* index)
+{
+    for(size_t i = 0; i < index->tags_size; i++)
+        index->tags[i].length = 0;
+    
+    index->root = NULL;
+    index->last = NULL;
+}
+
+void myhtml_index_clean(myhtml_index_t* index)
+{
+    myhtml_index_tags_clean(index);
+    myhtml_index_attrs_clean(index);
+    
+    /* before parsing the tree builder fills the index */
+    index->valid = (index->tree->node_html == NULL);
+}
+
+myhtml_index_t * myhtml_index_destroy(myhtml_index_t* index, bool self_destroy)
+{
+    if(index == NULL)
+        return NULL;
+    
+    myhtml_index_mhash_lists_free(index->keys);
+    myhtml_index_mhash_lists_free(index->ids);
+    myhtml_index_mhash_lists_free(index->classes);
+    
+    index->keys    = mycore_utils_mhash_destroy(index->keys, true);
+    index->ids     = mycore_utils_mhash_destroy(index->ids, true);
+    index->classes = mycore_utils_mhash_destroy(index->classes, true);
+    
+    index->lists_obj = mcobject_destroy(index->lists_obj, true);
+    
+    if(index->tags) {
+        for(size_t i = 0; i < index->tags_size; i++)
+            mycore_free(index->tags[i].list);
+        
+        mycore_free(index->tags);
+        index->tags = NULL;
+    }
+    
+    if(index->buf) {
+        mycore_free(index->buf);
+        index->buf = NULL;
+    }
+    
+    if(self_destroy) {
+        mycore_free(index);
+        return NULL;
+    }
+    
+    return index;
+}
+
+void myhtml_index_invalidate(myhtml_index_t* index)
+{
+    index->valid = false;
+    index->attrs = false;
+}
+
+/* attributes of indexed node are changed without add/remove, maps are built again on next query */
+void myhtml_index_attrs_invalidate(myhtml_index_t* index)
+{
+    index->attrs = false;
+}
+
+bool myhtml_index_is_ready(myhtml_index_t* index, bool attrs)
+{
+    if(index->valid == false || index->root != index->tree->node_html)
+        return false;
+    
+    return (attrs == false || index->attrs);
+}
+
+/*
+ * Document order
+ */
+int myhtml_index_node_compare(myhtml_tree_node_t* first, myhtml_tree_node_t* second)
+{
+    if(first == second)
+        return 0;
+    
+    size_t depth_first = 0, depth_second = 0;
+    myhtml_tree_node_t *node;
+    
+    for(node = first->parent; node; node = node->parent)
+        depth_first++;
+    
+    for(node = second->parent; node; node = node->parent)
+        depth_second++;
+    
+    myhtml_tree_node_t *one = first, *two = second;
+    
+    while(depth_first > depth_second) {
+        one = one->parent;
+        depth_first--;
+    }
+    
+    while(depth_second > depth_first) {
+        two = two->parent;
+        depth_second--;
+    }
+    
+    /* ancestor goes first */
+    if(one == two)
+        return (one == first ? -1 : 1);
+    
+    while(one->parent != two->parent) {
+        one = one->parent;
+        two = two->parent;
+    }
+    
+    /* siblings, look both ways for nearest */
+    myhtml_tree_node_t *next = one->next, *prev = one->prev;
+    
+    while(next || prev) {
+        if(next == two)
+            return -1;
+        
+        if(prev == two)
+            return 1;
+        
+        if(next)
+            next = next->next;
+        
+        if(prev)
+            prev = prev->prev;
+    }
+    
+    /* nodes of different trees */
+    return (one < two ? -1 : 1);
+}
+
+myhtml_tree_node_t * myhtml_index_node_after(myhtml_tree_node_t* node)
+{
+    while(node) {
+        if(node->next)
+            return node->next;
+        
+        node = node->parent;
+    }
+    
+    return NULL;
+}
+
+bool myhtml_index_node_is_indexed(myhtml_index_t* index, myhtml_tree_node_t* node)
+{
+    if(index->root == NULL)
+        return false;
+    
+    while(node) {
+        if(node == index->root)
+            return true;
+        
+        node = node->parent;
+    }
+    
+    return false;
+}
+
+/*
+ * Lists
+ */
+static mystatus_t myhtml_index_list_check_size(myhtml_index_list_t* list)
+{
+    if(list->length < list->size)
+        return MyHTML_STATUS_OK;
+    
+    size_t new_size = (list->size ? (list->size << 1) : MyHTML_INDEX_LIST_SIZE);
+    myhtml_tree_node_t** tmp = (myhtml_tree_node_t**)mycore_realloc(list->list, sizeof(myhtml_tree_node_t*) * new_size);
+    
+    if(tmp == NULL)
+        return MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    list->list = tmp;
+    list->size = new_size;
+    
+    return MyHTML_STATUS_OK;
+}
+
+static mystatus_t myhtml_index_list_append(myhtml_index_list_t* list, myhtml_tree_node_t* node)
+{
+    if(myhtml_index_list_check_size(list))
+        return MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    list->list[ list->length ] = node;
+    list->length++;
+    
+    return MyHTML_STATUS_OK;
+}
+
+size_t myhtml_index_list_lower_bound(myhtml_index_list_t* list, myhtml_tree_node_t* node)
+{
+    size_t begin = 0, end = list->length;
+    
+    while(begin < end) {
+        size_t middle = begin + ((end - begin) >> 1);
+        
+        if(myhtml_index_node_compare(list->list[middle], node) < 0)
+            begin = middle + 1;
+        else
+            end = middle;
+    }
+    
+    return begin;
+}
+
+static mystatus_t myhtml_index_list_insert(myhtml_index_list_t* list, myhtml_tree_node_t* node)
+{
+    if(myhtml_index_list_check_size(list))
+        return MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    size_t idx = myhtml_index_list_lower_bound(list, node);
+    
+    memmove(&list->list[(idx + 1)], &list->list[idx], sizeof(myhtml_tree_node_t*) * (list->length - idx));
+    
+    list->list[idx] = node;
+    list->length++;
+    
+    return MyHTML_STATUS_OK;
+}
+
+static void myhtml_index_list_remove(myhtml_index_list_t* list, myhtml_tree_node_t* node)
+{
+    size_t idx = myhtml_index_list_lower_bound(list, node);
+    
+    if(idx == list->length || list->list[idx] != node)
+        return;
+    
+    list->length--;
+    memmove(&list->list[idx], &list->list[(idx + 1)], sizeof(myhtml_tree_node_t*) * (list->length - idx));
+}
+
+mystatus_t myhtml_index_list_range_copy(myhtml_index_list_t* list, myhtml_tree_node_t* first, myhtml_tree_node_t* bound,
+                                        myhtml_collection_t* collection)
+{
+    size_t begin = (first ? myhtml_index_list_lower_bound(list, first) : 0);
+    size_t end   = (bound ? myhtml_index_list_lower_bound(list, bound) : list->length);
+    
+    if(begin >= end)
+        return MyHTML_STATUS_OK;
+    
+    if(myhtml_collection_check_size(collection, (end - begin), 1024))
+        return MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    memcpy(&collection->list[ collection->length ], &list->list[begin], sizeof(myhtml_tree_node_t*) * (end - begin));
+    collection->length += (end - begin);
+    
+    return MyHTML_STATUS_OK;
+}
+
+static myhtml_index_list_t * myhtml_index_mhash_list(myhtml_index_t* index, mycore_utils_mhash_t* mhash,
+                                                     const char* key, size_t key_len, bool create)
+{
+    mycore_utils_mhash_entry_t* entry;
+    
+    if(create == false) {
+        entry = mycore_utils_mhash_search(mhash, key, key_len, NULL);
+        return (entry ? (myhtml_index_list_t*)entry->value : NULL);
+    }
+    
+    entry = mycore_utils_mhash_add_with_choice(mhash, key, key_len);
+    
+    if(entry == NULL)
+        return NULL;
+    
+    if(entry->value == NULL) {
+        mystatus_t status;
+        myhtml_index_list_t* list = (myhtml_index_list_t*)mcobject_malloc(index->lists_obj, &status);
+        
+        if(status)
+            return NULL;
+        
+        memset(list, 0, sizeof(myhtml_index_list_t));
+        entry->value = list;
+    }
+    
+    return (myhtml_index_list_t*)entry->value;
+}
+
+static mystatus_t myhtml_index_mhash_change(myhtml_index_t* index, mycore_utils_mhash_t* mhash,
+                                            const char* key, size_t key_len, myhtml_tree_node_t* node,
+                                            bool remove, bool append)
+{
+    myhtml_index_list_t* list = myhtml_index_mhash_list(index, mhash, key, key_len, (remove == false));
+    
+    if(remove) {
+        if(list)
+            myhtml_index_list_remove(list, node);
+        
+        return MyHTML_STATUS_OK;
+    }
+    
+    if(list == NULL)
+        return MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    if(append)
+        return myhtml_index_list_append(list, node);
+    
+    return myhtml_index_list_insert(list, node);
+}
+
+static const char * myhtml_index_key_lowercase(myhtml_index_t* index, const char* key, size_t key_len)
+{
+    if(key_len >= index->buf_size) {
+        char* tmp = (char*)mycore_realloc(index->buf, (key_len + 1));
+        
+        if(tmp == NULL)
+            return NULL;
+        
+        index->buf      = tmp;
+        index->buf_size = key_len + 1;
+    }
+    
+    for(size_t i = 0; i < key_len; i++)
+        index->buf[i] = (char)mycore_string_chars_lowercase_map[ (const unsigned char)key[i] ];
+    
+    return index->buf;
+}
+
+/* every distinct token of class value once, like whitespace separated match does for one attribute */
+static bool myhtml_index_class_token_seen(const char* data, size_t pos, const char* token, size_t token_len)
+{
+    size_t i = 0;
+    
+    while(i < pos) {
+        while(i < pos && mycore_utils_whithspace(data[i], ==, ||))
+            i++;
+        
+        size_t begin = i;
+        
+        while(i < pos && mycore_utils_whithspace(data[i], !=, &&))
+            i++;
+        
+        if((i - begin) == token_len && memcmp(&data[begin], token, token_len) == 0)
+            return true;
+    }
+    
+    return false;
+}
+
+static mystatus_t myhtml_index_attr_change(myhtml_index_t* index, myhtml_tree_node_t* node, myhtml_token_attr_t* attr,
+                                           bool remove, bool append)
+{
+    mystatus_t status;
+    
+    if(attr->key.length == 0)
+        return MyHTML_STATUS_OK;
+    
+    const char* key = myhtml_index_key_lowercase(index, attr->key.data, attr->key.length);
+    
+    if(key == NULL)
+        return MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    if((status = myhtml_index_mhash_change(index, index->keys, key, attr->key.length, node, remove, append)))
+        return status;
+    
+    /* values of other attributes are not indexed, keep them lazy */
+    if((attr->key.length == 2 && memcmp(key, "id", 2) == 0) ||
+       (attr->key.length == 5 && memcmp(key, "class", 5) == 0))
+    {
+        myhtml_token_attr_materialize(attr);
+    }
+    
+    if(attr->value.length == 0)
+        return MyHTML_STATUS_OK;
+    
+    if(attr->key.length == 2 && memcmp(key, "id", 2) == 0) {
+        return myhtml_index_mhash_change(index, index->ids, attr->value.data, attr->value.length, node, remove, append);
+    }
+    
+    if(attr->key.length == 5 && memcmp(key, "class", 5) == 0) {
+        const char* data = attr->value.data;
+        size_t length = attr->value.length, i = 0;
+        
+        while(i < length) {
+            while(i < length && mycore_utils_whithspace(data[i], ==, ||))
+                i++;
+            
+            size_t begin = i;
+            
+            while(i < length && mycore_utils_whithspace(data[i], !=, &&))
+                i++;
+            
+            if(i == begin || myhtml_index_class_token_seen(data, begin, &data[begin], (i - begin)))
+                continue;
+            
+            if((status = myhtml_index_mhash_change(index, index->classes, &data[begin], (i - begin), node, remove, append)))
+                return status;
+        }
+    }
+    
+    return MyHTML_STATUS_OK;
+}
+
+static mystatus_t myhtml_index_node_attrs_append(myhtml_index_t* index, myhtml_tree_node_t* node)
+{
+    if(node->token == NULL)
+        return MyHTML_STATUS_OK;
+    
+    myhtml_token_node_wait_for_done(index->tree->token, node->token);
+    
+    myhtml_token_attr_t* attr = node->token->attr_first;
+    
+    while(attr) {
+        mystatus_t status = myhtml_index_attr_change(index, node, attr, false, true);
+        
+        if(status)
+            return status;
+        
+        attr = attr->next;
+    }
+    
+    return MyHTML_STATUS_OK;
+}
+
+static mystatus_t myhtml_index_node_tag_append(myhtml_index_t* index, myhtml_tree_node_t* node)
+{
+    if(node->tag_id >= index->tags_size) {
+        size_t new_size = node->tag_id + 128;
+        myhtml_index_list_t* tmp = (myhtml_index_list_t*)mycore_realloc(index->tags, sizeof(myhtml_index_list_t) * new_size);
+        
+        if(tmp == NULL)
+            return MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+        
+        memset(&tmp[index->tags_size], 0, sizeof(myhtml_index_list_t) * (new_size - index->tags_size));
+        
+        index->tags      = tmp;
+        index->tags_size = new_size;
+    }
+    
+    return myhtml_index_list_append(&index->tags[ node->tag_id ], node);
+}
+
+/* append nodes of subtree in document order */
+static mystatus_t myhtml_index_subtree_append(myhtml_index_t* index, myhtml_tree_node_t* root, bool tags, bool attrs)
+{
+    mystatus_t status;
+    myhtml_tree_node_t *node = root;
+    
+    while(node)
+    {
+        if(tags) {
+            if((status = myhtml_index_node_tag_append(index, node)))
+                return status;
+            
+            index->last = node;
+        }
+        
+        if(attrs && (status = myhtml_index_node_attrs_append(index, node)))
+            return status;
+        
+        if(node->child)
+            node = node->child;
+        else {
+            while(node != root && node->next == NULL)
+                node = node->parent;
+            
+            if(node == root)
+                break;
+            
+            node = node->next;
+        }
+    }
+    
+    return MyHTML_STATUS_OK;
+}
+
+mystatus_t myhtml_index_update(myhtml_index_t* index, bool attrs)
+{
+    mystatus_t status;
+    
+    if(myhtml_index_is_ready(index, attrs))
+        return MyHTML_STATUS_OK;
+    
+    if(index->valid && index->root == index->tree->node_html) {
+        myhtml_index_attrs_clean(index);
+        
+        if((status = myhtml_index_subtree_append(index, index->root, false, true))) {
+            myhtml_index_invalidate(index);
+            return status;
+        }
+        
+        index->attrs = true;
+        return MyHTML_STATUS_OK;
+    }
+    
+    myhtml_index_tags_clean(index);
+    myhtml_index_attrs_clean(index);
+    
+    index->root = index->tree->node_html;
+    
+    if(index->root && (status = myhtml_index_subtree_append(index, index->root, true, attrs))) {
+        myhtml_index_invalidate(index);
+        return status;
+    }
+    
+    index->valid = true;
+    index->attrs = attrs;
+    
+    return MyHTML_STATUS_OK;
+}
+
+/*
+ * Tree and attributes changes
+ */
+void myhtml_index_node_insert(myhtml_index_t* index, myhtml_tree_node_t* node)
+{
+    if(index->valid == false)
+        return;
+    
+    myhtml_tree_node_t *parent = node->parent;
+    
+    if(index->root == NULL) {
+        /* node_html is set after it is added to document */
+        if(parent == index->tree->document && node->tag_id == MyHTML_TAG_HTML) {
+            index->root = node;
+            
+            if(myhtml_index_subtree_append(index, node, true, index->attrs))
+                myhtml_index_invalidate(index);
+        }
+        
+        return;
+    }
+    
+    /* appended to parent on the path from root to last node, so it is the last node now */
+    if(node->next == NULL) {
+        for(myhtml_tree_node_t *path = index->last; path; path = path->parent)
+        {
+            if(path == parent) {
+                if(myhtml_index_subtree_append(index, node, true, index->attrs))
+                    myhtml_index_invalidate(index);
+                
+                return;
+            }
+            
+            if(path == index->root)
+                break;
+        }
+    }
+    
+    /* nodes out of root are not indexed */
+    if(myhtml_index_node_is_indexed(index, node))
+        myhtml_index_invalidate(index);
+}
+
+void myhtml_index_attr_add(myhtml_index_t* index, myhtml_tree_node_t* node, myhtml_token_attr_t* attr)
+{
+    if(index->attrs == false || attr == NULL || myhtml_index_node_is_indexed(index, node) == false)
+        return;
+    
+    if(myhtml_index_attr_change(index, node, attr, false, false))
+        myhtml_index_invalidate(index);
+}
+
+void myhtml_index_attr_remove(myhtml_index_t* index, myhtml_tree_node_t* node, myhtml_token_attr_t* attr)
+{
+    if(index->attrs == false || attr == NULL)
+        return;
+    
+    myhtml_index_attr_change(index, node, attr, true, false);
+}
+
+/*
+ * Lists by name
+ */
+myhtml_index_list_t * myhtml_index_list_by_tag_id(myhtml_index_t* index, myhtml_tag_id_t tag_id)
+{
+    if(tag_id >= index->tags_size || index->tags[tag_id].length == 0)
+        return NULL;
+    
+    return &index->tags[tag_id];
+}
+
+myhtml_index_list_t * myhtml_index_list_by_key(myhtml_index_t* index, const char* key, size_t key_len)
+{
+    if(key == NULL || key_len == 0)
+        return NULL;
+    
+    const char* lower = myhtml_index_key_lowercase(index, key, key_len);
+    
+    if(lower == NULL)
+        return NULL;
+    
+    return myhtml_index_mhash_list(index, index->keys, lower, key_len, false);
+}
+
+myhtml_index_list_t * myhtml_index_list_by_id(myhtml_index_t* index, const char* value, size_t value_len)
+{
+    if(value == NULL || value_len == 0)
+        return NULL;
+    
+    return myhtml_index_mhash_list(index, index->ids, value, value_len, false);
+}
+
+myhtml_index_list_t * myhtml_index_list_by_class(myhtml_index_t* index, const char* value, size_t value_len)
+{
+    if(value == NULL || value_len == 0)
+        return NULL;
+    
+    return myhtml_index_mhash_list(index, index->classes, value, value_len, false);
+}
@@ -0,0 +1,116 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#ifndef MyHTML_INDEX_H
+#define MyHTML_INDEX_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "myhtml/myosi.h"
+#include "myhtml/tree.h"
+#include "mycore/utils/mhash.h"
+#include "mycore/utils/mcobject.h"
+
+/*
+ * Per tree index of nodes by tag id, by attribute key, by id value and by class token.
+ * Lists hold nodes of node_html subtree in document order.
+ *
+ * The tree builder appends new nodes while they are inserted at the end of the document,
+ * any other change of tree structure makes the index invalid and it is rebuilt by one walk
+ * on next query. Attribute maps are built on first attribute query, because in thread mode
+ * attributes are processed after node insertion; after that they follow attribute add/remove.
+ */
+
+#define myhtml_index_node_callback_insert(tree, node) \
+    if(tree->index) \
+        myhtml_index_node_insert(tree->index, node)
+
+#define myhtml_index_node_callback_remove(tree, node) \
+    if(tree->index) \
+        myhtml_index_invalidate(tree->index)
+
+struct myhtml_index_list {
+    myhtml_tree_node_t** list;
+    size_t length;
+    size_t size;
+}
+typedef myhtml_index_list_t;
+
+struct myhtml_index {
+    myhtml_tree_t* tree;
+    
+    /* by tag id, grows for custom tags */
+    myhtml_index_list_t* tags;
+    size_t tags_size;
+    
+    /* values are myhtml_index_list_t* from lists_obj */
+    mycore_utils_mhash_t* keys;
+    mycore_utils_mhash_t* ids;
+    mycore_utils_mhash_t* classes;
+    mcobject_t* lists_obj;
+    
+    /* lowercase attribute key */
+    char*  buf;
+    size_t buf_size;
+    
+    myhtml_tree_node_t* root;
+    myhtml_tree_node_t* last;
+    
+    bool valid;
+    bool attrs;
+};
+
+myhtml_index_t * myhtml_index_create(void);
+mystatus_t myhtml_index_init(myhtml_index_t* index, myhtml_tree_t* tree);
+void myhtml_index_clean(myhtml_index_t* index);
+myhtml_index_t * myhtml_index_destroy(myhtml_index_t* index, bool self_destroy);
+
+void myhtml_index_invalidate(myhtml_index_t* index);
+void myhtml_index_attrs_invalidate(myhtml_index_t* index);
+mystatus_t myhtml_index_update(myhtml_index_t* index, bool attrs);
+bool myhtml_index_is_ready(myhtml_index_t* index, bool attrs);
+
+/* tree and attributes changes */
+void myhtml_index_node_insert(myhtml_index_t* index, myhtml_tree_node_t* node);
+void myhtml_index_attr_add(myhtml_index_t* index, myhtml_tree_node_t* node, myhtml_token_attr_t* attr);
+void myhtml_index_attr_remove(myhtml_index_t* index, myhtml_tree_node_t* node, myhtml_token_attr_t* attr);
+
+/* lists; index must be updated, NULL if nothing found */
+myhtml_index_list_t * myhtml_index_list_by_tag_id(myhtml_index_t* index, myhtml_tag_id_t tag_id);
+myhtml_index_list_t * myhtml_index_list_by_key(myhtml_index_t* index, const char* key, size_t key_len);
+myhtml_index_list_t * myhtml_index_list_by_id(myhtml_index_t* index, const char* value, size_t value_len);
+myhtml_index_list_t * myhtml_index_list_by_class(myhtml_index_t* index, const char* value, size_t value_len);
+
+/* document order */
+int myhtml_index_node_compare(myhtml_tree_node_t* first, myhtml_tree_node_t* second);
+myhtml_tree_node_t * myhtml_index_node_after(myhtml_tree_node_t* node);
+bool myhtml_index_node_is_indexed(myhtml_index_t* index, myhtml_tree_node_t* node);
+size_t myhtml_index_list_lower_bound(myhtml_index_list_t* list, myhtml_tree_node_t* node);
+mystatus_t myhtml_index_list_range_copy(myhtml_index_list_t* list, myhtml_tree_node_t* first, myhtml_tree_node_t* bound,
+                                        myhtml_collection_t* collection);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* MyHTML_INDEX_H */
@@ -153,6 +153,12 @@ mystatus_t myhtml_init(myhtml_t* myhtml, enum myhtml_options opt, size_t thread_
             myhtml->thread_stream->context = mythread_queue_list_create(&status);
             myhtml->thread_batch->context  = myhtml->thread_stream->context;
             
+            if(status)
+                return status;
+            
+            /* stream and batch threads work on one queue list, wake up together; batch is destroyed last */
+            mythread_cond_share(myhtml->thread_stream, myhtml->thread_batch);
+            
             status = myhread_entry_create(myhtml->thread_stream, mythread_function_queue_stream, myhtml_parser_stream, MyTHREAD_OPT_STOP);
             if(status)
                 return status;
@@ -222,6 +228,16 @@ myhtml_t* myhtml_destroy(myhtml_t* myhtml)
     return NULL;
 }
 
+void myhtml_allocator_set(myhtml_t* myhtml, mcallocator_t* allocator)
+{
+    myhtml->allocator = allocator;
+}
+
+mcallocator_t * myhtml_allocator(myhtml_t* myhtml)
+{
+    return myhtml->allocator;
+}
+
 mystatus_t myhtml_parse(myhtml_tree_t* tree, myencoding_t encoding, const char* html, size_t html_size)
 {
     if(tree->flags & MyHTML_TREE_FLAGS_PARSE_END) {
@@ -237,6 +253,27 @@ mystatus_t myhtml_parse(myhtml_tree_t* tree, myencoding_t encoding, const char*
     return myhtml_tokenizer_end(tree);
 }
 
+mystatus_t myhtml_parse_file(myhtml_tree_t* tree, myencoding_t encoding, const char* filename)
+{
+    const char *data;
+    size_t size;
+    
+    mystatus_t status = mycore_file_map(filename, &data, &size);
+    
+    if(status)
+        return status;
+    
+    /* previous file is unmapped by clean of tree */
+    status = myhtml_parse(tree, encoding, (data ? data : ""), size);
+    
+    myhtml_tree_file_unmap(tree);
+    
+    tree->file_data = data;
+    tree->file_size = size;
+    
+    return status;
+}
+
 mystatus_t myhtml_parse_fragment(myhtml_tree_t* tree, myencoding_t encoding, const char* html, size_t html_size, myhtml_tag_id_t tag_id, enum myhtml_namespace ns)
 {
     if(tree->flags & MyHTML_TREE_FLAGS_PARSE_END) {
@@ -372,6 +409,47 @@ myencoding_t myhtml_encoding_get(myhtml_tree_t* tree)
  * Nodes
  */
 
+/* the index answers for node_html subtree, NULL if walk is needed */
+static myhtml_index_t * myhtml_get_nodes_index(myhtml_tree_t* tree, bool attrs)
+{
+    if(tree->index == NULL || myhtml_index_update(tree->index, attrs))
+        return NULL;
+    
+    return tree->index;
+}
+
+/* the node, its following siblings and their descendants as range of index list */
+static bool myhtml_get_nodes_index_siblings_scope(myhtml_index_t* index, myhtml_tree_node_t* node, myhtml_tree_node_t** bound)
+{
+    if(myhtml_index_node_is_indexed(index, node) == false)
+        return false;
+    
+    if(node == index->root) {
+        /* after html can be only comments and text without attributes */
+        for(myhtml_tree_node_t* next = node->next; next; next = next->next) {
+            if(next->tag_id != MyHTML_TAG__COMMENT && next->tag_id != MyHTML_TAG__TEXT)
+                return false;
+        }
+        
+        *bound = NULL;
+    }
+    else
+        *bound = myhtml_index_node_after(node->parent);
+    
+    return true;
+}
+
+static myhtml_collection_t * myhtml_get_nodes_by_index_list(myhtml_index_list_t* list, myhtml_collection_t* collection,
+                                                            myhtml_tree_node_t* first, myhtml_tree_node_t* bound, mystatus_t* status)
+{
+    if(list && myhtml_index_list_range_copy(list, first, bound, collection)) {
+        if(status)
+            *status = MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+    }
+    
+    return collection;
+}
+
 mystatus_t myhtml_get_nodes_by_tag_id_in_scope_find_recursion(myhtml_tree_node_t *node, myhtml_collection_t *collection, myhtml_tag_id_t tag_id)
 {
     while(node) {
@@ -415,7 +493,18 @@ myhtml_collection_t * myhtml_get_nodes_by_tag_id_in_scope(myhtml_tree_t* tree, m
         return collection;
     }
     
-    if(node->child)
+    myhtml_index_t* index = myhtml_get_nodes_index(tree, false);
+    
+    if(index && myhtml_index_node_is_indexed(index, node)) {
+        myhtml_index_list_t* list = myhtml_index_list_by_tag_id(index, tag_id);
+        
+        if(list && node->child)
+            mystatus = myhtml_index_list_range_copy(list, node->child, myhtml_index_node_after(node), collection);
+        
+        if(mystatus == MyHTML_STATUS_OK)
+            mystatus = myhtml_collection_check_size(collection, 1, 1024);
+    }
+    else if(node->child)
         mystatus = myhtml_get_nodes_by_tag_id_in_scope_find_recursion(node->child, collection, tag_id);
     
     collection->list[collection->length] = NULL;
@@ -444,7 +533,12 @@ myhtml_collection_t * myhtml_get_nodes_by_tag_id(myhtml_tree_t* tree, myhtml_col
             return NULL;
     }
     
-    myhtml_tree_node_t *node = tree->node_html;
+    myhtml_index_t* index = myhtml_get_nodes_index(tree, false);
+    myhtml_tree_node_t *node = (index ? NULL : tree->node_html);
+    
+    if(index) {
+        myhtml_get_nodes_by_index_list(myhtml_index_list_by_tag_id(index, tag_id), collection, NULL, NULL, status);
+    }
     
     while(node)
     {
@@ -813,6 +907,9 @@ myhtml_tree_attr_t * myhtml_node_attribute_last(myhtml_tree_node_t *node)
 
 const char * myhtml_node_text(myhtml_tree_node_t *node, size_t *length)
 {
+    if(node->token)
+        myhtml_token_node_materialize(node->tree->token, node->token);
+    
     if(node->token && node->token->str.length && node->token->str.data)
     {
         if(length)
@@ -829,8 +926,10 @@ const char * myhtml_node_text(myhtml_tree_node_t *node, size_t *length)
 
 mycore_string_t * myhtml_node_string(myhtml_tree_node_t *node)
 {
-    if(node && node->token)
+    if(node && node->token) {
+        myhtml_token_node_materialize(node->tree->token, node->token);
         return &node->token->str;
+    }
     
     return NULL;
 }
@@ -917,6 +1016,14 @@ myhtml_collection_t * myhtml_get_nodes_by_attribute_key(myhtml_tree_t *tree, myh
     if(scope_node == NULL)
         scope_node = tree->node_html;
     
+    myhtml_index_t* index = myhtml_get_nodes_index(tree, true);
+    myhtml_tree_node_t* bound;
+    
+    if(index && scope_node && key_len && myhtml_get_nodes_index_siblings_scope(index, scope_node, &bound)) {
+        return myhtml_get_nodes_by_index_list(myhtml_index_list_by_key(index, key, key_len), collection,
+                                              scope_node, bound, status);
+    }
+    
     mystatus_t rec_status = myhtml_get_nodes_by_attribute_key_recursion(scope_node, collection, key, key_len);
     
     if(rec_status && status)
@@ -947,7 +1054,7 @@ bool myhtml_get_nodes_by_attribute_value_recursion_whitespace_separated(mycore_s
     {
         if(mycore_utils_whithspace(data[(i - 1)], ==, ||)) {
             if(mycore_strncmp(&data[i], value, value_len) == 0) {
-                if((i > value_len && mycore_utils_whithspace(data[(i + value_len)], ==, ||)) || (str->length - i) == value_len)
+                if(((str->length - i) > value_len && mycore_utils_whithspace(data[(i + value_len)], ==, ||)) || (str->length - i) == value_len)
                     return true;
             }
         }
@@ -1027,7 +1134,7 @@ bool myhtml_get_nodes_by_attribute_value_recursion_whitespace_separated_i(mycore
     {
         if(mycore_utils_whithspace(data[(i - 1)], ==, ||)) {
             if(mycore_strncasecmp(&data[i], value, value_len) == 0) {
-                if((i > value_len && mycore_utils_whithspace(data[(i + value_len)], ==, ||)) || (str->length - i) == value_len)
+                if(((str->length - i) > value_len && mycore_utils_whithspace(data[(i + value_len)], ==, ||)) || (str->length - i) == value_len)
                     return true;
             }
         }
@@ -1096,6 +1203,7 @@ mystatus_t myhtml_get_nodes_by_attribute_value_recursion(myhtml_tree_node_t* nod
             myhtml_tree_attr_t* attr = node->token->attr_first;
             
             while(attr) {
+                myhtml_token_attr_materialize(attr);
                 mycore_string_t* str = &attr->value;
                 
                 if(func_eq(str, value, value_len)) {
@@ -1143,6 +1251,8 @@ mystatus_t myhtml_get_nodes_by_attribute_value_recursion_by_key(myhtml_tree_node
                 
                 if(str_key->length == key_len && mycore_strncasecmp(str_key->data, key, key_len) == 0)
                 {
+                    myhtml_token_attr_materialize(attr);
+                    
                     if(func_eq(str, value, value_len)) {
                         collection->list[ collection->length ] = node;
                         
@@ -1190,6 +1300,26 @@ myhtml_collection_t * _myhtml_get_nodes_by_attribute_value(myhtml_tree_t *tree,
     if(node == NULL)
         node = tree->node_html;
     
+    /* id and class from the index */
+    if(tree->index && node && key && value_len) {
+        myhtml_index_list_t* (*by_value)(myhtml_index_t*, const char*, size_t) = NULL;
+        
+        if(func_eq == myhtml_get_nodes_by_attribute_value_recursion_eq &&
+           key_len == 2 && mycore_strncasecmp(key, "id", 2) == 0)
+            by_value = myhtml_index_list_by_id;
+        else if(func_eq == myhtml_get_nodes_by_attribute_value_recursion_whitespace_separated &&
+                key_len == 5 && mycore_strncasecmp(key, "class", 5) == 0)
+            by_value = myhtml_index_list_by_class;
+        
+        myhtml_index_t* index = (by_value ? myhtml_get_nodes_index(tree, true) : NULL);
+        myhtml_tree_node_t* bound;
+        
+        if(index && myhtml_get_nodes_index_siblings_scope(index, node, &bound)) {
+            return myhtml_get_nodes_by_index_list(by_value(index, value, value_len), collection,
+                                                  node, bound, status);
+        }
+    }
+    
     mystatus_t rec_status;
     
     if(key && key_len)
@@ -1346,6 +1476,8 @@ const char * myhtml_attribute_key(myhtml_tree_attr_t *attr, size_t *length)
 
 const char * myhtml_attribute_value(myhtml_tree_attr_t *attr, size_t *length)
 {
+    myhtml_token_attr_materialize(attr);
+    
     if(attr->value.data && attr->value.length)
     {
         if(length)
@@ -1370,8 +1502,10 @@ mycore_string_t * myhtml_attribute_key_string(myhtml_tree_attr_t* attr)
 
 mycore_string_t * myhtml_attribute_value_string(myhtml_tree_attr_t* attr)
 {
-    if(attr)
+    if(attr) {
+        myhtml_token_attr_materialize(attr);
         return &attr->value;
+    }
     
     return NULL;
 }
@@ -1400,8 +1534,13 @@ myhtml_tree_attr_t * myhtml_attribute_add(myhtml_tree_node_t *node, const char *
         node->token->type |= MyHTML_TOKEN_TYPE_DONE;
     }
     
-    return myhtml_token_node_attr_append_with_convert_encoding(tree->token, node->token, key, key_len,
-                                                               value, value_len, tree->mcasync_rules_token_id, encoding);
+    myhtml_tree_attr_t* attr = myhtml_token_node_attr_append_with_convert_encoding(tree->token, node->token, key, key_len,
+                                                                                   value, value_len, tree->mcasync_rules_token_id, encoding);
+    
+    if(tree->index)
+        myhtml_index_attr_add(tree->index, node, attr);
+    
+    return attr;
 }
 
 myhtml_tree_attr_t * myhtml_attribute_remove(myhtml_tree_node_t *node, myhtml_tree_attr_t *attr)
@@ -1409,6 +1548,9 @@ myhtml_tree_attr_t * myhtml_attribute_remove(myhtml_tree_node_t *node, myhtml_tr
     if(node == NULL || node->token == NULL)
         return NULL;
     
+    if(node->tree->index)
+        myhtml_index_attr_remove(node->tree->index, node, attr);
+    
     return myhtml_token_attr_remove(node->token, attr);
 }
 
@@ -1417,7 +1559,7 @@ myhtml_tree_attr_t * myhtml_attribute_remove_by_key(myhtml_tree_node_t *node, co
     if(node == NULL || node->token == NULL)
         return NULL;
     
-    return myhtml_token_attr_remove_by_name(node->token, key, key_len);
+    return myhtml_attribute_remove(node, myhtml_token_attr_by_name(node->token, key, key_len));
 }
 
 void myhtml_attribute_delete(myhtml_tree_t *tree, myhtml_tree_node_t *node, myhtml_tree_attr_t *attr)
@@ -1425,7 +1567,7 @@ void myhtml_attribute_delete(myhtml_tree_t *tree, myhtml_tree_node_t *node, myht
     if(node == NULL || node->token == NULL)
         return;
     
-    myhtml_token_attr_remove(node->token, attr);
+    myhtml_attribute_remove(node, attr);
     myhtml_attribute_free(tree, attr);
 }
 
@@ -1526,6 +1668,18 @@ myhtml_collection_t * myhtml_collection_destroy(myhtml_collection_t *collection)
 }
 
 /* queue */
+static void myhtml_queue_token_stream_free(myhtml_tree_t *tree, mythread_queue_node_t *qnode)
+{
+    /*
+     * Tokenizer takes tag id of previous token for RCDATA and RAWTEXT,
+     * so token is freed when next token is processed
+     */
+    if(qnode->prev && qnode->prev->args) {
+        myhtml_token_node_free(tree->token, qnode->prev->args);
+        qnode->prev->args = NULL;
+    }
+}
+
 mystatus_t myhtml_queue_add(myhtml_tree_t *tree, size_t begin, myhtml_token_node_t* token)
 {
     // TODO: need refactoring this code
@@ -1550,6 +1704,9 @@ mystatus_t myhtml_queue_add(myhtml_tree_t *tree, size_t begin, myhtml_token_node
             
             myhtml_parser_worker(0, qnode);
             myhtml_parser_stream(0, qnode);
+            
+            if((tree->parse_flags & MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM) == MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM)
+                myhtml_queue_token_stream_free(tree, qnode);
         }
         
         tree->current_qnode = mythread_queue_node_malloc_limit(tree->myhtml->thread_stream, tree->queue, 4, NULL);
@@ -1574,6 +1731,9 @@ mystatus_t myhtml_queue_add(myhtml_tree_t *tree, size_t begin, myhtml_token_node
         
         myhtml_parser_worker(0, qnode);
         myhtml_parser_stream(0, qnode);
+        
+        if((tree->parse_flags & MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM) == MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM)
+            myhtml_queue_token_stream_free(tree, qnode);
     }
     
     tree->current_qnode = mythread_queue_node_malloc_limit(tree->myhtml->thread_stream, tree->queue, 4, NULL);
@@ -1595,6 +1755,10 @@ mystatus_t myhtml_queue_add(myhtml_tree_t *tree, size_t begin, myhtml_token_node
     
     tree->current_token_node->raw_begin = tree->current_token_node->element_begin = (tree->global_offset + begin);
     
+    /* tokenizer stops, the tree is built from tokens before */
+    if(tree->myhtml->allocator && mcallocator_limit_exceeded(tree->myhtml->allocator))
+        tree->tokenizer_status = MyCORE_STATUS_ERROR_MEMORY_LIMIT;
+    
     return MyHTML_STATUS_OK;
 }
 
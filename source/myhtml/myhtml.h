@@ -42,6 +42,8 @@ extern "C" {
 #include "myhtml/token.h"
 #include "myhtml/charef.h"
 #include "myhtml/callback.h"
+#include "myhtml/index.h"
+#include "myhtml/pool.h"
 
 #define mh_queue_current() tree->queue
 #define myhtml_tokenizer_state_set(tree) myhtml_tree_set(tree, state)
@@ -75,6 +77,9 @@ struct myhtml {
     
     enum myhtml_options opt;
     myhtml_tree_node_t *marker;
+    
+    /* for memory of trees, NULL for mycore_malloc */
+    mcallocator_t* allocator;
 };
 
 struct myhtml_collection {
@@ -89,7 +94,11 @@ mystatus_t myhtml_init(myhtml_t* myhtml, enum myhtml_options opt, size_t thread_
 void myhtml_clean(myhtml_t* myhtml);
 myhtml_t* myhtml_destroy(myhtml_t* myhtml);
 
+void myhtml_allocator_set(myhtml_t* myhtml, mcallocator_t* allocator);
+mcallocator_t * myhtml_allocator(myhtml_t* myhtml);
+
 mystatus_t myhtml_parse(myhtml_tree_t* tree, myencoding_t encoding, const char* html, size_t html_size);
+mystatus_t myhtml_parse_file(myhtml_tree_t* tree, myencoding_t encoding, const char* filename);
 mystatus_t myhtml_parse_fragment(myhtml_tree_t* tree, myencoding_t encoding, const char* html, size_t html_size, myhtml_tag_id_t tag_id, enum myhtml_namespace ns);
 
 mystatus_t myhtml_parse_single(myhtml_tree_t* tree, myencoding_t encoding, const char* html, size_t html_size);
@@ -31,9 +31,11 @@ void myhtml_parser_stream(mythread_id_t thread_id, void* ctx)
 
 size_t myhtml_parser_token_data_to_string_lowercase(myhtml_tree_t *tree, mycore_string_t* str, myhtml_data_process_entry_t* proc_entry, size_t begin, size_t length)
 {
-    mycore_incoming_buffer_t *buffer = mycore_incoming_buffer_find_by_position(tree->incoming_buf_first, begin);
+    mycore_incoming_buffer_t *buffer = mycore_incoming_buffer_find_by_position((proc_entry->inc_buf ? proc_entry->inc_buf : tree->incoming_buf_first), begin);
     size_t relative_begin = begin - buffer->offset;
     
+    proc_entry->inc_buf = buffer;
+    
     // if token data length in one buffer then print them all at once
     if((relative_begin + length) <= buffer->size) {
         if(tree->encoding == MyENCODING_UTF_8)
@@ -89,9 +91,11 @@ size_t myhtml_parser_token_data_to_string_lowercase(myhtml_tree_t *tree, mycore_
 
 size_t myhtml_parser_token_data_to_string(myhtml_tree_t *tree, mycore_string_t* str, myhtml_data_process_entry_t* proc_entry, size_t begin, size_t length)
 {
-    mycore_incoming_buffer_t *buffer = mycore_incoming_buffer_find_by_position(tree->incoming_buf_first, begin);
+    mycore_incoming_buffer_t *buffer = mycore_incoming_buffer_find_by_position((proc_entry->inc_buf ? proc_entry->inc_buf : tree->incoming_buf_first), begin);
     size_t relative_begin = begin - buffer->offset;
     
+    proc_entry->inc_buf = buffer;
+    
     // if token data length in one buffer then print them all at once
     if((relative_begin + length) <= buffer->size) {
         if(tree->encoding == MyENCODING_UTF_8)
@@ -148,9 +152,11 @@ size_t myhtml_parser_token_data_to_string(myhtml_tree_t *tree, mycore_string_t*
 
 size_t myhtml_parser_token_data_to_string_charef(myhtml_tree_t *tree, mycore_string_t* str, myhtml_data_process_entry_t* proc_entry, size_t begin, size_t length)
 {
-    mycore_incoming_buffer_t *buffer = mycore_incoming_buffer_find_by_position(tree->incoming_buf_first, begin);
+    mycore_incoming_buffer_t *buffer = mycore_incoming_buffer_find_by_position((proc_entry->inc_buf ? proc_entry->inc_buf : tree->incoming_buf_first), begin);
     size_t relative_begin = begin - buffer->offset;
     
+    proc_entry->inc_buf = buffer;
+    
     // if token data length in one buffer then print them all at once
     if((relative_begin + length) <= buffer->size) {
         myhtml_data_process(proc_entry, str, &buffer->data[relative_begin], length);
@@ -182,6 +188,47 @@ size_t myhtml_parser_token_data_to_string_charef(myhtml_tree_t *tree, mycore_str
     return str->length;
 }
 
+void myhtml_parser_token_text_to_string(myhtml_tree_t *tree, myhtml_token_node_t* token, mycore_string_t* str,
+                                        size_t mchar_node_id, mycore_incoming_buffer_t** inc_buf)
+{
+    mycore_string_init(tree->mchar, mchar_node_id, str, (token->raw_length + 1));
+    
+    myhtml_data_process_entry_t proc_entry;
+    myhtml_data_process_entry_clean(&proc_entry);
+    
+    proc_entry.encoding = tree->encoding;
+    proc_entry.inc_buf  = *inc_buf;
+    
+    if(token->type & MyHTML_TOKEN_TYPE_DATA) {
+        proc_entry.emit_null_char = true;
+        
+        myhtml_parser_token_data_to_string_charef(tree, str, &proc_entry, token->raw_begin, token->raw_length);
+    }
+    else if(token->type & MyHTML_TOKEN_TYPE_RCDATA || token->type & MyHTML_TOKEN_TYPE_CDATA) {
+        myhtml_parser_token_data_to_string_charef(tree, str, &proc_entry, token->raw_begin, token->raw_length);
+    }
+    else
+        myhtml_parser_token_data_to_string(tree, str, &proc_entry, token->raw_begin, token->raw_length);
+    
+    *inc_buf = proc_entry.inc_buf;
+}
+
+void myhtml_parser_token_attr_value_to_string(myhtml_tree_t *tree, myhtml_token_attr_t* attr, mycore_string_t* str,
+                                              size_t mchar_node_id, mycore_incoming_buffer_t** inc_buf)
+{
+    myhtml_data_process_entry_t proc_entry;
+    myhtml_data_process_entry_clean(&proc_entry);
+    
+    proc_entry.encoding = tree->encoding;
+    proc_entry.is_attributes = true;
+    proc_entry.inc_buf = *inc_buf;
+    
+    mycore_string_init(tree->mchar, mchar_node_id, str, (attr->raw_value_length + 1));
+    myhtml_parser_token_data_to_string_charef(tree, str, &proc_entry, attr->raw_value_begin, attr->raw_value_length);
+    
+    *inc_buf = proc_entry.inc_buf;
+}
+
 void myhtml_parser_worker(mythread_id_t thread_id, void* ctx)
 {
     mythread_queue_node_t *qnode = (mythread_queue_node_t*)ctx;
@@ -215,40 +262,33 @@ void myhtml_parser_worker(mythread_id_t thread_id, void* ctx)
         return;
     }
     
-    size_t mchar_node_id;
+    myhtml_async_args_t* async_args;
 #ifndef MyCORE_BUILD_WITHOUT_THREADS
     if(tree->myhtml->thread_batch)
-        mchar_node_id = tree->async_args[(thread_id + tree->myhtml->thread_batch->id_increase)].mchar_node_id;
+        async_args = &tree->async_args[(thread_id + tree->myhtml->thread_batch->id_increase)];
     else
 #endif
-        mchar_node_id = tree->async_args[thread_id].mchar_node_id;
+        async_args = &tree->async_args[thread_id];
+    
+    size_t mchar_node_id = async_args->mchar_node_id;
     
     if(tree->callback_before_token)
         tree->callback_before_token_ctx = tree->callback_before_token(tree, token, tree->callback_before_token_ctx);
     
+    /* in lazy mode and inside pruned element strings are decoded by myhtml_token_*_materialize */
+    bool without_strings = ((tree->parse_flags & MyHTML_TREE_PARSE_FLAGS_LAZY_STRINGS) ||
+                            myhtml_tree_pruned_insertion(tree));
+    
     if(token->tag_id == MyHTML_TAG__TEXT ||
        token->tag_id == MyHTML_TAG__COMMENT)
     {
-        mycore_string_init(tree->mchar, mchar_node_id, &token->str, (token->raw_length + 1));
-        
         token->attr_first = NULL;
         token->attr_last  = NULL;
         
-        myhtml_data_process_entry_t proc_entry;
-        myhtml_data_process_entry_clean(&proc_entry);
-        
-        proc_entry.encoding = tree->encoding;
-        
-        if(token->type & MyHTML_TOKEN_TYPE_DATA) {
-            proc_entry.emit_null_char = true;
-            
-            myhtml_parser_token_data_to_string_charef(tree, &token->str, &proc_entry, token->raw_begin, token->raw_length);
-        }
-        else if(token->type & MyHTML_TOKEN_TYPE_RCDATA || token->type & MyHTML_TOKEN_TYPE_CDATA) {
-            myhtml_parser_token_data_to_string_charef(tree, &token->str, &proc_entry, token->raw_begin, token->raw_length);
-        }
+        if(without_strings)
+            mycore_string_clean_all(&token->str);
         else
-            myhtml_parser_token_data_to_string(tree, &token->str, &proc_entry, token->raw_begin, token->raw_length);
+            myhtml_parser_token_text_to_string(tree, token, &token->str, mchar_node_id, &async_args->incoming_buf);
     }
     else if(token->attr_first)
     {
@@ -262,21 +302,18 @@ void myhtml_parser_worker(mythread_id_t thread_id, void* ctx)
             if(attr->raw_key_length) {
                 myhtml_data_process_entry_clean(&proc_entry);
                 proc_entry.encoding = tree->encoding;
+                proc_entry.inc_buf  = async_args->incoming_buf;
                 
                 mycore_string_init(tree->mchar, mchar_node_id, &attr->key, (attr->raw_key_length + 1));
                 myhtml_parser_token_data_to_string_lowercase(tree, &attr->key, &proc_entry, attr->raw_key_begin, attr->raw_key_length);
+                
+                async_args->incoming_buf = proc_entry.inc_buf;
             }
             else
                 mycore_string_clean_all(&attr->key);
             
-            if(attr->raw_value_length) {
-                myhtml_data_process_entry_clean(&proc_entry);
-                proc_entry.encoding = tree->encoding;
-                proc_entry.is_attributes = true;
-                
-                mycore_string_init(tree->mchar, mchar_node_id, &attr->value, (attr->raw_value_length + 1));
-                myhtml_parser_token_data_to_string_charef(tree, &attr->value, &proc_entry, attr->raw_value_begin, attr->raw_value_length);
-            }
+            if(attr->raw_value_length && without_strings == false)
+                myhtml_parser_token_attr_value_to_string(tree, attr, &attr->value, mchar_node_id, &async_args->incoming_buf);
             else
                 mycore_string_clean_all(&attr->value);
             
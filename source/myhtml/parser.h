@@ -41,6 +41,11 @@ size_t myhtml_parser_token_data_to_string(myhtml_tree_t *tree, mycore_string_t*
 size_t myhtml_parser_token_data_to_string_lowercase(myhtml_tree_t *tree, mycore_string_t* str, myhtml_data_process_entry_t* proc_entry, size_t begin, size_t length);
 size_t myhtml_parser_token_data_to_string_charef(myhtml_tree_t *tree, mycore_string_t* str, myhtml_data_process_entry_t* proc_entry, size_t begin, size_t length);
 
+void myhtml_parser_token_text_to_string(myhtml_tree_t *tree, myhtml_token_node_t* token, mycore_string_t* str,
+                                        size_t mchar_node_id, mycore_incoming_buffer_t** inc_buf);
+void myhtml_parser_token_attr_value_to_string(myhtml_tree_t *tree, myhtml_token_attr_t* attr, mycore_string_t* str,
+                                              size_t mchar_node_id, mycore_incoming_buffer_t** inc_buf);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -0,0 +1,285 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#include "myhtml/pool.h"
+#include "myhtml/myhtml.h"
+#include "mycore/utils/mcsync.h"
+
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+static void myhtml_pool_worker(mythread_id_t thread_id, void* arg);
+#endif
+
+myhtml_pool_t * myhtml_pool_create(void)
+{
+    return (myhtml_pool_t*)mycore_calloc(1, sizeof(myhtml_pool_t));
+}
+
+mystatus_t myhtml_pool_init(myhtml_pool_t* pool, size_t thread_count, size_t queue_size)
+{
+#ifdef MyCORE_BUILD_WITHOUT_THREADS
+    thread_count = 1;
+#else
+    if(thread_count == 0)
+        thread_count = mythread_cpu_count();
+#endif
+    
+    if(queue_size == 0)
+        queue_size = thread_count * MyHTML_POOL_QUEUE_SIZE_BY_THREAD;
+    
+    /* all trees of pool are parsed in single mode */
+    pool->myhtml = myhtml_create();
+    if(pool->myhtml == NULL)
+        return MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    mystatus_t status = myhtml_init(pool->myhtml, MyHTML_OPTIONS_PARSE_MODE_SINGLE, 1, 0);
+    if(status)
+        return status;
+    
+    pool->tree_list = (myhtml_tree_t**)mycore_calloc(thread_count, sizeof(myhtml_tree_t*));
+    if(pool->tree_list == NULL)
+        return MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    for(size_t i = 0; i < thread_count; i++) {
+        pool->tree_list[i] = myhtml_tree_create();
+        if(pool->tree_list[i] == NULL)
+            return MyHTML_STATUS_TREE_ERROR_MEMORY_ALLOCATION;
+        
+        pool->tree_list_size++;
+        
+        status = myhtml_tree_init(pool->tree_list[i], pool->myhtml);
+        if(status)
+            return status;
+    }
+    
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    pool->job_list = (myhtml_pool_job_t*)mycore_calloc(queue_size, sizeof(myhtml_pool_job_t));
+    if(pool->job_list == NULL)
+        return MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    pool->job_list_size = queue_size;
+    pool->job_first     = 0;
+    pool->job_length    = 0;
+    pool->job_active    = 0;
+    pool->quit          = false;
+    
+    pool->mutex = mcsync_mutex_create();
+    if(pool->mutex == NULL)
+        return MyCORE_STATUS_THREAD_ERROR_MUTEX_INIT;
+    
+    if(mcsync_mutex_init(pool->mutex)) {
+        mycore_free(pool->mutex);
+        pool->mutex = NULL;
+        
+        return MyCORE_STATUS_THREAD_ERROR_MUTEX_INIT;
+    }
+    
+    pool->thread = mythread_create();
+    if(pool->thread == NULL)
+        return MyCORE_STATUS_THREAD_ERROR_MEMORY_ALLOCATION;
+    
+    status = mythread_init(pool->thread, MyTHREAD_TYPE_STREAM, thread_count, 0);
+    if(status) {
+        pool->thread = mythread_destroy(pool->thread, NULL, NULL, true);
+        return status;
+    }
+    
+    pool->thread->context = pool;
+    
+    for(size_t i = 0; i < thread_count; i++) {
+        status = myhread_entry_create(pool->thread, mythread_function, myhtml_pool_worker, MyTHREAD_OPT_STOP);
+        if(status)
+            return status;
+    }
+    
+    /* threads work until destroy of pool */
+    return mythread_resume(pool->thread, MyTHREAD_OPT_UNDEF);
+#else
+    return MyHTML_STATUS_OK;
+#endif
+}
+
+myhtml_pool_t * myhtml_pool_destroy(myhtml_pool_t* pool, bool self_destroy)
+{
+    if(pool == NULL)
+        return NULL;
+    
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    if(pool->thread) {
+        myhtml_pool_wait_for_all_done(pool);
+        
+        pool->quit = true;
+        mythread_notify(pool->thread);
+        
+        /* workers leave their loop, then they can be quit */
+        mythread_stop(pool->thread);
+        pool->thread = mythread_destroy(pool->thread, mythread_callback_quit, NULL, true);
+    }
+    
+    if(pool->mutex) {
+        mcsync_mutex_destroy(pool->mutex);
+        pool->mutex = NULL;
+    }
+    
+    if(pool->job_list) {
+        mycore_free(pool->job_list);
+        
+        pool->job_list = NULL;
+        pool->job_list_size = 0;
+    }
+#endif
+    
+    if(pool->tree_list) {
+        for(size_t i = 0; i < pool->tree_list_size; i++)
+            myhtml_tree_destroy(pool->tree_list[i]);
+        
+        mycore_free(pool->tree_list);
+        
+        pool->tree_list = NULL;
+        pool->tree_list_size = 0;
+    }
+    
+    if(pool->myhtml)
+        pool->myhtml = myhtml_destroy(pool->myhtml);
+    
+    if(self_destroy) {
+        mycore_free(pool);
+        return NULL;
+    }
+    
+    return pool;
+}
+
+size_t myhtml_pool_tree_count(myhtml_pool_t* pool)
+{
+    return pool->tree_list_size;
+}
+
+myhtml_tree_t * myhtml_pool_tree(myhtml_pool_t* pool, size_t idx)
+{
+    if(idx >= pool->tree_list_size)
+        return NULL;
+    
+    return pool->tree_list[idx];
+}
+
+static void myhtml_pool_parse_job(myhtml_tree_t* tree, myhtml_pool_job_t* job)
+{
+    mystatus_t status = myhtml_parse(tree, job->encoding, job->html, job->html_size);
+    
+    if(job->callback)
+        job->callback(tree, status, job->ctx);
+    
+    /* tree stays ready for the next document, even after error of parsing */
+    myhtml_tree_clean(tree);
+}
+
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+static bool myhtml_pool_job_take(myhtml_pool_t* pool, myhtml_pool_job_t* job)
+{
+    while(1)
+    {
+        mythread_cond_wait_while(pool->thread, pool->thread->cond, pool->job_length == 0 && pool->quit == false);
+        
+        mcsync_mutex_lock(pool->mutex);
+        
+        if(pool->job_length) {
+            bool was_full = (pool->job_length == pool->job_list_size);
+            
+            *job = pool->job_list[pool->job_first];
+            
+            pool->job_first = (pool->job_first + 1) % pool->job_list_size;
+            pool->job_length--;
+            
+            mcsync_mutex_unlock(pool->mutex);
+            
+            /* submit may wait for place in queue */
+            if(was_full)
+                mythread_notify(pool->thread);
+            
+            return true;
+        }
+        
+        mcsync_mutex_unlock(pool->mutex);
+        
+        if(pool->quit)
+            return false;
+    }
+}
+
+static void myhtml_pool_worker(mythread_id_t thread_id, void* arg)
+{
+    mythread_context_t *ctx = (mythread_context_t*)arg;
+    myhtml_pool_t *pool = (myhtml_pool_t*)ctx->mythread->context;
+    myhtml_tree_t *tree = pool->tree_list[thread_id];
+    
+    myhtml_pool_job_t job;
+    
+    while(myhtml_pool_job_take(pool, &job))
+    {
+        myhtml_pool_parse_job(tree, &job);
+        
+        mcsync_mutex_lock(pool->mutex);
+        pool->job_active--;
+        mcsync_mutex_unlock(pool->mutex);
+        
+        mythread_notify(pool->thread);
+    }
+}
+#endif
+
+mystatus_t myhtml_pool_parse(myhtml_pool_t* pool, myencoding_t encoding, const char* html, size_t html_size,
+                             myhtml_callback_pool_done_f callback, void* ctx)
+{
+    myhtml_pool_job_t job = {encoding, html, html_size, callback, ctx};
+    
+#ifdef MyCORE_BUILD_WITHOUT_THREADS
+    myhtml_pool_parse_job(pool->tree_list[0], &job);
+#else
+    while(1)
+    {
+        mythread_cond_wait_while(pool->thread, pool->thread->cond, pool->job_length == pool->job_list_size);
+        
+        mcsync_mutex_lock(pool->mutex);
+        
+        if(pool->job_length < pool->job_list_size) {
+            pool->job_list[ ((pool->job_first + pool->job_length) % pool->job_list_size) ] = job;
+            
+            pool->job_length++;
+            pool->job_active++;
+            
+            mcsync_mutex_unlock(pool->mutex);
+            break;
+        }
+        
+        mcsync_mutex_unlock(pool->mutex);
+    }
+    
+    mythread_notify(pool->thread);
+#endif
+    
+    return MyHTML_STATUS_OK;
+}
+
+void myhtml_pool_wait_for_all_done(myhtml_pool_t* pool)
+{
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    mythread_cond_wait_while(pool->thread, pool->thread->cond, pool->job_active != 0);
+#endif
+}
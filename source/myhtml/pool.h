@@ -0,0 +1,91 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+#ifndef MyHTML_POOL_H
+#define MyHTML_POOL_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "myhtml/myosi.h"
+#include "mycore/mythread.h"
+#include "myencoding/myosi.h"
+
+/*
+ * Parsing of many independent documents by a fixed set of threads.
+ *
+ * Every thread owns one tree and parses whole documents in it one after another,
+ * the tree is cleaned and reused for the next document. All trees belong to one myhtml_t
+ * in MyHTML_OPTIONS_PARSE_MODE_SINGLE, so parsing does not go through the stream thread
+ * and threads share only the queue of submitted documents.
+ */
+
+/* queue size for every thread if 0 is given to init */
+#define MyHTML_POOL_QUEUE_SIZE_BY_THREAD 64
+
+struct myhtml_pool_job {
+    myencoding_t encoding;
+    const char*  html;
+    size_t       html_size;
+    
+    myhtml_callback_pool_done_f callback;
+    void* ctx;
+}
+typedef myhtml_pool_job_t;
+
+struct myhtml_pool {
+    myhtml_t* myhtml;
+    
+    /* one tree for every thread */
+    myhtml_tree_t** tree_list;
+    size_t tree_list_size;
+    
+    /* ring of submitted documents */
+    myhtml_pool_job_t* job_list;
+    size_t job_list_size;
+    size_t job_first;
+    volatile size_t job_length;
+    
+    /* submitted and not done yet */
+    volatile size_t job_active;
+    volatile bool quit;
+    
+    mythread_t* thread;
+    void* mutex;
+};
+
+myhtml_pool_t * myhtml_pool_create(void);
+mystatus_t myhtml_pool_init(myhtml_pool_t* pool, size_t thread_count, size_t queue_size);
+myhtml_pool_t * myhtml_pool_destroy(myhtml_pool_t* pool, bool self_destroy);
+
+size_t myhtml_pool_tree_count(myhtml_pool_t* pool);
+myhtml_tree_t * myhtml_pool_tree(myhtml_pool_t* pool, size_t idx);
+
+mystatus_t myhtml_pool_parse(myhtml_pool_t* pool, myencoding_t encoding, const char* html, size_t html_size,
+                             myhtml_callback_pool_done_f callback, void* ctx);
+void myhtml_pool_wait_for_all_done(myhtml_pool_t* pool);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* MyHTML_POOL_H */
@@ -1214,6 +1214,9 @@ bool myhtml_insertion_mode_in_body(myhtml_tree_t* tree, myhtml_token_node_t* tok
                     else {
                         top_node->token = token;
                     }
+                    
+                    if(tree->index)
+                        myhtml_index_attrs_invalidate(tree->index);
                 }
                 
                 break;
@@ -1266,6 +1269,9 @@ bool myhtml_insertion_mode_in_body(myhtml_tree_t* tree, myhtml_token_node_t* tok
                     else {
                         top_node->token = token;
                     }
+                    
+                    if(tree->index)
+                        myhtml_index_attrs_invalidate(tree->index);
                 }
                 
                 break;
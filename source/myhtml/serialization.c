@@ -123,6 +123,9 @@ mystatus_t myhtml_serialization_node_callback(myhtml_tree_node_t* node, mycore_c
             if(callback("<!--", 4, ptr))
                 return MyCORE_STATUS_ERROR_MEMORY_ALLOCATION;
             
+            if(node->token)
+                myhtml_token_node_materialize(node->tree->token, node->token);
+            
             if(node->token && node->token->str.data) {
                 if(callback(node->token->str.data, node->token->str.length, ptr))
                     return MyCORE_STATUS_ERROR_MEMORY_ALLOCATION;
@@ -350,7 +353,11 @@ mystatus_t myhtml_serialization_node_append_close(myhtml_tree_node_t* node, myco
  */
 mystatus_t myhtml_serialization_node_append_text_node(myhtml_tree_node_t* node, mycore_callback_serialize_f callback, void* ptr)
 {
-    if(node->token == NULL || node->token->str.data == NULL) return MyCORE_STATUS_OK;
+    if(node->token == NULL) return MyCORE_STATUS_OK;
+    
+    myhtml_token_node_materialize(node->tree->token, node->token);
+    
+    if(node->token->str.data == NULL) return MyCORE_STATUS_OK;
     
     if(node->parent == NULL) {
         if(myhtml_serialization_append(node->token->str.data, node->token->str.length, callback, ptr))
@@ -40,8 +40,10 @@ mystatus_t myhtml_stream_buffer_init(myhtml_stream_buffer_t* stream_buffer, size
 mystatus_t myhtml_stream_buffer_entry_init(myhtml_stream_buffer_entry_t* stream_buffer_entry, size_t size)
 {
     if(stream_buffer_entry->data) {
-        if(size <= stream_buffer_entry->size)
+        if(size <= stream_buffer_entry->size) {
+            stream_buffer_entry->length = 0;
             return MyHTML_STATUS_OK;
+        }
         else
             mycore_free(stream_buffer_entry->data);
     }
@@ -80,8 +82,10 @@ myhtml_stream_buffer_entry_t * myhtml_stream_buffer_entry_destroy(myhtml_stream_
 
 void myhtml_stream_buffer_clean(myhtml_stream_buffer_t* stream_buffer)
 {
-    if(stream_buffer)
+    if(stream_buffer) {
         stream_buffer->length = 0;
+        myencoding_result_clean(&stream_buffer->res);
+    }
 }
 
 myhtml_stream_buffer_t * myhtml_stream_buffer_destroy(myhtml_stream_buffer_t* stream_buffer, bool self_destroy)
@@ -90,7 +94,8 @@ myhtml_stream_buffer_t * myhtml_stream_buffer_destroy(myhtml_stream_buffer_t* st
         return NULL;
     
     if(stream_buffer->entries) {
-        for(size_t i = 0; i < stream_buffer->length; i++)
+        /* entries after length keep their data after clean */
+        for(size_t i = 0; i < stream_buffer->size; i++)
             myhtml_stream_buffer_entry_destroy(&stream_buffer->entries[i], false);
         
         mycore_free(stream_buffer->entries);
@@ -109,10 +114,10 @@ myhtml_stream_buffer_entry_t * myhtml_stream_buffer_add_entry(myhtml_stream_buff
     if(stream_buffer->length >= stream_buffer->size) {
         size_t new_size = stream_buffer->size << 1;
         
-        myhtml_stream_buffer_entry_t *entries = mycore_realloc(stream_buffer, sizeof(myhtml_stream_buffer_entry_t) * new_size);
+        myhtml_stream_buffer_entry_t *entries = mycore_realloc(stream_buffer->entries, sizeof(myhtml_stream_buffer_entry_t) * new_size);
         
         if(entries) {
-            memset(&entries[stream_buffer->size], 0, (new_size - stream_buffer->size));
+            memset(&entries[stream_buffer->size], 0, sizeof(myhtml_stream_buffer_entry_t) * (new_size - stream_buffer->size));
             
             stream_buffer->entries = entries;
             stream_buffer->size = new_size;
@@ -140,4 +145,35 @@ myhtml_stream_buffer_entry_t * myhtml_stream_buffer_current_entry(myhtml_stream_
     return &stream_buffer->entries[ (stream_buffer->length - 1) ];
 }
 
-
+/*
+ * Entries before the one with data are not used anymore; they go after the used ones
+ * and keep their data for myhtml_stream_buffer_add_entry. Current entry is never released.
+ */
+void myhtml_stream_buffer_release_before(myhtml_stream_buffer_t* stream_buffer, const char* data)
+{
+    size_t count = 0;
+    
+    while(count < stream_buffer->length) {
+        myhtml_stream_buffer_entry_t *entry = &stream_buffer->entries[count];
+        
+        if(data >= entry->data && data < (entry->data + entry->size))
+            break;
+        
+        count++;
+    }
+    
+    if(count >= stream_buffer->length)
+        return;
+    
+    while(count) {
+        myhtml_stream_buffer_entry_t released = stream_buffer->entries[0];
+        
+        memmove(stream_buffer->entries, &stream_buffer->entries[1],
+                sizeof(myhtml_stream_buffer_entry_t) * (stream_buffer->length - 1));
+        
+        stream_buffer->length--;
+        stream_buffer->entries[ stream_buffer->length ] = released;
+        
+        count--;
+    }
+}
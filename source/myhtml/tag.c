@@ -27,34 +27,56 @@ myhtml_tag_t * myhtml_tag_create(void)
 }
 
 mystatus_t myhtml_tag_init(myhtml_tree_t *tree, myhtml_tag_t *tags)
+{
+    /*
+     * Static tags live in one process-wide table (see tag_init.c),
+     * custom tags of the tree are created on first myhtml_tag_add
+     */
+    tags->mcsimple_context = NULL;
+    tags->tree             = NULL;
+    tags->mchar            = tree->mchar;
+    tags->mchar_node       = 0;
+    tags->tags_count       = MyHTML_TAG_LAST_ENTRY;
+    
+    return MyHTML_STATUS_OK;
+}
+
+static mystatus_t myhtml_tag_overlay_init(myhtml_tag_t *tags)
 {
     mystatus_t status;
     
+    tags->mchar_node = mchar_async_node_add(tags->mchar, &status);
+    
+    if(status)
+        return status;
+    
     tags->mcsimple_context = mcsimple_create();
     
-    if(tags->mcsimple_context == NULL)
+    if(tags->mcsimple_context == NULL) {
+        mchar_async_node_delete(tags->mchar, tags->mchar_node);
         return MyHTML_STATUS_TAGS_ERROR_MEMORY_ALLOCATION;
+    }
     
+    mcsimple_allocator_set(tags->mcsimple_context, tags->mchar->allocator);
     mcsimple_init(tags->mcsimple_context, 128, 1024, sizeof(myhtml_tag_context_t));
     
-    tags->mchar_node = mchar_async_node_add(tree->mchar, &status);
-    tags->tree       = mctree_create(2);
-    tags->mchar      = tree->mchar;
-    tags->tags_count = MyHTML_TAG_LAST_ENTRY;
+    tags->tree = mctree_create(2);
     
-    if(status)
-        return status;
-    
-    if(tags->tree == NULL)
+    if(tags->tree == NULL) {
+        tags->mcsimple_context = mcsimple_destroy(tags->mcsimple_context, true);
+        mchar_async_node_delete(tags->mchar, tags->mchar_node);
+        
         return MyCORE_STATUS_ERROR_MEMORY_ALLOCATION;
-    
-    myhtml_tag_clean(tags);
+    }
     
     return MyHTML_STATUS_OK;
 }
 
 void myhtml_tag_clean(myhtml_tag_t* tags)
 {
+    if(tags->tags_count == MyHTML_TAG_LAST_ENTRY)
+        return;
+    
     tags->tags_count = MyHTML_TAG_LAST_ENTRY;
     
     mcsimple_clean(tags->mcsimple_context);
@@ -67,10 +89,12 @@ myhtml_tag_t * myhtml_tag_destroy(myhtml_tag_t* tags)
     if(tags == NULL)
         return NULL;
     
-    tags->tree = mctree_destroy(tags->tree);
-    tags->mcsimple_context = mcsimple_destroy(tags->mcsimple_context, true);
-    
-    mchar_async_node_delete(tags->mchar, tags->mchar_node);
+    if(tags->tree) {
+        tags->tree = mctree_destroy(tags->tree);
+        tags->mcsimple_context = mcsimple_destroy(tags->mcsimple_context, true);
+        
+        mchar_async_node_delete(tags->mchar, tags->mchar_node);
+    }
     
     mycore_free(tags);
     
@@ -80,8 +104,14 @@ myhtml_tag_t * myhtml_tag_destroy(myhtml_tag_t* tags)
 myhtml_tag_id_t myhtml_tag_add(myhtml_tag_t* tags, const char* key, size_t key_size,
                               enum myhtml_tokenizer_state data_parser, bool to_lcase)
 {
+    if(tags->tree == NULL && myhtml_tag_overlay_init(tags))
+        return MyHTML_TAG__UNDEF;
+    
     char* cache = mchar_async_malloc(tags->mchar, tags->mchar_node, (key_size + 1));
     
+    if(cache == NULL)
+        return MyHTML_TAG__UNDEF;
+    
     if(to_lcase) {
         size_t i;
         for(i = 0; i < key_size; i++) {
@@ -98,6 +128,9 @@ myhtml_tag_id_t myhtml_tag_add(myhtml_tag_t* tags, const char* key, size_t key_s
     
     myhtml_tag_context_t *tag_ctx = mcsimple_malloc(tags->mcsimple_context);
     
+    if(tag_ctx == NULL)
+        return MyHTML_TAG__UNDEF;
+    
     mctree_insert(tags->tree, cache, key_size, (void *)tag_ctx, NULL);
     
     tag_ctx->id          = tags->tags_count;
@@ -115,7 +148,7 @@ myhtml_tag_id_t myhtml_tag_add(myhtml_tag_t* tags, const char* key, size_t key_s
 void myhtml_tag_set_category(myhtml_tag_t* tags, myhtml_tag_id_t tag_idx,
                                        enum myhtml_namespace ns, enum myhtml_tag_categories cats)
 {
-    if(tag_idx < MyHTML_TAG_LAST_ENTRY)
+    if(tag_idx < MyHTML_TAG_LAST_ENTRY || tag_idx >= tags->tags_count)
         return;
     
     myhtml_tag_context_t *tag_ctx = mcsimple_get_by_absolute_position(tags->mcsimple_context, (tag_idx - MyHTML_TAG_LAST_ENTRY));
@@ -125,6 +158,9 @@ void myhtml_tag_set_category(myhtml_tag_t* tags, myhtml_tag_id_t tag_idx,
 const myhtml_tag_context_t * myhtml_tag_get_by_id(myhtml_tag_t* tags, myhtml_tag_id_t tag_id)
 {
     if(tag_id >= MyHTML_TAG_LAST_ENTRY) {
+        if(tag_id >= tags->tags_count)
+            return NULL;
+        
         return mcsimple_get_by_absolute_position(tags->mcsimple_context, (tag_id - MyHTML_TAG_LAST_ENTRY));
     }
     
@@ -135,7 +171,7 @@ const myhtml_tag_context_t * myhtml_tag_get_by_name(myhtml_tag_t* tags, const ch
 {
     const myhtml_tag_context_t *ctx = myhtml_tag_static_search(name, length);
     
-    if(ctx)
+    if(ctx || tags->tree == NULL)
         return ctx;
     
     mctree_index_t idx = mctree_search_lowercase(tags->tree, name, length);
@@ -19,6 +19,7 @@
 */
 
 #include "myhtml/token.h"
+#include "myhtml/parser.h"
 
 // all key size == value size
 static const myhtml_token_replacement_entry_t myhtml_token_attr_svg_replacement[] = {
@@ -123,6 +124,9 @@ myhtml_token_t * myhtml_token_create(myhtml_tree_t* tree, size_t size)
         return NULL;
     }
     
+    mcobject_async_allocator_set(token->nodes_obj, tree->myhtml->allocator);
+    mcobject_async_allocator_set(token->attr_obj, tree->myhtml->allocator);
+    
     mcobject_async_init(token->nodes_obj, 128, size, sizeof(myhtml_token_node_t));
     mcobject_async_init(token->attr_obj, 128, size, sizeof(myhtml_token_attr_t));
     
@@ -187,6 +191,8 @@ myhtml_token_attr_t * myhtml_token_attr_create(myhtml_token_t* token, size_t asy
         return NULL;
     
     myhtml_token_attr_clean(attr_node);
+    attr_node->tree = token->tree;
+    
     return attr_node;
 }
 
@@ -256,8 +262,94 @@ bool myhtml_token_node_is_close_self(myhtml_token_node_t *token_node)
 void myhtml_token_node_wait_for_done(myhtml_token_t* token, myhtml_token_node_t* node)
 {
 #ifndef MyCORE_BUILD_WITHOUT_THREADS
-    while((node->type & MyHTML_TOKEN_TYPE_DONE) == 0) {mythread_nanosleep_sleep(token->tree->myhtml->thread_stream->timespec);}
+    if((node->type & MyHTML_TOKEN_TYPE_DONE) == 0) {
+        mythread_t *mythread = token->tree->myhtml->thread_stream;
+        mythread_queue_list_t *queue_list = (mythread_queue_list_t*)mythread->context;
+        
+        mythread_cond_wait_while(mythread, queue_list->cond, (node->type & MyHTML_TOKEN_TYPE_DONE) == 0);
+    }
+#endif
+    
+    /* all who wait for token read it text */
+    myhtml_token_node_materialize(token, node);
+}
+
+void myhtml_token_node_materialize(myhtml_token_t* token, myhtml_token_node_t* node)
+{
+    if(node->str.data) {
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+        /* pairs with the fence before data is set: length and others are read after it */
+        mcsync_atomic_fence();
+#endif
+        return;
+    }
+    
+    if(node->raw_length == 0 || (node->type & MyHTML_TOKEN_TYPE_DONE) == 0 ||
+       (node->tag_id != MyHTML_TAG__TEXT && node->tag_id != MyHTML_TAG__COMMENT))
+    {
+        return;
+    }
+    
+    myhtml_tree_t* tree = token->tree;
+    
+    mcsync_lock(tree->sync);
+    
+    if(node->str.data == NULL) {
+        mycore_string_t str;
+        mycore_incoming_buffer_t *inc_buf = NULL;
+        
+        myhtml_parser_token_text_to_string(tree, node, &str, tree->mchar_node_id, &inc_buf);
+        
+        /* readers without lock check data only */
+        node->str.size     = str.size;
+        node->str.length   = str.length;
+        node->str.mchar    = str.mchar;
+        node->str.node_idx = str.node_idx;
+        
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+        mcsync_atomic_fence();
+#endif
+        node->str.data = str.data;
+    }
+    
+    mcsync_unlock(tree->sync);
+}
+
+void myhtml_token_attr_materialize(myhtml_token_attr_t* attr)
+{
+    if(attr->value.data) {
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+        /* pairs with the fence before data is set */
+        mcsync_atomic_fence();
+#endif
+        return;
+    }
+    
+    if(attr->raw_value_length == 0 || attr->tree == NULL)
+        return;
+    
+    myhtml_tree_t* tree = attr->tree;
+    
+    mcsync_lock(tree->sync);
+    
+    if(attr->value.data == NULL) {
+        mycore_string_t str;
+        mycore_incoming_buffer_t *inc_buf = NULL;
+        
+        myhtml_parser_token_attr_value_to_string(tree, attr, &str, tree->mchar_node_id, &inc_buf);
+        
+        attr->value.size     = str.size;
+        attr->value.length   = str.length;
+        attr->value.mchar    = str.mchar;
+        attr->value.node_idx = str.node_idx;
+        
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+        mcsync_atomic_fence();
 #endif
+        attr->value.data = str.data;
+    }
+    
+    mcsync_unlock(tree->sync);
 }
 
 void myhtml_token_set_done(myhtml_token_node_t* node)
@@ -285,6 +377,8 @@ myhtml_token_node_t * myhtml_token_node_clone(myhtml_token_t* token, myhtml_toke
     new_node->element_begin  = node->element_begin;
     new_node->element_length = node->element_length;
     
+    myhtml_token_node_materialize(token, node);
+    
     if(node->str.length) {
         mycore_string_init(tree->mchar, tree->mchar_node_id, &new_node->str, node->str.length + 1);
         mycore_string_append(&new_node->str, node->str.data, node->str.length);
@@ -310,7 +404,7 @@ myhtml_token_attr_t * myhtml_token_node_attr_append(myhtml_token_t* token, myhtm
                                    const char* value, size_t value_len, size_t thread_idx)
 {
     myhtml_token_attr_t* new_attr = mcobject_async_malloc(token->attr_obj, thread_idx, NULL);
-    new_attr->next = 0;
+    myhtml_token_attr_clean(new_attr);
     
     if(key_len) {
         mycore_string_init(token->tree->mchar, token->tree->mchar_node_id, &new_attr->key, (key_len + 1));
@@ -350,7 +444,7 @@ myhtml_token_attr_t * myhtml_token_node_attr_append_with_convert_encoding(myhtml
                                                                           size_t thread_idx, myencoding_t encoding)
 {
     myhtml_token_attr_t* new_attr = mcobject_async_malloc(token->attr_obj, thread_idx, NULL);
-    new_attr->next = 0;
+    myhtml_token_attr_clean(new_attr);
     
     if(key_len) {
         mycore_string_init(token->tree->mchar, token->tree->mchar_node_id, &new_attr->key, (key_len + 1));
@@ -419,8 +513,10 @@ void myhtml_token_node_attr_copy(myhtml_token_t* token, myhtml_token_node_t* tar
 
 bool myhtml_token_attr_copy(myhtml_token_t* token, myhtml_token_attr_t* attr, myhtml_token_node_t* dest, size_t thread_idx)
 {
+    myhtml_token_attr_materialize(attr);
+    
     myhtml_token_attr_t* new_attr = mcobject_async_malloc(token->attr_obj, thread_idx, NULL);
-    new_attr->next = 0;
+    myhtml_token_attr_clean(new_attr);
     
     if(attr->key.length) {
         mycore_string_init(token->tree->mchar, token->tree->mchar_node_id, &new_attr->key, (attr->key.length + 1));
@@ -461,6 +557,8 @@ myhtml_token_attr_t * myhtml_token_attr_match(myhtml_token_t* token, myhtml_toke
     
     while (attr)
     {
+        myhtml_token_attr_materialize(attr);
+        
         if(attr->key.length == key_size && attr->value.length == value_size)
         {
             if((mycore_strcmp(attr->key.data, key) == 0)) {
@@ -484,6 +582,8 @@ myhtml_token_attr_t * myhtml_token_attr_match_case(myhtml_token_t* token, myhtml
     
     while (attr)
     {
+        myhtml_token_attr_materialize(attr);
+        
         if(attr->key.length == key_size && attr->value.length == value_size)
         {
             if((mycore_strcmp(attr->key.data, key) == 0)) {
@@ -519,6 +619,13 @@ void myhtml_token_strict_doctype_by_token(myhtml_token_t* token, myhtml_token_no
 {
     myhtml_token_attr_t* attr = target->attr_first;
     
+    while(attr) {
+        myhtml_token_attr_materialize(attr);
+        attr = attr->next;
+    }
+    
+    attr = target->attr_first;
+    
     if(attr && attr->key.length) {
         _myhtml_token_create_copy_srt(token, attr->key.data, attr->key.length, &return_doctype->attr_name);
         
@@ -713,6 +820,9 @@ bool myhtml_token_attr_compare(myhtml_token_node_t* target, myhtml_token_node_t*
     
     while (target_attr && dest_attr)
     {
+        myhtml_token_attr_materialize(target_attr);
+        myhtml_token_attr_materialize(dest_attr);
+        
         if(target_attr->key.length == dest_attr->key.length &&
            target_attr->value.length == dest_attr->value.length)
         {
@@ -761,6 +871,23 @@ void myhtml_token_delete(myhtml_token_t* token, myhtml_token_node_t* node)
     mcobject_async_free(token->nodes_obj, node);
 }
 
+void myhtml_token_node_free(myhtml_token_t* token, myhtml_token_node_t* node)
+{
+    myhtml_token_attr_delete_all(token, node);
+    
+    myhtml_token_attr_t* attr = node->attr_first;
+    
+    while (attr)
+    {
+        myhtml_token_attr_t* next = attr->next;
+        mcobject_async_free(token->attr_obj, attr);
+        
+        attr = next;
+    }
+    
+    myhtml_token_delete(token, node);
+}
+
 void myhtml_token_attr_delete_all(myhtml_token_t* token, myhtml_token_node_t* node)
 {
     myhtml_token_attr_t* attr = node->attr_first;
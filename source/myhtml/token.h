@@ -69,6 +69,9 @@ struct myhtml_token_attr {
     size_t raw_value_begin;
     size_t raw_value_length;
     
+    /* ref, for decode of value by MyHTML_TREE_PARSE_FLAGS_LAZY_STRINGS */
+    myhtml_tree_t* tree;
+    
     enum myhtml_namespace ns;
 };
 
@@ -130,7 +133,10 @@ myhtml_token_attr_t * myhtml_token_attr_remove_by_name(myhtml_token_node_t* node
 void myhtml_token_attr_delete_all(myhtml_token_t* token, myhtml_token_node_t* node);
 
 void myhtml_token_delete(myhtml_token_t* token, myhtml_token_node_t* node);
+void myhtml_token_node_free(myhtml_token_t* token, myhtml_token_node_t* node);
 void myhtml_token_node_wait_for_done(myhtml_token_t* token, myhtml_token_node_t* node);
+void myhtml_token_node_materialize(myhtml_token_t* token, myhtml_token_node_t* node);
+void myhtml_token_attr_materialize(myhtml_token_attr_t* attr);
 void myhtml_token_set_done(myhtml_token_node_t* node);
 
 myhtml_token_attr_t * myhtml_token_attr_match(myhtml_token_t* token, myhtml_token_node_t* target, const char* key, size_t key_size, const char* value, size_t value_size);
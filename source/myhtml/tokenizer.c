@@ -42,6 +42,37 @@ mystatus_t myhtml_tokenizer_begin(myhtml_tree_t* tree, const char* html, size_t
     return myhtml_tokenizer_chunk(tree, html, html_length);
 }
 
+/* buffers which end before current token are not needed for parsing anymore */
+static void myhtml_tokenizer_chunk_release_buffers(myhtml_tree_t* tree)
+{
+    mycore_incoming_buffer_t *inc_buf = tree->incoming_buf_first;
+    size_t token_begin = tree->current_token_node->element_begin;
+    
+    if(tree->current_token_node->raw_begin < token_begin)
+        token_begin = tree->current_token_node->raw_begin;
+    
+    while(inc_buf != tree->incoming_buf && (inc_buf->offset + inc_buf->size) <= token_begin) {
+        mycore_incoming_buffer_t *next = inc_buf->next;
+        mcobject_free(tree->mcobject_incoming_buf, inc_buf);
+        
+        inc_buf = next;
+    }
+    
+    if(inc_buf == tree->incoming_buf_first)
+        return;
+    
+    inc_buf->prev = NULL;
+    tree->incoming_buf_first = inc_buf;
+    
+    /* position cache of workers can point to released buffer */
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+    for(size_t i = 0; i < tree->myhtml->thread_total; i++)
+        tree->async_args[i].incoming_buf = NULL;
+#else
+    tree->async_args->incoming_buf = NULL;
+#endif
+}
+
 mystatus_t myhtml_tokenizer_chunk_process(myhtml_tree_t* tree, const char* html, size_t html_length)
 {
     myhtml_t* myhtml = tree->myhtml;
@@ -55,6 +86,10 @@ mystatus_t myhtml_tokenizer_chunk_process(myhtml_tree_t* tree, const char* html,
     if(myhtml->opt & MyHTML_OPTIONS_PARSE_MODE_SINGLE)
         tree->flags |= MyHTML_TREE_FLAGS_SINGLE_MODE;
     
+    /* tokens are freed right after processing, it can not be done in other thread */
+    if((tree->parse_flags & MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM) == MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM)
+        tree->flags |= MyHTML_TREE_FLAGS_SINGLE_MODE;
+    
     if((tree->flags & MyHTML_TREE_FLAGS_SINGLE_MODE) == 0)
     {
         if(tree->queue_entry == NULL) {
@@ -82,12 +117,15 @@ mystatus_t myhtml_tokenizer_chunk_process(myhtml_tree_t* tree, const char* html,
     
     size_t offset = 0;
     
-    while (offset < html_length) {
+    while (offset < html_length && tree->tokenizer_status == MyHTML_STATUS_OK) {
         offset = state_f[tree->state](tree, tree->current_token_node, html, offset, html_length);
     }
     
     tree->global_offset += html_length;
     
+    if((tree->parse_flags & MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM) == MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM)
+        myhtml_tokenizer_chunk_release_buffers(tree);
+    
     return MyHTML_STATUS_OK;
 }
 
@@ -99,14 +137,19 @@ mystatus_t myhtml_tokenizer_chunk(myhtml_tree_t* tree, const char* html, size_t
         return myhtml_tokenizer_chunk_with_stream_buffer(tree, html, html_length);
     }
     
+    /* MyENCODING_DEFAULT is UTF-8 now, but keep it out if it changes to detection */
+    if((tree->parse_flags & MyHTML_TREE_PARSE_FLAGS_CONVERT_TO_UTF_8) &&
+       tree->encoding_usereq != MyENCODING_UTF_8 &&
+       tree->encoding_usereq != MyENCODING_DEFAULT)
+    {
+        return myhtml_tokenizer_chunk_with_stream_buffer(tree, html, html_length);
+    }
+    
     return myhtml_tokenizer_chunk_process(tree, html, html_length);
 }
 
 mystatus_t myhtml_tokenizer_chunk_with_stream_buffer(myhtml_tree_t* tree, const char* html, size_t html_length)
 {
-    unsigned const char* u_html = (unsigned const char*)html;
-    const myencoding_custom_f func = myencoding_get_function_by_id(tree->encoding);
-    
     if(tree->stream_buffer == NULL) {
         tree->stream_buffer = myhtml_stream_buffer_create();
         
@@ -117,42 +160,55 @@ mystatus_t myhtml_tokenizer_chunk_with_stream_buffer(myhtml_tree_t* tree, const
         
         if(status)
             return status;
-        
-        if(myhtml_stream_buffer_add_entry(tree->stream_buffer, (4096 * 4)) == NULL)
-            return MyHTML_STATUS_STREAM_BUFFER_ERROR_ADD_ENTRY;
     }
     
     myhtml_stream_buffer_t *stream_buffer = tree->stream_buffer;
     myhtml_stream_buffer_entry_t *stream_entry = myhtml_stream_buffer_current_entry(stream_buffer);
     
-    size_t temp_curr_pos = stream_entry->length;
+    if(stream_entry == NULL) {
+        stream_entry = myhtml_stream_buffer_add_entry(stream_buffer, (4096 * 4));
+        
+        if(stream_entry == NULL)
+            return MyHTML_STATUS_STREAM_BUFFER_ERROR_ADD_ENTRY;
+    }
     
-    for (size_t i = 0; i < html_length; i++)
+    /* tokenizer gets UTF-8, source encoding is what user requested */
+    tree->encoding = MyENCODING_UTF_8;
+    
+    size_t offset = 0;
+    
+    while(offset < html_length)
     {
-        if(func(u_html[i], &stream_buffer->res) == MyENCODING_STATUS_OK)
-        {
-            if((stream_entry->length + 4) >= stream_entry->size)
+        if((stream_entry->size - stream_entry->length) < 4) {
+            stream_entry = myhtml_stream_buffer_add_entry(stream_buffer, (4096 * 4));
+            
+            if(stream_entry == NULL)
+                return MyHTML_STATUS_STREAM_BUFFER_ERROR_ADD_ENTRY;
+        }
+        
+        size_t temp_curr_pos = stream_entry->length;
+        
+        stream_entry->length += myencoding_decode_chunk_to_ascii_utf_8(tree->encoding_usereq, &stream_buffer->res,
+                                                                       html, html_length, &offset,
+                                                                       &stream_entry->data[temp_curr_pos],
+                                                                       (stream_entry->size - temp_curr_pos));
+        
+        if(stream_entry->length != temp_curr_pos) {
+            mystatus_t status = myhtml_tokenizer_chunk_process(tree, &stream_entry->data[temp_curr_pos],
+                                                              (stream_entry->length - temp_curr_pos));
+            if(status)
+                return status;
+            
+            /* like incoming buffers, decoded text before current token is not needed */
+            if((tree->parse_flags & MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM) == MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM &&
+               tree->incoming_buf_first)
             {
-                tree->encoding = MyENCODING_UTF_8;
-                myhtml_tokenizer_chunk_process(tree, &stream_entry->data[temp_curr_pos], (stream_entry->length - temp_curr_pos));
-                
-                stream_entry = myhtml_stream_buffer_add_entry(stream_buffer, (4096 * 4));
-                
-                if(stream_entry == NULL)
-                    return MyHTML_STATUS_STREAM_BUFFER_ERROR_ADD_ENTRY;
-                
-                temp_curr_pos = stream_entry->length;
+                myhtml_stream_buffer_release_before(stream_buffer, tree->incoming_buf_first->data);
+                stream_entry = myhtml_stream_buffer_current_entry(stream_buffer);
             }
-            
-            stream_entry->length += myencoding_codepoint_to_ascii_utf_8(stream_buffer->res.result, &stream_entry->data[ stream_entry->length ]);
         }
     }
     
-    if((stream_entry->length - temp_curr_pos)) {
-        tree->encoding = MyENCODING_UTF_8;
-        myhtml_tokenizer_chunk_process(tree, &stream_entry->data[temp_curr_pos], (stream_entry->length - temp_curr_pos));
-    }
-    
     return MyHTML_STATUS_OK;
 }
 
@@ -194,6 +250,8 @@ mystatus_t myhtml_tokenizer_end(myhtml_tree_t* tree)
     
 #endif
     
+    myhtml_tree_pruned_clean(tree);
+    
     tree->flags |= MyHTML_TREE_FLAGS_PARSE_END;
     
     return status;
@@ -218,7 +276,12 @@ myhtml_tree_node_t * myhtml_tokenizer_fragment_init(myhtml_tree_t* tree, myhtml_
         }
         else {
             const myhtml_tag_context_t *tag_ctx = myhtml_tag_get_by_id(tree->tags, tag_idx);
-            myhtml_tokenizer_state_set(tree) = tag_ctx->data_parser;
+            
+            /* custom tag id of a cleaned tree is not known; custom tags are parsed as data */
+            if(tag_ctx)
+                myhtml_tokenizer_state_set(tree) = tag_ctx->data_parser;
+            else
+                myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_DATA;
         }
     }
     
@@ -323,6 +386,12 @@ void myhtml_check_tag_parser(myhtml_tree_t* tree, myhtml_token_node_t* token_nod
             token_node->tag_id = myhtml_tag_add(tags, &html[ (token_node->raw_begin - tree->global_offset) ], token_node->raw_length, MyHTML_TOKENIZER_STATE_DATA, true);
         }
         
+        /* no memory for custom tag; stop, as on other allocation errors of tokenizer */
+        if(token_node->tag_id == MyHTML_TAG__UNDEF) {
+            tree->tokenizer_status = MyHTML_STATUS_TOKENIZER_ERROR_MEMORY_ALLOCATION;
+            return;
+        }
+        
         myhtml_tag_set_category(tags, token_node->tag_id, MyHTML_NAMESPACE_HTML, MyHTML_TAG_CATEGORIES_ORDINARY);
     }
 }
@@ -390,19 +459,14 @@ size_t myhtml_tokenizer_state_rcdata(myhtml_tree_t* tree, myhtml_token_node_t* t
         }
     }
     
-    while(html_offset < html_size)
+    html_offset = mcscan_char(html, html_offset, html_size, '<');
+    
+    if(html_offset < html_size)
     {
-        if(html[html_offset] == '<')
-        {
-            token_node->element_begin = (html_offset + tree->global_offset);
-            
-            html_offset++;
-            myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_RCDATA_LESS_THAN_SIGN;
-            
-            break;
-        }
+        token_node->element_begin = (html_offset + tree->global_offset);
         
         html_offset++;
+        myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_RCDATA_LESS_THAN_SIGN;
     }
     
     return html_offset;
@@ -567,19 +631,14 @@ size_t myhtml_tokenizer_state_rawtext(myhtml_tree_t* tree, myhtml_token_node_t*
     }
 
     
-    while(html_offset < html_size)
+    html_offset = mcscan_char(html, html_offset, html_size, '<');
+    
+    if(html_offset < html_size)
     {
-        if(html[html_offset] == '<')
-        {
-            token_node->element_begin = (html_offset + tree->global_offset);
-            
-            html_offset++;
-            myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_RAWTEXT_LESS_THAN_SIGN;
-            
-            break;
-        }
+        token_node->element_begin = (html_offset + tree->global_offset);
         
         html_offset++;
+        myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_RAWTEXT_LESS_THAN_SIGN;
     }
     
     return html_offset;
@@ -755,6 +814,20 @@ size_t myhtml_tokenizer_state_data(myhtml_tree_t* tree, myhtml_token_node_t* tok
 {
     while(html_offset < html_size)
     {
+        /* text up to the next '<' or '\0' */
+        size_t text_end = mcscan_char2(html, html_offset, html_size, '<', '\0');
+        
+        if(token_node->type & MyHTML_TOKEN_TYPE_WHITESPACE &&
+           mcscan_not_whitespace(html, html_offset, text_end) < text_end) {
+            token_node->type ^= (token_node->type & MyHTML_TOKEN_TYPE_WHITESPACE);
+            token_node->type |= MyHTML_TOKEN_TYPE_DATA;
+        }
+        
+        html_offset = text_end;
+        
+        if(html_offset >= html_size)
+            break;
+        
         if(html[html_offset] == '<')
         {
             token_node->element_begin = (tree->global_offset + html_offset);
@@ -764,14 +837,13 @@ size_t myhtml_tokenizer_state_data(myhtml_tree_t* tree, myhtml_token_node_t* tok
             
             break;
         }
-        else if(html[html_offset] == '\0' && (token_node->type & MyHTML_TOKEN_TYPE_NULL) == 0) {
+        else if((token_node->type & MyHTML_TOKEN_TYPE_NULL) == 0) {
             // parse error
             /* %EXTERNAL% VALIDATOR:TOKENIZER POSITION STATUS:CHAR_NULL LEVEL:ERROR BEGIN:html_offset LENGTH:1 */
             
             token_node->type |= MyHTML_TOKEN_TYPE_NULL;
         }
-        else if(token_node->type & MyHTML_TOKEN_TYPE_WHITESPACE &&
-                mycore_tokenizer_chars_map[ (unsigned char)html[html_offset] ] != MyCORE_STRING_MAP_CHAR_WHITESPACE) {
+        else if(token_node->type & MyHTML_TOKEN_TYPE_WHITESPACE) {
             token_node->type ^= (token_node->type & MyHTML_TOKEN_TYPE_WHITESPACE);
             token_node->type |= MyHTML_TOKEN_TYPE_DATA;
         }
@@ -1308,24 +1380,20 @@ size_t myhtml_tokenizer_state_attribute_value_double_quoted(myhtml_tree_t* tree,
 {
     //myhtml_t* myhtml = tree->myhtml;
     
-    while(html_offset < html_size)
+    html_offset = mcscan_char(html, html_offset, html_size, '"');
+    
+    if(html_offset < html_size)
     {
-        if(html[html_offset] == '"')
-        {
-            tree->attr_current->raw_value_length = (tree->global_offset + html_offset) - tree->attr_current->raw_value_begin;
-            
-            tree->attr_current = myhtml_token_attr_create(tree->token, tree->token->mcasync_attr_id);
-            if(tree->attr_current == NULL) {
-                myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_PARSE_ERROR_STOP;
-                return 0;
-            }
-            
-            myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_AFTER_ATTRIBUTE_VALUE_QUOTED;
-            
-            html_offset++;
-            break;
+        tree->attr_current->raw_value_length = (tree->global_offset + html_offset) - tree->attr_current->raw_value_begin;
+        
+        tree->attr_current = myhtml_token_attr_create(tree->token, tree->token->mcasync_attr_id);
+        if(tree->attr_current == NULL) {
+            myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_PARSE_ERROR_STOP;
+            return 0;
         }
         
+        myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_AFTER_ATTRIBUTE_VALUE_QUOTED;
+        
         html_offset++;
     }
     
@@ -1340,24 +1408,20 @@ size_t myhtml_tokenizer_state_attribute_value_single_quoted(myhtml_tree_t* tree,
 {
     //myhtml_t* myhtml = tree->myhtml;
     
-    while(html_offset < html_size)
+    html_offset = mcscan_char(html, html_offset, html_size, '\'');
+    
+    if(html_offset < html_size)
     {
-        if(html[html_offset] == '\'')
-        {
-            tree->attr_current->raw_value_length = (tree->global_offset + html_offset) - tree->attr_current->raw_value_begin;
-            
-            tree->attr_current = myhtml_token_attr_create(tree->token, tree->token->mcasync_attr_id);
-            if(tree->attr_current == NULL) {
-                myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_PARSE_ERROR_STOP;
-                return 0;
-            }
-            
-            myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_AFTER_ATTRIBUTE_VALUE_QUOTED;
-            
-            html_offset++;
-            break;
+        tree->attr_current->raw_value_length = (tree->global_offset + html_offset) - tree->attr_current->raw_value_begin;
+        
+        tree->attr_current = myhtml_token_attr_create(tree->token, tree->token->mcasync_attr_id);
+        if(tree->attr_current == NULL) {
+            myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_PARSE_ERROR_STOP;
+            return 0;
         }
         
+        myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_AFTER_ATTRIBUTE_VALUE_QUOTED;
+        
         html_offset++;
     }
     
@@ -1522,15 +1586,11 @@ size_t myhtml_tokenizer_state_comment(myhtml_tree_t* tree, myhtml_token_node_t*
 {
     token_node->tag_id = MyHTML_TAG__COMMENT;
     
-    while(html_offset < html_size)
+    html_offset = mcscan_char(html, html_offset, html_size, '-');
+    
+    if(html_offset < html_size)
     {
-        if(html[html_offset] == '-')
-        {
-            myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_COMMENT_END_DASH;
-            html_offset++;
-            break;
-        }
-        
+        myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_COMMENT_END_DASH;
         html_offset++;
     }
     
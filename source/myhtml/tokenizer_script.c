@@ -23,18 +23,13 @@
 
 size_t myhtml_tokenizer_state_script_data(myhtml_tree_t* tree, myhtml_token_node_t* token_node, const char* html, size_t html_offset, size_t html_size)
 {
-    while (html_offset < html_size)
-    {
-        if(html[html_offset] == '<') {
-            token_node->element_begin = (tree->global_offset + html_offset);
-            
-            html_offset++;
-            myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_SCRIPT_DATA_LESS_THAN_SIGN;
-            
-            break;
-        }
+    html_offset = mcscan_char(html, html_offset, html_size, '<');
+    
+    if(html_offset < html_size) {
+        token_node->element_begin = (tree->global_offset + html_offset);
         
         html_offset++;
+        myhtml_tokenizer_state_set(tree) = MyHTML_TOKENIZER_STATE_SCRIPT_DATA_LESS_THAN_SIGN;
     }
     
     return html_offset;
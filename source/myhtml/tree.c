@@ -19,6 +19,7 @@
 */
 
 #include "myhtml/tree.h"
+#include "myhtml/index.h"
 
 myhtml_tree_t * myhtml_tree_create(void)
 {
@@ -49,6 +50,10 @@ mystatus_t myhtml_tree_init(myhtml_tree_t* tree, myhtml_t* myhtml)
     tree->callback_tree_node_remove     = NULL;
     tree->callback_tree_node_insert_ctx = NULL;
     tree->callback_tree_node_remove_ctx = NULL;
+    tree->callback_tree_node_prune      = NULL;
+    tree->callback_tree_node_prune_ctx  = NULL;
+    
+    tree->index = NULL;
     
     if(status)
         return status;
@@ -67,6 +72,8 @@ mystatus_t myhtml_tree_init(myhtml_tree_t* tree, myhtml_t* myhtml)
     if(tree->mcobject_incoming_buf == NULL)
         return MyHTML_STATUS_TREE_ERROR_INCOMING_BUFFER_CREATE;
     
+    mcobject_allocator_set(tree->mcobject_incoming_buf, myhtml->allocator);
+    
     status = mcobject_init(tree->mcobject_incoming_buf, 256, sizeof(mycore_incoming_buffer_t));
     if(status)
         return status;
@@ -76,6 +83,8 @@ mystatus_t myhtml_tree_init(myhtml_tree_t* tree, myhtml_t* myhtml)
     if(tree->tree_obj == NULL)
         return MyHTML_STATUS_TREE_ERROR_MCOBJECT_CREATE;
     
+    mcobject_async_allocator_set(tree->tree_obj, myhtml->allocator);
+    
     mcobject_async_status_t mcstatus = mcobject_async_init(tree->tree_obj, 128, 1024, sizeof(myhtml_tree_node_t));
     if(mcstatus)
         return MyHTML_STATUS_TREE_ERROR_MCOBJECT_INIT;
@@ -90,6 +99,8 @@ mystatus_t myhtml_tree_init(myhtml_tree_t* tree, myhtml_t* myhtml)
     if(tree->mchar == NULL)
         return MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
     
+    mchar_async_allocator_set(tree->mchar, myhtml->allocator);
+    
     if((status = mchar_async_init(tree->mchar, 128, (4096 * 5))))
         return status;
     
@@ -156,9 +167,11 @@ void myhtml_tree_clean(myhtml_tree_t* tree)
     
     for(size_t i = 0; i < myhtml->thread_total; i++) {
         mchar_async_node_clean(tree->mchar, tree->async_args[i].mchar_node_id);
+        tree->async_args[i].incoming_buf = NULL;
     }
 #else
     mchar_async_node_clean(tree->mchar, tree->mchar_node_id);
+    tree->async_args->incoming_buf = NULL;
 #endif
     
     mcobject_async_node_clean(tree->tree_obj, tree->mcasync_tree_id);
@@ -208,6 +221,7 @@ void myhtml_tree_clean(myhtml_tree_t* tree)
     tree->encoding            = MyENCODING_UTF_8;
     tree->encoding_usereq     = MyENCODING_DEFAULT;
     
+    myhtml_tree_file_unmap(tree);
     myhtml_stream_buffer_clean(tree->stream_buffer);
     
     myhtml_tree_active_formatting_clean(tree);
@@ -215,11 +229,19 @@ void myhtml_tree_clean(myhtml_tree_t* tree)
     myhtml_tree_list_clean(tree->other_elements);
     myhtml_tree_token_list_clean(tree->token_list);
     myhtml_tree_template_insertion_clean(tree);
-    mcobject_clean(tree->mcobject_incoming_buf);
+    
+    if(tree->mchar->arena)
+        mcobject_rewind(tree->mcobject_incoming_buf);
+    else
+        mcobject_clean(tree->mcobject_incoming_buf);
+    
     myhtml_tag_clean(tree->tags);
     mythread_queue_clean(tree->queue);
     
     tree->attr_current = myhtml_token_attr_create(tree->token, tree->token->mcasync_attr_id);
+    
+    if(tree->index)
+        myhtml_index_clean(tree->index);
 }
 
 void myhtml_tree_clean_all(myhtml_tree_t* tree)
@@ -263,6 +285,7 @@ void myhtml_tree_clean_all(myhtml_tree_t* tree)
     tree->encoding            = MyENCODING_UTF_8;
     tree->encoding_usereq     = MyENCODING_DEFAULT;
     
+    myhtml_tree_file_unmap(tree);
     myhtml_stream_buffer_clean(tree->stream_buffer);
     
     myhtml_tree_active_formatting_clean(tree);
@@ -280,6 +303,9 @@ void myhtml_tree_clean_all(myhtml_tree_t* tree)
 #endif
     
     tree->attr_current = myhtml_token_attr_create(tree->token, tree->token->mcasync_attr_id);
+    
+    if(tree->index)
+        myhtml_index_clean(tree->index);
 }
 
 myhtml_tree_t * myhtml_tree_destroy(myhtml_tree_t* tree)
@@ -301,8 +327,10 @@ myhtml_tree_t * myhtml_tree_destroy(myhtml_tree_t* tree)
     tree->stream_buffer         = myhtml_stream_buffer_destroy(tree->stream_buffer, true);
     tree->queue                 = mythread_queue_destroy(tree->queue);
     tree->mcobject_incoming_buf = mcobject_destroy(tree->mcobject_incoming_buf, true);
+    tree->index                 = myhtml_index_destroy(tree->index, true);
     
     myhtml_tree_temp_tag_name_destroy(&tree->temp_tag_name, false);
+    myhtml_tree_file_unmap(tree);
     
     mycore_free(tree->async_args);
     mycore_free(tree);
@@ -310,12 +338,62 @@ myhtml_tree_t * myhtml_tree_destroy(myhtml_tree_t* tree)
     return NULL;
 }
 
+void myhtml_tree_file_unmap(myhtml_tree_t* tree)
+{
+    mycore_file_unmap(tree->file_data, tree->file_size);
+    
+    tree->file_data = NULL;
+    tree->file_size = 0;
+}
+
 void myhtml_tree_node_clean(myhtml_tree_node_t* tree_node)
 {
     memset(tree_node, 0, sizeof(myhtml_tree_node_t));
     tree_node->ns = MyHTML_NAMESPACE_HTML;
 }
 
+/* index */
+mystatus_t myhtml_tree_index_enable(myhtml_tree_t* tree)
+{
+    if(tree->index)
+        return MyHTML_STATUS_OK;
+    
+    tree->index = myhtml_index_create();
+    if(tree->index == NULL)
+        return MyHTML_STATUS_ERROR_MEMORY_ALLOCATION;
+    
+    mystatus_t status = myhtml_index_init(tree->index, tree);
+    
+    if(status)
+        tree->index = myhtml_index_destroy(tree->index, true);
+    
+    return status;
+}
+
+void myhtml_tree_index_disable(myhtml_tree_t* tree)
+{
+    tree->index = myhtml_index_destroy(tree->index, true);
+}
+
+myhtml_index_t * myhtml_tree_get_index(myhtml_tree_t* tree)
+{
+    return tree->index;
+}
+
+/* arena */
+void myhtml_tree_arena_set(myhtml_tree_t* tree, bool arena)
+{
+    mcobject_async_arena_set(tree->tree_obj, arena);
+    mcobject_async_arena_set(tree->token->nodes_obj, arena);
+    mcobject_async_arena_set(tree->token->attr_obj, arena);
+    mchar_async_arena_set(tree->mchar, arena);
+}
+
+bool myhtml_tree_arena(myhtml_tree_t* tree)
+{
+    return tree->mchar->arena;
+}
+
 /* parse flags */
 myhtml_tree_parse_flags_t myhtml_tree_parse_flags(myhtml_tree_t* tree)
 {
@@ -383,6 +461,23 @@ myhtml_tree_node_t * myhtml_tree_node_create(myhtml_tree_t* tree)
     return node;
 }
 
+/* nodes inside pruned element are not passed to index and callbacks */
+static bool myhtml_tree_node_in_pruned(myhtml_tree_node_t* parent, myhtml_tree_node_t* node)
+{
+    if(parent && (parent->flags & (MyHTML_TREE_NODE_PRUNED|MyHTML_TREE_NODE_IN_PRUNED)))
+        node->flags |= MyHTML_TREE_NODE_IN_PRUNED;
+    
+    return (node->flags & MyHTML_TREE_NODE_IN_PRUNED);
+}
+
+static bool myhtml_tree_node_is_pruned_location(myhtml_tree_node_t* adjusted_location, enum myhtml_tree_insertion_mode mode)
+{
+    if(mode != MyHTML_TREE_INSERTION_MODE_DEFAULT)
+        adjusted_location = adjusted_location->parent;
+    
+    return (adjusted_location && (adjusted_location->flags & (MyHTML_TREE_NODE_PRUNED|MyHTML_TREE_NODE_IN_PRUNED)));
+}
+
 void myhtml_tree_node_add_child(myhtml_tree_node_t* root, myhtml_tree_node_t* node)
 {
     if(root->last_child) {
@@ -396,6 +491,10 @@ void myhtml_tree_node_add_child(myhtml_tree_node_t* root, myhtml_tree_node_t* no
     node->parent     = root;
     root->last_child = node;
     
+    if(myhtml_tree_node_in_pruned(root, node))
+        return;
+    
+    myhtml_index_node_callback_insert(node->tree, node);
     myhtml_tree_node_callback_insert(node->tree, node);
 }
 
@@ -413,6 +512,10 @@ void myhtml_tree_node_insert_before(myhtml_tree_node_t* root, myhtml_tree_node_t
     node->next   = root;
     root->prev   = node;
     
+    if(myhtml_tree_node_in_pruned(root->parent, node))
+        return;
+    
+    myhtml_index_node_callback_insert(node->tree, node);
     myhtml_tree_node_callback_insert(node->tree, node);
 }
 
@@ -430,6 +533,10 @@ void myhtml_tree_node_insert_after(myhtml_tree_node_t* root, myhtml_tree_node_t*
     node->prev   = root;
     root->next   = node;
     
+    if(myhtml_tree_node_in_pruned(root->parent, node))
+        return;
+    
+    myhtml_index_node_callback_insert(node->tree, node);
     myhtml_tree_node_callback_insert(node->tree, node);
 }
 
@@ -462,6 +569,10 @@ myhtml_tree_node_t * myhtml_tree_node_remove(myhtml_tree_node_t* node)
     if(node->next)
         node->next = NULL;
     
+    if(node->flags & MyHTML_TREE_NODE_IN_PRUNED)
+        return node;
+    
+    myhtml_index_node_callback_remove(node->tree, node);
     myhtml_tree_node_callback_remove(node->tree, node);
     
     return node;
@@ -472,6 +583,9 @@ void myhtml_tree_node_free(myhtml_tree_node_t* node)
     if(node == NULL)
         return;
     
+    /* index can keep pointer to the node */
+    myhtml_index_node_callback_remove(node->tree, node);
+    
     if(node->token) {
         myhtml_token_attr_delete_all(node->tree->token, node->token);
         myhtml_token_delete(node->tree->token, node->token);
@@ -531,6 +645,31 @@ myhtml_tree_node_t * myhtml_tree_node_clone(myhtml_tree_node_t* node)
     return new_node;
 }
 
+/*
+ * Single mode parser does not decode strings of tokens inside pruned element,
+ * decode them for token which is inserted out of it, while input is still alive
+ */
+static void myhtml_tree_node_prune_materialize(myhtml_tree_t* tree, myhtml_token_node_t* token)
+{
+    if(token == NULL || (tree->flags & MyHTML_TREE_FLAGS_SINGLE_MODE) == 0 ||
+       (tree->parse_flags & MyHTML_TREE_PARSE_FLAGS_LAZY_STRINGS))
+    {
+        return;
+    }
+    
+    if(token->tag_id == MyHTML_TAG__TEXT || token->tag_id == MyHTML_TAG__COMMENT) {
+        myhtml_token_node_materialize(tree->token, token);
+        return;
+    }
+    
+    myhtml_token_attr_t* attr = token->attr_first;
+    
+    while(attr) {
+        myhtml_token_attr_materialize(attr);
+        attr = attr->next;
+    }
+}
+
 void myhtml_tree_node_insert_by_mode(myhtml_tree_node_t* adjusted_location,
                                      myhtml_tree_node_t* node, enum myhtml_tree_insertion_mode mode)
 {
@@ -540,6 +679,24 @@ void myhtml_tree_node_insert_by_mode(myhtml_tree_node_t* adjusted_location,
         myhtml_tree_node_insert_before(adjusted_location, node);
     else
         myhtml_tree_node_insert_after(adjusted_location, node);
+    
+    myhtml_tree_t* tree = node->tree;
+    
+    if(tree->callback_tree_node_prune &&
+       (node->flags & (MyHTML_TREE_NODE_PRUNED|MyHTML_TREE_NODE_IN_PRUNED)) == 0)
+    {
+        myhtml_tree_node_prune_materialize(tree, node->token);
+        
+        if(node->tag_id != MyHTML_TAG__TEXT && node->tag_id != MyHTML_TAG__COMMENT)
+        {
+            /* attributes of token can still be in processing by thread */
+            if(node->token)
+                myhtml_token_node_wait_for_done(tree->token, node->token);
+            
+            if(tree->callback_tree_node_prune(tree, node, tree->callback_tree_node_prune_ctx))
+                node->flags |= MyHTML_TREE_NODE_PRUNED;
+        }
+    }
 }
 
 myhtml_tree_node_t * myhtml_tree_node_insert_by_token(myhtml_tree_t* tree, myhtml_token_node_t* token, myhtml_namespace_t ns)
@@ -576,16 +733,19 @@ myhtml_tree_node_t * myhtml_tree_node_insert(myhtml_tree_t* tree, myhtml_tag_id_
 
 myhtml_tree_node_t * myhtml_tree_node_insert_comment(myhtml_tree_t* tree, myhtml_token_node_t* token, myhtml_tree_node_t* parent)
 {
-    myhtml_tree_node_t* node = myhtml_tree_node_create(tree);
-    
-    node->token  = token;
-    node->tag_id = MyHTML_TAG__COMMENT;
-    
     enum myhtml_tree_insertion_mode mode = 0;
     if(parent == NULL) {
         parent = myhtml_tree_appropriate_place_inserting(tree, NULL, &mode);
     }
     
+    if(myhtml_tree_node_is_pruned_location(parent, mode))
+        return NULL;
+    
+    myhtml_tree_node_t* node = myhtml_tree_node_create(tree);
+    
+    node->token  = token;
+    node->tag_id = MyHTML_TAG__COMMENT;
+    
     myhtml_tree_node_insert_by_mode(parent, node, mode);
     node->ns = parent->ns;
     
@@ -631,6 +791,13 @@ myhtml_tree_node_t * myhtml_tree_node_insert_text(myhtml_tree_t* tree, myhtml_to
     if(adjusted_location == tree->document)
         return NULL;
     
+    /* text inside pruned element is not built */
+    if(myhtml_tree_node_is_pruned_location(adjusted_location, mode))
+        return NULL;
+    
+    if(tree->callback_tree_node_prune)
+        myhtml_tree_node_prune_materialize(tree, token);
+    
     if(mode == MyHTML_TREE_INSERTION_MODE_AFTER) {
         if(adjusted_location->tag_id == MyHTML_TAG__TEXT && adjusted_location->token)
         {
@@ -705,6 +872,76 @@ myhtml_tree_node_t * myhtml_tree_node_insert_html_element(myhtml_tree_t* tree, m
     return node;
 }
 
+/*
+ * Next token of single mode parser goes inside pruned element.
+ * In these insertion modes text and elements are inserted to current node,
+ * so text and attribute values of the token are not needed
+ */
+bool myhtml_tree_pruned_insertion(myhtml_tree_t* tree)
+{
+    if(tree->callback_tree_node_prune == NULL || (tree->flags & MyHTML_TREE_FLAGS_SINGLE_MODE) == 0 ||
+       tree->open_elements->length == 0)
+    {
+        return false;
+    }
+    
+    myhtml_tree_node_t* current_node = tree->open_elements->list[ (tree->open_elements->length - 1) ];
+    
+    if((current_node->flags & (MyHTML_TREE_NODE_PRUNED|MyHTML_TREE_NODE_IN_PRUNED)) == 0)
+        return false;
+    
+    switch (tree->insert_mode) {
+        case MyHTML_INSERTION_MODE_IN_BODY:
+        case MyHTML_INSERTION_MODE_TEXT:
+        case MyHTML_INSERTION_MODE_IN_CAPTION:
+        case MyHTML_INSERTION_MODE_IN_CELL:
+            return true;
+            
+        default:
+            return false;
+    }
+}
+
+/* at the end of parsing pruned elements lose their children */
+void myhtml_tree_pruned_clean(myhtml_tree_t* tree)
+{
+    if(tree->callback_tree_node_prune == NULL || tree->document == NULL)
+        return;
+    
+    myhtml_tree_node_t* node = tree->document->child;
+    
+    while(node)
+    {
+        myhtml_tree_node_t* next = node->next;
+        myhtml_tree_node_t* parent = node->parent;
+        
+        if(node->flags & MyHTML_TREE_NODE_IN_PRUNED) {
+            /* moved out of pruned element by adoption agency */
+            myhtml_tree_node_remove(node);
+        }
+        else {
+            if(node->flags & MyHTML_TREE_NODE_PRUNED) {
+                node->child      = NULL;
+                node->last_child = NULL;
+                
+                node->flags ^= MyHTML_TREE_NODE_PRUNED;
+            }
+            
+            if(node->child) {
+                node = node->child;
+                continue;
+            }
+        }
+        
+        while(next == NULL && parent && parent != tree->document) {
+            next   = parent->next;
+            parent = parent->parent;
+        }
+        
+        node = next;
+    }
+}
+
 myhtml_tree_node_t * myhtml_tree_element_in_scope(myhtml_tree_t* tree, myhtml_tag_id_t tag_idx,
                                                   myhtml_namespace_t mynamespace, enum myhtml_tag_categories category)
 {
@@ -2454,7 +2691,12 @@ void myhtml_tree_wait_for_last_done_token(myhtml_tree_t* tree, myhtml_token_node
 {
 #ifndef MyCORE_BUILD_WITHOUT_THREADS
     
-    while(tree->token_last_done != token_for_wait) {mythread_nanosleep_sleep(tree->myhtml->thread_stream->timespec);}
+    if(tree->token_last_done != token_for_wait) {
+        mythread_t *mythread = tree->myhtml->thread_stream;
+        mythread_queue_list_t *queue_list = (mythread_queue_list_t*)mythread->context;
+        
+        mythread_cond_wait_while(mythread, queue_list->cond, tree->token_last_done != token_for_wait);
+    }
     
 #endif
 }
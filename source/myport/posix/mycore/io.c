@@ -18,8 +18,17 @@
  Author: lex.borisov@gmail.com (Alexander Borisov)
 */
 
+/* madvise is out of POSIX version of build flags */
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+
 #include "mycore/myosi.h"
 #include <stdarg.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 
 /* FILE */
 FILE * mycore_fopen(const char *filename, const char *mode)
@@ -67,3 +76,78 @@ void mycore_setbuf(FILE *stream, char *buffer)
 {
     setbuf(stream, buffer);
 }
+
+/* mapping */
+static mystatus_t mycore_file_map_by_prot(const char* filename, void** data, size_t* size, int prot)
+{
+    *data = NULL;
+    *size = 0;
+    
+    int fd = open(filename, O_RDONLY);
+    if(fd == -1)
+        return MyCORE_STATUS_ERROR_FILE_OPEN;
+    
+    struct stat st;
+    
+    if(fstat(fd, &st) == -1) {
+        close(fd);
+        return MyCORE_STATUS_ERROR_FILE_OPEN;
+    }
+    
+    if(st.st_size == 0) {
+        close(fd);
+        return MyCORE_STATUS_OK;
+    }
+    
+    /* private: writes by copy on write never reach the file */
+    void *map = mmap(NULL, (size_t)st.st_size, prot, MAP_PRIVATE, fd, 0);
+    
+    /* mapping keeps the file */
+    close(fd);
+    
+    if(map == MAP_FAILED)
+        return MyCORE_STATUS_ERROR_FILE_MAP;
+    
+    *data = map;
+    *size = (size_t)st.st_size;
+    
+    return MyCORE_STATUS_OK;
+}
+
+mystatus_t mycore_file_map(const char* filename, const char** data, size_t* size)
+{
+    void *map;
+    mystatus_t status = mycore_file_map_by_prot(filename, &map, size, PROT_READ);
+    
+    if(status)
+        return status;
+    
+#if defined(POSIX_MADV_SEQUENTIAL)
+    if(map)
+        posix_madvise(map, *size, POSIX_MADV_SEQUENTIAL);
+#elif defined(MADV_SEQUENTIAL)
+    if(map)
+        madvise(map, *size, MADV_SEQUENTIAL);
+#endif
+    
+    *data = (const char*)map;
+    
+    return MyCORE_STATUS_OK;
+}
+
+mystatus_t mycore_file_map_copy(const char* filename, char** data, size_t* size)
+{
+    void *map;
+    mystatus_t status = mycore_file_map_by_prot(filename, &map, size, (PROT_READ|PROT_WRITE));
+    
+    *data = (char*)map;
+    
+    return status;
+}
+
+void mycore_file_unmap(const char* data, size_t size)
+{
+    if(data)
+        munmap((void*)data, size);
+}
+
@@ -20,23 +20,43 @@
 
 #include "mycore/myosi.h"
 
+static mycore_malloc_f  mycore_memory_malloc  = malloc;
+static mycore_realloc_f mycore_memory_realloc = realloc;
+static mycore_calloc_f  mycore_memory_calloc  = calloc;
+static mycore_free_f    mycore_memory_free    = free;
+
+void mycore_memory_set(mycore_malloc_f malloc_f, mycore_realloc_f realloc_f, mycore_calloc_f calloc_f, mycore_free_f free_f)
+{
+    if(malloc_f == NULL || realloc_f == NULL || calloc_f == NULL || free_f == NULL) {
+        malloc_f  = malloc;
+        realloc_f = realloc;
+        calloc_f  = calloc;
+        free_f    = free;
+    }
+    
+    mycore_memory_malloc  = malloc_f;
+    mycore_memory_realloc = realloc_f;
+    mycore_memory_calloc  = calloc_f;
+    mycore_memory_free    = free_f;
+}
+
 void * mycore_malloc(size_t size)
 {
-    return malloc(size);
+    return mycore_memory_malloc(size);
 }
 
 void * mycore_realloc(void* dst, size_t size)
 {
-    return realloc(dst, size);
+    return mycore_memory_realloc(dst, size);
 }
 
 void * mycore_calloc(size_t num, size_t size)
 {
-    return calloc(num, size);
+    return mycore_memory_calloc(num, size);
 }
 
 void * mycore_free(void* dst)
 {
-    free(dst);
+    mycore_memory_free(dst);
     return NULL;
 }
@@ -23,6 +23,22 @@
 
 #ifndef MyCORE_BUILD_WITHOUT_THREADS
 #include <pthread.h>
+#include <unistd.h>
+
+#if ((defined(__GNUC__) && __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)) || defined(__ATOMIC_SEQ_CST))
+#define MyCORE_MYTHREAD_COND_ATOMIC_PRESENT
+#endif
+
+#define MyCORE_MYTHREAD_COND_SPIN_COUNT 512
+
+struct mythread_cond_posix {
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    
+    volatile size_t epoch;
+    volatile size_t waiters;
+}
+typedef mythread_cond_posix_t;
 
 /***********************************************************************************
  *
@@ -134,6 +150,142 @@ void mythread_mutex_close(mythread_t *mythread, void* mutex)
     mcsync_mutex_destroy(mutex);
 }
 
+/*
+ * Wait/notify (event count).
+ * Waiter: ticket = prepare(); check condition; wait(ticket) or cancel().
+ * Notifier: change condition; notify().
+ * Notify is a fence and a load while nobody waits.
+ */
+void * mythread_cond_create(mythread_t *mythread)
+{
+    mythread_cond_posix_t *cond = (mythread_cond_posix_t*)mycore_calloc(1, sizeof(mythread_cond_posix_t));
+    
+    if(cond == NULL)
+        return NULL;
+    
+    if(pthread_mutex_init(&cond->mutex, NULL)) {
+        mycore_free(cond);
+        return NULL;
+    }
+    
+    if(pthread_cond_init(&cond->cond, NULL)) {
+        pthread_mutex_destroy(&cond->mutex);
+        mycore_free(cond);
+        return NULL;
+    }
+    
+    return cond;
+}
+
+size_t mythread_cond_prepare(mythread_t *mythread, void* cond)
+{
+    mythread_cond_posix_t *pcond = (mythread_cond_posix_t*)cond;
+    
+#ifdef MyCORE_MYTHREAD_COND_ATOMIC_PRESENT
+    __atomic_add_fetch(&pcond->waiters, 1, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&pcond->epoch, __ATOMIC_SEQ_CST);
+#else
+    pthread_mutex_lock(&pcond->mutex);
+    
+    pcond->waiters++;
+    size_t epoch = pcond->epoch;
+    
+    pthread_mutex_unlock(&pcond->mutex);
+    
+    return epoch;
+#endif
+}
+
+void mythread_cond_cancel(mythread_t *mythread, void* cond)
+{
+    mythread_cond_posix_t *pcond = (mythread_cond_posix_t*)cond;
+    
+#ifdef MyCORE_MYTHREAD_COND_ATOMIC_PRESENT
+    __atomic_sub_fetch(&pcond->waiters, 1, __ATOMIC_SEQ_CST);
+#else
+    pthread_mutex_lock(&pcond->mutex);
+    pcond->waiters--;
+    pthread_mutex_unlock(&pcond->mutex);
+#endif
+}
+
+mystatus_t mythread_cond_wait(mythread_t *mythread, void* cond, size_t ticket)
+{
+    mythread_cond_posix_t *pcond = (mythread_cond_posix_t*)cond;
+    mystatus_t status = MyCORE_STATUS_OK;
+    
+#ifdef MyCORE_MYTHREAD_COND_ATOMIC_PRESENT
+    /* short spin for a fast handoff, notifier bumps epoch only when it sees us */
+    for(size_t i = 0; i < MyCORE_MYTHREAD_COND_SPIN_COUNT; i++) {
+        if(__atomic_load_n(&pcond->epoch, __ATOMIC_ACQUIRE) != ticket) {
+            __atomic_sub_fetch(&pcond->waiters, 1, __ATOMIC_SEQ_CST);
+            return MyCORE_STATUS_OK;
+        }
+    }
+#endif
+    
+    pthread_mutex_lock(&pcond->mutex);
+    
+    while(pcond->epoch == ticket) {
+        if(pthread_cond_wait(&pcond->cond, &pcond->mutex)) {
+            status = MyCORE_STATUS_ERROR;
+            break;
+        }
+    }
+    
+#ifdef MyCORE_MYTHREAD_COND_ATOMIC_PRESENT
+    pthread_mutex_unlock(&pcond->mutex);
+    __atomic_sub_fetch(&pcond->waiters, 1, __ATOMIC_SEQ_CST);
+#else
+    pcond->waiters--;
+    pthread_mutex_unlock(&pcond->mutex);
+#endif
+    
+    return status;
+}
+
+mystatus_t mythread_cond_notify(mythread_t *mythread, void* cond)
+{
+    mythread_cond_posix_t *pcond = (mythread_cond_posix_t*)cond;
+    
+#ifdef MyCORE_MYTHREAD_COND_ATOMIC_PRESENT
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    
+    if(__atomic_load_n(&pcond->waiters, __ATOMIC_SEQ_CST) == 0)
+        return MyCORE_STATUS_OK;
+#endif
+    
+    pthread_mutex_lock(&pcond->mutex);
+    
+#ifdef MyCORE_MYTHREAD_COND_ATOMIC_PRESENT
+    __atomic_add_fetch(&pcond->epoch, 1, __ATOMIC_SEQ_CST);
+#else
+    pcond->epoch++;
+#endif
+    
+    int err = pthread_cond_broadcast(&pcond->cond);
+    
+    pthread_mutex_unlock(&pcond->mutex);
+    
+    if(err)
+        return MyCORE_STATUS_ERROR;
+    
+    return MyCORE_STATUS_OK;
+}
+
+void mythread_cond_close(mythread_t *mythread, void* cond)
+{
+    mythread_cond_posix_t *pcond = (mythread_cond_posix_t*)cond;
+    
+    if(pcond == NULL)
+        return;
+    
+    pthread_cond_destroy(&pcond->cond);
+    pthread_mutex_destroy(&pcond->mutex);
+    
+    mycore_free(pcond);
+}
+
 void * mythread_nanosleep_create(mythread_t* mythread)
 {
     return mycore_calloc(1, sizeof(struct timespec));
@@ -157,4 +309,14 @@ mystatus_t mythread_nanosleep_sleep(void* timespec)
     return MyCORE_STATUS_ERROR;
 }
 
+size_t mythread_cpu_count(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    
+    if(count < 1)
+        return 1;
+    
+    return (size_t)count;
+}
+
 #endif
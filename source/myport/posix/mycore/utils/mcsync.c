@@ -31,7 +31,11 @@
 static mcsync_status_t mcsync_static_atomic_lock(void* spinlock)
 {
     int compare = 0;
-    while (!__atomic_compare_exchange_n((int*)spinlock, &compare, 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {}
+    
+    /* failed exchange writes current value to compare */
+    while (!__atomic_compare_exchange_n((int*)spinlock, &compare, 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+        compare = 0;
+    }
     
     return MCSYNC_STATUS_OK;
 }
@@ -150,4 +154,77 @@ mcsync_status_t mcsync_mutex_unlock(void* mutex)
     return MCSYNC_STATUS_NOT_OK;
 }
 
+/* atomic */
+#ifndef MyCORE_MCSYNC_SPINLOCK_PRESENT
+static pthread_mutex_t mcsync_static_atomic_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+size_t mcsync_atomic_load(volatile size_t* value)
+{
+#ifdef MyCORE_MCSYNC_SPINLOCK_PRESENT
+    return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+#else
+    pthread_mutex_lock(&mcsync_static_atomic_mutex);
+    size_t res = *value;
+    pthread_mutex_unlock(&mcsync_static_atomic_mutex);
+    
+    return res;
+#endif
+}
+
+void mcsync_atomic_store(volatile size_t* value, size_t new_value)
+{
+#ifdef MyCORE_MCSYNC_SPINLOCK_PRESENT
+    __atomic_store_n(value, new_value, __ATOMIC_SEQ_CST);
+#else
+    pthread_mutex_lock(&mcsync_static_atomic_mutex);
+    *value = new_value;
+    pthread_mutex_unlock(&mcsync_static_atomic_mutex);
+#endif
+}
+
+bool mcsync_atomic_compare_exchange(volatile size_t* value, size_t expected, size_t desired)
+{
+#ifdef MyCORE_MCSYNC_SPINLOCK_PRESENT
+    return __atomic_compare_exchange_n(value, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#else
+    bool res = false;
+    
+    pthread_mutex_lock(&mcsync_static_atomic_mutex);
+    
+    if(*value == expected) {
+        *value = desired;
+        res = true;
+    }
+    
+    pthread_mutex_unlock(&mcsync_static_atomic_mutex);
+    
+    return res;
+#endif
+}
+
+size_t mcsync_atomic_fetch_add(volatile size_t* value, size_t add)
+{
+#ifdef MyCORE_MCSYNC_SPINLOCK_PRESENT
+    return __atomic_fetch_add(value, add, __ATOMIC_SEQ_CST);
+#else
+    pthread_mutex_lock(&mcsync_static_atomic_mutex);
+    size_t res = *value;
+    *value += add;
+    pthread_mutex_unlock(&mcsync_static_atomic_mutex);
+    
+    return res;
+#endif
+}
+
+void mcsync_atomic_fence(void)
+{
+#ifdef MyCORE_MCSYNC_SPINLOCK_PRESENT
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#else
+    pthread_mutex_lock(&mcsync_static_atomic_mutex);
+    pthread_mutex_unlock(&mcsync_static_atomic_mutex);
+#endif
+}
+
 #endif
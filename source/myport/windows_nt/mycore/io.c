@@ -20,6 +20,7 @@
 
 #include "mycore/myosi.h"
 #include <stdarg.h>
+#include <windows.h>
 
 /* FILE */
 FILE * mycore_fopen(const char* filename, const char* mode)
@@ -68,4 +69,71 @@ void mycore_setbuf(FILE* stream, char* buffer)
     setbuf(stream, buffer);
 }
 
+/* mapping */
+static mystatus_t mycore_file_map_by_access(const char* filename, void** data, size_t* size, DWORD flags, DWORD protect, DWORD access)
+{
+    *data = NULL;
+    *size = 0;
+    
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags, NULL);
+    if(file == INVALID_HANDLE_VALUE)
+        return MyCORE_STATUS_ERROR_FILE_OPEN;
+    
+    LARGE_INTEGER file_size;
+    
+    if(GetFileSizeEx(file, &file_size) == 0) {
+        CloseHandle(file);
+        return MyCORE_STATUS_ERROR_FILE_OPEN;
+    }
+    
+    if(file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return MyCORE_STATUS_OK;
+    }
+    
+    HANDLE mapping = CreateFileMappingA(file, NULL, protect, 0, 0, NULL);
+    CloseHandle(file);
+    
+    if(mapping == NULL)
+        return MyCORE_STATUS_ERROR_FILE_MAP;
+    
+    void *map = MapViewOfFile(mapping, access, 0, 0, 0);
+    
+    /* view keeps the mapping */
+    CloseHandle(mapping);
+    
+    if(map == NULL)
+        return MyCORE_STATUS_ERROR_FILE_MAP;
+    
+    *data = map;
+    *size = (size_t)file_size.QuadPart;
+    
+    return MyCORE_STATUS_OK;
+}
+
+mystatus_t mycore_file_map(const char* filename, const char** data, size_t* size)
+{
+    void *map;
+    mystatus_t status = mycore_file_map_by_access(filename, &map, size, FILE_FLAG_SEQUENTIAL_SCAN, PAGE_READONLY, FILE_MAP_READ);
+    
+    *data = (const char*)map;
+    
+    return status;
+}
+
+mystatus_t mycore_file_map_copy(const char* filename, char** data, size_t* size)
+{
+    void *map;
+    mystatus_t status = mycore_file_map_by_access(filename, &map, size, FILE_ATTRIBUTE_NORMAL, PAGE_WRITECOPY, FILE_MAP_COPY);
+    
+    *data = (char*)map;
+    
+    return status;
+}
+
+void mycore_file_unmap(const char* data, size_t size)
+{
+    if(data)
+        UnmapViewOfFile(data);
+}
 
@@ -23,6 +23,17 @@
 #ifndef MyCORE_BUILD_WITHOUT_THREADS
 #include <windows.h>
 
+#define MyCORE_MYTHREAD_COND_SPIN_COUNT 512
+
+struct mythread_cond_windows {
+    SRWLOCK            lock;
+    CONDITION_VARIABLE cond;
+    
+    volatile LONG epoch;
+    volatile LONG waiters;
+}
+typedef mythread_cond_windows_t;
+
 /***********************************************************************************
  *
  * For Windows
@@ -109,6 +120,96 @@ void mythread_mutex_close(mythread_t *mythread, void* mutex)
     mcsync_mutex_destroy(mutex);
 }
 
+/*
+ * Wait/notify (event count), see posix port for the protocol.
+ * Waiter: ticket = prepare(); check condition; wait(ticket) or cancel().
+ * Notifier: change condition; notify().
+ */
+void * mythread_cond_create(mythread_t *mythread)
+{
+    mythread_cond_windows_t *cond = (mythread_cond_windows_t*)mycore_calloc(1, sizeof(mythread_cond_windows_t));
+    
+    if(cond == NULL)
+        return NULL;
+    
+    InitializeSRWLock(&cond->lock);
+    InitializeConditionVariable(&cond->cond);
+    
+    return cond;
+}
+
+size_t mythread_cond_prepare(mythread_t *mythread, void* cond)
+{
+    mythread_cond_windows_t *wcond = (mythread_cond_windows_t*)cond;
+    
+    InterlockedIncrement(&wcond->waiters);
+    
+    /* full barrier: read epoch after waiters is visible to notifier */
+    return (size_t)(ULONG)InterlockedCompareExchange(&wcond->epoch, 0, 0);
+}
+
+void mythread_cond_cancel(mythread_t *mythread, void* cond)
+{
+    mythread_cond_windows_t *wcond = (mythread_cond_windows_t*)cond;
+    
+    InterlockedDecrement(&wcond->waiters);
+}
+
+mystatus_t mythread_cond_wait(mythread_t *mythread, void* cond, size_t ticket)
+{
+    mythread_cond_windows_t *wcond = (mythread_cond_windows_t*)cond;
+    mystatus_t status = MyCORE_STATUS_OK;
+    
+    /* short spin for a fast handoff, notifier bumps epoch only when it sees us */
+    for(size_t i = 0; i < MyCORE_MYTHREAD_COND_SPIN_COUNT; i++) {
+        if((size_t)(ULONG)InterlockedCompareExchange(&wcond->epoch, 0, 0) != ticket) {
+            InterlockedDecrement(&wcond->waiters);
+            return MyCORE_STATUS_OK;
+        }
+        
+        YieldProcessor();
+    }
+    
+    AcquireSRWLockExclusive(&wcond->lock);
+    
+    while((size_t)(ULONG)wcond->epoch == ticket) {
+        if(SleepConditionVariableSRW(&wcond->cond, &wcond->lock, INFINITE, 0) == FALSE) {
+            status = MyCORE_STATUS_ERROR;
+            break;
+        }
+    }
+    
+    ReleaseSRWLockExclusive(&wcond->lock);
+    InterlockedDecrement(&wcond->waiters);
+    
+    return status;
+}
+
+mystatus_t mythread_cond_notify(mythread_t *mythread, void* cond)
+{
+    mythread_cond_windows_t *wcond = (mythread_cond_windows_t*)cond;
+    
+    MemoryBarrier();
+    
+    if(InterlockedCompareExchange(&wcond->waiters, 0, 0) == 0)
+        return MyCORE_STATUS_OK;
+    
+    /* epoch changes under the lock, so a waiter can not miss the wake between check and sleep */
+    AcquireSRWLockExclusive(&wcond->lock);
+    InterlockedIncrement(&wcond->epoch);
+    ReleaseSRWLockExclusive(&wcond->lock);
+    
+    WakeAllConditionVariable(&wcond->cond);
+    
+    return MyCORE_STATUS_OK;
+}
+
+void mythread_cond_close(mythread_t *mythread, void* cond)
+{
+    /* SRWLOCK and CONDITION_VARIABLE need no destroy */
+    mycore_free(cond);
+}
+
 void * mythread_nanosleep_create(mythread_t* mythread)
 {
     return (void*)0x01;
@@ -128,4 +229,15 @@ mystatus_t mythread_nanosleep_sleep(void* timespec)
     return MyCORE_STATUS_OK;
 }
 
+size_t mythread_cpu_count(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    
+    if(info.dwNumberOfProcessors < 1)
+        return 1;
+    
+    return (size_t)info.dwNumberOfProcessors;
+}
+
 #endif
@@ -114,4 +114,34 @@ mcsync_status_t mcsync_mutex_unlock(void* mutex)
     return MCSYNC_STATUS_NOT_OK;
 }
 
+/* atomic, size_t is pointer sized; Interlocked* are full barriers */
+size_t mcsync_atomic_load(volatile size_t* value)
+{
+    return (size_t)InterlockedCompareExchangePointer((PVOID volatile*)value, NULL, NULL);
+}
+
+void mcsync_atomic_store(volatile size_t* value, size_t new_value)
+{
+    InterlockedExchangePointer((PVOID volatile*)value, (PVOID)new_value);
+}
+
+bool mcsync_atomic_compare_exchange(volatile size_t* value, size_t expected, size_t desired)
+{
+    return (size_t)InterlockedCompareExchangePointer((PVOID volatile*)value, (PVOID)desired, (PVOID)expected) == expected;
+}
+
+size_t mcsync_atomic_fetch_add(volatile size_t* value, size_t add)
+{
+#ifdef _WIN64
+    return (size_t)InterlockedExchangeAdd64((LONG64 volatile*)value, (LONG64)add);
+#else
+    return (size_t)InterlockedExchangeAdd((LONG volatile*)value, (LONG)add);
+#endif
+}
+
+void mcsync_atomic_fence(void)
+{
+    MemoryBarrier();
+}
+
 #endif
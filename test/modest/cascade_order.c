@@ -0,0 +1,384 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Collation by cascade keys (modest/style/raw.h): of equal specificity the later rule wins,
+ * also from a later stylesheet, !important and origin are above specificity, and the result
+ * is the same for any thread count and for left to right and right to left matching.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include <modest/modest.h>
+#include <modest/glue.h>
+#include <modest/node/node.h>
+#include <modest/finder/finder.h>
+#include <modest/finder/thread.h>
+#include <modest/finder/rules.h>
+#include <modest/style/computed.h>
+#include <myhtml/myhtml.h>
+#include <mycss/mycss.h>
+
+#include "../test.h"
+
+/* rules of the same selector, split between threads */
+#define TEST_MANY_COUNT 200
+
+static const char *test_css_user_agent = ".ua {width: 20px !important; height: 21px}";
+
+static const char *test_css_begin =
+".a {width: 1px} .b {width: 2px}\n"
+".d {width: 3px} .c {width: 4px}\n"
+".e {width: 5px !important} .f {width: 6px}\n"
+"div .g {width: 7px} p.g {width: 8px}\n"
+".h {width: 9px; width: 10px}\n"
+"* {height: 11px}\n"
+".p1 {padding-top: 12px} .p2 {padding: 13px}\n"
+".q1 {padding: 14px} .q2 {padding-top: 15px}\n"
+".ua {width: 22px !important; height: 23px}\n"
+".s2 {width: 24px}\n";
+
+/* after all rules of the first author stylesheet, but with low order in own one */
+static const char *test_css_author_next = ".s1 {width: 25px}";
+
+static const char *test_html =
+"<html><body>"
+"<div id=\"later\" class=\"a b\"></div><div id=\"earlier\" class=\"c d\"></div><div id=\"important\" class=\"e f\"></div>"
+"<div><p id=\"same\" class=\"g\"></p></div><div id=\"dup\" class=\"h\"></div><div id=\"universal\"></div>"
+"<div id=\"short\" class=\"p1 p2\"></div><div id=\"long\" class=\"q1 q2\"></div><div id=\"many\" class=\"m\"></div>"
+"<div id=\"origin\" class=\"ua\"></div><div id=\"sheet\" class=\"s1 s2\"></div>"
+"</body></html>";
+
+struct test_case {
+    const char* id;
+    const char* name;
+    mycss_property_type_t type;
+    float value;
+}
+typedef test_case_t;
+
+static const test_case_t test_cases[] = {
+    {"later",     "later rule wins",                   MyCSS_PROPERTY_TYPE_WIDTH,       2.0f},
+    {"earlier",   "source order, not class order",     MyCSS_PROPERTY_TYPE_WIDTH,       4.0f},
+    {"important", "important wins over later",         MyCSS_PROPERTY_TYPE_WIDTH,       5.0f},
+    {"same",      "equal specificity of compounds",    MyCSS_PROPERTY_TYPE_WIDTH,       8.0f},
+    {"dup",       "later declaration of rule",         MyCSS_PROPERTY_TYPE_WIDTH,       10.0f},
+    {"universal", "universal selector",                MyCSS_PROPERTY_TYPE_HEIGHT,      11.0f},
+    {"short",     "later shorthand",                   MyCSS_PROPERTY_TYPE_PADDING_TOP, 13.0f},
+    {"long",      "later longhand",                    MyCSS_PROPERTY_TYPE_PADDING_TOP, 15.0f},
+    {"many",      "last of rules split by threads",    MyCSS_PROPERTY_TYPE_WIDTH,       (float)(100 + TEST_MANY_COUNT - 1)},
+    {"origin",    "user agent important over author",  MyCSS_PROPERTY_TYPE_WIDTH,       20.0f},
+    {"origin",    "author over user agent",            MyCSS_PROPERTY_TYPE_HEIGHT,      23.0f},
+    {"sheet",     "rule of later stylesheet wins",     MyCSS_PROPERTY_TYPE_WIDTH,       25.0f}
+};
+
+/* while set, realloc fails in all threads but the main one */
+static volatile bool test_realloc_fail = false;
+static pthread_t test_main_thread;
+
+static void test_check_run(const char* name, size_t threads, bool rules, bool is_good)
+{
+    char full_name[256];
+    
+    snprintf(full_name, sizeof(full_name), "%s, threads " MyCORE_FORMAT_Z ", %s", name, threads,
+             (rules ? "right to left" : "left to right"));
+    
+    test_check(is_good, full_name);
+}
+
+static void * test_realloc(void* dst, size_t size)
+{
+    if(test_realloc_fail && pthread_equal(pthread_self(), test_main_thread) == 0)
+        return NULL;
+    
+    return realloc(dst, size);
+}
+
+static char * test_make_css(void)
+{
+    size_t size = strlen(test_css_begin) + (TEST_MANY_COUNT * 32) + 1;
+    char *css = malloc(size);
+    
+    if(css == NULL)
+        DIE("Can't allocate mem for CSS\n");
+    
+    size_t length = sprintf(css, "%s", test_css_begin);
+    
+    for(size_t i = 0; i < TEST_MANY_COUNT; i++)
+        length += sprintf(&css[length], ".m {width: %zupx}\n", (100 + i));
+    
+    return css;
+}
+
+static mycss_entry_t * test_parse_css(mycss_t* mycss, const char* css)
+{
+    mycss_entry_t *entry = mycss_entry_create();
+    mystatus_t status = mycss_entry_init(mycss, entry);
+    
+    CHECK_STATUS("Can't init MyCSS Entry object\n");
+    
+    status = mycss_parse(entry, MyENCODING_UTF_8, css, strlen(css));
+    CHECK_STATUS("Can't parse CSS\n");
+    
+    return entry;
+}
+
+static myhtml_tree_node_t * test_node_by_id(myhtml_tree_t* tree, const char* id)
+{
+    mystatus_t status;
+    myhtml_collection_t *collection = myhtml_get_nodes_by_attribute_value(tree, NULL, NULL, false, "id", 2, id, strlen(id), &status);
+    
+    if(collection == NULL || collection->length != 1)
+        DIE("Can't find node by id: %s\n", id);
+    
+    myhtml_tree_node_t *node = collection->list[0];
+    myhtml_collection_destroy(collection);
+    
+    return node;
+}
+
+static float test_value(modest_style_sheet_t* sheet, mycss_property_type_t type)
+{
+    switch(type) {
+        case MyCSS_PROPERTY_TYPE_WIDTH:       return sheet->width.value;
+        case MyCSS_PROPERTY_TYPE_HEIGHT:      return sheet->height.value;
+        case MyCSS_PROPERTY_TYPE_PADDING_TOP: return sheet->padding_top.value;
+        default:
+            return -1.0f;
+    }
+}
+
+static void test_run(modest_t* modest, modest_style_computed_t* computed, size_t threads, bool by_rules,
+                     mycss_stylesheet_t* user_agent, modest_finder_rules_t* user_agent_rules,
+                     mycss_stylesheet_t* author, modest_finder_rules_t* author_rules,
+                     mycss_stylesheet_t* author_next, modest_finder_rules_t* author_next_rules)
+{
+    modest_finder_t *finder = modest_finder_create_simple();
+    
+    modest_finder_thread_t *finder_thread = modest_finder_thread_create();
+    mystatus_t status = modest_finder_thread_init(finder, finder_thread, threads);
+    
+    CHECK_STATUS("Can't init Modest Finder Thread object\n");
+    
+    modest_clean(modest);
+    
+    status = myhtml_parse(modest->myhtml_tree, MyENCODING_UTF_8, test_html, strlen(test_html));
+    CHECK_STATUS("Can't parse HTML\n");
+    
+    myhtml_tree_node_t *scope = modest->myhtml_tree->node_html;
+    
+    /* user agent first, then author to the same nodes */
+    finder_thread->origin = MODEST_STYLE_RAW_ORIGIN_USER_AGENT;
+    
+    if(by_rules)
+        status = modest_finder_thread_process_rules(modest, finder_thread, scope, user_agent_rules);
+    else
+        status = modest_finder_thread_process(modest, finder_thread, scope, user_agent->sel_list_first);
+    
+    CHECK_STATUS("Can't find by selectors with thread\n");
+    
+    finder_thread->origin = MODEST_STYLE_RAW_ORIGIN_AUTHOR;
+    
+    if(by_rules)
+        status = modest_finder_thread_process_rules(modest, finder_thread, scope, author_rules);
+    else
+        status = modest_finder_thread_process(modest, finder_thread, scope, author->sel_list_first);
+    
+    CHECK_STATUS("Can't find by selectors with thread\n");
+    
+    if(by_rules)
+        status = modest_finder_thread_process_rules(modest, finder_thread, scope, author_next_rules);
+    else
+        status = modest_finder_thread_process(modest, finder_thread, scope, author_next->sel_list_first);
+    
+    CHECK_STATUS("Can't find by selectors with thread\n");
+    
+    status = modest_style_computed_process(computed, scope);
+    CHECK_STATUS("Can't process computed style\n");
+    
+    for(size_t i = 0; i < (sizeof(test_cases) / sizeof(test_cases[0])); i++) {
+        modest_style_sheet_t *sheet = modest_style_computed_by_node(test_node_by_id(modest->myhtml_tree, test_cases[i].id));
+        float value = test_value(sheet, test_cases[i].type);
+        
+        test_check_run(test_cases[i].name, finder_thread->context_list_size, by_rules, (fabsf(value - test_cases[i].value) < 0.01f));
+    }
+    
+    /* a new cascade starts from order 0, as the first one */
+    size_t order_end = finder_thread->order_base;
+    
+    modest_finder_thread_clean(finder_thread, false);
+    test_check_run("clean starts a new cascade", finder_thread->context_list_size, by_rules, (finder_thread->order_base == 0));
+    
+    finder_thread->origin = MODEST_STYLE_RAW_ORIGIN_USER_AGENT;
+    
+    if(by_rules)
+        status = modest_finder_thread_process_rules(modest, finder_thread, scope, user_agent_rules);
+    else
+        status = modest_finder_thread_process(modest, finder_thread, scope, user_agent->sel_list_first);
+    
+    CHECK_STATUS("Can't find by selectors with thread\n");
+    
+    size_t order_user_agent = finder_thread->order_base;
+    
+    finder_thread->origin = MODEST_STYLE_RAW_ORIGIN_AUTHOR;
+    
+    if(by_rules) {
+        status = modest_finder_thread_process_rules(modest, finder_thread, scope, author_rules) ||
+                 modest_finder_thread_process_rules(modest, finder_thread, scope, author_next_rules);
+    }
+    else {
+        status = modest_finder_thread_process(modest, finder_thread, scope, author->sel_list_first) ||
+                 modest_finder_thread_process(modest, finder_thread, scope, author_next->sel_list_first);
+    }
+    
+    CHECK_STATUS("Can't find by selectors with thread\n");
+    
+    test_check_run("order of new cascade is as of first one", finder_thread->context_list_size, by_rules,
+                   (order_user_agent < order_end && finder_thread->order_base == order_end));
+    
+    modest_finder_thread_clean(finder_thread, false);
+    modest_finder_thread_destroy(finder_thread, true);
+    modest_finder_destroy(finder, true);
+}
+
+/* an allocation error of right to left matching in threads fails the process, nothing is collated */
+static void test_run_memory_error(modest_t* modest, size_t threads, modest_finder_rules_t* author_rules)
+{
+    modest_finder_t *finder = modest_finder_create_simple();
+    
+    modest_finder_thread_t *finder_thread = modest_finder_thread_create();
+    mystatus_t status = modest_finder_thread_init(finder, finder_thread, threads);
+    
+    CHECK_STATUS("Can't init Modest Finder Thread object\n");
+    
+    modest_clean(modest);
+    
+    status = myhtml_parse(modest->myhtml_tree, MyENCODING_UTF_8, test_html, strlen(test_html));
+    CHECK_STATUS("Can't parse HTML\n");
+    
+    myhtml_tree_node_t *scope = modest->myhtml_tree->node_html;
+    modest_node_t *mnode = (modest_node_t*)test_node_by_id(modest->myhtml_tree, "later")->data;
+    
+    test_realloc_fail = true;
+    status = modest_finder_thread_process_rules(modest, finder_thread, scope, author_rules);
+    test_realloc_fail = false;
+    
+    test_check_run("allocation error is returned", threads, true, (status == MODEST_STATUS_ERROR_MEMORY_ALLOCATION));
+    test_check_run("nothing is collated on error", threads, true,
+                   (modest_node_declaration_by_type(modest, mnode, MyCSS_PROPERTY_TYPE_WIDTH) == NULL));
+    
+    status = modest_finder_thread_process_rules(modest, finder_thread, scope, author_rules);
+    
+    test_check_run("process after error", threads, true,
+                   (status == MODEST_STATUS_OK && modest_node_declaration_by_type(modest, mnode, MyCSS_PROPERTY_TYPE_WIDTH)));
+    
+    modest_finder_thread_destroy(finder_thread, true);
+    modest_finder_destroy(finder, true);
+}
+
+int main(int argc, const char * argv[])
+{
+    /* before any object */
+    test_main_thread = pthread_self();
+    mycore_memory_set(malloc, test_realloc, calloc, free);
+    
+    modest_t *modest = modest_create();
+    mystatus_t status = modest_init(modest);
+    
+    CHECK_STATUS("Can't init Modest object\n");
+    
+    myhtml_t* myhtml = myhtml_create();
+    status = myhtml_init(myhtml, MyHTML_OPTIONS_PARSE_MODE_SINGLE, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    modest->myhtml_tree = myhtml_tree_create();
+    status = myhtml_tree_init(modest->myhtml_tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    myhtml_callback_tree_node_insert_set(modest->myhtml_tree, modest_glue_callback_myhtml_insert_node, (void*)modest);
+    
+    mycss_t *mycss = mycss_create();
+    status = mycss_init(mycss);
+    
+    CHECK_STATUS("Can't init MyCSS object\n");
+    
+    char *css = test_make_css();
+    
+    mycss_entry_t *user_agent_entry = test_parse_css(mycss, test_css_user_agent);
+    mycss_entry_t *author_entry = test_parse_css(mycss, css);
+    mycss_entry_t *author_next_entry = test_parse_css(mycss, test_css_author_next);
+    
+    mycss_stylesheet_t *user_agent = mycss_entry_stylesheet(user_agent_entry);
+    mycss_stylesheet_t *author = mycss_entry_stylesheet(author_entry);
+    mycss_stylesheet_t *author_next = mycss_entry_stylesheet(author_next_entry);
+    
+    modest->mycss_entry = author_entry;
+    
+    modest_finder_rules_t *user_agent_rules = modest_finder_rules_create();
+    modest_finder_rules_t *author_rules = modest_finder_rules_create();
+    modest_finder_rules_t *author_next_rules = modest_finder_rules_create();
+    
+    /* orders go on from one stylesheet to the next */
+    if(modest_finder_rules_init_by_stylesheet(user_agent_rules, user_agent, 0) ||
+       modest_finder_rules_init_by_stylesheet(author_rules, author, modest_finder_rules_order_end(user_agent_rules)) ||
+       modest_finder_rules_init_by_stylesheet(author_next_rules, author_next, modest_finder_rules_order_end(author_rules)))
+    {
+        DIE("Can't init Modest Finder Rules object\n");
+    }
+    
+    modest_style_computed_t *computed = modest_style_computed_create();
+    status = modest_style_computed_init(computed, modest);
+    
+    CHECK_STATUS("Can't init Modest Style Computed object\n");
+    
+    for(size_t threads = 1; threads <= 4; threads *= 2) {
+        test_run(modest, computed, threads, false, user_agent, user_agent_rules, author, author_rules, author_next, author_next_rules);
+        test_run(modest, computed, threads, true, user_agent, user_agent_rules, author, author_rules, author_next, author_next_rules);
+    }
+    
+    test_run_memory_error(modest, 2, author_rules);
+    
+    modest_style_computed_destroy(computed, true);
+    modest_finder_rules_destroy(user_agent_rules, true);
+    modest_finder_rules_destroy(author_rules, true);
+    modest_finder_rules_destroy(author_next_rules, true);
+    
+    mycss_stylesheet_destroy(user_agent, true);
+    mycss_stylesheet_destroy(author, true);
+    mycss_stylesheet_destroy(author_next, true);
+    mycss_entry_destroy(user_agent_entry, true);
+    mycss_entry_destroy(author_entry, true);
+    mycss_entry_destroy(author_next_entry, true);
+    mycss_destroy(mycss, true);
+    
+    myhtml_tree_destroy(modest->myhtml_tree);
+    myhtml_destroy(myhtml);
+    
+    modest_destroy(modest, true);
+    free(css);
+    
+    return test_total();
+}
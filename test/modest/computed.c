@@ -0,0 +1,371 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Computed style (modest/style/computed.h): inheritance, resolved lengths, colors,
+ * and shared stylesheets must be equal to stylesheets computed without sharing.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <modest/modest.h>
+#include <modest/glue.h>
+#include <modest/finder/finder.h>
+#include <modest/finder/thread.h>
+#include <modest/style/computed.h>
+#include <myhtml/myhtml.h>
+#include <mycss/mycss.h>
+
+#include "../test.h"
+
+#define TEST_LIST_SIZE 40
+
+static const char *test_css =
+"body {font-size: 20px; color: #336699}\n"
+"ul {margin: 10px 5% 0 auto}\n"
+".item {padding: 1em 2%; color: rgb(255, 0, 0)}\n"
+".item a {font: italic bold 150%/2 serif}\n"
+".item.big {font-size: larger; color: hsl(120, 100%, 25%); line-height: 120%}\n"
+"li.big a {font-weight: bolder; color: currentcolor}\n"
+"#rem {width: 2rem; height: 50%; font-size: 0.5em; color: inherit}\n"
+"#border {border-top-style: solid; border-top-width: thick; border-left-width: 4px; border-right-style: dashed}\n"
+"#named {color: rebeccapurple; display: none; font-weight: initial}\n";
+
+static const char *test_html_begin = "<html><body><div id=\"rem\"><p id=\"border\">b</p><span id=\"named\">n</span></div><ul>";
+static const char *test_html_end   = "</ul></body></html>";
+
+struct test_env {
+    modest_t* modest;
+    myhtml_t* myhtml;
+    mycss_entry_t* css_entry;
+    modest_finder_thread_t* finder_thread;
+    modest_style_computed_t* computed;
+}
+typedef test_env_t;
+
+static bool test_float_eq(float left, float right)
+{
+    return fabsf(left - right) < 0.01f;
+}
+
+static bool test_color_eq(modest_style_type_color_t* color, unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+    return color->r == r && color->g == g && color->b == b && color->a == a;
+}
+
+static char * test_make_html(void)
+{
+    size_t size = strlen(test_html_begin) + strlen(test_html_end) + (TEST_LIST_SIZE * 64) + 1;
+    char *html = malloc(size);
+    
+    if(html == NULL)
+        DIE("Can't allocate mem for HTML\n");
+    
+    size_t length = sprintf(html, "%s", test_html_begin);
+    
+    /* every 10th item is different */
+    for(size_t i = 0; i < TEST_LIST_SIZE; i++) {
+        length += sprintf(&html[length], "<li class=\"item%s\"><a href=\"#\">%zu</a></li>",
+                          ((i % 10) == 9 ? " big" : ""), i);
+    }
+    
+    sprintf(&html[length], "%s", test_html_end);
+    
+    return html;
+}
+
+static myhtml_tree_node_t * test_node_by_id(myhtml_tree_t* tree, const char* id)
+{
+    mystatus_t status;
+    myhtml_collection_t *collection = myhtml_get_nodes_by_attribute_value(tree, NULL, NULL, false, "id", 2, id, strlen(id), &status);
+    
+    if(collection == NULL || collection->length != 1)
+        DIE("Can't find node by id: %s\n", id);
+    
+    myhtml_tree_node_t *node = collection->list[0];
+    myhtml_collection_destroy(collection);
+    
+    return node;
+}
+
+static myhtml_tree_node_t * test_node_by_tag(myhtml_tree_t* tree, myhtml_tag_id_t tag_id, size_t index)
+{
+    myhtml_collection_t *collection = myhtml_get_nodes_by_tag_id(tree, NULL, tag_id, NULL);
+    
+    if(collection == NULL || collection->length <= index)
+        DIE("Can't find node by tag\n");
+    
+    myhtml_tree_node_t *node = collection->list[index];
+    myhtml_collection_destroy(collection);
+    
+    return node;
+}
+
+static void test_env_init(test_env_t* env)
+{
+    env->modest = modest_create();
+    mystatus_t status = modest_init(env->modest);
+    
+    CHECK_STATUS("Can't init Modest object\n");
+    
+    env->myhtml = myhtml_create();
+    status = myhtml_init(env->myhtml, MyHTML_OPTIONS_PARSE_MODE_SINGLE, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    env->modest->myhtml_tree = myhtml_tree_create();
+    status = myhtml_tree_init(env->modest->myhtml_tree, env->myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    myhtml_callback_tree_node_insert_set(env->modest->myhtml_tree, modest_glue_callback_myhtml_insert_node, (void*)env->modest);
+    
+    mycss_t *mycss = mycss_create();
+    status = mycss_init(mycss);
+    
+    CHECK_STATUS("Can't init MyCSS object\n");
+    
+    env->css_entry = mycss_entry_create();
+    status = mycss_entry_init(mycss, env->css_entry);
+    
+    CHECK_STATUS("Can't init MyCSS Entry object\n");
+    
+    status = mycss_parse(env->css_entry, MyENCODING_UTF_8, test_css, strlen(test_css));
+    CHECK_STATUS("Can't parse CSS\n");
+    
+    env->modest->mycss_entry = env->css_entry;
+    
+    modest_finder_t *finder = modest_finder_create_simple();
+    
+    env->finder_thread = modest_finder_thread_create();
+    status = modest_finder_thread_init(finder, env->finder_thread, 1);
+    
+    CHECK_STATUS("Can't init Modest Finder Thread object\n");
+    
+    env->computed = modest_style_computed_create();
+    status = modest_style_computed_init(env->computed, env->modest);
+    
+    CHECK_STATUS("Can't init Modest Style Computed object\n");
+}
+
+static void test_env_destroy(test_env_t* env)
+{
+    modest_finder_t *finder = env->finder_thread->finder;
+    
+    modest_style_computed_destroy(env->computed, true);
+    modest_finder_thread_destroy(env->finder_thread, true);
+    modest_finder_destroy(finder, true);
+    
+    mycss_stylesheet_destroy(mycss_entry_stylesheet(env->css_entry), true);
+    
+    mycss_t *mycss = env->css_entry->mycss;
+    mycss_entry_destroy(env->css_entry, true);
+    mycss_destroy(mycss, true);
+    
+    myhtml_tree_destroy(env->modest->myhtml_tree);
+    myhtml_destroy(env->myhtml);
+    
+    modest_destroy(env->modest, true);
+}
+
+static void test_parse(test_env_t* env, const char* html)
+{
+    modest_clean(env->modest);
+    
+    mystatus_t status = myhtml_parse(env->modest->myhtml_tree, MyENCODING_UTF_8, html, strlen(html));
+    CHECK_STATUS("Can't parse HTML\n");
+    
+    status = modest_finder_thread_process(env->modest, env->finder_thread, env->modest->myhtml_tree->node_html,
+                                          mycss_entry_stylesheet(env->css_entry)->sel_list_first);
+    CHECK_STATUS("Can't find by selectors with thread\n");
+    
+    status = modest_style_computed_process(env->computed, env->modest->myhtml_tree->node_html);
+    CHECK_STATUS("Can't process computed style\n");
+}
+
+static void test_values(test_env_t* env)
+{
+    myhtml_tree_t *tree = env->modest->myhtml_tree;
+    
+    modest_style_sheet_t *body = modest_style_computed_by_node(tree->node_body);
+    modest_style_sheet_t *ul   = modest_style_computed_by_node(test_node_by_tag(tree, MyHTML_TAG_UL, 0));
+    modest_style_sheet_t *li   = modest_style_computed_by_node(test_node_by_tag(tree, MyHTML_TAG_LI, 0));
+    modest_style_sheet_t *a    = modest_style_computed_by_node(test_node_by_tag(tree, MyHTML_TAG_A, 0));
+    modest_style_sheet_t *big  = modest_style_computed_by_node(test_node_by_tag(tree, MyHTML_TAG_LI, 9));
+    modest_style_sheet_t *big_a  = modest_style_computed_by_node(test_node_by_tag(tree, MyHTML_TAG_A, 9));
+    modest_style_sheet_t *rem    = modest_style_computed_by_node(test_node_by_id(tree, "rem"));
+    modest_style_sheet_t *border = modest_style_computed_by_node(test_node_by_id(tree, "border"));
+    modest_style_sheet_t *named  = modest_style_computed_by_node(test_node_by_id(tree, "named"));
+    
+    test_check(test_float_eq(body->font_size.value, 20.0f) &&
+               test_color_eq(&body->color, 0x33, 0x66, 0x99, 255),
+               "length in px and hex color");
+    
+    test_check(test_float_eq(ul->font_size.value, 20.0f) && test_color_eq(&ul->color, 0x33, 0x66, 0x99, 255) &&
+               ul->font_weight.value == 400 && ul->line_height.type == MyCSS_PROPERTY_LINE_HEIGHT_NORMAL,
+               "inherited by child");
+    
+    test_check(ul->padding_top.type == MyCSS_PROPERTY_VALUE__LENGTH && test_float_eq(ul->padding_top.value, 0.0f) &&
+               ul->width.type == MyCSS_PROPERTY_WIDTH_AUTO && ul->display.value == MyCSS_PROPERTY_DISPLAY_INLINE,
+               "not inherited");
+    
+    test_check(ul->margin_top.type == MyCSS_PROPERTY_VALUE__LENGTH && test_float_eq(ul->margin_top.value, 10.0f) &&
+               ul->margin_right.type == MyCSS_PROPERTY_VALUE__PERCENTAGE && test_float_eq(ul->margin_right.value, 5.0f) &&
+               test_float_eq(ul->margin_bottom.value, 0.0f) && ul->margin_left.type == MyCSS_PROPERTY_MARGIN_AUTO,
+               "margin shorthand, percentage and auto");
+    
+    test_check(test_float_eq(li->padding_top.value, 20.0f) &&
+               li->padding_right.type == MyCSS_PROPERTY_VALUE__PERCENTAGE && test_float_eq(li->padding_right.value, 2.0f) &&
+               test_color_eq(&li->color, 255, 0, 0, 255),
+               "em of padding and rgb color");
+    
+    test_check(test_float_eq(a->font_size.value, 30.0f) && a->font_weight.value == 700 &&
+               a->font_style.value == MyCSS_PROPERTY_FONT_STYLE_ITALIC &&
+               a->line_height.type == MyCSS_PROPERTY_VALUE__NUMBER && test_float_eq(a->line_height.value, 2.0f) &&
+               test_color_eq(&a->color, 255, 0, 0, 255),
+               "font shorthand");
+    
+    test_check(test_float_eq(big->font_size.value, 24.0f) &&
+               test_color_eq(&big->color, 0, 128, 0, 255) &&
+               big->line_height.type == MyCSS_PROPERTY_VALUE__LENGTH && test_float_eq(big->line_height.value, 28.8f),
+               "larger, hsl and percentage of line height");
+    
+    test_check(big_a->font_weight.value == 700 && test_float_eq(big_a->font_size.value, 36.0f) &&
+               test_color_eq(&big_a->color, 0, 128, 0, 255),
+               "bolder and currentcolor");
+    
+    test_check(test_float_eq(rem->font_size.value, 10.0f) &&
+               test_float_eq(rem->width.value, 32.0f) && rem->height.type == MyCSS_PROPERTY_VALUE__PERCENTAGE &&
+               test_color_eq(&rem->color, 0x33, 0x66, 0x99, 255),
+               "rem, em of font size and inherit");
+    
+    test_check(test_float_eq(border->border_top_width.value, 5.0f) &&
+               test_float_eq(border->border_left_width.value, 0.0f) && test_float_eq(border->border_right_width.value, 3.0f) &&
+               test_float_eq(border->border_bottom_width.value, 0.0f),
+               "border width by border style");
+    
+    test_check(border->display.value == MyCSS_PROPERTY_DISPLAY_BLOCK &&
+               named->display.value == MyCSS_PROPERTY_DISPLAY_NONE && named->font_weight.value == 400 &&
+               test_color_eq(&named->color, 0x66, 0x33, 0x99, 255),
+               "default of html node, named color and initial");
+}
+
+static void test_sharing(test_env_t* env, const char* html)
+{
+    myhtml_tree_t *tree = env->modest->myhtml_tree;
+    
+    myhtml_collection_t *li_list = myhtml_get_nodes_by_tag_id(tree, NULL, MyHTML_TAG_LI, NULL);
+    myhtml_collection_t *a_list  = myhtml_get_nodes_by_tag_id(tree, NULL, MyHTML_TAG_A, NULL);
+    
+    if(li_list == NULL || a_list == NULL || li_list->length != TEST_LIST_SIZE || a_list->length != TEST_LIST_SIZE)
+        DIE("Bad count of list items\n");
+    
+    bool is_good = true;
+    
+    for(size_t i = 0; i < TEST_LIST_SIZE; i++) {
+        modest_style_sheet_t *first = modest_style_computed_by_node(li_list->list[ ((i % 10) == 9 ? 9 : 0) ]);
+        modest_style_sheet_t *first_a = modest_style_computed_by_node(a_list->list[ ((i % 10) == 9 ? 9 : 0) ]);
+        
+        if(modest_style_computed_by_node(li_list->list[i]) != first || modest_style_computed_by_node(a_list->list[i]) != first_a)
+            is_good = false;
+    }
+    
+    is_good = is_good && modest_style_computed_by_node(li_list->list[0]) != modest_style_computed_by_node(li_list->list[9]);
+    
+    test_check(is_good, "siblings and cousins share stylesheet");
+    
+    size_t node_count = env->computed->sheet_count + env->computed->shared_count;
+    
+    test_check(env->computed->shared_count >= ((TEST_LIST_SIZE - 4) * 2) &&
+               env->computed->sheet_count < (node_count - ((TEST_LIST_SIZE - 4) * 2)) + 1,
+               "count of shared");
+    
+    /* copy values of all nodes, then compute without sharing */
+    modest_style_sheet_t *shared = malloc(sizeof(modest_style_sheet_t) * node_count);
+    myhtml_tree_node_t **nodes = malloc(sizeof(myhtml_tree_node_t*) * node_count);
+    
+    if(shared == NULL || nodes == NULL)
+        DIE("Can't allocate mem for test\n");
+    
+    size_t length = 0;
+    myhtml_tree_node_t *node = tree->node_html;
+    
+    while(node) {
+        if(node->data && length < node_count) {
+            nodes[length] = node;
+            shared[length] = *modest_style_computed_by_node(node);
+            length++;
+        }
+        
+        if(node->child)
+            node = node->child;
+        else {
+            while(node != tree->node_html && node->next == NULL)
+                node = node->parent;
+            
+            if(node == tree->node_html)
+                break;
+            
+            node = node->next;
+        }
+    }
+    
+    env->computed->share = false;
+    
+    mystatus_t status = modest_style_computed_process(env->computed, tree->node_html);
+    CHECK_STATUS("Can't process computed style\n");
+    
+    is_good = (length == node_count && env->computed->shared_count == 0 && env->computed->sheet_count == node_count);
+    
+    for(size_t i = 0; i < length; i++) {
+        if(memcmp(&shared[i], modest_style_computed_by_node(nodes[i]), sizeof(modest_style_sheet_t)))
+            is_good = false;
+    }
+    
+    test_check(is_good, "shared values are equal to not shared");
+    
+    env->computed->share = true;
+    
+    free(shared);
+    free(nodes);
+    
+    myhtml_collection_destroy(li_list);
+    myhtml_collection_destroy(a_list);
+}
+
+int main(int argc, const char * argv[])
+{
+    test_env_t env;
+    test_env_init(&env);
+    
+    char *html = test_make_html();
+    
+    test_parse(&env, html);
+    test_values(&env);
+    test_sharing(&env, html);
+    
+    free(html);
+    test_env_destroy(&env);
+    
+    return test_total();
+}
@@ -0,0 +1,193 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Element, #id and .class selectors take nodes from the tree index,
+ * the finder must find the same nodes in the same order as by walk.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <modest/finder/finder.h>
+#include <myhtml/myhtml.h>
+#include <mycss/mycss.h>
+#include <mycss/selectors/init.h>
+
+#include "../test.h"
+
+static const char *test_html_list[] = {
+    "<!DOCTYPE html><html><head><title>t</title></head><body class=\"main\">"
+    "<div id=\"a\" class=\"x y\"><p class=\"x\">1<span class=\"z\">s</span></p>text<p>2</p><ul><li>1<li class=\"x x\" class=\"z\">2<li id=\"l3\">3</ul></div>"
+    "<div class=\"y\"><div class=\"x\"><div><p class=\"Y z\"><a href=\"#\" class=\"x\">a</a><span>s</span></p></div></div>"
+    "<section><h1>h</h1><p>p1</p><p class=\"x\">p2</p><em>e</em><p id=\"a\">p3</p></section>"
+    "<custom-tag class=\"x\"><span>c</span></custom-tag></div>"
+    "<table><tr><td>1</td><td class=\"x\">2</td></tr></table>"
+    "</body></html><!-- end -->",
+    
+    /* quirks mode, id and class are case-insensitive */
+    "<div id=\"A\" class=\"X y\"><p class=\"x\">1<b>2<i class=\"Z\">3</b>4</i></p></div><div class=\"z\"><p id=\"a\">5</p></div>",
+    NULL
+};
+
+static const char *test_selectors[] = {
+    "p", "div", "span", "li", ".x", ".y", ".z", "#a", "#l3", "#A", "div p", "div > p", "div div p", "div .x", ".y .x",
+    ".x .z", ".x > span", "div#a > ul li", "p.x", ".x.y", "li + li", "li ~ li", "h1 ~ p.x", "p + em + p",
+    "div:not(.y) p", "custom-tag span", "tr td.x", "html", "body", "body > div", "div p span", "#a p, .z",
+    "i", "b i", ".main div", "x-none", ".none", "#none"
+};
+
+static myhtml_tree_t * parse_html(myhtml_t* myhtml, const char* data, bool index)
+{
+    myhtml_tree_t* tree = myhtml_tree_create();
+    mystatus_t status = myhtml_tree_init(tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    if(index) {
+        status = myhtml_tree_index_enable(tree);
+        CHECK_STATUS("Can't enable index for MyHTML Tree object\n");
+    }
+    
+    status = myhtml_parse(tree, MyENCODING_UTF_8, data, strlen(data));
+    CHECK_STATUS("Can't parse HTML:\n%s\n", data);
+    
+    return tree;
+}
+
+static myhtml_tree_node_t * test_scope(myhtml_tree_t* tree, size_t idx)
+{
+    switch(idx) {
+        case 0:  return myhtml_tree_get_document(tree);
+        case 1:  return myhtml_tree_get_node_html(tree);
+        default: return myhtml_node_child(myhtml_tree_get_node_body(tree));
+    }
+}
+
+/* position of node in document for compare nodes of two trees */
+static size_t test_node_position(myhtml_tree_node_t* node)
+{
+    size_t position = 0;
+    
+    while(node->prev || node->parent) {
+        if(node->prev) {
+            node = node->prev;
+            
+            while(node->last_child)
+                node = node->last_child;
+        }
+        else
+            node = node->parent;
+        
+        position++;
+    }
+    
+    return position;
+}
+
+static bool test_find(modest_finder_t* finder, myhtml_tree_t* indexed, myhtml_tree_t* walked, mycss_selectors_list_t* list, size_t scope)
+{
+    mystatus_t status;
+    myhtml_collection_t *first = myhtml_collection_create(128, &status);
+    myhtml_collection_t *second = myhtml_collection_create(128, &status);
+    
+    modest_finder_by_selectors_list(finder, test_scope(indexed, scope), list, &first);
+    modest_finder_by_selectors_list(finder, test_scope(walked, scope), list, &second);
+    
+    bool is_good = (first->length == second->length);
+    
+    for(size_t i = 0; is_good && i < first->length; i++) {
+        if(test_node_position(first->list[i]) != test_node_position(second->list[i]))
+            is_good = false;
+    }
+    
+    if(is_good == false)
+        printf(": scope " MyCORE_FORMAT_Z ", indexed " MyCORE_FORMAT_Z ", walked " MyCORE_FORMAT_Z, scope, first->length, second->length);
+    
+    myhtml_collection_destroy(first);
+    myhtml_collection_destroy(second);
+    
+    return is_good;
+}
+
+int main(int argc, const char * argv[])
+{
+    myhtml_t* myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, MyHTML_OPTIONS_DEFAULT, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    mycss_t *mycss = mycss_create();
+    status = mycss_init(mycss);
+    
+    CHECK_STATUS("Can't init MyCSS object\n");
+    
+    mycss_entry_t *css_entry = mycss_entry_create();
+    status = mycss_entry_init(mycss, css_entry);
+    
+    CHECK_STATUS("Can't init MyCSS Entry object\n");
+    
+    modest_finder_t *finder = modest_finder_create_simple();
+    
+    size_t count = sizeof(test_selectors) / sizeof(test_selectors[0]);
+    size_t total = 0, good = 0;
+    
+    for(size_t h = 0; test_html_list[h]; h++)
+    {
+        myhtml_tree_t *indexed = parse_html(myhtml, test_html_list[h], true);
+        myhtml_tree_t *walked = parse_html(myhtml, test_html_list[h], false);
+        
+        for(size_t i = 0; i < count; i++)
+        {
+            mycss_selectors_list_t *list = mycss_selectors_parse(mycss_entry_selectors(css_entry), MyENCODING_UTF_8,
+                                                                 test_selectors[i], strlen(test_selectors[i]), &status);
+            
+            if(list == NULL || (list->flags & MyCSS_SELECTORS_FLAGS_SELECTOR_BAD))
+                DIE("Bad CSS Selectors: %s\n", test_selectors[i]);
+            
+            for(size_t scope = 0; scope < 3; scope++) {
+                total++;
+                
+                printf(MyCORE_FORMAT_Z ") %s", total, test_selectors[i]);
+                
+                if(test_find(finder, indexed, walked, list, scope)) {
+                    printf(": good\n");
+                    good++;
+                }
+                else
+                    printf(": bad\n");
+            }
+        }
+        
+        myhtml_tree_destroy(indexed);
+        myhtml_tree_destroy(walked);
+    }
+    
+    printf("\nTotal: " MyCORE_FORMAT_Z "; Good: " MyCORE_FORMAT_Z "; Bad: " MyCORE_FORMAT_Z "\n",
+           total, good, (total - good));
+    
+    modest_finder_destroy(finder, true);
+    mycss_entry_destroy(css_entry, true);
+    mycss_destroy(mycss, true);
+    myhtml_destroy(myhtml);
+    
+    return (good == total ? EXIT_SUCCESS : EXIT_FAILURE);
+}
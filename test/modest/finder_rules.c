@@ -0,0 +1,249 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Right to left matching (modest/finder/rules.h) must find the same nodes
+ * as left to right matching (modest_finder_by_selectors_list).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <modest/finder/finder.h>
+#include <modest/finder/rules.h>
+#include <myhtml/myhtml.h>
+#include <mycss/mycss.h>
+#include <mycss/selectors/init.h>
+
+#include "../test.h"
+
+static const char *test_html =
+"<!DOCTYPE html><html><head><title>t</title></head><body class=\"main\">"
+"<div id=\"a\" class=\"x y\"><p class=\"x\">1<span class=\"z\">s</span></p>text<p>2</p><!-- c --><ul><li>1<li class=\"x\">2<li id=\"l3\">3</ul></div>"
+"<div class=\"y\"><div class=\"x\"><div><p class=\"Y z\"><a href=\"#\" class=\"x\">a</a><span>s</span></p></div></div>"
+"<section><h1>h</h1><p>p1</p><p class=\"x\">p2</p><em>e</em><p>p3</p></section>"
+"<custom-tag class=\"x\"><span>c</span></custom-tag><form><input type=\"text\" disabled><input type=\"checkbox\" checked></form></div>"
+"<table><tr><td>1</td><td class=\"x\">2</td></tr></table>"
+"</body></html>";
+
+static const char *test_selectors[] = {
+    "*", "p", "div", ".x", "#a", "#l3", "div p", "div > p", "div div p", "div .x", ".y .x", ".x .z",
+    "div#a > ul li", "li + li", "li ~ li", "h1 + p", "h1 ~ p", "h1 ~ p.x", "p + em + p", "section > *",
+    "div > div > div > p > a", ".main div.y p", "body > div:not(.y)", "p:first-child", "li:last-child",
+    "p:nth-child(2)", "li:nth-child(odd)", "p:not(.x)", ":not(p)", "[href]", "a[href=\"#\"]", "div [class~=z]",
+    "custom-tag span", "custom-tag", "input:disabled", "input:checked", "form > :not([disabled])", "tr td.x",
+    "html", "html body", "body > *", ":root", "span:only-child", "p:empty", "div:has(span)", ".y > .x > div p",
+    "ul ~ *", "div p span", "div > p > span", "* *", "* > p", "div :not(.x) span", "p.x, li.x, td.x",
+    "head title", "em ~ p", "p ~ em", "div ~ table", "body > div ~ div > div"
+};
+
+myhtml_tree_t * parse_html(const char* data, size_t data_size)
+{
+    myhtml_t* myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, MyHTML_OPTIONS_DEFAULT, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    myhtml_tree_t* tree = myhtml_tree_create();
+    status = myhtml_tree_init(tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    status = myhtml_parse(tree, MyENCODING_UTF_8, data, data_size);
+    CHECK_STATUS("Can't parse HTML:\n%s\n", data);
+    
+    return tree;
+}
+
+mycss_entry_t * create_css_parser(void)
+{
+    mycss_t *mycss = mycss_create();
+    mystatus_t status = mycss_init(mycss);
+    
+    CHECK_STATUS("Can't init MyCSS object\n");
+    
+    mycss_entry_t *entry = mycss_entry_create();
+    status = mycss_entry_init(mycss, entry);
+    
+    CHECK_STATUS("Can't init MyCSS Entry object\n");
+    
+    return entry;
+}
+
+static int test_node_cmp(const void* left, const void* right)
+{
+    const myhtml_tree_node_t *l = *((myhtml_tree_node_t* const*)left), *r = *((myhtml_tree_node_t* const*)right);
+    
+    return (l < r ? -1 : (l > r ? 1 : 0));
+}
+
+/* left to right may find a node twice */
+static void test_collection_unique(myhtml_collection_t* collection)
+{
+    if(collection->length < 2)
+        return;
+    
+    qsort(collection->list, collection->length, sizeof(myhtml_tree_node_t*), test_node_cmp);
+    
+    size_t length = 1;
+    
+    for(size_t i = 1; i < collection->length; i++) {
+        if(collection->list[i] != collection->list[ (length - 1) ]) {
+            collection->list[length] = collection->list[i];
+            length++;
+        }
+    }
+    
+    collection->length = length;
+}
+
+static bool test_rules(modest_finder_t* finder, myhtml_tree_t* tree, mycss_selectors_list_t* list)
+{
+    mystatus_t status;
+    myhtml_collection_t *ltr = myhtml_collection_create(128, &status);
+    myhtml_collection_t *rtl = myhtml_collection_create(128, &status);
+    
+    modest_finder_by_selectors_list(finder, tree->node_html, list, &ltr);
+    
+    modest_finder_rules_t *rules = modest_finder_rules_create();
+    status = modest_finder_rules_init(rules, list, 0);
+    CHECK_STATUS("Can't init rules\n");
+    
+    status = modest_finder_by_rules(finder, tree->node_html, rules, &rtl);
+    CHECK_STATUS("Can't find by rules\n");
+    
+    test_collection_unique(ltr);
+    test_collection_unique(rtl);
+    
+    bool is_good = (ltr->length == rtl->length &&
+                    memcmp(ltr->list, rtl->list, sizeof(myhtml_tree_node_t*) * ltr->length) == 0);
+    
+    if(is_good == false)
+        printf(": left to right " MyCORE_FORMAT_Z ", right to left " MyCORE_FORMAT_Z, ltr->length, rtl->length);
+    
+    modest_finder_rules_destroy(rules, true);
+    
+    myhtml_collection_destroy(ltr);
+    myhtml_collection_destroy(rtl);
+    
+    return is_good;
+}
+
+/* one stylesheet with all selectors: rules are sorted by specificity, then by source order */
+static bool test_rules_order(mycss_entry_t* css_entry)
+{
+    size_t count = sizeof(test_selectors) / sizeof(test_selectors[0]);
+    size_t css_length = 0;
+    
+    for(size_t i = 0; i < count; i++)
+        css_length += strlen(test_selectors[i]) + 4;
+    
+    char *css = malloc(css_length + 1);
+    if(css == NULL)
+        DIE("Can't allocate mem for CSS\n");
+    
+    css_length = 0;
+    
+    for(size_t i = 0; i < count; i++)
+        css_length += sprintf(&css[css_length], "%s {}\n", test_selectors[i]);
+    
+    mystatus_t status = mycss_parse(css_entry, MyENCODING_UTF_8, css, css_length);
+    CHECK_STATUS("Can't parse CSS\n");
+    
+    modest_finder_rules_t *rules = modest_finder_rules_create();
+    status = modest_finder_rules_init_by_stylesheet(rules, mycss_entry_stylesheet(css_entry), 0);
+    CHECK_STATUS("Can't init rules\n");
+    
+    bool is_good = (rules->list_length > count);
+    
+    for(size_t i = 1; i < rules->list_length; i++) {
+        mycss_selectors_specificity_t *prev = &rules->list[(i - 1)].specificity, *spec = &rules->list[i].specificity;
+        
+        if(prev->a != spec->a ? prev->a > spec->a :
+           (prev->b != spec->b ? prev->b > spec->b :
+            (prev->c != spec->c ? prev->c > spec->c : rules->list[(i - 1)].order > rules->list[i].order)))
+        {
+            is_good = false;
+        }
+    }
+    
+    modest_finder_rules_destroy(rules, true);
+    mycss_stylesheet_destroy(mycss_entry_stylesheet(css_entry), true);
+    free(css);
+    
+    return is_good;
+}
+
+int main(int argc, const char * argv[])
+{
+    myhtml_tree_t *tree = parse_html(test_html, strlen(test_html));
+    mycss_entry_t *css_entry = create_css_parser();
+    modest_finder_t *finder = modest_finder_create_simple();
+    
+    size_t count = sizeof(test_selectors) / sizeof(test_selectors[0]);
+    size_t good = 0;
+    
+    for(size_t i = 0; i < count; i++)
+    {
+        mystatus_t status;
+        mycss_selectors_list_t *list = mycss_selectors_parse(mycss_entry_selectors(css_entry), MyENCODING_UTF_8,
+                                                             test_selectors[i], strlen(test_selectors[i]), &status);
+        
+        if(list == NULL || (list->flags & MyCSS_SELECTORS_FLAGS_SELECTOR_BAD))
+            DIE("Bad CSS Selectors: %s\n", test_selectors[i]);
+        
+        printf(MyCORE_FORMAT_Z ") %s", (i + 1), test_selectors[i]);
+        
+        if(test_rules(finder, tree, list)) {
+            printf(": good\n");
+            good++;
+        }
+        else
+            printf(": bad\n");
+        
+        mycss_selectors_list_destroy(mycss_entry_selectors(css_entry), list, true);
+    }
+    
+    count++;
+    
+    printf(MyCORE_FORMAT_Z ") order of rules", count);
+    
+    if(test_rules_order(css_entry)) {
+        printf(": good\n");
+        good++;
+    }
+    else
+        printf(": bad\n");
+    
+    printf("\nTotal: " MyCORE_FORMAT_Z "; Good: " MyCORE_FORMAT_Z "; Bad: " MyCORE_FORMAT_Z "\n", count, good, (count - good));
+    
+    modest_finder_destroy(finder, true);
+    
+    mycss_t *mycss = css_entry->mycss;
+    mycss_entry_destroy(css_entry, true);
+    mycss_destroy(mycss, true);
+    
+    myhtml_t* myhtml = tree->myhtml;
+    myhtml_tree_destroy(tree);
+    myhtml_destroy(myhtml);
+    
+    return (good == count ? EXIT_SUCCESS : EXIT_FAILURE);
+}
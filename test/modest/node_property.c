@@ -0,0 +1,228 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Cascaded declarations of modest nodes (modest/node/node.h): whatever store is built
+ * (MODEST_BUILD_NODE_STORE), declarations set by type must be found by type and listed once.
+ * A declaration that can not be stored is reported by status.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <modest/modest.h>
+#include <modest/node/node.h>
+#include <modest/style/raw.h>
+#include <mycore/utils/mcallocator.h>
+
+#include "../test.h"
+
+#define TEST_NODE_COUNT 64
+
+/* while set, allocator of modest fails */
+static bool test_malloc_fail = false;
+
+struct test_list_context {
+    modest_style_raw_declaration_t** expect;
+    size_t count;
+    bool is_good;
+}
+typedef test_list_context_t;
+
+static void test_list_callback(mycss_property_type_t type, modest_style_raw_declaration_t *raw_declr, void* ctx)
+{
+    test_list_context_t *context = ctx;
+    
+    /* every type once, cleared after visit */
+    if(type >= MyCSS_PROPERTY_TYPE_LAST_ENTRY || context->expect[type] != raw_declr)
+        context->is_good = false;
+    else
+        context->expect[type] = NULL;
+    
+    context->count++;
+}
+
+static bool test_node(modest_t* modest, size_t seed)
+{
+    modest_style_raw_declaration_t *expect[MyCSS_PROPERTY_TYPE_LAST_ENTRY];
+    memset(expect, 0, sizeof(expect));
+    
+    modest_node_t *mnode = modest_node_create(modest);
+    if(mnode == NULL || modest_node_init(modest, mnode))
+        DIE("Can't create Modest Node\n");
+    
+    /* from a few declarations to all types, some types are set twice */
+    size_t count = (seed * 7) % (MyCSS_PROPERTY_TYPE_LAST_ENTRY + 40);
+    size_t type = seed;
+    size_t length = 0;
+    
+    for(size_t i = 0; i < count; i++) {
+        type = (type * 1103515245 + 12345) % MyCSS_PROPERTY_TYPE_LAST_ENTRY;
+        
+        modest_style_raw_declaration_t *raw_declr = modest_style_raw_declaration_create(modest);
+        if(raw_declr == NULL)
+            DIE("Can't create Modest Raw Declaration\n");
+        
+        if(expect[type] == NULL)
+            length++;
+        
+        expect[type] = raw_declr;
+        
+        if(modest_node_raw_declaration_set_by_type(modest, mnode, (mycss_property_type_t)type, raw_declr))
+            return false;
+    }
+    
+    /* the first and the last types */
+    if(seed == 0) {
+        modest_style_raw_declaration_t *raw_declr = modest_style_raw_declaration_create(modest);
+        
+        expect[0] = raw_declr;
+        expect[(MyCSS_PROPERTY_TYPE_LAST_ENTRY - 1)] = raw_declr;
+        length += 2;
+        
+        if(modest_node_raw_declaration_set_by_type(modest, mnode, (mycss_property_type_t)0, raw_declr) ||
+           modest_node_raw_declaration_set_by_type(modest, mnode, (mycss_property_type_t)(MyCSS_PROPERTY_TYPE_LAST_ENTRY - 1), raw_declr))
+        {
+            return false;
+        }
+    }
+    
+    for(size_t i = 0; i < MyCSS_PROPERTY_TYPE_LAST_ENTRY; i++) {
+        if(modest_node_raw_declaration_by_type(modest, mnode, (mycss_property_type_t)i) != expect[i])
+            return false;
+    }
+    
+    test_list_context_t context = {expect, 0, true};
+    modest_node_raw_declaration_list_all(modest, mnode, test_list_callback, &context);
+    
+    return (context.is_good && context.count == length);
+}
+
+static void * test_malloc(size_t size, void* ctx)
+{
+    return (test_malloc_fail ? NULL : malloc(size));
+}
+
+static void * test_realloc(void* dst, size_t size, void* ctx)
+{
+    return (test_malloc_fail ? NULL : realloc(dst, size));
+}
+
+static void test_free(void* dst, void* ctx)
+{
+    free(dst);
+}
+
+/* the flat store takes lists from an arena; when it has no memory the declaration is not stored (other stores can not fail) */
+static bool test_memory_error(void)
+{
+    if(strcmp(modest_node_store_name(), "flat"))
+        return true;
+    
+    mcallocator_t *allocator = mcallocator_create();
+    mystatus_t status = mcallocator_init(allocator, test_malloc, test_realloc, test_free, NULL);
+    
+    CHECK_STATUS("Can't init allocator\n");
+    
+    modest_t *modest = modest_create();
+    modest_allocator_set(modest, allocator);
+    
+    status = modest_init(modest);
+    CHECK_STATUS("Can't init Modest object\n");
+    
+    modest_node_t *mnodes[TEST_NODE_COUNT];
+    modest_style_raw_declaration_t *raw_declr = modest_style_raw_declaration_create(modest);
+    
+    for(size_t i = 0; i < TEST_NODE_COUNT; i++) {
+        mnodes[i] = modest_node_create(modest);
+        
+        if(mnodes[i] == NULL || modest_node_init(modest, mnodes[i]) || raw_declr == NULL)
+            DIE("Can't create Modest Node\n");
+    }
+    
+    test_malloc_fail = true;
+    
+    /* all types to all nodes are more than the first chunk of arena */
+    for(size_t i = 0; i < TEST_NODE_COUNT && status == MODEST_STATUS_OK; i++) {
+        for(size_t type = 0; type < MyCSS_PROPERTY_TYPE_LAST_ENTRY; type++) {
+            if((status = modest_node_raw_declaration_set_by_type(modest, mnodes[i], (mycss_property_type_t)type, raw_declr))) {
+                /* not stored */
+                if(modest_node_raw_declaration_by_type(modest, mnodes[i], (mycss_property_type_t)type))
+                    status = MODEST_STATUS_OK;
+                
+                break;
+            }
+        }
+    }
+    
+    test_malloc_fail = false;
+    
+    modest_destroy(modest, true);
+    mcallocator_destroy(allocator, true);
+    
+    return (status == MODEST_STATUS_ERROR_MEMORY_ALLOCATION);
+}
+
+int main(int argc, const char * argv[])
+{
+    modest_t *modest = modest_create();
+    mystatus_t status = modest_init(modest);
+    
+    CHECK_STATUS("Can't init Modest object\n");
+    
+    size_t total = 0, good = 0;
+    
+    /* the second pass is on memory after modest_clean */
+    for(size_t pass = 0; pass < 2; pass++) {
+        for(size_t i = 0; i < TEST_NODE_COUNT; i++) {
+            total++;
+            
+            printf(MyCORE_FORMAT_Z ") node " MyCORE_FORMAT_Z ", pass " MyCORE_FORMAT_Z, total, i, pass);
+            
+            if(test_node(modest, i)) {
+                printf(": good\n");
+                good++;
+            }
+            else
+                printf(": bad\n");
+        }
+        
+        modest_clean(modest);
+    }
+    
+    total++;
+    
+    printf(MyCORE_FORMAT_Z ") memory error of store", total);
+    
+    if(test_memory_error()) {
+        printf(": good\n");
+        good++;
+    }
+    else
+        printf(": bad\n");
+    
+    printf("\nTotal: " MyCORE_FORMAT_Z "; Good: " MyCORE_FORMAT_Z "; Bad: " MyCORE_FORMAT_Z "\n",
+           total, good, (total - good));
+    
+    modest_destroy(modest, true);
+    
+    return (good == total ? EXIT_SUCCESS : EXIT_FAILURE);
+}
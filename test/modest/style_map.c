@@ -0,0 +1,243 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Collation of shorthands (modest/style/map.h): values of a shorthand must be
+ * cascaded to nodes by the types of their longhands.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <modest/modest.h>
+#include <modest/glue.h>
+#include <modest/node/node.h>
+#include <modest/finder/finder.h>
+#include <modest/finder/thread.h>
+#include <myhtml/myhtml.h>
+#include <mycss/mycss.h>
+#include <mycss/declaration/default.h>
+
+#include "../test.h"
+
+static const char *test_css =
+"#one {margin: 1px}\n"
+"#two {margin: 1px 2px}\n"
+"#three {margin: 1px 2px 3px}\n"
+"#four {margin: 1px 2px 3px 4px}\n"
+"#font {font: italic bold 12px/2 serif}\n"
+"#size {font: 12px serif}\n"
+"#keyword {font: inherit}\n";
+
+static const char *test_html =
+"<div id=\"one\"></div><div id=\"two\"></div><div id=\"three\"></div><div id=\"four\"></div>"
+"<p id=\"font\"></p><p id=\"size\"></p><p id=\"keyword\"></p>";
+
+struct test_env {
+    modest_t* modest;
+    myhtml_t* myhtml;
+    mycss_entry_t* css_entry;
+    modest_finder_thread_t* finder_thread;
+}
+typedef test_env_t;
+
+static void test_env_init(test_env_t* env, const char* css, const char* html)
+{
+    env->modest = modest_create();
+    mystatus_t status = modest_init(env->modest);
+
+    CHECK_STATUS("Can't init Modest object\n");
+
+    env->myhtml = myhtml_create();
+    status = myhtml_init(env->myhtml, MyHTML_OPTIONS_PARSE_MODE_SINGLE, 1, 0);
+
+    CHECK_STATUS("Can't init MyHTML object\n");
+
+    env->modest->myhtml_tree = myhtml_tree_create();
+    status = myhtml_tree_init(env->modest->myhtml_tree, env->myhtml);
+
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+
+    myhtml_callback_tree_node_insert_set(env->modest->myhtml_tree, modest_glue_callback_myhtml_insert_node, (void*)env->modest);
+
+    mycss_t *mycss = mycss_create();
+    status = mycss_init(mycss);
+
+    CHECK_STATUS("Can't init MyCSS object\n");
+
+    env->css_entry = mycss_entry_create();
+    status = mycss_entry_init(mycss, env->css_entry);
+
+    CHECK_STATUS("Can't init MyCSS Entry object\n");
+
+    status = mycss_parse(env->css_entry, MyENCODING_UTF_8, css, strlen(css));
+    CHECK_STATUS("Can't parse CSS\n");
+
+    env->modest->mycss_entry = env->css_entry;
+
+    status = myhtml_parse(env->modest->myhtml_tree, MyENCODING_UTF_8, html, strlen(html));
+    CHECK_STATUS("Can't parse HTML\n");
+
+    modest_finder_t *finder = modest_finder_create_simple();
+
+    env->finder_thread = modest_finder_thread_create();
+    status = modest_finder_thread_init(finder, env->finder_thread, 1);
+
+    CHECK_STATUS("Can't init Modest Finder Thread object\n");
+
+    status = modest_finder_thread_process(env->modest, env->finder_thread, env->modest->myhtml_tree->node_html,
+                                          mycss_entry_stylesheet(env->css_entry)->sel_list_first);
+    CHECK_STATUS("Can't find by selectors with thread\n");
+}
+
+static void test_env_destroy(test_env_t* env)
+{
+    modest_finder_t *finder = env->finder_thread->finder;
+
+    modest_finder_thread_destroy(env->finder_thread, true);
+    modest_finder_destroy(finder, true);
+
+    mycss_stylesheet_destroy(mycss_entry_stylesheet(env->css_entry), true);
+
+    mycss_t *mycss = env->css_entry->mycss;
+    mycss_entry_destroy(env->css_entry, true);
+    mycss_destroy(mycss, true);
+
+    myhtml_tree_destroy(env->modest->myhtml_tree);
+    myhtml_destroy(env->myhtml);
+
+    modest_destroy(env->modest, true);
+}
+
+static modest_node_t * test_node_by_id(test_env_t* env, const char* id)
+{
+    mystatus_t status;
+    myhtml_collection_t *collection = myhtml_get_nodes_by_attribute_value(env->modest->myhtml_tree, NULL, NULL, false,
+                                                                          "id", 2, id, strlen(id), &status);
+
+    if(collection == NULL || collection->length != 1)
+        DIE("Can't find node by id: %s\n", id);
+
+    myhtml_tree_node_t *node = collection->list[0];
+    myhtml_collection_destroy(collection);
+
+    return (modest_node_t*)node->data;
+}
+
+static void * test_value(test_env_t* env, modest_node_t* mnode, mycss_property_type_t type)
+{
+    mycss_declaration_entry_t *decl = modest_node_declaration_by_type(env->modest, mnode, type);
+    return (decl ? decl->value : NULL);
+}
+
+/* declarations of top, right, bottom and left must be values of shorthand in given order */
+static bool test_margin(test_env_t* env, const char* id, unsigned int top, unsigned int right, unsigned int bottom, unsigned int left)
+{
+    modest_node_t *mnode = test_node_by_id(env, id);
+
+    if(mnode == NULL)
+        return false;
+
+    mycss_declaration_entry_t *values[4] = {
+        modest_node_declaration_by_type(env->modest, mnode, MyCSS_PROPERTY_TYPE_MARGIN_TOP),
+        modest_node_declaration_by_type(env->modest, mnode, MyCSS_PROPERTY_TYPE_MARGIN_RIGHT),
+        modest_node_declaration_by_type(env->modest, mnode, MyCSS_PROPERTY_TYPE_MARGIN_BOTTOM),
+        modest_node_declaration_by_type(env->modest, mnode, MyCSS_PROPERTY_TYPE_MARGIN_LEFT)
+    };
+
+    unsigned int expect[4] = {top, right, bottom, left};
+
+    for(size_t i = 0; i < 4; i++) {
+        if(values[i] == NULL || values[i]->value_type != MyCSS_PROPERTY_VALUE__LENGTH)
+            return false;
+
+        mycss_values_length_t *length = (mycss_values_length_t*)values[i]->value;
+
+        if(length == NULL || length->is_float || length->value.i != (int)expect[i])
+            return false;
+    }
+
+    return (test_value(env, mnode, MyCSS_PROPERTY_TYPE_MARGIN) == NULL);
+}
+
+/* longhands of font, omitted values are initial */
+static bool test_font(test_env_t* env)
+{
+    modest_node_t *font = test_node_by_id(env, "font");
+    modest_node_t *size = test_node_by_id(env, "size");
+
+    mycss_declaration_entry_t *weight = modest_node_declaration_by_type(env->modest, font, MyCSS_PROPERTY_TYPE_FONT_WEIGHT);
+    mycss_declaration_entry_t *style  = modest_node_declaration_by_type(env->modest, font, MyCSS_PROPERTY_TYPE_FONT_STYLE);
+
+    if(weight == NULL || weight->value_type != MyCSS_PROPERTY_FONT_WEIGHT_BOLD ||
+       style == NULL || style->value_type != MyCSS_PROPERTY_FONT_STYLE_ITALIC ||
+       test_value(env, font, MyCSS_PROPERTY_TYPE_FONT_SIZE) == NULL ||
+       test_value(env, font, MyCSS_PROPERTY_TYPE_LINE_HEIGHT) == NULL ||
+       test_value(env, font, MyCSS_PROPERTY_TYPE_FONT_FAMILY) == NULL)
+    {
+        return false;
+    }
+
+    return (modest_node_declaration_by_type(env->modest, size, MyCSS_PROPERTY_TYPE_FONT_WEIGHT) ==
+            mycss_declaration_default_by_type(MyCSS_PROPERTY_TYPE_FONT_WEIGHT) &&
+            modest_node_declaration_by_type(env->modest, size, MyCSS_PROPERTY_TYPE_LINE_HEIGHT) ==
+            mycss_declaration_default_by_type(MyCSS_PROPERTY_TYPE_LINE_HEIGHT) &&
+            test_value(env, size, MyCSS_PROPERTY_TYPE_FONT_SIZE) != NULL);
+}
+
+/* CSS-wide keyword of font goes to all longhands */
+static bool test_font_keyword(test_env_t* env)
+{
+    modest_node_t *mnode = test_node_by_id(env, "keyword");
+    mycss_property_type_t types[] = {MyCSS_PROPERTY_TYPE_FONT_STYLE, MyCSS_PROPERTY_TYPE_FONT_WEIGHT,
+        MyCSS_PROPERTY_TYPE_FONT_SIZE, MyCSS_PROPERTY_TYPE_LINE_HEIGHT, MyCSS_PROPERTY_TYPE_FONT_FAMILY};
+
+    for(size_t i = 0; i < (sizeof(types) / sizeof(types[0])); i++) {
+        mycss_declaration_entry_t *decl = modest_node_declaration_by_type(env->modest, mnode, types[i]);
+
+        if(decl == NULL || decl->value_type != MyCSS_PROPERTY_VALUE_INHERIT)
+            return false;
+    }
+
+    return true;
+}
+
+static void test_shorthands(void)
+{
+    test_env_t env;
+    test_env_init(&env, test_css, test_html);
+
+    test_check(test_margin(&env, "one", 1, 1, 1, 1), "margin of one value");
+    test_check(test_margin(&env, "two", 1, 2, 1, 2), "margin of two values");
+    test_check(test_margin(&env, "three", 1, 2, 3, 2), "margin of three values");
+    test_check(test_margin(&env, "four", 1, 2, 3, 4), "margin of four values");
+    test_check(test_font(&env), "font to longhands");
+    test_check(test_font_keyword(&env), "font of CSS-wide keyword");
+
+    test_env_destroy(&env);
+}
+
+int main(int argc, const char * argv[])
+{
+    test_shorthands();
+
+    return test_total();
+}
@@ -0,0 +1,292 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Allocator (mycore/utils/mcallocator.h) must count bytes of pools of trees,
+ * CSS entries and Modest, give all of them back on destroy and stop parsing
+ * when its limit is exceeded.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myhtml/myhtml.h>
+#include <mycss/mycss.h>
+#include <modest/modest.h>
+
+#include "../../test.h"
+
+struct test_counter {
+    size_t malloc;
+    size_t realloc;
+    size_t free;
+}
+typedef test_counter_t;
+
+static size_t test_global_calls = 0;
+
+static void * test_malloc(size_t size, void* ctx)
+{
+    ((test_counter_t*)ctx)->malloc++;
+    return malloc(size);
+}
+
+static void * test_realloc(void* dst, size_t size, void* ctx)
+{
+    ((test_counter_t*)ctx)->realloc++;
+    return realloc(dst, size);
+}
+
+static void test_free(void* dst, void* ctx)
+{
+    ((test_counter_t*)ctx)->free++;
+    free(dst);
+}
+
+static void * test_global_malloc(size_t size)
+{
+    test_global_calls++;
+    return malloc(size);
+}
+
+static void * test_global_realloc(void* dst, size_t size)
+{
+    test_global_calls++;
+    return realloc(dst, size);
+}
+
+static void * test_global_calloc(size_t num, size_t size)
+{
+    test_global_calls++;
+    return calloc(num, size);
+}
+
+static void test_global_free(void* dst)
+{
+    test_global_calls++;
+    free(dst);
+}
+
+static char * test_html_generate(size_t count, size_t* length)
+{
+    static const char item[] = "<div class=\"a b\"><p id=x>text <b>bold</b> &amp; more</p></div>";
+    
+    char *html = malloc((sizeof(item) - 1) * count + 1);
+    if(html == NULL)
+        DIE("Can't allocate memory for HTML\n");
+    
+    for(size_t i = 0; i < count; i++)
+        memcpy(&html[(sizeof(item) - 1) * i], item, (sizeof(item) - 1));
+    
+    *length = (sizeof(item) - 1) * count;
+    html[*length] = '\0';
+    
+    return html;
+}
+
+static void test_allocator(void)
+{
+    test_counter_t counter = {0};
+    mcallocator_t *allocator = mcallocator_create();
+    
+    test_check(mcallocator_init(allocator, test_malloc, NULL, test_free, &counter) != MyCORE_STATUS_OK,
+               "init without some of functions");
+    test_check(mcallocator_init(allocator, test_malloc, test_realloc, test_free, &counter) == MyCORE_STATUS_OK,
+               "init with functions");
+    
+    char *data = mcallocator_malloc(allocator, 100);
+    test_check(data && counter.malloc == 1 && mcallocator_bytes(allocator) == 100, "malloc is counted");
+    test_check(((size_t)data % sizeof(size_t)) == 0, "malloc data is aligned");
+    
+    memset(data, 'a', 100);
+    data = mcallocator_realloc(allocator, data, 1000);
+    test_check(data && counter.realloc == 1 && mcallocator_bytes(allocator) == 1000 && data[99] == 'a',
+               "realloc is counted");
+    
+    data = mcallocator_realloc(allocator, data, 10);
+    test_check(data && mcallocator_bytes(allocator) == 10 && mcallocator_bytes_peak(allocator) == 1000,
+               "realloc to less size");
+    
+    unsigned char *zero = mcallocator_calloc(allocator, 16, 4);
+    test_check(zero && zero[0] == 0 && zero[63] == 0 && mcallocator_bytes(allocator) == 74, "calloc is counted");
+    
+    mcallocator_free(allocator, zero);
+    mcallocator_free(allocator, data);
+    mcallocator_free(allocator, NULL);
+    test_check(counter.free == 2 && mcallocator_bytes(allocator) == 0, "free is counted");
+    
+    mcallocator_clean(allocator);
+    test_check(mcallocator_bytes_peak(allocator) == 0, "clean resets peak");
+    
+    mcallocator_limit_set(allocator, 10);
+    data = mcallocator_malloc(allocator, 11);
+    test_check(data && mcallocator_limit_exceeded(allocator), "limit exceeded");
+    mcallocator_free(allocator, data);
+    test_check(mcallocator_limit_exceeded(allocator) == false, "limit is not exceeded after free");
+    
+    data = mcallocator_malloc(NULL, 8);
+    test_check(data && mcallocator_free(NULL, data) == NULL, "without allocator");
+    
+    mcallocator_destroy(allocator, true);
+}
+
+static void test_myhtml(void)
+{
+    test_counter_t counter = {0};
+    mcallocator_t *allocator = mcallocator_create();
+    
+    mystatus_t status = mcallocator_init(allocator, test_malloc, test_realloc, test_free, &counter);
+    CHECK_STATUS("Can't init allocator\n");
+    
+    myhtml_t* myhtml = myhtml_create();
+    status = myhtml_init(myhtml, MyHTML_OPTIONS_DEFAULT, 1, 0);
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    myhtml_allocator_set(myhtml, allocator);
+    test_check(myhtml_allocator(myhtml) == allocator, "allocator of myhtml");
+    
+    myhtml_tree_t* tree = myhtml_tree_create();
+    status = myhtml_tree_init(tree, myhtml);
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    status = myhtml_tree_index_enable(tree);
+    CHECK_STATUS("Can't enable index\n");
+    
+    size_t init_bytes = mcallocator_bytes(allocator);
+    test_check(init_bytes && counter.malloc, "tree takes memory from allocator");
+    
+    size_t length;
+    char *html = test_html_generate(2000, &length);
+    
+    status = myhtml_parse(tree, MyENCODING_UTF_8, html, length);
+    test_check(status == MyCORE_STATUS_OK, "parse without limit");
+    
+    size_t parse_bytes = mcallocator_bytes(allocator);
+    test_check(parse_bytes > init_bytes, "tree takes more memory for parsing");
+    
+    /* limit is a half of memory of this document */
+    mcallocator_limit_set(allocator, init_bytes + ((parse_bytes - init_bytes) / 2));
+    mcallocator_t *other = mcallocator_create();
+    
+    myhtml_tree_t* limited = myhtml_tree_create();
+    
+    status = mcallocator_init(other, NULL, NULL, NULL, NULL);
+    CHECK_STATUS("Can't init allocator\n");
+    
+    mcallocator_limit_set(other, mcallocator_limit(allocator) - init_bytes);
+    myhtml_allocator_set(myhtml, other);
+    
+    status = myhtml_tree_init(limited, myhtml);
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    status = myhtml_parse(limited, MyENCODING_UTF_8, html, length);
+    test_check(status == MyCORE_STATUS_ERROR_MEMORY_LIMIT, "parse stops on limit");
+    
+    myhtml_tree_node_t *body = myhtml_tree_get_node_body(limited);
+    test_check(body && myhtml_node_child(body) && myhtml_node_child(body)->tag_id == MyHTML_TAG_DIV,
+               "tree has nodes before limit");
+    
+    myhtml_collection_t *collection = myhtml_get_nodes_by_tag_id(limited, NULL, MyHTML_TAG_DIV, NULL);
+    test_check(collection && collection->length > 0 && collection->length < 2000, "tree has a part of document");
+    myhtml_collection_destroy(collection);
+    
+    mcallocator_limit_set(other, 0);
+    
+    status = myhtml_parse(limited, MyENCODING_UTF_8, html, length);
+    test_check(status == MyCORE_STATUS_OK, "parse again without limit");
+    
+    myhtml_tree_destroy(limited);
+    test_check(mcallocator_bytes(other) == 0, "destroyed tree gives back all memory");
+    
+    myhtml_tree_destroy(tree);
+    test_check(mcallocator_bytes(allocator) == 0, "destroyed tree with index gives back all memory");
+    test_check(counter.malloc == counter.free, "all blocks are freed by allocator");
+    
+    myhtml_destroy(myhtml);
+    mcallocator_destroy(other, true);
+    mcallocator_destroy(allocator, true);
+    
+    free(html);
+}
+
+static void test_mycss_and_modest(void)
+{
+    test_counter_t counter = {0};
+    mcallocator_t *allocator = mcallocator_create();
+    
+    mystatus_t status = mcallocator_init(allocator, test_malloc, test_realloc, test_free, &counter);
+    CHECK_STATUS("Can't init allocator\n");
+    
+    mycss_t *mycss = mycss_create();
+    status = mycss_init(mycss);
+    CHECK_STATUS("Can't init MyCSS object\n");
+    
+    mycss_allocator_set(mycss, allocator);
+    test_check(mycss_allocator(mycss) == allocator, "allocator of mycss");
+    
+    mycss_entry_t *entry = mycss_entry_create();
+    status = mycss_entry_init(mycss, entry);
+    CHECK_STATUS("Can't init MyCSS Entry object\n");
+    
+    const char *css = "@namespace svg url(x); div > p.a, #b:not(.c) {width: 10px; color: red} a[href^='x'] {}";
+    status = mycss_parse(entry, MyENCODING_UTF_8, css, strlen(css));
+    
+    test_check(status == MyCORE_STATUS_OK && mcallocator_bytes(allocator), "entry takes memory from allocator");
+    
+    mycss_entry_destroy(entry, true);
+    test_check(mcallocator_bytes(allocator) == 0, "destroyed entry gives back all memory");
+    
+    modest_t *modest = modest_create();
+    modest_allocator_set(modest, allocator);
+    
+    status = modest_init(modest);
+    CHECK_STATUS("Can't init Modest object\n");
+    
+    test_check(modest_allocator(modest) == allocator && mcallocator_bytes(allocator), "modest takes memory from allocator");
+    
+    modest_destroy(modest, true);
+    test_check(mcallocator_bytes(allocator) == 0, "destroyed modest gives back all memory");
+    test_check(counter.malloc == counter.free, "all blocks are freed by allocator");
+    
+    mycss_destroy(mycss, true);
+    mcallocator_destroy(allocator, true);
+}
+
+int main(int argc, const char * argv[])
+{
+    /* before any object */
+    mycore_memory_set(test_global_malloc, test_global_realloc, test_global_calloc, test_global_free);
+    
+    test_allocator();
+    test_myhtml();
+    test_mycss_and_modest();
+    
+    test_check(test_global_calls > 0, "global memory functions");
+    
+    mycore_memory_set(NULL, NULL, NULL, NULL);
+    
+    size_t calls = test_global_calls;
+    mycore_free(mycore_malloc(8));
+    
+    test_check(calls == test_global_calls, "global memory functions are reset");
+    
+    return test_total();
+}
@@ -0,0 +1,319 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Work-stealing deque (mycore/utils/mcdeque.h): order for owner and
+ * thieves, full and empty bounds, resize, and races where every pushed
+ * value must come out exactly once, either by pop or by steal.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mycore/mythread.h>
+#include <mycore/utils/mcdeque.h>
+
+#include "../../test.h"
+
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+
+#define TEST_THIEVES 3
+#define TEST_LAST_ROUNDS 100000
+#define TEST_RACE_VALUES 200000
+#define TEST_RACE_DEQUE_SIZE 64
+
+struct test_thief {
+    mcdeque_t* deque;
+    
+    volatile size_t* stop;
+    volatile size_t* started;
+    unsigned char* seen;
+}
+typedef test_thief_t;
+
+static void * test_thief_process(void* arg)
+{
+    test_thief_t* thief = (test_thief_t*)arg;
+    size_t value;
+    
+    mcsync_atomic_fetch_add(thief->started, 1);
+    
+    for(;;) {
+        /* read stop before the last steal, so nothing left behind is missed */
+        size_t stop = mcsync_atomic_load(thief->stop);
+        
+        while(mcdeque_steal(thief->deque, &value)) {
+            thief->seen[value]++;
+        }
+        
+        if(stop)
+            break;
+    }
+    
+    return NULL;
+}
+
+static void test_order(void)
+{
+    mcdeque_t* deque = mcdeque_create();
+    size_t value = 0;
+    
+    test_check(deque && mcdeque_init(deque, 4) == MyCORE_STATUS_OK, "order: init");
+    
+    test_check(mcdeque_pop(deque, &value) == false, "order: pop on empty");
+    test_check(mcdeque_steal(deque, &value) == false, "order: steal on empty");
+    
+    bool is_ok = true;
+    
+    for(size_t i = 0; i < 4; i++)
+        is_ok = is_ok && mcdeque_push(deque, i);
+    
+    test_check(is_ok, "order: push up to size");
+    test_check(mcdeque_push(deque, 4) == false, "order: push on full");
+    
+    /* owner takes newest, thief takes oldest */
+    test_check(mcdeque_pop(deque, &value) && value == 3, "order: pop is LIFO");
+    test_check(mcdeque_steal(deque, &value) && value == 0, "order: steal is FIFO");
+    test_check(mcdeque_steal(deque, &value) && value == 1, "order: second steal");
+    
+    /* the last one goes by the top compare exchange in pop */
+    test_check(mcdeque_pop(deque, &value) && value == 2, "order: pop of last element");
+    test_check(mcdeque_pop(deque, &value) == false, "order: pop after last");
+    test_check(mcdeque_steal(deque, &value) == false, "order: steal after last");
+    
+    /* ring wraps after top and bottom moved */
+    is_ok = true;
+    
+    for(size_t round = 0; round < 10; round++) {
+        for(size_t i = 0; i < 3; i++)
+            is_ok = is_ok && mcdeque_push(deque, (round * 10 + i));
+        
+        is_ok = is_ok && mcdeque_steal(deque, &value) && value == (round * 10);
+        is_ok = is_ok && mcdeque_pop(deque, &value) && value == (round * 10 + 2);
+        is_ok = is_ok && mcdeque_pop(deque, &value) && value == (round * 10 + 1);
+        is_ok = is_ok && mcdeque_pop(deque, &value) == false;
+    }
+    
+    test_check(is_ok, "order: wrap of ring");
+    
+    mcdeque_destroy(deque, true);
+}
+
+static void test_resize(void)
+{
+    mcdeque_t* deque = mcdeque_create();
+    size_t value = 0;
+    
+    test_check(deque && mcdeque_init(deque, 0) == MyCORE_STATUS_OK && deque->size == 1, "resize: zero size is one");
+    
+    test_check(mcdeque_push(deque, 7), "resize: push to one");
+    test_check(mcdeque_push(deque, 8) == false, "resize: one is full");
+    test_check(mcdeque_pop(deque, &value) && value == 7, "resize: pop from one");
+    
+    test_check(mcdeque_resize(deque, 16) == MyCORE_STATUS_OK && deque->size == 16, "resize: grow");
+    test_check(deque->top == 0 && deque->bottom == 0, "resize: grow resets indexes");
+    
+    /* smaller size keeps list */
+    test_check(mcdeque_resize(deque, 8) == MyCORE_STATUS_OK && deque->size == 16, "resize: shrink is no-op");
+    
+    bool is_ok = true;
+    
+    for(size_t i = 0; i < 16; i++)
+        is_ok = is_ok && mcdeque_push(deque, i);
+    
+    test_check(is_ok && mcdeque_push(deque, 16) == false, "resize: new size is used");
+    
+    is_ok = true;
+    
+    for(size_t i = 0; i < 16; i++)
+        is_ok = is_ok && mcdeque_steal(deque, &value) && value == i;
+    
+    test_check(is_ok, "resize: steal all in order");
+    
+    mcdeque_clean(deque);
+    test_check(mcdeque_pop(deque, &value) == false, "resize: empty after clean");
+    
+    mcdeque_destroy(deque, true);
+}
+
+static bool test_thieves_run(mythread_t* mythread, mcdeque_t* deque, test_thief_t* thieves, void** threads,
+                             volatile size_t* stop, size_t values_count)
+{
+    static volatile size_t started;
+    
+    mcsync_atomic_store(&started, 0);
+    
+    for(size_t i = 0; i < TEST_THIEVES; i++) {
+        thieves[i].deque = deque;
+        thieves[i].stop  = stop;
+        thieves[i].started = &started;
+        thieves[i].seen  = mycore_calloc(values_count, sizeof(unsigned char));
+        
+        if(thieves[i].seen == NULL)
+            return false;
+        
+        threads[i] = mythread_thread_create(mythread, test_thief_process, &thieves[i]);
+        
+        if(threads[i] == NULL)
+            return false;
+    }
+    
+    /* owner starts only when all thieves spin */
+    while(mcsync_atomic_load(&started) != TEST_THIEVES) {}
+    
+    return true;
+}
+
+static bool test_thieves_join(mythread_t* mythread, test_thief_t* thieves, void** threads,
+                              volatile size_t* stop, unsigned char* seen, size_t values_count)
+{
+    mcsync_atomic_store(stop, 1);
+    
+    for(size_t i = 0; i < TEST_THIEVES; i++) {
+        if(threads[i]) {
+            mythread_thread_join(mythread, threads[i]);
+            mythread_thread_destroy(mythread, threads[i]);
+        }
+    }
+    
+    bool is_ok = true;
+    
+    for(size_t v = 0; v < values_count; v++) {
+        size_t sum = seen[v];
+        
+        for(size_t i = 0; i < TEST_THIEVES; i++)
+            sum += thieves[i].seen[v];
+        
+        if(sum != 1)
+            is_ok = false;
+    }
+    
+    for(size_t i = 0; i < TEST_THIEVES; i++)
+        mycore_free(thieves[i].seen);
+    
+    return is_ok;
+}
+
+/* one element at a time: pop and steal meet on the last element every round */
+static void test_race_last(mythread_t* mythread)
+{
+    mcdeque_t* deque = mcdeque_create();
+    unsigned char* seen = mycore_calloc(TEST_LAST_ROUNDS, sizeof(unsigned char));
+    
+    test_thief_t thieves[TEST_THIEVES];
+    void* threads[TEST_THIEVES] = {0};
+    volatile size_t stop = 0;
+    
+    test_check(deque && seen && mcdeque_init(deque, 4) == MyCORE_STATUS_OK, "race last: init");
+    test_check(test_thieves_run(mythread, deque, thieves, threads, &stop, TEST_LAST_ROUNDS), "race last: threads");
+    
+    size_t value;
+    bool is_ok = true;
+    
+    for(size_t i = 0; i < TEST_LAST_ROUNDS; i++) {
+        is_ok = is_ok && mcdeque_push(deque, i);
+        
+        if(mcdeque_pop(deque, &value)) {
+            seen[value]++;
+        }
+    }
+    
+    test_check(is_ok, "race last: push to empty");
+    test_check(test_thieves_join(mythread, thieves, threads, &stop, seen, TEST_LAST_ROUNDS),
+               "race last: every value exactly once");
+    
+    mycore_free(seen);
+    mcdeque_destroy(deque, true);
+}
+
+/* owner pushes batches and pops part of them, thieves take the rest */
+static void test_race_batch(mythread_t* mythread)
+{
+    mcdeque_t* deque = mcdeque_create();
+    unsigned char* seen = mycore_calloc(TEST_RACE_VALUES, sizeof(unsigned char));
+    
+    test_thief_t thieves[TEST_THIEVES];
+    void* threads[TEST_THIEVES] = {0};
+    volatile size_t stop = 0;
+    
+    test_check(deque && seen && mcdeque_init(deque, TEST_RACE_DEQUE_SIZE) == MyCORE_STATUS_OK, "race batch: init");
+    test_check(test_thieves_run(mythread, deque, thieves, threads, &stop, TEST_RACE_VALUES), "race batch: threads");
+    
+    size_t value, next = 0, round = 0;
+    
+    while(next < TEST_RACE_VALUES) {
+        /* push until full or batch is done, full deque must not lose values */
+        size_t batch = (round % 7) * 11 + 1;
+        
+        while(batch-- && next < TEST_RACE_VALUES) {
+            if(mcdeque_push(deque, next) == false)
+                break;
+            
+            next++;
+        }
+        
+        for(size_t i = 0; i < (round % 5); i++) {
+            if(mcdeque_pop(deque, &value))
+                seen[value]++;
+        }
+        
+        round++;
+    }
+    
+    while(mcdeque_pop(deque, &value))
+        seen[value]++;
+    
+    test_check(test_thieves_join(mythread, thieves, threads, &stop, seen, TEST_RACE_VALUES),
+               "race batch: every value exactly once");
+    
+    test_check(deque->top == deque->bottom, "race batch: empty at end");
+    
+    mycore_free(seen);
+    mcdeque_destroy(deque, true);
+}
+
+int main(int argc, const char * argv[])
+{
+    mythread_t* mythread = mythread_create();
+    
+    if(mythread == NULL || mythread_init(mythread, MyTHREAD_TYPE_STREAM, 1, 0)) {
+        fprintf(stderr, "Failed to init mythread\n");
+        return EXIT_FAILURE;
+    }
+    
+    test_order();
+    test_resize();
+    test_race_last(mythread);
+    test_race_batch(mythread);
+    
+    mythread_destroy(mythread, NULL, NULL, true);
+    
+    return test_total();
+}
+
+#else
+
+int main(int argc, const char * argv[])
+{
+    return test_total();
+}
+
+#endif /* MyCORE_BUILD_WITHOUT_THREADS */
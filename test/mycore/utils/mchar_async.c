@@ -0,0 +1,158 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Chunks of deleted nodes are given to new nodes: a chunk from cache must be empty
+ * and linked only to its new node, and a size bigger than all cached chunks gets a new chunk.
+ */
+
+#include <string.h>
+
+#include <mycore/utils/mchar_async.h>
+
+#include "../../test.h"
+
+/* minimal size of chunk */
+#define TEST_ORIGIN_SIZE 4096
+
+/* chunks of node from first by next, prev of each must be the one before */
+static bool test_node_chunks(mchar_async_t *mchar, size_t node_idx, size_t count)
+{
+    mchar_async_chunk_t *chunk = mchar->nodes[node_idx].chunk;
+
+    while(chunk->prev)
+        chunk = chunk->prev;
+
+    mchar_async_chunk_t *prev = NULL;
+    size_t length = 0;
+
+    while(chunk) {
+        if(chunk->prev != prev || chunk->length > chunk->size)
+            return false;
+
+        prev = chunk;
+        chunk = chunk->next;
+        length++;
+    }
+
+    return (length == count);
+}
+
+static bool test_fill(mchar_async_t *mchar, size_t node_idx, size_t size, char ch, char **data)
+{
+    *data = mchar_async_malloc(mchar, node_idx, size);
+
+    if(*data == NULL)
+        return false;
+
+    memset(*data, ch, size);
+
+    return true;
+}
+
+static bool test_is_filled(const char *data, size_t size, char ch)
+{
+    for(size_t i = 0; i < size; i++) {
+        if(data[i] != ch)
+            return false;
+    }
+
+    return true;
+}
+
+static mchar_async_t * test_mchar_create(void)
+{
+    mchar_async_t *mchar = mchar_async_create();
+    mystatus_t status = mchar_async_init(mchar, 4, TEST_ORIGIN_SIZE);
+
+    CHECK_STATUS("Can't init mchar_async\n");
+
+    return mchar;
+}
+
+static size_t test_node_add(mchar_async_t *mchar)
+{
+    mystatus_t status;
+    size_t node_idx = mchar_async_node_add(mchar, &status);
+
+    CHECK_STATUS("Can't add mchar_async node\n");
+
+    return node_idx;
+}
+
+static void test_cached_chunk(void)
+{
+    mchar_async_t *mchar = test_mchar_create();
+
+    /* node with chunk of origin size and two bigger ones, all go to cache on delete */
+    size_t first_idx = test_node_add(mchar);
+    char *data;
+
+    if(test_fill(mchar, first_idx, 16, 'a', &data) == false ||
+       test_fill(mchar, first_idx, (TEST_ORIGIN_SIZE + 1000), 'b', &data) == false ||
+       test_fill(mchar, first_idx, (TEST_ORIGIN_SIZE + 1000), 'b', &data) == false)
+        DIE("Can't allocate chars of first node\n");
+
+    mchar_async_node_delete(mchar, first_idx);
+
+    size_t node_idx = test_node_add(mchar);
+    char *small, *big, *bigger;
+
+    /* bigger chunk from cache */
+    test_check(test_fill(mchar, node_idx, 16, 'c', &small) && test_fill(mchar, node_idx, TEST_ORIGIN_SIZE, 'd', &big) &&
+               mchar->nodes[node_idx].chunk->length == (TEST_ORIGIN_SIZE + sizeof(size_t)),
+               "cached chunk is empty");
+
+    test_check(test_fill(mchar, node_idx, (TEST_ORIGIN_SIZE * 4), 'e', &bigger) && test_node_chunks(mchar, node_idx, 3) &&
+               test_is_filled(small, 16, 'c') && test_is_filled(big, TEST_ORIGIN_SIZE, 'd') &&
+               test_is_filled(bigger, (TEST_ORIGIN_SIZE * 4), 'e'),
+               "chunks of node are linked and keep data");
+
+    mchar_async_destroy(mchar, true);
+}
+
+static void test_bigger_than_cached(void)
+{
+    mchar_async_t *mchar = test_mchar_create();
+
+    /* two chunks of origin size in cache, new node takes one of them */
+    size_t first_idx  = test_node_add(mchar);
+    size_t second_idx = test_node_add(mchar);
+
+    mchar_async_node_delete(mchar, first_idx);
+    mchar_async_node_delete(mchar, second_idx);
+
+    size_t node_idx = test_node_add(mchar);
+    char *data;
+
+    test_check(test_fill(mchar, node_idx, (TEST_ORIGIN_SIZE + 1000), 'f', &data) &&
+               test_is_filled(data, (TEST_ORIGIN_SIZE + 1000), 'f') && test_node_chunks(mchar, node_idx, 2),
+               "size bigger than all cached chunks");
+
+    mchar_async_destroy(mchar, true);
+}
+
+int main(int argc, const char * argv[])
+{
+    test_cached_chunk();
+    test_bigger_than_cached();
+
+    return test_total();
+}
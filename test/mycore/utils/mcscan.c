@@ -0,0 +1,134 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Block scanners (mycore/utils/mcscan.h) must give the same offsets
+ * as simple byte by byte loops, for any offset, size and alignment.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mycore/utils/mcscan.h>
+
+#define TEST_BUFFER_SIZE 512
+#define TEST_ROUNDS 64
+
+static const unsigned char test_alphabet[] = {
+    'a', 'b', 'z', '<', '>', '-', '"', '\'', '&', '\0', ' ', '\t', '\n', '\f', '\r', '\v',
+    0x7F, 0x80, 0xA0, 0xDF, 0xFF, 0x01, 0x08, 0x1F
+};
+
+static size_t test_ref_char(const char* data, size_t offset, size_t size, unsigned char c)
+{
+    while(offset < size && (unsigned char)data[offset] != c)
+        offset++;
+    
+    return offset;
+}
+
+static size_t test_ref_char2(const char* data, size_t offset, size_t size, unsigned char c1, unsigned char c2)
+{
+    while(offset < size && (unsigned char)data[offset] != c1 && (unsigned char)data[offset] != c2)
+        offset++;
+    
+    return offset;
+}
+
+static size_t test_ref_not_whitespace(const char* data, size_t offset, size_t size)
+{
+    while(offset < size && (data[offset] == ' ' || data[offset] == '\t' || data[offset] == '\n' ||
+                            data[offset] == '\f' || data[offset] == '\r'))
+    {
+        offset++;
+    }
+    
+    return offset;
+}
+
+static size_t test_ref_not_ascii(const char* data, size_t offset, size_t size)
+{
+    while(offset < size && (unsigned char)data[offset] < 0x80)
+        offset++;
+    
+    return offset;
+}
+
+/* long runs of text or of whitespace with rare stop bytes, like real documents */
+static void test_fill(char* data, size_t size, unsigned int round)
+{
+    size_t alphabet_size = sizeof(test_alphabet);
+    
+    for(size_t i = 0; i < size; i++) {
+        if(round % 3 == 0)
+            data[i] = (char)test_alphabet[ (rand() % alphabet_size) ];
+        else if(round % 3 == 1)
+            data[i] = (rand() % 64 ? 'x' : (char)test_alphabet[ (rand() % alphabet_size) ]);
+        else
+            data[i] = (rand() % 64 ? " \t\n\r\f"[ (rand() % 5) ] : (char)test_alphabet[ (rand() % alphabet_size) ]);
+    }
+}
+
+int main(int argc, const char * argv[])
+{
+    char *buffer = malloc(TEST_BUFFER_SIZE);
+    if(buffer == NULL) {
+        fprintf(stderr, "Can't allocate mem for buffer\n");
+        return EXIT_FAILURE;
+    }
+    
+    size_t count = 0, good = 0;
+    srand(42);
+    
+    for(unsigned int round = 0; round < TEST_ROUNDS; round++)
+    {
+        test_fill(buffer, TEST_BUFFER_SIZE, round);
+        
+        for(size_t offset = 0; offset < 80; offset++)
+        {
+            for(size_t size = offset; size < TEST_BUFFER_SIZE; size += (1 + (rand() % 23)))
+            {
+                unsigned char c1 = test_alphabet[ (rand() % sizeof(test_alphabet)) ];
+                unsigned char c2 = test_alphabet[ (rand() % sizeof(test_alphabet)) ];
+                
+                count += 4;
+                
+                if(mcscan_char(buffer, offset, size, c1) == test_ref_char(buffer, offset, size, c1))
+                    good++;
+                
+                if(mcscan_char2(buffer, offset, size, c1, c2) == test_ref_char2(buffer, offset, size, c1, c2))
+                    good++;
+                
+                if(mcscan_not_whitespace(buffer, offset, size) == test_ref_not_whitespace(buffer, offset, size))
+                    good++;
+                
+                if(mcscan_not_ascii(buffer, offset, size) == test_ref_not_ascii(buffer, offset, size))
+                    good++;
+            }
+        }
+    }
+    
+    free(buffer);
+    
+    printf("Total: " MyCORE_FORMAT_Z "; Good: " MyCORE_FORMAT_Z "; Bad: " MyCORE_FORMAT_Z "\n", count, good, (count - good));
+    
+    return (good == count ? EXIT_SUCCESS : EXIT_FAILURE);
+}
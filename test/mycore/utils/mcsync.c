@@ -0,0 +1,115 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Spinlock (mcsync_spin_lock) must let one thread at a time in: threads add to
+ * a counter by read and write under the lock, and no addition may be lost.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mycore/mythread.h>
+#include <mycore/utils/mcsync.h>
+
+#include "../../test.h"
+
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+
+#define TEST_THREADS 4
+#define TEST_ROUNDS 200000
+
+struct test_counter {
+    void* spinlock;
+    volatile size_t value;
+}
+typedef test_counter_t;
+
+static void * test_add(void* arg)
+{
+    test_counter_t* counter = (test_counter_t*)arg;
+
+    for(size_t i = 0; i < TEST_ROUNDS; i++) {
+        mcsync_spin_lock(counter->spinlock);
+
+        /* read and write apart, so the thread can be switched between them */
+        size_t value = counter->value;
+
+        for(volatile size_t j = 0; j < 16; j++) {}
+
+        counter->value = value + 1;
+
+        mcsync_spin_unlock(counter->spinlock);
+    }
+
+    return NULL;
+}
+
+static void test_spinlock(mythread_t* mythread)
+{
+    test_counter_t counter = {0};
+    void* threads[TEST_THREADS] = {0};
+
+    counter.spinlock = mcsync_spin_create();
+
+    if(counter.spinlock == NULL || mcsync_spin_init(counter.spinlock))
+        DIE("Can't init spinlock\n");
+
+    for(size_t i = 0; i < TEST_THREADS; i++) {
+        threads[i] = mythread_thread_create(mythread, test_add, &counter);
+
+        if(threads[i] == NULL)
+            DIE("Can't create thread\n");
+    }
+
+    for(size_t i = 0; i < TEST_THREADS; i++) {
+        mythread_thread_join(mythread, threads[i]);
+        mythread_thread_destroy(mythread, threads[i]);
+    }
+
+    test_check(counter.value == (TEST_THREADS * TEST_ROUNDS), "no addition lost under spinlock");
+
+    mcsync_spin_destroy(counter.spinlock);
+}
+
+int main(int argc, const char * argv[])
+{
+    mythread_t* mythread = mythread_create();
+
+    if(mythread == NULL || mythread_init(mythread, MyTHREAD_TYPE_STREAM, 1, 0)) {
+        fprintf(stderr, "Failed to init mythread\n");
+        return EXIT_FAILURE;
+    }
+
+    test_spinlock(mythread);
+
+    mythread_destroy(mythread, NULL, NULL, true);
+
+    return test_total();
+}
+
+#else
+
+int main(int argc, const char * argv[])
+{
+    return test_total();
+}
+
+#endif /* MyCORE_BUILD_WITHOUT_THREADS */
@@ -0,0 +1,188 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * mythread_cond_* (event count) wait/notify handoff between two threads:
+ * a value is passed back and forth by ping-pong, every wake must see
+ * the value written before notify, and no wake may be lost.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mycore/mythread.h>
+
+#ifndef MyCORE_BUILD_WITHOUT_THREADS
+
+#include <mycore/utils/mcsync.h>
+
+#define TEST_ROUNDS 20000
+
+struct test_handoff {
+    mythread_t* mythread;
+    void* cond;
+    
+    /* odd: ping thread owns the turn, even: pong thread */
+    volatile size_t turn;
+    size_t errors;
+}
+typedef test_handoff_t;
+
+static size_t test_turn_load(test_handoff_t* handoff)
+{
+    return mcsync_atomic_load(&handoff->turn);
+}
+
+static void * test_pong(void* arg)
+{
+    test_handoff_t* handoff = (test_handoff_t*)arg;
+    
+    for(size_t i = 1; i <= TEST_ROUNDS; i++) {
+        size_t expect = i * 2 - 1;
+        
+        mythread_cond_wait_while(handoff->mythread, handoff->cond, test_turn_load(handoff) < expect);
+        
+        if(test_turn_load(handoff) != expect)
+            handoff->errors++;
+        
+        mcsync_atomic_store(&handoff->turn, expect + 1);
+        mythread_cond_notify(handoff->mythread, handoff->cond);
+    }
+    
+    return NULL;
+}
+
+static size_t test_ping_pong(mythread_t* mythread)
+{
+    test_handoff_t handoff = {0};
+    
+    handoff.mythread = mythread;
+    handoff.cond = mythread_cond_create(mythread);
+    
+    if(handoff.cond == NULL) {
+        fprintf(stderr, "Failed to create cond\n");
+        return 1;
+    }
+    
+    void* thread = mythread_thread_create(mythread, test_pong, &handoff);
+    
+    if(thread == NULL) {
+        fprintf(stderr, "Failed to create thread\n");
+        mythread_cond_close(mythread, handoff.cond);
+        return 1;
+    }
+    
+    size_t errors = 0;
+    
+    for(size_t i = 1; i <= TEST_ROUNDS; i++) {
+        size_t expect = i * 2 - 2;
+        
+        mythread_cond_wait_while(mythread, handoff.cond, test_turn_load(&handoff) < expect);
+        
+        if(test_turn_load(&handoff) != expect)
+            errors++;
+        
+        mcsync_atomic_store(&handoff.turn, expect + 1);
+        mythread_cond_notify(mythread, handoff.cond);
+    }
+    
+    mythread_cond_wait_while(mythread, handoff.cond, test_turn_load(&handoff) < TEST_ROUNDS * 2);
+    
+    mythread_thread_join(mythread, thread);
+    mythread_thread_destroy(mythread, thread);
+    mythread_cond_close(mythread, handoff.cond);
+    
+    errors += handoff.errors;
+    
+    if(errors)
+        fprintf(stderr, "Ping-pong: " MyCORE_FORMAT_Z " out of order wakes\n", errors);
+    
+    return errors ? 1 : 0;
+}
+
+/* notify without waiters must not block or change what a later waiter sees */
+static size_t test_notify_idle(mythread_t* mythread)
+{
+    void* cond = mythread_cond_create(mythread);
+    
+    if(cond == NULL)
+        return 1;
+    
+    size_t errors = 0;
+    
+    for(size_t i = 0; i < 16; i++) {
+        if(mythread_cond_notify(mythread, cond))
+            errors++;
+    }
+    
+    /* prepare then cancel leaves no waiter behind */
+    size_t ticket = mythread_cond_prepare(mythread, cond);
+    mythread_cond_cancel(mythread, cond);
+    
+    if(mythread_cond_notify(mythread, cond))
+        errors++;
+    
+    /* a notify between prepare and wait must release the wait at once */
+    ticket = mythread_cond_prepare(mythread, cond);
+    
+    if(mythread_cond_notify(mythread, cond))
+        errors++;
+    
+    if(mythread_cond_wait(mythread, cond, ticket))
+        errors++;
+    
+    mythread_cond_close(mythread, cond);
+    
+    if(errors)
+        fprintf(stderr, "Notify idle: " MyCORE_FORMAT_Z " errors\n", errors);
+    
+    return errors ? 1 : 0;
+}
+
+int main(int argc, const char * argv[])
+{
+    mythread_t* mythread = mythread_create();
+    
+    if(mythread == NULL || mythread_init(mythread, MyTHREAD_TYPE_STREAM, 1, 0)) {
+        fprintf(stderr, "Failed to init mythread\n");
+        return EXIT_FAILURE;
+    }
+    
+    size_t total = 0, bad = 0;
+    
+    total++; bad += test_notify_idle(mythread);
+    total++; bad += test_ping_pong(mythread);
+    
+    mythread_destroy(mythread, NULL, NULL, true);
+    
+    printf("Total: " MyCORE_FORMAT_Z "; Good: " MyCORE_FORMAT_Z "; Bad: " MyCORE_FORMAT_Z "\n", total, (total - bad), bad);
+    
+    return bad ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#else
+
+int main(int argc, const char * argv[])
+{
+    printf("Total: 0; Good: 0; Bad: 0\n");
+    return EXIT_SUCCESS;
+}
+
+#endif /* MyCORE_BUILD_WITHOUT_THREADS */
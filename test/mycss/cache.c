@@ -0,0 +1,246 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Binary cache of stylesheet: serialization of loaded image must be equal to serialization of parsed stylesheet,
+ * bad and already loaded images are not accepted, selectors from image find the same nodes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <modest/finder/finder.h>
+#include <mycss/mycss.h>
+#include <mycss/cache.h>
+#include <mycss/selectors/serialization.h>
+
+#include "../test.h"
+
+#define TEST_CACHE_FILENAME "mycss_cache_test.bin"
+
+static const char test_css[] =
+    "@namespace svg url(http://www.w3.org/2000/svg);\n"
+    "div > p.a#b[title~=\"x y\" i] {color: #ff0000; width: 10px !important}\n"
+    "svg|rect, *|circle, ul li:not(.c):nth-child(2n+1 of .d) {margin: 1px 2% auto; padding: 3px}\n"
+    ":lang(en, fr) a::before, :dir(rtl) {font: italic bold 12px/1.5 \"Open Sans\", serif}\n"
+    "p:nth-last-of-type(-n+3) ~ span {background: url(\"a.png\") no-repeat 10px 50% / cover, #fff}\n"
+    "b {border: 1px solid red; border-radius: 2px 4px / 3px; text-decoration: underline overline dotted blue}\n"
+    "i {background-image: image(\"b.png\", red); border-color: red blue; font-family: Arial, sans-serif}\n"
+    "q:matches(.e, .f) {background-position: left 10px top; background-size: 10px auto}\n";
+
+static const char test_html[] =
+    "<div><p class=a id=b title='x y'>1</p><span>2</span></div>"
+    "<ul><li class=d>a<li class=d>b<li class=c>c<li class=d>d</ul>"
+    "<p>1</p><p>2</p><span>s</span><q class=f>q</q>";
+
+struct test_buffer {
+    char*  data;
+    size_t length;
+    size_t size;
+}
+typedef test_buffer_t;
+
+static mystatus_t test_buffer_callback(const char* data, size_t size, void* ctx)
+{
+    test_buffer_t *buffer = (test_buffer_t*)ctx;
+    
+    if((buffer->length + size + 1) > buffer->size) {
+        buffer->size = (buffer->length + size + 1) * 2;
+        buffer->data = realloc(buffer->data, buffer->size);
+        
+        if(buffer->data == NULL)
+            DIE("Can't allocate mem for buffer\n");
+    }
+    
+    memcpy(&buffer->data[buffer->length], data, size);
+    
+    buffer->length += size;
+    buffer->data[buffer->length] = '\0';
+    
+    return MyCORE_STATUS_OK;
+}
+
+static mycss_entry_t * test_parse_css(mycss_t* mycss)
+{
+    mycss_entry_t *entry = mycss_entry_create();
+    mystatus_t status = mycss_entry_init(mycss, entry);
+    
+    CHECK_STATUS("Can't init MyCSS Entry object\n");
+    
+    status = mycss_parse(entry, MyENCODING_UTF_8, test_css, strlen(test_css));
+    CHECK_STATUS("Can't parse CSS\n");
+    
+    return entry;
+}
+
+/* loaded stylesheet has no entry, selectors are printed by other one */
+static test_buffer_t test_serialization(mycss_entry_t* entry, mycss_stylesheet_t* stylesheet)
+{
+    test_buffer_t buffer = {NULL, 0, 0};
+    
+    test_buffer_callback("", 0, &buffer);
+    mycss_selectors_serialization_list(entry->selectors, stylesheet->sel_list_first, (mycore_callback_serialize_f)test_buffer_callback, &buffer);
+    
+    return buffer;
+}
+
+static size_t test_find(myhtml_tree_t* tree, mycss_stylesheet_t* stylesheet)
+{
+    modest_finder_t *finder = modest_finder_create_simple();
+    myhtml_collection_t *collection = NULL;
+    size_t count = 0;
+    
+    for(mycss_selectors_list_t *list = stylesheet->sel_list_first; list; list = list->next) {
+        modest_finder_by_selectors_list(finder, tree->node_html, list, &collection);
+        
+        if(collection) {
+            count = count * 31 + collection->length;
+            myhtml_collection_clean(collection);
+        }
+    }
+    
+    myhtml_collection_destroy(collection);
+    modest_finder_destroy(finder, true);
+    
+    return count;
+}
+
+static myhtml_tree_t * test_parse_html(myhtml_t* myhtml)
+{
+    myhtml_tree_t *tree = myhtml_tree_create();
+    mystatus_t status = myhtml_tree_init(tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    status = myhtml_parse(tree, MyENCODING_UTF_8, test_html, strlen(test_html));
+    CHECK_STATUS("Can't parse HTML\n");
+    
+    return tree;
+}
+
+int main(int argc, const char * argv[])
+{
+    myhtml_t *myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, MyHTML_OPTIONS_DEFAULT, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    mycss_t *mycss = mycss_create();
+    status = mycss_init(mycss);
+    
+    CHECK_STATUS("Can't init MyCSS object\n");
+    
+    myhtml_tree_t *tree = test_parse_html(myhtml);
+    
+    /* image of parsed stylesheet, parsed one is destroyed before load */
+    mycss_entry_t *entry = test_parse_css(mycss);
+    mycss_stylesheet_t *stylesheet = mycss_entry_stylesheet(entry);
+    
+    test_buffer_t expect = test_serialization(entry, stylesheet);
+    test_buffer_t image = {NULL, 0, 0};
+    size_t expect_found = test_find(tree, stylesheet);
+    
+    status = mycss_cache_serialization(stylesheet, (mycore_callback_serialize_f)test_buffer_callback, &image);
+    test_check(status == MyCSS_STATUS_OK && image.length > sizeof(mycss_cache_header_t), "serialization");
+    
+    status = mycss_cache_save(stylesheet, TEST_CACHE_FILENAME);
+    test_check(status == MyCSS_STATUS_OK, "save to file");
+    
+    mycss_entry_destroy(entry, true);
+    
+    /* other entry to print selectors */
+    entry = mycss_entry_create();
+    status = mycss_entry_init(mycss, entry);
+    
+    CHECK_STATUS("Can't init MyCSS Entry object\n");
+    
+    /* copy of image, buffer of malloc is aligned */
+    char *data = malloc(image.length);
+    if(data == NULL)
+        DIE("Can't allocate mem for image\n");
+    
+    memcpy(data, image.data, image.length);
+    
+    mycss_cache_t *cache = mycss_cache_create();
+    status = mycss_cache_init(cache);
+    
+    CHECK_STATUS("Can't init MyCSS Cache object\n");
+    
+    status = mycss_cache_load_data(cache, data, image.length);
+    test_check(status == MyCSS_STATUS_OK && mycss_cache_stylesheet(cache), "load from memory");
+    
+    if(status == MyCSS_STATUS_OK) {
+        test_buffer_t result = test_serialization(entry, mycss_cache_stylesheet(cache));
+        
+        test_check(strcmp(expect.data, result.data) == 0, "serialization of loaded stylesheet");
+        test_check(test_find(tree, mycss_cache_stylesheet(cache)) == expect_found, "find by loaded stylesheet");
+        
+        if(strcmp(expect.data, result.data))
+            printf("expect:\n%s\nresult:\n%s\n", expect.data, result.data);
+        
+        free(result.data);
+    }
+    
+    status = mycss_cache_load_data(cache, data, image.length);
+    test_check(status == MyCSS_STATUS_ERROR_CACHE_FORMAT, "loaded image is not loaded again");
+    
+    memcpy(data, image.data, image.length);
+    data[0] = 'X';
+    
+    status = mycss_cache_load_data(cache, data, image.length);
+    test_check(status == MyCSS_STATUS_ERROR_CACHE_FORMAT, "bad magic");
+    
+    memcpy(data, image.data, image.length);
+    
+    status = mycss_cache_load_data(cache, data, (image.length - 8));
+    test_check(status == MyCSS_STATUS_ERROR_CACHE_FORMAT, "truncated image");
+    
+    status = mycss_cache_load(cache, TEST_CACHE_FILENAME);
+    test_check(status == MyCSS_STATUS_OK, "load from file");
+    
+    if(status == MyCSS_STATUS_OK) {
+        test_buffer_t result = test_serialization(entry, mycss_cache_stylesheet(cache));
+        
+        test_check(strcmp(expect.data, result.data) == 0, "serialization of mapped stylesheet");
+        test_check(test_find(tree, mycss_cache_stylesheet(cache)) == expect_found, "find by mapped stylesheet");
+        
+        free(result.data);
+    }
+    
+    /* private mapping, file is not changed by load */
+    status = mycss_cache_load(cache, TEST_CACHE_FILENAME);
+    test_check(status == MyCSS_STATUS_OK, "load same file again");
+    
+    mycss_cache_destroy(cache, true);
+    remove(TEST_CACHE_FILENAME);
+    
+    free(data);
+    free(image.data);
+    free(expect.data);
+    
+    mycss_entry_destroy(entry, true);
+    mycss_destroy(mycss, true);
+    
+    myhtml_tree_destroy(tree);
+    myhtml_destroy(myhtml);
+    
+    return test_total();
+}
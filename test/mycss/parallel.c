@@ -0,0 +1,280 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Parse of stylesheet by slices in threads must give the same selector lists as sequential parse:
+ * serialization and nodes found by every list are compared for different counts of threads.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <modest/finder/finder.h>
+#include <mycss/mycss.h>
+#include <mycss/parallel.h>
+
+#include "../test.h"
+
+static const char *test_rules[] = {
+    "div > p.a {color: red; width: 10px}\n",
+    "svg|rect, *|circle {margin: 1px 2px}\n",
+    "a[title=\"}{\"] /* } */ {padding: 1px}\n",
+    "li:nth-child(2n+1 of .d), li:not(.c) {border: 1px solid blue}\n",
+    "@media screen { p {color: blue} }\n",
+    "span { background: url(a}b.png) no-repeat }\n",
+    "q::before {font: 12px/1.5 \"A } B\", serif}\n",
+    "@namespace html url(http://www.w3.org/1999/xhtml);\n",
+    "html|p, svg|circle {width: 3px}\n",
+    "p { color: red; ; } <!-- -->\n"
+};
+
+static const char test_html[] =
+    "<div><p class=a>1</p></div><ul><li class=d>a<li class=c>b<li class=d>c</ul>"
+    "<svg><rect/><circle/></svg><span>s</span><q>q</q><a title='}{'>a</a>";
+
+struct test_buffer {
+    char*  data;
+    size_t length;
+    size_t size;
+}
+typedef test_buffer_t;
+
+static mystatus_t test_buffer_callback(const char* data, size_t size, void* ctx)
+{
+    test_buffer_t *buffer = (test_buffer_t*)ctx;
+    
+    if((buffer->length + size + 1) > buffer->size) {
+        buffer->size = (buffer->length + size + 1) * 2;
+        buffer->data = realloc(buffer->data, buffer->size);
+        
+        if(buffer->data == NULL)
+            DIE("Can't allocate mem for buffer\n");
+    }
+    
+    memcpy(&buffer->data[buffer->length], data, size);
+    
+    buffer->length += size;
+    buffer->data[buffer->length] = '\0';
+    
+    return MyCORE_STATUS_OK;
+}
+
+static test_buffer_t test_generate_css(size_t count, bool is_broken)
+{
+    test_buffer_t buffer = {NULL, 0, 0};
+    
+    const char *ns = "@namespace svg url(http://www.w3.org/2000/svg);\n";
+    const char *broken = "b) {color: red}\n";
+    
+    test_buffer_callback(ns, strlen(ns), &buffer);
+    
+    for(size_t i = 0; i < count; i++) {
+        const char *rule = test_rules[ (i % (sizeof(test_rules) / sizeof(test_rules[0]))) ];
+        test_buffer_callback(rule, strlen(rule), &buffer);
+        
+        /* rest of stylesheet after unbalanced bracket is one rule for sequential parse */
+        if(is_broken && i == (count / 2))
+            test_buffer_callback(broken, strlen(broken), &buffer);
+    }
+    
+    return buffer;
+}
+
+static test_buffer_t test_serialization(mycss_stylesheet_t* stylesheet)
+{
+    test_buffer_t buffer = {NULL, 0, 0};
+    
+    test_buffer_callback("", 0, &buffer);
+    mycss_stylesheet_serialization(stylesheet, (mycore_callback_serialize_f)test_buffer_callback, &buffer);
+    
+    return buffer;
+}
+
+static size_t test_find(myhtml_tree_t* tree, mycss_stylesheet_t* stylesheet)
+{
+    modest_finder_t *finder = modest_finder_create_simple();
+    myhtml_collection_t *collection = NULL;
+    size_t count = 0;
+    
+    for(mycss_selectors_list_t *list = stylesheet->sel_list_first; list; list = list->next) {
+        modest_finder_by_selectors_list(finder, tree->node_html, list, &collection);
+        
+        if(collection) {
+            count = count * 31 + collection->length;
+            myhtml_collection_clean(collection);
+        }
+    }
+    
+    myhtml_collection_destroy(collection);
+    modest_finder_destroy(finder, true);
+    
+    return count;
+}
+
+/* namespaces of the second parse by the same entry or slices must not be appended to the first stylesheet */
+static void test_namespace_twice(mycss_t* mycss)
+{
+    const char *css = "@namespace svg url(http://www.w3.org/2000/svg);\n@namespace html url(http://www.w3.org/1999/xhtml);\n"
+                      "svg|rect, html|p {width: 1px}\n@namespace m url(http://www.w3.org/1998/Math/MathML);\nm|mi {width: 2px}\n";
+    
+    mycss_entry_t *entry = mycss_entry_create();
+    mystatus_t status = mycss_entry_init(mycss, entry);
+    
+    CHECK_STATUS("Can't init MyCSS Entry object\n");
+    
+    status = mycss_parse(entry, MyENCODING_UTF_8, css, strlen(css));
+    CHECK_STATUS("Can't parse CSS\n");
+    
+    mycss_stylesheet_t *first = mycss_entry_stylesheet(entry);
+    test_buffer_t expect = test_serialization(first);
+    
+    status = mycss_parse(entry, MyENCODING_UTF_8, css, strlen(css));
+    CHECK_STATUS("Can't parse CSS\n");
+    
+    test_buffer_t first_again = test_serialization(first);
+    test_buffer_t second = test_serialization(mycss_entry_stylesheet(entry));
+    
+    test_check(strcmp(expect.data, first_again.data) == 0 && strcmp(expect.data, second.data) == 0,
+               "namespaces, second parse by entry");
+    
+    for(size_t threads = 1; threads <= 2; threads++)
+    {
+        mycss_parallel_t *parallel = mycss_parallel_create();
+        status = mycss_parallel_init(parallel, mycss, threads);
+        
+        CHECK_STATUS("Can't init MyCSS Parallel object\n");
+        
+        parallel->slice_min_size = 1;
+        
+        bool is_good = true;
+        
+        for(size_t i = 0; i < 2; i++) {
+            status = mycss_parallel_parse(parallel, MyENCODING_UTF_8, css, strlen(css));
+            
+            test_buffer_t result = test_serialization(mycss_parallel_stylesheet(parallel));
+            
+            if(status || strcmp(expect.data, result.data))
+                is_good = false;
+            
+            free(result.data);
+        }
+        
+        test_check(is_good, "namespaces, second parse by parallel");
+        
+        mycss_parallel_destroy(parallel, true);
+    }
+    
+    mycss_stylesheet_destroy(first, true);
+    mycss_stylesheet_destroy(mycss_entry_stylesheet(entry), true);
+    mycss_entry_destroy(entry, true);
+    
+    free(expect.data);
+    free(first_again.data);
+    free(second.data);
+}
+
+static void test_parse(mycss_t* mycss, myhtml_tree_t* tree, size_t rule_count, bool is_broken)
+{
+    test_buffer_t css = test_generate_css(rule_count, is_broken);
+    
+    mycss_entry_t *entry = mycss_entry_create();
+    mystatus_t status = mycss_entry_init(mycss, entry);
+    
+    CHECK_STATUS("Can't init MyCSS Entry object\n");
+    
+    status = mycss_parse(entry, MyENCODING_UTF_8, css.data, css.length);
+    CHECK_STATUS("Can't parse CSS\n");
+    
+    test_buffer_t expect = test_serialization(mycss_entry_stylesheet(entry));
+    size_t expect_found = test_find(tree, mycss_entry_stylesheet(entry));
+    
+    for(size_t threads = 1; threads <= 4; threads++)
+    {
+        mycss_parallel_t *parallel = mycss_parallel_create();
+        status = mycss_parallel_init(parallel, mycss, threads);
+        
+        CHECK_STATUS("Can't init MyCSS Parallel object\n");
+        
+        /* every rule can begin a slice */
+        parallel->slice_min_size = 1;
+        
+        /* twice, second parse reuses entries */
+        for(size_t i = 0; i < 2; i++) {
+            status = mycss_parallel_parse(parallel, MyENCODING_UTF_8, css.data, css.length);
+            
+            test_buffer_t result = test_serialization(mycss_parallel_stylesheet(parallel));
+            char name[128];
+            
+            snprintf(name, sizeof(name), "rules: " MyCORE_FORMAT_Z "%s; threads: " MyCORE_FORMAT_Z "; slices: " MyCORE_FORMAT_Z,
+                     rule_count, (is_broken ? " broken" : ""), threads, mycss_parallel_slice_count(parallel));
+            
+            test_check(status == MyCSS_STATUS_OK && strcmp(expect.data, result.data) == 0 &&
+                       test_find(tree, mycss_parallel_stylesheet(parallel)) == expect_found &&
+                       (is_broken || rule_count < threads || mycss_parallel_slice_count(parallel) == threads), name);
+            
+            free(result.data);
+        }
+        
+        mycss_parallel_destroy(parallel, true);
+    }
+    
+    mycss_stylesheet_destroy(mycss_entry_stylesheet(entry), true);
+    mycss_entry_destroy(entry, true);
+    
+    free(expect.data);
+    free(css.data);
+}
+
+int main(int argc, const char * argv[])
+{
+    myhtml_t *myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, MyHTML_OPTIONS_DEFAULT, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    myhtml_tree_t *tree = myhtml_tree_create();
+    status = myhtml_tree_init(tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    status = myhtml_parse(tree, MyENCODING_UTF_8, test_html, strlen(test_html));
+    CHECK_STATUS("Can't parse HTML\n");
+    
+    mycss_t *mycss = mycss_create();
+    status = mycss_init(mycss);
+    
+    CHECK_STATUS("Can't init MyCSS object\n");
+    
+    test_parse(mycss, tree, 0, false);
+    test_parse(mycss, tree, 3, false);
+    test_parse(mycss, tree, 10, false);
+    test_parse(mycss, tree, 200, false);
+    test_parse(mycss, tree, 40, true);
+    
+    test_namespace_twice(mycss);
+    
+    mycss_destroy(mycss, true);
+    
+    myhtml_tree_destroy(tree);
+    myhtml_destroy(myhtml);
+    
+    return test_total();
+}
@@ -0,0 +1,143 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Bulk decoding (myencoding_decode_chunk_to_ascii_utf_8) must give the same UTF-8
+ * as decoding byte by byte, for all encodings, any split of input and any size of output.
+ * Byte by byte here decodes again an ASCII byte which broke a lead, as bulk decoding does.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myencoding/encoding.h>
+
+#define TEST_BUFFER_SIZE 4096
+#define TEST_ROUNDS 16
+
+static bool test_is_lead_based(myencoding_t encoding)
+{
+    return (encoding == MyENCODING_BIG5 || encoding == MyENCODING_EUC_JP || encoding == MyENCODING_EUC_KR ||
+            encoding == MyENCODING_GB18030 || encoding == MyENCODING_GBK || encoding == MyENCODING_SHIFT_JIS);
+}
+
+static size_t test_ref_decode(myencoding_t encoding, const char* data, size_t size, char* out)
+{
+    const myencoding_custom_f func = myencoding_get_function_by_id(encoding);
+    myencoding_result_t res = {0};
+    size_t length = 0;
+    
+    for(size_t i = 0; i < size; i++) {
+        unsigned long lead = res.first;
+        myencoding_status_t status = func((unsigned const char)data[i], &res);
+        
+        if(status == MyENCODING_STATUS_OK)
+            length += myencoding_codepoint_to_ascii_utf_8(res.result, &out[length]);
+        else if(status == MyENCODING_STATUS_ERROR && (unsigned char)data[i] <= 0x7F && lead && res.first == 0 &&
+                test_is_lead_based(encoding))
+        {
+            i--;
+        }
+    }
+    
+    return length;
+}
+
+/* input is given by random parts, output by random sizes */
+static size_t test_chunk_decode(myencoding_t encoding, const char* data, size_t size, char* out)
+{
+    myencoding_result_t res = {0};
+    size_t length = 0, begin = 0;
+    
+    while(begin < size)
+    {
+        size_t end = begin + 1 + (size_t)(rand() % 300);
+        
+        if(end > size)
+            end = size;
+        
+        size_t offset = begin;
+        
+        while(offset < end) {
+            size_t out_size = 4 + (size_t)(rand() % 64);
+            length += myencoding_decode_chunk_to_ascii_utf_8(encoding, &res, data, end, &offset, &out[length], out_size);
+        }
+        
+        begin = end;
+    }
+    
+    return length;
+}
+
+/* runs of ASCII with not ASCII bytes between, like real documents */
+static void test_fill(char* data, size_t size, unsigned int round)
+{
+    for(size_t i = 0; i < size; i++) {
+        if(round % 2)
+            data[i] = (char)(rand() % 256);
+        else
+            data[i] = (rand() % 8 ? (char)(0x20 + (rand() % 0x5F)) : (char)(0x80 + (rand() % 0x80)));
+    }
+}
+
+int main(int argc, const char * argv[])
+{
+    char *data = malloc(TEST_BUFFER_SIZE);
+    char *ref  = malloc(TEST_BUFFER_SIZE * 4);
+    char *out  = malloc((TEST_BUFFER_SIZE * 4) + 128);
+    
+    if(data == NULL || ref == NULL || out == NULL) {
+        fprintf(stderr, "Can't allocate mem for buffers\n");
+        return EXIT_FAILURE;
+    }
+    
+    size_t count = 0, good = 0;
+    srand(42);
+    
+    for(myencoding_t encoding = MyENCODING_UTF_8; encoding < MyENCODING_LAST_ENTRY; encoding++)
+    {
+        if(myencoding_get_function_by_id(encoding) == NULL)
+            continue;
+        
+        for(unsigned int round = 0; round < TEST_ROUNDS; round++)
+        {
+            test_fill(data, TEST_BUFFER_SIZE, round);
+            
+            size_t ref_length = test_ref_decode(encoding, data, TEST_BUFFER_SIZE, ref);
+            size_t out_length = test_chunk_decode(encoding, data, TEST_BUFFER_SIZE, out);
+            
+            count++;
+            
+            if(ref_length == out_length && memcmp(ref, out, ref_length) == 0)
+                good++;
+            else
+                printf("Bad: %s, round %u\n", myencoding_name_by_id(encoding, NULL), round);
+        }
+    }
+    
+    free(data);
+    free(ref);
+    free(out);
+    
+    printf("Total: " MyCORE_FORMAT_Z "; Good: " MyCORE_FORMAT_Z "; Bad: " MyCORE_FORMAT_Z "\n", count, good, (count - good));
+    
+    return (good == count ? EXIT_SUCCESS : EXIT_FAILURE);
+}
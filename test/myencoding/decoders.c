@@ -0,0 +1,64 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Decoders of multibyte encodings must leave no state of a character to the next one:
+ * a decoded or broken sequence gives only its own code point or an error.
+ */
+
+#include <string.h>
+
+#include <myencoding/encoding.h>
+
+#include "../test.h"
+
+/* byte by byte, code points of errors are skipped */
+static bool test_decode(myencoding_t encoding, const char* data, size_t size, const char* expect)
+{
+    const myencoding_custom_f func = myencoding_get_function_by_id(encoding);
+    myencoding_result_t res = {0};
+
+    char out[128];
+    size_t length = 0;
+
+    for(size_t i = 0; i < size; i++) {
+        if(func((unsigned const char)data[i], &res) == MyENCODING_STATUS_OK)
+            length += myencoding_codepoint_to_ascii_utf_8(res.result, &out[length]);
+    }
+
+    return (length == strlen(expect) && memcmp(out, expect, length) == 0);
+}
+
+int main(int argc, const char * argv[])
+{
+    /* あ, then single byte katakana ｱ: lead of あ must not be taken again */
+    test_check(test_decode(MyENCODING_SHIFT_JIS, "\x82\xA0\xB1", 3, "\xE3\x81\x82\xEF\xBD\xB1"),
+               "Shift_JIS lead reset");
+
+    /* 가, then lead with bad trail: error, not 가 again */
+    test_check(test_decode(MyENCODING_EUC_KR, "\xB0\xA1\xB0\xFF", 4, "\xEA\xB0\x80"),
+               "EUC-KR broken sequence");
+
+    /* 啊, then four bytes sequence with bad last byte: error, not 啊 again */
+    test_check(test_decode(MyENCODING_GB18030, "\xB0\xA1\x81\x30\x81\xFF", 6, "\xE5\x95\x8A"),
+               "GB18030 broken four bytes sequence");
+
+    return test_total();
+}
@@ -0,0 +1,195 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * myencoding_detect_utf_8 and myencoding_detect_utf_16 count by blocks;
+ * counts must be the same as counts of simple byte by byte loops.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myencoding/encoding.h>
+
+#define TEST_BUFFER_SIZE 2048
+#define TEST_ROUNDS 400
+
+static myencoding_unicode_result_t test_ref_utf_8(unsigned const char *u_text, size_t length)
+{
+    size_t i = 0;
+    myencoding_unicode_result_t res = {0, 0, 0};
+    
+    while(i < length)
+    {
+        size_t need;
+        
+        if((u_text[i] & 0x80) == 0x00) {
+            res.count_ascii++;
+            i++;
+            
+            continue;
+        }
+        else if((u_text[i] & 0xE0) == 0xC0)
+            need = 1;
+        else if((u_text[i] & 0xF0) == 0xE0)
+            need = 2;
+        else if((u_text[i] & 0xF8) == 0xF0)
+            need = 3;
+        else {
+            res.count_bad++;
+            i++;
+            
+            continue;
+        }
+        
+        i += need + 1;
+        
+        if(i >= length)
+            break;
+        
+        bool good = true;
+        
+        for(size_t j = 1; j <= need; j++) {
+            if((u_text[i - j] & 0xC0) != 0x80)
+                good = false;
+        }
+        
+        if(good)
+            res.count_good++;
+        else
+            res.count_bad++;
+    }
+    
+    return res;
+}
+
+static myencoding_unicode_result_t test_ref_utf_16(unsigned const char *u_text, size_t length)
+{
+    myencoding_unicode_result_t res = {0, 0, 0};
+    
+    for(size_t i = 0; i < length; i++)
+    {
+        if(u_text[i] != 0x00)
+            continue;
+        
+        if((i % 2) == 0) {
+            if((i + 1) < length && u_text[(i + 1)] > 0x1F && u_text[(i + 1)] < 0x7F)
+                res.count_bad++;
+            
+            /* next byte is checked as odd */
+        }
+        else if(u_text[(i - 1)] > 0x1F && u_text[(i - 1)] < 0x7F)
+            res.count_good++;
+    }
+    
+    return res;
+}
+
+static size_t test_put_char(unsigned char* data, size_t codepoint)
+{
+    return myencoding_codepoint_to_ascii_utf_8(codepoint, (char*)data);
+}
+
+/* text like in real documents: mostly ASCII, UTF-8 characters of all lengths, broken bytes, zeros */
+static void test_fill(unsigned char* data, size_t size, unsigned int round)
+{
+    size_t i = 0;
+    
+    while(i < size)
+    {
+        if((size - i) < 4 || (round % 5) == 0) {
+            data[i++] = (unsigned char)(rand() % 256);
+            continue;
+        }
+        
+        switch (rand() % 16) {
+            case 0: i += test_put_char(&data[i], 0x80 + (rand() % 0x780)); break;
+            case 1: i += test_put_char(&data[i], 0x800 + (rand() % 0xF800)); break;
+            case 2: i += test_put_char(&data[i], 0x10000 + (rand() % 0x100000)); break;
+            case 3:
+                if((round % 5) == 1)
+                    data[i++] = (unsigned char)(0x80 + (rand() % 0x80));
+                else
+                    data[i++] = 'a';
+                break;
+            case 4:
+                if((round % 5) == 2)
+                    data[i++] = 0x00;
+                else
+                    data[i++] = ' ';
+                break;
+            default:
+                data[i++] = (unsigned char)(0x20 + (rand() % 0x5F));
+                break;
+        }
+    }
+}
+
+static bool test_equal(myencoding_unicode_result_t* a, myencoding_unicode_result_t* b)
+{
+    return (a->count_ascii == b->count_ascii && a->count_good == b->count_good && a->count_bad == b->count_bad);
+}
+
+int main(int argc, const char * argv[])
+{
+    unsigned char *data = malloc(TEST_BUFFER_SIZE);
+    if(data == NULL) {
+        fprintf(stderr, "Can't allocate mem for buffer\n");
+        return EXIT_FAILURE;
+    }
+    
+    size_t count = 0, good = 0;
+    srand(42);
+    
+    for(unsigned int round = 0; round < TEST_ROUNDS; round++)
+    {
+        test_fill(data, TEST_BUFFER_SIZE, round);
+        
+        size_t offset = (size_t)(rand() % 40);
+        size_t length = (size_t)(rand() % (TEST_BUFFER_SIZE - offset));
+        
+        myencoding_unicode_result_t ref = test_ref_utf_8(&data[offset], length);
+        myencoding_unicode_result_t res = myencoding_detect_utf_8(&data[offset], length);
+        
+        count++;
+        
+        if(test_equal(&ref, &res))
+            good++;
+        else
+            printf("Bad UTF-8 counts in round %u\n", round);
+        
+        ref = test_ref_utf_16(&data[offset], length);
+        res = myencoding_detect_utf_16(&data[offset], length);
+        
+        count++;
+        
+        if(test_equal(&ref, &res))
+            good++;
+        else
+            printf("Bad UTF-16 counts in round %u\n", round);
+    }
+    
+    free(data);
+    
+    printf("Total: " MyCORE_FORMAT_Z "; Good: " MyCORE_FORMAT_Z "; Bad: " MyCORE_FORMAT_Z "\n", count, good, (count - good));
+    
+    return (good == count ? EXIT_SUCCESS : EXIT_FAILURE);
+}
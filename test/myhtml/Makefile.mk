@@ -5,3 +5,5 @@ myhtml_all: $(myhtml_objs)
 
 myhtml_clean: 
 	rm -f $(myhtml_objs)
+
+myhtml_parse_file := $(TEST_DIR_RELATIVE)/myhtml/data/parse_file
@@ -0,0 +1,159 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Tree in arena mode must build the same documents as tree in default mode,
+ * must not reuse freed objects before clean and must reuse its chunks after clean.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myhtml/myhtml.h>
+#include <myhtml/serialization.h>
+
+#include "../test.h"
+
+static const char *test_documents[] = {
+    "<!DOCTYPE html><html><head><title>t</title></head><body><div id=a class='b c'>text</div></body></html>",
+    "<p><b><i>misnested</b> formatting</i> elements<p>and <a href=x>links <a href=y>inside</a></a>",
+    "<table><tr><td>cell</td>foster <b>parented</b><tr><td>two</table>",
+    "<div a=1 a=2 A=3 b>duplicate attributes</div>\n\n\n   <pre>\n\nnewlines</pre><textarea>\n\ntext</textarea>",
+    "<svg viewbox='0 0 1 1'><foreignObject><p>svg</p></foreignObject></svg><math><mi>x</mi></math>",
+    "<ul><li>one<li>two<li><ul><li>three</ul></ul><select><option>a<option>b</select><x-custom>c</x-custom>",
+    "&amp;&lt;&#x41;&notin;&notit; <!-- comment --><script>var a = '<b>';</script><style>p {}</style>",
+    NULL
+};
+
+static myhtml_tree_t * test_tree_create(myhtml_t* myhtml, bool arena)
+{
+    myhtml_tree_t* tree = myhtml_tree_create();
+    mystatus_t status = myhtml_tree_init(tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    myhtml_tree_arena_set(tree, arena);
+    
+    return tree;
+}
+
+static void test_parse(myhtml_tree_t* tree, const char* html)
+{
+    mystatus_t status = myhtml_parse(tree, MyENCODING_UTF_8, html, strlen(html));
+    CHECK_STATUS("Can't parse HTML:\n%s\n", html);
+}
+
+static bool test_same_document(myhtml_tree_t* tree, myhtml_tree_t* arena)
+{
+    mycore_string_raw_t str_tree = {0};
+    mycore_string_raw_t str_arena = {0};
+    
+    if(myhtml_serialization_tree_buffer(myhtml_tree_get_document(tree), &str_tree) ||
+       myhtml_serialization_tree_buffer(myhtml_tree_get_document(arena), &str_arena))
+    {
+        DIE("Can't serialize tree\n");
+    }
+    
+    bool is_same = (str_tree.length == str_arena.length &&
+                    memcmp(str_tree.data, str_arena.data, str_tree.length) == 0);
+    
+    mycore_string_raw_destroy(&str_tree, false);
+    mycore_string_raw_destroy(&str_arena, false);
+    
+    return is_same;
+}
+
+/* count of chunks taken from object and char allocators of tree */
+static size_t test_chunks_count(myhtml_tree_t* tree)
+{
+    mcobject_async_t *objs[] = {tree->tree_obj, tree->token->nodes_obj, tree->token->attr_obj};
+    size_t count = 0;
+    
+    for(size_t i = 0; i < (sizeof(objs) / sizeof(objs[0])); i++)
+        count += (objs[i]->chunks_pos_length * objs[i]->chunks_size) + objs[i]->chunks_length;
+    
+    return count + (tree->mchar->chunks_pos_length * tree->mchar->chunks_size) + tree->mchar->chunks_length;
+}
+
+int main(int argc, const char * argv[])
+{
+    myhtml_t* myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, MyHTML_OPTIONS_DEFAULT, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    myhtml_tree_t* tree  = test_tree_create(myhtml, false);
+    myhtml_tree_t* arena = test_tree_create(myhtml, true);
+    
+    test_check(myhtml_tree_arena(tree) == false, "default mode of tree");
+    test_check(myhtml_tree_arena(arena), "arena mode of tree");
+    
+    /* same documents, also in a row on one tree */
+    for(size_t i = 0; test_documents[i]; i++) {
+        test_parse(tree, test_documents[i]);
+        test_parse(arena, test_documents[i]);
+        
+        char name[64];
+        snprintf(name, sizeof(name), "same document " MyCORE_FORMAT_Z, i);
+        
+        test_check(test_same_document(tree, arena), name);
+    }
+    
+    /* all documents together need more chunks than one, then chunks are reused */
+    size_t chunks = test_chunks_count(arena);
+    
+    for(size_t i = 0; i < 3; i++) {
+        for(size_t j = 0; test_documents[j]; j++)
+            test_parse(arena, test_documents[j]);
+    }
+    
+    test_check(test_chunks_count(arena) == chunks, "chunks are reused after clean");
+    
+    /* free does not give objects back before clean */
+    myhtml_tree_node_t *node = myhtml_node_create(tree, MyHTML_TAG_DIV, MyHTML_NAMESPACE_HTML);
+    myhtml_node_free(node);
+    test_check(myhtml_node_create(tree, MyHTML_TAG_DIV, MyHTML_NAMESPACE_HTML) == node, "freed node is reused in default mode");
+    
+    node = myhtml_node_create(arena, MyHTML_TAG_DIV, MyHTML_NAMESPACE_HTML);
+    myhtml_node_free(node);
+    test_check(myhtml_node_create(arena, MyHTML_TAG_DIV, MyHTML_NAMESPACE_HTML) != node, "freed node is not reused in arena mode");
+    
+    char *data = mchar_async_malloc(arena->mchar, arena->mchar_node_id, 64);
+    mchar_async_free(arena->mchar, arena->mchar_node_id, data);
+    test_check(mchar_async_malloc(arena->mchar, arena->mchar_node_id, 64) != data, "freed chars are not reused in arena mode");
+    
+    /* back to default mode */
+    myhtml_tree_arena_set(arena, false);
+    
+    node = myhtml_node_create(arena, MyHTML_TAG_DIV, MyHTML_NAMESPACE_HTML);
+    myhtml_node_free(node);
+    test_check(myhtml_node_create(arena, MyHTML_TAG_DIV, MyHTML_NAMESPACE_HTML) == node, "freed node is reused after arena mode off");
+    
+    test_parse(tree, test_documents[0]);
+    test_parse(arena, test_documents[0]);
+    test_check(test_same_document(tree, arena), "same document after arena mode off");
+    
+    myhtml_tree_destroy(arena);
+    myhtml_tree_destroy(tree);
+    myhtml_destroy(myhtml);
+    
+    return test_total();
+}
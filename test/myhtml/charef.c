@@ -0,0 +1,150 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Named character references: the longest name from the table wins, names of legacy entities
+ * can be without semicolon, in attribute values such names are not decoded before '=' or alphanumeric.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myhtml/myhtml.h>
+#include <myhtml/charef.h>
+
+#include "../test.h"
+
+struct test_charef {
+    const char *data;
+    const char *text;
+    const char *attr;
+}
+typedef test_charef_t;
+
+static const test_charef_t test_list[] = {
+    {"&amp;", "&", "&"},
+    {"&amp", "&", "&"},
+    {"&AMP;x", "&x", "&x"},
+    {"&ampx", "&x", "&ampx"},
+    {"&amp=", "&=", "&amp="},
+    {"&Amp;", "&Amp;", "&Amp;"},
+    {"&&lt;", "&<", "&<"},
+    {"&lt&gt", "<>", "<>"},
+    {"&notin;", "\xe2\x88\x89", "\xe2\x88\x89"},
+    {"&notit;", "\xc2\xacit;", "&notit;"},
+    {"&noti", "\xc2\xaci", "&noti"},
+    {"&not ", "\xc2\xac ", "\xc2\xac "},
+    {"&AElig;", "\xc3\x86", "\xc3\x86"},
+    {"&frac34;", "\xc2\xbe", "\xc2\xbe"},
+    {"&frac35;", "\xe2\x85\x97", "\xe2\x85\x97"},
+    {"&frac3;", "&frac3;", "&frac3;"},
+    {"&there4;", "\xe2\x88\xb4", "\xe2\x88\xb4"},
+    {"&zwnj;", "\xe2\x80\x8c", "\xe2\x80\x8c"},
+    {"&NotNestedGreaterGreater;", "\xe2\xaa\xa2\xcc\xb8", "\xe2\xaa\xa2\xcc\xb8"},
+    {"&NotNestedGreaterGreater", "&NotNestedGreaterGreater", "&NotNestedGreaterGreater"},
+    {"&unknown;", "&unknown;", "&unknown;"},
+    {"&;", "&;", "&;"},
+    {"&#x41;&#66;", "AB", "AB"}
+};
+
+static bool test_entry(myhtml_t* myhtml, const test_charef_t* entry)
+{
+    char html[256];
+    int length = snprintf(html, sizeof(html), "<p title=\"%s\">%s</p>", entry->data, entry->data);
+    
+    if(length < 0 || (size_t)length >= sizeof(html))
+        DIE("Test data is too long: %s\n", entry->data);
+    
+    myhtml_tree_t* tree = myhtml_tree_create();
+    mystatus_t status = myhtml_tree_init(tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    status = myhtml_parse(tree, MyENCODING_UTF_8, html, (size_t)length);
+    CHECK_STATUS("Can't parse HTML\n");
+    
+    myhtml_collection_t *collection = myhtml_get_nodes_by_tag_id(tree, NULL, MyHTML_TAG_P, NULL);
+    
+    bool is_eq = false;
+    
+    if(collection && collection->length == 1) {
+        myhtml_tree_node_t *node = collection->list[0];
+        
+        const char *text = myhtml_node_text(myhtml_node_child(node), NULL);
+        const char *attr = myhtml_attribute_value(myhtml_attribute_by_key(node, "title", 5), NULL);
+        
+        is_eq = (text && attr && strcmp(text, entry->text) == 0 && strcmp(attr, entry->attr) == 0);
+        
+        if(is_eq == false)
+            printf("%s: text \"%s\", attribute \"%s\"\n", entry->data, (text ? text : ""), (attr ? attr : ""));
+    }
+    
+    myhtml_collection_destroy(collection);
+    myhtml_tree_destroy(tree);
+    
+    return is_eq;
+}
+
+static void test_parse(myhtml_t* myhtml)
+{
+    for(size_t i = 0; i < (sizeof(test_list) / sizeof(test_list[0])); i++) {
+        test_check(test_entry(myhtml, &test_list[i]), test_list[i].data);
+    }
+}
+
+static void test_find(void)
+{
+    size_t offset = 0, data_size = 0;
+    const charef_entry_t *entry = myhtml_charef_find("AMP;", &offset, 4, &data_size);
+    
+    test_check(entry && offset == 4 && data_size == 1 && entry->codepoints[0] == '&', "find full name");
+    
+    offset = 0;
+    entry = myhtml_charef_find("NotNestedGreaterGreater;", &offset, 24, &data_size);
+    
+    test_check(entry && offset == 24 && data_size == 2 && entry->codepoints[0] == 0x2AA2 &&
+               entry->codepoints[1] == 0x0338, "find name with two codepoints");
+    
+    offset = 0;
+    entry = myhtml_charef_find("Amp;", &offset, 4, &data_size);
+    
+    test_check(entry && data_size == 0, "unknown name is not found");
+    
+    entry = myhtml_charef_get_first_position('a');
+    
+    test_check(entry && entry->ch == 'a' && entry->children != 0, "first position by character");
+    test_check(myhtml_charef_get_first_position('_')->ch == '\0', "no names from character");
+}
+
+int main(int argc, const char * argv[])
+{
+    myhtml_t* myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, MyHTML_OPTIONS_DEFAULT, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    test_parse(myhtml);
+    test_find();
+    
+    myhtml_destroy(myhtml);
+    
+    return test_total();
+}
@@ -0,0 +1,134 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Custom tags live in the tree, static tags are shared by all trees.
+ * Custom tags must be forgotten after the tree is cleaned.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myhtml/myhtml.h>
+
+#include "../test.h"
+
+static void test_parse(myhtml_tree_t* tree, const char* html)
+{
+    mystatus_t status = myhtml_parse(tree, MyENCODING_UTF_8, html, strlen(html));
+    CHECK_STATUS("Can't parse HTML:\n%s\n", html);
+}
+
+static myhtml_tag_id_t test_id(myhtml_tree_t* tree, const char* name)
+{
+    return myhtml_tag_id_by_name(tree, name, strlen(name));
+}
+
+static bool test_name(myhtml_tree_t* tree, myhtml_tag_id_t tag_id, const char* name)
+{
+    size_t length;
+    const char *tag_name = myhtml_tag_name_by_id(tree, tag_id, &length);
+    
+    if(tag_name == NULL)
+        return name == NULL;
+    
+    return name && length == strlen(name) && strncmp(tag_name, name, length) == 0;
+}
+
+static bool test_first_child(myhtml_tree_t* tree, const char* name)
+{
+    myhtml_tree_node_t *body = myhtml_tree_get_node_body(tree);
+    
+    if(body == NULL || myhtml_node_child(body) == NULL)
+        return false;
+    
+    return myhtml_node_tag_id(myhtml_node_child(body)) == test_id(tree, name);
+}
+
+int main(int argc, const char * argv[])
+{
+    myhtml_t* myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, MyHTML_OPTIONS_DEFAULT, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    myhtml_tree_t* tree = myhtml_tree_create();
+    status = myhtml_tree_init(tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    myhtml_tree_t* other = myhtml_tree_create();
+    status = myhtml_tree_init(other, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    /* new tree */
+    test_check(test_id(tree, "div") == MyHTML_TAG_DIV, "static tag in new tree");
+    test_check(test_id(tree, "DiV") == MyHTML_TAG_DIV, "static tag case insensitive");
+    test_check(test_id(tree, "x-foo") == MyHTML_TAG__UNDEF, "no custom tags in new tree");
+    test_check(test_name(tree, MyHTML_TAG_LAST_ENTRY, NULL), "no custom tag ids in new tree");
+    test_check(test_name(tree, MyHTML_TAG_SPAN, "span"), "static tag name by id");
+    
+    /* custom tags */
+    test_parse(tree, "<x-foo><X-Bar>t</X-Bar></x-foo><div></div>");
+    
+    myhtml_tag_id_t foo_id = test_id(tree, "x-foo");
+    myhtml_tag_id_t bar_id = test_id(tree, "X-BAR");
+    
+    test_check(foo_id >= MyHTML_TAG_LAST_ENTRY, "custom tag added");
+    test_check(bar_id >= MyHTML_TAG_LAST_ENTRY && bar_id != foo_id, "second custom tag added");
+    test_check(test_name(tree, bar_id, "x-bar"), "custom tag name in lowercase");
+    test_check(test_first_child(tree, "x-foo"), "custom tag node");
+    test_check(test_id(tree, "div") == MyHTML_TAG_DIV, "static tag with custom tags");
+    test_check(test_id(other, "x-foo") == MyHTML_TAG__UNDEF, "custom tags are not shared");
+    
+    /* reparse, tree is cleaned */
+    test_parse(tree, "<y-baz>t</y-baz>");
+    
+    test_check(test_id(tree, "x-foo") == MyHTML_TAG__UNDEF, "custom tag forgotten after clean");
+    test_check(test_id(tree, "y-baz") == MyHTML_TAG_LAST_ENTRY, "custom tag ids start over after clean");
+    test_check(test_name(tree, (MyHTML_TAG_LAST_ENTRY + 1), NULL), "old custom tag ids after clean");
+    test_check(test_first_child(tree, "y-baz"), "custom tag node after clean");
+    
+    /* fragment in a custom tag of the cleaned tree, its id is not known any more */
+    status = myhtml_parse_fragment(tree, MyENCODING_UTF_8, "<b>t</b>", 8, bar_id, MyHTML_NAMESPACE_HTML);
+    myhtml_collection_t *collection = myhtml_get_nodes_by_tag_id(tree, NULL, MyHTML_TAG_B, NULL);
+    
+    test_check(status == MyHTML_STATUS_OK && collection && collection->length == 1, "fragment in dropped custom tag");
+    myhtml_collection_destroy(collection);
+    
+    /* only static tags */
+    test_parse(tree, "<p><b>t</b></p>");
+    
+    test_check(test_id(tree, "y-baz") == MyHTML_TAG__UNDEF, "no custom tags after static only parse");
+    test_check(test_first_child(tree, "p"), "static tag node");
+    
+    test_parse(other, "<y-baz><p>t</p></y-baz>");
+    
+    test_check(test_id(other, "y-baz") == MyHTML_TAG_LAST_ENTRY, "custom tag in other tree");
+    test_check(test_first_child(other, "y-baz"), "custom tag node in other tree");
+    
+    myhtml_tree_destroy(other);
+    myhtml_tree_destroy(tree);
+    myhtml_destroy(myhtml);
+    
+    return test_total();
+}
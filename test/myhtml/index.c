@@ -0,0 +1,352 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Queries of tree with index must give the same nodes in the same order
+ * as queries of the same tree without index, after parsing and after changes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myhtml/myhtml.h>
+
+#include "../test.h"
+
+#define TEST_NODES_MAX 4096
+
+struct test_tree {
+    myhtml_tree_t* tree;
+    
+    /* nodes in document order for compare of two trees */
+    myhtml_tree_node_t* nodes[TEST_NODES_MAX];
+    size_t nodes_length;
+}
+typedef test_tree_t;
+
+static void test_check_query(bool result, const char* name, const char* what)
+{
+    if(test_count_result(result) == false)
+        printf(MyCORE_FORMAT_Z ") %s: %s: bad\n", test_count, name, what);
+}
+
+static void test_tree_nodes(test_tree_t* test)
+{
+    myhtml_tree_node_t *root = myhtml_tree_get_document(test->tree);
+    myhtml_tree_node_t *node = root;
+    
+    test->nodes_length = 0;
+    
+    while(node)
+    {
+        if(test->nodes_length < TEST_NODES_MAX)
+            test->nodes[ test->nodes_length++ ] = node;
+        
+        if(node->child)
+            node = node->child;
+        else {
+            while(node != root && node->next == NULL)
+                node = node->parent;
+            
+            if(node == root)
+                break;
+            
+            node = node->next;
+        }
+    }
+}
+
+static size_t test_node_position(test_tree_t* test, myhtml_tree_node_t* node)
+{
+    for(size_t i = 0; i < test->nodes_length; i++) {
+        if(test->nodes[i] == node)
+            return i;
+    }
+    
+    /* detached node */
+    return TEST_NODES_MAX;
+}
+
+static myhtml_tree_node_t * test_node_by_tag(test_tree_t* test, myhtml_tag_id_t tag_id, size_t skip)
+{
+    for(size_t i = 0; i < test->nodes_length; i++) {
+        if(test->nodes[i]->tag_id == tag_id) {
+            if(skip == 0)
+                return test->nodes[i];
+            
+            skip--;
+        }
+    }
+    
+    return NULL;
+}
+
+static bool test_collection_eq(test_tree_t* indexed, myhtml_collection_t* first, test_tree_t* walked, myhtml_collection_t* second)
+{
+    if(first == NULL || second == NULL)
+        return first == second;
+    
+    if(first->length != second->length)
+        return false;
+    
+    for(size_t i = 0; i < first->length; i++) {
+        if(test_node_position(indexed, first->list[i]) != test_node_position(walked, second->list[i]))
+            return false;
+    }
+    
+    return true;
+}
+
+static const char *test_tags[] = {
+    "html", "body", "div", "p", "b", "i", "a", "span", "table", "tr", "td", "li", "x-foo", NULL
+};
+
+static const char *test_keys[] = {
+    "id", "class", "href", "data-x", "ID", NULL
+};
+
+static const char *test_ids[] = {
+    "a", "b", "c", "main", "x", NULL
+};
+
+static const char *test_classes[] = {
+    "a", "b", "c", "bbbb", "x", "y", "z", NULL
+};
+
+static void test_queries_scope(test_tree_t* indexed, test_tree_t* walked, size_t position, const char* name)
+{
+    myhtml_tree_node_t *scope_indexed = NULL, *scope_walked = NULL;
+    
+    if(position) {
+        if(position >= indexed->nodes_length)
+            return;
+        
+        scope_indexed = indexed->nodes[position];
+        scope_walked  = walked->nodes[position];
+    }
+    
+    mystatus_t status;
+    char what[128];
+    
+    for(size_t i = 0; test_tags[i]; i++) {
+        myhtml_collection_t *first, *second;
+        
+        if(scope_indexed) {
+            first  = myhtml_get_nodes_by_name_in_scope(indexed->tree, NULL, scope_indexed, test_tags[i], strlen(test_tags[i]), &status);
+            second = myhtml_get_nodes_by_name_in_scope(walked->tree, NULL, scope_walked, test_tags[i], strlen(test_tags[i]), &status);
+        }
+        else {
+            first  = myhtml_get_nodes_by_name(indexed->tree, NULL, test_tags[i], strlen(test_tags[i]), &status);
+            second = myhtml_get_nodes_by_name(walked->tree, NULL, test_tags[i], strlen(test_tags[i]), &status);
+        }
+        
+        snprintf(what, sizeof(what), "tag %s, scope " MyCORE_FORMAT_Z, test_tags[i], position);
+        test_check_query(test_collection_eq(indexed, first, walked, second), name, what);
+        
+        myhtml_collection_destroy(first);
+        myhtml_collection_destroy(second);
+    }
+    
+    for(size_t i = 0; test_keys[i]; i++) {
+        myhtml_collection_t *first  = myhtml_get_nodes_by_attribute_key(indexed->tree, NULL, scope_indexed, test_keys[i], strlen(test_keys[i]), NULL);
+        myhtml_collection_t *second = myhtml_get_nodes_by_attribute_key(walked->tree, NULL, scope_walked, test_keys[i], strlen(test_keys[i]), NULL);
+        
+        snprintf(what, sizeof(what), "key %s, scope " MyCORE_FORMAT_Z, test_keys[i], position);
+        test_check_query(test_collection_eq(indexed, first, walked, second), name, what);
+        
+        myhtml_collection_destroy(first);
+        myhtml_collection_destroy(second);
+    }
+    
+    for(size_t i = 0; test_ids[i]; i++) {
+        myhtml_collection_t *first  = myhtml_get_nodes_by_attribute_value(indexed->tree, NULL, scope_indexed, false, "id", 2,
+                                                                          test_ids[i], strlen(test_ids[i]), NULL);
+        myhtml_collection_t *second = myhtml_get_nodes_by_attribute_value(walked->tree, NULL, scope_walked, false, "id", 2,
+                                                                          test_ids[i], strlen(test_ids[i]), NULL);
+        
+        snprintf(what, sizeof(what), "id %s, scope " MyCORE_FORMAT_Z, test_ids[i], position);
+        test_check_query(test_collection_eq(indexed, first, walked, second), name, what);
+        
+        myhtml_collection_destroy(first);
+        myhtml_collection_destroy(second);
+    }
+    
+    for(size_t i = 0; test_classes[i]; i++) {
+        myhtml_collection_t *first  = myhtml_get_nodes_by_attribute_value_whitespace_separated(indexed->tree, NULL, scope_indexed, false, "class", 5,
+                                                                                               test_classes[i], strlen(test_classes[i]), NULL);
+        myhtml_collection_t *second = myhtml_get_nodes_by_attribute_value_whitespace_separated(walked->tree, NULL, scope_walked, false, "class", 5,
+                                                                                               test_classes[i], strlen(test_classes[i]), NULL);
+        
+        snprintf(what, sizeof(what), "class %s, scope " MyCORE_FORMAT_Z, test_classes[i], position);
+        test_check_query(test_collection_eq(indexed, first, walked, second), name, what);
+        
+        myhtml_collection_destroy(first);
+        myhtml_collection_destroy(second);
+    }
+}
+
+static void test_queries(test_tree_t* indexed, test_tree_t* walked, const char* name)
+{
+    test_tree_nodes(indexed);
+    test_tree_nodes(walked);
+    
+    test_check_query(indexed->nodes_length == walked->nodes_length, name, "same trees");
+    
+    if(indexed->nodes_length != walked->nodes_length)
+        return;
+    
+    /* whole document, html, then some nodes inside */
+    test_queries_scope(indexed, walked, 0, name);
+    
+    for(size_t position = 1; position < indexed->nodes_length; position += 3)
+        test_queries_scope(indexed, walked, position, name);
+}
+
+static void test_parse(test_tree_t* test, const char* html)
+{
+    mystatus_t status = myhtml_parse(test->tree, MyENCODING_UTF_8, html, strlen(html));
+    CHECK_STATUS("Can't parse HTML:\n%s\n", html);
+}
+
+/* same changes for both trees */
+static void test_change(test_tree_t* test)
+{
+    myhtml_tree_t *tree = test->tree;
+    
+    myhtml_tree_node_t *div = test_node_by_tag(test, MyHTML_TAG_DIV, 0);
+    myhtml_tree_node_t *span = test_node_by_tag(test, MyHTML_TAG_SPAN, 0);
+    myhtml_tree_node_t *p = test_node_by_tag(test, MyHTML_TAG_P, 1);
+    myhtml_tree_node_t *body = myhtml_tree_get_node_body(tree);
+    
+    if(div) {
+        myhtml_attribute_add(div, "class", 5, "y  z y", 6, MyENCODING_UTF_8);
+        myhtml_attribute_add(div, "ID", 2, "x", 1, MyENCODING_UTF_8);
+        myhtml_attribute_remove_by_key(div, "id", 2);
+    }
+    
+    if(span) {
+        myhtml_tree_attr_t *attr = myhtml_attribute_by_key(span, "class", 5);
+        
+        if(attr)
+            myhtml_attribute_delete(tree, span, attr);
+        
+        myhtml_attribute_add(span, "class", 5, "c x", 3, MyENCODING_UTF_8);
+    }
+    
+    if(body) {
+        myhtml_tree_node_t *node = myhtml_node_create(tree, MyHTML_TAG_P, MyHTML_NAMESPACE_HTML);
+        myhtml_node_append_child(body, node);
+        myhtml_attribute_add(node, "class", 5, "z", 1, MyENCODING_UTF_8);
+        
+        myhtml_tree_node_t *child = myhtml_node_create(tree, MyHTML_TAG_SPAN, MyHTML_NAMESPACE_HTML);
+        myhtml_attribute_add(child, "id", 2, "b", 1, MyENCODING_UTF_8);
+        myhtml_node_append_child(node, child);
+        
+        if(body->child && body->child != node) {
+            myhtml_tree_node_t *first = myhtml_node_create(tree, MyHTML_TAG_DIV, MyHTML_NAMESPACE_HTML);
+            myhtml_attribute_add(first, "class", 5, "x", 1, MyENCODING_UTF_8);
+            myhtml_node_insert_before(body->child, first);
+        }
+    }
+    
+    if(p)
+        myhtml_node_delete_recursive(p);
+}
+
+static void test_document(test_tree_t* indexed, test_tree_t* walked, const char* html, bool built)
+{
+    test_parse(indexed, html);
+    test_parse(walked, html);
+    
+    /* well-formed document is built by tree builder without walk */
+    if(built)
+        test_check_query(myhtml_index_is_ready(myhtml_tree_get_index(indexed->tree), false), html, "index after parse");
+    
+    test_queries(indexed, walked, html);
+    
+    test_change(indexed);
+    test_change(walked);
+    
+    test_queries(indexed, walked, html);
+}
+
+static const char *test_html_list[] = {
+    "<div id=a class=\"a b\"><p class=a>1</p><p class='b  a a'>2<span class=c>3</span></p></div><div id=b class=bbbb><p>4</p></div>",
+    "<!doctype html><html><head><title>t</title></head><body class=x><ul><li class='a bbbb c'>1<li class=\"bbbb\">2</ul><a href=#>3</a></body></html><!-- end -->",
+    "<p><b class=a>1<i class=b>2</b>3</i>4</p><p>5</p><b id=c><p class=c>6</p></b>",
+    "<table><tr><td class=a>1</td></tr><div class=b>foster</div><span id=a>2</span></table><p class=a>3</p>",
+    "<body id=main><div><p>1</div><body class=y data-x=1><p class=z>2",
+    "<x-foo class=a><x-foo class=b><span class=a ID=x Class=y>1</span></x-foo></x-foo><svg><a class=a></a></svg>",
+    "<div class=\"a\" class=\"b\" id=a id=b><p data-x=1 DATA-X=2>1</p></div>",
+    NULL
+};
+
+int main(int argc, const char * argv[])
+{
+    myhtml_t* myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, MyHTML_OPTIONS_DEFAULT, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    test_tree_t *indexed = calloc(1, sizeof(test_tree_t));
+    test_tree_t *walked = calloc(1, sizeof(test_tree_t));
+    
+    if(indexed == NULL || walked == NULL)
+        DIE("Can't allocate mem for test trees\n");
+    
+    indexed->tree = myhtml_tree_create();
+    status = myhtml_tree_init(indexed->tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    status = myhtml_tree_index_enable(indexed->tree);
+    
+    CHECK_STATUS("Can't enable index for MyHTML Tree object\n");
+    
+    walked->tree = myhtml_tree_create();
+    status = myhtml_tree_init(walked->tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    for(size_t i = 0; test_html_list[i]; i++)
+        test_document(indexed, walked, test_html_list[i], (i < 2));
+    
+    /* index enabled after parsing */
+    myhtml_tree_index_disable(indexed->tree);
+    
+    test_parse(indexed, test_html_list[0]);
+    test_parse(walked, test_html_list[0]);
+    
+    status = myhtml_tree_index_enable(indexed->tree);
+    
+    CHECK_STATUS("Can't enable index for MyHTML Tree object\n");
+    
+    test_queries(indexed, walked, "enabled after parsing");
+    
+    myhtml_tree_destroy(indexed->tree);
+    myhtml_tree_destroy(walked->tree);
+    myhtml_destroy(myhtml);
+    
+    free(indexed);
+    free(walked);
+    
+    return test_total();
+}
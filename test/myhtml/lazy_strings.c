@@ -0,0 +1,257 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * MyHTML_TREE_PARSE_FLAGS_LAZY_STRINGS keeps only raw positions of text and attribute values after tokenizer,
+ * strings are decoded on first read. Trees must be the same as trees of parse without the flag.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myhtml/myhtml.h>
+#include <myhtml/serialization.h>
+
+#include "../test.h"
+
+static const char test_html[] =
+    "<!DOCTYPE html PUBLIC \"-//W3C//DTD HTML 4.01 Transitional//EN\" \"http://www.w3.org/TR/html4/loose.dtd\">"
+    "<html><head><title>A &amp; B</title><!-- c&amp;d --></head>"
+    "<body class=\"main  page\" id=b>"
+    "<a href=\"/x?a=1&amp;b=2\" title='&lt;q&gt;'>link &copy; &#x41;&#66;</a>"
+    "<pre>\nfirst line</pre>"
+    "<table> <tr><td>cell</td></tr> text in table <input type=HIDDEN name=h><input type=text></table>"
+    "<b class=f>bold<p>reconstructed</b> tail</p>"
+    "<svg viewbox=\"0 0 1 1\"><foreignObject definitionurl=x>in svg</foreignObject></svg>"
+    "<math><annotation-xml encoding=\"text/html\"><div>html</div></annotation-xml></math>"
+    "<p>null\0char</p><textarea>\nrc &amp; data</textarea>"
+    "<div title=\"&notin; &noti\">&amp</div>"
+    "</body></html>";
+
+static myhtml_tree_t * test_tree_create(myhtml_t* myhtml, bool lazy)
+{
+    myhtml_tree_t* tree = myhtml_tree_create();
+    mystatus_t status = myhtml_tree_init(tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    if(lazy)
+        myhtml_tree_parse_flags_set(tree, MyHTML_TREE_PARSE_FLAGS_LAZY_STRINGS);
+    
+    return tree;
+}
+
+static myhtml_tree_t * test_tree_chunks(myhtml_t* myhtml, bool lazy, size_t step)
+{
+    myhtml_tree_t* tree = test_tree_create(myhtml, lazy);
+    myhtml_encoding_set(tree, MyENCODING_UTF_8);
+    
+    size_t length = (sizeof(test_html) - 1);
+    
+    for(size_t i = 0; i < length; i += step) {
+        mystatus_t status = myhtml_parse_chunk(tree, &test_html[i], ((i + step) > length ? (length - i) : step));
+        CHECK_STATUS("Can't parse HTML chunk\n");
+    }
+    
+    mystatus_t status = myhtml_parse_chunk_end(tree);
+    CHECK_STATUS("Can't parse HTML chunk\n");
+    
+    return tree;
+}
+
+static myhtml_tree_node_t * test_first_node(myhtml_tree_t* tree, myhtml_tag_id_t tag_id)
+{
+    myhtml_collection_t *collection = myhtml_get_nodes_by_tag_id(tree, NULL, tag_id, NULL);
+    myhtml_tree_node_t *node = NULL;
+    
+    if(collection && collection->length)
+        node = collection->list[0];
+    
+    myhtml_collection_destroy(collection);
+    
+    return node;
+}
+
+static bool test_serialization_eq(myhtml_tree_t* tree, myhtml_tree_t* lazy_tree)
+{
+    mycore_string_raw_t str, lazy_str;
+    
+    mycore_string_raw_clean_all(&str);
+    mycore_string_raw_clean_all(&lazy_str);
+    
+    if(myhtml_serialization_tree_buffer(myhtml_tree_get_document(tree), &str) ||
+       myhtml_serialization_tree_buffer(myhtml_tree_get_document(lazy_tree), &lazy_str))
+    {
+        DIE("Can't serialize tree\n");
+    }
+    
+    bool is_eq = (str.length == lazy_str.length && memcmp(str.data, lazy_str.data, str.length) == 0);
+    
+    if(is_eq == false)
+        printf("eager: %s\nlazy:  %s\n", str.data, lazy_str.data);
+    
+    mycore_string_raw_destroy(&str, false);
+    mycore_string_raw_destroy(&lazy_str, false);
+    
+    return is_eq;
+}
+
+static void test_on_demand(myhtml_t* myhtml)
+{
+    const char *html = "<div id=x data-v=\"a&amp;b\" title=skip>some &lt;text&gt;</div><!--c-->";
+    
+    myhtml_tree_t* tree = test_tree_create(myhtml, true);
+    mystatus_t status = myhtml_parse(tree, MyENCODING_UTF_8, html, strlen(html));
+    
+    CHECK_STATUS("Can't parse HTML\n");
+    
+    myhtml_tree_node_t *node = test_first_node(tree, MyHTML_TAG_DIV);
+    myhtml_tree_node_t *text = myhtml_node_child(node);
+    
+    test_check(text && text->token->str.data == NULL && text->token->raw_length == 17, "text is not decoded by parse");
+    
+    myhtml_tree_attr_t *attr = myhtml_attribute_by_key(node, "data-v", 6);
+    
+    test_check(attr && attr->value.data == NULL && myhtml_attribute_key(attr, NULL) &&
+               strcmp(myhtml_attribute_key(attr, NULL), "data-v") == 0, "value is not decoded, key is");
+    
+    size_t length;
+    const char *value = myhtml_attribute_value(attr, &length);
+    
+    test_check(value && length == 3 && strcmp(value, "a&b") == 0, "value decoded on read");
+    test_check(myhtml_attribute_value(attr, NULL) == value, "decoded value is kept");
+    
+    test_check(myhtml_attribute_value(myhtml_attribute_by_key(node, "title", 5), NULL) &&
+               attr->next->value.data != NULL, "other value decoded on read");
+    
+    const char *data = myhtml_node_text(text, &length);
+    
+    test_check(data && length == 11 && strcmp(data, "some <text>") == 0 && myhtml_node_text(text, NULL) == data,
+               "text decoded on read");
+    
+    myhtml_tree_node_t *comment = myhtml_node_next(node);
+    
+    test_check(comment && comment->token->str.data == NULL &&
+               strcmp(myhtml_node_text(comment, NULL), "c") == 0, "comment decoded on read");
+    
+    /* index takes values of "id" and "class" only */
+    myhtml_tree_destroy(tree);
+    
+    tree = test_tree_create(myhtml, true);
+    myhtml_tree_index_enable(tree);
+    
+    status = myhtml_parse(tree, MyENCODING_UTF_8, html, strlen(html));
+    CHECK_STATUS("Can't parse HTML\n");
+    
+    node = test_first_node(tree, MyHTML_TAG_DIV);
+    
+    myhtml_collection_t *collection = myhtml_get_nodes_by_attribute_value(tree, NULL, NULL, false, "id", 2, "x", 1, NULL);
+    
+    test_check(collection && collection->length == 1 && collection->list[0] == node &&
+               myhtml_attribute_by_key(node, "title", 5)->value.data == NULL, "index decodes only id and class");
+    
+    myhtml_collection_destroy(collection);
+    
+    collection = myhtml_get_nodes_by_attribute_value(tree, NULL, NULL, false, "data-v", 6, "a&b", 3, NULL);
+    
+    test_check(collection && collection->length == 1 && collection->list[0] == node, "find by attribute value");
+    
+    myhtml_collection_destroy(collection);
+    myhtml_tree_destroy(tree);
+}
+
+static void test_same_tree(myhtml_t* myhtml)
+{
+    myhtml_tree_t* tree = test_tree_create(myhtml, false);
+    myhtml_tree_t* lazy_tree = test_tree_create(myhtml, true);
+    
+    mystatus_t status = myhtml_parse(tree, MyENCODING_UTF_8, test_html, (sizeof(test_html) - 1));
+    CHECK_STATUS("Can't parse HTML\n");
+    
+    status = myhtml_parse(lazy_tree, MyENCODING_UTF_8, test_html, (sizeof(test_html) - 1));
+    CHECK_STATUS("Can't parse HTML\n");
+    
+    test_check(test_serialization_eq(tree, lazy_tree), "same tree as parse without flag");
+    
+    test_check(lazy_tree->doctype.attr_public && lazy_tree->doctype.attr_system &&
+               strcmp(lazy_tree->doctype.attr_public, "-//W3C//DTD HTML 4.01 Transitional//EN") == 0 &&
+               strcmp(lazy_tree->doctype.attr_system, "http://www.w3.org/TR/html4/loose.dtd") == 0,
+               "doctype public and system ids");
+    
+    myhtml_tree_destroy(tree);
+    myhtml_tree_destroy(lazy_tree);
+    
+    /* by chunks; every chunk is incoming buffer and a string can be spread across them */
+    for(size_t step = 1; step < 8; step++)
+    {
+        tree = test_tree_chunks(myhtml, false, step);
+        lazy_tree = test_tree_chunks(myhtml, true, step);
+        
+        char name[64];
+        snprintf(name, sizeof(name), "same tree by chunks of " MyCORE_FORMAT_Z " bytes", step);
+        
+        test_check(test_serialization_eq(tree, lazy_tree), name);
+        
+        myhtml_tree_destroy(tree);
+        myhtml_tree_destroy(lazy_tree);
+    }
+}
+
+static void test_encoding(myhtml_t* myhtml)
+{
+    /* windows-1251: "<p title=\"Привет\">мир &amp; ok</p>" */
+    const char html[] = "<p title=\"\xcf\xf0\xe8\xe2\xe5\xf2\">\xec\xe8\xf0 &amp; ok</p>";
+    
+    myhtml_tree_t* tree = test_tree_create(myhtml, false);
+    myhtml_tree_t* lazy_tree = test_tree_create(myhtml, true);
+    
+    mystatus_t status = myhtml_parse(tree, MyENCODING_WINDOWS_1251, html, (sizeof(html) - 1));
+    CHECK_STATUS("Can't parse HTML\n");
+    
+    status = myhtml_parse(lazy_tree, MyENCODING_WINDOWS_1251, html, (sizeof(html) - 1));
+    CHECK_STATUS("Can't parse HTML\n");
+    
+    test_check(test_serialization_eq(tree, lazy_tree), "same tree for not UTF-8 input");
+    
+    myhtml_tree_node_t *node = test_first_node(lazy_tree, MyHTML_TAG_P);
+    
+    test_check(strcmp(myhtml_node_text(myhtml_node_child(node), NULL), "\xd0\xbc\xd0\xb8\xd1\x80 & ok") == 0,
+               "text converted to UTF-8");
+    
+    myhtml_tree_destroy(tree);
+    myhtml_tree_destroy(lazy_tree);
+}
+
+int main(int argc, const char * argv[])
+{
+    myhtml_t* myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, MyHTML_OPTIONS_DEFAULT, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    test_on_demand(myhtml);
+    test_same_tree(myhtml);
+    test_encoding(myhtml);
+    
+    myhtml_destroy(myhtml);
+    
+    return test_total();
+}
@@ -0,0 +1,157 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * myhtml_parse_file and mycss_parse_file give mapping of file to tokenizer without copy:
+ * incoming buffers and raw positions point to the mapping until the next parse, clean or destroy.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myhtml/myhtml.h>
+#include <mycss/mycss.h>
+
+#include "../test.h"
+
+static const char * test_path(const char* dir, const char* filename)
+{
+    static char path[4096];
+    snprintf(path, sizeof(path), "%s/%s", dir, filename);
+    
+    return path;
+}
+
+static myhtml_tree_node_t * test_first_node(myhtml_tree_t* tree, myhtml_tag_id_t tag_id)
+{
+    myhtml_collection_t *collection = myhtml_get_nodes_by_tag_id(tree, NULL, tag_id, NULL);
+    myhtml_tree_node_t *node = NULL;
+    
+    if(collection && collection->length)
+        node = collection->list[0];
+    
+    myhtml_collection_destroy(collection);
+    
+    return node;
+}
+
+static void test_myhtml(const char* dir)
+{
+    myhtml_t* myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, MyHTML_OPTIONS_DEFAULT, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    myhtml_tree_t* tree = myhtml_tree_create();
+    status = myhtml_tree_init(tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    status = myhtml_parse_file(tree, MyENCODING_UTF_8, test_path(dir, "page.html"));
+    test_check(status == MyHTML_STATUS_OK && tree->file_data && tree->file_size == 128, "parse file");
+    
+    const char *data = mycore_incoming_buffer_data(myhtml_tree_incoming_buffer_first(tree));
+    test_check(data == tree->file_data, "incoming buffer is the mapping");
+    
+    myhtml_tree_node_t *node = test_first_node(tree, MyHTML_TAG_P);
+    myhtml_position_t pos = myhtml_node_element_position(node);
+    
+    test_check(node && memcmp(&data[pos.begin], "<p id=x>", pos.length) == 0 && pos.length == 8,
+               "element position in the mapping");
+    
+    pos = myhtml_node_raw_position(myhtml_node_child(node));
+    test_check(pos.length == 5 && memcmp(&data[pos.begin], "hello", pos.length) == 0,
+               "raw position in the mapping");
+    
+    node = test_first_node(tree, MyHTML_TAG_TITLE);
+    test_check(node && strcmp(myhtml_node_text(myhtml_node_child(node), NULL), "Mapped") == 0, "text of node");
+    
+    /* previous mapping is unmapped by new parse */
+    status = myhtml_parse_file(tree, MyENCODING_UTF_8, test_path(dir, "list.html"));
+    node = test_first_node(tree, MyHTML_TAG_LI);
+    
+    test_check(status == MyHTML_STATUS_OK && node && tree->file_size == 24 &&
+               strcmp(myhtml_node_text(myhtml_node_child(node), NULL), "one") == 0, "parse other file");
+    
+    status = myhtml_parse(tree, MyENCODING_UTF_8, "<b>x</b>", 8);
+    test_check(status == MyHTML_STATUS_OK && tree->file_data == NULL && tree->file_size == 0,
+               "parse of buffer unmaps file");
+    
+    status = myhtml_parse_file(tree, MyENCODING_UTF_8, test_path(dir, "empty.html"));
+    test_check(status == MyHTML_STATUS_OK && tree->file_data == NULL && myhtml_tree_get_node_body(tree),
+               "parse empty file");
+    
+    status = myhtml_parse_file(tree, MyENCODING_UTF_8, test_path(dir, "not_exists.html"));
+    test_check(status == MyCORE_STATUS_ERROR_FILE_OPEN, "parse not existing file");
+    
+    status = myhtml_parse_file(tree, MyENCODING_UTF_8, test_path(dir, "page.html"));
+    test_check(status == MyHTML_STATUS_OK && test_first_node(tree, MyHTML_TAG_DIV), "parse after error");
+    
+    myhtml_tree_destroy(tree);
+    myhtml_destroy(myhtml);
+}
+
+static void test_mycss(const char* dir)
+{
+    mycss_t *mycss = mycss_create();
+    mystatus_t status = mycss_init(mycss);
+    
+    CHECK_STATUS("Can't init MyCSS object\n");
+    
+    mycss_entry_t *entry = mycss_entry_create();
+    status = mycss_entry_init(mycss, entry);
+    
+    CHECK_STATUS("Can't init MyCSS Entry object\n");
+    
+    status = mycss_parse_file(entry, MyENCODING_UTF_8, test_path(dir, "style.css"));
+    test_check(status == MyCSS_STATUS_OK && entry->file_data && entry->file_size == 43, "parse css file");
+    
+    test_check(entry->first_buffer && mycore_incoming_buffer_data(entry->first_buffer) == entry->file_data,
+               "css incoming buffer is the mapping");
+    
+    mycss_selectors_list_t *list = mycss_entry_stylesheet(entry)->sel_list_first;
+    test_check(list && list->entries_list_length == 2 && list->next && list->next->entries_list_length == 1,
+               "selectors of css file");
+    
+    mycss_stylesheet_destroy(mycss_entry_stylesheet(entry), true);
+    
+    status = mycss_parse(entry, MyENCODING_UTF_8, "a {}", 4);
+    test_check(status == MyCSS_STATUS_OK && entry->file_data == NULL, "parse of css buffer unmaps file");
+    
+    mycss_stylesheet_destroy(mycss_entry_stylesheet(entry), true);
+    
+    status = mycss_parse_file(entry, MyENCODING_UTF_8, test_path(dir, "not_exists.css"));
+    test_check(status == MyCORE_STATUS_ERROR_FILE_OPEN, "parse not existing css file");
+    
+    mycss_entry_destroy(entry, true);
+    mycss_destroy(mycss, true);
+}
+
+int main(int argc, const char * argv[])
+{
+    if(argc < 2)
+        DIE("Usage: %s <directory with files>\n", argv[0]);
+    
+    test_myhtml(argv[1]);
+    test_mycss(argv[1]);
+    
+    return test_total();
+}
@@ -0,0 +1,243 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Documents parsed by threads of pool must give the same trees as documents parsed one by one,
+ * with small queue, with documents of other encoding and after wait and destroy of pool.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myhtml/myhtml.h>
+#include <myhtml/serialization.h>
+
+#include "../test.h"
+
+#define TEST_DOCUMENTS_COUNT 400
+
+struct test_document {
+    char* html;
+    size_t html_size;
+    myencoding_t encoding;
+    
+    /* hash of serialization */
+    unsigned long long expected;
+    unsigned long long result;
+    
+    mystatus_t status;
+    size_t done;
+    
+    myhtml_tree_t* tree;
+}
+typedef test_document_t;
+
+static test_document_t test_documents[TEST_DOCUMENTS_COUNT];
+
+static mystatus_t test_serialization_hash(const char* data, size_t len, void* ctx)
+{
+    unsigned long long *hash = (unsigned long long*)ctx;
+    
+    for(size_t i = 0; i < len; i++)
+        *hash = (*hash ^ (unsigned char)data[i]) * 1099511628211ULL;
+    
+    return MyCORE_STATUS_OK;
+}
+
+static unsigned long long test_tree_hash(myhtml_tree_t* tree)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    
+    if(myhtml_serialization_tree_callback(myhtml_tree_get_document(tree), test_serialization_hash, &hash))
+        DIE("Can't serialize tree\n");
+    
+    return hash;
+}
+
+static void test_documents_create(void)
+{
+    char buf[512];
+    
+    for(size_t i = 0; i < TEST_DOCUMENTS_COUNT; i++)
+    {
+        test_document_t *doc = &test_documents[i];
+        
+        switch (i % 4) {
+            case 0:
+                snprintf(buf, sizeof(buf), "<div id=d" MyCORE_FORMAT_Z "><p>text " MyCORE_FORMAT_Z " &amp; more<b>bold<i>italic</b>rest</i></div>", i, i);
+                break;
+            case 1:
+                snprintf(buf, sizeof(buf), "<!DOCTYPE html><title>doc " MyCORE_FORMAT_Z "</title><table><tr><td>" MyCORE_FORMAT_Z "<td>cell</table>", i, i);
+                break;
+            case 2:
+                /* windows-1251 */
+                snprintf(buf, sizeof(buf), "<ul><li>\xcf\xf0\xe8\xe2\xe5\xf2 " MyCORE_FORMAT_Z "<li>item</ul><svg><path d=\"M0 0\"/></svg>", i);
+                break;
+            default:
+                snprintf(buf, sizeof(buf), "<select><option>" MyCORE_FORMAT_Z "<option>two</select><script>var a = '<p>';</script><p>" MyCORE_FORMAT_Z, i, i);
+                break;
+        }
+        
+        doc->html_size = strlen(buf);
+        doc->html = (char*)malloc(doc->html_size + 1);
+        
+        if(doc->html == NULL)
+            DIE("Can't allocate memory for document\n");
+        
+        memcpy(doc->html, buf, (doc->html_size + 1));
+        
+        doc->encoding = ((i % 4) == 2 ? MyENCODING_WINDOWS_1251 : MyENCODING_UTF_8);
+    }
+}
+
+static void test_documents_expected(void)
+{
+    myhtml_t* myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, MyHTML_OPTIONS_PARSE_MODE_SINGLE, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    myhtml_tree_t* tree = myhtml_tree_create();
+    status = myhtml_tree_init(tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    for(size_t i = 0; i < TEST_DOCUMENTS_COUNT; i++)
+    {
+        test_document_t *doc = &test_documents[i];
+        
+        status = myhtml_parse(tree, doc->encoding, doc->html, doc->html_size);
+        CHECK_STATUS("Can't parse HTML\n");
+        
+        doc->expected = test_tree_hash(tree);
+    }
+    
+    myhtml_tree_destroy(tree);
+    myhtml_destroy(myhtml);
+}
+
+static void test_callback_done(myhtml_tree_t* tree, mystatus_t status, void* ctx)
+{
+    test_document_t *doc = (test_document_t*)ctx;
+    
+    doc->result = test_tree_hash(tree);
+    doc->status = status;
+    doc->tree   = tree;
+    doc->done++;
+}
+
+static bool test_documents_result(myhtml_pool_t* pool)
+{
+    for(size_t i = 0; i < TEST_DOCUMENTS_COUNT; i++)
+    {
+        test_document_t *doc = &test_documents[i];
+        bool tree_of_pool = false;
+        
+        for(size_t t = 0; t < myhtml_pool_tree_count(pool); t++) {
+            if(myhtml_pool_tree(pool, t) == doc->tree)
+                tree_of_pool = true;
+        }
+        
+        if(doc->done != 1 || doc->status || doc->result != doc->expected || tree_of_pool == false) {
+            printf("document " MyCORE_FORMAT_Z ": done " MyCORE_FORMAT_Z " times, status %d\n", i, doc->done, doc->status);
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+static void test_documents_reset(void)
+{
+    for(size_t i = 0; i < TEST_DOCUMENTS_COUNT; i++) {
+        test_documents[i].result = 0;
+        test_documents[i].status = MyHTML_STATUS_OK;
+        test_documents[i].done   = 0;
+        test_documents[i].tree   = NULL;
+    }
+}
+
+static void test_pool(size_t thread_count, size_t queue_size, const char* name)
+{
+    char test_name[128];
+    
+    myhtml_pool_t *pool = myhtml_pool_create();
+    mystatus_t status = myhtml_pool_init(pool, thread_count, queue_size);
+    
+    CHECK_STATUS("Can't init MyHTML Pool object\n");
+    
+    /* two rounds for reuse of trees */
+    for(size_t round = 0; round < 2; round++)
+    {
+        test_documents_reset();
+        
+        for(size_t i = 0; i < TEST_DOCUMENTS_COUNT; i++) {
+            status = myhtml_pool_parse(pool, test_documents[i].encoding, test_documents[i].html, test_documents[i].html_size,
+                                       test_callback_done, &test_documents[i]);
+            
+            CHECK_STATUS("Can't submit HTML to pool\n");
+        }
+        
+        myhtml_pool_wait_for_all_done(pool);
+        
+        snprintf(test_name, sizeof(test_name), "%s, round " MyCORE_FORMAT_Z, name, (round + 1));
+        test_check(test_documents_result(pool), test_name);
+    }
+    
+    /* destroy waits for submitted documents */
+    test_documents_reset();
+    
+    for(size_t i = 0; i < TEST_DOCUMENTS_COUNT; i++) {
+        status = myhtml_pool_parse(pool, test_documents[i].encoding, test_documents[i].html, test_documents[i].html_size,
+                                   test_callback_done, &test_documents[i]);
+        
+        CHECK_STATUS("Can't submit HTML to pool\n");
+    }
+    
+    bool all_done = true;
+    size_t tree_count = myhtml_pool_tree_count(pool);
+    
+    myhtml_pool_destroy(pool, true);
+    
+    for(size_t i = 0; i < TEST_DOCUMENTS_COUNT; i++) {
+        if(test_documents[i].done != 1 || test_documents[i].result != test_documents[i].expected)
+            all_done = false;
+    }
+    
+    snprintf(test_name, sizeof(test_name), "%s, destroy with documents in queue", name);
+    test_check(all_done && tree_count >= 1, test_name);
+}
+
+int main(int argc, const char * argv[])
+{
+    test_documents_create();
+    test_documents_expected();
+    
+    test_pool(4, 0, "4 threads");
+    test_pool(3, 1, "3 threads, queue of 1 document");
+    test_pool(1, 8, "1 thread");
+    test_pool(0, 0, "threads by processors");
+    
+    for(size_t i = 0; i < TEST_DOCUMENTS_COUNT; i++)
+        free(test_documents[i].html);
+    
+    return test_total();
+}
@@ -0,0 +1,280 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Contents of elements pruned by myhtml_callback_tree_node_prune_set are not built.
+ * Trees must be the same as trees of usual parse with children of these elements removed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myhtml/myhtml.h>
+#include <myhtml/serialization.h>
+
+#include "../test.h"
+
+struct test_counter {
+    size_t inserted;
+    size_t inserted_secret;
+    size_t decoded_secret;
+    size_t decoded;
+}
+typedef test_counter_t;
+
+static const char *test_html[] = {
+    "<html><head><style>p {color: red}</style><script>var secret = '<p>';</script></head>"
+    "<body><p class=keep>text &amp; more</p><div class=\"ad\"><a href=x>secret</a><table><tr><td>secret</table>secret</div>"
+    "<svg viewbox=\"0 0 1 1\"><text>secret</text></svg><p>after</p></body></html>",
+    
+    /* closed by implied end tags and by end of file */
+    "<p class=ad>secret<div title=\"a &amp; b\">after</div><div class=ad><ul><li>secret<li>secret",
+    
+    /* misnested formatting and table inside */
+    "<b>bold<div class=ad>secret<i>secret</b>secret</i></div>tail</b><p>x<i class=ad>secret<p>y</i>z",
+    "<table><tr><td class=ad>secret<b>secret</b></td><td>cell</td></tr></table><select class=ad><option>secret<input name=n value=\"v &amp; w\">after",
+    
+    /* comments and text inside */
+    "<div class=ad><!-- secret -->secret<noscript>secret</noscript></div><!-- comment --><textarea class=ad>secret</textarea>end"
+};
+
+static bool test_node_is_pruned(myhtml_tree_node_t* node)
+{
+    switch (myhtml_node_tag_id(node)) {
+        case MyHTML_TAG_SCRIPT:
+        case MyHTML_TAG_STYLE:
+        case MyHTML_TAG_SVG:
+            return true;
+            
+        default:
+            break;
+    }
+    
+    myhtml_tree_attr_t *attr = myhtml_attribute_by_key(node, "class", 5);
+    
+    return (attr && myhtml_attribute_value(attr, NULL) && strcmp(myhtml_attribute_value(attr, NULL), "ad") == 0);
+}
+
+static bool test_callback_prune(myhtml_tree_t* tree, myhtml_tree_node_t* node, void* ctx)
+{
+    return test_node_is_pruned(node);
+}
+
+static void test_callback_insert(myhtml_tree_t* tree, myhtml_tree_node_t* node, void* ctx)
+{
+    test_counter_t *counter = (test_counter_t*)ctx;
+    counter->inserted++;
+    
+    const char *text = myhtml_node_text(node, NULL);
+    
+    if(text && strstr(text, "secret"))
+        counter->inserted_secret++;
+}
+
+static void * test_callback_after_token(myhtml_tree_t* tree, myhtml_token_node_t* token, void* ctx)
+{
+    test_counter_t *counter = (test_counter_t*)ctx;
+    const char *text = myhtml_token_node_text(token, NULL);
+    
+    if(text) {
+        counter->decoded++;
+        
+        if(strstr(text, "secret"))
+            counter->decoded_secret++;
+    }
+    
+    return ctx;
+}
+
+static myhtml_tree_t * test_parse(myhtml_t* myhtml, const char* html, bool prune, test_counter_t* counter)
+{
+    myhtml_tree_t* tree = myhtml_tree_create();
+    mystatus_t status = myhtml_tree_init(tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    if(prune)
+        myhtml_callback_tree_node_prune_set(tree, test_callback_prune, NULL);
+    
+    if(counter) {
+        myhtml_callback_tree_node_insert_set(tree, test_callback_insert, counter);
+        myhtml_callback_after_token_done_set(tree, test_callback_after_token, counter);
+    }
+    
+    status = myhtml_parse(tree, MyENCODING_UTF_8, html, strlen(html));
+    CHECK_STATUS("Can't parse HTML\n");
+    
+    return tree;
+}
+
+/* the same as pruning, but after parse */
+static void test_remove_children(myhtml_tree_node_t* node)
+{
+    while(node)
+    {
+        if(myhtml_node_tag_id(node) != MyHTML_TAG__TEXT && test_node_is_pruned(node)) {
+            while(myhtml_node_child(node))
+                myhtml_node_remove(myhtml_node_child(node));
+        }
+        else
+            test_remove_children(myhtml_node_child(node));
+        
+        node = myhtml_node_next(node);
+    }
+}
+
+static bool test_serialization_eq(myhtml_tree_t* tree, myhtml_tree_t* pruned_tree)
+{
+    mycore_string_raw_t str, pruned_str;
+    
+    mycore_string_raw_clean_all(&str);
+    mycore_string_raw_clean_all(&pruned_str);
+    
+    if(myhtml_serialization_tree_buffer(myhtml_tree_get_document(tree), &str) ||
+       myhtml_serialization_tree_buffer(myhtml_tree_get_document(pruned_tree), &pruned_str))
+    {
+        DIE("Can't serialize tree\n");
+    }
+    
+    bool is_eq = (str.length == pruned_str.length && memcmp(str.data, pruned_str.data, str.length) == 0);
+    
+    if(is_eq == false)
+        printf("expected: %s\npruned:   %s\n", str.data, pruned_str.data);
+    
+    mycore_string_raw_destroy(&str, false);
+    mycore_string_raw_destroy(&pruned_str, false);
+    
+    return is_eq;
+}
+
+static void test_same_tree(myhtml_t* myhtml, const char* mode)
+{
+    for(size_t i = 0; i < (sizeof(test_html) / sizeof(test_html[0])); i++)
+    {
+        myhtml_tree_t* tree = test_parse(myhtml, test_html[i], false, NULL);
+        test_remove_children(myhtml_node_child(myhtml_tree_get_document(tree)));
+        
+        myhtml_tree_t* pruned_tree = test_parse(myhtml, test_html[i], true, NULL);
+        
+        char name[64];
+        snprintf(name, sizeof(name), "%s, same tree for HTML " MyCORE_FORMAT_Z, mode, (i + 1));
+        
+        test_check(test_serialization_eq(tree, pruned_tree), name);
+        
+        myhtml_tree_destroy(tree);
+        myhtml_tree_destroy(pruned_tree);
+    }
+}
+
+static void test_skipped(myhtml_t* myhtml)
+{
+    test_counter_t counter = {0};
+    test_counter_t pruned_counter = {0};
+    
+    myhtml_tree_t* tree = test_parse(myhtml, test_html[0], false, &counter);
+    myhtml_tree_t* pruned_tree = test_parse(myhtml, test_html[0], true, &pruned_counter);
+    
+    test_check(pruned_counter.inserted && pruned_counter.inserted < counter.inserted &&
+               pruned_counter.inserted_secret == 0 && counter.inserted_secret, "nodes inside are not inserted");
+    
+    test_check(pruned_counter.decoded && pruned_counter.decoded_secret == 0 && counter.decoded_secret,
+               "text inside is not decoded");
+    
+    myhtml_collection_t *collection = myhtml_get_nodes_by_tag_id(pruned_tree, NULL, MyHTML_TAG_A, NULL);
+    
+    test_check(collection && collection->length == 0, "element inside is not in tree");
+    myhtml_collection_destroy(collection);
+    
+    collection = myhtml_get_nodes_by_tag_id(pruned_tree, NULL, MyHTML_TAG_DIV, NULL);
+    
+    test_check(collection && collection->length == 1 && myhtml_node_child(collection->list[0]) == NULL &&
+               test_node_is_pruned(collection->list[0]), "pruned element stays without children");
+    myhtml_collection_destroy(collection);
+    
+    myhtml_tree_destroy(tree);
+    myhtml_tree_destroy(pruned_tree);
+    
+    /* element which goes out of pruned element gets its attributes */
+    pruned_tree = test_parse(myhtml, test_html[1], true, NULL);
+    
+    collection = myhtml_get_nodes_by_attribute_value(pruned_tree, NULL, NULL, false, "title", 5, "a & b", 5, NULL);
+    
+    test_check(collection && collection->length == 1 &&
+               strcmp(myhtml_node_text(myhtml_node_child(collection->list[0]), NULL), "after") == 0,
+               "element after pruned element is built");
+    
+    myhtml_collection_destroy(collection);
+    myhtml_tree_destroy(pruned_tree);
+}
+
+static void test_index(myhtml_t* myhtml)
+{
+    myhtml_tree_t* tree = myhtml_tree_create();
+    mystatus_t status = myhtml_tree_init(tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    status = myhtml_tree_index_enable(tree);
+    CHECK_STATUS("Can't enable index\n");
+    
+    myhtml_callback_tree_node_prune_set(tree, test_callback_prune, NULL);
+    
+    const char *html = "<div id=a class=ad><p id=b class=c>x</p></div><p id=c class=c>y</p>";
+    
+    status = myhtml_parse(tree, MyENCODING_UTF_8, html, strlen(html));
+    CHECK_STATUS("Can't parse HTML\n");
+    
+    myhtml_collection_t *collection = myhtml_get_nodes_by_attribute_value(tree, NULL, NULL, false, "class", 5, "c", 1, NULL);
+    
+    test_check(collection && collection->length == 1 &&
+               strcmp(myhtml_attribute_value(myhtml_attribute_by_key(collection->list[0], "id", 2), NULL), "c") == 0,
+               "index has not nodes inside");
+    
+    myhtml_collection_destroy(collection);
+    myhtml_tree_destroy(tree);
+}
+
+int main(int argc, const char * argv[])
+{
+    myhtml_t* myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, MyHTML_OPTIONS_PARSE_MODE_SINGLE, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    test_same_tree(myhtml, "single");
+    test_skipped(myhtml);
+    test_index(myhtml);
+    
+    myhtml_destroy(myhtml);
+    
+    /* in thread mode strings are decoded, but nodes are not built */
+    myhtml = myhtml_create();
+    status = myhtml_init(myhtml, MyHTML_OPTIONS_DEFAULT, 2, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    test_same_tree(myhtml, "threads");
+    test_index(myhtml);
+    
+    myhtml_destroy(myhtml);
+    
+    return test_total();
+}
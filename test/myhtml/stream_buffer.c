@@ -0,0 +1,141 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Stream buffer keeps decoded text of UTF-16 input: its entries grow past the initial size,
+ * are reused after clean, and every chunk is decoded from the encoding of user.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myhtml/myhtml.h>
+#include <myhtml/stream.h>
+
+#include "../test.h"
+
+static void test_entries(void)
+{
+    myhtml_stream_buffer_t *stream_buffer = myhtml_stream_buffer_create();
+    mystatus_t status = myhtml_stream_buffer_init(stream_buffer, 1);
+
+    CHECK_STATUS("Can't init stream buffer\n");
+
+    bool is_good = true;
+
+    for(size_t i = 0; i < 4; i++) {
+        myhtml_stream_buffer_entry_t *entry = myhtml_stream_buffer_add_entry(stream_buffer, 16);
+
+        if(entry == NULL || entry != myhtml_stream_buffer_current_entry(stream_buffer)) {
+            is_good = false;
+            break;
+        }
+
+        entry->length = (size_t)snprintf(entry->data, entry->size, "entry " MyCORE_FORMAT_Z, i);
+    }
+
+    for(size_t i = 0; is_good && i < 4; i++) {
+        char text[16];
+        snprintf(text, sizeof(text), "entry " MyCORE_FORMAT_Z, i);
+
+        is_good = (strcmp(stream_buffer->entries[i].data, text) == 0);
+    }
+
+    test_check(is_good && stream_buffer->length == 4 && stream_buffer->size >= 4, "entries grow past initial size");
+
+    stream_buffer->res.first = 0xD8;
+    myhtml_stream_buffer_clean(stream_buffer);
+
+    test_check(stream_buffer->length == 0 && stream_buffer->res.first == 0, "clean drops unfinished character");
+
+    myhtml_stream_buffer_entry_t *entry = myhtml_stream_buffer_add_entry(stream_buffer, 16);
+
+    test_check(entry && entry->length == 0, "entry reused after clean is empty");
+
+    myhtml_stream_buffer_destroy(stream_buffer, true);
+}
+
+/* "<p>" + text + "</p>" in UTF-16LE, by chunks of odd size: code units are split */
+static bool test_parse_utf_16(myhtml_tree_t* tree, const char* text)
+{
+    char html[256], data[512];
+    size_t length = (size_t)snprintf(html, sizeof(html), "<p>%s</p>", text);
+
+    for(size_t i = 0; i < length; i++) {
+        data[(i * 2)] = html[i];
+        data[(i * 2) + 1] = 0x00;
+    }
+
+    myhtml_encoding_set(tree, MyENCODING_UTF_16LE);
+
+    for(size_t offset = 0; offset < (length * 2); offset += 7) {
+        size_t size = ((length * 2) - offset < 7 ? (length * 2) - offset : 7);
+
+        if(myhtml_parse_chunk(tree, &data[offset], size))
+            return false;
+    }
+
+    if(myhtml_parse_chunk_end(tree))
+        return false;
+
+    myhtml_collection_t *collection = myhtml_get_nodes_by_tag_id(tree, NULL, MyHTML_TAG_P, NULL);
+    bool is_eq = false;
+
+    if(collection && collection->length == 1) {
+        const char *node_text = myhtml_node_text(myhtml_node_child(collection->list[0]), NULL);
+        is_eq = (node_text && strcmp(node_text, text) == 0);
+    }
+
+    myhtml_collection_destroy(collection);
+
+    return is_eq;
+}
+
+static void test_parse(myhtml_t* myhtml)
+{
+    myhtml_tree_t* tree = myhtml_tree_create();
+    mystatus_t status = myhtml_tree_init(tree, myhtml);
+
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+
+    test_check(test_parse_utf_16(tree, "first text"), "UTF-16LE by chunks");
+
+    myhtml_tree_clean(tree);
+
+    test_check(test_parse_utf_16(tree, "second text"), "UTF-16LE by chunks after clean");
+
+    myhtml_tree_destroy(tree);
+}
+
+int main(int argc, const char * argv[])
+{
+    myhtml_t* myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, MyHTML_OPTIONS_DEFAULT, 1, 0);
+
+    CHECK_STATUS("Can't init MyHTML object\n");
+
+    test_entries();
+    test_parse(myhtml);
+
+    myhtml_destroy(myhtml);
+
+    return test_total();
+}
@@ -0,0 +1,314 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+ 
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+ 
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ 
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM frees every token with attributes after callback_after_token
+ * and releases incoming buffers before current token, memory of parse by chunks must not grow with document.
+ * Input converted to UTF-8 (UTF-16, or other encodings with MyHTML_TREE_PARSE_FLAGS_CONVERT_TO_UTF_8)
+ * goes through the stream buffer, its entries must be reused too.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myhtml/myhtml.h>
+#include <myhtml/tree.h>
+#include <myhtml/stream.h>
+#include <mycore/utils/mcallocator.h>
+
+#include "../test.h"
+
+#define TEST_CHUNK_SIZE 1024
+
+struct test_stat {
+    size_t tokens;
+    size_t texts;
+    size_t attrs;
+    size_t hash;
+    
+    /* entries of stream buffer with allocated data */
+    size_t stream_entries;
+}
+typedef test_stat_t;
+
+static void * test_malloc(size_t size, void* ctx)
+{
+    return malloc(size);
+}
+
+static void * test_realloc(void* dst, size_t size, void* ctx)
+{
+    return realloc(dst, size);
+}
+
+static void test_free(void* dst, void* ctx)
+{
+    free(dst);
+}
+
+static void test_hash(test_stat_t* stat, const char* data, size_t length)
+{
+    for(size_t i = 0; i < length; i++)
+        stat->hash = (stat->hash ^ (unsigned char)data[i]) * 16777619;
+    
+    stat->hash = (stat->hash ^ 0xff) * 16777619;
+}
+
+static void * test_callback_after_token(myhtml_tree_t* tree, myhtml_token_node_t* token, void* ctx)
+{
+    test_stat_t *stat = (test_stat_t*)ctx;
+    
+    stat->tokens++;
+    stat->hash = (stat->hash ^ (myhtml_token_node_tag_id(token) + 1)) * 16777619;
+    
+    size_t length;
+    const char *text = myhtml_token_node_text(token, &length);
+    
+    if(text) {
+        stat->texts++;
+        test_hash(stat, text, length);
+    }
+    
+    myhtml_tree_attr_t *attr = myhtml_token_node_attribute_first(token);
+    
+    while(attr) {
+        stat->attrs++;
+        
+        const char *data = myhtml_attribute_key(attr, &length);
+        test_hash(stat, data, length);
+        
+        data = myhtml_attribute_value(attr, &length);
+        test_hash(stat, data, length);
+        
+        attr = myhtml_attribute_next(attr);
+    }
+    
+    return ctx;
+}
+
+static char * test_html_generate(size_t count, const char* word, size_t* size)
+{
+    static const char *text = "some text &amp; entities &lt;<!-- comment -->";
+    
+    char *html = malloc(count * (160 + strlen(word)) + 1);
+    if(html == NULL)
+        DIE("Can't allocate mem for HTML\n");
+    
+    size_t length = 0;
+    
+    for(size_t i = 0; i < count; i++) {
+        length += sprintf(&html[length], "<div class=\"c" MyCORE_FORMAT_Z "\" id=i" MyCORE_FORMAT_Z " data-x='&quot;" MyCORE_FORMAT_Z "'>%s%s<br/></div>\n",
+                          (i % 10), i, i, word, text);
+    }
+    
+    *size = length;
+    return html;
+}
+
+/* UTF-8 of one and two bytes only */
+static char * test_to_utf_16le(const char* html, size_t size, size_t* new_size)
+{
+    unsigned char *utf_16 = malloc(size * 2);
+    if(utf_16 == NULL)
+        DIE("Can't allocate mem for HTML\n");
+    
+    size_t length = 0;
+    
+    for(size_t i = 0; i < size; i++) {
+        unsigned int cp = (unsigned char)html[i];
+        
+        if(cp >= 0xC0) {
+            cp = ((cp & 0x1F) << 6) | ((unsigned char)html[i + 1] & 0x3F);
+            i++;
+        }
+        
+        utf_16[length++] = (unsigned char)(cp & 0xFF);
+        utf_16[length++] = (unsigned char)(cp >> 8);
+    }
+    
+    *new_size = length;
+    return (char*)utf_16;
+}
+
+static test_stat_t test_parse(myhtml_t* myhtml, myhtml_tree_parse_flags_t flags, myencoding_t encoding,
+                              const char* html, size_t size, size_t chunk_size, bool check_buffers)
+{
+    test_stat_t stat = {0, 0, 0, 2166136261, 0};
+    
+    myhtml_tree_t* tree = myhtml_tree_create();
+    mystatus_t status = myhtml_tree_init(tree, myhtml);
+    
+    CHECK_STATUS("Can't init MyHTML Tree object\n");
+    
+    myhtml_tree_parse_flags_set(tree, flags);
+    myhtml_callback_after_token_done_set(tree, test_callback_after_token, &stat);
+    myhtml_encoding_set(tree, encoding);
+    
+    for(size_t i = 0; i < size; i += chunk_size) {
+        status = myhtml_parse_chunk(tree, &html[i], ((i + chunk_size) > size ? (size - i) : chunk_size));
+        CHECK_STATUS("Can't parse HTML chunk\n");
+    }
+    
+    status = myhtml_parse_chunk_end(tree);
+    CHECK_STATUS("Can't parse HTML chunk\n");
+    
+    if(check_buffers) {
+        mycore_incoming_buffer_t *inc_buf = myhtml_tree_incoming_buffer_first(tree);
+        
+        test_check(inc_buf && mycore_incoming_buffer_prev(inc_buf) == NULL &&
+                   mycore_incoming_buffer_offset(inc_buf) > 0 && mycore_incoming_buffer_next(inc_buf) == NULL,
+                   "incoming buffers before last chunk are released");
+    }
+    
+    if(tree->stream_buffer) {
+        for(size_t i = 0; i < tree->stream_buffer->size; i++) {
+            if(tree->stream_buffer->entries[i].data)
+                stat.stream_entries++;
+        }
+    }
+    
+    myhtml_tree_destroy(tree);
+    
+    return stat;
+}
+
+static void test_same_tokens(myhtml_t* myhtml)
+{
+    const char html[] = "<!DOCTYPE html><html><head><title>A &amp; B</title><script>if(a < b) x = \"</p>\";</script></head>"
+                        "<body class=\"main  page\" id=b><a href=\"/x?a=1&amp;b=2\" title='&lt;q&gt;'>link &copy;</a>"
+                        "<textarea>\nrc &amp; data</textarea><!-- c&amp;d --><div title=\"&notin; &noti\">&amp</div>"
+                        "<svg viewbox=\"0 0 1 1\"><path d=M0/></svg></body></html>";
+    
+    /* tokens are compared with the same chunks, tokenizer takes end tags of RCDATA split by chunks as text */
+    for(size_t step = 1; step < 8; step++)
+    {
+        test_stat_t stat = test_parse(myhtml, MyHTML_TREE_PARSE_FLAGS_WITHOUT_BUILD_TREE, MyENCODING_UTF_8, html, (sizeof(html) - 1), step, false);
+        test_stat_t stream = test_parse(myhtml, MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM, MyENCODING_UTF_8, html, (sizeof(html) - 1), step, false);
+        
+        char name[64];
+        snprintf(name, sizeof(name), "same tokens by chunks of " MyCORE_FORMAT_Z " bytes", step);
+        
+        test_check(stream.tokens == stat.tokens && stream.texts == stat.texts &&
+                   stream.attrs == stat.attrs && stream.hash == stat.hash, name);
+    }
+}
+
+static void test_memory(void)
+{
+    mcallocator_t *allocator = mcallocator_create();
+    
+    mystatus_t status = mcallocator_init(allocator, test_malloc, test_realloc, test_free, NULL);
+    CHECK_STATUS("Can't init allocator\n");
+    
+    myhtml_t* myhtml = myhtml_create();
+    status = myhtml_init(myhtml, MyHTML_OPTIONS_DEFAULT, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    myhtml_allocator_set(myhtml, allocator);
+    
+    size_t small_size, big_size;
+    char *small = test_html_generate(1000, "", &small_size);
+    char *big = test_html_generate(20000, "", &big_size);
+    
+    mcallocator_clean(allocator);
+    test_stat_t small_stat = test_parse(myhtml, MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM, MyENCODING_UTF_8, small, small_size, TEST_CHUNK_SIZE, true);
+    size_t small_peak = mcallocator_bytes_peak(allocator);
+    
+    mcallocator_clean(allocator);
+    test_stat_t big_stat = test_parse(myhtml, MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM, MyENCODING_UTF_8, big, big_size, TEST_CHUNK_SIZE, true);
+    size_t big_peak = mcallocator_bytes_peak(allocator);
+    
+    test_check(small_stat.tokens == 1000 * 6 + 1 && small_stat.texts == 1000 * 3 &&
+               big_stat.tokens == 20000 * 6 + 1 && big_stat.attrs == 20000 * 3, "all tokens are delivered");
+    
+    test_check(big_peak <= small_peak, "peak memory does not depend on document size");
+    
+    mcallocator_clean(allocator);
+    test_parse(myhtml, MyHTML_TREE_PARSE_FLAGS_WITHOUT_BUILD_TREE, MyENCODING_UTF_8, big, big_size, TEST_CHUNK_SIZE, false);
+    
+    test_check(mcallocator_bytes_peak(allocator) > big_peak, "less memory than without stream");
+    
+    free(small);
+    free(big);
+    
+    myhtml_destroy(myhtml);
+    mcallocator_destroy(allocator, true);
+}
+
+/* stream buffer of converted input has the same entries for any document size, and tokens are as without stream */
+static void test_converted_encoding(myhtml_t* myhtml, myencoding_t encoding, const char* word, bool to_utf_16, const char* name)
+{
+    myhtml_tree_parse_flags_t convert = MyHTML_TREE_PARSE_FLAGS_CONVERT_TO_UTF_8;
+    
+    size_t counts[2] = {1000, 20000};
+    test_stat_t stat[2], stream[2];
+    
+    for(size_t i = 0; i < 2; i++) {
+        size_t size;
+        char *html = test_html_generate(counts[i], word, &size);
+        
+        if(to_utf_16) {
+            char *utf_16 = test_to_utf_16le(html, size, &size);
+            
+            free(html);
+            html = utf_16;
+        }
+        
+        stat[i] = test_parse(myhtml, (MyHTML_TREE_PARSE_FLAGS_WITHOUT_BUILD_TREE|convert), encoding, html, size, TEST_CHUNK_SIZE, false);
+        stream[i] = test_parse(myhtml, (MyHTML_TREE_PARSE_FLAGS_TOKEN_STREAM|convert), encoding, html, size, TEST_CHUNK_SIZE, false);
+        
+        free(html);
+    }
+    
+    char buf[128];
+    
+    snprintf(buf, sizeof(buf), "%s: same tokens as without stream", name);
+    test_check(stream[1].tokens == counts[1] * 6 + 1 && stream[1].tokens == stat[1].tokens &&
+               stream[1].texts == stat[1].texts && stream[1].hash == stat[1].hash, buf);
+    
+    snprintf(buf, sizeof(buf), "%s: stream buffer does not depend on document size", name);
+    test_check(stream[0].stream_entries > 0 && stream[1].stream_entries <= stream[0].stream_entries &&
+               stream[1].stream_entries < stat[1].stream_entries, buf);
+}
+
+static void test_converted(myhtml_t* myhtml)
+{
+    test_converted_encoding(myhtml, MyENCODING_WINDOWS_1251, "\xcf\xf0\xe8\xe2\xe5\xf2 ", false, "windows-1251");
+    test_converted_encoding(myhtml, MyENCODING_UTF_16LE, "\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82 ", true, "UTF-16LE");
+}
+
+int main(int argc, const char * argv[])
+{
+    myhtml_t* myhtml = myhtml_create();
+    mystatus_t status = myhtml_init(myhtml, MyHTML_OPTIONS_DEFAULT, 1, 0);
+    
+    CHECK_STATUS("Can't init MyHTML object\n");
+    
+    test_same_tokens(myhtml);
+    test_converted(myhtml);
+    
+    myhtml_destroy(myhtml);
+    
+    test_memory();
+    
+    return test_total();
+}
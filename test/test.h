@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2016-2017 Alexander Borisov
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+ Author: lex.borisov@gmail.com (Alexander Borisov)
+*/
+
+/*
+ * Common part of unit tests.
+ *
+ * Every check is counted; a test ends with
+ *   Total: N; Good: N; Bad: N
+ * and exits with failure if any check is bad.
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mycore/myosi.h>
+
+#define DIE(msg, ...) do { fprintf(stderr, msg, ##__VA_ARGS__); exit(EXIT_FAILURE); } while(0)
+#define CHECK_STATUS(msg, ...) do {if(status) DIE(msg, ##__VA_ARGS__);} while(0)
+
+static size_t test_count = 0;
+static size_t test_good  = 0;
+
+/* count a check without printing it, for tests printing only the bad ones */
+static bool test_count_result(bool result)
+{
+    test_count++;
+
+    if(result)
+        test_good++;
+
+    return result;
+}
+
+/* count a check and print it as "N) name: good" or "N) name: bad" */
+static void test_check(bool result, const char* name)
+{
+    printf(MyCORE_FORMAT_Z ") %s: %s\n", (test_count + 1), name, (result ? "good" : "bad"));
+
+    test_count_result(result);
+}
+
+/* print totals, return exit status of a test */
+static int test_total(void)
+{
+    printf("\nTotal: " MyCORE_FORMAT_Z "; Good: " MyCORE_FORMAT_Z "; Bad: " MyCORE_FORMAT_Z "\n",
+           test_count, test_good, (test_count - test_good));
+
+    return (test_good == test_count ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+#endif /* TEST_H */
@@ -36,6 +36,7 @@ sub work_now {
 	#struct charef_entry {
 	#    char ch;
 	#    size_t next;
+	#    unsigned long long children;
 	#    size_t cur_pos;
 	#    const char *data;
 	#  	 size_t data_len;
@@ -83,9 +84,19 @@ sub work_now {
 		#
 		#print "\n";
 		
+		print "static const unsigned char named_character_references_class[] = {\n    ";
+		
+		foreach my $char_id (0..255) {
+			my $class = char_class(chr($char_id));
+			print sprintf("0x%02x", defined $class ? $class : 0xff), ($char_id == 255 ? "\n" : ($char_id % 16 == 15 ? ",\n    " : ", "));
+		}
+		
+		print "};\n\n";
+		
 		my $i = 1;
 		foreach my $pos (sort {$a <=> $b} keys %$tree) {
-			print "{'$tree->{$pos}[0]', $tree->{$pos}[1], $tree->{$pos}[2], $tree->{$pos}[3], $tree->{$pos}[4]},";
+			my $children = children_bits($tree, $tree->{$pos}[1]);
+			print "{'$tree->{$pos}[0]', $tree->{$pos}[1], $children, $tree->{$pos}[2], $tree->{$pos}[3], $tree->{$pos}[4]},";
 			
 			unless ($i % 3) {
 				print "\n\t";
@@ -178,6 +189,35 @@ sub convert_first {
 	$zav;
 }
 
+# position of character in bits of children, sorted like characters
+sub char_class {
+	my ($char) = @_;
+	
+	return ord($char) - ord('0')      if $char =~ /^[0-9]$/;
+	return 10                         if $char eq ';';
+	return 11 + ord($char) - ord('A') if $char =~ /^[A-Z]$/;
+	return 37 + ord($char) - ord('a') if $char =~ /^[a-z]$/;
+	
+	undef;
+}
+
+sub children_bits {
+	my ($tree, $pos) = @_;
+	
+	return 0 unless $pos;
+	
+	my $bits = 0;
+	while ($tree->{$pos}[0] ne '\0') {
+		my $class = char_class($tree->{$pos}[0]);
+		die "Character out of classes: $tree->{$pos}[0]\n" unless defined $class;
+		
+		$bits |= 1 << $class;
+		$pos++;
+	}
+	
+	$bits ? sprintf("0x%016xULL", $bits) : 0;
+}
+
 sub convert_variable_name {
 	my ($name) = @_;
 	$name =~ s/[^A-Za-z0-9]/_t/g;